@@ -15,6 +15,107 @@ void main()
 	uv0 = vertexUV0;
 }
 
+--- billboardVertexInstanced
+
+// Draws all the particles of an emitter with a single instanced call.
+// The billboard orientation of each particle is computed here instead of on the CPU.
+
+#define BILLBOARD_NORMAL 0
+#define BILLBOARD_STRETCH 1
+#define BILLBOARD_HORIZONTAL 2
+#define BILLBOARD_VERTICAL 3
+
+#define ALIGNMENT_VIEW 0
+#define ALIGNMENT_WORLD 1
+#define ALIGNMENT_LOCAL 2
+#define ALIGNMENT_FACING 3
+#define ALIGNMENT_VELOCITY 4
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec2 vertexUV0;
+layout(location = 2) in vec4 particlePositionRotation; // World position and rotation around the billboard normal
+layout(location = 3) in vec4 particleScaleFrame; // Scale and texture sheet frame
+layout(location = 4) in vec4 particleColor;
+layout(location = 5) in vec3 particleDirection; // World direction
+
+uniform mat4 proj;
+uniform mat4 view;
+
+uniform int billboardType;
+uniform int renderAlignment;
+uniform int horizontalOrientation;
+uniform vec3 cameraPos;
+uniform vec3 cameraFront;
+uniform vec3 emitterUp;
+
+out vec2 uv0;
+flat out vec4 instanceColor;
+flat out float instanceFrame;
+
+// Same rotation as float4x4::LookAt(float3::unitZ, direction, float3::unitY, float3::unitY)
+mat3 LookAt(vec3 direction)
+{
+	vec3 forward = normalize(direction);
+	vec3 right = cross(vec3(0.0, 1.0, 0.0), forward);
+	right = dot(right, right) > 1e-8 ? normalize(right) : vec3(1.0, 0.0, 0.0);
+	vec3 up = cross(forward, right);
+	return mat3(right, up, forward);
+}
+
+void main()
+{
+	vec3 position = particlePositionRotation.xyz;
+
+	mat3 rotation;
+	if (billboardType == BILLBOARD_NORMAL) {
+		if (renderAlignment == ALIGNMENT_VIEW) {
+			rotation = LookAt(-cameraFront);
+		} else if (renderAlignment == ALIGNMENT_WORLD) {
+			rotation = mat3(1.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 1.0);
+		} else if (renderAlignment == ALIGNMENT_LOCAL) {
+			rotation = LookAt(-emitterUp);
+		} else if (renderAlignment == ALIGNMENT_FACING) {
+			rotation = LookAt(cameraPos - position);
+		} else {
+			rotation = LookAt(-position);
+		}
+	} else if (billboardType == BILLBOARD_STRETCH) {
+		vec3 cameraDir = normalize(cameraPos - position);
+		vec3 upDir = cross(particleDirection, cameraDir);
+		rotation = mat3(upDir, particleDirection, cross(particleDirection, upDir));
+	} else if (billboardType == BILLBOARD_HORIZONTAL) {
+		if (horizontalOrientation == 1) {
+			vec3 right = cross(vec3(0.0, 1.0, 0.0), particleDirection);
+			rotation = mat3(cross(right, vec3(0.0, 1.0, 0.0)), right, vec3(0.0, 1.0, 0.0));
+		} else {
+			rotation = LookAt(vec3(0.0, 1.0, 0.0));
+		}
+	} else {
+		rotation = LookAt(vec3(cameraPos.x, position.y, cameraPos.z) - position);
+	}
+
+	float angle = particlePositionRotation.w;
+	vec3 scaled = vertexPosition * particleScaleFrame.xyz;
+	vec3 rotated = vec3(cos(angle) * scaled.x - sin(angle) * scaled.y, sin(angle) * scaled.x + cos(angle) * scaled.y, scaled.z);
+
+	gl_Position = proj * view * vec4(position + rotation * rotated, 1.0);
+	uv0 = vertexUV0;
+	instanceColor = particleColor;
+	instanceFrame = particleScaleFrame.w;
+}
+
+--- billboardFragmentInstanced
+
+// Must be added before billboardFragment
+
+#define INSTANCED
+
+flat in vec4 instanceColor;
+flat in float instanceFrame;
+
+#define inputColor instanceColor
+#define currentFrame instanceFrame
+
 --- billboardFragment
 
 in vec2 uv0;
@@ -26,12 +127,16 @@ uniform sampler2D depths;
 
 uniform sampler2D diffuseMap;
 uniform int hasDiffuseMap;
+#ifndef INSTANCED
 uniform vec4 inputColor;
+#endif
 uniform vec3 intensity;
 
 uniform int transparent;
 
+#ifndef INSTANCED
 uniform float currentFrame;
+#endif
 uniform int Xtiles;
 uniform int Ytiles;
 
@@ -8,7 +8,9 @@ in layout(location=3) vec2 uvs;
 in layout(location=4) uvec4 boneIndices;
 in layout(location=5) vec4 boneWeitghts;
 
+#ifndef INSTANCED
 uniform mat4 model;
+#endif
 uniform mat4 view;
 uniform mat4 proj;
 
@@ -0,0 +1,13 @@
+--- vertInstanced
+
+// Instanced variants read the model matrix of each instance from a storage buffer.
+// Must be added before the vertex snippet that uses 'model'.
+
+#define INSTANCED
+
+layout(std430, row_major, binding = 8) readonly buffer InstancesBuffer
+{
+    mat4 instanceModels[];
+};
+
+#define model instanceModels[gl_BaseInstance + gl_InstanceID]
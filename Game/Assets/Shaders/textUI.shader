@@ -1,28 +0,0 @@
---- vertTextUI
-
-layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
-out vec2 TexCoords;
-
-uniform mat4 proj;
-uniform mat4 view;
-uniform mat4 model;
-
-void main()
-{
-    gl_Position = proj * view * model * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
-}  
-
---- fragTextUI
-
-in vec2 TexCoords;
-out vec4 color;
-
-uniform sampler2D text;
-uniform vec4 textColor;
-
-void main()
-{    
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = SRGBA(textColor) * sampled;
-}  
\ No newline at end of file
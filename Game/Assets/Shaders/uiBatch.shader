@@ -0,0 +1,42 @@
+--- vertUIBatch
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec2 vertexUV0;
+layout(location = 2) in vec4 vertexColor;
+layout(location = 3) in vec2 vertexParams; // x: mode (0: color, 1: texture, 2: glyph), y: opaque
+
+uniform mat4 proj;
+uniform mat4 view;
+
+out vec2 uv0;
+out vec4 color;
+flat out vec2 params;
+
+void main()
+{
+	gl_Position = proj * view * vec4(vertexPosition, 1.0);
+	uv0 = vertexUV0;
+	color = vertexColor;
+	params = vertexParams;
+}
+
+--- fragUIBatch
+
+in vec2 uv0;
+in vec4 color;
+flat in vec2 params;
+
+uniform sampler2D diffuse;
+
+out vec4 outColor;
+
+void main()
+{
+	outColor = SRGBA(color);
+	if (params.x > 1.5) {
+		outColor.a *= texture(diffuse, uv0).r;
+	} else if (params.x > 0.5) {
+		outColor *= SRGBA(texture(diffuse, uv0));
+	}
+	outColor.a = mix(outColor.a, 1.0, params.y);
+}
@@ -19,13 +19,13 @@ int AnimationController::GetCurrentSample(const ResourceClip& clip, float& curre
 	return Clamp(currentSample, clip.beginIndex, clip.endIndex);
 }
 
-bool AnimationController::GetTransform(ResourceClip& clip, float& currentTime, const char* name, float3& pos, Quat& quat, ComponentAnimation &componentAnimation) {
+bool AnimationController::GetTransform(ResourceClip& clip, float& currentTime, unsigned boneIndex, float3& pos, Quat& quat, ComponentAnimation &componentAnimation) {
 	if (clip.animationUID == 0) {
 		return false;
 	}
 
-	ResourceAnimation* resourceAnimation = App->resources->GetResource<ResourceAnimation>(clip.animationUID);
-	if (resourceAnimation == nullptr || resourceAnimation->keyFrames.size() == 0) return false;
+	const AnimationBinding* binding = componentAnimation.BindAnimation(clip.animationUID);
+	if (binding == nullptr) return false;
 
 	//Resetting the events since it has been a loop only for one bone
 	if (  currentTime >= clip.duration) {
@@ -48,32 +48,22 @@ bool AnimationController::GetTransform(ResourceClip& clip, float& currentTime, c
 	int intPart = (int) currentSample;
 	float decimal = currentSample - intPart;
 
-	//find in hash by name
-	std::unordered_map<std::string, ResourceAnimation::Channel>::const_iterator channel = resourceAnimation->keyFrames[intPart].channels.find(name);
 	unsigned int idNext = intPart == (clip.endIndex) ? clip.beginIndex : intPart + 1;
-	std::unordered_map<std::string, ResourceAnimation::Channel>::const_iterator channelNext = resourceAnimation->keyFrames[idNext].channels.find(name);
 
-	if (channel == resourceAnimation->keyFrames[intPart].channels.end() && channelNext == resourceAnimation->keyFrames[idNext].channels.end()) {
-		return false;
-	}
-
-	pos = float3::Lerp(channel->second.tranlation, channelNext->second.tranlation, decimal);
-	quat = AnimationController::Interpolate(channel->second.rotation, channelNext->second.rotation, decimal);
-
-	return true;
+	return componentAnimation.SampleBone(*binding, intPart, idNext, decimal, boneIndex, pos, quat);
 }
 
-bool AnimationController::InterpolateTransitions(const std::list<AnimationInterpolation>::iterator& it, const std::list<AnimationInterpolation>& animationInterpolations, const GameObject& rootBone, const GameObject& gameObject, float3& pos, Quat& quat, ComponentAnimation &componentAnimation) {
-	ResourceClip* clip = App->resources->GetResource<ResourceClip>((*it).state->clipUid);
+bool AnimationController::InterpolateTransitions(const std::list<AnimationInterpolation>::iterator& it, const std::list<AnimationInterpolation>& animationInterpolations, const GameObject& rootBone, unsigned boneIndex, float3& pos, Quat& quat, ComponentAnimation &componentAnimation) {
+	ResourceClip* clip = componentAnimation.GetCachedResource<ResourceClip>((*it).state->clipUid);
 	if (!clip) {
 		return false;
 	}
-	bool result = GetTransform(*clip, (*it).currentTime, gameObject.name.c_str(), pos, quat, componentAnimation);
+	bool result = GetTransform(*clip, (*it).currentTime, boneIndex, pos, quat, componentAnimation);
 	bool resultInner = true; 
 	if (&(*it) != &(*std::prev(animationInterpolations.end())) && result) {
 		float3 position;
 		Quat rotation;
-		resultInner = AnimationController::InterpolateTransitions(std::next(it), animationInterpolations, rootBone, gameObject, position, rotation, componentAnimation);
+		resultInner = AnimationController::InterpolateTransitions(std::next(it), animationInterpolations, rootBone, boneIndex, position, rotation, componentAnimation);
 		if (resultInner) {
 			float weight = (*it).fadeTime / (*it).transitionTime;
 			pos = float3::Lerp(position,pos, weight);
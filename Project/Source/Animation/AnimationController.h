@@ -12,8 +12,8 @@ class ComponentAnimation;
 
 namespace AnimationController {
 	int GetCurrentSample(const ResourceClip& clip, float& currentTime);
-	bool GetTransform(ResourceClip& clip, float& currentTime, const char* name, float3& pos, Quat& quat, ComponentAnimation& componentAnimation );
-	bool InterpolateTransitions(const std::list<AnimationInterpolation>::iterator& it, const std::list<AnimationInterpolation>& animationInterpolations, const GameObject& rootBone, const GameObject& gameObject, float3& pos, Quat& quat, ComponentAnimation& componentAnimation);
+	bool GetTransform(ResourceClip& clip, float& currentTime, unsigned boneIndex, float3& pos, Quat& quat, ComponentAnimation& componentAnimation );
+	bool InterpolateTransitions(const std::list<AnimationInterpolation>::iterator& it, const std::list<AnimationInterpolation>& animationInterpolations, const GameObject& rootBone, unsigned boneIndex, float3& pos, Quat& quat, ComponentAnimation& componentAnimation);
 	bool UpdateTransitions(std::list<AnimationInterpolation>& animationInterpolations, std::unordered_map<UID,float>& currentTimeStates, const float time);
 	Quat Interpolate(const Quat& first, const Quat& second, float lambda);
 };
\ No newline at end of file
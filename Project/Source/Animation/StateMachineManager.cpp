@@ -66,16 +66,16 @@ void StateMachineManager::SendTrigger(const std::string& trigger, StateMachineEn
 	}
 }
 
-bool StateMachineManager::UpdateAnimations(GameObject* gameObject, const GameObject& owner, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine) {
+bool StateMachineManager::UpdateAnimations(GameObject* gameObject, unsigned boneIndex, const GameObject& owner, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine) {
 	bool result = true;
 	StateMachineEnum stateMachineSelected = StateMachineEnum::PRINCIPAL;
 	//The currentStateSecondary could be an empty State object with the id of zero in case for the second state machine
 	if (componentAnimation.currentStateSecondary.id != 0) {
-		ResourceStateMachine* resourceStateMachine = App->resources->GetResource<ResourceStateMachine>(componentAnimation.stateMachineResourceUIDSecondary);
+		ResourceStateMachine* resourceStateMachine = componentAnimation.GetCachedResource<ResourceStateMachine>(componentAnimation.stateMachineResourceUIDSecondary);
 		//Looking for the bone if is it in the state machine in order to be applied
 		if (resourceStateMachine && !resourceStateMachine->bones.empty()) {
-			auto nameBone = resourceStateMachine->bones.find(gameObject->name);
-			if (nameBone != resourceStateMachine->bones.end()) {
+			const StateMachineBinding& binding = componentAnimation.BindStateMachine(StateMachineEnum::SECONDARY, *resourceStateMachine);
+			if (boneIndex < binding.animatedBones.size() && binding.animatedBones[boneIndex]) {
 				stateMachineSelected = StateMachineEnum::SECONDARY;
 			}
 		}
@@ -84,15 +84,15 @@ bool StateMachineManager::UpdateAnimations(GameObject* gameObject, const GameObj
 	//Selecting which state machine is going to be used
 	switch (stateMachineSelected) {
 	case StateMachineEnum::PRINCIPAL:
-		result = StateMachineManager::CalculateAnimation(gameObject, owner, stateMachineSelected, componentAnimation, position, rotation, resetSecondaryStatemachine);
+		result = StateMachineManager::CalculateAnimation(gameObject, boneIndex, owner, stateMachineSelected, componentAnimation, position, rotation, resetSecondaryStatemachine);
 		break;
 	case StateMachineEnum::SECONDARY:
-		ResourceStateMachine* resourceStateMachinePrincipal = App->resources->GetResource<ResourceStateMachine>(componentAnimation.stateMachineResourceUIDPrincipal);
+		ResourceStateMachine* resourceStateMachinePrincipal = componentAnimation.GetCachedResource<ResourceStateMachine>(componentAnimation.stateMachineResourceUIDPrincipal);
 		bool secondaryToAnyPrincipal = false;
 		if (resourceStateMachinePrincipal) {
 			secondaryToAnyPrincipal = StateMachineManager::SecondaryEqualsToAnyPrincipal(componentAnimation.currentStateSecondary, resourceStateMachinePrincipal->states);
 		}
-		result = StateMachineManager::CalculateAnimation(gameObject, owner, stateMachineSelected, componentAnimation, position, rotation, resetSecondaryStatemachine, secondaryToAnyPrincipal);
+		result = StateMachineManager::CalculateAnimation(gameObject, boneIndex, owner, stateMachineSelected, componentAnimation, position, rotation, resetSecondaryStatemachine, secondaryToAnyPrincipal);
 		break;
 	}
 
@@ -105,7 +105,7 @@ bool StateMachineManager::SecondaryEqualsToAnyPrincipal(const State& currentStat
 	}
 	return false;
 }
-bool StateMachineManager::CalculateAnimation(GameObject* gameObject, const GameObject& owner, StateMachineEnum stateMachineSelected, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine, bool principalEqualSecondary) {
+bool StateMachineManager::CalculateAnimation(GameObject* gameObject, unsigned boneIndex, const GameObject& owner, StateMachineEnum stateMachineSelected, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine, bool principalEqualSecondary) {
 	bool result = false;
 
 	bool isPrincipal = stateMachineSelected == StateMachineEnum::PRINCIPAL;
@@ -114,7 +114,7 @@ bool StateMachineManager::CalculateAnimation(GameObject* gameObject, const GameO
 	std::unordered_map<UID, float>* currentTimeStates = isPrincipal ? &componentAnimation.currentTimeStatesPrincipal : &componentAnimation.currentTimeStatesSecondary;
 	std::list<AnimationInterpolation>* animationInterpolations = isPrincipal ? &componentAnimation.animationInterpolationsPrincipal : &componentAnimation.animationInterpolationsSecondary;
 
-	ResourceStateMachine* resourceStateMachine = App->resources->GetResource<ResourceStateMachine>(stateMachineResourceUID);
+	ResourceStateMachine* resourceStateMachine = componentAnimation.GetCachedResource<ResourceStateMachine>(stateMachineResourceUID);
 	if (!resourceStateMachine) {
 		return result;
 	}
@@ -123,14 +123,15 @@ bool StateMachineManager::CalculateAnimation(GameObject* gameObject, const GameO
 		return result;
 	}
 
-	ResourceClip* clip = App->resources->GetResource<ResourceClip>(currentState.clipUid);
+	ResourceClip* clip = componentAnimation.GetCachedResource<ResourceClip>(currentState.clipUid);
 	if (!clip) {
 		return result;
 	}
 	int currentSample = AnimationController::GetCurrentSample(*clip, (*currentTimeStates)[currentState.id]);
 
-	
-	if (gameObject->name == (*resourceStateMachine->bones.begin())) {
+	const StateMachineBinding& binding = componentAnimation.BindStateMachine(stateMachineSelected, *resourceStateMachine);
+	bool isFirstBone = boneIndex < binding.firstBones.size() && binding.firstBones[boneIndex];
+	if (isFirstBone) {
 		//Sending Event on Finished
 		if (!clip->loop) {
 			// Checking if the current sample is the last keyframe in order to send the event
@@ -180,10 +181,10 @@ bool StateMachineManager::CalculateAnimation(GameObject* gameObject, const GameO
 
 	//Checking for transition between states
 	if ((*animationInterpolations).size() > 1) {
-		result = AnimationController::InterpolateTransitions((*animationInterpolations).begin(), (*animationInterpolations), *owner.GetRootBone(), *gameObject, position, rotation, componentAnimation);
+		result = AnimationController::InterpolateTransitions((*animationInterpolations).begin(), (*animationInterpolations), *owner.GetRootBone(), boneIndex, position, rotation, componentAnimation);
 
 		//Updating times
-		if (gameObject->name == (*resourceStateMachine->bones.begin())) { // Only udate currentTime for the rootBone
+		if (isFirstBone) { // Only udate currentTime for the rootBone
 			bool finishedTransition = AnimationController::UpdateTransitions((*animationInterpolations), (*currentTimeStates), App->time->GetDeltaTime());
 			//Comparing the state principal with state secondary & set variable for setting secondary state as "empty" State
 			if (finishedTransition && principalEqualSecondary) {
@@ -197,7 +198,7 @@ bool StateMachineManager::CalculateAnimation(GameObject* gameObject, const GameO
 				resetSecondaryStatemachine = true;
 			}
 
-			result = AnimationController::GetTransform(*clip, (*currentTimeStates)[currentState.id], gameObject->name.c_str(), position, rotation, componentAnimation);
+			result = AnimationController::GetTransform(*clip, (*currentTimeStates)[currentState.id], boneIndex, position, rotation, componentAnimation);
 		}
 	}
 
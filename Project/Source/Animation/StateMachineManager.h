@@ -19,11 +19,11 @@ namespace StateMachineManager {
 
 	void SendTrigger(const std::string& trigger, StateMachineEnum stateMachineSelected, ComponentAnimation& componentAnimation);
 
-	bool UpdateAnimations(GameObject* gameObject, const GameObject& owner, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine);
+	bool UpdateAnimations(GameObject* gameObject, unsigned boneIndex, const GameObject& owner, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine);
 
 	bool SecondaryEqualsToAnyPrincipal(const State& currentStateSecondary, const std::unordered_map<UID, State>& states);
 
-	bool CalculateAnimation(GameObject* gameObject, const GameObject& owner, StateMachineEnum stateMachineSelected, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine, bool principalEqualSecondary = false);
+	bool CalculateAnimation(GameObject* gameObject, unsigned boneIndex, const GameObject& owner, StateMachineEnum stateMachineSelected, ComponentAnimation& componentAnimation, float3& position, Quat& rotation, bool& resetSecondaryStatemachine, bool principalEqualSecondary = false);
 
 	void ResetKeyEvents(ComponentAnimation& componentAnimation, const State& state);
 }; // namespace StateMachineManager
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include "Modules/ModulePhysics.h"
 #include "Modules/ModuleNavigation.h"
 #include "Modules/ModuleConfiguration.h"
+#include "Modules/ModuleJobs.h"
 
 #include "SDL_timer.h"
 #include <windows.h>
@@ -35,6 +36,7 @@ Application::Application() {
 	modules.push_back(hardware = new ModuleHardwareInfo());
 	modules.push_back(files = new ModuleFiles());
 	modules.push_back(configuration = new ModuleConfiguration());
+	modules.push_back(jobs = new ModuleJobs());
 	modules.push_back(window = new ModuleWindow());
 	modules.push_back(project = new ModuleProject());
 	modules.push_back(resources = new ModuleResources());
@@ -66,6 +68,7 @@ bool Application::Init() {
 
 	for (std::vector<Module*>::iterator it = modules.begin(); it != modules.end() && ret; ++it) {
 		ret = (*it)->Init();
+		logger->UpdateLogString(); // Modules can log a lot while loading, so the log ring is emptied after each one
 	}
 
 	return ret;
@@ -76,6 +79,7 @@ bool Application::Start() {
 
 	for (std::vector<Module*>::iterator it = modules.begin(); it != modules.end() && ret; ++it) {
 		ret = (*it)->Start();
+		logger->UpdateLogString();
 	}
 
 	return ret;
@@ -89,14 +93,30 @@ UpdateStatus Application::Update() {
 	for (std::vector<Module*>::iterator it = modules.begin(); it != modules.end() && ret == UpdateStatus::CONTINUE; ++it) {
 		ret = (*it)->PreUpdate();
 	}
+	events->FlushEvents();
+
+	// Fixed steps of game time accumulated since the last frame
+	unsigned fixedSteps = time->GetFixedStepsThisFrame();
+	for (unsigned step = 0; step < fixedSteps && ret == UpdateStatus::CONTINUE; ++step) {
+		time->BeginFixedStep();
+		for (std::vector<Module*>::iterator it = modules.begin(); it != modules.end() && ret == UpdateStatus::CONTINUE; ++it) {
+			ret = (*it)->FixedUpdate();
+		}
+		time->EndFixedStep();
+		events->FlushEvents();
+	}
 
 	for (std::vector<Module*>::iterator it = modules.begin(); it != modules.end() && ret == UpdateStatus::CONTINUE; ++it) {
 		ret = (*it)->Update();
 	}
+	events->FlushEvents();
 
 	for (std::vector<Module*>::iterator it = modules.begin(); it != modules.end() && ret == UpdateStatus::CONTINUE; ++it) {
 		ret = (*it)->PostUpdate();
 	}
+	events->FlushEvents();
+
+	logger->UpdateLogString();
 
 	time->WaitForEndOfFrame();
 
@@ -108,6 +128,7 @@ bool Application::CleanUp() {
 
 	for (std::vector<Module*>::reverse_iterator it = modules.rbegin(); it != modules.rend() && ret; ++it) {
 		ret = (*it)->CleanUp();
+		logger->UpdateLogString();
 	}
 
 	return ret;
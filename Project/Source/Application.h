@@ -22,6 +22,7 @@ class ModuleUserInterface;
 class ModuleAudio;
 class ModuleProject;
 class ModuleEvents;
+class ModuleJobs;
 class ModulePhysics;
 class ModuleNavigation;
 class ModuleConfiguration;
@@ -58,6 +59,7 @@ public:
 	ModuleAudio* audio = nullptr;
 	ModuleProject* project = nullptr;
 	ModuleEvents* events = nullptr;
+	ModuleJobs* jobs = nullptr;
 	ModulePhysics* physics = nullptr;
 	ModuleNavigation* navigation = nullptr;
 	ModuleConfiguration* configuration = nullptr;
@@ -19,6 +19,8 @@ void Component::Start() {}
 
 void Component::Update() {}
 
+void Component::FixedUpdate() {}
+
 void Component::DrawGizmos() {}
 
 void Component::OnEditorUpdate() {}
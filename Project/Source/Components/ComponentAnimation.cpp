@@ -50,19 +50,20 @@ void ComponentAnimation::Update() {
 	LoadStateMachines();
 
 	// Update gameobjects matrix
-	GameObject* rootBone = GetOwner().GetRootBone();
+	UpdateBones(GetOwner().GetRootBone());
+	numPoses = 0;
 
-	UpdateAnimations(rootBone);
+	UpdateAnimations();
 
 	if (loadedResourceStateMachine && animationInterpolationsPrincipal.empty()) {
-		ResourceClip* currentClip = App->resources->GetResource<ResourceClip>(currentStatePrincipal.clipUid);
+		ResourceClip* currentClip = GetCachedResource<ResourceClip>(currentStatePrincipal.clipUid);
 		if (!currentClip) {
 			return;
 		}
 		currentTimeStatesPrincipal[currentStatePrincipal.id] += App->time->GetDeltaTime() * currentClip->speed;
 	}
 	if (loadedResourceStateMachineSecondary && currentStateSecondary.id != 0 && animationInterpolationsSecondary.empty()) {
-		ResourceClip* currentClip = App->resources->GetResource<ResourceClip>(currentStateSecondary.clipUid);
+		ResourceClip* currentClip = GetCachedResource<ResourceClip>(currentStateSecondary.clipUid);
 		if (!currentClip) {
 			return;
 		}
@@ -130,46 +131,152 @@ void ComponentAnimation::SendTriggerSecondary(const std::string& trigger) {
 	StateMachineManager::SendTrigger(trigger, StateMachineEnum::SECONDARY, *this);
 }
 
-void ComponentAnimation::UpdateAnimations(GameObject* gameObject) {
-	if (gameObject == nullptr) {
-		return;
+const AnimationBinding* ComponentAnimation::BindAnimation(UID animationId) {
+	AnimationBinding* binding = nullptr;
+	for (AnimationBinding& element : animationBindings) {
+		if (element.animationId == animationId) {
+			binding = &element;
+			break;
+		}
+	}
+	if (binding == nullptr) {
+		binding = &animationBindings.emplace_back();
+		binding->animationId = animationId;
 	}
 
-	//find gameobject in hash
-	float3 position = float3::zero;
-	Quat rotation = Quat::identity;
-	bool resetSecondaryStatemachine = false;
+	ResourceAnimation* animation = App->resources->GetResource<ResourceAnimation>(animationId, binding->handle);
+	if (animation == nullptr || animation->GetNumKeyFrames() == 0) return nullptr;
 
-	bool result = StateMachineManager::UpdateAnimations(
-		gameObject,
-		GetOwner(),
-		*this,
-		position,
-		rotation,
-		resetSecondaryStatemachine);
+	// Resolve the channels again if the animation has been reloaded
+	if (animation != binding->animation || animation->GetNumChannels() != binding->numChannels) {
+		binding->animation = animation;
+		binding->numChannels = animation->GetNumChannels();
+		binding->channels.resize(bones.size());
+		for (unsigned i = 0; i < bones.size(); ++i) {
+			binding->channels[i] = animation->FindChannel(bones[i]->name);
+		}
+		numPoses = 0;
+	}
 
-	//If finishedTransition and currentStateSecondary equals to currentStatePrincipal we must reset the currentStateSecondary to "empty" state
-	//See line 84 of StateMachineManager.cpp
-	if (resetSecondaryStatemachine) {
-		ResourceStateMachine* resourceStateMachine = App->resources->GetResource<ResourceStateMachine>(stateMachineResourceUIDSecondary);
-		if (!resourceStateMachine) {
-			return;
+	return binding;
+}
+
+const StateMachineBinding& ComponentAnimation::BindStateMachine(StateMachineEnum stateMachineSelected, const ResourceStateMachine& resourceStateMachine) {
+	StateMachineBinding& binding = stateMachineBindings[(int) stateMachineSelected];
+
+	// Resolve the bones again if the state machine has changed or has been reloaded
+	if (binding.stateMachine != &resourceStateMachine || binding.numBones != resourceStateMachine.bones.size() || binding.animatedBones.size() != bones.size()) {
+		binding.stateMachine = &resourceStateMachine;
+		binding.numBones = (unsigned) resourceStateMachine.bones.size();
+		binding.animatedBones.resize(bones.size());
+		binding.firstBones.resize(bones.size());
+		for (unsigned i = 0; i < bones.size(); ++i) {
+			const std::string& name = bones[i]->name;
+			binding.animatedBones[i] = resourceStateMachine.bones.find(name) != resourceStateMachine.bones.end();
+			binding.firstBones[i] = !resourceStateMachine.bones.empty() && name == *resourceStateMachine.bones.begin();
 		}
-		std::unordered_map<UID, State>::iterator it = resourceStateMachine->states.find(0); // Get "empty" state
-		if (it != resourceStateMachine->states.end()) {
-			currentStateSecondary = (*it).second;
+	}
+
+	return binding;
+}
+
+bool ComponentAnimation::SampleBone(const AnimationBinding& binding, unsigned keyFrame, unsigned nextKeyFrame, float lambda, unsigned boneIndex, float3& position, Quat& rotation) {
+	if (boneIndex >= binding.channels.size() || binding.channels[boneIndex] == ANIMATION_INVALID_CHANNEL) return false;
+
+	AnimationPose* pose = nullptr;
+	for (unsigned i = 0; i < numPoses; ++i) {
+		AnimationPose& cachedPose = poses[i];
+		if (cachedPose.animationId == binding.animationId && cachedPose.keyFrame == keyFrame && cachedPose.nextKeyFrame == nextKeyFrame && cachedPose.lambda == lambda) {
+			pose = &cachedPose;
+			break;
+		}
+	}
+
+	if (pose == nullptr) {
+		if (numPoses < ANIMATION_POSE_CACHE_SIZE) {
+			pose = &poses[numPoses++];
+		} else {
+			pose = &poses[nextPose];
+			nextPose = (nextPose + 1) % ANIMATION_POSE_CACHE_SIZE;
 		}
+
+		pose->animationId = binding.animationId;
+		pose->keyFrame = keyFrame;
+		pose->nextKeyFrame = nextKeyFrame;
+		pose->lambda = lambda;
+		pose->positions.resize(bones.size());
+		pose->rotations.resize(bones.size());
+		binding.animation->SampleChannels(binding.channels.data(), (unsigned) binding.channels.size(), keyFrame, nextKeyFrame, lambda, pose->positions.data(), pose->rotations.data());
 	}
 
-	ComponentTransform* componentTransform = gameObject->GetComponent<ComponentTransform>();
+	position = pose->positions[boneIndex];
+	rotation = pose->rotations[boneIndex];
+	return true;
+}
+
+void ComponentAnimation::UpdateBones(GameObject* rootBone) {
+	gatheredBones.clear();
+	if (rootBone != nullptr) {
+		boneStack.push_back(rootBone);
+		while (!boneStack.empty()) {
+			GameObject* bone = boneStack.back();
+			boneStack.pop_back();
+			gatheredBones.push_back(bone);
 
-	if (componentTransform && result) {
-		componentTransform->SetPosition(position);
-		componentTransform->SetRotation(rotation);
+			const std::vector<GameObject*>& children = bone->GetChildren();
+			for (auto it = children.rbegin(); it != children.rend(); ++it) {
+				boneStack.push_back(*it);
+			}
+		}
 	}
 
-	for (GameObject* child : gameObject->GetChildren()) {
-		UpdateAnimations(child);
+	// The bindings are indexed by bone, so they have to be resolved again when the hierarchy changes
+	if (gatheredBones != bones) {
+		bones.swap(gatheredBones);
+		animationBindings.clear();
+		for (StateMachineBinding& binding : stateMachineBindings) {
+			binding.stateMachine = nullptr;
+		}
+		numPoses = 0;
+	}
+}
+
+void ComponentAnimation::UpdateAnimations() {
+	for (unsigned boneIndex = 0; boneIndex < bones.size(); ++boneIndex) {
+		GameObject* gameObject = bones[boneIndex];
+
+		float3 position = float3::zero;
+		Quat rotation = Quat::identity;
+		bool resetSecondaryStatemachine = false;
+
+		bool result = StateMachineManager::UpdateAnimations(
+			gameObject,
+			boneIndex,
+			GetOwner(),
+			*this,
+			position,
+			rotation,
+			resetSecondaryStatemachine);
+
+		//If finishedTransition and currentStateSecondary equals to currentStatePrincipal we must reset the currentStateSecondary to "empty" state
+		//See line 84 of StateMachineManager.cpp
+		if (resetSecondaryStatemachine) {
+			ResourceStateMachine* resourceStateMachine = GetCachedResource<ResourceStateMachine>(stateMachineResourceUIDSecondary);
+			if (!resourceStateMachine) {
+				continue;
+			}
+			std::unordered_map<UID, State>::iterator it = resourceStateMachine->states.find(0); // Get "empty" state
+			if (it != resourceStateMachine->states.end()) {
+				currentStateSecondary = (*it).second;
+			}
+		}
+
+		ComponentTransform* componentTransform = gameObject->GetComponent<ComponentTransform>();
+
+		if (componentTransform && result) {
+			componentTransform->SetPosition(position);
+			componentTransform->SetRotation(rotation);
+		}
 	}
 }
 
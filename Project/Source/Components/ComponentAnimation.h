@@ -9,15 +9,53 @@
 #include "Animation/AnimationInterpolation.h"
 #include "Resources/ResourceStateMachine.h"
 #include "Resources/ResourceClip.h"
+#include "Resources/ResourceHandle.h"
 #include "Utils/UID.h"
 
+#include "Math/float3.h"
+#include "Math/Quat.h"
 #include <string>
+#include <vector>
 #include <unordered_map>
 
+#define ANIMATION_POSE_CACHE_SIZE 8 // Maximum number of different samples blended in the same frame
+
 class GameObject;
 class ResourceAnimation;
 class ResourceTransition;
 
+/* Bones are animated by index instead of by name. The bones under the root bone are gathered in hierarchy order,
+*  and every animation is bound once to them by resolving the channel of each bone. The first bone that needs a sample
+*  of an animation samples all the bones at once, and the rest of the bones read it from the pose cache.
+*/
+
+// Channel of each bone in an animation
+struct AnimationBinding {
+	UID animationId = 0;
+	ResourceHandle handle;
+	const ResourceAnimation* animation = nullptr;
+	unsigned numChannels = 0;
+	std::vector<int> channels; // ANIMATION_INVALID_CHANNEL for the bones that the animation doesn't move
+};
+
+// Bones of a state machine, resolved by name once instead of every frame
+struct StateMachineBinding {
+	const ResourceStateMachine* stateMachine = nullptr;
+	unsigned numBones = 0;
+	std::vector<bool> animatedBones; // Bones whose name is in the bones of the state machine
+	std::vector<bool> firstBones;	 // Bones named as the first bone of the state machine. They send the events and update the times
+};
+
+// Sampled transforms of every bone. Only valid for the frame in which they are sampled
+struct AnimationPose {
+	UID animationId = 0;
+	unsigned keyFrame = 0;
+	unsigned nextKeyFrame = 0;
+	float lambda = 0.0f;
+	std::vector<float3> positions;
+	std::vector<Quat> rotations;
+};
+
 class ComponentAnimation : public Component {
 public:
 	REGISTER_COMPONENT(ComponentAnimation, ComponentType::ANIMATION, false); // Refer to ComponentType for the Constructor
@@ -32,6 +70,16 @@ public:
 
 	void OnUpdate();
 
+	const AnimationBinding* BindAnimation(UID animationId); // Returns nullptr if the animation isn't loaded
+	const StateMachineBinding& BindStateMachine(StateMachineEnum stateMachineSelected, const ResourceStateMachine& resourceStateMachine);
+	bool SampleBone(const AnimationBinding& binding, unsigned keyFrame, unsigned nextKeyFrame, float lambda, unsigned boneIndex, float3& position, Quat& rotation);
+
+	// Resolves the resource through a handle cached by the component, without locking the resources
+	template<typename T>
+	T* GetCachedResource(UID id) {
+		return App->resources->GetResource<T>(id, resourceHandles[id]);
+	}
+
 	TESSERACT_ENGINE_API void SendTrigger(const std::string& trigger); // Method to trigger the change of state
 	TESSERACT_ENGINE_API void SendTriggerSecondary(const std::string& trigger); // Method to trigger the change of state
 
@@ -64,9 +112,20 @@ public:
 	std::unordered_map<UID, float> currentTimeStatesSecondary;
 
 private:
-	void UpdateAnimations(GameObject* gameObject);
+	void UpdateBones(GameObject* rootBone);
+	void UpdateAnimations();
 	void LoadStateMachines();
 	bool loadedResourceStateMachine = false;
 	bool loadedResourceStateMachineSecondary = false;
 
+	std::vector<GameObject*> bones; // Hierarchy order, parents first
+	std::vector<GameObject*> gatheredBones;
+	std::vector<GameObject*> boneStack;
+	std::vector<AnimationBinding> animationBindings;
+	StateMachineBinding stateMachineBindings[2]; // Indexed by StateMachineEnum
+	AnimationPose poses[ANIMATION_POSE_CACHE_SIZE];
+	unsigned numPoses = 0;
+	unsigned nextPose = 0;
+	std::unordered_map<UID, ResourceHandle> resourceHandles;
+
 };
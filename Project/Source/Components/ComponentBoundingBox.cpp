@@ -4,6 +4,7 @@
 #include "Globals.h"
 #include "Application.h"
 #include "GameObject.h"
+#include "Scene.h"
 #include "Modules/ModuleEditor.h"
 #include "Components/ComponentTransform.h"
 #include "Resources/ResourceMaterial.h"
@@ -48,11 +49,21 @@ void ComponentBoundingBox::Load(JsonValue jComponent) {
 	localAABB.maxPoint.Set(jLocalBoundingBox[3], jLocalBoundingBox[4], jLocalBoundingBox[5]);
 
 	dirty = true;
+	QueueDynamicTreeUpdate();
 }
 
 void ComponentBoundingBox::SetLocalBoundingBox(const AABB& boundingBox) {
 	localAABB = boundingBox;
 	dirty = true;
+	QueueDynamicTreeUpdate();
+}
+
+void ComponentBoundingBox::SetDynamicTreeLeaf(int leaf) {
+	dynamicTreeLeaf = leaf;
+}
+
+void ComponentBoundingBox::SetDynamicTreeQueueIndex(int index) {
+	dynamicTreeQueueIndex = index;
 }
 
 void ComponentBoundingBox::CalculateWorldBoundingBox(bool force) {
@@ -84,16 +95,11 @@ void ComponentBoundingBox::DrawBoundingBox() {
 
 void ComponentBoundingBox::Invalidate() {
 	dirty = true;
+	QueueDynamicTreeUpdate();
 
 	ComponentMeshRenderer* meshRenderer = GetOwner().GetComponent<ComponentMeshRenderer>();
 	if (meshRenderer) {
-		UID materialUID = meshRenderer->GetMaterial();
-		ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialUID);
-		if (material->castShadows) {
-			App->renderer->lightFrustumStatic.Invalidate();
-			App->renderer->lightFrustumDynamic.Invalidate();
-			App->renderer->lightFrustumMainEntities.Invalidate();
-		}
+		meshRenderer->InvalidateShadowCaster();
 	}
 
 }
@@ -108,10 +114,33 @@ const AABB& ComponentBoundingBox::GetWorldAABB() {
 	return worldAABB;
 }
 
+bool ComponentBoundingBox::IsDirty() const {
+	return dirty;
+}
+
 const AABB& ComponentBoundingBox::GetLocalAABB() {
 	return localAABB;
 }
 
+int ComponentBoundingBox::GetDynamicTreeLeaf() const {
+	return dynamicTreeLeaf;
+}
+
+int ComponentBoundingBox::GetDynamicTreeQueueIndex() const {
+	return dynamicTreeQueueIndex;
+}
+
+bool ComponentBoundingBox::IsDynamicTreeQueued() const {
+	return dynamicTreeQueueIndex != BOUNDING_BOX_NOT_QUEUED;
+}
+
+void ComponentBoundingBox::QueueDynamicTreeUpdate() {
+	Scene* scene = GetOwner().scene;
+	if (scene == nullptr) return;
+
+	scene->QueueDynamicTreeUpdate(this);
+}
+
 const float3 ComponentBoundingBox::GetLocalMinPointAABB() {
 	CalculateWorldBoundingBox();
 	return localAABB.minPoint;
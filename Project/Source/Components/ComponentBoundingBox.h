@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Component.h"
+#include "Utils/DynamicAABBTree.h"
 
 #include "Geometry/AABB.h"
 #include "Geometry/OBB.h"
 
+#define BOUNDING_BOX_NOT_QUEUED -1
+
 class ComponentBoundingBox : public Component {
 public:
 	REGISTER_COMPONENT(ComponentBoundingBox, ComponentType::BOUNDING_BOX, false); // Refer to ComponentType for the Constructor
@@ -23,15 +26,26 @@ public:
 	// ---------- Setters ---------- //
 	void Invalidate(); // Sets dirty to true. This function must be called any time the Transform of the GameObject has changed, to recalculate the BBs on the next frame.
 	void SetLocalBoundingBox(const AABB& boundingBox);
+	void SetDynamicTreeLeaf(int leaf);
+	void SetDynamicTreeQueueIndex(int index); // BOUNDING_BOX_NOT_QUEUED when the bounding box leaves the queue
 
 	// ---------- Getters ---------- //
 	TESSERACT_ENGINE_API const OBB& GetWorldOBB();
 	TESSERACT_ENGINE_API const AABB& GetWorldAABB();
 	const AABB& GetLocalAABB();
+	int GetDynamicTreeLeaf() const;
+	int GetDynamicTreeQueueIndex() const;
+	bool IsDynamicTreeQueued() const;
+	bool IsDirty() const;
+
+private:
+	void QueueDynamicTreeUpdate(); // Notifies the scene that the world AABB has changed, so that it's updated in the dynamic tree and the raycast tree
 
 private:
 	AABB localAABB = {{0, 0, 0}, {0, 0, 0}}; // Axis Aligned Bounding Box, local to the GameObject
 	AABB worldAABB = {{0, 0, 0}, {0, 0, 0}}; // Axis Aligned Bounding Box in world coordinates. Used for Culling and other camera calculations.
 	OBB worldOBB = {worldAABB};				 // Oriented Bounding Box. This is the one that will be rendered.
 	bool dirty = true;						 // If set to true CalculateWorldBoundingBox() will update the BBs on the next frame. Otherwise, it will skip the calculations.
+	int dynamicTreeLeaf = DYNAMIC_AABB_TREE_NULL_NODE;	 // Leaf of the bounding box in the scene's dynamic tree. Bounding boxes in the quadtree aren't in the dynamic tree
+	int dynamicTreeQueueIndex = BOUNDING_BOX_NOT_QUEUED; // Position in the scene's queue of bounding boxes waiting to be updated in the dynamic tree
 };
@@ -20,6 +20,7 @@
 #include "Components/ComponentBoundingBox.h"
 #include "Components/ComponentAnimation.h"
 #include "FileSystem/TextureImporter.h"
+#include "Rendering/RenderQueue.h"
 #include "Utils/ImGuiUtils.h"
 
 #include "Geometry/Sphere.h"
@@ -63,15 +64,15 @@ void ComponentMeshRenderer::OnEditorUpdate() {
 	}
 
 	if (ImGui::TreeNode("Mesh")) {
-		ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId);
+		ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
 		if (mesh != nullptr) {
 			ImGui::TextColored(App->editor->titleColor, "Geometry");
 			ImGui::TextWrapped("Num Vertices: ");
 			ImGui::SameLine();
-			ImGui::TextColored(App->editor->textColor, "%d", mesh->vertices.size());
+			ImGui::TextColored(App->editor->textColor, "%d", mesh->numVertices);
 			ImGui::TextWrapped("Num Triangles: ");
 			ImGui::SameLine();
-			ImGui::TextColored(App->editor->textColor, "%d", mesh->indices.size() / 3);
+			ImGui::TextColored(App->editor->textColor, "%d", mesh->numIndices / 3);
 			ImGui::Separator();
 			ImGui::TextColored(App->editor->titleColor, "Bounding Box");
 
@@ -88,19 +89,26 @@ void ComponentMeshRenderer::OnEditorUpdate() {
 	ImGui::ResourceSlot<ResourceMaterial>(
 		"Material",
 		&materialId,
-		[this]() { DeleteRenderingModeMask(); },
-		[this]() { UpdateMasks(); });
+		[this]() {
+			DeleteRenderingModeMask();
+			InvalidateShadowCaster();
+		},
+		[this]() {
+			UpdateMasks();
+			InvalidateShadowCaster();
+		});
 
 	if (ImGui::Button("Remove##material")) {
 		if (materialId != 0) {
 			DeleteRenderingModeMask();
+			InvalidateShadowCaster();
 			AddShadowCaster();
 			App->resources->DecreaseReferenceCount(materialId);
 			materialId = 0;
 		}
 	}
 	if (ImGui::TreeNode("Material")) {
-		ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+		ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 		if (material != nullptr) {
 			material->OnEditorUpdate();
 
@@ -130,10 +138,12 @@ void ComponentMeshRenderer::OnEditorUpdate() {
 void ComponentMeshRenderer::Init() {
 	App->resources->IncreaseReferenceCount(meshId);
 	App->resources->IncreaseReferenceCount(materialId);
+	meshHandle = App->resources->GetResourceHandle(meshId);
+	materialHandle = App->resources->GetResourceHandle(materialId);
 
 	UpdateMasks();
 
-	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId);
+	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
 	if (mesh == nullptr) return;
 
 	palette.resize(mesh->bones.size());
@@ -155,7 +165,7 @@ void ComponentMeshRenderer::Init() {
 }
 
 void ComponentMeshRenderer::Update() {
-	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId);
+	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
 	if (!mesh) return;
 
 	if (palette.empty()) {
@@ -173,9 +183,9 @@ void ComponentMeshRenderer::Update() {
 	const GameObject* rootBone = parent->GetRootBone();
 	if (rootBone != nullptr) {
 		const GameObject* rootBoneParent = rootBone->GetParent();
-		const float4x4& invertedRootBoneTransform = rootBoneParent ? rootBoneParent->GetComponent<ComponentTransform>()->GetGlobalMatrix().Inverted() : float4x4::identity;
+		float4x4 invertedRootBoneTransform = rootBoneParent ? rootBoneParent->GetComponent<ComponentTransform>()->GetGlobalMatrix().Inverted() : float4x4::identity;
 
-		const float4x4& localMatrix = GetOwner().GetComponent<ComponentTransform>()->GetLocalMatrix();
+		float4x4 localMatrix = GetOwner().GetComponent<ComponentTransform>()->GetLocalMatrix();
 		for (unsigned i = 0; i < mesh->bones.size(); ++i) {
 			const GameObject* bone = goBones.at(mesh->bones[i].boneName);
 			palette[i] = localMatrix * invertedRootBoneTransform * bone->GetComponent<ComponentTransform>()->GetGlobalMatrix() * mesh->bones[i].transform;
@@ -197,86 +207,123 @@ void ComponentMeshRenderer::Start() {
 	ResetDissolveValues();
 }
 
-void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
+void ComponentMeshRenderer::OnEnable() {
+	InvalidateShadowCaster();
+}
+
+void ComponentMeshRenderer::OnDisable() {
+	InvalidateShadowCaster();
+}
+
+void ComponentMeshRenderer::Draw(const float4x4& modelMatrix, RenderState* renderState) {
 	if (!IsActive()) return;
 
-	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId);
+	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
 	if (mesh == nullptr) return;
 
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (material == nullptr) return;
 
+	// Draws outside of a render queue set all their state and leave nothing bound
+	RenderState standaloneRenderState;
+	if (renderState == nullptr) renderState = &standaloneRenderState;
+	DEFER {
+		if (renderState == &standaloneRenderState) glBindVertexArray(0);
+	};
+
 	// Specific shader settings
 	unsigned glTextureNormal = 0;
-	ResourceTexture* normal = App->resources->GetResource<ResourceTexture>(material->normalMapId);
+	ResourceTexture* normal = App->resources->GetResource<ResourceTexture>(material->normalMapId, material->normalMapHandle);
 	glTextureNormal = normal ? normal->glTexture : 0;
 	int hasNormalMap = normal ? 1 : 0;
 
+	// Instanced draws read the model matrices from the instance buffer
+	bool instanced = renderState->instanceCount > 0;
+
 	ProgramStandard* standardProgram = nullptr;
+	bool programChanged = false;
 	switch (material->shaderType) {
 	case MaterialShader::PHONG: {
 		// Phong-specific uniform settings
-		ProgramStandardPhong* phongProgram = hasNormalMap ? App->programs->phongNormal : App->programs->phongNotNormal;
+		ProgramStandardPhong* phongProgram = nullptr;
+		if (instanced) {
+			phongProgram = hasNormalMap ? App->programs->phongNormalInstanced : App->programs->phongNotNormalInstanced;
+		} else {
+			phongProgram = hasNormalMap ? App->programs->phongNormal : App->programs->phongNotNormal;
+		}
 		if (phongProgram == nullptr) return;
 
-		glUseProgram(phongProgram->program);
+		programChanged = renderState->UseProgram(phongProgram->program);
+		if (renderState->UseMaterial(material)) {
+			unsigned glTextureSpecular = 0;
+			ResourceTexture* specular = App->resources->GetResource<ResourceTexture>(material->specularMapId, material->specularMapHandle);
+			glTextureSpecular = specular ? specular->glTexture : 0;
+			int hasSpecularMap = specular ? 1 : 0;
 
-		unsigned glTextureSpecular = 0;
-		ResourceTexture* specular = App->resources->GetResource<ResourceTexture>(material->specularMapId);
-		glTextureSpecular = specular ? specular->glTexture : 0;
-		int hasSpecularMap = specular ? 1 : 0;
+			glUniform3fv(phongProgram->specularColorLocation, 1, material->specularColor.ptr());
+			glUniform1i(phongProgram->hasSpecularMapLocation, hasSpecularMap);
 
-		glUniform3fv(phongProgram->specularColorLocation, 1, material->specularColor.ptr());
-		glUniform1i(phongProgram->hasSpecularMapLocation, hasSpecularMap);
-
-		glUniform1i(phongProgram->specularMapLocation, 1);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureSpecular);
+			glUniform1i(phongProgram->specularMapLocation, 1);
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureSpecular);
+		}
 
 		standardProgram = phongProgram;
 		break;
 	}
 	case MaterialShader::STANDARD_SPECULAR: {
 		// Specular-specific uniform settings
-		ProgramStandardSpecular* specularProgram = hasNormalMap ? App->programs->specularNormal : App->programs->specularNotNormal;
+		ProgramStandardSpecular* specularProgram = nullptr;
+		if (instanced) {
+			specularProgram = hasNormalMap ? App->programs->specularNormalInstanced : App->programs->specularNotNormalInstanced;
+		} else {
+			specularProgram = hasNormalMap ? App->programs->specularNormal : App->programs->specularNotNormal;
+		}
 		if (specularProgram == nullptr) return;
 
-		glUseProgram(specularProgram->program);
-
-		unsigned glTextureSpecular = 0;
-		ResourceTexture* specular = App->resources->GetResource<ResourceTexture>(material->specularMapId);
-		glTextureSpecular = specular ? specular->glTexture : 0;
-		int hasSpecularMap = specular ? 1 : 0;
+		programChanged = renderState->UseProgram(specularProgram->program);
+		if (renderState->UseMaterial(material)) {
+			unsigned glTextureSpecular = 0;
+			ResourceTexture* specular = App->resources->GetResource<ResourceTexture>(material->specularMapId, material->specularMapHandle);
+			glTextureSpecular = specular ? specular->glTexture : 0;
+			int hasSpecularMap = specular ? 1 : 0;
 
-		glUniform3fv(specularProgram->specularColorLocation, 1, material->specularColor.ptr());
-		glUniform1i(specularProgram->hasSpecularMapLocation, hasSpecularMap);
+			glUniform3fv(specularProgram->specularColorLocation, 1, material->specularColor.ptr());
+			glUniform1i(specularProgram->hasSpecularMapLocation, hasSpecularMap);
 
-		glUniform1i(specularProgram->specularMapLocation, 1);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureSpecular);
+			glUniform1i(specularProgram->specularMapLocation, 1);
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureSpecular);
+		}
 
 		standardProgram = specularProgram;
 		break;
 	}
 	case MaterialShader::STANDARD: {
 		// Standard-specific uniform settings
-		ProgramStandardMetallic* metallicProgram = hasNormalMap ? App->programs->standardNormal : App->programs->standardNotNormal;
+		ProgramStandardMetallic* metallicProgram = nullptr;
+		if (instanced) {
+			metallicProgram = hasNormalMap ? App->programs->standardNormalInstanced : App->programs->standardNotNormalInstanced;
+		} else {
+			metallicProgram = hasNormalMap ? App->programs->standardNormal : App->programs->standardNotNormal;
+		}
 		if (metallicProgram == nullptr) return;
 
-		glUseProgram(metallicProgram->program);
-
-		// Standard-specific settings
-		unsigned glTextureMetallic = 0;
-		ResourceTexture* metallic = App->resources->GetResource<ResourceTexture>(material->metallicMapId);
-		glTextureMetallic = metallic ? metallic->glTexture : 0;
-		int hasMetallicMap = metallic ? 1 : 0;
+		programChanged = renderState->UseProgram(metallicProgram->program);
+		if (renderState->UseMaterial(material)) {
+			// Standard-specific settings
+			unsigned glTextureMetallic = 0;
+			ResourceTexture* metallic = App->resources->GetResource<ResourceTexture>(material->metallicMapId, material->metallicMapHandle);
+			glTextureMetallic = metallic ? metallic->glTexture : 0;
+			int hasMetallicMap = metallic ? 1 : 0;
 
-		glUniform1f(metallicProgram->metalnessLocation, material->metallic);
-		glUniform1i(metallicProgram->hasMetallicMapLocation, hasMetallicMap);
+			glUniform1f(metallicProgram->metalnessLocation, material->metallic);
+			glUniform1i(metallicProgram->hasMetallicMapLocation, hasMetallicMap);
 
-		glUniform1i(metallicProgram->metallicMapLocation, 1);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureMetallic);
+			glUniform1i(metallicProgram->metallicMapLocation, 1);
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureMetallic);
+		}
 
 		standardProgram = metallicProgram;
 		break;
@@ -288,33 +335,35 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 
 		ProgramStandardDissolve* dissolveProgram = App->programs->dissolveStandard;
 
-		glUseProgram(dissolveProgram->program);
-
-		// Standard-specific settings
-		unsigned glTextureMetallic = 0;
-		ResourceTexture* metallic = App->resources->GetResource<ResourceTexture>(material->metallicMapId);
-		glTextureMetallic = metallic ? metallic->glTexture : 0;
-		int hasMetallicMap = metallic ? 1 : 0;
+		programChanged = renderState->UseProgram(dissolveProgram->program);
+		if (renderState->UseMaterial(material)) {
+			// Standard-specific settings
+			unsigned glTextureMetallic = 0;
+			ResourceTexture* metallic = App->resources->GetResource<ResourceTexture>(material->metallicMapId, material->metallicMapHandle);
+			glTextureMetallic = metallic ? metallic->glTexture : 0;
+			int hasMetallicMap = metallic ? 1 : 0;
 
-		glUniform1f(dissolveProgram->metalnessLocation, material->metallic);
-		glUniform1i(dissolveProgram->hasMetallicMapLocation, hasMetallicMap);
+			glUniform1f(dissolveProgram->metalnessLocation, material->metallic);
+			glUniform1i(dissolveProgram->hasMetallicMapLocation, hasMetallicMap);
 
-		glUniform1i(dissolveProgram->metallicMapLocation, 1);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureMetallic);
+			glUniform1i(dissolveProgram->metallicMapLocation, 1);
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureMetallic);
 
-		// Dissolve settings
-		unsigned glTextureDissolveNoise = 0;
-		ResourceTexture* dissolveNoise = App->resources->GetResource<ResourceTexture>(material->dissolveNoiseMapId);
-		glTextureDissolveNoise = dissolveNoise ? dissolveNoise->glTexture : 0;
-		int hasDissolveNoiseMap = glTextureDissolveNoise ? 1 : 0;
+			// Dissolve noise
+			unsigned glTextureDissolveNoise = 0;
+			ResourceTexture* dissolveNoise = App->resources->GetResource<ResourceTexture>(material->dissolveNoiseMapId, material->dissolveNoiseMapHandle);
+			glTextureDissolveNoise = dissolveNoise ? dissolveNoise->glTexture : 0;
+			int hasDissolveNoiseMap = glTextureDissolveNoise ? 1 : 0;
 
-		glUniform1i(dissolveProgram->hasNoiseMapLocation, hasDissolveNoiseMap);
+			glUniform1i(dissolveProgram->hasNoiseMapLocation, hasDissolveNoiseMap);
 
-		glUniform1i(dissolveProgram->noiseMapLocation, 31);
-		glActiveTexture(GL_TEXTURE31);
-		glBindTexture(GL_TEXTURE_2D, glTextureDissolveNoise);
+			glUniform1i(dissolveProgram->noiseMapLocation, 31);
+			glActiveTexture(GL_TEXTURE31);
+			glBindTexture(GL_TEXTURE_2D, glTextureDissolveNoise);
+		}
 
+		// Dissolve settings
 		glUniform4fv(dissolveProgram->colorLocation, 1, material->dissolveColor.ptr());
 		glUniform1f(dissolveProgram->intensityLocation, material->dissolveIntensity);
 		glUniform1f(dissolveProgram->scaleLocation, material->dissolveScale);
@@ -326,18 +375,19 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 		break;
 	}
 	case MaterialShader::UNLIT: {
-		ProgramUnlit* unlitProgram = App->programs->unlit;
+		ProgramUnlit* unlitProgram = instanced ? App->programs->unlitInstanced : App->programs->unlit;
 		if (unlitProgram == nullptr) return;
 
-		glUseProgram(unlitProgram->program);
+		if (renderState->UseProgram(unlitProgram->program)) {
+			// Matrices
+			float4x4 viewMatrix = App->camera->GetViewMatrix();
+			float4x4 projMatrix = App->camera->GetProjectionMatrix();
 
-		// Matrices
-		float4x4 viewMatrix = App->camera->GetViewMatrix();
-		float4x4 projMatrix = App->camera->GetProjectionMatrix();
+			glUniformMatrix4fv(unlitProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
+			glUniformMatrix4fv(unlitProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
+		}
 
 		glUniformMatrix4fv(unlitProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
-		glUniformMatrix4fv(unlitProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
-		glUniformMatrix4fv(unlitProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
 
 		if (palette.size() > 0) {
 			glUniformMatrix4fv(unlitProgram->paletteLocation, palette.size(), GL_TRUE, palette[0].ptr());
@@ -345,38 +395,38 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 
 		glUniform1i(unlitProgram->hasBonesLocation, mesh->bones.size());
 
-		// Diffuse
-		unsigned glTextureDiffuse = 0;
-		ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId);
-		glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
-		int hasDiffuseMap = diffuse ? 1 : 0;
-
-		glUniform1i(unlitProgram->diffuseMapLocation, 0);
-		glUniform4fv(unlitProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
-		glUniform1i(unlitProgram->hasDiffuseMapLocation, hasDiffuseMap);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
-
-		// Emissive
-		unsigned glTextureEmissive = 0;
-		ResourceTexture* emissive = App->resources->GetResource<ResourceTexture>(material->emissiveMapId);
-		glTextureEmissive = emissive ? emissive->glTexture : 0;
-		int hasEmissiveMap = glTextureEmissive ? 1 : 0;
-
-		glUniform1i(unlitProgram->emissiveMapLocation, 1);
-		glUniform1i(unlitProgram->hasEmissiveMapLocation, hasEmissiveMap);
-		glUniform1f(unlitProgram->emissiveIntensityLocation, material->emissiveIntensity);
-		glUniform4fv(unlitProgram->emissiveColorLocation, 1, material->emissiveColor.ptr());
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureEmissive);
+		if (renderState->UseMaterial(material)) {
+			// Diffuse
+			unsigned glTextureDiffuse = 0;
+			ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId, material->diffuseMapHandle);
+			glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
+			int hasDiffuseMap = diffuse ? 1 : 0;
+
+			glUniform1i(unlitProgram->diffuseMapLocation, 0);
+			glUniform4fv(unlitProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
+			glUniform1i(unlitProgram->hasDiffuseMapLocation, hasDiffuseMap);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
+
+			// Emissive
+			unsigned glTextureEmissive = 0;
+			ResourceTexture* emissive = App->resources->GetResource<ResourceTexture>(material->emissiveMapId, material->emissiveMapHandle);
+			glTextureEmissive = emissive ? emissive->glTexture : 0;
+			int hasEmissiveMap = glTextureEmissive ? 1 : 0;
+
+			glUniform1i(unlitProgram->emissiveMapLocation, 1);
+			glUniform1i(unlitProgram->hasEmissiveMapLocation, hasEmissiveMap);
+			glUniform1f(unlitProgram->emissiveIntensityLocation, material->emissiveIntensity);
+			glUniform4fv(unlitProgram->emissiveColorLocation, 1, material->emissiveColor.ptr());
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureEmissive);
+		}
 
 		// Tilling settings
 		glUniform2fv(unlitProgram->tilingLocation, 1, ChooseTextureTiling(material->tiling).ptr());
 		glUniform2fv(unlitProgram->offsetLocation, 1, ChooseTextureOffset(material->offset).ptr());
 
-		glBindVertexArray(mesh->vao);
-		glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, nullptr);
-		glBindVertexArray(0);
+		renderState->DrawMesh(mesh);
 
 		break;
 	}
@@ -384,15 +434,16 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 		ProgramUnlitDissolve* unlitProgram = App->programs->dissolveUnlit;
 		if (unlitProgram == nullptr) return;
 
-		glUseProgram(unlitProgram->program);
+		if (renderState->UseProgram(unlitProgram->program)) {
+			// Matrices
+			float4x4 viewMatrix = App->camera->GetViewMatrix();
+			float4x4 projMatrix = App->camera->GetProjectionMatrix();
 
-		// Matrices
-		float4x4 viewMatrix = App->camera->GetViewMatrix();
-		float4x4 projMatrix = App->camera->GetProjectionMatrix();
+			glUniformMatrix4fv(unlitProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
+			glUniformMatrix4fv(unlitProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
+		}
 
 		glUniformMatrix4fv(unlitProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
-		glUniformMatrix4fv(unlitProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
-		glUniformMatrix4fv(unlitProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
 
 		if (palette.size() > 0) {
 			glUniformMatrix4fv(unlitProgram->paletteLocation, palette.size(), GL_TRUE, palette[0].ptr());
@@ -400,48 +451,51 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 
 		glUniform1i(unlitProgram->hasBonesLocation, mesh->bones.size());
 
-		// Diffuse
-		unsigned glTextureDiffuse = 0;
-		ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId);
-		glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
-		int hasDiffuseMap = diffuse ? 1 : 0;
-
-		glUniform1i(unlitProgram->diffuseMapLocation, 0);
-		glUniform4fv(unlitProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
-		glUniform1i(unlitProgram->hasDiffuseMapLocation, hasDiffuseMap);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
-
-		// Emissive
-		unsigned glTextureEmissive = 0;
-		ResourceTexture* emissive = App->resources->GetResource<ResourceTexture>(material->emissiveMapId);
-		glTextureEmissive = emissive ? emissive->glTexture : 0;
-		int hasEmissiveMap = glTextureEmissive ? 1 : 0;
-
-		glUniform1i(unlitProgram->emissiveMapLocation, 1);
-		glUniform1i(unlitProgram->hasEmissiveMapLocation, hasEmissiveMap);
-		glUniform1f(unlitProgram->emissiveIntensityLocation, material->emissiveIntensity);
-		glUniform4fv(unlitProgram->emissiveColorLocation, 1, material->emissiveColor.ptr());
-
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureEmissive);
+		if (renderState->UseMaterial(material)) {
+			// Diffuse
+			unsigned glTextureDiffuse = 0;
+			ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId, material->diffuseMapHandle);
+			glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
+			int hasDiffuseMap = diffuse ? 1 : 0;
+
+			glUniform1i(unlitProgram->diffuseMapLocation, 0);
+			glUniform4fv(unlitProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
+			glUniform1i(unlitProgram->hasDiffuseMapLocation, hasDiffuseMap);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
+
+			// Emissive
+			unsigned glTextureEmissive = 0;
+			ResourceTexture* emissive = App->resources->GetResource<ResourceTexture>(material->emissiveMapId, material->emissiveMapHandle);
+			glTextureEmissive = emissive ? emissive->glTexture : 0;
+			int hasEmissiveMap = glTextureEmissive ? 1 : 0;
+
+			glUniform1i(unlitProgram->emissiveMapLocation, 1);
+			glUniform1i(unlitProgram->hasEmissiveMapLocation, hasEmissiveMap);
+			glUniform1f(unlitProgram->emissiveIntensityLocation, material->emissiveIntensity);
+			glUniform4fv(unlitProgram->emissiveColorLocation, 1, material->emissiveColor.ptr());
+
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureEmissive);
+
+			// Dissolve noise
+			unsigned glTextureDissolveNoise = 0;
+			ResourceTexture* dissolveNoise = App->resources->GetResource<ResourceTexture>(material->dissolveNoiseMapId, material->dissolveNoiseMapHandle);
+			glTextureDissolveNoise = dissolveNoise ? dissolveNoise->glTexture : 0;
+			int hasDissolveNoiseMap = glTextureDissolveNoise ? 1 : 0;
+
+			glUniform1i(unlitProgram->hasNoiseMapLocation, hasDissolveNoiseMap);
+
+			glUniform1i(unlitProgram->noiseMapLocation, 2);
+			glActiveTexture(GL_TEXTURE2);
+			glBindTexture(GL_TEXTURE_2D, glTextureDissolveNoise);
+		}
 
 		// Tilling settings
 		glUniform2fv(unlitProgram->tilingLocation, 1, ChooseTextureTiling(material->tiling).ptr());
 		glUniform2fv(unlitProgram->offsetLocation, 1, ChooseTextureOffset(material->offset).ptr());
 
 		// Dissolve settings
-		unsigned glTextureDissolveNoise = 0;
-		ResourceTexture* dissolveNoise = App->resources->GetResource<ResourceTexture>(material->dissolveNoiseMapId);
-		glTextureDissolveNoise = dissolveNoise ? dissolveNoise->glTexture : 0;
-		int hasDissolveNoiseMap = glTextureDissolveNoise ? 1 : 0;
-
-		glUniform1i(unlitProgram->hasNoiseMapLocation, hasDissolveNoiseMap);
-
-		glUniform1i(unlitProgram->noiseMapLocation, 2);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, glTextureDissolveNoise);
-
 		glUniform4fv(unlitProgram->colorLocation, 1, material->dissolveColor.ptr());
 		glUniform1f(unlitProgram->intensityLocation, material->dissolveIntensity);
 		glUniform1f(unlitProgram->scaleLocation, material->dissolveScale);
@@ -449,9 +503,7 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 		glUniform2fv(unlitProgram->offsetLocation, 1, material->dissolveOffset.ptr());
 		glUniform1f(unlitProgram->edgeSizeLocation, material->dissolveEdgeSize);
 
-		glBindVertexArray(mesh->vao);
-		glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, nullptr);
-		glBindVertexArray(0);
+		renderState->DrawMesh(mesh);
 
 		break;
 	}
@@ -459,15 +511,25 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 		ProgramVolumetricLight* volumetricLightProgram = App->programs->volumetricLight;
 		if (volumetricLightProgram == nullptr) return;
 
-		glUseProgram(volumetricLightProgram->program);
+		if (renderState->UseProgram(volumetricLightProgram->program)) {
+			// Matrices
+			float4x4 viewMatrix = App->camera->GetViewMatrix();
+			float4x4 projMatrix = App->camera->GetProjectionMatrix();
 
-		// Matrices
-		float4x4 viewMatrix = App->camera->GetViewMatrix();
-		float4x4 projMatrix = App->camera->GetProjectionMatrix();
+			glUniformMatrix4fv(volumetricLightProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
+			glUniformMatrix4fv(volumetricLightProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
+
+			glUniform3fv(volumetricLightProgram->viewPosLocation, 1, App->camera->GetPosition().ptr());
+
+			glUniform1f(volumetricLightProgram->nearLocation, App->camera->GetNearPlane());
+			glUniform1f(volumetricLightProgram->farLocation, App->camera->GetFarPlane());
+
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, App->renderer->depthsTexture);
+			glUniform1i(volumetricLightProgram->depthsLocation, 0);
+		}
 
 		glUniformMatrix4fv(volumetricLightProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
-		glUniformMatrix4fv(volumetricLightProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
-		glUniformMatrix4fv(volumetricLightProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
 
 		if (palette.size() > 0) {
 			glUniformMatrix4fv(volumetricLightProgram->paletteLocation, palette.size(), GL_TRUE, palette[0].ptr());
@@ -475,35 +537,26 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 
 		glUniform1i(volumetricLightProgram->hasBonesLocation, mesh->bones.size());
 
-		glUniform3fv(volumetricLightProgram->viewPosLocation, 1, App->camera->GetPosition().ptr());
-
-		glUniform1f(volumetricLightProgram->nearLocation, App->camera->GetNearPlane());
-		glUniform1f(volumetricLightProgram->farLocation, App->camera->GetFarPlane());
+		if (renderState->UseMaterial(material)) {
+			// Light
+			unsigned glTextureLight = 0;
+			ResourceTexture* volumetricLightMap = App->resources->GetResource<ResourceTexture>(material->diffuseMapId, material->diffuseMapHandle);
+			glTextureLight = volumetricLightMap ? volumetricLightMap->glTexture : 0;
+			int hasLightMap = volumetricLightMap ? 1 : 0;
+
+			glUniform1i(volumetricLightProgram->lightMapLocation, 1);
+			glUniform4fv(volumetricLightProgram->lightColorLocation, 1, material->diffuseColor.ptr());
+			glUniform1i(volumetricLightProgram->hasLightMapLocation, hasLightMap ? 1 : 0);
+			glUniform1f(volumetricLightProgram->intensityLocation, material->volumetricLightInstensity);
+			glUniform1f(volumetricLightProgram->attenuationExponentLocation, material->volumetricLightAttenuationExponent);
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureLight);
+
+			glUniform1i(volumetricLightProgram->isSoftLocation, material->isSoft ? 1 : 0);
+			glUniform1f(volumetricLightProgram->softRangeLocation, material->softRange);
+		}
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, App->renderer->depthsTexture);
-		glUniform1i(volumetricLightProgram->depthsLocation, 0);
-
-		// Light
-		unsigned glTextureLight = 0;
-		ResourceTexture* volumetricLightMap = App->resources->GetResource<ResourceTexture>(material->diffuseMapId);
-		glTextureLight = volumetricLightMap ? volumetricLightMap->glTexture : 0;
-		int hasLightMap = volumetricLightMap ? 1 : 0;
-
-		glUniform1i(volumetricLightProgram->lightMapLocation, 1);
-		glUniform4fv(volumetricLightProgram->lightColorLocation, 1, material->diffuseColor.ptr());
-		glUniform1i(volumetricLightProgram->hasLightMapLocation, hasLightMap ? 1 : 0);
-		glUniform1f(volumetricLightProgram->intensityLocation, material->volumetricLightInstensity);
-		glUniform1f(volumetricLightProgram->attenuationExponentLocation, material->volumetricLightAttenuationExponent);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureLight);
-
-		glUniform1i(volumetricLightProgram->isSoftLocation, material->isSoft ? 1 : 0);
-		glUniform1f(volumetricLightProgram->softRangeLocation, material->softRange);
-
-		glBindVertexArray(mesh->vao);
-		glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, nullptr);
-		glBindVertexArray(0);
+		renderState->DrawMesh(mesh);
 
 		break;
 	}
@@ -518,10 +571,86 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 	// Common shader settings
 	if (standardProgram == nullptr) return;
 
+	Scene* scene = GetOwner().scene;
+
+	// Per-frame settings. Inside a render queue they are only set when the program changes
+	if (programChanged) {
+		SetStandardFrameUniforms(standardProgram, scene);
+	}
+
+	// Per-instance settings
+	glUniformMatrix4fv(standardProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
+
+	// Skinning uniform settings
+	if (palette.size() > 0) {
+		glUniformMatrix4fv(standardProgram->paletteLocation, palette.size(), GL_TRUE, palette[0].ptr());
+	}
+
+	glUniform1i(standardProgram->hasBonesLocation, mesh->bones.size());
+
+	// Tilling settings
+	glUniform2fv(standardProgram->tilingLocation, 1, ChooseTextureTiling(material->tiling).ptr());
+	glUniform2fv(standardProgram->offsetLocation, 1, ChooseTextureOffset(material->offset).ptr());
+
+	// Per-material settings
+	if (renderState->materialChanged) {
+		unsigned glTextureDiffuse = 0;
+		ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId, material->diffuseMapHandle);
+		glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
+		int hasDiffuseMap = diffuse ? 1 : 0;
+
+		unsigned glTextureEmissive = 0;
+		ResourceTexture* emissive = App->resources->GetResource<ResourceTexture>(material->emissiveMapId, material->emissiveMapHandle);
+		glTextureEmissive = emissive ? emissive->glTexture : 0;
+		int hasEmissiveMap = glTextureEmissive ? 1 : 0;
+
+		unsigned glTextureAmbientOcclusion = 0;
+		ResourceTexture* ambientOcclusion = App->resources->GetResource<ResourceTexture>(material->ambientOcclusionMapId, material->ambientOcclusionMapHandle);
+		glTextureAmbientOcclusion = ambientOcclusion ? ambientOcclusion->glTexture : 0;
+		int hasAmbientOcclusionMap = glTextureAmbientOcclusion ? 1 : 0;
+
+		glUniform1i(standardProgram->isOpaqueLocation, material->renderingMode == RenderingMode::OPAQUE ? 1 : 0);
+
+		// Diffuse
+		glUniform1i(standardProgram->diffuseMapLocation, 0);
+		glUniform4fv(standardProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
+		glUniform1i(standardProgram->hasDiffuseMapLocation, hasDiffuseMap);
+		glUniform1f(standardProgram->smoothnessLocation, material->smoothness);
+		glUniform1i(standardProgram->hasSmoothnessAlphaLocation, material->hasSmoothnessInAlphaChannel);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
+
+		// Normal Map
+		glUniform1i(standardProgram->normalMapLocation, 2);
+		glUniform1i(standardProgram->hasNormalMapLocation, hasNormalMap);
+		glUniform1f(standardProgram->normalStrengthLocation, material->normalStrength);
+		glActiveTexture(GL_TEXTURE2);
+		glBindTexture(GL_TEXTURE_2D, glTextureNormal);
+
+		// Emissive Map
+		glUniform1i(standardProgram->emissiveMapLocation, 3);
+		glUniform1i(standardProgram->hasEmissiveMapLocation, hasEmissiveMap);
+		glUniform1f(standardProgram->emissiveIntensityLocation, material->emissiveIntensity);
+		glUniform4fv(standardProgram->emissiveColorLocation, 1, material->emissiveColor.ptr());
+
+		glActiveTexture(GL_TEXTURE3);
+		glBindTexture(GL_TEXTURE_2D, glTextureEmissive);
+
+		// Ambient Occlusion Map
+		glUniform1i(standardProgram->ambientOcclusionMapLocation, 4);
+		glUniform1i(standardProgram->hasAmbientOcclusionMapLocation, hasAmbientOcclusionMap);
+		glActiveTexture(GL_TEXTURE4);
+		glBindTexture(GL_TEXTURE_2D, glTextureAmbientOcclusion);
+	}
+
+	renderState->DrawMesh(mesh);
+}
+
+void ComponentMeshRenderer::SetStandardFrameUniforms(ProgramStandard* standardProgram, Scene* scene) {
 	// Light settings
 	ComponentLight* directionalLight = nullptr;
 
-	Scene* scene = GetOwner().scene;
 	for (ComponentLight& light : scene->lightComponents) {
 		if (light.lightType == LightType::DIRECTIONAL) {
 			// It takes the first actived Directional Light inside the Pool
@@ -565,30 +694,12 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 		farPlaneDistancesMainEntities[i] = subsFrustumsMainEntities[i].perspectiveFrustum.FarPlaneDistance();
 	}
 
-	unsigned glTextureDiffuse = 0;
-	ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId);
-	glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
-	int hasDiffuseMap = diffuse ? 1 : 0;
-
 	unsigned glSSAOTexture = App->renderer->ssaoTexture;
 
-	unsigned glTextureEmissive = 0;
-	ResourceTexture* emissive = App->resources->GetResource<ResourceTexture>(material->emissiveMapId);
-	glTextureEmissive = emissive ? emissive->glTexture : 0;
-	int hasEmissiveMap = glTextureEmissive ? 1 : 0;
-
-	unsigned glTextureAmbientOcclusion = 0;
-	ResourceTexture* ambientOcclusion = App->resources->GetResource<ResourceTexture>(material->ambientOcclusionMapId);
-	glTextureAmbientOcclusion = ambientOcclusion ? ambientOcclusion->glTexture : 0;
-	int hasAmbientOcclusionMap = glTextureAmbientOcclusion ? 1 : 0;
-
 	// Common uniform settings
-	glUniformMatrix4fv(standardProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
 	glUniformMatrix4fv(standardProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
 	glUniformMatrix4fv(standardProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
 
-	glUniform1i(standardProgram->isOpaqueLocation, material->renderingMode == RenderingMode::OPAQUE ? 1 : 0);
-
 	// Shadows uniform settings
 	if (subsFrustumsStatic.size() > 0) {
 		glUniformMatrix4fv(standardProgram->viewOrtoLightsStaticLocation, viewOrtoLightsStatic.size(), GL_TRUE, viewOrtoLightsStatic[0].ptr());
@@ -623,58 +734,14 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 	glUniform1ui(standardProgram->shadowDynamicCascadesCounterLocation, App->renderer->lightFrustumDynamic.GetNumberOfCascades());
 	glUniform1ui(standardProgram->shadowMainEntitiesCascadesCounterLocation, App->renderer->lightFrustumMainEntities.GetNumberOfCascades());
 
-	// Skinning uniform settings
-
-	if (palette.size() > 0) {
-		glUniformMatrix4fv(standardProgram->paletteLocation, palette.size(), GL_TRUE, palette[0].ptr());
-	}
-
-	glUniform1i(standardProgram->hasBonesLocation, mesh->bones.size());
-
 	glUniform3fv(standardProgram->viewPosLocation, 1, App->camera->GetPosition().ptr());
 
-	// Diffuse
-	glUniform1i(standardProgram->diffuseMapLocation, 0);
-	glUniform4fv(standardProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
-	glUniform1i(standardProgram->hasDiffuseMapLocation, hasDiffuseMap);
-	glUniform1f(standardProgram->smoothnessLocation, material->smoothness);
-	glUniform1i(standardProgram->hasSmoothnessAlphaLocation, material->hasSmoothnessInAlphaChannel);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
-
-	// Normal Map
-	glUniform1i(standardProgram->normalMapLocation, 2);
-	glUniform1i(standardProgram->hasNormalMapLocation, hasNormalMap);
-	glUniform1f(standardProgram->normalStrengthLocation, material->normalStrength);
-	glActiveTexture(GL_TEXTURE2);
-	glBindTexture(GL_TEXTURE_2D, glTextureNormal);
-
-	// Emissive Map
-	glUniform1i(standardProgram->emissiveMapLocation, 3);
-	glUniform1i(standardProgram->hasEmissiveMapLocation, hasEmissiveMap);
-	glUniform1f(standardProgram->emissiveIntensityLocation, material->emissiveIntensity);
-	glUniform4fv(standardProgram->emissiveColorLocation, 1, material->emissiveColor.ptr());
-
-	glActiveTexture(GL_TEXTURE3);
-	glBindTexture(GL_TEXTURE_2D, glTextureEmissive);
-
-	// Ambient Occlusion Map
-	glUniform1i(standardProgram->ambientOcclusionMapLocation, 4);
-	glUniform1i(standardProgram->hasAmbientOcclusionMapLocation, hasAmbientOcclusionMap);
-	glActiveTexture(GL_TEXTURE4);
-	glBindTexture(GL_TEXTURE_2D, glTextureAmbientOcclusion);
-
 	// SSAO texture
 	glUniform1i(standardProgram->ssaoTextureLocation, 5);
 	glActiveTexture(GL_TEXTURE5);
 	glBindTexture(GL_TEXTURE_2D, glSSAOTexture);
 	glUniform1f(standardProgram->ssaoDirectLightingStrengthLocation, App->renderer->ssaoDirectLightingStrength);
 
-	// Tilling settings
-	glUniform2fv(standardProgram->tilingLocation, 1, ChooseTextureTiling(material->tiling).ptr());
-	glUniform2fv(standardProgram->offsetLocation, 1, ChooseTextureOffset(material->offset).ptr());
-
 	// IBL textures
 	auto skyboxIt = scene->skyboxComponents.begin();
 	bool hasIBL = false;
@@ -734,7 +801,7 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 	}
 
 	// Lights uniforms settings
-	glUniform3fv(standardProgram->ambientColorLocation, 1, GetOwner().scene->ambientColor.ptr());
+	glUniform3fv(standardProgram->ambientColorLocation, 1, scene->ambientColor.ptr());
 
 	if (directionalLight != nullptr) {
 		glUniform3fv(standardProgram->dirLightDirectionLocation, 1, directionalLight->direction.ptr());
@@ -750,58 +817,68 @@ void ComponentMeshRenderer::Draw(const float4x4& modelMatrix) {
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, App->renderer->lightTilesStorageBufferOpaque);
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, App->renderer->lightIndicesStorageBufferTransparent);
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, App->renderer->lightTilesStorageBufferTransparent);
-
-	glBindVertexArray(mesh->vao);
-	glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
 }
 
-void ComponentMeshRenderer::DrawDepthPrepass(const float4x4& modelMatrix) const {
+void ComponentMeshRenderer::DrawDepthPrepass(const float4x4& modelMatrix, RenderState* renderState) const {
 	if (!IsActive()) return;
 
-	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId);
+	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
 	if (mesh == nullptr) return;
 
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (material == nullptr) return;
 
-	ProgramDepthPrepass* depthPrepassProgram = App->programs->depthPrepass;
+	RenderState standaloneRenderState;
+	if (renderState == nullptr) renderState = &standaloneRenderState;
+	DEFER {
+		if (renderState == &standaloneRenderState) glBindVertexArray(0);
+	};
+
+	ProgramDepthPrepass* depthPrepassProgram = renderState->instanceCount > 0 ? App->programs->depthPrepassInstanced : App->programs->depthPrepass;
 	bool mustUseDissolveProgram = material->shaderType == MaterialShader::UNLIT_DISSOLVE || material->shaderType == MaterialShader::STANDARD_DISSOLVE;
 
+	bool programChanged = false;
 	if (mustUseDissolveProgram) {
 		ProgramDepthPrepassDissolve* depthPrepassProgramDissolve = App->programs->depthPrepassDissolve;
 		if (depthPrepassProgramDissolve == nullptr) return;
 
 		depthPrepassProgram = depthPrepassProgramDissolve;
 
-		glUseProgram(depthPrepassProgram->program);
+		programChanged = renderState->UseProgram(depthPrepassProgram->program);
 
-		unsigned glTextureDissolveNoise = 0;
-		ResourceTexture* dissolveNoise = App->resources->GetResource<ResourceTexture>(material->dissolveNoiseMapId);
-		glTextureDissolveNoise = dissolveNoise ? dissolveNoise->glTexture : 0;
-		int hasDissolveNoiseMap = glTextureDissolveNoise ? 1 : 0;
+		if (renderState->UseMaterial(material)) {
+			unsigned glTextureDissolveNoise = 0;
+			ResourceTexture* dissolveNoise = App->resources->GetResource<ResourceTexture>(material->dissolveNoiseMapId, material->dissolveNoiseMapHandle);
+			glTextureDissolveNoise = dissolveNoise ? dissolveNoise->glTexture : 0;
+			int hasDissolveNoiseMap = glTextureDissolveNoise ? 1 : 0;
 
-		glUniform1i(depthPrepassProgramDissolve->hasNoiseMapLocation, hasDissolveNoiseMap);
+			glUniform1i(depthPrepassProgramDissolve->hasNoiseMapLocation, hasDissolveNoiseMap);
 
-		glUniform1i(depthPrepassProgramDissolve->noiseMapLocation, 1);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, glTextureDissolveNoise);
+			glUniform1i(depthPrepassProgramDissolve->noiseMapLocation, 1);
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, glTextureDissolveNoise);
+
+			glUniform1f(depthPrepassProgramDissolve->scaleLocation, material->dissolveScale);
+			glUniform2fv(depthPrepassProgramDissolve->offsetLocation, 1, material->dissolveOffset.ptr());
+		}
 
-		glUniform1f(depthPrepassProgramDissolve->scaleLocation, material->dissolveScale);
 		glUniform1f(depthPrepassProgramDissolve->thresholdLocation, GetDissolveValue());
-		glUniform2fv(depthPrepassProgramDissolve->offsetLocation, 1, material->dissolveOffset.ptr());
 	} else {
 		if (depthPrepassProgram == nullptr) return;
-		glUseProgram(depthPrepassProgram->program);
+		programChanged = renderState->UseProgram(depthPrepassProgram->program);
+		renderState->UseMaterial(material);
 	}
 
-	float4x4 viewMatrix = App->camera->GetViewMatrix();
-	float4x4 projMatrix = App->camera->GetProjectionMatrix();
+	if (programChanged) {
+		float4x4 viewMatrix = App->camera->GetViewMatrix();
+		float4x4 projMatrix = App->camera->GetProjectionMatrix();
+
+		glUniformMatrix4fv(depthPrepassProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
+		glUniformMatrix4fv(depthPrepassProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
+	}
 
 	// Common uniform settings
 	glUniformMatrix4fv(depthPrepassProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
-	glUniformMatrix4fv(depthPrepassProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
-	glUniformMatrix4fv(depthPrepassProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
 
 	// Skinning
 	if (palette.size() > 0) {
@@ -811,70 +888,79 @@ void ComponentMeshRenderer::DrawDepthPrepass(const float4x4& modelMatrix) const
 	glUniform1i(depthPrepassProgram->hasBonesLocation, mesh->bones.size());
 
 	// Diffuse
-	unsigned glTextureDiffuse = 0;
-	ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId);
-	glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
-	int hasDiffuseMap = diffuse ? 1 : 0;
+	if (renderState->materialChanged) {
+		unsigned glTextureDiffuse = 0;
+		ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId, material->diffuseMapHandle);
+		glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
+		int hasDiffuseMap = diffuse ? 1 : 0;
 
-	glUniform1i(depthPrepassProgram->diffuseMapLocation, 0);
-	glUniform4fv(depthPrepassProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
-	glUniform1i(depthPrepassProgram->hasDiffuseMapLocation, hasDiffuseMap);
+		glUniform1i(depthPrepassProgram->diffuseMapLocation, 0);
+		glUniform4fv(depthPrepassProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
+		glUniform1i(depthPrepassProgram->hasDiffuseMapLocation, hasDiffuseMap);
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
+	}
 
 	// Tiling settings
 	glUniform2fv(depthPrepassProgram->tilingLocation, 1, ChooseTextureTiling(material->tiling).ptr());
 	glUniform2fv(depthPrepassProgram->offsetLocation, 1, ChooseTextureOffset(material->offset).ptr());
 
-	glBindVertexArray(mesh->vao);
-	glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
+	renderState->DrawMesh(mesh);
 }
 
-void ComponentMeshRenderer::DrawShadow(const float4x4& modelMatrix, unsigned int i, ShadowCasterType lightFrustumType) const {
+void ComponentMeshRenderer::DrawShadow(const float4x4& modelMatrix, unsigned int i, ShadowCasterType lightFrustumType, RenderState* renderState) const {
 	if (!IsActive()) return;
 
-	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId);
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (mesh == nullptr || material == nullptr) return;
 
-	unsigned program = App->programs->shadowMap;
-	float4x4 viewMatrix = App->renderer->GetLightViewMatrix(i, lightFrustumType);
-	float4x4 projMatrix = App->renderer->GetLightProjectionMatrix(i, lightFrustumType);
+	RenderState standaloneRenderState;
+	if (renderState == nullptr) renderState = &standaloneRenderState;
+	DEFER {
+		if (renderState == &standaloneRenderState) glBindVertexArray(0);
+	};
+
+	ProgramShadowMap* shadowProgram = renderState->instanceCount > 0 ? App->programs->shadowMapInstanced : App->programs->shadowMap;
+	if (shadowProgram == nullptr) return;
 
-	unsigned glTextureDiffuse = 0;
-	ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId);
-	glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
-	int hasDiffuseMap = diffuse ? 1 : 0;
+	if (renderState->UseProgram(shadowProgram->program)) {
+		float4x4 viewMatrix = App->renderer->GetLightViewMatrix(i, lightFrustumType);
+		float4x4 projMatrix = App->renderer->GetLightProjectionMatrix(i, lightFrustumType);
 
-	glUseProgram(program);
+		glUniformMatrix4fv(shadowProgram->viewLocation, 1, GL_TRUE, viewMatrix.ptr());
+		glUniformMatrix4fv(shadowProgram->projLocation, 1, GL_TRUE, projMatrix.ptr());
+	}
 
 	// Common uniform settings
-	glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_TRUE, modelMatrix.ptr());
-	glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_TRUE, viewMatrix.ptr());
-	glUniformMatrix4fv(glGetUniformLocation(program, "proj"), 1, GL_TRUE, projMatrix.ptr());
+	glUniformMatrix4fv(shadowProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
 
-	glUniform1i(glGetUniformLocation(program, "diffuseMap"), 0);
-	glUniform4fv(glGetUniformLocation(program, "diffuseColor"), 1, material->diffuseColor.ptr());
-	glUniform1i(glGetUniformLocation(program, "hasDiffuseMap"), hasDiffuseMap);
+	if (renderState->UseMaterial(material)) {
+		unsigned glTextureDiffuse = 0;
+		ResourceTexture* diffuse = App->resources->GetResource<ResourceTexture>(material->diffuseMapId, material->diffuseMapHandle);
+		glTextureDiffuse = diffuse ? diffuse->glTexture : 0;
+		int hasDiffuseMap = diffuse ? 1 : 0;
+
+		glUniform1i(shadowProgram->diffuseMapLocation, 0);
+		glUniform4fv(shadowProgram->diffuseColorLocation, 1, material->diffuseColor.ptr());
+		glUniform1i(shadowProgram->hasDiffuseMapLocation, hasDiffuseMap);
 
-	glUniform2fv(glGetUniformLocation(program, "tiling"), 1, material->tiling.ptr());
-	glUniform2fv(glGetUniformLocation(program, "offset"), 1, material->offset.ptr());
+		glUniform2fv(shadowProgram->tilingLocation, 1, material->tiling.ptr());
+		glUniform2fv(shadowProgram->offsetLocation, 1, material->offset.ptr());
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, glTextureDiffuse);
+	}
 
 	// Skinning
 	if (palette.size() > 0) {
-		glUniformMatrix4fv(glGetUniformLocation(program, "palette"), palette.size(), GL_TRUE, palette[0].ptr());
+		glUniformMatrix4fv(shadowProgram->paletteLocation, palette.size(), GL_TRUE, palette[0].ptr());
 	}
 
-	glUniform1i(glGetUniformLocation(program, "hasBones"), mesh->bones.size());
+	glUniform1i(shadowProgram->hasBonesLocation, mesh->bones.size());
 
-	glBindVertexArray(mesh->vao);
-	glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
+	renderState->DrawMesh(mesh);
 }
 
 void ComponentMeshRenderer::UpdateMasks() {
@@ -883,7 +969,7 @@ void ComponentMeshRenderer::UpdateMasks() {
 }
 
 void ComponentMeshRenderer::AddShadowCaster() {
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (material == nullptr) return;
 	
 	GameObject* owner = &GetOwner();
@@ -909,8 +995,15 @@ void ComponentMeshRenderer::AddShadowCaster() {
 	}
 }
 
+void ComponentMeshRenderer::InvalidateShadowCaster() {
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
+	if (material == nullptr) return;
+
+	material->InvalidateShadowCasters();
+}
+
 void ComponentMeshRenderer::AddRenderingModeMask() {
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (material && material->renderingMode == RenderingMode::TRANSPARENT) {
 		GameObject& gameObject = GetOwner();
 		gameObject.AddMask(MaskType::TRANSPARENT);
@@ -918,7 +1011,7 @@ void ComponentMeshRenderer::AddRenderingModeMask() {
 }
 
 void ComponentMeshRenderer::DeleteRenderingModeMask() {
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (material && material->renderingMode == RenderingMode::TRANSPARENT) {
 		GameObject& gameObject = GetOwner();
 		gameObject.DeleteMask(MaskType::TRANSPARENT);
@@ -938,6 +1031,35 @@ void ComponentMeshRenderer::SetMaterialInternal(UID materialId_) {
 	AddShadowCaster();
 }
 
+ResourceMesh* ComponentMeshRenderer::GetMeshResource() const {
+	return App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
+}
+
+bool ComponentMeshRenderer::GetRenderQueueKeys(unsigned& program, unsigned& depthPrepassProgram, unsigned& material, unsigned& mesh, bool& instanceable) const {
+	if (!IsActive()) return false;
+
+	ResourceMesh* meshResource = App->resources->GetResource<ResourceMesh>(meshId, meshHandle);
+	ResourceMaterial* materialResource = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
+	if (meshResource == nullptr || materialResource == nullptr) return false;
+
+	// The program is chosen from the shader type and the normal map, the same way Draw() does
+	ResourceTexture* normal = App->resources->GetResource<ResourceTexture>(materialResource->normalMapId, materialResource->normalMapHandle);
+	program = (static_cast<unsigned>(materialResource->shaderType) << 1) | (normal ? 1 : 0);
+	depthPrepassProgram = materialResource->shaderType == MaterialShader::UNLIT_DISSOLVE || materialResource->shaderType == MaterialShader::STANDARD_DISSOLVE ? 1 : 0;
+	material = materialHandle.index;
+	mesh = meshHandle.index;
+
+	// Skinned meshes and the dissolve and volumetric light shaders use per-draw uniforms that aren't part of the instance data
+	MaterialShader shaderType = materialResource->shaderType;
+	bool instancedShader = shaderType == MaterialShader::PHONG || shaderType == MaterialShader::STANDARD_SPECULAR || shaderType == MaterialShader::STANDARD || shaderType == MaterialShader::UNLIT;
+	instanceable = instancedShader && palette.empty() && meshResource->bones.empty();
+	return true;
+}
+
+bool ComponentMeshRenderer::CanBeInstancedWith(const ComponentMeshRenderer& other) const {
+	return meshId == other.meshId && materialId == other.materialId && textureTiling.Equals(other.textureTiling) && textureOffset.Equals(other.textureOffset);
+}
+
 UID ComponentMeshRenderer::GetMesh() const {
 	return meshId;
 }
@@ -945,6 +1067,7 @@ UID ComponentMeshRenderer::GetMesh() const {
 void ComponentMeshRenderer::SetMesh(UID meshId_) {
 	App->resources->DecreaseReferenceCount(meshId);
 	meshId = meshId_;
+	meshHandle = App->resources->GetResourceHandle(meshId);
 	App->resources->IncreaseReferenceCount(meshId);
 }
 
@@ -953,9 +1076,13 @@ UID ComponentMeshRenderer::GetMaterial() const {
 }
 
 void ComponentMeshRenderer::SetMaterial(UID materialId_) {
+	// The cached shadow maps of both the old and the new caster type have to be redrawn
+	InvalidateShadowCaster();
 	App->resources->DecreaseReferenceCount(materialId);
 	materialId = materialId_;
+	materialHandle = App->resources->GetResourceHandle(materialId);
 	AddShadowCaster();
+	InvalidateShadowCaster();
 	App->resources->IncreaseReferenceCount(materialId);
 }
 
@@ -974,7 +1101,7 @@ void ComponentMeshRenderer::ResetDissolveValues() {
 }
 
 float ComponentMeshRenderer::GetDissolveDuration() const {
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (!material) return 0.0f;
 	return material->dissolveDuration;
 }
@@ -1008,7 +1135,7 @@ void ComponentMeshRenderer::SetTextureOffset(float2 _offset) {
 }
 
 void ComponentMeshRenderer::UpdateDissolveAnimation() {
-	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId);
+	ResourceMaterial* material = App->resources->GetResource<ResourceMaterial>(materialId, materialHandle);
 	if (!material) return;
 
 	if (!dissolveAnimationFinished && material->dissolveDuration > 0) {
@@ -3,12 +3,17 @@
 #include "Component.h"
 
 #include "Modules/ModuleRender.h"
+#include "Resources/ResourceHandle.h"
 
 #include "Math/float2.h"
 #include "Math/float4x4.h"
 #include <unordered_map>
 
 struct aiMesh;
+struct ProgramStandard;
+struct RenderState;
+class ResourceMesh;
+class Scene;
 
 class ComponentMeshRenderer : public Component {
 public:
@@ -21,18 +26,25 @@ public:
 	void Save(JsonValue jComponent) const override;
 	void Load(JsonValue jComponent) override;
 	void Start() override;
+	void OnEnable() override;
+	void OnDisable() override;
 
-	void Draw(const float4x4& modelMatrix);
-	void DrawDepthPrepass(const float4x4& modelMatrix) const;
-	void DrawShadow(const float4x4& modelMatrix, unsigned int i, ShadowCasterType lightFrustumType) const;
+	void Draw(const float4x4& modelMatrix, RenderState* renderState = nullptr); // If a render state is given, the bindings still valid from the previous draw are skipped
+	void DrawDepthPrepass(const float4x4& modelMatrix, RenderState* renderState = nullptr) const;
+	void DrawShadow(const float4x4& modelMatrix, unsigned int i, ShadowCasterType lightFrustumType, RenderState* renderState = nullptr) const;
 
 	void UpdateMasks();
 	void AddShadowCaster();
+	void InvalidateShadowCaster(); // Forces the shadow maps of this renderer's caster type to be redrawn. Only its own light frustum is affected, so static shadow maps are kept when other casters move
 	void AddRenderingModeMask();
 	void DeleteRenderingModeMask();
 
 	void SetGameObjectBones(const std::unordered_map<std::string, GameObject*>& goBones);
 
+	ResourceMesh* GetMeshResource() const;
+	bool GetRenderQueueKeys(unsigned& program, unsigned& depthPrepassProgram, unsigned& material, unsigned& mesh, bool& instanceable) const; // Fills the ids used to sort the draws of this renderer. Returns false if there's nothing to draw.
+	bool CanBeInstancedWith(const ComponentMeshRenderer& other) const; // True if both renderers draw the same mesh and material with the same per-draw uniforms
+
 	void SetMeshInternal(UID meshId);
 	void SetMaterialInternal(UID materialId);
 
@@ -57,6 +69,8 @@ public:
 	TESSERACT_ENGINE_API void SetTextureOffset(float2 _offset);
 
 private:
+	void SetStandardFrameUniforms(ProgramStandard* standardProgram, Scene* scene);
+
 	void UpdateDissolveAnimation();
 	float GetDissolveValue() const;
 
@@ -68,6 +82,8 @@ private:
 
 	UID meshId = 0;
 	UID materialId = 0;
+	mutable ResourceHandle meshHandle;
+	mutable ResourceHandle materialHandle;
 	std::vector<float4x4> palette;
 
 	std::unordered_map<std::string, GameObject*> goBones;
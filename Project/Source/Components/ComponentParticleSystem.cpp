@@ -21,6 +21,7 @@
 #include "Scene.h"
 
 #include "Math/float3x3.h"
+#include "Math/MathFunc.h"
 #include "Math/TransformOps.h"
 #include "Geometry/Plane.h"
 #include "Geometry/Line.h"
@@ -230,6 +231,8 @@ ComponentParticleSystem::~ComponentParticleSystem() {
 
 	App->resources->DecreaseReferenceCount(textureID);
 	App->resources->DecreaseReferenceCount(textureTrailID);
+
+	instanceBuffer.CleanUp();
 }
 
 void ComponentParticleSystem::Init() {
@@ -1402,6 +1405,7 @@ void ComponentParticleSystem::AllocateParticlesMemory() {
 	if (isPlaying) {
 		Restart();
 	}
+	simulation.Allocate(maxParticles);
 	particles.Allocate(maxParticles);
 }
 
@@ -1411,43 +1415,45 @@ void ComponentParticleSystem::SpawnParticles() {
 		if (restParticlesPerSecond <= 0) {
 			InitStartRate();
 			for (int i = 0; i < particlesCurrentFrame; i++) {
-				if (maxParticles > particles.Count()) SpawnParticleUnit();
+				if (maxParticles > simulation.Count()) SpawnParticleUnit();
 			}
 		} else {
 			restParticlesPerSecond -= App->time->GetDeltaTimeOrRealDeltaTime();
 		}
-	} else if (particles.Count() == 0) {
+	} else if (simulation.Count() == 0) {
 		isPlaying = false;
 	}
 }
 
 void ComponentParticleSystem::SpawnParticleUnit() {
-	Particle* currentParticle = particles.Obtain();
-
-	if (currentParticle) {
-		InitParticlePosAndDir(currentParticle);
-		InitParticleRotation(currentParticle);
-		InitParticleScale(currentParticle);
-		InitParticleSpeed(currentParticle);
-		InitParticleGravity(currentParticle);
-		InitParticleLife(currentParticle);
-		InitParticleAnimationTexture(currentParticle);
+	unsigned index = simulation.Add();
+
+	if (index != PARTICLE_INVALID_INDEX) {
+		InitParticlePosAndDir(index);
+		InitParticleRotation(index);
+		InitParticleScale(index);
+		InitParticleSpeed(index);
+		InitParticleGravity(index);
+		InitParticleLife(index);
+		InitParticleAnimationTexture(index);
 		if (hasTrail && IsProbably(trailRatio)) {
-			InitParticleTrail(currentParticle);
+			InitParticleTrail(ObtainColdParticle(index));
 		}
 
-		InitSubEmitter(currentParticle, SubEmitterType::BIRTH);
+		InitSubEmitter(index, SubEmitterType::BIRTH);
 
 		if (hasLights && IsProbably(lightsRatio)) {
 			if (lightsSpawned < maxLights) {
-				InitLight(currentParticle);
+				InitLight(ObtainColdParticle(index));
 			}
 		}
 	}
 }
 
-void ComponentParticleSystem::InitParticlePosAndDir(Particle* currentParticle) {
+void ComponentParticleSystem::InitParticlePosAndDir(unsigned index) {
 	float reverseDist = ObtainRandomValueFloat(reverseDistanceRM, reverseDistance, reverseDistanceCurve, emitterTime / duration);
+	float3 position;
+	float3 direction;
 
 	if (emitterType == ParticleEmitterType::BOX) {
 		float3 point;
@@ -1461,8 +1467,8 @@ void ComponentParticleSystem::InitParticlePosAndDir(Particle* currentParticle) {
 			point = obbEmitter.PointOnEdge(index, Random());
 		}
 
-		currentParticle->initialPosition = float3(point.x, point.y, point.z);
-		currentParticle->direction = float3::unitY;
+		position = float3(point.x, point.y, point.z);
+		direction = float3::unitY;
 
 	} else {
 		float x0 = 0, y0 = 0, z0 = 0, x1 = 0, y1 = 0, z1 = 0;
@@ -1499,8 +1505,8 @@ void ComponentParticleSystem::InitParticlePosAndDir(Particle* currentParticle) {
 			localPos = localPos + localDir * reverseDist;
 		}
 
-		currentParticle->initialPosition = localPos;
-		currentParticle->direction = localDir.Normalized();
+		position = localPos;
+		direction = localDir.Normalized();
 	}
 
 	if (!attachEmitter) {
@@ -1511,84 +1517,93 @@ void ComponentParticleSystem::InitParticlePosAndDir(Particle* currentParticle) {
 		rotateMatrix.ScaleCol(0, scale.x);
 		rotateMatrix.ScaleCol(1, scale.y);
 		rotateMatrix.ScaleCol(2, scale.z);
-		currentParticle->initialPosition = newModel.TranslatePart() + rotateMatrix * currentParticle->initialPosition;
-		currentParticle->direction = (rotateMatrix * currentParticle->direction).Normalized();
+		position = newModel.TranslatePart() + rotateMatrix * position;
+		direction = (rotateMatrix * direction).Normalized();
 	}
 
-	currentParticle->position = currentParticle->initialPosition;
+	simulation.positionX[index] = position.x;
+	simulation.positionY[index] = position.y;
+	simulation.positionZ[index] = position.z;
+	simulation.directionX[index] = direction.x;
+	simulation.directionY[index] = direction.y;
+	simulation.directionZ[index] = direction.z;
 
 	if (velocityOverLifetime && velocityLinearRM == RandomMode::CONST_MULT) {
-		currentParticle->velocityXOL = ObtainRandomValueFloat(velocityLinearRM, velocityLinearX, velocityLinearXCurve, ParticleLifeNormalized(currentParticle));
-		currentParticle->velocityYOL = ObtainRandomValueFloat(velocityLinearRM, velocityLinearY, velocityLinearYCurve, ParticleLifeNormalized(currentParticle));
-		currentParticle->velocityZOL = ObtainRandomValueFloat(velocityLinearRM, velocityLinearZ, velocityLinearZCurve, ParticleLifeNormalized(currentParticle));
+		simulation.velocityX[index] = ObtainRandomValueFloat(velocityLinearRM, velocityLinearX, velocityLinearXCurve, ParticleLifeNormalized(index));
+		simulation.velocityY[index] = ObtainRandomValueFloat(velocityLinearRM, velocityLinearY, velocityLinearYCurve, ParticleLifeNormalized(index));
+		simulation.velocityZ[index] = ObtainRandomValueFloat(velocityLinearRM, velocityLinearZ, velocityLinearZCurve, ParticleLifeNormalized(index));
 	}
 }
 
-void ComponentParticleSystem::InitParticleRotation(Particle* currentParticle) {
+void ComponentParticleSystem::InitParticleRotation(unsigned index) {
 	float newRotation = ObtainRandomValueFloat(rotationRM, rotation, rotationCurve, emitterTime / duration);
 
 	if (billboardType == BillboardType::STRETCH) {
 		newRotation += pi / 2;
 	}
-	currentParticle->rotation = Quat::FromEulerXYZ(0.0f, 0.0f, newRotation);
+	simulation.rotation[index] = newRotation;
 
 	if (rotationOverLifetime && rotationFactorRM == RandomMode::CONST_MULT) {
-		currentParticle->rotationOL = ObtainRandomValueFloat(rotationFactorRM, rotationFactor, rotationFactorCurve, ParticleLifeNormalized(currentParticle));
+		simulation.rotationFactor[index] = ObtainRandomValueFloat(rotationFactorRM, rotationFactor, rotationFactorCurve, ParticleLifeNormalized(index));
 	}
 }
 
-void ComponentParticleSystem::InitParticleScale(Particle* currentParticle) {
-	currentParticle->emitter = this;
-	currentParticle->radius = radius;
+void ComponentParticleSystem::InitParticleScale(unsigned index) {
+	float particleRadius = radius;
 
-	currentParticle->scale = float3(0.1f, 0.1f, 0.1f) * ObtainRandomValueFloat(scaleRM, scale, scaleCurve, emitterTime / duration);
+	simulation.scale[index] = 0.1f * ObtainRandomValueFloat(scaleRM, scale, scaleCurve, emitterTime / duration);
 
 	if (sizeOverLifetime) {
-		float newScale = ObtainRandomValueFloat(scaleFactorRM, scaleFactor, scaleFactorCurve, ParticleLifeNormalized(currentParticle));
+		float newScale = ObtainRandomValueFloat(scaleFactorRM, scaleFactor, scaleFactorCurve, ParticleLifeNormalized(index));
 		if (scaleFactorRM == RandomMode::CONST_MULT) {
-			currentParticle->scaleOL = newScale;
+			simulation.scaleFactor[index] = newScale;
 		} else if (scaleFactorRM == RandomMode::CURVE) {
-			currentParticle->radius = radius * newScale;
+			particleRadius = radius * newScale;
 		}
 	}
 
-	if (App->time->HasGameStarted() && collision) {
-		App->physics->CreateParticleRigidbody(currentParticle);
+	// Only colliding particles need cold data for their rigidbody
+	if (collision) {
+		Particle* currentParticle = ObtainColdParticle(index);
+		currentParticle->radius = particleRadius;
+		if (App->time->HasGameStarted()) {
+			App->physics->CreateParticleRigidbody(currentParticle);
+		}
 	}
 }
 
-void ComponentParticleSystem::InitParticleSpeed(Particle* currentParticle) {
-	currentParticle->speed = ObtainRandomValueFloat(speedRM, speed, speedCurve, emitterTime / duration);
+void ComponentParticleSystem::InitParticleSpeed(unsigned index) {
+	simulation.speed[index] = ObtainRandomValueFloat(speedRM, speed, speedCurve, emitterTime / duration);
 
 	if (velocityOverLifetime && velocitySpeedModifierRM == RandomMode::CONST_MULT) {
-		currentParticle->speedMultiplierOL = ObtainRandomValueFloat(velocitySpeedModifierRM, velocitySpeedModifier, velocitySpeedModifierCurve, ParticleLifeNormalized(currentParticle));
+		simulation.speedMultiplier[index] = ObtainRandomValueFloat(velocitySpeedModifierRM, velocitySpeedModifier, velocitySpeedModifierCurve, ParticleLifeNormalized(index));
 	}
 }
 
-void ComponentParticleSystem::InitParticleGravity(Particle* currentParticle) {
+void ComponentParticleSystem::InitParticleGravity(unsigned index) {
 	if (gravityEffect && gravityFactorRM == RandomMode::CONST_MULT) {
-		currentParticle->gravityFactorOL = ObtainRandomValueFloat(gravityFactorRM, gravityFactor, gravityFactorCurve, ParticleLifeNormalized(currentParticle));
+		simulation.gravityFactor[index] = ObtainRandomValueFloat(gravityFactorRM, gravityFactor, gravityFactorCurve, ParticleLifeNormalized(index));
 	}
 }
 
-void ComponentParticleSystem::InitParticleLife(Particle* currentParticle) {
-	currentParticle->initialLife = ObtainRandomValueFloat(lifeRM, life, lifeCurve, emitterTime / duration);
-	currentParticle->life = currentParticle->initialLife;
+void ComponentParticleSystem::InitParticleLife(unsigned index) {
+	simulation.initialLife[index] = ObtainRandomValueFloat(lifeRM, life, lifeCurve, emitterTime / duration);
+	simulation.life[index] = simulation.initialLife[index];
 }
 
-void ComponentParticleSystem::InitParticleAnimationTexture(Particle* currentParticle) {
+void ComponentParticleSystem::InitParticleAnimationTexture(unsigned index) {
 	if (isRandomFrame) {
-		currentParticle->currentFrame = static_cast<float>(rand() % ((Xtiles * Ytiles) + 1));
+		simulation.frame[index] = static_cast<float>(rand() % ((Xtiles * Ytiles) + 1));
 	} else {
-		currentParticle->currentFrame = 0;
+		simulation.frame[index] = 0;
 	}
 
 	if (loopAnimation) {
-		currentParticle->animationSpeed = animationSpeed;
+		simulation.animationSpeed[index] = animationSpeed;
 	} else {
-		float timePerCycle = currentParticle->initialLife / nCycles;
+		float timePerCycle = simulation.initialLife[index] / nCycles;
 		float timePerFrame = (Ytiles * Xtiles) / timePerCycle;
-		currentParticle->animationSpeed = timePerFrame;
+		simulation.animationSpeed[index] = timePerFrame;
 	}
 }
 
@@ -1626,7 +1641,7 @@ void ComponentParticleSystem::InitStartRate() {
 	particlesCurrentFrame = (App->time->GetDeltaTimeOrRealDeltaTime() / restParticlesPerSecond);
 }
 
-void ComponentParticleSystem::InitSubEmitter(Particle* currentParticle, SubEmitterType subEmitterType) {
+void ComponentParticleSystem::InitSubEmitter(unsigned index, SubEmitterType subEmitterType) {
 	for (SubEmitter* subEmitter : subEmitters) {
 		if (subEmitter->subEmitterType != subEmitterType) continue;
 		if (!IsProbably(subEmitter->emitProbability)) continue;
@@ -1635,14 +1650,16 @@ void ComponentParticleSystem::InitSubEmitter(Particle* currentParticle, SubEmitt
 			Scene* scene = parent.scene;
 			UID gameObjectId = GenerateUID();
 			GameObject* newGameObject = scene->gameObjects.Obtain(gameObjectId);
+			if (newGameObject == nullptr) return;
+
 			newGameObject->scene = scene;
 			newGameObject->id = gameObjectId;
 			newGameObject->name = "SubEmitter (Temp)";
 			newGameObject->SetParent(&parent);
 
 			ComponentTransform* transform = newGameObject->CreateComponent<ComponentTransform>();
-			float3x3 rotationMatrix = float3x3::RotateFromTo(float3::unitY, currentParticle->direction);
-			float4x4 particleModel = float4x4::FromTRS(currentParticle->position, rotationMatrix, float3::one);
+			float3x3 rotationMatrix = float3x3::RotateFromTo(float3::unitY, GetParticleDirection(index));
+			float4x4 particleModel = float4x4::FromTRS(GetParticlePosition(index), rotationMatrix, float3::one);
 			if (attachEmitter) {
 				float4x4 emitterModel;
 				ObtainEmitterGlobalMatrix(emitterModel);
@@ -1678,6 +1695,8 @@ void ComponentParticleSystem::InitLight(Particle* currentParticle) {
 	Scene* scene = parent.scene;
 	UID gameObjectId = GenerateUID();
 	GameObject* newGameObject = scene->gameObjects.Obtain(gameObjectId);
+	if (newGameObject == nullptr) return;
+
 	newGameObject->scene = scene;
 	newGameObject->id = gameObjectId;
 	newGameObject->name = "Light (Temp)";
@@ -1686,11 +1705,12 @@ void ComponentParticleSystem::InitLight(Particle* currentParticle) {
 	ComponentTransform* transform = newGameObject->CreateComponent<ComponentTransform>();
 	ComponentTransform* transformPS = GetOwner().GetComponent<ComponentTransform>();
 
+	float3 position = GetParticlePosition(currentParticle->index);
 	if (attachEmitter) {
-		transform->SetPosition(currentParticle->position + lightOffset);
+		transform->SetPosition(position + lightOffset);
 	} else {
 		float3 globalOffset = transformPS->GetGlobalMatrix().RotatePart() * lightOffset;
-		transform->SetGlobalPosition(currentParticle->position + globalOffset);
+		transform->SetGlobalPosition(position + globalOffset);
 	}
 	transform->SetGlobalRotation(float3::zero);
 	transform->SetGlobalScale(float3::one);
@@ -1744,41 +1764,39 @@ void ComponentParticleSystem::Update() {
 
 	if (restDelayTime <= 0) {
 		if (isPlaying) {
-			for (Particle& currentParticle : particles) {
-				UpdatePosition(&currentParticle);
-
-				UpdateLife(&currentParticle);
-
-				if (rotationOverLifetime) {
-					UpdateRotation(&currentParticle);
-				}
+			float deltaTime = App->time->GetDeltaTimeOrRealDeltaTime();
+			if (!simulated) {
+				UpdateParticles(deltaTime);
+			}
 
+			// Only the particles with cold data need to be updated one by one
+			for (Particle& currentParticle : particles) {
 				if (sizeOverLifetime) {
-					UpdateScale(&currentParticle);
+					UpdateScale(&currentParticle, deltaTime);
 				}
 
-				if (!isRandomFrame) {
-					currentParticle.currentFrame += currentParticle.animationSpeed * App->time->GetDeltaTimeOrRealDeltaTime();
-				}
 				if (currentParticle.trail != nullptr) {
 					UpdateTrail(&currentParticle);
 				}
 
-				if (currentParticle.life < 0) {
-					deadParticles.push_back(&currentParticle);
-					InitSubEmitter(&currentParticle, SubEmitterType::DEATH);
-				}
-
 				if (currentParticle.hasCollided) {
-					InitSubEmitter(&currentParticle, SubEmitterType::COLLISION);
+					InitSubEmitter(currentParticle.index, SubEmitterType::COLLISION);
+					currentParticle.hasCollided = false;
 				}
 
 				if (currentParticle.lightGO != nullptr) {
 					UpdateLight(&currentParticle);
 				}
 			}
+
+			simulation.FindDead(deadParticles);
+			for (unsigned index : deadParticles) {
+				InitSubEmitter(index, SubEmitterType::DEATH);
+			}
 		}
 
+		simulated = false;
+
 		UndertakerParticle();
 		UpdateSubEmitters();
 		SpawnParticles();
@@ -1792,82 +1810,104 @@ void ComponentParticleSystem::Update() {
 	}
 }
 
-void ComponentParticleSystem::UpdatePosition(Particle* currentParticle) {
+bool ComponentParticleSystem::BeginSimulation() {
+	simulated = false;
+
+	// Emitters that start playing in this frame are updated in Update
+	if (!isStarted && App->time->HasGameStarted() && playOnAwake) return false;
+	if (restDelayTime > 0 || !isPlaying) return false;
+
+	// The simulation reads the global matrix of the emitter, which has to be up to date before the job starts
+	GetOwner().GetComponent<ComponentTransform>()->GetGlobalMatrix();
+	simulationDeltaTime = App->time->GetDeltaTimeOrRealDeltaTime();
+	simulated = true;
+	return true;
+}
+
+void ComponentParticleSystem::SimulateParticles() {
+	UpdateParticles(simulationDeltaTime);
+}
+
+void ComponentParticleSystem::UpdateParticles(float deltaTime) {
+	// Position
 	if (reverseEffect) {
-		currentParticle->position -= currentParticle->direction * currentParticle->speed * App->time->GetDeltaTimeOrRealDeltaTime();
+		simulation.UpdatePositionReverse(deltaTime);
 	} else {
 		if (gravityEffect) {
-			UpdateGravityDirection(currentParticle);
+			UpdateOverLifetimeValues(gravityFactorRM, gravityFactor, gravityFactorCurve, simulation.gravityFactor);
+
+			float3 gravityAxis = float3::unitY;
+			if (attachEmitter) {
+				float4x4 emitterModel;
+				ObtainEmitterGlobalMatrix(emitterModel);
+				gravityAxis = emitterModel.RotatePart().Inverted() * float3::unitY;
+			}
+			simulation.UpdatePositionGravity(gravityAxis, deltaTime);
 		}
 		if (velocityOverLifetime) {
-			UpdateVelocity(currentParticle);
+			UpdateOverLifetimeValues(velocityLinearRM, velocityLinearX, velocityLinearXCurve, simulation.velocityX);
+			UpdateOverLifetimeValues(velocityLinearRM, velocityLinearY, velocityLinearYCurve, simulation.velocityY);
+			UpdateOverLifetimeValues(velocityLinearRM, velocityLinearZ, velocityLinearZCurve, simulation.velocityZ);
+			UpdateOverLifetimeValues(velocitySpeedModifierRM, velocitySpeedModifier, velocitySpeedModifierCurve, simulation.speedMultiplier);
+
+			float3x3 velocitySpace = float3x3::identity;
+			if (velocityLinearSpace) {
+				velocitySpace = GetOwner().GetComponent<ComponentTransform>()->GetRotation().ToFloat3x3();
+			}
+			simulation.UpdatePositionVelocity(velocitySpace, deltaTime);
 		} else {
-			currentParticle->position += currentParticle->direction * currentParticle->speed * App->time->GetDeltaTimeOrRealDeltaTime();
+			simulation.UpdatePosition(deltaTime);
 		}
 	}
-}
 
-void ComponentParticleSystem::UpdateVelocity(Particle* currentParticle) {
-	float linearX, linearY, linearZ;
-	if (velocityLinearRM != RandomMode::CONST_MULT) {
-		linearX = ObtainRandomValueFloat(velocityLinearRM, velocityLinearX, velocityLinearXCurve, ParticleLifeNormalized(currentParticle));
-		linearY = ObtainRandomValueFloat(velocityLinearRM, velocityLinearY, velocityLinearYCurve, ParticleLifeNormalized(currentParticle));
-		linearZ = ObtainRandomValueFloat(velocityLinearRM, velocityLinearZ, velocityLinearZCurve, ParticleLifeNormalized(currentParticle));
-	} else {
-		linearX = currentParticle->velocityXOL;
-		linearY = currentParticle->velocityYOL;
-		linearZ = currentParticle->velocityZOL;
-	}
+	// Life
+	simulation.UpdateLife(deltaTime);
 
-	float speed;
-	if (velocitySpeedModifierRM != RandomMode::CONST_MULT) {
-		speed = ObtainRandomValueFloat(velocitySpeedModifierRM, velocitySpeedModifier, velocitySpeedModifierCurve, ParticleLifeNormalized(currentParticle));
-	} else {
-		speed = currentParticle->speedMultiplierOL;
+	// Rotation
+	if (rotationOverLifetime) {
+		UpdateOverLifetimeValues(rotationFactorRM, rotationFactor, rotationFactorCurve, simulation.rotationFactor);
+		simulation.UpdateRotation(deltaTime);
 	}
 
-	float3 direction;
-	if (velocityLinearSpace) {
-		direction = GetOwner().GetComponent<ComponentTransform>()->GetRotation() * float3(linearX, linearY, linearZ);
-	} else {
-		direction = float3(linearX, linearY, linearZ);
+	// Scale
+	if (sizeOverLifetime) {
+		UpdateOverLifetimeValues(scaleFactorRM, scaleFactor, scaleFactorCurve, simulation.scaleFactor);
+		if (scaleFactorRM == RandomMode::CURVE) {
+			simulation.SetScale(simulation.scaleFactor);
+		} else {
+			simulation.UpdateScale(deltaTime);
+		}
 	}
-	currentParticle->position += (currentParticle->direction + direction) * currentParticle->speed * speed * App->time->GetDeltaTimeOrRealDeltaTime();
-}
 
-void ComponentParticleSystem::UpdateRotation(Particle* currentParticle) {
-	float newRotation;
-	if (rotationFactorRM != RandomMode::CONST_MULT) {
-		newRotation = ObtainRandomValueFloat(rotationFactorRM, rotationFactor, rotationFactorCurve, ParticleLifeNormalized(currentParticle));
-	} else {
-		newRotation = currentParticle->rotationOL;
+	// Texture sheet animation
+	if (!isRandomFrame) {
+		simulation.UpdateFrames(deltaTime);
 	}
-	float rotation = currentParticle->rotation.ToEulerXYZ().z;
-	rotation += newRotation * App->time->GetDeltaTimeOrRealDeltaTime();
-	currentParticle->rotation = Quat::FromEulerXYZ(0.0f, 0.0f, rotation);
 }
 
-void ComponentParticleSystem::UpdateScale(Particle* currentParticle) {
-	if (scaleFactorRM == RandomMode::CURVE) {
-		float newScale = ObtainRandomValueFloat(scaleFactorRM, scaleFactor, scaleFactorCurve, ParticleLifeNormalized(currentParticle));
+void ComponentParticleSystem::UpdateOverLifetimeValues(RandomMode mode, float2& values, ImVec2* curveValues, float* particleValues) {
+	if (mode == RandomMode::CONST_MULT) return;
 
-		currentParticle->scale = float3(newScale);
-		currentParticle->radius = radius * newScale;
-	} else {
-		float newScale;
-		if (scaleFactorRM == RandomMode::CONST) {
-			newScale = ObtainRandomValueFloat(scaleFactorRM, scaleFactor);
-		} else {
-			newScale = currentParticle->scaleOL;
+	if (mode == RandomMode::CURVE && curveValues != nullptr) {
+		float curveTable[PARTICLE_CURVE_SAMPLES + 1];
+		for (int i = 0; i <= PARTICLE_CURVE_SAMPLES; ++i) {
+			curveTable[i] = values[0] * ImGui::CurveValue(i / (float) PARTICLE_CURVE_SAMPLES, CURVE_SIZE - 1, curveValues);
 		}
-
-		currentParticle->scale += float3(newScale) * App->time->GetDeltaTimeOrRealDeltaTime();
-		currentParticle->radius *= 1 + newScale * App->time->GetDeltaTimeOrRealDeltaTime() / currentParticle->scale.x;
+		simulation.SampleCurve(curveTable, particleValues);
+	} else {
+		simulation.Fill(particleValues, values[0]);
 	}
+}
 
-	if (currentParticle->scale.x < 0 || currentParticle->scale.y < 0 || currentParticle->scale.z < 0) {
-		currentParticle->scale = float3::zero;
+void ComponentParticleSystem::UpdateScale(Particle* currentParticle, float deltaTime) {
+	// The scale itself is updated in UpdateParticles. Here we only keep the collider in sync
+	float newScale = simulation.scale[currentParticle->index];
+	if (newScale <= 0) {
 		currentParticle->radius = 0;
+	} else if (scaleFactorRM == RandomMode::CURVE) {
+		currentParticle->radius = radius * newScale;
+	} else {
+		currentParticle->radius *= 1 + simulation.scaleFactor[currentParticle->index] * deltaTime / newScale;
 	}
 
 	if (App->time->HasGameStarted() && collision) {
@@ -1875,41 +1915,12 @@ void ComponentParticleSystem::UpdateScale(Particle* currentParticle) {
 	}
 }
 
-void ComponentParticleSystem::UpdateLife(Particle* currentParticle) {
-	currentParticle->life -= App->time->GetDeltaTimeOrRealDeltaTime();
-}
-
 void ComponentParticleSystem::UpdateTrail(Particle* currentParticle) {
-	float4x4 particleModel = float4x4::FromTRS(currentParticle->position, float3x3::identity, float3::one);
-	if (attachEmitter) {
-		float4x4 emitterModel;
-		ObtainEmitterGlobalMatrix(emitterModel);
-		particleModel = emitterModel * particleModel;
-	}
+	float4x4 particleModel;
+	ObtainParticleGlobalMatrix(currentParticle, particleModel);
 	currentParticle->trail->Update(particleModel.TranslatePart());
 }
 
-void ComponentParticleSystem::UpdateGravityDirection(Particle* currentParticle) {
-	float newGravityFactor;
-	if (gravityFactorRM != RandomMode::CONST_MULT) {
-		newGravityFactor = ObtainRandomValueFloat(gravityFactorRM, gravityFactor, gravityFactorCurve, ParticleLifeNormalized(currentParticle));
-	} else {
-		newGravityFactor = currentParticle->gravityFactorOL;
-	}
-
-	float4x4 particleModel = float4x4::FromTRS(currentParticle->position, float3x3::identity, float3::one);
-	if (attachEmitter) {
-		float4x4 emitterModel;
-		ObtainEmitterGlobalMatrix(emitterModel);
-		particleModel = emitterModel * particleModel;
-	}
-
-	float time = App->time->GetDeltaTimeOrRealDeltaTime();
-	float3 gravityAxis = particleModel.RotatePart().Inverted() * float3(0.0f, newGravityFactor, 0.0f);
-	currentParticle->position += currentParticle->direction * currentParticle->speed * time + 0.5 * gravityAxis * time * time;
-	currentParticle->direction += gravityAxis * time;
-}
-
 void ComponentParticleSystem::UpdateSubEmitters() {
 	for (unsigned pos = 0; pos < subEmittersGO.size(); ++pos) {
 		GameObject* gameObject = subEmittersGO[pos];
@@ -1945,49 +1956,62 @@ void ComponentParticleSystem::UpdateLight(Particle* currentParticle) {
 	ComponentTransform* transform = currentParticle->lightGO->GetComponent<ComponentTransform>();
 	ComponentTransform* transformPS = GetOwner().GetComponent<ComponentTransform>();
 
+	float3 position = GetParticlePosition(currentParticle->index);
 	if (attachEmitter) {
-		transform->SetPosition(currentParticle->position + lightOffset);
+		transform->SetPosition(position + lightOffset);
 	} else {
 		float3 globalOffset = transformPS->GetGlobalMatrix().RotatePart() * lightOffset;
-		transform->SetGlobalPosition(currentParticle->position + globalOffset);
+		transform->SetGlobalPosition(position + globalOffset);
 	}
 
 	if (useParticleColor && colorOverLifetime) {
 		float4 color = float4::one;
-		float factor = 1 - currentParticle->life / currentParticle->initialLife;
+		float factor = ParticleLifeNormalized(currentParticle->index);
 		gradient->getColorAt(factor, color.ptr());
 		light->color = float3(color.x, color.y, color.z);
 	} else if (useCustomColor) {
 		float4 color = float4::one;
-		float factor = 1 - currentParticle->life / currentParticle->initialLife;
+		float factor = ParticleLifeNormalized(currentParticle->index);
 		gradientLight->getColorAt(factor, color.ptr());
 		light->color = float3(color.x, color.y, color.z);
 	}
 }
 
 void ComponentParticleSystem::KillParticle(Particle* currentParticle) {
-	currentParticle->life = -1;
+	simulation.life[currentParticle->index] = -1;
 }
 
 void ComponentParticleSystem::UndertakerParticle(bool force) {
 	if (force) {
-		for (Particle& currentParticle : particles) {
-			deadParticles.push_back(&currentParticle);
+		deadParticles.clear();
+		for (unsigned index = simulation.Count(); index > 0; --index) {
+			deadParticles.push_back(index - 1);
 		}
 	}
-	for (Particle* currentParticle : deadParticles) {
-		if (currentParticle->rigidBody) App->physics->RemoveParticleRigidbody(currentParticle);
-		if (currentParticle->motionState) {
-			RELEASE(currentParticle->motionState);
+
+	// Dead particles go from last to first, so the particles moved into their slots are always alive
+	for (unsigned index : deadParticles) {
+		Particle* currentParticle = (Particle*) simulation.cold[index];
+		if (currentParticle != nullptr) {
+			if (currentParticle->rigidBody) App->physics->RemoveParticleRigidbody(currentParticle);
+			if (currentParticle->motionState) {
+				RELEASE(currentParticle->motionState);
+			}
+			RELEASE(currentParticle->trail);
+
+			if (currentParticle->lightGO != nullptr) {
+				if (App->editor->selectedGameObject == currentParticle->lightGO) App->editor->selectedGameObject = nullptr;
+				App->scene->DestroyGameObjectDeferred(currentParticle->lightGO);
+				lightsSpawned--;
+			}
+			particles.Release(currentParticle);
 		}
-		RELEASE(currentParticle->trail);
 
-		if (currentParticle->lightGO != nullptr) {
-			if (App->editor->selectedGameObject == currentParticle->lightGO) App->editor->selectedGameObject = nullptr;
-			App->scene->DestroyGameObjectDeferred(currentParticle->lightGO);
-			lightsSpawned--;
+		unsigned movedIndex = simulation.Remove(index);
+		Particle* movedParticle = movedIndex != PARTICLE_INVALID_INDEX ? (Particle*) simulation.cold[index] : nullptr;
+		if (movedParticle != nullptr) {
+			movedParticle->index = index;
 		}
-		particles.Release(currentParticle);
 	}
 	deadParticles.clear();
 }
@@ -2025,142 +2049,109 @@ void ComponentParticleSystem::DrawGizmos() {
 }
 
 void ComponentParticleSystem::Draw() {
-	if (isPlaying) {
-		for (Particle& currentParticle : particles) {
-			ProgramBillboard* program = App->programs->billboard;
-			glUseProgram(program->program);
-
-			unsigned glTexture = 0;
-			ResourceTexture* texture = App->resources->GetResource<ResourceTexture>(textureID);
-			glTexture = texture ? texture->glTexture : 0;
-			int hasDiffuseMap = texture ? 1 : 0;
-
-			glDepthMask(GL_FALSE);
-			glEnable(GL_BLEND);
-			glBlendEquation(GL_FUNC_ADD);
-			if (renderMode == ParticleRenderMode::ADDITIVE) {
-				glBlendFunc(GL_ONE, GL_ONE);
-			} else {
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-			}
+	if (!isPlaying || simulation.Count() == 0) return;
 
-			glBindBuffer(GL_ARRAY_BUFFER, App->userInterface->GetQuadVBO());
-			glEnableVertexAttribArray(0);
-			glEnableVertexAttribArray(1);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
-			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*) (sizeof(float) * 6 * 3));
+	if (!instanceBuffer.IsInitialized()) {
+		instanceBuffer.Init();
+	}
 
-			float4x4 particleModel = float4x4::FromTRS(currentParticle.position, float3x3::identity, float3::one);
-			if (attachEmitter) {
-				float4x4 emitterModel;
-				ObtainEmitterGlobalMatrix(emitterModel);
-				particleModel = emitterModel * particleModel;
-			}
-			float3 globalPosition = particleModel.TranslatePart();
-			float3 globalDirection = (particleModel.RotatePart() * currentParticle.direction).Normalized();
-			float4x4 newModelMatrix;
-			if (billboardType == BillboardType::NORMAL) {
-				if (renderAlignment == ParticleRenderAlignment::VIEW) {
-					Frustum* frustum = App->camera->GetActiveCamera()->GetFrustum();
-					newModelMatrix = float4x4::LookAt(float3::unitZ, -frustum->Front(), float3::unitY, float3::unitY);
-				} else if (renderAlignment == ParticleRenderAlignment::WORLD) {
-					newModelMatrix = float3x3::identity;
-					newModelMatrix[1][1] = -1; // Invert z axis
-				} else if (renderAlignment == ParticleRenderAlignment::LOCAL) {
-					ComponentTransform* transform = GetOwner().GetComponent<ComponentTransform>();
-					newModelMatrix = float4x4::LookAt(float3::unitZ, -(transform->GetGlobalRotation() * float3::unitY), float3::unitY, float3::unitY);
-				} else if (renderAlignment == ParticleRenderAlignment::FACING) {
-					float3 cameraPos = App->camera->GetActiveCamera()->GetFrustum()->Pos();
-					newModelMatrix = float4x4::LookAt(float3::unitZ, cameraPos - globalPosition, float3::unitY, float3::unitY);
-				} else { // Velocity
-					newModelMatrix = float4x4::LookAt(float3::unitZ, -globalPosition, float3::unitY, float3::unitY);
-				}
-			} else if (billboardType == BillboardType::STRETCH) {
-				float3 cameraPos = App->camera->GetActiveCamera()->GetFrustum()->Pos();
-				float3 cameraDir = (cameraPos - globalPosition).Normalized();
-				float3 upDir = Cross(globalDirection, cameraDir);
-				float3 newCameraDir = Cross(globalDirection, upDir);
-
-				float3x3 newRotation;
-				newRotation.SetCol(0, upDir);
-				newRotation.SetCol(1, globalDirection);
-				newRotation.SetCol(2, newCameraDir);
-
-				newModelMatrix = float4x4::identity * newRotation;
-			} else if (billboardType == BillboardType::HORIZONTAL) {
-				if (isHorizontalOrientation) {
-					float3 right = Cross(float3::unitY, globalDirection);
-					float3 direction = Cross(right, float3::unitY);
-
-					float3x3 newRotation;
-					newRotation.SetCol(1, right);
-					newRotation.SetCol(2, float3::unitY);
-					newRotation.SetCol(0, direction);
-
-					newModelMatrix = float4x4::identity * newRotation;
-				} else {
-					newModelMatrix = float4x4::LookAt(float3::unitZ, float3::unitY, float3::unitY, float3::unitY);
-				}
-			} else if (billboardType == BillboardType::VERTICAL) {
-				float3 cameraPos = App->camera->GetActiveCamera()->GetFrustum()->Pos();
-				float3 cameraDir = (float3(cameraPos.x, globalPosition.y, cameraPos.z) - globalPosition).Normalized();
-				newModelMatrix = float4x4::LookAt(float3::unitZ, cameraDir, float3::unitY, float3::unitY);
-			}
+	float4x4 emitterModel = float4x4::identity;
+	if (attachEmitter) {
+		ObtainEmitterGlobalMatrix(emitterModel);
+	}
 
-			float4x4 modelMatrix = float4x4::FromTRS(globalPosition, newModelMatrix.RotatePart() * float3x3::FromQuat(currentParticle.rotation), currentParticle.scale);
-			float4x4* view = &App->camera->GetViewMatrix();
-			float4x4* proj = &App->camera->GetProjectionMatrix();
+	// Fill the instances. The billboard orientation is computed in the vertex shader
+	unsigned numInstances = 0;
+	ParticleInstance* instances = instanceBuffer.Map(simulation.Count());
+	if (instances == nullptr) return;
+	for (unsigned index = 0; index < simulation.Count(); ++index) {
+		float3 position = GetParticlePosition(index);
+		ParticleInstance& instance = instances[numInstances++];
+		instance.position = attachEmitter ? emitterModel.TransformPos(position) : position;
+		instance.rotation = simulation.rotation[index];
+		instance.scale = float3(simulation.scale[index]);
+		instance.frame = simulation.frame[index];
+		instance.color = float4::one;
+		if (colorOverLifetime) {
+			float factor = ParticleLifeNormalized(index); // Life decreases from Life to 0
+			gradient->getColorAt(factor, instance.color.ptr());
+		}
+		instance.direction = (emitterModel.RotatePart() * GetParticleDirection(index)).Normalized();
+		instance.padding = 0.0f;
+	}
+	instanceBuffer.Unmap();
 
-			glUniformMatrix4fv(program->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
-			glUniformMatrix4fv(program->viewLocation, 1, GL_TRUE, view->ptr());
-			glUniformMatrix4fv(program->projLocation, 1, GL_TRUE, proj->ptr());
+	ProgramBillboardInstanced* program = App->programs->billboardInstanced;
+	glUseProgram(program->program);
 
-			float4 color = float4::one;
-			if (colorOverLifetime) {
-				float factor = 1 - currentParticle.life / currentParticle.initialLife; // Life decreases from Life to 0
-				gradient->getColorAt(factor, color.ptr());
-			}
+	unsigned glTexture = 0;
+	ResourceTexture* texture = App->resources->GetResource<ResourceTexture>(textureID);
+	glTexture = texture ? texture->glTexture : 0;
+	int hasDiffuseMap = texture ? 1 : 0;
+
+	glDepthMask(GL_FALSE);
+	glEnable(GL_BLEND);
+	glBlendEquation(GL_FUNC_ADD);
+	if (renderMode == ParticleRenderMode::ADDITIVE) {
+		glBlendFunc(GL_ONE, GL_ONE);
+	} else {
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
 
-			glUniform1f(program->nearLocation, App->camera->GetNearPlane());
-			glUniform1f(program->farLocation, App->camera->GetFarPlane());
+	Frustum* frustum = App->camera->GetActiveCamera()->GetFrustum();
+	float4x4 view = App->camera->GetViewMatrix();
+	float4x4 proj = App->camera->GetProjectionMatrix();
+	ComponentTransform* transform = GetOwner().GetComponent<ComponentTransform>();
+	float3 emitterUp = transform->GetGlobalRotation() * float3::unitY;
 
-			glUniform1i(program->transparentLocation, renderMode == ParticleRenderMode::TRANSPARENT ? 1 : 0);
+	glUniformMatrix4fv(program->viewLocation, 1, GL_TRUE, view.ptr());
+	glUniformMatrix4fv(program->projLocation, 1, GL_TRUE, proj.ptr());
 
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, App->renderer->depthsTexture);
-			glUniform1i(program->depthsLocation, 0);
+	glUniform1i(program->billboardTypeLocation, (int) billboardType);
+	glUniform1i(program->renderAlignmentLocation, (int) renderAlignment);
+	glUniform1i(program->horizontalOrientationLocation, isHorizontalOrientation ? 1 : 0);
+	glUniform3fv(program->cameraPosLocation, 1, frustum->Pos().ptr());
+	glUniform3fv(program->cameraFrontLocation, 1, frustum->Front().ptr());
+	glUniform3fv(program->emitterUpLocation, 1, emitterUp.ptr());
 
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, glTexture);
-			glUniform1i(program->diffuseMapLocation, 1);
-			glUniform1i(program->hasDiffuseLocation, hasDiffuseMap);
-			glUniform4fv(program->inputColorLocation, 1, color.ptr());
-			glUniform3fv(program->intensityLocation, 1, textureIntensity.ptr());
+	glUniform1f(program->nearLocation, App->camera->GetNearPlane());
+	glUniform1f(program->farLocation, App->camera->GetFarPlane());
 
-			glUniform1f(program->currentFrameLocation, currentParticle.currentFrame);
+	glUniform1i(program->transparentLocation, renderMode == ParticleRenderMode::TRANSPARENT ? 1 : 0);
 
-			glUniform1i(program->xTilesLocation, Xtiles);
-			glUniform1i(program->yTilesLocation, Ytiles);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, App->renderer->depthsTexture);
+	glUniform1i(program->depthsLocation, 0);
 
-			glUniform1i(program->xFlipLocation, flipTexture[0] ? 1 : 0);
-			glUniform1i(program->yFlipLocation, flipTexture[1] ? 1 : 0);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, glTexture);
+	glUniform1i(program->diffuseMapLocation, 1);
+	glUniform1i(program->hasDiffuseLocation, hasDiffuseMap);
+	glUniform3fv(program->intensityLocation, 1, textureIntensity.ptr());
 
-			glUniform1i(program->isSoftLocation, isSoft ? 1 : 0);
-			glUniform1f(program->softRangeLocation, softRange);
+	glUniform1i(program->xTilesLocation, Xtiles);
+	glUniform1i(program->yTilesLocation, Ytiles);
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glUniform1i(program->xFlipLocation, flipTexture[0] ? 1 : 0);
+	glUniform1i(program->yFlipLocation, flipTexture[1] ? 1 : 0);
 
-			glDisable(GL_BLEND);
-			glDepthMask(GL_TRUE);
+	glUniform1i(program->isSoftLocation, isSoft ? 1 : 0);
+	glUniform1f(program->softRangeLocation, softRange);
 
-			if (currentParticle.trail != nullptr) {
-				currentParticle.trail->Draw();
-			}
-			if (collision && App->renderer->drawColliders) {
-				dd::sphere(modelMatrix.TranslatePart(), dd::colors::LawnGreen, currentParticle.radius);
-			}
+	instanceBuffer.Draw(numInstances);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glDisable(GL_BLEND);
+	glDepthMask(GL_TRUE);
+
+	for (Particle& currentParticle : particles) {
+		if (currentParticle.trail != nullptr) {
+			currentParticle.trail->Draw();
+		}
+		if (collision && App->renderer->drawColliders) {
+			float3 position = GetParticlePosition(currentParticle.index);
+			float3 globalPosition = attachEmitter ? emitterModel.TransformPos(position) : position;
+			dd::sphere(globalPosition, dd::colors::LawnGreen, currentParticle.radius);
 		}
 	}
 }
@@ -2273,8 +2264,29 @@ bool ComponentParticleSystem::ImGuiRandomMenu(const char* name, RandomMode& mode
 	return used;
 };
 
-float ComponentParticleSystem::ParticleLifeNormalized(Particle* currentParticle) {
-	return 1 - currentParticle->life / currentParticle->initialLife;
+float ComponentParticleSystem::ParticleLifeNormalized(unsigned index) {
+	return 1 - simulation.life[index] / simulation.initialLife[index];
+}
+
+float3 ComponentParticleSystem::GetParticlePosition(unsigned index) const {
+	return float3(simulation.positionX[index], simulation.positionY[index], simulation.positionZ[index]);
+}
+
+float3 ComponentParticleSystem::GetParticleDirection(unsigned index) const {
+	return float3(simulation.directionX[index], simulation.directionY[index], simulation.directionZ[index]);
+}
+
+ComponentParticleSystem::Particle* ComponentParticleSystem::ObtainColdParticle(unsigned index) {
+	Particle* currentParticle = (Particle*) simulation.cold[index];
+	if (currentParticle != nullptr) return currentParticle;
+
+	// Both pools have the same capacity, so there is always room for the cold data of an alive particle
+	currentParticle = particles.Obtain();
+	currentParticle->index = index;
+	currentParticle->emitter = this;
+	currentParticle->radius = radius;
+	simulation.cold[index] = currentParticle;
+	return currentParticle;
 }
 
 void ComponentParticleSystem::ObtainEmitterGlobalMatrix(float4x4& matrix) {
@@ -2282,6 +2294,16 @@ void ComponentParticleSystem::ObtainEmitterGlobalMatrix(float4x4& matrix) {
 	matrix = model * emitterModel;
 }
 
+void ComponentParticleSystem::ObtainParticleGlobalMatrix(const Particle* currentParticle, float4x4& matrix) {
+	unsigned index = currentParticle->index;
+	matrix = float4x4::FromTRS(GetParticlePosition(index), Quat::FromEulerXYZ(0.0f, 0.0f, simulation.rotation[index]), float3::one);
+	if (attachEmitter) {
+		float4x4 emitterModel;
+		ObtainEmitterGlobalMatrix(emitterModel);
+		matrix = emitterModel * matrix;
+	}
+}
+
 void ComponentParticleSystem::Play() {
 	if (!isPlaying) {
 		isPlaying = true;
@@ -2340,7 +2362,7 @@ void ComponentParticleSystem::SetParticlesPerSecondChild(float2 particlesPerSeco
 }
 
 float ComponentParticleSystem::ChildParticlesInfo() {
-	float particlesInfo = (float) particles.Count();
+	float particlesInfo = (float) simulation.Count();
 	for (GameObject* currentChild : GetOwner().GetChildren()) {
 		if (currentChild->GetComponent<ComponentParticleSystem>()) {
 			particlesInfo += currentChild->GetComponent<ComponentParticleSystem>()->ChildParticlesInfo();
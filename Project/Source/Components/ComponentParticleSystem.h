@@ -4,6 +4,8 @@
 #include "Utils/Pool.h"
 #include "Utils/UID.h"
 #include "Utils/Collider.h"
+#include "Utils/ParticleSimulation.h"
+#include "Rendering/ParticleInstanceBuffer.h"
 
 #include "Math/float2.h"
 #include "Math/float3.h"
@@ -73,35 +75,13 @@ enum class SubEmitterType {
 
 class ComponentParticleSystem : public Component {
 public:
+	// Cold data of a particle. Only particles with a trail, a light or a collider have one.
+	// The hot data lives in the emitter's ParticleSimulation, at 'index'.
 	struct Particle {
-		~Particle() {
-			collidedWith.clear();
-		}
-
-		float3 initialPosition = float3(0.0f, 0.0f, 0.0f);
-		float3 position = float3(0.0f, 0.0f, 0.0f);
-		Quat rotation = Quat(0.0f, 0.0f, 0.0f, 0.0f);
-		float3 scale = float3(0.1f, 0.1f, 0.1f);
-		float3 direction = float3(0.0f, 0.0f, 0.0f);
-
-		float speed = 0.0f;
-		float life = 0.0f;
-		float initialLife = 0.0f;
-		float currentFrame = 0.0f;
-		float animationSpeed = 1.0f;
-
-		// Random Overlifetime variables
-		float rotationOL = 0.0f;
-		float scaleOL = 0.0f;
-		float velocityXOL = 0.0f;
-		float velocityYOL = 0.0f;
-		float velocityZOL = 0.0f;
-		float speedMultiplierOL = 0.0f;
-		float gravityFactorOL = 0.0f;
+		unsigned index = 0; // Index in the simulation arrays. Updated when the particle is moved
 
 		// Collider
-		bool hasCollided = false;
-		std::vector<GameObject*> collidedWith;
+		bool hasCollided = false; // Started touching a body since the last update. Set by ModulePhysics
 
 		ParticleMotionState* motionState = nullptr;
 		btRigidBody* rigidBody = nullptr;
@@ -138,26 +118,25 @@ public:
 	void SpawnParticles();
 	void SpawnParticleUnit();
 
-	void InitParticlePosAndDir(Particle* currentParticle);
-	void InitParticleRotation(Particle* currentParticle);
-	void InitParticleScale(Particle* currentParticle);
-	void InitParticleSpeed(Particle* currentParticle);
-	void InitParticleGravity(Particle* currentParticle);
-	void InitParticleLife(Particle* currentParticle);
-	void InitParticleAnimationTexture(Particle* currentParticle);
+	void InitParticlePosAndDir(unsigned index);
+	void InitParticleRotation(unsigned index);
+	void InitParticleScale(unsigned index);
+	void InitParticleSpeed(unsigned index);
+	void InitParticleGravity(unsigned index);
+	void InitParticleLife(unsigned index);
+	void InitParticleAnimationTexture(unsigned index);
 	void InitParticleTrail(Particle* currentParticle);
 	void InitStartDelay();
 	void InitStartRate();
-	void InitSubEmitter(Particle* currentParticle, SubEmitterType subEmitterType);
+	void InitSubEmitter(unsigned index, SubEmitterType subEmitterType);
 	void InitLight(Particle* currentParticle);
 
-	TESSERACT_ENGINE_API void UpdatePosition(Particle* currentParticle);
-	void UpdateVelocity(Particle* currentParticle);
-	void UpdateRotation(Particle* currentParticle);
-	void UpdateScale(Particle* currentParticle);
-	void UpdateLife(Particle* currentParticle);
+	bool BeginSimulation();				   // Called on the main thread before SimulateParticles. Returns false if the emitter doesn't update its particles in this frame
+	void SimulateParticles();			   // Runs UpdateParticles ahead of Update. It only touches this emitter, so it can run in a job
+	void UpdateParticles(float deltaTime); // Batched update of the hot data of every particle
+	void UpdateOverLifetimeValues(RandomMode mode, float2& values, ImVec2* curveValues, float* particleValues); // Fills the per-particle values of curves and constants. Random values are kept from the spawn
+	void UpdateScale(Particle* currentParticle, float deltaTime);
 	void UpdateTrail(Particle* currentParticle);
-	void UpdateGravityDirection(Particle* currentParticle);
 	void UpdateSubEmitters();
 	void UpdateLight(Particle* currentParticle);
 
@@ -166,8 +145,12 @@ public:
 	void Draw();
 	void ImGuiParticlesEffect();
 	bool ImGuiRandomMenu(const char* name, RandomMode& mode, float2& values, ImVec2* curveValues, bool isEmitterDuration = true, float speed = 0.01f, float min = 0, float max = inf, const char* format = "%.3f", ImGuiSliderFlags flags = 0);
-	float ParticleLifeNormalized(Particle* currentParticle);
+	float ParticleLifeNormalized(unsigned index);
+	float3 GetParticlePosition(unsigned index) const; // Local to the emitter if it's attached, global otherwise
+	float3 GetParticleDirection(unsigned index) const;
+	Particle* ObtainColdParticle(unsigned index); // Creates the cold data of the particle if it doesn't have one yet
 	void ObtainEmitterGlobalMatrix(float4x4& matrix);
+	void ObtainParticleGlobalMatrix(const Particle* currentParticle, float4x4& matrix);
 
 	TESSERACT_ENGINE_API void Play();
 	TESSERACT_ENGINE_API void Restart();
@@ -318,10 +301,14 @@ public:
 
 private:
 	// Common
-	Pool<Particle> particles;
-	std::vector<Particle*> deadParticles;
+	ParticleSimulation simulation; // Hot data of every alive particle
+	Pool<Particle> particles;		// Cold data, only for the particles that need it
+	std::vector<unsigned> deadParticles;
+	ParticleInstanceBuffer instanceBuffer; // Written once per frame, all the particles are drawn with a single instanced call
 	bool isPlaying = false;
 	bool isStarted = false;
+	bool simulated = false; // Set when the particles of this frame were already updated by SimulateParticles
+	float simulationDeltaTime = 0.0f;
 
 	float3 cameraDir = {0.f, 0.f, 0.f};
 	float emitterTime = 0.0f;
@@ -16,8 +16,8 @@
 #define JSON_TAG_LOCAL_EULER_ANGLES "LocalEulerAngles"
 
 void ComponentTransform::OnEditorUpdate() {
-	float3 pos = position;
-	float3 scl = scale;
+	float3 pos = GetPosition();
+	float3 scl = GetScale();
 	float3 rot = localEulerAngles;
 
 	ImGui::TextColored(App->editor->titleColor, "Transformation (X,Y,Z)");
@@ -34,6 +34,10 @@ void ComponentTransform::OnEditorUpdate() {
 }
 
 void ComponentTransform::Save(JsonValue jComponent) const {
+	float3 position = GetPosition();
+	Quat rotation = GetRotation();
+	float3 scale = GetScale();
+
 	JsonValue jPosition = jComponent[JSON_TAG_POSITION];
 	jPosition[0] = position.x;
 	jPosition[1] = position.y;
@@ -58,80 +62,53 @@ void ComponentTransform::Save(JsonValue jComponent) const {
 
 void ComponentTransform::Load(JsonValue jComponent) {
 	JsonValue jPosition = jComponent[JSON_TAG_POSITION];
-	position.Set(jPosition[0], jPosition[1], jPosition[2]);
+	float3 position(jPosition[0], jPosition[1], jPosition[2]);
 
 	JsonValue jRotation = jComponent[JSON_TAG_ROTATION];
-	rotation.Set(jRotation[0], jRotation[1], jRotation[2], jRotation[3]);
+	Quat rotation(jRotation[0], jRotation[1], jRotation[2], jRotation[3]);
 
 	JsonValue jScale = jComponent[JSON_TAG_SCALE];
-	scale.Set(jScale[0], jScale[1], jScale[2]);
+	float3 scale(jScale[0], jScale[1], jScale[2]);
 
 	JsonValue jLocalEulerAngles = jComponent[JSON_TAG_LOCAL_EULER_ANGLES];
 	localEulerAngles.Set(jLocalEulerAngles[0], jLocalEulerAngles[1], jLocalEulerAngles[2]);
 
-	dirty = true;
+	hierarchy->SetTRS(hierarchyIndex, position, rotation, scale);
 }
 
 void ComponentTransform::InvalidateHierarchy() {
-	if (!dirty) {
-		dirty = true;
-		ComponentBoundingBox* boundingBox = GetOwner().GetComponent<ComponentBoundingBox>();
-		if (boundingBox) boundingBox->Invalidate();
-
-		for (GameObject* child : GetOwner().GetChildren()) {
-			
-			ComponentTransform* childTransform = child->GetComponent<ComponentTransform>();
-			if (childTransform != nullptr) {
-				childTransform->InvalidateHierarchy();
-			}
-		}
-	}
+	hierarchy->Invalidate(hierarchyIndex);
 }
 
-void ComponentTransform::CalculateGlobalMatrix(bool force) {
-	if (force || dirty) {
-		localMatrix = float4x4::FromTRS(position, rotation, scale);
-
-		GameObject* parent = GetOwner().GetParent();
-		if (parent != nullptr) {
-			ComponentTransform* parentTransform = parent->GetComponent<ComponentTransform>();
-
-			parentTransform->CalculateGlobalMatrix();
-			globalMatrix = parentTransform->globalMatrix * localMatrix;
-		} else {
-			globalMatrix = localMatrix;
-		}
-
-		dirty = false;
-	}
+void ComponentTransform::UpdateParent() {
+	hierarchy->Relink(this);
 }
 
 void ComponentTransform::SetPosition(float3 position_) {
-	position = position_;
-	InvalidateHierarchy();
+	hierarchy->SetPosition(hierarchyIndex, position_);
 }
 
 void ComponentTransform::SetRotation(Quat rotation_) {
-	rotation = rotation_;
 	localEulerAngles = rotation_.ToEulerXYZ().Mul(RADTODEG);
-	InvalidateHierarchy();
+	hierarchy->SetRotation(hierarchyIndex, rotation_);
 }
 
 void ComponentTransform::SetRotation(float3 rotation_) {
-	rotation = Quat::FromEulerXYZ(rotation_.x * DEGTORAD, rotation_.y * DEGTORAD, rotation_.z * DEGTORAD);
 	localEulerAngles = rotation_;
-	InvalidateHierarchy();
+	hierarchy->SetRotation(hierarchyIndex, Quat::FromEulerXYZ(rotation_.x * DEGTORAD, rotation_.y * DEGTORAD, rotation_.z * DEGTORAD));
 }
 
 void ComponentTransform::SetScale(float3 scale_) {
-	scale = scale_;
-	InvalidateHierarchy();
+	hierarchy->SetScale(hierarchyIndex, scale_);
 }
 
 void ComponentTransform::SetTRS(const float4x4& newTransform_) {
+	float3 position;
+	Quat rotation;
+	float3 scale;
 	newTransform_.Decompose(position, rotation, scale);
 	localEulerAngles = rotation.ToEulerXYZ().Mul(RADTODEG);
-	InvalidateHierarchy();
+	hierarchy->SetTRS(hierarchyIndex, position, rotation, scale);
 }
 
 void ComponentTransform::SetGlobalPosition(float3 position_) {
@@ -185,44 +162,39 @@ void ComponentTransform::SetGlobalTRS(float4x4& newTransform_) {
 }
 
 float3 ComponentTransform::GetPosition() const {
-	return position;
+	return hierarchy->GetPosition(hierarchyIndex);
 }
 
 Quat ComponentTransform::GetRotation() const {
-	return rotation;
+	return hierarchy->GetRotation(hierarchyIndex);
 }
 
 float3 ComponentTransform::GetScale() const {
-	return scale;
+	return hierarchy->GetScale(hierarchyIndex);
 }
 
 float3 ComponentTransform::GetGlobalPosition() {
-	CalculateGlobalMatrix();
-	return globalMatrix.TranslatePart();
+	return GetGlobalMatrix().TranslatePart();
 }
 
 Quat ComponentTransform::GetGlobalRotation() {
-	CalculateGlobalMatrix();
-	return Quat(globalMatrix.RotatePart());
+	return Quat(GetGlobalMatrix().RotatePart());
 }
 
 float3 ComponentTransform::GetGlobalScale() {
-	CalculateGlobalMatrix();
-	return globalMatrix.GetScale();
+	return GetGlobalMatrix().GetScale();
 }
 
-const float4x4& ComponentTransform::GetLocalMatrix() {
-	CalculateGlobalMatrix();
-	return localMatrix;
+float4x4 ComponentTransform::GetLocalMatrix() {
+	return hierarchy->GetLocalMatrix(hierarchyIndex);
 }
 
-const float4x4& ComponentTransform::GetGlobalMatrix() {
-	CalculateGlobalMatrix();
-	return globalMatrix;
+float4x4 ComponentTransform::GetGlobalMatrix() {
+	return hierarchy->GetWorldMatrix(hierarchyIndex);
 }
 
 float3 ComponentTransform::GetFront() const {
-	return rotation * float3::unitZ;
+	return GetRotation() * float3::unitZ;
 }
 
 float3 ComponentTransform::GetRight() const {
@@ -230,5 +202,5 @@ float3 ComponentTransform::GetRight() const {
 }
 
 float3 ComponentTransform::GetUp() const {
-	return rotation * float3::unitY;
+	return GetRotation() * float3::unitY;
 }
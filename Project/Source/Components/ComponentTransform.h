@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Component.h"
+#include "Utils/TransformHierarchy.h"
 
 #include "Math/float3.h"
 #include "Math/Quat.h"
@@ -15,8 +16,8 @@ public:
 	void Save(JsonValue jComponent) const override;
 	void Load(JsonValue jComponent) override;
 
-	void InvalidateHierarchy();						// Marks all the hierarchy of the owner GameObject as 'dirty'
-	void CalculateGlobalMatrix(bool force = false); // Recalculates the Transformation Matrix from 'position', 'rotation' and 'scale'.
+	void InvalidateHierarchy();	// Marks all the hierarchy of the owner GameObject as 'dirty'
+	void UpdateParent();		// Called by the owner GameObject when its parent changes
 
 	// ---------- Setters ---------- //
 	TESSERACT_ENGINE_API void SetPosition(float3 position);
@@ -38,20 +39,17 @@ public:
 	TESSERACT_ENGINE_API float3 GetGlobalPosition();
 	TESSERACT_ENGINE_API Quat GetGlobalRotation();
 	TESSERACT_ENGINE_API float3 GetGlobalScale();
-	TESSERACT_ENGINE_API const float4x4& GetLocalMatrix();
-	TESSERACT_ENGINE_API const float4x4& GetGlobalMatrix();
+	TESSERACT_ENGINE_API float4x4 GetLocalMatrix(); // Returned by value, since the hierarchy moves its matrices when transforms are added or sorted
+	TESSERACT_ENGINE_API float4x4 GetGlobalMatrix();
 	TESSERACT_ENGINE_API float3 GetFront() const;
 	TESSERACT_ENGINE_API float3 GetRight() const;
 	TESSERACT_ENGINE_API float3 GetUp() const;
 
 private:
-	float3 position = float3::zero;			// Position of the GameObject in world coordinates.
-	Quat rotation = Quat::identity;			// Rotation of the GameObject as a Quaternion.
-	float3 localEulerAngles = float3::zero; // Rotation of the GameObject as euler angles.
-	float3 scale = float3::one;				// Scale of the GameObject.
+	friend class TransformHierarchy;
 
-	float4x4 localMatrix = float4x4::identity;	// Transform Matrix in local coordinates from its parent gameobject.
-	float4x4 globalMatrix = float4x4::identity; // Transform Matrix in world coordinates.
+	float3 localEulerAngles = float3::zero; // Rotation of the GameObject as euler angles.
 
-	bool dirty = true; // If set to true CalculateGlobalMatrix() will update the Transform when called. Otherwise, it will skip the calculations.
+	TransformHierarchy* hierarchy = nullptr;	   // Hierarchy of the scene, which stores the position, rotation, scale and matrices of the transform
+	int hierarchyIndex = TRANSFORM_HIERARCHY_NONE; // Index of the transform in the hierarchy. Changes when the hierarchy is sorted
 };
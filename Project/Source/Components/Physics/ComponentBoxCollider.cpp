@@ -113,6 +113,7 @@ void ComponentBoxCollider::OnEditorUpdate() {
 
 	if (colliderType == ColliderType::DYNAMIC) { // Mass is only available when the collider is dynamic
 		if (ImGui::DragFloat("Mass", &mass, App->editor->dragSpeed3f, 0.0f, 100.f) && App->time->HasGameStarted()) {
+			App->physics->WaitForStep();
 			rigidBody->setMassProps(mass, btVector3(0, 0, 0));
 		}
 	}
@@ -127,6 +128,7 @@ void ComponentBoxCollider::OnEditorUpdate() {
 		if (App->time->HasGameStarted()) {
 			float3 position = GetOwner().GetComponent<ComponentTransform>()->GetGlobalPosition();
 			Quat rotation = GetOwner().GetComponent<ComponentTransform>()->GetGlobalRotation();
+			App->physics->WaitForStep();
 			rigidBody->setCenterOfMassTransform(btTransform(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w), btVector3(position.x, position.y, position.z)) * btTransform(btQuaternion::getIdentity(), btVector3(centerOffset.x, centerOffset.y, centerOffset.z)));
 		}
 	}
@@ -192,30 +194,6 @@ void ComponentBoxCollider::OnDisable() {
 	if (rigidBody && App->time->HasGameStarted() && GetOwner().scene == GetOwner().scene) App->physics->RemoveBoxRigidbody(this);
 }
 
-void ComponentBoxCollider::OnCollision(GameObject& collidedWith, float3 collisionNormal, float3 penetrationDistance, ComponentParticleSystem::Particle* p) {
-	if (p != nullptr) {
-		bool alreadyCollided = false;
-		for (GameObject* collided : p->collidedWith) {
-			if (collided == &GetOwner()) {
-				alreadyCollided = true;
-			}
-		}
-		if (!alreadyCollided) {
-			p->collidedWith.push_back(&GetOwner());
-			p->hasCollided = true;
-		} else {
-			p->hasCollided = false;
-		}
-	}
-
-	for (ComponentScript& scriptComponent : GetOwner().GetComponents<ComponentScript>()) {
-		Script* script = scriptComponent.GetScriptInstance();
-		if (script != nullptr) {
-			script->OnCollision(collidedWith, collisionNormal, penetrationDistance, p);
-		}
-	}
-}
-
 void ComponentBoxCollider::CalculateWorldBoundingBox() {
 	worldOBB = OBB(localAABB);
 	worldOBB.Transform(GetOwner().GetComponent<ComponentTransform>()->GetGlobalMatrix());
@@ -26,7 +26,6 @@ public:
 	void OnDisable() override;
 
 	// ----- Collider Functions ---- //
-	void OnCollision(GameObject& collidedWith, float3 collisionNormal, float3 penetrationDistance, ComponentParticleSystem::Particle* p = nullptr);  // Callback function for scripting
 	void CalculateWorldBoundingBox(); // Set the worldOBB from the localAABB and the GameObject transform
 
 public:
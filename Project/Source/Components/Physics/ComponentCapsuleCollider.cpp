@@ -117,6 +117,7 @@ void ComponentCapsuleCollider::OnEditorUpdate() {
 
 	if (colliderType == ColliderType::DYNAMIC) {
 		if (ImGui::DragFloat("Mass", &mass, App->editor->dragSpeed3f, 0.0f, 100.f) && App->time->HasGameStarted()) {
+			App->physics->WaitForStep();
 			rigidBody->setMassProps(mass, btVector3(0, 0, 0));
 		}
 	}
@@ -169,6 +170,7 @@ void ComponentCapsuleCollider::OnEditorUpdate() {
 	if (ImGui::DragFloat3("Center Offset", centerOffset.ptr(), App->editor->dragSpeed2f, -inf, inf) && App->time->HasGameStarted()) {
 		float3 position = GetOwner().GetComponent<ComponentTransform>()->GetGlobalPosition();
 		Quat rotation = GetOwner().GetComponent<ComponentTransform>()->GetGlobalRotation();
+		App->physics->WaitForStep();
 		rigidBody->setCenterOfMassTransform(btTransform(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w), btVector3(position.x, position.y, position.z)) * btTransform(btQuaternion::getIdentity(), btVector3(centerOffset.x, centerOffset.y, centerOffset.z)));
 	}
 
@@ -242,27 +244,3 @@ void ComponentCapsuleCollider::OnEnable() {
 void ComponentCapsuleCollider::OnDisable() {
 	if (rigidBody && App->time->HasGameStarted() && GetOwner().scene == GetOwner().scene) App->physics->RemoveCapsuleRigidbody(this);
 }
-
-void ComponentCapsuleCollider::OnCollision(GameObject& collidedWith, float3 collisionNormal, float3 penetrationDistance, ComponentParticleSystem::Particle* p) {
-	if (p != nullptr) {
-		bool alreadyCollided = false;
-		for (GameObject* collided : p->collidedWith) {
-			if (collided == &GetOwner()) {
-				alreadyCollided = true;
-			}
-		}
-		if (!alreadyCollided) {
-			p->collidedWith.push_back(&GetOwner());
-			p->hasCollided = true;
-		} else {
-			p->hasCollided = false;
-		}
-	}
-
-	for (ComponentScript& scriptComponent : GetOwner().GetComponents<ComponentScript>()) {
-		Script* script = scriptComponent.GetScriptInstance();
-		if (script != nullptr) {
-			script->OnCollision(collidedWith, collisionNormal, penetrationDistance, p);
-		}
-	}
-}
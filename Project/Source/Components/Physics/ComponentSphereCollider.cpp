@@ -98,6 +98,7 @@ void ComponentSphereCollider::OnEditorUpdate() {
 
 	if (colliderType == ColliderType::DYNAMIC) { // Mass is only available when the collider is dynamic
 		if (ImGui::DragFloat("Mass", &mass, App->editor->dragSpeed3f, 0.0f, 100.f) && App->time->HasGameStarted()) {
+			App->physics->WaitForStep();
 			rigidBody->setMassProps(mass, rigidBody->getLocalInertia());
 		}
 	}
@@ -107,6 +108,7 @@ void ComponentSphereCollider::OnEditorUpdate() {
 	if (ImGui::DragFloat3("Center Offset", centerOffset.ptr(), App->editor->dragSpeed2f, -inf, inf) && App->time->HasGameStarted()) {
 		float3 position = GetOwner().GetComponent<ComponentTransform>()->GetGlobalPosition();
 		Quat rotation = GetOwner().GetComponent<ComponentTransform>()->GetGlobalRotation();
+		App->physics->WaitForStep();
 		rigidBody->setCenterOfMassTransform(btTransform(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w), btVector3(position.x, position.y, position.z)) * btTransform(btQuaternion::getIdentity(), btVector3(centerOffset.x, centerOffset.y, centerOffset.z)));
 	}
 	if (ImGui::Checkbox("Freeze rotation", &freezeRotation) && App->time->HasGameStarted()) {
@@ -167,27 +169,3 @@ void ComponentSphereCollider::OnEnable() {
 void ComponentSphereCollider::OnDisable() {
 	if (rigidBody && App->time->HasGameStarted() && GetOwner().scene == GetOwner().scene) App->physics->RemoveSphereRigidbody(this);
 }
-
-void ComponentSphereCollider::OnCollision(GameObject& collidedWith, float3 collisionNormal, float3 penetrationDistance, ComponentParticleSystem::Particle* p) {
-	if (p != nullptr) {
-		bool alreadyCollided = false;
-		for (GameObject* collided : p->collidedWith) {
-			if (collided == &GetOwner()) {
-				alreadyCollided = true;
-			}
-		}
-		if (!alreadyCollided) {
-			p->collidedWith.push_back(&GetOwner());
-			p->hasCollided = true;
-		} else {
-			p->hasCollided = false;
-		}
-	}
-
-	for (ComponentScript& scriptComponent : GetOwner().GetComponents<ComponentScript>()) {
-		Script* script = scriptComponent.GetScriptInstance();
-		if (script != nullptr) {
-			script->OnCollision(collidedWith, collisionNormal, penetrationDistance, p);
-		}
-	}
-}
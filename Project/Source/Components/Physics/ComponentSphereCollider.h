@@ -24,7 +24,6 @@ public:
 	void OnDisable() override;
 
 	// ----- Collider Functions ---- //
-	void OnCollision(GameObject& collidedWith, float3 collisionNormal, float3 penetrationDistance, ComponentParticleSystem::Particle* p = nullptr); // Callback function for scripting
 
 public:
 	btRigidBody* rigidBody = nullptr;										// Body that is represented in the physic world.
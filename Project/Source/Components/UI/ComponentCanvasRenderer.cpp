@@ -5,6 +5,7 @@
 #include "Components/UI/ComponentText.h"
 #include "Components/UI/ComponentCanvas.h"
 #include "Components/UI/ComponentTransform2D.h"
+#include "Rendering/UIBatch.h"
 
 
 #include "debugdraw.h"
@@ -17,7 +18,7 @@ void ComponentCanvasRenderer::Save(JsonValue jComponent) const {
 void ComponentCanvasRenderer::Load(JsonValue jComponent) {
 }
 
-void ComponentCanvasRenderer::Render(const GameObject* gameObject) const {
+void ComponentCanvasRenderer::Render(const GameObject* gameObject, UIBatch& batch) const {
 	ComponentTransform2D* transform2D = gameObject->GetComponent<ComponentTransform2D>();
 	const ComponentCanvas* parentCanvas = AnyParentHasCanvas(&GetOwner());
 	if (transform2D != nullptr && parentCanvas != nullptr) { // Get the Parent in a variable if needed and add canvas customization to render
@@ -25,16 +26,17 @@ void ComponentCanvasRenderer::Render(const GameObject* gameObject) const {
 		//IF OTHER COMPONENTS THAT RENDER IN UI ARE IMPLEMENTED, THEY MUST HAVE THEIR DRAW METHODS CALLED HERE
 		ComponentImage* componentImage = gameObject->GetComponent<ComponentImage>();
 		if (componentImage != nullptr && componentImage->IsActive()) {
-			componentImage->Draw(transform2D);
+			componentImage->Draw(transform2D, batch);
 		}
 
 		ComponentText* componentText = gameObject->GetComponent<ComponentText>();
 		if (componentText != nullptr && componentText->IsActive()) {
-			componentText->Draw(transform2D);
+			componentText->Draw(transform2D, batch);
 		}
 
 		ComponentVideo* componentVideo = gameObject->GetComponent<ComponentVideo>();
 		if (componentVideo != nullptr && componentVideo->IsActive()) {
+			batch.Flush(); // Keep the drawing order
 			componentVideo->Draw(transform2D);
 		}
 	}
@@ -5,6 +5,7 @@
 #include "Math/float2.h"
 
 class ComponentCanvas;
+class UIBatch;
 
 class ComponentCanvasRenderer : public Component {
 public:
@@ -12,8 +13,8 @@ public:
 
 	void Save(JsonValue jComponent) const override;
 	void Load(JsonValue jComponent) override;
-	bool CanBeRemoved() const override;				 //This override returns false if the GameObject holds a ComponentImage/ComponentText
-	void Render(const GameObject* gameObject) const; //Calls Draw on all images if one of its parents is a canvas
+	bool CanBeRemoved() const override;								 //This override returns false if the GameObject holds a ComponentImage/ComponentText
+	void Render(const GameObject* gameObject, UIBatch& batch) const; //Adds the images and texts to the batch if one of its parents is a canvas. Videos are drawn after flushing it
 
 	float2 GetCanvasSize();
 	float2 GetScreenReferenceSize() const;
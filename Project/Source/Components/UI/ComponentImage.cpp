@@ -10,6 +10,7 @@
 #include "Modules/ModuleUserInterface.h"
 #include "Components/UI/ComponentTransform2D.h"
 #include "Resources/ResourceTexture.h"
+#include "Rendering/UIBatch.h"
 #include "FileSystem/JsonValue.h"
 #include "Utils/ImGuiUtils.h"
 
@@ -28,16 +29,10 @@
 
 ComponentImage::~ComponentImage() {
 	App->resources->DecreaseReferenceCount(textureID);
-
-	glDeleteBuffers(1, &fillQuadVBO);
 }
 
 void ComponentImage::Init() {
 	App->resources->IncreaseReferenceCount(textureID);
-
-	glGenBuffers(1, &fillQuadVBO);
-
-	RebuildFillQuadVBO();
 }
 
 void ComponentImage::Update() {
@@ -63,9 +58,7 @@ void ComponentImage::OnEditorUpdate() {
 
 	ImGui::Checkbox("Is Fill", &isFill);
 
-	if (ImGui::DragFloat("Fill", &fillVal, App->editor->dragSpeed2f, 0, 1)) {
-		RebuildFillQuadVBO();
-	}
+	ImGui::DragFloat("Fill", &fillVal, App->editor->dragSpeed2f, 0, 1);
 
 	float oldTextureOffset[2] = {textureOffset.x, textureOffset.y};
 
@@ -179,64 +172,28 @@ float4 ComponentImage::GetMainColor() const {
 	return componentColor.Equals(App->userInterface->GetErrorColor()) ? color : componentColor;
 }
 
-void ComponentImage::Draw(ComponentTransform2D* transform) const {
-	ProgramImageUI* imageUIProgram = App->programs->imageUI;
-	if (imageUIProgram == nullptr) return;
-
-	if (alphaTransparency) {
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	}
-	if (isFill) {
-		glBindBuffer(GL_ARRAY_BUFFER, fillQuadVBO);
-	} else {
-		glBindBuffer(GL_ARRAY_BUFFER, App->userInterface->GetQuadVBO());
-	}
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*) ((sizeof(float) * 6 * 3)));
-	glUseProgram(imageUIProgram->program);
-
+void ComponentImage::Draw(ComponentTransform2D* transform, UIBatch& batch) const {
 	float4x4 modelMatrix = transform->GetGlobalScaledMatrix();
-	float4x4& proj = App->camera->GetProjectionMatrix();
-	float4x4& view = App->camera->GetViewMatrix();
-
-	if (App->userInterface->IsUsing2D()) {
-		proj = float4x4::D3DOrthoProjLH(-1, 1, App->renderer->GetViewportSize().x, App->renderer->GetViewportSize().y); //near plane. far plane, screen width, screen height
-		view = float4x4::identity;
-	}
 
 	ComponentCanvasRenderer* canvasRenderer = GetOwner().GetComponent<ComponentCanvasRenderer>();
 	if (canvasRenderer != nullptr) {
 		float factor = canvasRenderer->GetCanvasScreenFactor();
-		view = view * float4x4::Scale(factor, factor, factor);
+		modelMatrix = float4x4::Scale(factor, factor, factor) * modelMatrix;
 	}
 
-	glUniformMatrix4fv(imageUIProgram->viewLocation, 1, GL_TRUE, view.ptr());
-	glUniformMatrix4fv(imageUIProgram->projLocation, 1, GL_TRUE, proj.ptr());
-	glUniformMatrix4fv(imageUIProgram->modelLocation, 1, GL_TRUE, modelMatrix.ptr());
-
-	glUniform2fv(imageUIProgram->offsetLocation, 1, textureOffset.ptr());
-	glUniform2fv(imageUIProgram->tilingLocation, 1, textureTiling.ptr());
-
-	glActiveTexture(GL_TEXTURE0);
-	glUniform1i(imageUIProgram->diffuseLocation, 0);
-	glUniform4fv(imageUIProgram->inputColorLocation, 1, GetMainColor().ptr());
+	// Fill images only show the bottom part of the quad and the texture
+	float fill = isFill ? fillVal : 1.0f;
+	float2 minPosition = float2(-0.5f, -0.5f);
+	float2 maxPosition = float2(0.5f, -0.5f + fill);
+	float2 minUV = textureOffset;
+	float2 maxUV = float2(1.0f, fill).Mul(textureTiling) + textureOffset;
 
 	ResourceTexture* textureResource = App->resources->GetResource<ResourceTexture>(textureID);
 	if (textureResource != nullptr) {
-		glBindTexture(GL_TEXTURE_2D, textureResource->glTexture);
-		glUniform1i(imageUIProgram->hasDiffuseLocation, 1);
+		batch.AddQuad(modelMatrix, minPosition, maxPosition, minUV, maxUV, GetMainColor(), textureResource->glTexture, UIBatchMode::TEXTURE, !alphaTransparency);
 	} else {
-		glUniform1i(imageUIProgram->hasDiffuseLocation, 0);
+		batch.AddQuad(modelMatrix, minPosition, maxPosition, minUV, maxUV, GetMainColor(), 0, UIBatchMode::COLOR, !alphaTransparency);
 	}
-
-	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	glDisable(GL_BLEND);
 }
 
 void ComponentImage::SetColor(float4 color_) {
@@ -252,7 +209,6 @@ void ComponentImage::SetFillValue(float val) {
 		fillVal = 1.0f;
 	} else
 		fillVal = val;
-	RebuildFillQuadVBO();
 }
 
 void ComponentImage::SetIsFill(bool b) {
@@ -285,53 +241,4 @@ float2 ComponentImage::GetTextureTiling() const {
 
 void ComponentImage::SetTextureTiling(float2 tiling_) {
 	textureTiling = tiling_;
-}
-
-void ComponentImage::RebuildFillQuadVBO() {
-	float buffer_data[] = {
-		-0.5f,
-		-0.5f,
-		0.0f, //  v0 pos
-
-		0.5f,
-		-0.5f,
-		0.0f, // v1 pos
-
-		-0.5f,
-		-0.5f + fillVal,
-		0.0f, //  v2 pos
-
-		0.5f,
-		-0.5f,
-		0.0f, //  v3 pos
-
-		0.5f,
-		-0.5f + fillVal,
-		0.0f, // v4 pos
-
-		-0.5f,
-		-0.5f + fillVal,
-		0.0f, //  v5 pos
-
-		0.0f,
-		0.0f, //  v0 texcoord
-
-		1.0f,
-		0.0f, //  v1 texcoord
-
-		0.0f,
-		1.0f * fillVal, //  v2 texcoord
-
-		1.0f,
-		0.0f, //  v3 texcoord
-
-		1.0f,
-		1.0f * fillVal, //  v4 texcoord
-
-		0.0f,
-		1.0f * fillVal //  v5 texcoord
-	};
-
-	glBindBuffer(GL_ARRAY_BUFFER, fillQuadVBO); // set vbo active
-	glBufferData(GL_ARRAY_BUFFER, sizeof(buffer_data), buffer_data, GL_STATIC_DRAW);
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Math/float2.h"
 
 class ComponentTransform2D;
+class UIBatch;
 
 // Component that renders an Image on a Quad
 class ComponentImage : public Component {
@@ -20,7 +21,7 @@ public:
 	void Save(JsonValue jComponent) const override; // Serializes object
 	void Load(JsonValue jComponent) override;		// Deserializes object
 
-	void Draw(ComponentTransform2D* transform) const; // Draws the image ortographically using the active camera, and the transform passed as model. It will apply AlphaTransparency if true, and will get Button's additional color to apply if needed
+	void Draw(ComponentTransform2D* transform, UIBatch& batch) const; // Adds the quad of the image to the UI batch, using the transform passed as model. It will apply AlphaTransparency if true, and will get Button's additional color to apply if needed
 	TESSERACT_ENGINE_API void SetColor(float4 color_);
 	TESSERACT_ENGINE_API void SetFillValue(float val);
 	TESSERACT_ENGINE_API float4 GetColor() const;
@@ -36,16 +37,12 @@ public:
 	TESSERACT_ENGINE_API float2 GetTextureTiling() const;
 	TESSERACT_ENGINE_API void SetTextureTiling(float2 tiling_);
 
-private:
-	void RebuildFillQuadVBO();
-
 private:
 	float4 color = float4::one;		// Color used as default tainter
 	bool alphaTransparency = false; // Enables Alpha Transparency of the image and the color
 	bool isFill = false;			// Image rendered in function of fillVal
 	UID textureID = 0;				// ID of the image
 	float fillVal = 1.0f;			// Percent of image rendered (0 to 1)
-	unsigned int fillQuadVBO = 0;
 	float2 textureOffset = float2(0, 0);
 	float2 textureTiling = float2(1, 1);
 };
@@ -11,6 +11,7 @@
 #include "ComponentTransform2D.h"
 #include "Resources/ResourceTexture.h"
 #include "Resources/ResourceFont.h"
+#include "Rendering/UIBatch.h"
 #include "FileSystem/JsonValue.h"
 #include "Utils/ImGuiUtils.h"
 
@@ -30,23 +31,10 @@
 
 ComponentText::~ComponentText() {
 	App->resources->DecreaseReferenceCount(fontID);
-
-	glDeleteVertexArrays(1, &vao);
-	glDeleteBuffers(1, &vbo);
 }
 
 void ComponentText::Init() {
 	App->resources->IncreaseReferenceCount(fontID);
-
-	glGenVertexArrays(1, &vao);
-	glGenBuffers(1, &vbo);
-	glBindVertexArray(vao);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
 	Invalidate();
 }
 
@@ -131,63 +119,28 @@ void ComponentText::Load(JsonValue jComponent) {
 	color.Set(jColor[0], jColor[1], jColor[2], jColor[3]);
 }
 
-void ComponentText::Draw(ComponentTransform2D* transform) {
+void ComponentText::Draw(ComponentTransform2D* transform, UIBatch& batch) {
 	if (fontID == 0) {
 		return;
 	}
 
-	ProgramTextUI* textUIProgram = App->programs->textUI;
-	if (textUIProgram == nullptr) return;
-
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(vao);
+	RecalculateVertices();
 
-	glUseProgram(textUIProgram->program);
+	ResourceFont* font = App->resources->GetResource<ResourceFont>(fontID);
+	if (font == nullptr) return;
 
 	float4x4 model = transform->GetGlobalMatrix();
-	float4x4& proj = App->camera->GetProjectionMatrix();
-	float4x4& view = App->camera->GetViewMatrix();
-
-	if (App->userInterface->IsUsing2D()) {
-		proj = float4x4::D3DOrthoProjLH(-1, 1, App->renderer->GetViewportSize().x, App->renderer->GetViewportSize().y); //near plane. far plane, screen width, screen height
-		view = float4x4::identity;
-	}
 
 	ComponentCanvasRenderer* canvasRenderer = GetOwner().GetComponent<ComponentCanvasRenderer>();
 	if (canvasRenderer != nullptr) {
 		float factor = canvasRenderer->GetCanvasScreenFactor();
-		view = view * float4x4::Scale(factor, factor, factor);
+		model = float4x4::Scale(factor, factor, factor) * model;
 	}
 
-	glUniformMatrix4fv(textUIProgram->viewLocation, 1, GL_TRUE, view.ptr());
-	glUniformMatrix4fv(textUIProgram->projLocation, 1, GL_TRUE, proj.ptr());
-	glUniformMatrix4fv(textUIProgram->modelLocation, 1, GL_TRUE, model.ptr());
-	glUniform4fv(textUIProgram->textColorLocation, 1, color.ptr());
-
-	RecalculateVertices();
-
-	for (size_t i = 0; i < text.size(); ++i) {
-		if (text.at(i) != '\n') {
-			Character character = App->userInterface->GetCharacter(fontID, text.at(i));
-
-			// render glyph texture over quad
-			glBindTexture(GL_TEXTURE_2D, character.textureID);
-			// update content of VBO memory
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verticesText[i]), &verticesText[i].front());
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			// render quad
-			glDrawArrays(GL_TRIANGLES, 0, 6);
-		}
+	// All the glyphs are in the font atlas, so the whole text is merged into a single draw
+	for (const std::array<float, 8>& quad : verticesText) {
+		batch.AddQuad(model, float2(quad[0], quad[1]), float2(quad[2], quad[3]), float2(quad[4], quad[5]), float2(quad[6], quad[7]), color, font->atlasTexture, UIBatchMode::GLYPH, false);
 	}
-
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	glDisable(GL_BLEND);
 }
 
 void ComponentText::SetText(const std::string& newText) {
@@ -217,7 +170,14 @@ void ComponentText::RecalculateVertices() {
 		return;
 	}
 
-	verticesText.resize(text.size());
+	// Keep the vertices dirty until the font is loaded
+	ResourceFont* font = App->resources->GetResource<ResourceFont>(fontID);
+	if (font == nullptr) {
+		return;
+	}
+
+	verticesText.clear();
+	verticesText.reserve(text.size());
 
 	ComponentTransform2D* transform = GetOwner().GetComponent<ComponentTransform2D>();
 
@@ -227,8 +187,8 @@ void ComponentText::RecalculateVertices() {
 	float dy = 0; // additional y shifting
 	int j = 0;	  // index of row
 
-	// FontSize / size of imported font. 48 is due to FontImporter default PixelSize
-	float scale = (fontSize / 48);
+	// FontSize / size of imported font
+	float scale = (fontSize / FONT_PIXEL_SIZE);
 
 	for (size_t i = 0; i < text.size(); ++i) {
 		Character character = App->userInterface->GetCharacter(fontID, text.at(i));
@@ -258,23 +218,14 @@ void ComponentText::RecalculateVertices() {
 			dy += lineHeight;					// shifts to next line
 			x = -transform->GetSize().x * 0.5f; // reset to initial position
 			j = i + 1;							// updated j variable in order to get the substringwidth of the following line in the next iteration
+			continue;							// new lines have no quad
 		}
 
-		// clang-format off
-		verticesText[i] = {
-			xpos, ypos + h - dy, 0.0f, 0.0f,
-			xpos, ypos - dy, 0.0f, 1.0f,
-			xpos + w, ypos - dy, 1.0f, 1.0f,
-			xpos, ypos + h - dy, 0.0f, 0.0f,
-			xpos + w, ypos - dy, 1.0f, 1.0f,
-			xpos + w, ypos + h - dy, 1.0f, 0.0f
-		};
-		// clang-format on
+		// Bottom left and top right corners, with their UVs. The rows of the atlas go from top to bottom
+		verticesText.push_back({xpos, ypos - dy, xpos + w, ypos + h - dy, character.uvMin.x, character.uvMax.y, character.uvMax.x, character.uvMin.y});
 
 		// now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-		if (text.at(i) != '\n') {
-			x += ((character.advance >> 6) + letterSpacing) * scale; // bitshift by 6 to get value in pixels (2^6 = 64). Divides / 64
-		}
+		x += ((character.advance >> 6) + letterSpacing) * scale; // bitshift by 6 to get value in pixels (2^6 = 64). Divides / 64
 	}
 
 	dirty = false;
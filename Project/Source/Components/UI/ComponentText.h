@@ -9,6 +9,8 @@
 #include <array>
 #include <vector>
 
+class UIBatch;
+
 // Component that renders a Text, horizontally aligned based on the width of the component. The default value is Left alignment.
 class ComponentText : public Component {
 public:
@@ -16,13 +18,13 @@ public:
 
 	~ComponentText();
 
-	void Init() override;			// Generates VBO and VAO of ComponentText
+	void Init() override;			// Increases the reference count of the font
 	void OnEditorUpdate() override; // Works as input of Text, FontSize, Color and ShaderID and FontID
 
 	void Save(JsonValue jComponent) const override; // Serializes
 	void Load(JsonValue jComponent) override;		// Deserializes
 
-	void Draw(ComponentTransform2D* transform);				// Draws the text ortographically using the active camera and the position of the Tranform2D. It will apply the color as tint
+	void Draw(ComponentTransform2D* transform, UIBatch& batch);		// Adds the glyph quads to the UI batch, using the position of the Tranform2D. It will apply the color as tint
 	TESSERACT_ENGINE_API void SetText(const std::string& newText);	// Sets text
 	TESSERACT_ENGINE_API void SetFontSize(float newfontSize);		// Sets fontSize
 	TESSERACT_ENGINE_API void SetFontColor(const float4& newColor); // Sets color
@@ -41,8 +43,8 @@ private:
 		RIGHT
 	};
 
-	std::string text = "Text";									   // Text to display
-	std::vector<std::array<std::array<float, 4>, 6>> verticesText; // Vertices per each character
+	std::string text = "Text";						// Text to display
+	std::vector<std::array<float, 8>> verticesText; // Corners of each character quad: bottom left and top right positions, then their UVs. New lines have no quad
 
 	float fontSize = 24.0f;					 // Font size
 	float4 color = float4::one;				 // Color of the font
@@ -50,9 +52,7 @@ private:
 	float letterSpacing = 0.0f;				 // Space between letters
 	int textAlignment = TextAlignment::LEFT; // Horizontal Alignment
 
-	unsigned int vbo = 0; // VBO of the text
-	unsigned int vao = 0; // VAO of the text
-	UID fontID = 0;		  // Font ID of the text
+	UID fontID = 0; // Font ID of the text
 
 	bool dirty = true;
 };
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "BinaryJson.h"
+
+#include <string.h>
+
+#include "Utils/Leaks.h"
+
+enum class BinaryJsonTag : unsigned char {
+	NULL_VALUE,
+	FALSE_VALUE,
+	TRUE_VALUE,
+	INT,
+	UINT,
+	INT64,
+	UINT64,
+	FLOAT, // Doubles that can be stored as a float without losing precision
+	DOUBLE,
+	STRING,
+	ARRAY,
+	OBJECT
+};
+
+template<typename T>
+static void WriteData(std::vector<char>& data, T value) {
+	size_t size = data.size();
+	data.resize(size + sizeof(T));
+	memcpy(data.data() + size, &value, sizeof(T));
+}
+
+template<typename T>
+static bool ReadData(const char*& cursor, const char* end, T& value) {
+	if (end - cursor < (ptrdiff_t) sizeof(T)) return false;
+	memcpy(&value, cursor, sizeof(T));
+	cursor += sizeof(T);
+	return true;
+}
+
+unsigned BinaryJson::KeyTable::Add(const char* key) {
+	auto it = keyIndices.find(key);
+	if (it != keyIndices.end()) return it->second;
+
+	unsigned index = (unsigned) keys.size();
+	keys.push_back(key);
+	keyIndices.emplace(key, index);
+	return index;
+}
+
+void BinaryJson::Write(const rapidjson::Value& value, KeyTable& keyTable, std::vector<char>& data) {
+	switch (value.GetType()) {
+	case rapidjson::kNullType:
+		WriteData(data, BinaryJsonTag::NULL_VALUE);
+		break;
+	case rapidjson::kFalseType:
+		WriteData(data, BinaryJsonTag::FALSE_VALUE);
+		break;
+	case rapidjson::kTrueType:
+		WriteData(data, BinaryJsonTag::TRUE_VALUE);
+		break;
+	case rapidjson::kNumberType:
+		if (value.IsInt()) {
+			WriteData(data, BinaryJsonTag::INT);
+			WriteData(data, value.GetInt());
+		} else if (value.IsUint()) {
+			WriteData(data, BinaryJsonTag::UINT);
+			WriteData(data, value.GetUint());
+		} else if (value.IsInt64()) {
+			WriteData(data, BinaryJsonTag::INT64);
+			WriteData(data, value.GetInt64());
+		} else if (value.IsUint64()) {
+			WriteData(data, BinaryJsonTag::UINT64);
+			WriteData(data, value.GetUint64());
+		} else {
+			double number = value.GetDouble();
+			float floatNumber = (float) number;
+			if ((double) floatNumber == number) {
+				WriteData(data, BinaryJsonTag::FLOAT);
+				WriteData(data, floatNumber);
+			} else {
+				WriteData(data, BinaryJsonTag::DOUBLE);
+				WriteData(data, number);
+			}
+		}
+		break;
+	case rapidjson::kStringType: {
+		unsigned length = value.GetStringLength();
+		WriteData(data, BinaryJsonTag::STRING);
+		WriteData(data, length);
+		data.insert(data.end(), value.GetString(), value.GetString() + length);
+		break;
+	}
+	case rapidjson::kArrayType:
+		WriteData(data, BinaryJsonTag::ARRAY);
+		WriteData(data, (unsigned) value.Size());
+		for (rapidjson::Value::ConstValueIterator it = value.Begin(); it != value.End(); ++it) {
+			Write(*it, keyTable, data);
+		}
+		break;
+	case rapidjson::kObjectType:
+		WriteData(data, BinaryJsonTag::OBJECT);
+		WriteData(data, (unsigned) value.MemberCount());
+		for (rapidjson::Value::ConstMemberIterator it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+			WriteData(data, keyTable.Add(it->name.GetString()));
+			Write(it->value, keyTable, data);
+		}
+		break;
+	}
+}
+
+const char* BinaryJson::Read(const char* cursor, const char* end, const char* const* keys, unsigned numKeys, rapidjson::Value& value, rapidjson::Document::AllocatorType& allocator) {
+	BinaryJsonTag tag;
+	if (!ReadData(cursor, end, tag)) return nullptr;
+
+	switch (tag) {
+	case BinaryJsonTag::NULL_VALUE:
+		value.SetNull();
+		break;
+	case BinaryJsonTag::FALSE_VALUE:
+		value.SetBool(false);
+		break;
+	case BinaryJsonTag::TRUE_VALUE:
+		value.SetBool(true);
+		break;
+	case BinaryJsonTag::INT: {
+		int number;
+		if (!ReadData(cursor, end, number)) return nullptr;
+		value.SetInt(number);
+		break;
+	}
+	case BinaryJsonTag::UINT: {
+		unsigned number;
+		if (!ReadData(cursor, end, number)) return nullptr;
+		value.SetUint(number);
+		break;
+	}
+	case BinaryJsonTag::INT64: {
+		int64_t number;
+		if (!ReadData(cursor, end, number)) return nullptr;
+		value.SetInt64(number);
+		break;
+	}
+	case BinaryJsonTag::UINT64: {
+		uint64_t number;
+		if (!ReadData(cursor, end, number)) return nullptr;
+		value.SetUint64(number);
+		break;
+	}
+	case BinaryJsonTag::FLOAT: {
+		float number;
+		if (!ReadData(cursor, end, number)) return nullptr;
+		value.SetDouble(number);
+		break;
+	}
+	case BinaryJsonTag::DOUBLE: {
+		double number;
+		if (!ReadData(cursor, end, number)) return nullptr;
+		value.SetDouble(number);
+		break;
+	}
+	case BinaryJsonTag::STRING: {
+		unsigned length;
+		if (!ReadData(cursor, end, length)) return nullptr;
+		if ((size_t)(end - cursor) < length) return nullptr;
+		value.SetString(cursor, length, allocator);
+		cursor += length;
+		break;
+	}
+	case BinaryJsonTag::ARRAY: {
+		unsigned size;
+		if (!ReadData(cursor, end, size) || (size_t)(end - cursor) < size) return nullptr;
+		value.SetArray();
+		value.Reserve(size, allocator);
+		for (unsigned i = 0; i < size; ++i) {
+			rapidjson::Value element;
+			cursor = Read(cursor, end, keys, numKeys, element, allocator);
+			if (cursor == nullptr) return nullptr;
+			value.PushBack(element, allocator);
+		}
+		break;
+	}
+	case BinaryJsonTag::OBJECT: {
+		unsigned size;
+		if (!ReadData(cursor, end, size)) return nullptr;
+		value.SetObject();
+		for (unsigned i = 0; i < size; ++i) {
+			unsigned keyIndex;
+			if (!ReadData(cursor, end, keyIndex) || keyIndex >= numKeys) return nullptr;
+			rapidjson::Value member;
+			cursor = Read(cursor, end, keys, numKeys, member, allocator);
+			if (cursor == nullptr) return nullptr;
+			value.AddMember(rapidjson::StringRef(keys[keyIndex]), member, allocator);
+		}
+		break;
+	}
+	default:
+		return nullptr;
+	}
+
+	return cursor;
+}
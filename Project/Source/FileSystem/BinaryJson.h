@@ -0,0 +1,26 @@
+#pragma once
+
+#include "rapidjson/document.h"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+/* Compact binary encoding of JSON values, used to store component data in binary files.
+*  Numbers keep their exact JSON type, so values decoded from it behave like parsed ones when read through JsonValue.
+*  Object keys are written as indices into a key table that is shared by all the values of the same file section.
+*/
+
+namespace BinaryJson {
+	class KeyTable {
+	public:
+		unsigned Add(const char* key); // Returns the index of the key, adding it if it's not in the table yet
+
+	public:
+		std::vector<std::string> keys;
+		std::unordered_map<std::string, unsigned> keyIndices;
+	};
+
+	void Write(const rapidjson::Value& value, KeyTable& keyTable, std::vector<char>& data);
+	const char* Read(const char* cursor, const char* end, const char* const* keys, unsigned numKeys, rapidjson::Value& value, rapidjson::Document::AllocatorType& allocator); // Returns the position after the value, or nullptr if the data is invalid. Keys are referenced, not copied
+}; // namespace BinaryJson
@@ -0,0 +1,121 @@
+#include "ImportPipeline.h"
+
+#include "Globals.h"
+#include "Application.h"
+#include "Modules/ModuleResources.h"
+#include "Utils/FileDialog.h"
+
+#include "Utils/Leaks.h"
+
+ImportPipeline::~ImportPipeline() {
+	Stop();
+}
+
+void ImportPipeline::Start(unsigned numWorkers) {
+	Stop();
+
+	stopping = false;
+	for (unsigned i = 0; i < numWorkers; ++i) {
+		workers.emplace_back(&ImportPipeline::WorkerLoop, this);
+	}
+}
+
+void ImportPipeline::Stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	stageStarted.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+unsigned ImportPipeline::GetNumThreads() const {
+	return (unsigned) workers.size() + 1;
+}
+
+void ImportPipeline::Import(const std::vector<std::string>& filePaths, std::vector<std::list<UID>>& resourceIds, bool force, bool parallel, const ImportIsolation* isolation) {
+	std::lock_guard<std::mutex> batchLock(batchMutex);
+
+	resourceIds.clear();
+	resourceIds.resize(filePaths.size());
+
+	for (unsigned stage = 0; stage < IMPORT_STAGE_COUNT; ++stage) {
+		{
+			// Workers that woke up late may still be looking at the previous stage
+			std::unique_lock<std::mutex> lock(mutex);
+			stageFinished.wait(lock, [this] { return numRunningThreads == 0; });
+
+			stageJobs.clear();
+			for (unsigned i = 0; i < filePaths.size(); ++i) {
+				if (GetImportStage(filePaths[i].c_str()) == stage) {
+					stageJobs.push_back(i);
+				}
+			}
+			if (stageJobs.empty()) continue;
+
+			batchFilePaths = &filePaths;
+			batchResourceIds = &resourceIds;
+			stageForce = force;
+			batchIsolation = isolation;
+			nextJob = 0;
+			numRunningThreads = 1;
+			if (parallel) stageIndex += 1;
+		}
+		if (parallel) stageStarted.notify_all();
+
+		RunJobs();
+
+		std::unique_lock<std::mutex> lock(mutex);
+		numRunningThreads -= 1;
+		stageFinished.wait(lock, [this] { return numRunningThreads == 0; });
+	}
+
+	batchFilePaths = nullptr;
+	batchResourceIds = nullptr;
+	batchIsolation = nullptr;
+}
+
+unsigned ImportPipeline::GetImportStage(const char* filePath) {
+	std::string extension = FileDialog::GetFileExtension(filePath);
+	if (extension == MATERIAL_EXTENSION || extension == MODEL_EXTENSION) {
+		return 1;
+	} else if (extension == PREFAB_EXTENSION || extension == SCENE_EXTENSION || extension == ANIMATION_CLIP_EXTENSION || extension == STATE_MACHINE_EXTENSION) {
+		return 2;
+	} else {
+		return 0;
+	}
+}
+
+void ImportPipeline::WorkerLoop() {
+	unsigned lastStageIndex = 0;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		stageStarted.wait(lock, [&] { return stopping || stageIndex != lastStageIndex; });
+		if (stopping) return;
+
+		lastStageIndex = stageIndex;
+		numRunningThreads += 1;
+		lock.unlock();
+
+		RunJobs();
+
+		lock.lock();
+		numRunningThreads -= 1;
+		if (numRunningThreads == 0) stageFinished.notify_all();
+	}
+}
+
+void ImportPipeline::RunJobs() {
+	while (true) {
+		unsigned job = nextJob.fetch_add(1);
+		if (job >= stageJobs.size()) return;
+
+		unsigned index = stageJobs[job];
+		(*batchResourceIds)[index] = App->resources->ImportAssetResources((*batchFilePaths)[index].c_str(), stageForce, batchIsolation);
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Utils/UID.h"
+
+#include <string>
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#define IMPORT_STAGE_COUNT 3
+
+/* Imports can be isolated from the project: the assets under ASSETS_PATH are read from a copy, the resources
+*  are written to another library folder and the editor isn't told about them. Used by the import benchmark.
+*/
+struct ImportIsolation {
+	std::string assetsPath;	 // Replaces ASSETS_PATH in the paths of the imported assets
+	std::string libraryPath; // Replaces LIBRARY_PATH in the paths of the resources
+};
+
+/* Imports batches of assets with a pool of worker threads. Assets are imported in stages, so that the assets
+*  others depend on are imported first: textures, audio and the other leaf assets, then the materials and models
+*  (models import their textures too) and then the assets that only reference them (prefabs, scenes and animations).
+*  The assets of a stage are independent and are shared by the workers and the thread that calls Import.
+*/
+
+class ImportPipeline {
+public:
+	~ImportPipeline();
+
+	void Start(unsigned numWorkers);
+	void Stop();
+	unsigned GetNumThreads() const; // Workers and the thread that calls Import
+
+	// Blocks until all the assets are imported. resourceIds gets the resources of each asset, in the same order
+	void Import(const std::vector<std::string>& filePaths, std::vector<std::list<UID>>& resourceIds, bool force = false, bool parallel = true, const ImportIsolation* isolation = nullptr);
+
+	static unsigned GetImportStage(const char* filePath);
+
+private:
+	void WorkerLoop();
+	void RunJobs(); // Imports assets of the current stage until there are none left
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex batchMutex; // Only one batch is imported at a time
+
+	// Current stage. Written with mutex locked while no job is running
+	std::mutex mutex;
+	std::condition_variable stageStarted;
+	std::condition_variable stageFinished;
+	unsigned stageIndex = 0; // Increased for each stage, so that the workers know when there are new jobs
+	bool stopping = false;
+	bool stageForce = false;
+	const ImportIsolation* batchIsolation = nullptr;
+	const std::vector<std::string>* batchFilePaths = nullptr;
+	std::vector<std::list<UID>>* batchResourceIds = nullptr;
+	std::vector<unsigned> stageJobs; // Indices of the assets of the stage
+	std::atomic<unsigned> nextJob {0};
+	unsigned numRunningThreads = 0;
+};
@@ -7,6 +7,7 @@
 #include "Utils/Buffer.h"
 #include "Utils/MSTimer.h"
 #include "Utils/FileDialog.h"
+#include "Utils/VertexPacking.h"
 #include "FileSystem/PrefabImporter.h"
 #include "Components/ComponentTransform.h"
 #include "Components/ComponentBoundingBox.h"
@@ -22,6 +23,7 @@
 #include "Modules/ModuleFiles.h"
 #include "ImporterCommon.h"
 
+#include "Math/Quat.h"
 #include "assimp/mesh.h"
 #include "assimp/scene.h"
 #include "assimp/cimport.h"
@@ -41,35 +43,47 @@ static UID ImportMesh(const char* modelFilePath, JsonValue jMeta, const aiMesh*
 
 	unsigned numVertices = assimpMesh->mNumVertices;
 	unsigned numIndices = assimpMesh->mNumFaces * 3;
-	unsigned materialIndex = assimpMesh->mMaterialIndex;
 	unsigned numBones = assimpMesh->mNumBones;
+	if (numBones > MESH_MAX_BONES) {
+		LOG("Mesh has %u bones, but only %u are supported.", numBones, MESH_MAX_BONES);
+		return 0;
+	}
+
+	// Bone names are stored in a string table
+	std::vector<unsigned> boneNameOffsets(numBones);
+	unsigned stringTableSize = 0;
+	for (unsigned i = 0; i < numBones; ++i) {
+		boneNameOffsets[i] = stringTableSize;
+		stringTableSize += assimpMesh->mBones[i]->mName.length + 1;
+	}
+	stringTableSize = (stringTableSize + 3) & ~3u;
 
 	// Save to custom format buffer
-	unsigned positionSize = sizeof(float) * 3;
-	unsigned normalSize = sizeof(float) * 3;
-	unsigned tangentSize = sizeof(float) * 3;
-	unsigned uvSize = sizeof(float) * 2;
-	unsigned bonesIDSize = sizeof(unsigned) * 4;
-	unsigned weightsSize = sizeof(float) * 4;
-	unsigned indexSize = sizeof(unsigned);
-	unsigned boneSize = sizeof(unsigned) + sizeof(char) * FILENAME_MAX + sizeof(float) * 10;
-
-	unsigned headerSize = sizeof(unsigned) * 3;
-	unsigned vertexSize = positionSize + normalSize + tangentSize + uvSize + bonesIDSize + weightsSize;
-	unsigned vertexBufferSize = vertexSize * numVertices;
-	unsigned indexBufferSize = indexSize * numIndices;
-	unsigned bonesBufferSize = boneSize * numBones;
-
-	size_t size = headerSize + bonesBufferSize + vertexBufferSize + indexBufferSize;
+	unsigned indexSize = numVertices <= 0x10000 ? sizeof(unsigned short) : sizeof(unsigned);
+	unsigned headerSize = sizeof(ResourceMesh::FileHeader);
+	unsigned bonesBufferSize = sizeof(ResourceMesh::FileBone) * numBones;
+	unsigned staticVertexBufferSize = sizeof(ResourceMesh::StaticVertex) * numVertices;
+	unsigned skinnedVertexBufferSize = numBones > 0 ? sizeof(ResourceMesh::SkinnedVertex) * numVertices : 0;
+	unsigned indexBufferSize = (indexSize * numIndices + 3) & ~3u;
+
+	size_t size = headerSize + bonesBufferSize + stringTableSize + staticVertexBufferSize + skinnedVertexBufferSize + indexBufferSize;
 	Buffer<char> buffer = Buffer<char>(size);
-	char* cursor = buffer.Data();
-
-	*((unsigned*) cursor) = numVertices;
-	cursor += sizeof(unsigned);
-	*((unsigned*) cursor) = numIndices;
-	cursor += sizeof(unsigned);
-	*((unsigned*) cursor) = numBones;
-	cursor += sizeof(unsigned);
+	memset(buffer.Data(), 0, size);
+
+	ResourceMesh::FileHeader* header = (ResourceMesh::FileHeader*) buffer.Data();
+	header->magic = MESH_FORMAT_MAGIC;
+	header->version = MESH_FORMAT_VERSION;
+	header->numVertices = numVertices;
+	header->numIndices = numIndices;
+	header->numBones = numBones;
+	header->indexSize = indexSize;
+	header->stringTableSize = stringTableSize;
+
+	ResourceMesh::FileBone* fileBones = (ResourceMesh::FileBone*) (buffer.Data() + headerSize);
+	char* stringTable = buffer.Data() + headerSize + bonesBufferSize;
+	ResourceMesh::StaticVertex* staticVertices = (ResourceMesh::StaticVertex*) (stringTable + stringTableSize);
+	ResourceMesh::SkinnedVertex* skinnedVertices = (ResourceMesh::SkinnedVertex*) ((char*) staticVertices + staticVertexBufferSize);
+	char* indices = (char*) skinnedVertices + skinnedVertexBufferSize;
 
 	std::vector<ResourceMesh::Attach> attaches;
 	attaches.resize(numVertices);
@@ -78,42 +92,15 @@ static UID ImportMesh(const char* modelFilePath, JsonValue jMeta, const aiMesh*
 
 		bones.push_back(aiBone->mName.C_Str());
 
-		*((unsigned*) cursor) = aiBone->mName.length;
-		cursor += sizeof(unsigned);
-
-		memcpy_s(cursor, aiBone->mName.length * sizeof(char), aiBone->mName.data, aiBone->mName.length * sizeof(char));
-		cursor += FILENAME_MAX * sizeof(char);
+		memcpy_s(stringTable + boneNameOffsets[i], aiBone->mName.length * sizeof(char), aiBone->mName.data, aiBone->mName.length * sizeof(char));
+		fileBones[i].nameOffset = boneNameOffsets[i];
 
-		//Transform
+		// Transform
 		aiVector3D position, scaling;
 		aiQuaternion rotation;
 		aiBone->mOffsetMatrix.Decompose(scaling, rotation, position);
-
-		//Position
-		*((float*) cursor) = position.x;
-		cursor += sizeof(float);
-		*((float*) cursor) = position.y;
-		cursor += sizeof(float);
-		*((float*) cursor) = position.z;
-		cursor += sizeof(float);
-
-		// Scaling
-		*((float*) cursor) = scaling.x;
-		cursor += sizeof(float);
-		*((float*) cursor) = scaling.y;
-		cursor += sizeof(float);
-		*((float*) cursor) = scaling.z;
-		cursor += sizeof(float);
-
-		// Rotation
-		*((float*) cursor) = rotation.x;
-		cursor += sizeof(float);
-		*((float*) cursor) = rotation.y;
-		cursor += sizeof(float);
-		*((float*) cursor) = rotation.z;
-		cursor += sizeof(float);
-		*((float*) cursor) = rotation.w;
-		cursor += sizeof(float);
+		float4x4 transform = float4x4::FromTRS(float3(position.x, position.y, position.z), Quat(rotation.x, rotation.y, rotation.z, rotation.w), float3(scaling.x, scaling.y, scaling.z));
+		memcpy(fileBones[i].transform, transform.ptr(), sizeof(fileBones[i].transform));
 
 		for (unsigned j = 0; j < aiBone->mNumWeights; j++) {
 			aiVertexWeight vtxWeight = aiBone->mWeights[j];
@@ -127,86 +114,55 @@ static UID ImportMesh(const char* modelFilePath, JsonValue jMeta, const aiMesh*
 	for (unsigned i = 0; i < assimpMesh->mNumVertices; ++i) {
 		aiVector3D& vertex = assimpMesh->mVertices[i];
 		aiVector3D& normal = assimpMesh->mNormals[i];
-		aiVector3D& tangent = assimpMesh->mTangents[i];
 		aiVector3D* textureCoords = assimpMesh->mTextureCoords[0];
 
-		*((float*) cursor) = vertex.x;
-		cursor += sizeof(float);
-		*((float*) cursor) = vertex.y;
-		cursor += sizeof(float);
-		*((float*) cursor) = vertex.z;
-		cursor += sizeof(float);
-		*((float*) cursor) = normal.x;
-		cursor += sizeof(float);
-		*((float*) cursor) = normal.y;
-		cursor += sizeof(float);
-		*((float*) cursor) = normal.z;
-		cursor += sizeof(float);
+		ResourceMesh::StaticVertex& staticVertex = staticVertices[i];
+		staticVertex.position = float3(vertex.x, vertex.y, vertex.z);
+		staticVertex.normal = PackNormal(float3(normal.x, normal.y, normal.z));
 
 		// Check if Tangents exist
 		if ((aiVector3D*) assimpMesh->mTangents != nullptr) {
-			*((float*) cursor) = tangent.x;
-			cursor += sizeof(float);
-			*((float*) cursor) = tangent.y;
-			cursor += sizeof(float);
-			*((float*) cursor) = tangent.z;
-			cursor += sizeof(float);
-		} else {
-			*((float*) cursor) = 0;
-			cursor += sizeof(float);
-			*((float*) cursor) = 0;
-			cursor += sizeof(float);
-			*((float*) cursor) = 0;
-			cursor += sizeof(float);
+			aiVector3D& tangent = assimpMesh->mTangents[i];
+			staticVertex.tangent = PackNormal(float3(tangent.x, tangent.y, tangent.z));
 		}
-		*((float*) cursor) = textureCoords != nullptr ? textureCoords[i].x : 0;
-		cursor += sizeof(float);
-		*((float*) cursor) = textureCoords != nullptr ? textureCoords[i].y : 0;
-		cursor += sizeof(float);
+		staticVertex.uv[0] = FloatToHalf(textureCoords != nullptr ? textureCoords[i].x : 0);
+		staticVertex.uv[1] = FloatToHalf(textureCoords != nullptr ? textureCoords[i].y : 0);
 
-		float weight = attaches[i].weights[0] + attaches[i].weights[1] + attaches[i].weights[2] + attaches[i].weights[3];
+		if (numBones == 0) continue;
 
-		*((unsigned*) cursor) = attaches[i].bones[0];
-		cursor += sizeof(unsigned);
-		*((unsigned*) cursor) = attaches[i].bones[1];
-		cursor += sizeof(unsigned);
-		*((unsigned*) cursor) = attaches[i].bones[2];
-		cursor += sizeof(unsigned);
-		*((unsigned*) cursor) = attaches[i].bones[3];
-		cursor += sizeof(unsigned);
-
-		*((float*) cursor) = attaches[i].weights[0] / weight;
-		cursor += sizeof(float);
-		*((float*) cursor) = attaches[i].weights[1] / weight;
-		cursor += sizeof(float);
-		*((float*) cursor) = attaches[i].weights[2] / weight;
-		cursor += sizeof(float);
-		*((float*) cursor) = attaches[i].weights[3] / weight;
-		cursor += sizeof(float);
+		// Quantize the weights so that they still add up to 1. The rounding error goes to the biggest one
+		ResourceMesh::SkinnedVertex& skinnedVertex = skinnedVertices[i];
+		float weight = attaches[i].weights[0] + attaches[i].weights[1] + attaches[i].weights[2] + attaches[i].weights[3];
+		int weightsSum = 0;
+		unsigned biggestWeight = 0;
+		for (unsigned j = 0; j < 4; ++j) {
+			skinnedVertex.bones[j] = (unsigned char) attaches[i].bones[j];
+			skinnedVertex.weights[j] = weight > 0.0f ? (unsigned char) roundf(attaches[i].weights[j] / weight * 255.0f) : 0;
+			weightsSum += skinnedVertex.weights[j];
+			if (attaches[i].weights[j] > attaches[i].weights[biggestWeight]) biggestWeight = j;
+		}
+		if (weight > 0.0f) {
+			skinnedVertex.weights[biggestWeight] = (unsigned char) (skinnedVertex.weights[biggestWeight] + 255 - weightsSum);
+		}
 	}
 
 	for (unsigned i = 0; i < assimpMesh->mNumFaces; ++i) {
 		aiFace& assimpFace = assimpMesh->mFaces[i];
 
-		// Assume triangles have 3 indices per face
+		// Assume triangles have 3 indices per face. The rest are left as 0
 		if (assimpFace.mNumIndices != 3) {
 			LOG("Found a face with %i vertices. Discarded.", assimpFace.mNumIndices);
-
-			*((unsigned*) cursor) = 0;
-			cursor += sizeof(unsigned);
-			*((unsigned*) cursor) = 0;
-			cursor += sizeof(unsigned);
-			*((unsigned*) cursor) = 0;
-			cursor += sizeof(unsigned);
 			continue;
 		}
 
-		*((unsigned*) cursor) = assimpFace.mIndices[0];
-		cursor += sizeof(unsigned);
-		*((unsigned*) cursor) = assimpFace.mIndices[1];
-		cursor += sizeof(unsigned);
-		*((unsigned*) cursor) = assimpFace.mIndices[2];
-		cursor += sizeof(unsigned);
+		for (unsigned j = 0; j < 3; ++j) {
+			unsigned index = i * 3 + j;
+			if (indexSize == sizeof(unsigned short)) {
+				((unsigned short*) indices)[index] = (unsigned short) assimpFace.mIndices[j];
+			} else {
+				((unsigned*) indices)[index] = assimpFace.mIndices[j];
+			}
+		}
 	}
 
 	// Create mesh resource
@@ -402,8 +358,8 @@ static std::pair<UID, UID> ImportAnimation(const char* modelFilePath, JsonValue
 
 	// Create clip
 	std::unique_ptr<ResourceClip> clip = ImporterCommon::CreateResource<ResourceClip>(aiAnim->mName.C_Str(), modelFilePath, jMeta, resourceIndex);
-	clip->Init("clip" + std::to_string(animationIndex), animation->GetId(), 0, animation->keyFrames.size() - 1, true);
-	clip->frameRate = animation->duration / animation->keyFrames.size();
+	clip->Init("clip" + std::to_string(animationIndex), animation->GetId(), 0, animation->GetNumKeyFrames() - 1, true);
+	clip->frameRate = animation->duration / animation->GetNumKeyFrames();
 	// Save resource meta file
 	bool clipSaved = ImporterCommon::SaveResourceMetaFile(clip.get());
 	if (!clipSaved) {
@@ -534,7 +490,7 @@ bool ModelImporter::ImportModel(const char* filePath, JsonValue jMeta) {
 	// Check for extension support
 	std::string extension = FileDialog::GetFileExtension(filePath);
 	if (!aiIsExtensionSupported(extension.c_str())) {
-		LOG("Extension is not supported by assimp: \"%s\".", extension);
+		LOG("Extension is not supported by assimp: \"%s\".", extension.c_str());
 		return false;
 	}
 
@@ -549,6 +505,15 @@ bool ModelImporter::ImportModel(const char* filePath, JsonValue jMeta) {
 		return false;
 	}
 
+	// The bone indices of skinned vertices would be truncated
+	for (unsigned i = 0; i < assimpScene->mNumMeshes; ++i) {
+		const aiMesh* assimpMesh = assimpScene->mMeshes[i];
+		if (assimpMesh->mNumBones > MESH_MAX_BONES) {
+			LOG("Error importing scene: mesh \"%s\" has %u bones, but only %u are supported.", assimpMesh->mName.C_Str(), assimpMesh->mNumBones, MESH_MAX_BONES);
+			return false;
+		}
+	}
+
 	// Initialize resource accumulator
 	unsigned resourceIndex = 0;
 
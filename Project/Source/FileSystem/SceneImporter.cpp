@@ -4,17 +4,425 @@
 #include "GameObject.h"
 #include "Utils/FileDialog.h"
 #include "Utils/Logging.h"
+#include "Utils/MSTimer.h"
 #include "Modules/ModuleFiles.h"
+#include "Modules/ModuleScene.h"
 #include "Modules/ModuleTime.h"
 #include "Resources/ResourceScene.h"
+#include "Components/ComponentType.h"
 #include "ImporterCommon.h"
+#include "BinaryJson.h"
+#include "ModelImporter.h"
 #include "Scene.h"
 
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/error/en.h"
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
 
 #include "Utils/Leaks.h"
 
+#define JSON_TAG_ROOT "Root"
+#define JSON_TAG_QUADTREE_BOUNDS "QuadtreeBounds"
+#define JSON_TAG_QUADTREE_MAX_DEPTH "QuadtreeMaxDepth"
+#define JSON_TAG_QUADTREE_ELEMENTS_PER_NODE "QuadtreeElementsPerNode"
+#define JSON_TAG_GAME_CAMERA "GameCamera"
+#define JSON_TAG_AMBIENTLIGHT "AmbientLight"
+#define JSON_TAG_NAVMESH "NavMesh"
+#define JSON_TAG_CURSOR_WIDTH "CursorWidth"
+#define JSON_TAG_CURSOR_HEIGHT "CursorHeight"
+#define JSON_TAG_CURSOR "Cursor"
+#define JSON_TAG_NAME "Name"
+#define JSON_TAG_ACTIVE "Active"
+#define JSON_TAG_STATIC "Static"
+#define JSON_TAG_ACTIVEINHIERARCHY "ActiveHierarchy"
+#define JSON_TAG_ROOT_BONE_ID "RootBoneId"
+#define JSON_TAG_MASK "Mask"
+#define JSON_TAG_COMPONENTS "Components"
+#define JSON_TAG_CHILDREN "Children"
+
+// --- Reading JSON values with the same defaults as JsonValue --- //
+
+static const rapidjson::Value& GetMember(const rapidjson::Value& value, const char* key) {
+	static const rapidjson::Value nullValue;
+	if (!value.IsObject()) return nullValue;
+
+	rapidjson::Value::ConstMemberIterator it = value.FindMember(key);
+	return it != value.MemberEnd() ? it->value : nullValue;
+}
+
+static const rapidjson::Value& GetElement(const rapidjson::Value& value, unsigned index) {
+	static const rapidjson::Value nullValue;
+	return value.IsArray() && index < value.Size() ? value[index] : nullValue;
+}
+
+static bool GetBool(const rapidjson::Value& value) {
+	return value.IsBool() ? value.GetBool() : false;
+}
+
+static int GetInt(const rapidjson::Value& value) {
+	return value.IsInt() ? value.GetInt() : 0;
+}
+
+static unsigned GetUnsigned(const rapidjson::Value& value) {
+	return value.IsUint() ? value.GetUint() : 0;
+}
+
+static UID GetUID(const rapidjson::Value& value) {
+	return value.IsUint64() ? value.GetUint64() : 0;
+}
+
+static float GetFloat(const rapidjson::Value& value) {
+	return value.IsDouble() ? value.GetFloat() : 0;
+}
+
+static const char* GetString(const rapidjson::Value& value) {
+	return value.IsString() ? value.GetString() : "";
+}
+
+// --- Binary scene writing --- //
+
+class StringTable {
+public:
+	unsigned Add(const char* string) {
+		auto it = offsets.find(string);
+		if (it != offsets.end()) return it->second;
+
+		unsigned offset = (unsigned) data.size();
+		data.insert(data.end(), string, string + strlen(string) + 1);
+		offsets.emplace(string, offset);
+		return offset;
+	}
+
+public:
+	std::vector<char> data;
+	std::unordered_map<std::string, unsigned> offsets;
+};
+
+class ChunkWriter {
+public:
+	SceneImporter::FileChunk chunk;
+	std::vector<SceneImporter::FileComponent> components;
+	BinaryJson::KeyTable keyTable;
+	std::vector<char> data;
+};
+
+template<typename T>
+static void AppendData(std::vector<char>& data, const T* values, size_t count) {
+	const char* bytes = (const char*) values;
+	data.insert(data.end(), bytes, bytes + sizeof(T) * count);
+}
+
+static void AlignTo8(std::vector<char>& data) {
+	data.resize((data.size() + 7) & ~(size_t) 7, 0);
+}
+
+static size_t AlignTo8(size_t size) {
+	return (size + 7) & ~(size_t) 7;
+}
+
+static void WriteGameObject(const rapidjson::Value& jGameObject, unsigned parentIndex, StringTable& stringTable, std::vector<SceneImporter::FileGameObject>& gameObjects, std::vector<ChunkWriter>& chunks, std::unordered_map<std::string, unsigned>& chunkIndices) {
+	const rapidjson::Value& jComponents = GetMember(jGameObject, JSON_TAG_COMPONENTS);
+	unsigned numComponents = jComponents.IsArray() ? jComponents.Size() : 0;
+
+	unsigned index = (unsigned) gameObjects.size();
+	SceneImporter::FileGameObject& gameObject = gameObjects.emplace_back();
+	gameObject.id = GetUID(GetMember(jGameObject, JSON_TAG_ID));
+	gameObject.rootBoneId = GetUID(GetMember(jGameObject, JSON_TAG_ROOT_BONE_ID));
+	gameObject.parentIndex = parentIndex;
+	gameObject.nameOffset = stringTable.Add(GetString(GetMember(jGameObject, JSON_TAG_NAME)));
+	gameObject.numComponents = numComponents;
+	gameObject.mask = GetInt(GetMember(jGameObject, JSON_TAG_MASK));
+	gameObject.active = GetBool(GetMember(jGameObject, JSON_TAG_ACTIVE));
+	gameObject.isStatic = GetBool(GetMember(jGameObject, JSON_TAG_STATIC));
+	gameObject.activeInHierarchy = GetBool(GetMember(jGameObject, JSON_TAG_ACTIVEINHIERARCHY));
+
+	// Components are grouped by type. The whole JSON object is kept, as Component::Load receives it in the JSON path too
+	for (unsigned i = 0; i < numComponents; ++i) {
+		const rapidjson::Value& jComponent = jComponents[i];
+		const char* typeName = GetString(GetMember(jComponent, JSON_TAG_TYPE));
+
+		auto it = chunkIndices.find(typeName);
+		if (it == chunkIndices.end()) {
+			it = chunkIndices.emplace(typeName, (unsigned) chunks.size()).first;
+			ChunkWriter& newChunk = chunks.emplace_back();
+			newChunk.chunk.typeNameOffset = stringTable.Add(typeName);
+		}
+		ChunkWriter& chunk = chunks[it->second];
+
+		SceneImporter::FileComponent& component = chunk.components.emplace_back();
+		component.id = GetUID(GetMember(jComponent, JSON_TAG_ID));
+		component.ownerIndex = index;
+		component.slot = i;
+		component.active = GetBool(GetMember(jComponent, JSON_TAG_ACTIVE));
+		BinaryJson::Write(jComponent, chunk.keyTable, chunk.data);
+	}
+
+	const rapidjson::Value& jChildren = GetMember(jGameObject, JSON_TAG_CHILDREN);
+	if (jChildren.IsArray()) {
+		for (const rapidjson::Value* jChild = jChildren.Begin(); jChild != jChildren.End(); ++jChild) {
+			WriteGameObject(*jChild, index, stringTable, gameObjects, chunks, chunkIndices);
+		}
+	}
+}
+
+bool SceneImporter::WriteBinaryScene(const rapidjson::Value& jScene, std::vector<char>& data) {
+	const rapidjson::Value& jRoot = GetMember(jScene, JSON_TAG_ROOT);
+	if (!jRoot.IsObject()) return false;
+
+	FileHeader header;
+	const rapidjson::Value& jQuadtreeBounds = GetMember(jScene, JSON_TAG_QUADTREE_BOUNDS);
+	for (unsigned i = 0; i < 4; ++i) {
+		header.quadtreeBounds[i] = GetFloat(GetElement(jQuadtreeBounds, i));
+	}
+	header.quadtreeMaxDepth = GetUnsigned(GetMember(jScene, JSON_TAG_QUADTREE_MAX_DEPTH));
+	header.quadtreeElementsPerNode = GetUnsigned(GetMember(jScene, JSON_TAG_QUADTREE_ELEMENTS_PER_NODE));
+	header.gameCameraId = GetUID(GetMember(jScene, JSON_TAG_GAME_CAMERA));
+	const rapidjson::Value& jAmbientLight = GetMember(jScene, JSON_TAG_AMBIENTLIGHT);
+	for (unsigned i = 0; i < 3; ++i) {
+		header.ambientColor[i] = GetFloat(GetElement(jAmbientLight, i));
+	}
+	header.navMeshId = GetUID(GetMember(jScene, JSON_TAG_NAVMESH));
+	header.cursorHeight = GetInt(GetMember(jScene, JSON_TAG_CURSOR_HEIGHT));
+	header.cursorWidth = GetInt(GetMember(jScene, JSON_TAG_CURSOR_WIDTH));
+	header.cursorId = GetUID(GetMember(jScene, JSON_TAG_CURSOR));
+
+	StringTable stringTable;
+	std::vector<FileGameObject> gameObjects;
+	std::vector<ChunkWriter> chunks;
+	std::unordered_map<std::string, unsigned> chunkIndices;
+	WriteGameObject(jRoot, SCENE_INVALID_INDEX, stringTable, gameObjects, chunks, chunkIndices);
+
+	// Keys are added to the string table before it's written
+	std::vector<std::vector<unsigned>> keyOffsets(chunks.size());
+	for (unsigned i = 0; i < chunks.size(); ++i) {
+		for (const std::string& key : chunks[i].keyTable.keys) {
+			keyOffsets[i].push_back(stringTable.Add(key.c_str()));
+		}
+	}
+
+	header.numGameObjects = (unsigned) gameObjects.size();
+	header.numChunks = (unsigned) chunks.size();
+	header.stringTableSize = (unsigned) AlignTo8(stringTable.data.size());
+
+	data.clear();
+	AppendData(data, &header, 1);
+	AppendData(data, gameObjects.data(), gameObjects.size());
+	AlignTo8(data);
+	AppendData(data, stringTable.data.data(), stringTable.data.size());
+	AlignTo8(data);
+	for (unsigned i = 0; i < chunks.size(); ++i) {
+		ChunkWriter& chunk = chunks[i];
+		chunk.chunk.numComponents = (unsigned) chunk.components.size();
+		chunk.chunk.numKeys = (unsigned) keyOffsets[i].size();
+		chunk.chunk.dataSize = (unsigned) chunk.data.size();
+
+		AppendData(data, &chunk.chunk, 1);
+		AppendData(data, chunk.components.data(), chunk.components.size());
+		AppendData(data, keyOffsets[i].data(), keyOffsets[i].size());
+		AppendData(data, chunk.data.data(), chunk.data.size());
+		AlignTo8(data);
+	}
+
+	return true;
+}
+
+// --- Binary scene loading --- //
+
+struct ChunkReader {
+	ComponentType type = ComponentType::UNKNOWN;
+	const SceneImporter::FileChunk* chunk = nullptr;
+	const SceneImporter::FileComponent* components = nullptr;
+	const unsigned* keyOffsets = nullptr;
+	const char* data = nullptr;
+};
+
+static bool ReadChunks(const char* cursor, const char* end, const SceneImporter::FileHeader& header, const SceneImporter::FileGameObject* gameObjects, const char* stringTable, std::vector<ChunkReader>& chunks) {
+	chunks.resize(header.numChunks);
+	for (ChunkReader& reader : chunks) {
+		if ((size_t)(end - cursor) < sizeof(SceneImporter::FileChunk)) return false;
+		reader.chunk = (const SceneImporter::FileChunk*) cursor;
+		cursor += sizeof(SceneImporter::FileChunk);
+
+		const SceneImporter::FileChunk& chunk = *reader.chunk;
+		size_t chunkSize = sizeof(SceneImporter::FileComponent) * (size_t) chunk.numComponents + sizeof(unsigned) * (size_t) chunk.numKeys + chunk.dataSize;
+		if ((size_t)(end - cursor) < chunkSize || chunk.typeNameOffset >= header.stringTableSize) return false;
+
+		reader.type = GetComponentTypeFromName(stringTable + chunk.typeNameOffset);
+		reader.components = (const SceneImporter::FileComponent*) cursor;
+		reader.keyOffsets = (const unsigned*) (cursor + sizeof(SceneImporter::FileComponent) * chunk.numComponents);
+		reader.data = (const char*) (reader.keyOffsets + chunk.numKeys);
+		cursor += AlignTo8(chunkSize);
+
+		for (unsigned i = 0; i < chunk.numKeys; ++i) {
+			if (reader.keyOffsets[i] >= header.stringTableSize) return false;
+		}
+		for (unsigned i = 0; i < chunk.numComponents; ++i) {
+			const SceneImporter::FileComponent& component = reader.components[i];
+			if (component.ownerIndex >= header.numGameObjects || component.slot >= gameObjects[component.ownerIndex].numComponents) return false;
+		}
+	}
+	return true;
+}
+
+static Scene* LoadBinaryScene(const Buffer<char>& buffer) {
+	const char* data = buffer.Data();
+	const char* end = data + buffer.Size();
+	const SceneImporter::FileHeader& header = *(const SceneImporter::FileHeader*) data;
+	if (header.version != SCENE_FORMAT_VERSION) {
+		LOG("Unsupported scene format version %u.", header.version);
+		return nullptr;
+	}
+
+	// Validate every section before creating anything
+	const char* cursor = data + AlignTo8(sizeof(SceneImporter::FileHeader));
+	const SceneImporter::FileGameObject* fileGameObjects = (const SceneImporter::FileGameObject*) cursor;
+	size_t gameObjectsSize = AlignTo8(sizeof(SceneImporter::FileGameObject) * (size_t) header.numGameObjects);
+	if (header.numGameObjects == 0 || (size_t)(end - cursor) < gameObjectsSize) return nullptr;
+	cursor += gameObjectsSize;
+
+	const char* stringTable = cursor;
+	if (header.stringTableSize == 0 || (size_t)(end - cursor) < header.stringTableSize || stringTable[header.stringTableSize - 1] != '\0') return nullptr;
+	cursor += header.stringTableSize;
+
+	for (unsigned i = 0; i < header.numGameObjects; ++i) {
+		const SceneImporter::FileGameObject& fileGameObject = fileGameObjects[i];
+		bool validParent = i == 0 ? fileGameObject.parentIndex == SCENE_INVALID_INDEX : fileGameObject.parentIndex < i;
+		if (!validParent || fileGameObject.nameOffset >= header.stringTableSize) return nullptr;
+	}
+
+	std::vector<ChunkReader> chunks;
+	if (!ReadChunks(cursor, end, header, fileGameObjects, stringTable, chunks)) return nullptr;
+
+	// Size the pools from the chunk headers, leaving room for what is created at runtime. Types without a chunk only get the headroom
+	unsigned headroom = (unsigned) Max(App->scene->scenePoolHeadroom, 1);
+	Scene* scene = new Scene(headroom);
+	scene->gameObjects.Allocate(header.numGameObjects + headroom);
+	for (const ChunkReader& chunk : chunks) {
+		if (chunk.type == ComponentType::UNKNOWN) continue;
+		scene->AllocateComponentsByType(chunk.type, chunk.chunk->numComponents + headroom);
+	}
+
+	// GameObjects
+	std::vector<GameObject*> gameObjects(header.numGameObjects);
+	for (unsigned i = 0; i < header.numGameObjects; ++i) {
+		const SceneImporter::FileGameObject& fileGameObject = fileGameObjects[i];
+		GameObject* gameObject = scene->gameObjects.Obtain(fileGameObject.id);
+		if (gameObject == nullptr) {
+			// Only possible with repeated ids, as the pool has room for every GameObject in the file
+			LOG("GameObject %llu is repeated in the binary scene.", fileGameObject.id);
+			if (i > 0) scene->root = gameObjects[0]; // Everything created so far hangs from the root, so the scene can destroy it
+			delete scene;
+			return nullptr;
+		}
+
+		gameObject->scene = scene;
+		gameObject->LoadBinary(fileGameObject, stringTable + fileGameObject.nameOffset);
+		if (i > 0) gameObject->SetParent(gameObjects[fileGameObject.parentIndex]);
+		gameObject->components.resize(fileGameObject.numComponents, nullptr);
+		gameObjects[i] = gameObject;
+	}
+	scene->root = gameObjects[0];
+
+	// Components are all created before any of them is loaded, so that every GameObject is complete when they are
+	for (const ChunkReader& chunk : chunks) {
+		if (chunk.type == ComponentType::UNKNOWN) {
+			LOG("Unknown component type in binary scene: %s.", stringTable + chunk.chunk->typeNameOffset);
+			continue;
+		}
+
+		for (unsigned i = 0; i < chunk.chunk->numComponents; ++i) {
+			const SceneImporter::FileComponent& fileComponent = chunk.components[i];
+			GameObject* owner = gameObjects[fileComponent.ownerIndex];
+			Component* component = scene->CreateComponentByTypeAndId(owner, chunk.type, fileComponent.id);
+			if (component == nullptr) continue;
+
+			if (fileComponent.active) {
+				component->Enable();
+			} else {
+				component->Disable();
+			}
+			owner->components[fileComponent.slot] = component;
+		}
+	}
+
+	for (GameObject* gameObject : gameObjects) {
+		std::vector<Component*>& components = gameObject->components;
+		components.erase(std::remove(components.begin(), components.end(), nullptr), components.end());
+	}
+
+	// Component data
+	std::vector<const char*> keys;
+	for (const ChunkReader& chunk : chunks) {
+		if (chunk.type == ComponentType::UNKNOWN) continue;
+
+		keys.resize(chunk.chunk->numKeys);
+		for (unsigned i = 0; i < chunk.chunk->numKeys; ++i) {
+			keys[i] = stringTable + chunk.keyOffsets[i];
+		}
+
+		rapidjson::Document document;
+		document.SetArray();
+		document.Reserve(chunk.chunk->numComponents, document.GetAllocator());
+		const char* dataCursor = chunk.data;
+		const char* dataEnd = chunk.data + chunk.chunk->dataSize;
+		for (unsigned i = 0; i < chunk.chunk->numComponents; ++i) {
+			rapidjson::Value jValue;
+			dataCursor = BinaryJson::Read(dataCursor, dataEnd, keys.data(), chunk.chunk->numKeys, jValue, document.GetAllocator());
+			if (dataCursor == nullptr) {
+				LOG("Invalid component data in binary scene.");
+				break;
+			}
+			document.PushBack(jValue, document.GetAllocator());
+		}
+
+		for (unsigned i = 0; i < document.Size(); ++i) {
+			const SceneImporter::FileComponent& fileComponent = chunk.components[i];
+			GameObject* owner = gameObjects[fileComponent.ownerIndex];
+			Component* component = scene->GetComponentByTypeAndId(chunk.type, fileComponent.id);
+			if (component == nullptr) continue; // Not created above
+
+			JsonValue jComponent(document, document[i]);
+			component->Load(jComponent);
+
+			// Save in the Scene the GameObject with the directional light
+			if (chunk.type == ComponentType::LIGHT) {
+				ComponentLight* light = static_cast<ComponentLight*>(component);
+				if (light->lightType == LightType::DIRECTIONAL) {
+					scene->directionalLight = owner;
+				}
+			}
+		}
+	}
+
+	// Root bones
+	for (unsigned i = 0; i < header.numGameObjects; ++i) {
+		GameObject* rootBone = scene->GetGameObject(fileGameObjects[i].rootBoneId);
+		if (rootBone == nullptr) continue;
+
+		gameObjects[i]->SetRootBone(rootBone);
+		std::unordered_map<std::string, GameObject*> temporalBonesMap;
+		temporalBonesMap[rootBone->name] = rootBone;
+		ModelImporter::CacheBones(rootBone, temporalBonesMap);
+		ModelImporter::SaveBones(gameObjects[i], temporalBonesMap);
+	}
+
+	// Scene information
+	scene->quadtreeBounds = {{header.quadtreeBounds[0], header.quadtreeBounds[1]}, {header.quadtreeBounds[2], header.quadtreeBounds[3]}};
+	scene->quadtreeMaxDepth = header.quadtreeMaxDepth;
+	scene->quadtreeElementsPerNode = header.quadtreeElementsPerNode;
+	scene->RebuildQuadtree();
+	scene->gameCameraId = header.gameCameraId;
+	scene->ambientColor = {header.ambientColor[0], header.ambientColor[1], header.ambientColor[2]};
+	scene->navMeshId = header.navMeshId;
+	scene->heightCursor = header.cursorHeight;
+	scene->widthCursor = header.cursorWidth;
+	scene->cursorId = header.cursorId;
+
+	return scene;
+}
+
 bool SceneImporter::ImportScene(const char* filePath, JsonValue jMeta) {
 	// Timer to measure importing a scene
 	MSTimer timer;
@@ -36,10 +444,12 @@ bool SceneImporter::ImportScene(const char* filePath, JsonValue jMeta) {
 		return false;
 	}
 
-	// Write document to buffer
-	rapidjson::StringBuffer stringBuffer;
-	rapidjson::PrettyWriter<rapidjson::StringBuffer, rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag> writer(stringBuffer);
-	document.Accept(writer);
+	// Convert to the binary format
+	std::vector<char> data;
+	if (!WriteBinaryScene(document, data)) {
+		LOG("Error converting scene %s", filePath);
+		return false;
+	}
 
 	// Create scene resource
 	unsigned resourceIndex = 0;
@@ -53,7 +463,7 @@ bool SceneImporter::ImportScene(const char* filePath, JsonValue jMeta) {
 	}
 
 	// Save to file
-	saved = App->files->Save(scene->GetResourceFilePath().c_str(), stringBuffer.GetString(), stringBuffer.GetSize());
+	saved = App->files->Save(scene->GetResourceFilePath().c_str(), data.data(), data.size());
 	if (!saved) {
 		LOG("Failed to save state machine resource file.");
 		return false;
@@ -68,11 +478,29 @@ bool SceneImporter::ImportScene(const char* filePath, JsonValue jMeta) {
 }
 
 Scene* SceneImporter::LoadScene(const char* filePath) {
+	// Timer to measure loading a scene
+	MSTimer timer;
+	timer.Start();
+
 	// Read from file
 	Buffer<char> buffer = App->files->Load(filePath);
 
 	if (buffer.Size() == 0) return nullptr;
 
+	// Binary scene
+	if (buffer.Size() >= sizeof(FileHeader) && ((const FileHeader*) buffer.Data())->magic == SCENE_FORMAT_MAGIC) {
+		Scene* scene = LoadBinaryScene(buffer);
+		if (scene == nullptr) {
+			LOG("Invalid binary scene file: \"%s\".", filePath);
+			return nullptr;
+		}
+		scene->Init();
+
+		unsigned timeMs = timer.Stop();
+		LOG("Binary scene loaded in %ums", timeMs);
+		return scene;
+	}
+
 	// Parse document from file
 	rapidjson::Document document;
 	document.ParseInsitu<rapidjson::kParseNanAndInfFlag>(buffer.Data());
@@ -82,9 +510,12 @@ Scene* SceneImporter::LoadScene(const char* filePath) {
 	}
 	JsonValue jScene(document, document);
 
-	Scene* scene = new Scene(10000);
+	Scene* scene = new Scene(MAX_SCENE_COMPONENTS);
 	scene->Load(jScene);
 	scene->Init();
+
+	unsigned timeMs = timer.Stop();
+	LOG("Scene loaded in %ums", timeMs);
 	return scene;
 }
 
@@ -1,12 +1,70 @@
 #pragma once
 
 #include "FileSystem/JsonValue.h"
+#include "Utils/UID.h"
+
+#include <vector>
 
 class Scene;
 
+#define SCENE_FORMAT_MAGIC 0x4E435354 // "TSCN" in little-endian
+#define SCENE_FORMAT_VERSION 1
+#define SCENE_INVALID_INDEX ((unsigned) -1)
+
+/* Scenes are saved as JSON in the assets, and imported to a binary format that loads without parsing text.
+*  Binary layout: FileHeader, FileGameObject[numGameObjects] in hierarchy order (parents first), the string table,
+*  and one chunk per component type. A chunk is a FileChunk followed by FileComponent[numComponents], the offsets
+*  of its keys in the string table, and the component data encoded with BinaryJson. Every section is 8-byte aligned.
+*/
+
 namespace SceneImporter {
+	struct FileHeader {
+		unsigned magic = SCENE_FORMAT_MAGIC;
+		unsigned version = SCENE_FORMAT_VERSION;
+		unsigned numGameObjects = 0;
+		unsigned numChunks = 0;
+		unsigned stringTableSize = 0;
+		unsigned quadtreeMaxDepth = 0;
+		unsigned quadtreeElementsPerNode = 0;
+		int cursorWidth = 0;
+		int cursorHeight = 0;
+		float quadtreeBounds[4] = {0, 0, 0, 0};
+		float ambientColor[3] = {0, 0, 0};
+		UID gameCameraId = 0;
+		UID navMeshId = 0;
+		UID cursorId = 0;
+	};
+
+	struct FileGameObject {
+		UID id = 0;
+		UID rootBoneId = 0;
+		unsigned parentIndex = SCENE_INVALID_INDEX; // Index of the parent in the GameObject table. Always lower than the own index
+		unsigned nameOffset = 0;
+		unsigned numComponents = 0;
+		int mask = 0;
+		bool active = true;
+		bool isStatic = false;
+		bool activeInHierarchy = true;
+	};
+
+	struct FileChunk {
+		unsigned typeNameOffset = 0; // Component types are stored by name, so that the file doesn't depend on the ComponentType values
+		unsigned numComponents = 0;
+		unsigned numKeys = 0;
+		unsigned dataSize = 0;
+	};
+
+	struct FileComponent {
+		UID id = 0;
+		unsigned ownerIndex = 0;
+		unsigned slot = 0; // Position of the component in the components of its owner
+		bool active = true;
+	};
+
 	bool ImportScene(const char* filePath, JsonValue jMeta);
 
-	Scene* LoadScene(const char* filePath);
+	Scene* LoadScene(const char* filePath); // Loads both JSON and binary scenes
 	bool SaveScene(Scene* scene, const char* filePath);
-} // namespace SceneImporter
\ No newline at end of file
+
+	bool WriteBinaryScene(const rapidjson::Value& jScene, std::vector<char>& data); // Converts a JSON scene to the binary format
+} // namespace SceneImporter
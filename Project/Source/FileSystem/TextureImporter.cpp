@@ -18,6 +18,7 @@
 #include "IL/ilu.h"
 #include "GL/glew.h"
 #include "rapidjson/prettywriter.h"
+#include <mutex>
 
 #include "Utils/Leaks.h"
 
@@ -192,34 +193,64 @@ bool TextureImporter::ImportTexture(const char* filePath, JsonValue jMeta) {
 		return false;
 	}
 
-	// Generate image handler
-	unsigned image;
-	ilGenImages(1, &image);
-	DEFER {
-		ilDeleteImages(1, &image);
-	};
-
-	// Load image
-	ilBindImage(image);
-	bool imageLoaded = ilLoadImage(filePath);
-	if (!imageLoaded) {
-		LOG("Failed to load image.");
-		return false;
-	}
+	// DevIL keeps its state in globals, so only one thread can use it at a time.
+	// The image is decoded with it locked, and compressed after unlocking it so that other imports can continue
+	bool compressed = importOptions->compression == TextureCompression::DXT1 || importOptions->compression == TextureCompression::DXT3 || importOptions->compression == TextureCompression::DXT5 || importOptions->compression == TextureCompression::BC7;
+	Buffer<unsigned char> pixels;
+	Buffer<char> buffer;
+	int width = 0;
+	int height = 0;
+	{
+		std::lock_guard<std::mutex> lock(App->resources->imageLibraryMutex);
+
+		// Generate image handler
+		unsigned image;
+		ilGenImages(1, &image);
+		DEFER {
+			ilDeleteImages(1, &image);
+		};
 
-	int width = ilGetInteger(IL_IMAGE_WIDTH);
-	int height = ilGetInteger(IL_IMAGE_HEIGHT);
+		// Load image
+		ilBindImage(image);
+		bool imageLoaded = ilLoadImage(filePath);
+		if (!imageLoaded) {
+			LOG("Failed to load image.");
+			return false;
+		}
 
-	// Convert image
-	bool imageConverted = ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
-	if (!imageConverted) {
-		LOG("Failed to convert image.");
-		return false;
-	}
+		width = ilGetInteger(IL_IMAGE_WIDTH);
+		height = ilGetInteger(IL_IMAGE_HEIGHT);
+
+		// Convert image
+		bool imageConverted = ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
+		if (!imageConverted) {
+			LOG("Failed to convert image.");
+			return false;
+		}
 
-	// Flip if asked to
-	if (importOptions->flip) {
-		iluFlipImage();
+		// Flip if asked to
+		if (importOptions->flip) {
+			iluFlipImage();
+		}
+
+		if (compressed) {
+			iluFlipImage();
+
+			pixels.Allocate(width * height * 4);
+			memcpy(pixels.Data(), ilGetData(), pixels.Size());
+		} else {
+			unsigned size = ilSaveL(IL_TGA, nullptr, 0);
+			if (size == 0) {
+				LOG("Failed to save image.");
+				return false;
+			};
+			buffer.Allocate(size);
+			size = ilSaveL(IL_TGA, buffer.Data(), size);
+			if (size == 0) {
+				LOG("Failed to save image.");
+				return false;
+			}
+		}
 	}
 
 	// Create texture resource
@@ -242,15 +273,8 @@ bool TextureImporter::ImportTexture(const char* filePath, JsonValue jMeta) {
 	}
 
 	// Compress image
-	Buffer<char> buffer;
-	switch (importOptions->compression) {
-	case TextureCompression::DXT1:
-	case TextureCompression::DXT3: 
-	case TextureCompression::DXT5:
-	case TextureCompression::BC7: {
-		iluFlipImage();
-
-		Buffer<unsigned char> compressedData = CompressTexture(importOptions->compression, width, height, ilGetData());
+	if (compressed) {
+		Buffer<unsigned char> compressedData = CompressTexture(importOptions->compression, width, height, pixels.Data());
 
 		buffer.Allocate(sizeof(DDSHeader) + compressedData.Size());
 
@@ -284,22 +308,6 @@ bool TextureImporter::ImportTexture(const char* filePath, JsonValue jMeta) {
 		header->caps.caps1 = DDSHeader::Caps::TEXTURE;
 
 		memcpy(cursor, compressedData.Data(), compressedData.Size());
-		break;
-	}
-	default: {
-		unsigned size = ilSaveL(IL_TGA, nullptr, 0);
-		if (size == 0) {
-			LOG("Failed to save image.");
-			return false;
-		};
-		buffer.Allocate(size);
-		size = ilSaveL(IL_TGA, buffer.Data(), size);
-		if (size == 0) {
-			LOG("Failed to save image.");
-			return false;
-		}
-		break;
-	}
 	}
 
 	// Save to file
@@ -10,6 +10,7 @@
 #include "Components/UI/ComponentEventSystem.h"
 #include "Components/UI/ComponentSelectable.h"
 #include "FileSystem/ModelImporter.h"
+#include "FileSystem/SceneImporter.h"
 #include "Modules/ModuleInput.h"
 #include "Modules/ModuleScene.h"
 #include "Utils/Logging.h"
@@ -63,6 +64,18 @@ void GameObject::Update() {
 	}
 }
 
+void GameObject::FixedUpdate() {
+	if (IsActive()) {
+		for (Component* component : components) {
+			component->FixedUpdate();
+		}
+
+		for (GameObject* child : children) {
+			child->FixedUpdate();
+		}
+	}
+}
+
 void GameObject::DrawGizmos() {
 	for (Component* component : components) {
 		component->DrawGizmos();
@@ -147,6 +160,12 @@ void GameObject::SetParent(GameObject* gameObject) {
 	if (parentTransform2D != nullptr) {
 		parentTransform2D->InvalidateHierarchy();
 	}
+
+	// To move the transform under its new parent in the scene's transform hierarchy
+	ComponentTransform* transform = GetComponent<ComponentTransform>();
+	if (transform != nullptr) {
+		transform->UpdateParent();
+	}
 }
 
 GameObject* GameObject::GetParent() const {
@@ -161,6 +180,14 @@ GameObject* GameObject::GetRootBone() const {
 	return rootBoneHierarchy;
 }
 
+void GameObject::SetPrefabId(UID prefabId_) {
+	prefabId = prefabId_;
+}
+
+UID GameObject::GetPrefabId() const {
+	return prefabId;
+}
+
 void GameObject::AddMask(MaskType mask_) {
 	if ((mask.bitMask & static_cast<int>(mask_)) != 0) {
 		LOG("Mask already added");
@@ -319,6 +346,11 @@ void GameObject::Load(JsonValue jGameObject) {
 
 		ComponentType type = GetComponentTypeFromName(typeName.c_str());
 		Component* component = scene->CreateComponentByTypeAndId(this, type, componentId);
+		if (component == nullptr) {
+			LOG("Component %s of GameObject %s can't be created.", typeName.c_str(), name.c_str());
+			continue;
+		}
+
 		if (active) {
 			component->Enable();
 		} else {
@@ -342,6 +374,11 @@ void GameObject::Load(JsonValue jGameObject) {
 		std::string childName = jChild[JSON_TAG_NAME];
 
 		GameObject* child = scene->gameObjects.Obtain(0);
+		if (child == nullptr) {
+			LOG("The GameObject pool is full. The children of GameObject %s from %s on can't be loaded.", name.c_str(), childName.c_str());
+			break;
+		}
+
 		child->scene = scene;
 		child->SetParent(this);
 		child->Load(jChild);
@@ -358,6 +395,22 @@ void GameObject::Load(JsonValue jGameObject) {
 	}
 }
 
+void GameObject::LoadBinary(const SceneImporter::FileGameObject& fileGameObject, const char* name_) {
+	id = fileGameObject.id;
+	name = name_;
+	active = fileGameObject.active;
+	isStatic = fileGameObject.isStatic;
+	activeInHierarchy = fileGameObject.activeInHierarchy;
+	mask.bitMask = fileGameObject.mask;
+
+	for (unsigned i = 0; i < ARRAY_LENGTH(mask.maskNames); ++i) {
+		MaskType type = GetMaskTypeFromName(mask.maskNames[i]);
+		if ((mask.bitMask & static_cast<int>(type)) != 0) {
+			mask.maskValues[i] = true;
+		}
+	}
+}
+
 void GameObject::SavePrefab(JsonValue jGameObject) {
 	jGameObject[JSON_TAG_NAME] = name.c_str();
 	jGameObject[JSON_TAG_ACTIVE] = active;
@@ -405,6 +458,11 @@ void GameObject::LoadPrefab(JsonValue jGameObject) {
 
 		ComponentType type = GetComponentTypeFromName(typeName.c_str());
 		Component* component = scene->CreateComponentByTypeAndId(this, type, componentId);
+		if (component == nullptr) {
+			LOG("Component %s of GameObject %s can't be created.", typeName.c_str(), name.c_str());
+			continue;
+		}
+
 		components.push_back(component);
 		component->Load(jComponent);
 	}
@@ -416,6 +474,11 @@ void GameObject::LoadPrefab(JsonValue jGameObject) {
 
 		UID childId = GenerateUID();
 		GameObject* child = scene->gameObjects.Obtain(childId);
+		if (child == nullptr) {
+			LOG("The GameObject pool is full. The children of GameObject %s from %s on can't be loaded.", name.c_str(), childName.c_str());
+			break;
+		}
+
 		child->scene = scene;
 		child->id = childId;
 		child->SetParent(this);
@@ -425,6 +488,8 @@ void GameObject::LoadPrefab(JsonValue jGameObject) {
 	std::string rootBoneName = jGameObject[JSON_TAG_ROOT_BONE_NAME];
 	if (rootBoneName != "") {
 		rootBoneHierarchy = (rootBoneName == this->name) ? this : FindDescendant(rootBoneName);
+	}
+	if (rootBoneHierarchy != nullptr) {
 		// Recache bones to unordered map
 		std::unordered_map<std::string, GameObject*> temporalBonesMap;
 		temporalBonesMap[rootBoneHierarchy->name] = rootBoneHierarchy;
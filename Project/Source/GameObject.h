@@ -12,6 +12,10 @@
 
 class Component;
 
+namespace SceneImporter {
+	struct FileGameObject;
+}
+
 template<typename T>
 class ComponentView {
 public:
@@ -67,6 +71,7 @@ public:
 	void Init();
 	void Start();
 	void Update();
+	void FixedUpdate();
 	void DrawGizmos();
 
 	void Enable();
@@ -94,6 +99,9 @@ public:
 	void SetRootBone(GameObject* gameObject);
 	GameObject* GetRootBone() const;
 
+	void SetPrefabId(UID prefabId_); // Set on the root GameObject of prefab instances
+	UID GetPrefabId() const;
+
 	void AddMask(MaskType mask_);
 	void DeleteMask(MaskType mask_);
 	Mask& GetMask();
@@ -109,6 +117,7 @@ public:
 
 	void Save(JsonValue jGameObject) const;
 	void Load(JsonValue jGameObject);
+	void LoadBinary(const SceneImporter::FileGameObject& fileGameObject, const char* name_); // Loads the fields of a GameObject from a binary scene. Components, children and the root bone are set by SceneImporter
 
 	void SavePrefab(JsonValue jGameObject);
 	void LoadPrefab(JsonValue jGameObject);
@@ -143,6 +152,7 @@ template<class T>
 inline T* GameObject::CreateComponent() {
 	if (!T::allowMultipleComponents && HasComponent<T>()) return nullptr;
 	T* component = (T*) scene->CreateComponentByTypeAndId(this, T::staticType, GenerateUID());
+	if (component == nullptr) return nullptr;
 	components.push_back(component);
 	return component;
 }
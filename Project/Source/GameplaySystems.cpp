@@ -43,8 +43,16 @@ GameObject* GameplaySystems::GetGameObject(UID id) {
 }
 // --------- Instantiating --------- //
 GameObject* GameplaySystems::Instantiate(ResourcePrefab* prefab, float3 position, Quat rotation) {
-	UID prefabId = prefab->BuildPrefab(App->scene->scene->root);
-	GameObject* go = GameplaySystems::GetGameObject(prefabId);
+	GameObject* root = App->scene->scene->root;
+	GameObject* go = prefab->TakeFromPool(root);
+	if (go == nullptr) {
+		go = prefab->Instantiate(root);
+	}
+	if (go == nullptr) {
+		LOG("Prefab %s can't be instantiated: the pool of the prefab is empty and the scene has no room for another instance.", prefab->GetName().c_str());
+		return nullptr;
+	}
+
 	ComponentTransform* transform = go->GetComponent<ComponentTransform>();
 	transform->SetGlobalRotation(rotation);
 	transform->SetGlobalPosition(position);
@@ -109,13 +117,22 @@ void GameplaySystems::DestroyGameObject(GameObject* gameObject) {
 	App->scene->DestroyGameObjectDeferred(gameObject);
 }
 
+void GameplaySystems::Despawn(GameObject* gameObject) {
+	ResourcePrefab* prefab = App->resources->GetResource<ResourcePrefab>(gameObject->GetPrefabId());
+	if (prefab != nullptr && prefab->ReturnToPool(gameObject)) return;
+
+	App->scene->DestroyGameObjectDeferred(gameObject);
+}
+
 // ------------- DEBUG ------------- //
 
 void Debug::Log(const char* fmt, ...) {
+	char message[LOG_MESSAGE_SIZE];
 	va_list args;
 	va_start(args, fmt);
-	LOG(fmt, args);
+	vsnprintf(message, LOG_MESSAGE_SIZE, fmt, args);
 	va_end(args);
+	LOG_CATEGORY(LogCategory::SCRIPTING, LogSeverity::INFO, "%s", message);
 }
 
 void Debug::ToggleDebugMode() {
@@ -309,7 +326,7 @@ bool Input::IsGamepadConnected(int index) {
 void SceneManager::ChangeScene(UID sceneId) {
 	TesseractEvent e(TesseractEventType::CHANGE_SCENE);
 	e.Set<ChangeSceneStruct>(sceneId);
-	App->events->AddEvent(e);
+	App->events->AddEvent(std::move(e));
 }
 
 void SceneManager::ExitGame() {
@@ -319,34 +336,46 @@ void SceneManager::ExitGame() {
 }
 
 GameObject* Physics::Raycast(const float3& start, const float3& end, const int mask) {
-	LineSegment ray = LineSegment(start, end);
+	Scene* scene = App->scene->scene;
+	scene->UpdateRaycastTree();
 
+	float distance;
+	ComponentBoundingBox* closest = scene->raycastTree.RayNearest(start, end, [mask](ComponentBoundingBox* boundingBox) { return (boundingBox->GetOwner().GetMask().bitMask & mask) != 0; }, distance);
+
+	return closest != nullptr ? &closest->GetOwner() : nullptr;
+}
+
+void Physics::RaycastAll(const float3& start, const float3& end, const int mask, std::vector<GameObject*>& hits) {
+	Scene* scene = App->scene->scene;
+	scene->UpdateRaycastTree();
+
+	std::vector<BVH<ComponentBoundingBox>::Hit> treeHits;
+	scene->raycastTree.RayAll(start, end, [mask](ComponentBoundingBox* boundingBox) { return (boundingBox->GetOwner().GetMask().bitMask & mask) != 0; }, treeHits);
+
+	hits.reserve(hits.size() + treeHits.size());
+	for (const BVH<ComponentBoundingBox>::Hit& hit : treeHits) {
+		hits.push_back(&hit.object->GetOwner());
+	}
+}
+
+void Physics::RaycastBatch(const float3* starts, const float3* ends, unsigned count, const int mask, GameObject** hits) {
 	Scene* scene = App->scene->scene;
+	scene->UpdateRaycastTree();
 
-	GameObject* closestGo = nullptr;
-	float closestNear = FLT_MAX;
-	float closestFar = FLT_MIN;
-
-	for (GameObject& go : scene->gameObjects) {
-		if ((go.GetMask().bitMask & mask) == 0) continue;
-		ComponentBoundingBox* componentBBox = go.GetComponent<ComponentBoundingBox>();
-		if (componentBBox == nullptr) continue;
-		const AABB& bbox = componentBBox->GetWorldAABB();
-
-		float dNear, dFar;
-
-		if (ray.Intersects(bbox, dNear, dFar)) {
-			if (closestGo == nullptr) {
-				closestGo = &go;
-			} else {
-				if (dNear < closestFar) {
-					closestGo = &go;
-				}
-			}
-		}
+	auto filter = [mask](ComponentBoundingBox* boundingBox) { return (boundingBox->GetOwner().GetMask().bitMask & mask) != 0; };
+	for (unsigned i = 0; i < count; ++i) {
+		float distance;
+		ComponentBoundingBox* closest = scene->raycastTree.RayNearest(starts[i], ends[i], filter, distance);
+		hits[i] = closest != nullptr ? &closest->GetOwner() : nullptr;
 	}
+}
+
+void Physics::OverlapBox(const float3& minPoint, const float3& maxPoint, const int mask, std::vector<GameObject*>& hits) {
+	Scene* scene = App->scene->scene;
 
-	return closestGo;
+	size_t first = hits.size();
+	scene->GetGameObjectsInAABB(AABB(minPoint, maxPoint), hits);
+	hits.erase(std::remove_if(hits.begin() + first, hits.end(), [mask](GameObject* gameObject) { return (gameObject->GetMask().bitMask & mask) == 0; }), hits.end());
 }
 
 void Physics::CreateRigidbody(Component* collider) {
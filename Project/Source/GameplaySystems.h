@@ -27,7 +27,7 @@ class ResourcePrefab;
 class ComponentEventSystem;
 
 namespace GameplaySystems {
-	TESSERACT_ENGINE_API GameObject* Instantiate(ResourcePrefab* prefab, float3 position, Quat rotation);
+	TESSERACT_ENGINE_API GameObject* Instantiate(ResourcePrefab* prefab, float3 position, Quat rotation); // Returns nullptr if the scene has no room for the instance
 	TESSERACT_ENGINE_API GameObject* GetGameObject(const char* name);
 	TESSERACT_ENGINE_API GameObject* GetGameObject(UID id);
 	template<typename T> TESSERACT_ENGINE_API T* GetResource(UID id);
@@ -35,6 +35,7 @@ namespace GameplaySystems {
 	template<typename T> TESSERACT_ENGINE_API void SetGlobalVariable(const char* name, const T& value);
 	TESSERACT_ENGINE_API void SetRenderCamera(ComponentCamera* camera);
 	TESSERACT_ENGINE_API void DestroyGameObject(GameObject* gameObject);
+	TESSERACT_ENGINE_API void Despawn(GameObject* gameObject); // Returns prefab instances to the pool of their prefab. Destroys the GameObject if it can't be pooled
 
 	template<class T>
 	TESSERACT_ENGINE_API T* GetScript(const GameObject* go, const char* className) {
@@ -508,7 +509,10 @@ namespace SceneManager {
 }; // namespace SceneManager
 
 namespace Physics {
-	TESSERACT_ENGINE_API GameObject* Raycast(const float3& start, const float3& end, const int mask);
+	TESSERACT_ENGINE_API GameObject* Raycast(const float3& start, const float3& end, const int mask);									   // Returns the closest GameObject with any of the 'mask' bits whose bounding box is crossed by the segment, or nullptr
+	TESSERACT_ENGINE_API void RaycastAll(const float3& start, const float3& end, const int mask, std::vector<GameObject*>& hits);		   // Appends every GameObject hit by the segment, sorted from closest to furthest
+	TESSERACT_ENGINE_API void RaycastBatch(const float3* starts, const float3* ends, unsigned count, const int mask, GameObject** hits); // Fills 'hits' with the closest GameObject hit by each of the 'count' segments
+	TESSERACT_ENGINE_API void OverlapBox(const float3& minPoint, const float3& maxPoint, const int mask, std::vector<GameObject*>& hits); // Appends every GameObject with any of the 'mask' bits whose bounding box intersects the box
 	TESSERACT_ENGINE_API void CreateRigidbody(Component* collider);
 	TESSERACT_ENGINE_API void UpdateRigidbody(Component* collider);
 	TESSERACT_ENGINE_API void RemoveRigidbody(Component* collider);
@@ -68,6 +68,7 @@ enum class UpdateStatus {
 // Configuration -----------
 #define GLSL_VERSION "#version 460"
 #define MAX_SCENE_COMPONENTS 10000
+#define SCENE_POOL_HEADROOM 1000 // Default free slots added to the pools of a binary scene, for the GameObjects and components created at runtime. See ModuleScene::scenePoolHeadroom
 #define MAX_LIGHTS 1000
 #define GRID_FRUSTUM_WORK_GROUP_SIZE 16
 #define LIGHT_TILE_SIZE 16
@@ -76,6 +77,7 @@ enum class UpdateStatus {
 
 // Threads
 #define TIME_BETWEEN_RESOURCE_UPDATES_MS 300
+#define TIME_BETWEEN_FULL_ASSET_SCANS_MS 60000 // Asset folder scans while its changes are being watched
 #define TIME_BETWEEN_AUTOSAVES_MS 300000 // 5 minutes
 
 // Delete helpers -----------
@@ -97,6 +97,7 @@ int main(int argc, char** argv) {
 	LOG("Bye :)\n");
 
 	RELEASE(App);
+	logger->UpdateLogString();
 	RELEASE(logger);
 
 #ifdef _DEBUG
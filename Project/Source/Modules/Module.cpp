@@ -19,6 +19,10 @@ UpdateStatus Module::PreUpdate() {
 	return UpdateStatus::CONTINUE;
 }
 
+UpdateStatus Module::FixedUpdate() {
+	return UpdateStatus::CONTINUE;
+}
+
 UpdateStatus Module::Update() {
 	return UpdateStatus::CONTINUE;
 }
@@ -12,6 +12,7 @@ public:
 	virtual bool Init();						  // Module initialisations performed before the Main Loop.
 	virtual bool Start();						  // Second phase of initialisation. Here will be included all the actions that depend on another module or library to be initalised.
 	virtual UpdateStatus PreUpdate();			  // First phase of the update loop. Actions performed before rendering the scene.
+	virtual UpdateStatus FixedUpdate();			  // Called after PreUpdate zero or more times per frame, once per fixed step of game time. Simulation that has to be deterministic goes here.
 	virtual UpdateStatus Update();				  // Second phase of the update loop. Actions performed to render the scene.
 	virtual UpdateStatus PostUpdate();			  // Third phase of the update loop. Actions performed after rendering the scene.
 	virtual bool CleanUp();						  // Called on quitting the application. Releases recursively all the memory allocated for each Module.
@@ -208,16 +208,15 @@ void ModuleCamera::CalculateFrustumNearestObject(float2 pos) {
 	Scene* scene = App->scene->scene;
 	for (GameObject& gameObject : scene->gameObjects) {
 		gameObject.flag = false;
-		if (gameObject.isInQuadtree) continue;
-
-		ComponentBoundingBox* boundingBox = gameObject.GetComponent<ComponentBoundingBox>();
-		if (boundingBox == nullptr) continue;
-
-		const AABB& gameObjectAABB = boundingBox->GetWorldAABB();
-		if (ray.Intersects(gameObjectAABB)) {
-			intersectingObjects.push_back(&gameObject);
-		}
 	}
+	scene->UpdateDynamicTree();
+	scene->dynamicTree.Query(
+		[&ray](const AABB& aabb) { return ray.Intersects(aabb); },
+		[&ray, &intersectingObjects](ComponentBoundingBox* boundingBox) {
+			if (ray.Intersects(boundingBox->GetWorldAABB())) {
+				intersectingObjects.push_back(&boundingBox->GetOwner());
+			}
+		});
 	if (scene->quadtree.IsOperative()) {
 		GetIntersectingAABBRecursive(scene->quadtree.root, scene->quadtree.bounds, ray, intersectingObjects);
 	}
@@ -230,7 +229,7 @@ void ModuleCamera::CalculateFrustumNearestObject(float2 pos) {
 			ResourceMesh* meshResource = App->resources->GetResource<ResourceMesh>(mesh.GetMesh());
 			if (meshResource == nullptr) continue;
 
-			const float4x4& model = gameObject->GetComponent<ComponentTransform>()->GetGlobalMatrix();
+			float4x4 model = gameObject->GetComponent<ComponentTransform>()->GetGlobalMatrix();
 			std::vector<Triangle> triangles = meshResource->ExtractTriangles(model);
 			for (Triangle& triangle : triangles) {
 				if (!ray.Intersects(triangle, &distance, NULL)) continue;
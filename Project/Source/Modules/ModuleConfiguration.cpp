@@ -10,6 +10,7 @@
 #include "Modules/ModuleAudio.h"
 #include "Modules/ModulePhysics.h"
 #include "Modules/ModuleRender.h"
+#include "Modules/ModuleJobs.h"
 
 #include "rapidjson/document.h"
 #include "rapidjson/prettywriter.h"
@@ -20,10 +21,16 @@
 #define JSON_TAG_NAME "Name"
 #define JSON_TAG_ORGANIZATION "Organization"
 #define JSON_TAG_START_SCENE_ID "StartSceneId"
+#define JSON_TAG_SCENE_POOL_HEADROOM "ScenePoolHeadroom"
 #define JSON_TAG_LIMIT_FRAMERATE "LimitFramerate"
 #define JSON_TAG_MAX_FPS "MaxFPS"
 #define JSON_TAG_VSYNC "VSync"
+#define JSON_TAG_FIXED_UPDATE_RATE "FixedUpdateRate"
+#define JSON_TAG_MAX_FIXED_STEPS_PER_FRAME "MaxFixedStepsPerFrame"
 #define JSON_TAG_GRAVITY "Gravity"
+#define JSON_TAG_ASYNC_PHYSICS_STEPPING "AsyncPhysicsStepping"
+#define JSON_TAG_JOB_WORKER_THREADS "JobWorkerThreads"
+#define JSON_TAG_IGNORED_COLLISION_EVENT_LAYERS "IgnoredCollisionEventLayers"
 #define JSON_TAG_SSAO_ACTIVE "SSAOActive"
 #define JSON_TAG_SSAO_RANGE "SSAORange"
 #define JSON_TAG_SSAO_BIAS "SSAOBias"
@@ -92,12 +99,22 @@ void ModuleConfiguration::LoadConfiguration() {
 	std::strncpy(App->organization, organization.c_str(), sizeof(App->organization));
 
 	App->scene->startSceneId = jConfig[JSON_TAG_START_SCENE_ID];
+	int scenePoolHeadroom = jConfig[JSON_TAG_SCENE_POOL_HEADROOM];
+	if (scenePoolHeadroom > 0) App->scene->scenePoolHeadroom = scenePoolHeadroom;
 
 	App->time->limitFramerate = jConfig[JSON_TAG_LIMIT_FRAMERATE];
 	App->time->maxFps = jConfig[JSON_TAG_MAX_FPS];
 	App->time->vsync = jConfig[JSON_TAG_VSYNC];
+	int fixedUpdateRate = jConfig[JSON_TAG_FIXED_UPDATE_RATE];
+	if (fixedUpdateRate > 0) App->time->fixedUpdateRate = fixedUpdateRate;
+	int maxFixedStepsPerFrame = jConfig[JSON_TAG_MAX_FIXED_STEPS_PER_FRAME];
+	if (maxFixedStepsPerFrame > 0) App->time->maxFixedStepsPerFrame = maxFixedStepsPerFrame;
 
 	App->physics->gravity = jConfig[JSON_TAG_GRAVITY];
+	App->physics->asyncStepping = jConfig[JSON_TAG_ASYNC_PHYSICS_STEPPING];
+	App->physics->ignoredCollisionEventLayers = jConfig[JSON_TAG_IGNORED_COLLISION_EVENT_LAYERS];
+
+	App->jobs->workerThreads = jConfig[JSON_TAG_JOB_WORKER_THREADS];
 
 	App->renderer->ssaoActive = jConfig[JSON_TAG_SSAO_ACTIVE];
 	App->renderer->ssaoRange = jConfig[JSON_TAG_SSAO_RANGE];
@@ -197,12 +214,19 @@ void ModuleConfiguration::SaveConfiguration() {
 	jConfig[JSON_TAG_ORGANIZATION] = App->organization;
 
 	jConfig[JSON_TAG_START_SCENE_ID] = App->scene->startSceneId;
+	jConfig[JSON_TAG_SCENE_POOL_HEADROOM] = App->scene->scenePoolHeadroom;
 
 	jConfig[JSON_TAG_LIMIT_FRAMERATE] = App->time->limitFramerate;
 	jConfig[JSON_TAG_MAX_FPS] = App->time->maxFps;
 	jConfig[JSON_TAG_VSYNC] = App->time->vsync;
+	jConfig[JSON_TAG_FIXED_UPDATE_RATE] = App->time->fixedUpdateRate;
+	jConfig[JSON_TAG_MAX_FIXED_STEPS_PER_FRAME] = App->time->maxFixedStepsPerFrame;
 
 	jConfig[JSON_TAG_GRAVITY] = App->physics->gravity;
+	jConfig[JSON_TAG_ASYNC_PHYSICS_STEPPING] = App->physics->asyncStepping;
+	jConfig[JSON_TAG_IGNORED_COLLISION_EVENT_LAYERS] = App->physics->ignoredCollisionEventLayers;
+
+	jConfig[JSON_TAG_JOB_WORKER_THREADS] = App->jobs->workerThreads;
 
 	jConfig[JSON_TAG_SSAO_ACTIVE] = App->renderer->ssaoActive;
 	jConfig[JSON_TAG_SSAO_RANGE] = App->renderer->ssaoRange;
@@ -157,6 +157,7 @@ bool ModuleEditor::Start() {
 	panels.push_back(&panelGameControllerDebug);
 	panels.push_back(&panelImportOptions);
 	panels.push_back(&panelAudioMixer);
+	panels.push_back(&panelBenchmarks);
 
 	return true;
 }
@@ -230,6 +231,7 @@ UpdateStatus ModuleEditor::Update() {
 		ImGui::MenuItem(panelGameControllerDebug.name, "", &panelGameControllerDebug.enabled);
 		ImGui::MenuItem(panelImportOptions.name, "", &panelImportOptions.enabled);
 		ImGui::MenuItem(panelAudioMixer.name, "", &panelAudioMixer.enabled);
+		ImGui::MenuItem(panelBenchmarks.name, "", &panelBenchmarks.enabled);
 		ImGui::EndMenu();
 	}
 	if (ImGui::BeginMenu("Help")) {
@@ -505,12 +507,12 @@ bool ModuleEditor::CleanUp() {
 
 void ModuleEditor::OnMouseClicked() {
 	TesseractEvent mouseEvent = TesseractEvent(TesseractEventType::MOUSE_CLICKED);
-	App->events->AddEvent(mouseEvent);
+	App->events->AddEvent(std::move(mouseEvent));
 }
 
 void ModuleEditor::OnMouseReleased() {
 	TesseractEvent mouseEvent = TesseractEvent(TesseractEventType::MOUSE_RELEASED);
-	App->events->AddEvent(mouseEvent);
+	App->events->AddEvent(std::move(mouseEvent));
 }
 
 void ModuleEditor::HelpMarker(const char* text) {
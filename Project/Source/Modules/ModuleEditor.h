@@ -16,6 +16,7 @@
 #include "Panels/PanelDebug.h"
 #include "Panels/PanelImportOptions.h"
 #include "Panels/PanelAudioMixer.h"
+#include "Panels/PanelBenchmarks.h"
 #include "Utils/UID.h"
 
 #include "imgui.h"
@@ -74,6 +75,7 @@ public:
 	PanelDebug panelGameControllerDebug;
 	PanelImportOptions panelImportOptions;
 	PanelAudioMixer panelAudioMixer;
+	PanelBenchmarks panelBenchmarks;
 
 	GameObject* selectedGameObject = nullptr;							// Pointer to the GameObject that will be shown in the inspector.
 	std::string selectedFolder = "";									// Currently selected folder in the PanelProject.
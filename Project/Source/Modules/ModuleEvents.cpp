@@ -3,6 +3,9 @@
 #include "Utils/Logging.h"
 #include "Resources/Resource.h"
 #include "Utils/AssetCache.h"
+#include "Utils/PerformanceTimer.h"
+
+#include "Brofiler.h"
 
 #include "Utils/Leaks.h"
 
@@ -12,19 +15,40 @@ static void CleanUpEvent(TesseractEvent& e) {
 	case TesseractEventType::UPDATE_ASSET_CACHE:
 		RELEASE(e.Get<UpdateAssetCacheStruct>().assetCache);
 		break;
+	case TesseractEventType::UPDATE_ASSET_CACHE_DIFF:
+		RELEASE(e.Get<UpdateAssetCacheDiffStruct>().diff);
+		break;
 	}
 }
 
+ModuleEvents::ModuleEvents() {
+	// Modules are created on the main thread
+	mainThreadId = std::this_thread::get_id();
+}
+
 bool ModuleEvents::Init() {
+	createResourcePayloads.Allocate(EVENT_CREATE_RESOURCE_PAYLOAD_POOL_SIZE);
+
+	mainThreadEvents.reserve(EVENT_QUEUE_CAPACITY);
+	threadEvents.reserve(EVENT_QUEUE_CAPACITY);
+	dispatchedEvents.reserve(EVENT_QUEUE_CAPACITY);
+
 	return true;
 }
 
 UpdateStatus ModuleEvents::PreUpdate() {
+	// ModuleEvents is the first module, so a new frame starts here
+	eventsLastFrame = 0;
+	for (int i = 0; i < (int) TesseractEventType::COUNT; ++i) {
+		lastFrameStats[i] = frameStats[i];
+		eventsLastFrame += frameStats[i].numEvents;
+		frameStats[i] = EventTypeStats();
+	}
+
 	return UpdateStatus::CONTINUE;
 }
 
 UpdateStatus ModuleEvents::Update() {
-	ProcessEvents();
 	return UpdateStatus::CONTINUE;
 }
 
@@ -33,11 +57,23 @@ UpdateStatus ModuleEvents::PostUpdate() {
 }
 
 bool ModuleEvents::CleanUp() {
-	while (!eventQueue.empty()) {
-		TesseractEvent e(TesseractEventType::UNKNOWN);
-		eventQueue.try_pop(e);
+	for (TesseractEvent& e : mainThreadEvents) {
 		CleanUpEvent(e);
 	}
+	mainThreadEvents.clear();
+
+	std::lock_guard<std::mutex> lock(threadEventsMutex);
+	for (TesseractEvent& e : threadEvents) {
+		CleanUpEvent(e);
+	}
+	threadEvents.clear();
+	hasThreadEvents = false;
+
+	if (createResourcePayloads.GetOverflowCount() > 0) {
+		LOG("%u event payloads were allocated because the pool was full.", createResourcePayloads.GetOverflowCount());
+	}
+	createResourcePayloads.Deallocate();
+
 	return true;
 }
 
@@ -54,21 +90,74 @@ void ModuleEvents::RemoveObserverFromEvent(TesseractEventType type, Module* modu
 	}
 }
 
-void ModuleEvents::AddEvent(const TesseractEvent& newEvent) {
-	eventQueue.push(newEvent);
+void ModuleEvents::AddEvent(TesseractEvent&& newEvent) {
+	if (IsMainThread()) {
+		mainThreadEvents.push_back(std::move(newEvent));
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(threadEventsMutex);
+	threadEvents.push_back(std::move(newEvent));
+	hasThreadEvents = true;
 }
 
-void ModuleEvents::ProcessEvents() {
-	while (!eventQueue.empty()) {
-		TesseractEvent e(TesseractEventType::UNKNOWN);
-		eventQueue.try_pop(e);
-		ProcessEvent(e);
-		CleanUpEvent(e);
+void ModuleEvents::DispatchEvent(TesseractEvent& e) {
+	if (!IsMainThread()) {
+		AddEvent(std::move(e));
+		return;
+	}
+
+	ProcessEvent(e);
+	CleanUpEvent(e);
+}
+
+void ModuleEvents::FlushEvents() {
+	BROFILER_CATEGORY("ModuleEvents - FlushEvents", Profiler::Color::Orange)
+
+	bool threadEventsTaken = false;
+	while (true) {
+		// Events sent by the observers end up in the queues again, and are dispatched in the next iteration.
+		// Events from other threads are only taken once, so a thread that keeps sending them can't stall the frame
+		if (!mainThreadEvents.empty()) {
+			dispatchedEvents.swap(mainThreadEvents);
+		} else if (!threadEventsTaken && hasThreadEvents) {
+			std::lock_guard<std::mutex> lock(threadEventsMutex);
+			dispatchedEvents.swap(threadEvents);
+			hasThreadEvents = false;
+			threadEventsTaken = true;
+		} else {
+			break;
+		}
+
+		for (TesseractEvent& e : dispatchedEvents) {
+			ProcessEvent(e);
+			CleanUpEvent(e);
+		}
+		dispatchedEvents.clear();
 	}
 }
 
+const EventTypeStats& ModuleEvents::GetEventTypeStats(TesseractEventType type) const {
+	return lastFrameStats[(int) type];
+}
+
+unsigned ModuleEvents::GetEventsLastFrame() const {
+	return eventsLastFrame;
+}
+
+bool ModuleEvents::IsMainThread() const {
+	return std::this_thread::get_id() == mainThreadId;
+}
+
 void ModuleEvents::ProcessEvent(TesseractEvent& e) {
+	PerformanceTimer timer;
+	timer.Start();
+
 	for (Module* m : observerArray[(int) e.type]) {
 		m->ReceiveEvent(e);
 	}
+
+	EventTypeStats& stats = frameStats[(int) e.type];
+	stats.numEvents += 1;
+	stats.dispatchTimeMs += timer.Stop() / 1000.0f;
 }
@@ -2,13 +2,31 @@
 
 #include "TesseractEvent.h"
 #include "Modules/Module.h"
+#include "Utils/EventPayloadPool.h"
 
-#include <concurrent_queue.h>
 #include <vector>
-#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+#define EVENT_QUEUE_CAPACITY 256				 // Events reserved for each queue. The queues only grow past it during bursts
+#define EVENT_CREATE_RESOURCE_PAYLOAD_POOL_SIZE 1024 // Pending CREATE_RESOURCE events without allocations. Importing a project can exceed it
+
+/* Events sent from the main thread go to a plain vector, and events sent from other threads (resource imports)
+*  to a vector protected by a mutex. Both are dispatched at the flush points of the frame (Application::Update):
+*  after the PreUpdate, Update and PostUpdate of all the modules, so events sent in any phase are received in the same frame.
+*  DispatchEvent skips the queues and calls the observers immediately.
+*/
+
+struct EventTypeStats {
+	unsigned numEvents = 0;
+	float dispatchTimeMs = 0.0f;
+};
 
 class ModuleEvents : public Module {
 public:
+	ModuleEvents();
+
 	bool Init() override;
 	UpdateStatus PreUpdate() override;
 	UpdateStatus Update() override;
@@ -22,13 +40,34 @@ public:
 	void AddObserverToEvent(TesseractEventType type, Module* moduleToAdd);
 	void RemoveObserverFromEvent(TesseractEventType type, Module* moduletoRemove);
 
-	void AddEvent(const TesseractEvent& newEvent);
+	void AddEvent(TesseractEvent&& newEvent); // Can be called from any thread. The event is moved to a queue and dispatched at the next flush point
+	void DispatchEvent(TesseractEvent& e);	  // Calls the observers before returning. From other threads, it works like AddEvent and moves the event
+	void FlushEvents();						  // Dispatches the queued events, including the ones sent while dispatching
+
+	const EventTypeStats& GetEventTypeStats(TesseractEventType type) const; // Stats of the last frame
+	unsigned GetEventsLastFrame() const;
 
 private:
-	void ProcessEvents();
+	bool IsMainThread() const;
 	void ProcessEvent(TesseractEvent& e);
 
+public:
+	// Payloads of the events that don't fit in a TesseractEvent. One pool per payload type
+	EventPayloadPool<CreateResourcePayload> createResourcePayloads;
+
 private:
-	concurrency::concurrent_queue<TesseractEvent> eventQueue;
+	std::thread::id mainThreadId;
+
+	std::vector<TesseractEvent> mainThreadEvents; // Only accessed from the main thread, so it doesn't need a lock
+	std::vector<TesseractEvent> threadEvents;	  // Events sent from other threads
+	std::vector<TesseractEvent> dispatchedEvents; // Events being dispatched. Swapped with the queues to keep their memory
+	std::mutex threadEventsMutex;
+	std::atomic<bool> hasThreadEvents {false};
+
 	std::vector<Module*> observerArray[(int) TesseractEventType::COUNT];
+
+	// Instrumentation
+	EventTypeStats frameStats[(int) TesseractEventType::COUNT];
+	EventTypeStats lastFrameStats[(int) TesseractEventType::COUNT];
+	unsigned eventsLastFrame = 0;
 };
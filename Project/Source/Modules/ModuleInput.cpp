@@ -134,7 +134,7 @@ UpdateStatus ModuleInput::PreUpdate() {
 
 					TesseractEvent resizeEvent(TesseractEventType::SCREEN_RESIZED);
 					resizeEvent.Set<ViewportResizedStruct>(event.window.data1, event.window.data2);
-					App->events->AddEvent(resizeEvent);
+					App->events->AddEvent(std::move(resizeEvent));
 
 					break;
 				}
@@ -162,7 +162,7 @@ UpdateStatus ModuleInput::PreUpdate() {
 				App->editor->OnMouseClicked();
 #else
 				TesseractEvent e(TesseractEventType::MOUSE_CLICKED);
-				App->events->AddEvent(e);
+				App->events->AddEvent(std::move(e));
 #endif
 			}
 			break;
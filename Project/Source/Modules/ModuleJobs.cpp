@@ -0,0 +1,69 @@
+#include "ModuleJobs.h"
+
+#include "Globals.h"
+#include "Utils/Logging.h"
+
+#include <thread>
+
+#include "Utils/Leaks.h"
+
+bool ModuleJobs::Init() {
+	RestartWorkers();
+
+	return true;
+}
+
+UpdateStatus ModuleJobs::PreUpdate() {
+	unsigned long long executed = jobSystem.GetJobsExecuted();
+	unsigned long long stolen = jobSystem.GetJobsStolen();
+	jobsLastFrame = (unsigned) (executed - jobsExecuted);
+	jobsStolenLastFrame = (unsigned) (stolen - jobsStolen);
+	jobsExecuted = executed;
+	jobsStolen = stolen;
+
+	return UpdateStatus::CONTINUE;
+}
+
+bool ModuleJobs::CleanUp() {
+	jobSystem.Stop();
+
+	return true;
+}
+
+void ModuleJobs::Run(const char* name, JobFunction function, JobCounter* counter) {
+	jobSystem.Run(name, std::move(function), counter);
+}
+
+void ModuleJobs::ParallelFor(const char* name, unsigned count, unsigned batchSize, const ParallelForFunction& function) {
+	jobSystem.ParallelFor(name, count, batchSize, function);
+}
+
+void ModuleJobs::Wait(JobCounter& counter) {
+	jobSystem.Wait(counter);
+}
+
+void ModuleJobs::RestartWorkers() {
+	unsigned numWorkers = workerThreads;
+	if (workerThreads <= 0) {
+		unsigned numThreads = std::thread::hardware_concurrency();
+		numWorkers = numThreads > 1 ? numThreads - 1 : 0;
+	}
+
+	jobSystem.Start(numWorkers);
+	jobsExecuted = 0;
+	jobsStolen = 0;
+
+	LOG("Job system running on %u threads.", jobSystem.GetNumThreads());
+}
+
+unsigned ModuleJobs::GetNumThreads() const {
+	return jobSystem.GetNumThreads();
+}
+
+unsigned ModuleJobs::GetJobsLastFrame() const {
+	return jobsLastFrame;
+}
+
+unsigned ModuleJobs::GetJobsStolenLastFrame() const {
+	return jobsStolenLastFrame;
+}
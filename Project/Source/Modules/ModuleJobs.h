@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Modules/Module.h"
+#include "Utils/JobSystem.h"
+
+/* Engine-wide job system. The main thread runs jobs while it waits for them, so it only has to be idle when
+*  the frame has nothing else to do. Used by the stages of the frame that only touch their own data: the particle
+*  simulations (ModuleScene::Update) and the bounding box refresh and frustum culling (Scene::CullGameObjects).
+*/
+
+class ModuleJobs : public Module {
+public:
+	bool Init() override;
+	UpdateStatus PreUpdate() override;
+	bool CleanUp() override;
+
+	void Run(const char* name, JobFunction function, JobCounter* counter = nullptr);
+	void ParallelFor(const char* name, unsigned count, unsigned batchSize, const ParallelForFunction& function);
+	void Wait(JobCounter& counter);
+
+	void RestartWorkers(); // Applies 'workerThreads'. No job can be running
+	unsigned GetNumThreads() const;
+	unsigned GetJobsLastFrame() const;
+	unsigned GetJobsStolenLastFrame() const;
+
+public:
+	int workerThreads = 0; // 0 starts one worker for each hardware thread besides the main one
+
+private:
+	JobSystem jobSystem;
+
+	unsigned long long jobsExecuted = 0; // Totals at the start of the last frame
+	unsigned long long jobsStolen = 0;
+	unsigned jobsLastFrame = 0;
+	unsigned jobsStolenLastFrame = 0;
+};
@@ -8,6 +8,8 @@
 #include "Components/Physics/ComponentCapsuleCollider.h"
 #include "Components/Physics/ComponentBoxCollider.h"
 #include "Components/ComponentTransform.h"
+#include "Components/ComponentScript.h"
+#include "Scripting/Script.h"
 #include "Scene.h"
 #include "Utils/MotionState.h"
 #include "Utils/ParticleMotionState.h"
@@ -16,6 +18,34 @@
 
 #include "debugdraw.h"
 
+#include <algorithm>
+
+template<typename F>
+static void ForEachDynamicMotionState(btDiscreteDynamicsWorld* world, F function) {
+	btCollisionObjectArray& collisionObjects = world->getCollisionObjectArray();
+	for (int i = 0; i < collisionObjects.size(); ++i) {
+		btRigidBody* rigidBody = btRigidBody::upcast(collisionObjects[i]);
+		if (rigidBody == nullptr || rigidBody->isStaticOrKinematicObject()) continue;
+
+		// Only colliders are dynamic. Particles are kinematic and have their own motion state
+		MotionState* motionState = (MotionState*) rigidBody->getMotionState();
+		if (motionState != nullptr) function(motionState);
+	}
+}
+
+// Called by Bullet before each step, on the thread that steps the world
+static void PreTickCallback(btDynamicsWorld* world, btScalar timeStep) {
+	ForEachDynamicMotionState((btDiscreteDynamicsWorld*) world, [](MotionState* motionState) {
+		motionState->BeginFixedStep();
+	});
+}
+
+// Called by Bullet after each step, on the thread that steps the world
+static void PostTickCallback(btDynamicsWorld* world, btScalar timeStep) {
+	ContactCache* contactCache = (ContactCache*) world->getWorldUserInfo();
+	contactCache->Update(world->getDispatcher());
+}
+
 bool ModulePhysics::Init() {
 	LOG("Creating Physics environment using Bullet Physics.");
 
@@ -25,6 +55,10 @@ bool ModulePhysics::Init() {
 	constraintSolver = new btSequentialImpulseConstraintSolver();
 	world = new btDiscreteDynamicsWorld(dispatcher, broadPhase, constraintSolver, collisionConfiguration);
 	world->setGravity(btVector3(0.f, gravity, 0.f));
+	world->setInternalTickCallback(PreTickCallback, &contactCache, true);
+	world->setInternalTickCallback(PostTickCallback, &contactCache, false);
+
+	stepper.Start();
 
 	// BULLET DEBUG: Uncomment to activate it
 	/*debugDrawer = new DebugDrawer();
@@ -34,132 +68,65 @@ bool ModulePhysics::Init() {
 }
 
 UpdateStatus ModulePhysics::PreUpdate() {
-	for (btRigidBody* rigidBody : rigidBodiesToRemove) {
-		world->removeCollisionObject(rigidBody);
-		btCollisionShape* shape = rigidBody->getCollisionShape();
-		RELEASE(shape);
-		delete rigidBody;
+	collisionEventsLastFrame = 0;
+
+	// Results of the steps that ran on the worker during the last frame. The events of removed bodies are skipped by their null user pointer
+	if (asyncStepsInFlight) {
+		WaitForStep();
+		stepTime = stepper.GetLastStepTime();
+		waitTime = stepper.GetLastWaitTime();
+		asyncStepsInFlight = false;
+
+		ProcessContacts();
+	} else {
+		stepTime = 0;
+		waitTime = 0;
 	}
-	rigidBodiesToRemove.clear();
 
+	RemovePendingBodies();
+
+	return UpdateStatus::CONTINUE;
+}
+
+UpdateStatus ModulePhysics::FixedUpdate() {
 	if (App->time->HasGameStarted()) {
-		world->stepSimulation(App->time->GetDeltaTime(), 15);
-
-		int numManifolds = world->getDispatcher()->getNumManifolds();
-		for (int i = 0; i < numManifolds; i++) {
-			btPersistentManifold* contactManifold = world->getDispatcher()->getManifoldByIndexInternal(i);
-			btCollisionObject* obA = (btCollisionObject*) (contactManifold->getBody0());
-			btCollisionObject* obB = (btCollisionObject*) (contactManifold->getBody1());
-
-			int numContacts = contactManifold->getNumContacts();
-			if (numContacts > 0) {
-				Collider* bodyA = (Collider*) obA->getUserPointer();
-				Collider* bodyB = (Collider*) obB->getUserPointer();
-
-				if (bodyA && bodyB) {
-					float3 contactOnA = float3(contactManifold->getContactPoint(0).getPositionWorldOnA());
-					float3 contactOnB = float3(contactManifold->getContactPoint(0).getPositionWorldOnB());
-					float3 diff = contactOnB - contactOnA;
-
-					float3 collisionNormal = float3(contactManifold->getContactPoint(0).m_normalWorldOnB);
-
-					if (bodyA->tid == typeid(Component)) {
-						Component* pbodyA = (Component*) bodyA->collider;
-						switch (pbodyA->GetType()) {
-						case ComponentType::SPHERE_COLLIDER: {
-							ComponentSphereCollider* sphereCol = (ComponentSphereCollider*) pbodyA;
-
-							// Different casts whether it is a Component collider or a particle
-							if (bodyB->tid == typeid(Component)) {
-								Component* pbodyB = (Component*) bodyB->collider;
-								sphereCol->OnCollision(pbodyB->GetOwner(), collisionNormal, diff);
-							} else {
-								ComponentParticleSystem::Particle* pbodyB = (ComponentParticleSystem::Particle*) bodyB->collider;
-								sphereCol->OnCollision(pbodyB->emitter->GetOwner(), collisionNormal, diff, pbodyB);
-							}
-							break;
-						}
-						case ComponentType::BOX_COLLIDER: {
-							ComponentBoxCollider* boxCol = (ComponentBoxCollider*) pbodyA;
-
-							if (bodyB->tid == typeid(Component)) {
-								Component* pbodyB = (Component*) bodyB->collider;
-								boxCol->OnCollision(pbodyB->GetOwner(), collisionNormal, diff);
-							} else {
-								ComponentParticleSystem::Particle* pbodyB = (ComponentParticleSystem::Particle*) bodyB->collider;
-								boxCol->OnCollision(pbodyB->emitter->GetOwner(), collisionNormal, diff, pbodyB);
-							}
-
-							break;
-						}
-						case ComponentType::CAPSULE_COLLIDER: {
-							ComponentCapsuleCollider* capsuleCol = (ComponentCapsuleCollider*) pbodyA;
-
-							if (bodyB->tid == typeid(Component)) {
-								Component* pbodyB = (Component*) bodyB->collider;
-								capsuleCol->OnCollision(pbodyB->GetOwner(), collisionNormal, diff);
-							} else {
-								ComponentParticleSystem::Particle* pbodyB = (ComponentParticleSystem::Particle*) bodyB->collider;
-								capsuleCol->OnCollision(pbodyB->emitter->GetOwner(), collisionNormal, diff, pbodyB);
-							}
-							break;
-						}
-						default:
-							break;
-						}
-					}
-
-					if (bodyB->tid == typeid(Component)) {
-						Component* pbodyB = (Component*) bodyB->collider;
-						switch (pbodyB->GetType()) {
-						case ComponentType::SPHERE_COLLIDER: {
-							ComponentSphereCollider* sphereCol = (ComponentSphereCollider*) pbodyB;
-
-							if (bodyA->tid == typeid(Component)) {
-								Component* pbodyA = (Component*) bodyA->collider;
-								sphereCol->OnCollision(pbodyA->GetOwner(), -collisionNormal, -diff);
-							} else {
-								ComponentParticleSystem::Particle* pbodyA = (ComponentParticleSystem::Particle*) bodyA->collider;
-								sphereCol->OnCollision(pbodyA->emitter->GetOwner(), -collisionNormal, -diff, pbodyA);
-							}
-							break;
-						}
-						case ComponentType::BOX_COLLIDER: {
-							ComponentBoxCollider* boxCol = (ComponentBoxCollider*) pbodyB;
-
-							if (bodyA->tid == typeid(Component)) {
-								Component* pbodyA = (Component*) bodyA->collider;
-								boxCol->OnCollision(pbodyA->GetOwner(), -collisionNormal, -diff);
-							} else {
-								ComponentParticleSystem::Particle* pbodyA = (ComponentParticleSystem::Particle*) bodyA->collider;
-								boxCol->OnCollision(pbodyA->emitter->GetOwner(), -collisionNormal, -diff, pbodyA);
-							}
-							break;
-						}
-						case ComponentType::CAPSULE_COLLIDER: {
-							ComponentCapsuleCollider* capsuleCol = (ComponentCapsuleCollider*) pbodyB;
-
-							if (bodyA->tid == typeid(Component)) {
-								Component* pbodyA = (Component*) bodyA->collider;
-								capsuleCol->OnCollision(pbodyA->GetOwner(), -collisionNormal, -diff);
-							} else {
-								ComponentParticleSystem::Particle* pbodyA = (ComponentParticleSystem::Particle*) bodyA->collider;
-								capsuleCol->OnCollision(pbodyA->emitter->GetOwner(), -collisionNormal, -diff, pbodyA);
-							}
-							break;
-						}
-						default:
-							break;
-						}
-					}
-				}
-			}
+		// The steps of an asynchronous frame run on the worker, after the bodies are placed in Update
+		if (asyncStepping) {
+			pendingSteps += 1;
+			return UpdateStatus::CONTINUE;
 		}
+
+		// Bodies removed by the collision events of the previous step
+		RemovePendingBodies();
+
+		// No substeps: the world advances exactly one fixed step
+		stepTimer.Start();
+		world->stepSimulation(App->time->GetFixedDeltaTime(), 0);
+		stepTime += stepTimer.Stop();
+
+		ProcessContacts();
 	}
 	return UpdateStatus::CONTINUE;
 }
 
 UpdateStatus ModulePhysics::Update() {
+	if (App->time->HasGameStarted()) {
+		// Place the dynamic bodies between the last two fixed steps
+		float alpha = App->time->GetFixedStepAlpha();
+		ForEachDynamicMotionState(world, [alpha](MotionState* motionState) {
+			motionState->ApplyInterpolatedTransform(alpha);
+		});
+
+		// Start the steps of this frame, which run while the rest of the frame is updated and rendered
+		if (pendingSteps > 0) {
+			RemovePendingBodies();
+			CaptureKinematicTransforms();
+			stepper.StepAsync(world, pendingSteps, App->time->GetFixedDeltaTime());
+			asyncStepsInFlight = true;
+		}
+	}
+	pendingSteps = 0;
+
 	// BULLET DEBUG: Uncomment to activate it
 	/*if (debug == true) {
 		world->debugDrawWorld();
@@ -169,6 +136,9 @@ UpdateStatus ModulePhysics::Update() {
 }
 
 bool ModulePhysics::CleanUp() {
+	stepper.Stop();
+	RemovePendingBodies();
+	contactCache.Clear();
 	RELEASE(world);
 
 	/* BULLET DEBUG: Uncomment to activate it
@@ -183,6 +153,7 @@ bool ModulePhysics::CleanUp() {
 }
 
 void ModulePhysics::CreateSphereRigidbody(ComponentSphereCollider* sphereCollider) {
+	WaitForStep();
 	sphereCollider->motionState = MotionState(sphereCollider, sphereCollider->centerOffset, sphereCollider->freezeRotation);
 	sphereCollider->rigidBody = AddSphereBody(&sphereCollider->motionState, sphereCollider->radius, sphereCollider->colliderType == ColliderType::DYNAMIC ? sphereCollider->mass : 0);
 	sphereCollider->rigidBody->setUserPointer(&sphereCollider->col);
@@ -204,7 +175,11 @@ btRigidBody* ModulePhysics::AddSphereBody(MotionState* myMotionState, float radi
 }
 
 void ModulePhysics::RemoveSphereRigidbody(ComponentSphereCollider* sphereCollider) {
+	WaitForStep();
 	if (sphereCollider->rigidBody) {
+		// The body stays in the world until the next step, and its contacts may still be processed, but it can't point to the collider anymore
+		sphereCollider->rigidBody->setUserPointer(nullptr);
+		sphereCollider->rigidBody->setMotionState(nullptr);
 		rigidBodiesToRemove.push_back(sphereCollider->rigidBody);
 		sphereCollider->rigidBody = nullptr;
 	}
@@ -216,6 +191,7 @@ void ModulePhysics::UpdateSphereRigidbody(ComponentSphereCollider* sphereCollide
 }
 
 void ModulePhysics::CreateBoxRigidbody(ComponentBoxCollider* boxCollider) {
+	WaitForStep();
 	boxCollider->motionState = MotionState(boxCollider, boxCollider->centerOffset, boxCollider->freezeRotation);
 	boxCollider->rigidBody = AddBoxBody(&boxCollider->motionState, boxCollider->size / 2, boxCollider->colliderType == ColliderType::DYNAMIC ? boxCollider->mass : 0);
 	boxCollider->rigidBody->setUserPointer(&boxCollider->col);
@@ -237,7 +213,11 @@ btRigidBody* ModulePhysics::AddBoxBody(MotionState* myMotionState, float3 size,
 }
 
 void ModulePhysics::RemoveBoxRigidbody(ComponentBoxCollider* boxCollider) {
+	WaitForStep();
 	if (boxCollider->rigidBody) {
+		// The body stays in the world until the next step, and its contacts may still be processed, but it can't point to the collider anymore
+		boxCollider->rigidBody->setUserPointer(nullptr);
+		boxCollider->rigidBody->setMotionState(nullptr);
 		rigidBodiesToRemove.push_back(boxCollider->rigidBody);
 		boxCollider->rigidBody = nullptr;
 	}
@@ -249,6 +229,7 @@ void ModulePhysics::UpdateBoxRigidbody(ComponentBoxCollider* boxCollider) {
 }
 
 void ModulePhysics::CreateCapsuleRigidbody(ComponentCapsuleCollider* capsuleCollider) {
+	WaitForStep();
 	capsuleCollider->motionState = MotionState(capsuleCollider, capsuleCollider->centerOffset, capsuleCollider->freezeRotation);
 	capsuleCollider->rigidBody = AddCapsuleBody(&capsuleCollider->motionState, capsuleCollider->radius, capsuleCollider->height, capsuleCollider->capsuleType, capsuleCollider->colliderType == ColliderType::DYNAMIC ? capsuleCollider->mass : 0);
 	capsuleCollider->rigidBody->setUserPointer(&capsuleCollider->col);
@@ -282,7 +263,11 @@ btRigidBody* ModulePhysics::AddCapsuleBody(MotionState* myMotionState, float rad
 }
 
 void ModulePhysics::RemoveCapsuleRigidbody(ComponentCapsuleCollider* capsuleCollider) {
+	WaitForStep();
 	if (capsuleCollider->rigidBody) {
+		// The body stays in the world until the next step, and its contacts may still be processed, but it can't point to the collider anymore
+		capsuleCollider->rigidBody->setUserPointer(nullptr);
+		capsuleCollider->rigidBody->setMotionState(nullptr);
 		rigidBodiesToRemove.push_back(capsuleCollider->rigidBody);
 		capsuleCollider->rigidBody = nullptr;
 	}
@@ -344,6 +329,7 @@ void ModulePhysics::AddBodyToWorld(btRigidBody* rigidbody, ColliderType collider
 }
 
 void ModulePhysics::CreateParticleRigidbody(ComponentParticleSystem::Particle* currentParticle) {
+	WaitForStep();
 	currentParticle->motionState = new ParticleMotionState(currentParticle);
 
 	// Create rigidbody
@@ -356,7 +342,11 @@ void ModulePhysics::CreateParticleRigidbody(ComponentParticleSystem::Particle* c
 }
 
 void ModulePhysics::RemoveParticleRigidbody(ComponentParticleSystem::Particle* particle) {
+	WaitForStep();
 	if (particle->rigidBody) {
+		// The body stays in the world until the next step, but it can't point to the particle anymore
+		particle->rigidBody->setUserPointer(nullptr);
+		particle->rigidBody->setMotionState(nullptr);
 		rigidBodiesToRemove.push_back(particle->rigidBody);
 		particle->rigidBody = nullptr;
 		RELEASE(particle->motionState);
@@ -369,9 +359,162 @@ void ModulePhysics::UpdateParticleRigidbody(ComponentParticleSystem::Particle* p
 }
 
 void ModulePhysics::SetGravity(float newGravity) {
+	WaitForStep();
 	world->setGravity(btVector3(0.f, newGravity, 0.f));
 }
 
+void ModulePhysics::WaitForStep() {
+	stepper.Wait();
+}
+
+bool ModulePhysics::IsSteppingAsync() const {
+	return stepper.IsStepping();
+}
+
+unsigned long long ModulePhysics::GetStepTime() const {
+	return stepTime;
+}
+
+unsigned long long ModulePhysics::GetWaitTime() const {
+	return waitTime;
+}
+
+unsigned ModulePhysics::GetNumContactPairs() const {
+	return contactCache.GetNumPairs();
+}
+
+unsigned ModulePhysics::GetCollisionEventsLastFrame() const {
+	return collisionEventsLastFrame;
+}
+
+void ModulePhysics::CaptureKinematicTransforms() {
+	btCollisionObjectArray& collisionObjects = world->getCollisionObjectArray();
+	for (int i = 0; i < collisionObjects.size(); ++i) {
+		btRigidBody* rigidBody = btRigidBody::upcast(collisionObjects[i]);
+		if (rigidBody == nullptr || !rigidBody->isKinematicObject() || rigidBody->getMotionState() == nullptr) continue;
+
+		// Bullet computes the velocity of kinematic bodies from the transform they have when the step starts
+		btTransform transform;
+		rigidBody->getMotionState()->getWorldTransform(transform);
+		rigidBody->setWorldTransform(transform);
+	}
+}
+
+void ModulePhysics::RemovePendingBodies() {
+	if (rigidBodiesToRemove.empty()) return;
+
+	removedBodies.clear();
+	for (btRigidBody* rigidBody : rigidBodiesToRemove) {
+		removedBodies.push_back(rigidBody);
+	}
+	contactCache.RemoveBodies(removedBodies);
+
+	for (btRigidBody* rigidBody : rigidBodiesToRemove) {
+		world->removeCollisionObject(rigidBody);
+		btCollisionShape* shape = rigidBody->getCollisionShape();
+		RELEASE(shape);
+		delete rigidBody;
+	}
+	rigidBodiesToRemove.clear();
+}
+
+void ModulePhysics::ProcessContacts() {
+	// Each contact event is sent to both bodies, with the normal and the penetration seen from each of them
+	collisionEvents.clear();
+	for (const ContactEvent& contactEvent : contactCache.GetEvents()) {
+		if (contactEvent.bodyA->getUserPointer() == nullptr || contactEvent.bodyB->getUserPointer() == nullptr) continue;
+
+		if (ReceivesCollisionEvents(contactEvent.bodyA)) {
+			collisionEvents.push_back({contactEvent.type, contactEvent.bodyA, contactEvent.bodyB, contactEvent.normal, contactEvent.penetration});
+		}
+		if (ReceivesCollisionEvents(contactEvent.bodyB)) {
+			collisionEvents.push_back({contactEvent.type, contactEvent.bodyB, contactEvent.bodyA, -contactEvent.normal, -contactEvent.penetration});
+		}
+	}
+	contactCache.ClearEvents();
+
+	// Grouped by receiver, so that its scripts are looked up once per batch. Stable to keep the order of the steps
+	std::stable_sort(collisionEvents.begin(), collisionEvents.end(), [](const CollisionEvent& a, const CollisionEvent& b) {
+		return a.receiver < b.receiver;
+	});
+	collisionEventsLastFrame += (unsigned) collisionEvents.size();
+
+	unsigned firstEvent = 0;
+	while (firstEvent < collisionEvents.size()) {
+		unsigned lastEvent = firstEvent + 1;
+		while (lastEvent < collisionEvents.size() && collisionEvents[lastEvent].receiver == collisionEvents[firstEvent].receiver) {
+			lastEvent += 1;
+		}
+
+		SendCollisionEvents(firstEvent, lastEvent);
+		firstEvent = lastEvent;
+	}
+}
+
+bool ModulePhysics::ReceivesCollisionEvents(const btCollisionObject* body) const {
+	return (body->getBroadphaseHandle()->m_collisionFilterGroup & ignoredCollisionEventLayers) == 0;
+}
+
+void ModulePhysics::SendCollisionEvents(unsigned firstEvent, unsigned lastEvent) {
+	Collider* receiver = (Collider*) collisionEvents[firstEvent].receiver->getUserPointer();
+
+	// Particles only need to know that they hit something new, to start their collision sub-emitters
+	if (receiver->tid != typeid(Component)) {
+		ComponentParticleSystem::Particle* particle = (ComponentParticleSystem::Particle*) receiver->collider;
+		for (unsigned i = firstEvent; i < lastEvent; ++i) {
+			if (collisionEvents[i].type == ContactEventType::ENTER) {
+				particle->hasCollided = true;
+				break;
+			}
+		}
+		return;
+	}
+
+	Component* receiverComponent = (Component*) receiver->collider;
+	receiverScripts.clear();
+	for (ComponentScript& scriptComponent : receiverComponent->GetOwner().GetComponents<ComponentScript>()) {
+		Script* script = scriptComponent.GetScriptInstance();
+		if (script != nullptr) {
+			receiverScripts.push_back(script);
+		}
+	}
+	if (receiverScripts.empty()) return;
+
+	for (unsigned i = firstEvent; i < lastEvent; ++i) {
+		const CollisionEvent& collisionEvent = collisionEvents[i];
+
+		// The scripts may remove any of the two bodies while they handle the previous events
+		if (collisionEvent.receiver->getUserPointer() == nullptr) return;
+		Collider* other = (Collider*) collisionEvent.other->getUserPointer();
+		if (other == nullptr) continue;
+
+		// Different casts whether it is a Component collider or a particle
+		GameObject* collidedWith = nullptr;
+		ComponentParticleSystem::Particle* particle = nullptr;
+		if (other->tid == typeid(Component)) {
+			collidedWith = &((Component*) other->collider)->GetOwner();
+		} else {
+			particle = (ComponentParticleSystem::Particle*) other->collider;
+			collidedWith = &particle->emitter->GetOwner();
+		}
+
+		for (Script* script : receiverScripts) {
+			switch (collisionEvent.type) {
+			case ContactEventType::ENTER:
+				script->OnCollisionEnter(*collidedWith, collisionEvent.normal, collisionEvent.penetration, particle);
+				script->OnCollision(*collidedWith, collisionEvent.normal, collisionEvent.penetration, particle);
+				break;
+			case ContactEventType::STAY:
+				script->OnCollision(*collidedWith, collisionEvent.normal, collisionEvent.penetration, particle);
+				break;
+			case ContactEventType::EXIT:
+				script->OnCollisionExit(*collidedWith, particle);
+				break;
+			}
+		}
+	}
+}
+
 /*BULLET DEBUG: Uncomment to activate it. #include "debugdraw.h" in this file if using it.
 // =================== BULLET DEBUG CALLBACKS ==========================
 void DebugDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3& color) {
@@ -3,6 +3,9 @@
 
 #include "btBulletDynamicsCommon.h"
 #include "Components/ComponentParticleSystem.h"
+#include "Utils/PhysicsStepper.h"
+#include "Utils/PerformanceTimer.h"
+#include "Utils/ContactCache.h"
 
 // BULLET DEBUG: Uncomment to activate it
 //class DebugDrawer;
@@ -12,6 +15,7 @@ class ComponentSphereCollider;
 class ComponentBoxCollider;
 class ComponentCapsuleCollider;
 class btBroadphaseInterface;
+class Script;
 enum class CapsuleType;
 
 /* --- Collider Type ---
@@ -52,6 +56,7 @@ public:
 	// ------- Core Functions ------ //
 	bool Init() override;
 	UpdateStatus PreUpdate();
+	UpdateStatus FixedUpdate() override;
 	UpdateStatus Update();
 	bool CleanUp();
 
@@ -81,8 +86,36 @@ public:
 	// ----------- Setters --------- //
 	void SetGravity(float newGravity);
 
+	// ---- Asynchronous stepping ---- //
+	void WaitForStep();						// Must be called before modifying the world or a body outside ModulePhysics. Blocks until the steps on the worker finish
+	bool IsSteppingAsync() const;			// True while the world belongs to the worker
+	unsigned long long GetStepTime() const;	// Microseconds spent stepping the world in the last frame
+	unsigned long long GetWaitTime() const;	// Microseconds the main thread waited for the worker in the last frame
+
+	// ---- Collision events ---- //
+	unsigned GetNumContactPairs() const;
+	unsigned GetCollisionEventsLastFrame() const;
+
 public:
 	float gravity = -9.81f;
+	bool asyncStepping = false;			 // Steps the world on a worker thread while the rest of the frame is updated and rendered. The results are used in the next frame
+	int ignoredCollisionEventLayers = 0; // WorldLayers whose bodies don't receive collision events. Their contacts are still simulated
+
+private:
+	// A contact event as seen by one of its two bodies
+	struct CollisionEvent {
+		ContactEventType type;
+		const btCollisionObject* receiver;
+		const btCollisionObject* other;
+		float3 normal;
+		float3 penetration;
+	};
+
+	void CaptureKinematicTransforms();								   // Copies the transforms of the kinematic GameObjects to their bodies, so that the worker doesn't read them
+	void RemovePendingBodies();										   // Deletes the bodies removed since the last call. The world can't be stepping
+	void ProcessContacts();											   // Sends the contact events of the steps since the last call
+	bool ReceivesCollisionEvents(const btCollisionObject* body) const; // Filters the events by the layer of the receiver
+	void SendCollisionEvents(unsigned firstEvent, unsigned lastEvent); // Sends a run of events with the same receiver
 
 private:
 	// ----- Physics World Config ----- //
@@ -93,6 +126,19 @@ private:
 	btDiscreteDynamicsWorld* world = nullptr;
 
 	std::vector<btRigidBody*> rigidBodiesToRemove;
+	std::vector<const btCollisionObject*> removedBodies;
+
+	ContactCache contactCache;
+	std::vector<CollisionEvent> collisionEvents;
+	std::vector<Script*> receiverScripts;
+	unsigned collisionEventsLastFrame = 0;
+
+	PhysicsStepper stepper;
+	PerformanceTimer stepTimer;
+	unsigned pendingSteps = 0; // Fixed steps of this frame that will run on the worker
+	bool asyncStepsInFlight = false;
+	unsigned long long stepTime = 0;
+	unsigned long long waitTime = 0;
 
 	//BULLET DEBUG: Uncomment to activate it
 	//DebugDrawer* debugDrawer;
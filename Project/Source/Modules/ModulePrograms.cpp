@@ -7,15 +7,15 @@
 #include "Utils/Logging.h"
 #include "Utils/FileDialog.h"
 #include "Utils/StringBlocksParser.h"
+#include "Utils/Hash.h"
 
 #include "GL/glew.h"
 #include <string>
+#include <string.h>
 
 #include "Utils/Leaks.h"
 
-static unsigned CompileShader(unsigned type, const char* filePath, const char* snippets) {
-	LOG("Creating shader from snippets: \"%s\"...", snippets);
-
+static bool GetShaderSource(const char* filePath, const char* snippets, std::string& source) {
 	parsb_options options;
 	options.line_directives = false;
 	parsb_context* blocks = parsb_create_context(options);
@@ -33,12 +33,18 @@ static unsigned CompileShader(unsigned type, const char* filePath, const char* s
 	const char* shaderData = parsb_get_blocks(blocks, finalSnippet.c_str());
 	if (shaderData == nullptr) {
 		LOG("Error reading blocks %s from %s", finalSnippet.c_str(), filePath);
-		return 0;
+		return false;
 	}
 
+	source = shaderData;
+	return true;
+}
+
+static unsigned CompileShader(unsigned type, const std::string& source) {
 	unsigned shaderId = glCreateShader(type);
 	if (shaderId == 0) return 0;
 
+	const char* shaderData = source.c_str();
 	glShaderSource(shaderId, 1, &shaderData, 0);
 	glCompileShader(shaderId);
 
@@ -62,6 +68,29 @@ static unsigned CompileShader(unsigned type, const char* filePath, const char* s
 	return shaderId;
 }
 
+static bool LinkProgram(unsigned programId) {
+	LOG("Linking program...");
+	glLinkProgram(programId);
+	int res = GL_FALSE;
+	glGetProgramiv(programId, GL_LINK_STATUS, &res);
+	if (res == GL_FALSE) {
+		int len = 0;
+		glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &len);
+		if (len > 0) {
+			int written = 0;
+			Buffer<char> info = Buffer<char>(len);
+			glGetProgramInfoLog(programId, len, &written, info.Data());
+			LOG("Program Log Info: %s", info.Data());
+		}
+
+		LOG("Error linking program.");
+		return false;
+	}
+
+	LOG("Program linked.");
+	return true;
+}
+
 void ModulePrograms::LoadShaderBinFile() {
 	// Clean file on Start
 	Buffer<char> cleanBuffer;
@@ -88,6 +117,19 @@ void ModulePrograms::LoadShaders() {
 	LoadShaderBinFile();
 #endif
 
+	// Program binaries are only valid for the driver that created them
+	int numBinaryFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+	programBinariesSupported = numBinaryFormats > 0;
+	driverHash = HashString((const char*) glGetString(GL_VENDOR));
+	driverHash = HashString((const char*) glGetString(GL_RENDERER), driverHash);
+	driverHash = HashString((const char*) glGetString(GL_VERSION), driverHash);
+	if (programBinariesSupported && !App->files->IsDirectory(cachePath)) {
+		App->files->CreateFolder(cachePath);
+	}
+	cacheHits = 0;
+	cacheMisses = 0;
+
 	// SkyBox shaders
 	hdrToCubemap = new ProgramHDRToCubemap(CreateProgram(filePath, "vertCube", "fragFunctionIBL fragHDRToCubemap"));
 	irradiance = new ProgramIrradiance(CreateProgram(filePath, "vertCube", "fragFunctionIBL fragIrradianceMap"));
@@ -101,6 +143,7 @@ void ModulePrograms::LoadShaders() {
 
 	// Unlit Shader
 	unlit = new ProgramUnlit(CreateProgram(filePath, "vertUnlit", "gammaCorrection fragFunctionEmptyDissolve fragUnlit"));
+	unlitInstanced = new ProgramUnlit(CreateProgram(filePath, "vertInstanced vertUnlit", "gammaCorrection fragFunctionEmptyDissolve fragUnlit"));
 
 	// Volumetric Light Shader
 	volumetricLight = new ProgramVolumetricLight(CreateProgram(filePath, "vertVolumetricLight", "gammaCorrection fragVolumetricLight"));
@@ -113,6 +156,14 @@ void ModulePrograms::LoadShaders() {
 	specularNotNormal = new ProgramStandardSpecular(CreateProgram(filePath, "vertVarCommon vertMainCommon", "gammaCorrection varLights fragVarStandard fragVarLights fragVarSpecular fragFunctionLight fragMainSpecular"));
 	specularNormal = new ProgramStandardSpecular(CreateProgram(filePath, "vertVarCommon vertMainNormal", "gammaCorrection varLights fragVarStandard fragVarLights fragVarSpecular fragFunctionLight fragMainSpecular"));
 
+	// Instanced general shaders
+	phongNotNormalInstanced = new ProgramStandardPhong(CreateProgram(filePath, "vertInstanced vertVarCommon vertMainCommon", "gammaCorrection varLights fragVarStandard fragVarLights fragVarSpecular fragMainPhong"));
+	phongNormalInstanced = new ProgramStandardPhong(CreateProgram(filePath, "vertInstanced vertVarCommon vertMainNormal", "gammaCorrection varLights fragVarStandard fragVarLights fragVarSpecular fragMainPhong"));
+	standardNotNormalInstanced = new ProgramStandardMetallic(CreateProgram(filePath, "vertInstanced vertVarCommon vertMainCommon", "gammaCorrection varLights fragVarStandard fragVarLights fragVarMetallic fragFunctionLight fragFunctionEmptyDissolve fragMainMetallic"));
+	standardNormalInstanced = new ProgramStandardMetallic(CreateProgram(filePath, "vertInstanced vertVarCommon vertMainNormal", "gammaCorrection varLights fragVarStandard fragVarLights fragVarMetallic fragFunctionLight fragFunctionEmptyDissolve fragMainMetallic"));
+	specularNotNormalInstanced = new ProgramStandardSpecular(CreateProgram(filePath, "vertInstanced vertVarCommon vertMainCommon", "gammaCorrection varLights fragVarStandard fragVarLights fragVarSpecular fragFunctionLight fragMainSpecular"));
+	specularNormalInstanced = new ProgramStandardSpecular(CreateProgram(filePath, "vertInstanced vertVarCommon vertMainNormal", "gammaCorrection varLights fragVarStandard fragVarLights fragVarSpecular fragFunctionLight fragMainSpecular"));
+
 	// Dissolve shaders. Maybe another one for Normals
 	dissolveStandard = new ProgramStandardDissolve(CreateProgram(filePath, "vertVarCommon vertMainNormal", "gammaCorrection varLights fragVarStandard fragVarLights fragVarMetallic fragFunctionLight fragFunctionDissolveCommon fragFunctionDissolveFunction fragMainMetallic"));
 	dissolveUnlit = new ProgramUnlitDissolve(CreateProgram(filePath, "vertUnlit", "gammaCorrection fragFunctionDissolveCommon fragFunctionDissolveFunction fragUnlit"));
@@ -121,6 +172,7 @@ void ModulePrograms::LoadShaders() {
 	depthPrepass = new ProgramDepthPrepass(CreateProgram(filePath, "vertVarCommon vertMainCommon", "fragFunctionEmptyDissolveDepth fragDepthPrepass"));
 	depthPrepassConvertTextures = new ProgramDepthPrepassConvertTextures(CreateProgram(filePath, "vertScreen", "fragDepthPrepassConvertTextures"));
 	depthPrepassDissolve = new ProgramDepthPrepassDissolve(CreateProgram(filePath, "vertVarCommon vertMainCommon", "fragFunctionDissolveCommon fragFunctionDepthDissolve fragDepthPrepass"));
+	depthPrepassInstanced = new ProgramDepthPrepass(CreateProgram(filePath, "vertInstanced vertVarCommon vertMainCommon", "fragFunctionEmptyDissolveDepth fragDepthPrepass"));
 
 	// SSAO Shaders
 	ssao = new ProgramSSAO(CreateProgram(filePath, "vertScreen", "fragSSAO"));
@@ -137,10 +189,11 @@ void ModulePrograms::LoadShaders() {
 	heightFog = new ProgramHeightFog(CreateProgram(filePath, "vertScreen", "gammaCorrection fragHeightFog"));
 
 	// Shadow Shaders
-	shadowMap = CreateProgram(filePath, "vertDepthMap", "fragDepthMap");
+	shadowMap = new ProgramShadowMap(CreateProgram(filePath, "vertDepthMap", "fragDepthMap"));
+	shadowMapInstanced = new ProgramShadowMap(CreateProgram(filePath, "vertInstanced vertDepthMap", "fragDepthMap"));
 
 	//UI shaders
-	textUI = new ProgramTextUI(CreateProgram(filePath, "vertTextUI", "gammaCorrection fragTextUI"));
+	uiBatch = new ProgramUIBatch(CreateProgram(filePath, "vertUIBatch", "gammaCorrection fragUIBatch"));
 	imageUI = new ProgramImageUI(CreateProgram(filePath, "vertImageUI", "gammaCorrection fragImageUI"));
 
 	// Engine Shaders
@@ -149,10 +202,11 @@ void ModulePrograms::LoadShaders() {
 
 	// Particle Shaders
 	billboard = new ProgramBillboard(CreateProgram(filePath, "billboardVertex", "gammaCorrection billboardFragment"));
+	billboardInstanced = new ProgramBillboardInstanced(CreateProgram(filePath, "billboardVertexInstanced", "gammaCorrection billboardFragmentInstanced billboardFragment"));
 	trail = new ProgramTrail(CreateProgram(filePath, "trailVertex", "gammaCorrection trailFragment"));
 
 	unsigned timeMs = timer.Stop();
-	LOG("Shaders loaded in %ums", timeMs);
+	LOG("Shaders loaded in %ums (%u programs from the binary cache, %u compiled)", timeMs, cacheHits, cacheMisses);
 }
 
 void ModulePrograms::UnloadShaders() {
@@ -166,6 +220,7 @@ void ModulePrograms::UnloadShaders() {
 	RELEASE(lightCullingCompute);
 
 	RELEASE(unlit);
+	RELEASE(unlitInstanced);
 
 	RELEASE(volumetricLight);
 
@@ -176,9 +231,17 @@ void ModulePrograms::UnloadShaders() {
 	RELEASE(specularNormal);
 	RELEASE(specularNotNormal);
 
+	RELEASE(phongNormalInstanced);
+	RELEASE(phongNotNormalInstanced);
+	RELEASE(standardNormalInstanced);
+	RELEASE(standardNotNormalInstanced);
+	RELEASE(specularNormalInstanced);
+	RELEASE(specularNotNormalInstanced);
+
 	RELEASE(depthPrepass);
 	RELEASE(depthPrepassConvertTextures);
 	RELEASE(depthPrepassDissolve);
+	RELEASE(depthPrepassInstanced);
 
 	RELEASE(dissolveStandard);
 	RELEASE(dissolveUnlit);
@@ -194,53 +257,54 @@ void ModulePrograms::UnloadShaders() {
 
 	RELEASE(heightFog);
 
-	glDeleteProgram(shadowMap);
+	RELEASE(shadowMap);
+	RELEASE(shadowMapInstanced);
 
-	RELEASE(textUI);
+	RELEASE(uiBatch);
 	RELEASE(imageUI);
 
 	RELEASE(drawTexture);
 	RELEASE(drawLightTiles);
 
 	RELEASE(billboard);
+	RELEASE(billboardInstanced);
 	RELEASE(trail);
 }
 
 unsigned ModulePrograms::CreateProgram(const char* shaderFile, const char* vertexSnippets, const char* fragmentSnippets) {
 	LOG("Creating program...");
 
+	LOG("Creating shaders from snippets: \"%s\" and \"%s\"...", vertexSnippets, fragmentSnippets);
+	std::string vertexSource;
+	std::string fragmentSource;
+	GetShaderSource(shaderFile, vertexSnippets, vertexSource);
+	GetShaderSource(shaderFile, fragmentSnippets, fragmentSource);
+
+	// The entry of a program is replaced when its sources change
+	std::string cacheEntry = std::string(shaderFile) + "|" + vertexSnippets + "|" + fragmentSnippets;
+	unsigned long long sourceHash = HashString(fragmentSource, HashString(vertexSource));
+	unsigned programId = LoadProgramBinary(cacheEntry.c_str(), sourceHash);
+	if (programId != 0) return programId;
+	cacheMisses += 1;
+
 	// Compile the shaders and delete them at the end
 	LOG("Compiling shaders...");
-	unsigned vertexShader = CompileShader(GL_VERTEX_SHADER, shaderFile, vertexSnippets);
+	unsigned vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
 	DEFER {
 		glDeleteShader(vertexShader);
 	};
-	unsigned fragmentShader = CompileShader(GL_FRAGMENT_SHADER, shaderFile, fragmentSnippets);
+	unsigned fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
 	DEFER {
 		glDeleteShader(fragmentShader);
 	};
 
 	// Link the program
-	LOG("Linking program...");
-	unsigned programId = glCreateProgram();
+	programId = glCreateProgram();
 	glAttachShader(programId, vertexShader);
 	glAttachShader(programId, fragmentShader);
-	glLinkProgram(programId);
-	int res = GL_FALSE;
-	glGetProgramiv(programId, GL_LINK_STATUS, &res);
-	if (res == GL_FALSE) {
-		int len = 0;
-		glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &len);
-		if (len > 0) {
-			int written = 0;
-			Buffer<char> info = Buffer<char>(len);
-			glGetProgramInfoLog(programId, len, &written, info.Data());
-			LOG("Program Log Info: %s", info.Data());
-		}
-
-		LOG("Error linking program.");
-	} else {
-		LOG("Program linked.");
+	glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	if (LinkProgram(programId)) {
+		SaveProgramBinary(cacheEntry.c_str(), sourceHash, programId);
 	}
 
 	return programId;
@@ -249,38 +313,92 @@ unsigned ModulePrograms::CreateProgram(const char* shaderFile, const char* verte
 unsigned ModulePrograms::CreateComputeProgram(const char* shaderFile, const char* computeSnippets) {
 	LOG("Creating program...");
 
+	LOG("Creating shader from snippets: \"%s\"...", computeSnippets);
+	std::string computeSource;
+	GetShaderSource(shaderFile, computeSnippets, computeSource);
+
+	std::string cacheEntry = std::string(shaderFile) + "|" + computeSnippets;
+	unsigned long long sourceHash = HashString(computeSource);
+	unsigned programId = LoadProgramBinary(cacheEntry.c_str(), sourceHash);
+	if (programId != 0) return programId;
+	cacheMisses += 1;
+
 	// Compile the shaders and delete them at the end
 	LOG("Compiling shaders...");
-	unsigned computeShader = CompileShader(GL_COMPUTE_SHADER, shaderFile, computeSnippets);
+	unsigned computeShader = CompileShader(GL_COMPUTE_SHADER, computeSource);
 	DEFER {
 		glDeleteShader(computeShader);
 	};
 
 	// Link the program
-	LOG("Linking program...");
-	unsigned programId = glCreateProgram();
+	programId = glCreateProgram();
 	glAttachShader(programId, computeShader);
-	glLinkProgram(programId);
+	glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	if (LinkProgram(programId)) {
+		SaveProgramBinary(cacheEntry.c_str(), sourceHash, programId);
+	}
+
+	return programId;
+}
+
+std::string ModulePrograms::GetProgramBinaryPath(const char* cacheEntry) const {
+	return std::string(cachePath) + "/" + std::to_string(HashData(cacheEntry, strlen(cacheEntry)));
+}
+
+unsigned ModulePrograms::LoadProgramBinary(const char* cacheEntry, unsigned long long sourceHash) {
+	if (!programBinariesSupported) return 0;
+
+	std::string binaryPath = GetProgramBinaryPath(cacheEntry);
+	if (!App->files->Exists(binaryPath.c_str())) return 0;
+
+	Buffer<char> buffer = App->files->Load(binaryPath.c_str());
+	if (buffer.Size() <= sizeof(ProgramBinaryHeader)) return 0;
+
+	// Entries of other sources or drivers are stale. They are overwritten when the program is compiled again
+	ProgramBinaryHeader header;
+	memcpy(&header, buffer.Data(), sizeof(ProgramBinaryHeader));
+	if (header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION || header.sourceHash != sourceHash || header.driverHash != driverHash) {
+		LOG("Program binary of \"%s\" is stale.", cacheEntry);
+		return 0;
+	}
+
+	unsigned programId = glCreateProgram();
+	glProgramBinary(programId, header.format, buffer.Data() + sizeof(ProgramBinaryHeader), (GLsizei)(buffer.Size() - sizeof(ProgramBinaryHeader)));
+
+	// The driver can reject binaries even if they come from the same driver version
 	int res = GL_FALSE;
 	glGetProgramiv(programId, GL_LINK_STATUS, &res);
 	if (res == GL_FALSE) {
-		int len = 0;
-		glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &len);
-		if (len > 0) {
-			int written = 0;
-			Buffer<char> info = Buffer<char>(len);
-			glGetProgramInfoLog(programId, len, &written, info.Data());
-			LOG("Program Log Info: %s", info.Data());
-		}
-
-		LOG("Error linking program.");
-	} else {
-		LOG("Program linked.");
+		LOG("Program binary of \"%s\" was rejected by the driver.", cacheEntry);
+		glDeleteProgram(programId);
+		return 0;
 	}
 
+	LOG("Program loaded from binary.");
+	cacheHits += 1;
 	return programId;
 }
 
+void ModulePrograms::SaveProgramBinary(const char* cacheEntry, unsigned long long sourceHash, unsigned programId) {
+	if (!programBinariesSupported) return;
+
+	int binaryLength = 0;
+	glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	if (binaryLength <= 0) return;
+
+	ProgramBinaryHeader header;
+	header.sourceHash = sourceHash;
+	header.driverHash = driverHash;
+
+	Buffer<char> buffer = Buffer<char>(sizeof(ProgramBinaryHeader) + binaryLength);
+	int written = 0;
+	glGetProgramBinary(programId, binaryLength, &written, &header.format, buffer.Data() + sizeof(ProgramBinaryHeader));
+	if (written <= 0) return;
+
+	memcpy(buffer.Data(), &header, sizeof(ProgramBinaryHeader));
+	App->files->Save(GetProgramBinaryPath(cacheEntry).c_str(), buffer.Data(), sizeof(ProgramBinaryHeader) + written);
+}
+
 bool ModulePrograms::Start() {
 	LoadShaders();
 	return true;
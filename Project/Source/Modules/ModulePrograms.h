@@ -3,6 +3,25 @@
 #include "Module.h"
 #include "Rendering/Programs.h"
 
+#include <string>
+
+#define PROGRAM_BINARY_MAGIC 0x4E494250 // "PBIN" in little-endian
+#define PROGRAM_BINARY_VERSION 1
+
+/* Linked programs are cached in the library with glGetProgramBinary, and loaded with glProgramBinary on the next start.
+*  Each program has one entry, named after its shader file and snippets. The entry stores hashes of the shader sources
+*  and of the driver, and is recompiled from source and overwritten when they don't match or the driver rejects it.
+*/
+
+struct ProgramBinaryHeader {
+	unsigned magic = PROGRAM_BINARY_MAGIC;
+	unsigned version = PROGRAM_BINARY_VERSION;
+	unsigned format = 0;
+	unsigned padding = 0;
+	unsigned long long sourceHash = 0;
+	unsigned long long driverHash = 0; // Hash of the vendor, renderer and version strings
+};
+
 class ModulePrograms : public Module {
 public:
 	bool Start() override;
@@ -15,8 +34,14 @@ public:
 	unsigned CreateComputeProgram(const char* shaderFile, const char* computeSnippets = "compute");
 	void DeleteProgram(unsigned int idProgram);
 
+private:
+	std::string GetProgramBinaryPath(const char* cacheEntry) const;
+	unsigned LoadProgramBinary(const char* cacheEntry, unsigned long long sourceHash); // Returns 0 if the program isn't cached or the cached binary can't be used
+	void SaveProgramBinary(const char* cacheEntry, unsigned long long sourceHash, unsigned programId);
+
 public:
 	const char* filePath = "Library/shadersBin";
+	const char* cachePath = "Library/ProgramCache";
 
 	// Skybox shaders
 	ProgramHDRToCubemap* hdrToCubemap = nullptr;
@@ -31,6 +56,7 @@ public:
 
 	// Unlit Shader
 	ProgramUnlit* unlit = nullptr;
+	ProgramUnlit* unlitInstanced = nullptr;
 
 	// Volumetric light Shader
 	ProgramVolumetricLight* volumetricLight = nullptr;
@@ -43,6 +69,14 @@ public:
 	ProgramStandardSpecular* specularNormal = nullptr;
 	ProgramStandardSpecular* specularNotNormal = nullptr;
 
+	// Instanced Ilumination Shaders (model matrices are read from the instances storage buffer)
+	ProgramStandardPhong* phongNormalInstanced = nullptr;
+	ProgramStandardPhong* phongNotNormalInstanced = nullptr;
+	ProgramStandardMetallic* standardNormalInstanced = nullptr;
+	ProgramStandardMetallic* standardNotNormalInstanced = nullptr;
+	ProgramStandardSpecular* specularNormalInstanced = nullptr;
+	ProgramStandardSpecular* specularNotNormalInstanced = nullptr;
+
 	// Dissolve Shaders
 	ProgramStandardDissolve* dissolveStandard = nullptr;
 	ProgramUnlitDissolve* dissolveUnlit = nullptr;
@@ -51,6 +85,7 @@ public:
 	ProgramDepthPrepass* depthPrepass = nullptr;
 	ProgramDepthPrepassConvertTextures* depthPrepassConvertTextures = nullptr;
 	ProgramDepthPrepassDissolve* depthPrepassDissolve = nullptr;
+	ProgramDepthPrepass* depthPrepassInstanced = nullptr;
 
 	// SSAO Shaders
 	ProgramSSAO* ssao = nullptr;
@@ -67,17 +102,25 @@ public:
 	ProgramHeightFog* heightFog = nullptr;
 
 	// Shadow Shaders
-	unsigned shadowMap = 0;
+	ProgramShadowMap* shadowMap = nullptr;
+	ProgramShadowMap* shadowMapInstanced = nullptr;
 
 	// Engine Shaders
 	ProgramDrawTexture* drawTexture = nullptr;
 	ProgramDrawLightTiles* drawLightTiles = nullptr;
 
 	// UI Shaders
-	ProgramTextUI* textUI = nullptr;
-	ProgramImageUI* imageUI = nullptr;
+	ProgramUIBatch* uiBatch = nullptr; // Images and texts of the canvases
+	ProgramImageUI* imageUI = nullptr; // Videos
 
 	// Particle Shaders
 	ProgramBillboard* billboard = nullptr;
+	ProgramBillboardInstanced* billboardInstanced = nullptr;
 	ProgramTrail* trail = nullptr;
+
+private:
+	bool programBinariesSupported = false;
+	unsigned long long driverHash = 0;
+	unsigned cacheHits = 0;	  // Programs loaded from the binary cache in the last LoadShaders
+	unsigned cacheMisses = 0; // Programs compiled from source in the last LoadShaders
 };
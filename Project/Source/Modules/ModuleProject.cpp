@@ -403,6 +403,21 @@ bool ModuleProject::Init() {
 	return true;
 }
 
+UpdateStatus ModuleProject::FixedUpdate() {
+	if (App->time->HasGameStarted() && App->scene->scene->sceneLoaded) {
+		for (ComponentScript& script : App->scene->scene->scriptComponents) {
+			if (script.IsActive()) {
+				Script* scriptInstance = script.GetScriptInstance();
+				if (scriptInstance != nullptr) {
+					scriptInstance->FixedUpdate();
+				}
+			}
+		}
+	}
+
+	return UpdateStatus::CONTINUE;
+}
+
 UpdateStatus ModuleProject::Update() {
 	if (App->time->HasGameStarted() && App->scene->scene->sceneLoaded) {
 		for (ComponentScript& script : App->scene->scene->scriptComponents) {
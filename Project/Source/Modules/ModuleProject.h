@@ -22,6 +22,7 @@ enum class Configuration {
 class ModuleProject : public Module {
 public:
 	bool Init() override;
+	UpdateStatus FixedUpdate() override;
 	UpdateStatus Update() override;
 	bool CleanUp() override;
 	void ReceiveEvent(TesseractEvent& e) override; // Treats the events that is listening to.
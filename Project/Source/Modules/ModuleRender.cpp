@@ -24,6 +24,7 @@
 #include "Modules/ModuleUserInterface.h"
 #include "Modules/ModuleNavigation.h"
 #include "Resources/ResourceMesh.h"
+#include "Rendering/CullingBatch.h"
 #include "Utils/Logging.h"
 #include "Utils/Random.h"
 #include "TesseractEvent.h"
@@ -213,6 +214,8 @@ bool ModuleRender::Init() {
 	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, true);
 #endif
 
+	instanceBuffer.Init();
+
 	glGenBuffers(1, &lightTileFrustumsStorageBuffer);
 	glGenBuffers(1, &lightsStorageBuffer);
 	glGenBuffers(1, &lightIndicesCountStorageBufferOpaque);
@@ -328,30 +331,24 @@ bool ModuleRender::Init() {
 void ModuleRender::ClassifyGameObjects() {
 	opaqueGameObjects.clear();
 	transparentGameObjects.clear();
+	culledGameObjects.clear();
 
 	App->camera->CalculateFrustumPlanes();
 	float3 cameraPos = App->camera->GetActiveCamera()->GetFrustum()->Pos();
 	Scene* scene = App->scene->scene;
-	for (ComponentBoundingBox& boundingBox : scene->boundingBoxComponents) {
-		GameObject& gameObject = boundingBox.GetOwner();
-		gameObject.flag = false;
-		if (gameObject.isInQuadtree) continue;
-
-		const AABB& gameObjectAABB = boundingBox.GetWorldAABB();
-		const OBB& gameObjectOBB = boundingBox.GetWorldOBB();
-		if (App->camera->GetFrustumPlanes().CheckIfInsideFrustumPlanes(gameObjectAABB, gameObjectOBB)) {
-			if ((gameObject.GetMask().bitMask & static_cast<int>(MaskType::TRANSPARENT)) == 0) {
-				opaqueGameObjects.push_back(&gameObject);
-			} else {
-				ComponentTransform* transform = gameObject.GetComponent<ComponentTransform>();
-				float dist = Length(cameraPos - transform->GetGlobalPosition());
-				transparentGameObjects[dist] = &gameObject;
-			}
+	scene->CullGameObjects(App->camera->GetFrustumPlanes(), culledGameObjects, culledVisibility);
+	for (unsigned i = 0; i < culledGameObjects.size(); ++i) {
+		if (!CullingBatch::IsVisible(culledVisibility, i)) continue;
+
+		GameObject* gameObject = culledGameObjects[i];
+		if ((gameObject->GetMask().bitMask & static_cast<int>(MaskType::TRANSPARENT)) == 0) {
+			opaqueGameObjects.push_back(gameObject);
+		} else {
+			ComponentTransform* transform = gameObject->GetComponent<ComponentTransform>();
+			float dist = Length(cameraPos - transform->GetGlobalPosition());
+			transparentGameObjects[dist] = gameObject;
 		}
 	}
-	if (scene->quadtree.IsOperative()) {
-		ClassifyGameObjectsFromQuadtree(scene->quadtree.root, scene->quadtree.bounds);
-	}
 }
 
 void ModuleRender::ConvertDepthPrepassTextures() {
@@ -542,6 +539,8 @@ UpdateStatus ModuleRender::PreUpdate() {
 
 		UpdateFramebuffers();
 	}
+
+	instanceBuffer.BeginFrame();
 		
 	lightFrustumStatic.ReconstructFrustum(ShadowCasterType::STATIC);
 	lightFrustumDynamic.ReconstructFrustum(ShadowCasterType::DYNAMIC);
@@ -559,13 +558,17 @@ UpdateStatus ModuleRender::Update() {
 	BROFILER_CATEGORY("ModuleRender - Update", Profiler::Color::Green)
 
 	culledTriangles = 0;
+	drawCalls = 0;
+	stateChangesSaved = 0;
+	drawsMerged = 0;
 	Scene* scene = App->scene->scene;
 	float3 gammaClearColor = float3(pow(clearColor.x, 2.2f), pow(clearColor.y, 2.2f), pow(clearColor.y, 2.2f));
 
 	ClassifyGameObjects();
+	BuildRenderQueues();
 
 	// Shadow Pass Static
-	for (unsigned int i = 0; i < lightFrustumStatic.GetNumberOfCascades(); ++i) {
+	for (unsigned int i = 0; updateStaticShadowMaps && i < lightFrustumStatic.GetNumberOfCascades(); ++i) {
 		
 		glViewport(0, 0, static_cast<int>(viewportSize.x * lightFrustumStatic.GetSubFrustums()[i].multiplier), static_cast<int>(viewportSize.y * lightFrustumStatic.GetSubFrustums()[i].multiplier));
 
@@ -576,9 +579,7 @@ UpdateStatus ModuleRender::Update() {
 		glDepthFunc(GL_LESS);
 		glClear(GL_DEPTH_BUFFER_BIT);
 	
-		for (GameObject* gameObject : App->scene->scene->GetStaticShadowCasters()) {
-			DrawGameObjectShadowPass(gameObject, i, ShadowCasterType::STATIC);
-		}
+		DrawRenderQueue(staticShadowQueues[i], RenderPass::SHADOW, i, ShadowCasterType::STATIC);
 	
 	}
 	
@@ -594,9 +595,7 @@ UpdateStatus ModuleRender::Update() {
 		glDepthFunc(GL_LESS);
 		glClear(GL_DEPTH_BUFFER_BIT);
 
-		for (GameObject* gameObject : App->scene->scene->GetDynamicShadowCasters()) {
-			DrawGameObjectShadowPass(gameObject, i, ShadowCasterType::DYNAMIC);
-		}
+		DrawRenderQueue(dynamicShadowQueues[i], RenderPass::SHADOW, i, ShadowCasterType::DYNAMIC);
 
 	}
 
@@ -611,9 +610,7 @@ UpdateStatus ModuleRender::Update() {
 		glDepthFunc(GL_LESS);
 		glClear(GL_DEPTH_BUFFER_BIT);
 
-		for (GameObject* gameObject : App->scene->scene->GetMainEntitiesShadowCasters()) {
-			DrawGameObjectShadowPass(gameObject, i, ShadowCasterType::MAINENTITY);
-		}
+		DrawRenderQueue(mainEntitiesShadowQueues[i], RenderPass::SHADOW, i, ShadowCasterType::MAINENTITY);
 	}
 	
 #if GAME
@@ -633,9 +630,7 @@ UpdateStatus ModuleRender::Update() {
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 	}
 
-	for (GameObject* gameObject : opaqueGameObjects) {
-		DrawGameObjectDepthPrepass(gameObject);
-	}
+	DrawRenderQueue(depthPrepassQueue, RenderPass::DEPTH_PREPASS);
 
 	if (drawWireframe) {
 		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -769,9 +764,7 @@ UpdateStatus ModuleRender::Update() {
 
 	// Draw Opaque
 	glDepthFunc(GL_EQUAL);
-	for (GameObject* gameObject : opaqueGameObjects) {
-		DrawGameObject(gameObject);
-	}
+	DrawRenderQueue(opaqueQueue, RenderPass::OPAQUE);
 	glDepthFunc(GL_LEQUAL);
 
 	// Draw Fog
@@ -1030,6 +1023,8 @@ UpdateStatus ModuleRender::Update() {
 UpdateStatus ModuleRender::PostUpdate() {
 	BROFILER_CATEGORY("ModuleRender - PostUpdate", Profiler::Color::Green)
 
+	instanceBuffer.EndFrame();
+
 	SDL_GL_SwapWindow(App->window->window);
 
 	return UpdateStatus::CONTINUE;
@@ -1039,6 +1034,8 @@ bool ModuleRender::CleanUp() {
 	glDeleteVertexArrays(1, &cubeVAO);
 	glDeleteBuffers(1, &cubeVBO);
 
+	instanceBuffer.CleanUp();
+
 	glDeleteBuffers(1, &lightTileFrustumsStorageBuffer);
 	glDeleteBuffers(1, &lightsStorageBuffer);
 	glDeleteBuffers(1, &lightIndicesCountStorageBufferOpaque);
@@ -1105,6 +1102,9 @@ void ModuleRender::ReceiveEvent(TesseractEvent& ev) {
 void ModuleRender::UpdateFramebuffers() {
 	unsigned msaaSamples = msaaActive ? msaaSamplesNumber[static_cast<int>(msaaSampleType)] : msaaSampleSingle;
 
+	// The shadow map textures are recreated, so the cached static ones have to be drawn again
+	staticShadowMapsValid = false;
+
 	// Depth prepass buffer
 	glBindFramebuffer(GL_FRAMEBUFFER, depthPrepassBuffer);
 
@@ -1534,6 +1534,18 @@ int ModuleRender::GetCulledTriangles() const {
 	return culledTriangles;
 }
 
+int ModuleRender::GetDrawCalls() const {
+	return drawCalls;
+}
+
+int ModuleRender::GetStateChangesSaved() const {
+	return stateChangesSaved;
+}
+
+int ModuleRender::GetDrawsMerged() const {
+	return drawsMerged;
+}
+
 void ModuleRender::DrawQuadtreeRecursive(const Quadtree<GameObject>::Node& node, const AABB2D& aabb) {
 	if (node.IsBranch()) {
 		vec2d center = aabb.minPoint + (aabb.maxPoint - aabb.minPoint) * 0.5f;
@@ -1568,56 +1580,6 @@ void ModuleRender::DrawQuadtreeRecursive(const Quadtree<GameObject>::Node& node,
 	}
 }
 
-void ModuleRender::ClassifyGameObjectsFromQuadtree(const Quadtree<GameObject>::Node& node, const AABB2D& aabb) {
-	AABB aabb3d = AABB({aabb.minPoint.x, -1000000.0f, aabb.minPoint.y}, {aabb.maxPoint.x, 1000000.0f, aabb.maxPoint.y});
-	if (App->camera->GetFrustumPlanes().CheckIfInsideFrustumPlanes(aabb3d, OBB(aabb3d))) {
-		if (node.IsBranch()) {
-			vec2d center = aabb.minPoint + (aabb.maxPoint - aabb.minPoint) * 0.5f;
-
-			const Quadtree<GameObject>::Node& topLeft = node.childNodes->nodes[0];
-			AABB2D topLeftAABB = {{aabb.minPoint.x, center.y}, {center.x, aabb.maxPoint.y}};
-			ClassifyGameObjectsFromQuadtree(topLeft, topLeftAABB);
-
-			const Quadtree<GameObject>::Node& topRight = node.childNodes->nodes[1];
-			AABB2D topRightAABB = {{center.x, center.y}, {aabb.maxPoint.x, aabb.maxPoint.y}};
-			ClassifyGameObjectsFromQuadtree(topRight, topRightAABB);
-
-			const Quadtree<GameObject>::Node& bottomLeft = node.childNodes->nodes[2];
-			AABB2D bottomLeftAABB = {{aabb.minPoint.x, aabb.minPoint.y}, {center.x, center.y}};
-			ClassifyGameObjectsFromQuadtree(bottomLeft, bottomLeftAABB);
-
-			const Quadtree<GameObject>::Node& bottomRight = node.childNodes->nodes[3];
-			AABB2D bottomRightAABB = {{center.x, aabb.minPoint.y}, {aabb.maxPoint.x, center.y}};
-			ClassifyGameObjectsFromQuadtree(bottomRight, bottomRightAABB);
-		} else {
-			float3 cameraPos = App->camera->GetActiveCamera()->GetFrustum()->Pos();
-
-			const Quadtree<GameObject>::Element* element = node.firstElement;
-			while (element != nullptr) {
-				GameObject* gameObject = element->object;
-				if (!gameObject->flag) {
-					ComponentBoundingBox* boundingBox = gameObject->GetComponent<ComponentBoundingBox>();
-					const AABB& gameObjectAABB = boundingBox->GetWorldAABB();
-					const OBB& gameObjectOBB = boundingBox->GetWorldOBB();
-
-					if (App->camera->GetFrustumPlanes().CheckIfInsideFrustumPlanes(gameObjectAABB, gameObjectOBB)) {
-						if ((gameObject->GetMask().bitMask & static_cast<int>(MaskType::TRANSPARENT)) == 0) {
-							opaqueGameObjects.push_back(gameObject);
-						} else {
-							ComponentTransform* transform = gameObject->GetComponent<ComponentTransform>();
-							float dist = Length(cameraPos - transform->GetGlobalPosition());
-							transparentGameObjects[dist] = gameObject;
-						}
-					}
-
-					gameObject->flag = true;
-				}
-				element = element->next;
-			}
-		}
-	}
-}
-
 void ModuleRender::DrawGameObject(GameObject* gameObject) {
 	ComponentTransform* transform = gameObject->GetComponent<ComponentTransform>();
 	ComponentView<ComponentMeshRenderer> meshes = gameObject->GetComponents<ComponentMeshRenderer>();
@@ -1630,31 +1592,148 @@ void ModuleRender::DrawGameObject(GameObject* gameObject) {
 	for (ComponentMeshRenderer& mesh : meshes) {
 		mesh.Draw(transform->GetGlobalMatrix());
 
-		ResourceMesh* resourceMesh = App->resources->GetResource<ResourceMesh>(mesh.GetMesh());
+		ResourceMesh* resourceMesh = mesh.GetMeshResource();
 		if (resourceMesh != nullptr) {
-			culledTriangles += resourceMesh->indices.size() / 3;
+			culledTriangles += resourceMesh->numIndices / 3;
 		}
 	}
 }
 
-void ModuleRender::DrawGameObjectDepthPrepass(GameObject* gameObject) {
-	ComponentView<ComponentMeshRenderer> meshes = gameObject->GetComponents<ComponentMeshRenderer>();
-	ComponentTransform* transform = gameObject->GetComponent<ComponentTransform>();
-	assert(transform);
+void ModuleRender::BuildRenderQueues() {
+	BROFILER_CATEGORY("ModuleRender - BuildRenderQueues", Profiler::Color::Green)
 
-	for (ComponentMeshRenderer& mesh : meshes) {
-		mesh.DrawDepthPrepass(transform->GetGlobalMatrix());
+	depthPrepassQueue.Clear();
+	opaqueQueue.Clear();
+
+	Frustum* frustum = App->camera->GetActiveCamera()->GetFrustum();
+	float3 cameraPos = frustum->Pos();
+	float farPlane = frustum->FarPlaneDistance();
+
+	bool drawBoundingBoxes = drawAllBoundingBoxes && (App->camera->IsEngineCameraActive() || debugMode);
+	for (GameObject* gameObject : opaqueGameObjects) {
+		ComponentTransform* transform = gameObject->GetComponent<ComponentTransform>();
+		assert(transform);
+
+		if (drawBoundingBoxes) {
+			ComponentBoundingBox* boundingBox = gameObject->GetComponent<ComponentBoundingBox>();
+			if (boundingBox) boundingBox->DrawBoundingBox();
+		}
+
+		float4x4 modelMatrix = transform->GetGlobalMatrix();
+		float depth = Length(cameraPos - transform->GetGlobalPosition()) / farPlane;
+
+		for (ComponentMeshRenderer& mesh : gameObject->GetComponents<ComponentMeshRenderer>()) {
+			unsigned program = 0;
+			unsigned depthPrepassProgram = 0;
+			unsigned material = 0;
+			unsigned meshIndex = 0;
+			bool instanceable = false;
+			if (!mesh.GetRenderQueueKeys(program, depthPrepassProgram, material, meshIndex, instanceable)) continue;
+
+			depthPrepassQueue.Add(RenderPass::DEPTH_PREPASS, depthPrepassProgram, material, meshIndex, depth, &mesh, &modelMatrix, instanceable);
+			opaqueQueue.Add(RenderPass::OPAQUE, program, material, meshIndex, depth, &mesh, &modelMatrix, instanceable);
+
+			culledTriangles += mesh.GetMeshResource()->numIndices / 3;
+		}
+	}
+
+	for (RenderQueue* renderQueue : {&depthPrepassQueue, &opaqueQueue}) {
+		renderQueue->Sort();
+		renderQueue->BuildBatches(instanceBuffer);
+	}
+
+	// Shadow casters are culled against the light frustum of each cascade. They are drawn with a single program, so they are only sorted by material and mesh
+	Scene* scene = App->scene->scene;
+	for (unsigned int i = 0; i < lightFrustumDynamic.GetNumberOfCascades(); ++i) {
+		dynamicShadowQueues[i].Clear();
+		AddShadowCastersToRenderQueue(dynamicShadowQueues[i], scene->GetDynamicCulledShadowCasters(lightFrustumDynamic.GetSubFrustums()[i].orthographicPlanes));
+		dynamicShadowQueues[i].Sort();
+		dynamicShadowQueues[i].BuildBatches(instanceBuffer);
+	}
+
+	for (unsigned int i = 0; i < lightFrustumMainEntities.GetNumberOfCascades(); ++i) {
+		mainEntitiesShadowQueues[i].Clear();
+		AddShadowCastersToRenderQueue(mainEntitiesShadowQueues[i], scene->GetMainEntitiesCulledShadowCasters(lightFrustumMainEntities.GetSubFrustums()[i].orthographicPlanes));
+		mainEntitiesShadowQueues[i].Sort();
+		mainEntitiesShadowQueues[i].BuildBatches(instanceBuffer);
+	}
+
+	// Static shadow maps are kept from previous frames until the light, the cascades or a static caster change
+	updateStaticShadowMaps = !staticShadowMapsValid || staticShadowMapsVersion != lightFrustumStatic.GetVersion();
+	if (!updateStaticShadowMaps) return;
+
+	staticShadowMapsValid = true;
+	staticShadowMapsVersion = lightFrustumStatic.GetVersion();
+	for (unsigned int i = 0; i < lightFrustumStatic.GetNumberOfCascades(); ++i) {
+		staticShadowQueues[i].Clear();
+		if (!AddShadowCastersToRenderQueue(staticShadowQueues[i], scene->GetStaticCulledShadowCasters(lightFrustumStatic.GetSubFrustums()[i].orthographicPlanes))) {
+			staticShadowMapsValid = false;
+		}
+		staticShadowQueues[i].Sort();
+		staticShadowQueues[i].BuildBatches(instanceBuffer);
 	}
 }
 
-void ModuleRender::DrawGameObjectShadowPass(GameObject* gameObject, unsigned int i, ShadowCasterType lightFrustumType) {
-	ComponentView<ComponentMeshRenderer> meshes = gameObject->GetComponents<ComponentMeshRenderer>();
-	ComponentTransform* transform = gameObject->GetComponent<ComponentTransform>();
-	assert(transform);
+bool ModuleRender::AddShadowCastersToRenderQueue(RenderQueue& renderQueue, const std::vector<GameObject*>& shadowCasters) {
+	bool cacheable = true;
+	for (GameObject* gameObject : shadowCasters) {
+		ComponentTransform* transform = gameObject->GetComponent<ComponentTransform>();
+		assert(transform);
+
+		float4x4 modelMatrix = transform->GetGlobalMatrix();
+		for (ComponentMeshRenderer& mesh : gameObject->GetComponents<ComponentMeshRenderer>()) {
+			unsigned program = 0;
+			unsigned depthPrepassProgram = 0;
+			unsigned material = 0;
+			unsigned meshIndex = 0;
+			bool instanceable = false;
+			if (!mesh.GetRenderQueueKeys(program, depthPrepassProgram, material, meshIndex, instanceable)) {
+				// The caster has to be drawn again once its resources finish loading
+				if (mesh.IsActive() && mesh.GetMesh() != 0 && mesh.GetMeshResource() == nullptr) cacheable = false;
+				continue;
+			}
 
-	for (ComponentMeshRenderer& mesh : meshes) {
-		mesh.DrawShadow(transform->GetGlobalMatrix(), i, lightFrustumType);
+			// The shadow map program has no dissolve, so every non-skinned mesh can be instanced. Skinned meshes change every frame, so they can't be cached
+			instanceable = mesh.GetMeshResource()->bones.empty();
+			if (!instanceable) cacheable = false;
+			renderQueue.Add(RenderPass::SHADOW, 0, material, meshIndex, 0.0f, &mesh, &modelMatrix, instanceable);
+		}
 	}
+	return cacheable;
+}
+
+void ModuleRender::DrawRenderQueue(const RenderQueue& renderQueue, RenderPass renderPass, unsigned cascade, ShadowCasterType shadowCasterType) {
+	renderState.Reset();
+	instanceBuffer.Bind();
+
+	const std::vector<DrawCommand>& commands = renderQueue.GetCommands();
+	for (const DrawBatch& batch : renderQueue.GetBatches()) {
+		// Instanced batches only draw their first command, the rest of model matrices are already in the instance buffer
+		unsigned drawCount = batch.instanced ? 1 : batch.count;
+		renderState.instanceCount = batch.instanced ? batch.count : 0;
+		renderState.baseInstance = batch.baseInstance;
+
+		for (unsigned i = batch.first; i < batch.first + drawCount; ++i) {
+			const DrawCommand& command = commands[i];
+			switch (renderPass) {
+			case RenderPass::SHADOW:
+				command.meshRenderer->DrawShadow(*command.modelMatrix, cascade, shadowCasterType, &renderState);
+				break;
+			case RenderPass::DEPTH_PREPASS:
+				command.meshRenderer->DrawDepthPrepass(*command.modelMatrix, &renderState);
+				break;
+			case RenderPass::OPAQUE:
+				command.meshRenderer->Draw(*command.modelMatrix, &renderState);
+				break;
+			}
+		}
+	}
+	renderState.instanceCount = 0;
+	glBindVertexArray(0);
+
+	drawCalls += renderState.draws;
+	stateChangesSaved += renderState.stateChangesSaved;
+	drawsMerged += renderState.drawsMerged;
 }
 
 void ModuleRender::RenderUI() {
@@ -1666,6 +1745,7 @@ void ModuleRender::RenderUI() {
 	glDisable(GL_DEPTH_TEST); // In order to not clip with Models
 	App->userInterface->Render();
 	glEnable(GL_DEPTH_TEST);
+	drawCalls += App->userInterface->GetDrawCalls();
 
 	if (App->userInterface->IsUsing2D()) {
 		App->camera->EnablePerspective();
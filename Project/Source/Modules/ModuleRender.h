@@ -3,6 +3,8 @@
 #include "Module.h"
 #include "Utils/Quadtree.h"
 #include "Rendering/LightFrustum.h"
+#include "Rendering/RenderQueue.h"
+#include "Rendering/InstanceBuffer.h"
 
 #include "MathGeoLibFwd.h"
 #include "Math/float3.h"
@@ -83,6 +85,9 @@ public:
 	int GetLightTilesPerRow() const;
 
 	int GetCulledTriangles() const;
+	int GetDrawCalls() const;
+	int GetStateChangesSaved() const;
+	int GetDrawsMerged() const;
 	const float2 GetViewportSize();
 
 	bool ObjectInsideFrustum(GameObject* gameObject);
@@ -209,10 +214,10 @@ public:
 private:
 	void DrawQuadtreeRecursive(const Quadtree<GameObject>::Node& node, const AABB2D& aabb);			  // Draws the quadrtee nodes if 'drawQuadtree' is set to true.
 	void ClassifyGameObjects();																		  // Classify Game Objects from Scene taking into account Frustum Culling, Shadows and Rendering Mode
-	void ClassifyGameObjectsFromQuadtree(const Quadtree<GameObject>::Node& node, const AABB2D& aabb); // Classify Game Objects from Scene taking into account Frustum Culling, Quadtree, Shadows and Rendering Mode
 	void DrawGameObject(GameObject* gameObject);													  // ??
-	void DrawGameObjectDepthPrepass(GameObject* gameObject);
-	void DrawGameObjectShadowPass(GameObject* gameObject, unsigned int i, ShadowCasterType lightFrustumType);
+	void BuildRenderQueues();																			// Builds, sorts and batches the depth prepass, opaque and shadow render queues
+	bool AddShadowCastersToRenderQueue(RenderQueue& renderQueue, const std::vector<GameObject*>& shadowCasters); // Returns false if a caster can't be cached in a shadow map yet (its resources are still loading or it's skinned)
+	void DrawRenderQueue(const RenderQueue& renderQueue, RenderPass renderPass, unsigned cascade = 0, ShadowCasterType shadowCasterType = ShadowCasterType::STATIC); // Draws a sorted render queue, skipping the state changes that are still valid from the previous draw
 	void DrawAnimation(const GameObject* gameObject, bool hasAnimation = false);
 	void RenderUI();
 	void SetOrtographicRender();
@@ -252,9 +257,26 @@ private:
 	bool drawLightTilesOpaque = false;
 	bool drawLightTilesTransparent = false;
 
+	std::vector<GameObject*> culledGameObjects;			 // GameObjects in the spatial hierarchy nodes inside the frustum, before classifying them
+	std::vector<unsigned> culledVisibility;				 // One bit per culled GameObject, set if its bounds are inside the frustum
 	std::vector<GameObject*> opaqueGameObjects;			 // Vector of Opaque GameObjects
 	std::map<float, GameObject*> transparentGameObjects; // Map with Transparent GameObjects
 
+	// ------- Render Queues ------- //
+	RenderQueue depthPrepassQueue;
+	RenderQueue opaqueQueue;
+	RenderQueue staticShadowQueues[MAX_NUMBER_OF_CASCADES];		// Shadow casters culled against the light frustum of each cascade
+	RenderQueue dynamicShadowQueues[MAX_NUMBER_OF_CASCADES];
+	RenderQueue mainEntitiesShadowQueues[MAX_NUMBER_OF_CASCADES];
+	bool updateStaticShadowMaps = true;	// Static shadow maps are only redrawn when 'lightFrustumStatic' changes. Otherwise, the previous depth textures are reused
+	bool staticShadowMapsValid = false;	// False if the static shadow maps have to be redrawn even if 'lightFrustumStatic' hasn't changed
+	unsigned staticShadowMapsVersion = 0; // Version of 'lightFrustumStatic' the static shadow maps were drawn with
+	InstanceBuffer instanceBuffer;
+	RenderState renderState;
+	int drawCalls = 0;
+	int stateChangesSaved = 0;
+	int drawsMerged = 0;
+
 	// ------- Kernels ------- //
 	std::vector<float> ssaoGaussKernel;
 	std::vector<float> bloomGaussKernel;
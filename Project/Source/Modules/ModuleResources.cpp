@@ -4,6 +4,8 @@
 #include "Application.h"
 #include "Utils/Logging.h"
 #include "Utils/FileDialog.h"
+#include "Utils/MSTimer.h"
+#include "Utils/Hash.h"
 #include "Resources/ResourcePrefab.h"
 #include "Resources/ResourceMaterial.h"
 #include "Resources/ResourceMesh.h"
@@ -54,14 +56,15 @@
 
 #include "Utils/Leaks.h"
 
+static thread_local const ImportIsolation* importIsolation = nullptr; // Isolation of the import running in the thread
+
 #define JSON_TAG_RESOURCES "Resources"
 #define JSON_TAG_TYPE "Type"
 #define JSON_TAG_ID "Id"
 #define JSON_TAG_NAME "Name"
+#define JSON_TAG_CONTENT_HASH "ContentHash"
 
-static bool ReadJSON(const char* filePath, rapidjson::Document& document) {
-	// Read from file
-	Buffer<char> buffer = App->files->Load(filePath);
+static bool ParseJSON(const char* filePath, const Buffer<char>& buffer, rapidjson::Document& document) {
 	if (buffer.Size() == 0) {
 		LOG("Error reading meta file %s", filePath);
 		return false;
@@ -77,6 +80,40 @@ static bool ReadJSON(const char* filePath, rapidjson::Document& document) {
 	return true;
 }
 
+static bool ReadJSON(const char* filePath, rapidjson::Document& document) {
+	// Read from file
+	Buffer<char> buffer = App->files->Load(filePath);
+	return ParseJSON(filePath, buffer, document);
+}
+
+// Hash of the asset file and of its import options, which are the members of the meta file other than the resources
+static unsigned long long HashAssetSource(const char* filePath, const rapidjson::Document& document) {
+	Buffer<char> buffer = App->files->Load(filePath);
+	unsigned long long hash = HashData(buffer.Data(), buffer.Size());
+	if (!document.IsObject()) return hash;
+
+	for (rapidjson::Value::ConstMemberIterator it = document.MemberBegin(); it != document.MemberEnd(); ++it) {
+		const char* name = it->name.GetString();
+		if (strcmp(name, JSON_TAG_RESOURCES) == 0 || strcmp(name, JSON_TAG_CONTENT_HASH) == 0) continue;
+
+		rapidjson::StringBuffer stringBuffer;
+		rapidjson::Writer<rapidjson::StringBuffer, rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag> writer(stringBuffer);
+		it->value.Accept(writer);
+		hash = HashString(name, hash);
+		hash = HashData(stringBuffer.GetString(), stringBuffer.GetSize(), hash);
+	}
+	return hash;
+}
+
+// Returns true if the set contains the path or one of its parent folders
+static bool ContainsPathOrParent(const std::unordered_set<std::string>& paths, const std::string& path) {
+	for (size_t length = path.size(); length != std::string::npos; length = path.find_last_of('/', length - 1)) {
+		if (paths.find(path.substr(0, length)) != paths.end()) return true;
+		if (length == 0) break;
+	}
+	return false;
+}
+
 static void SaveJSON(const char* filePath, rapidjson::Document& document) {
 	// Write document to buffer
 	rapidjson::StringBuffer stringBuffer;
@@ -97,6 +134,7 @@ bool ModuleResources::Init() {
 	App->events->AddObserverToEvent(TesseractEventType::CREATE_RESOURCE, this);
 	App->events->AddObserverToEvent(TesseractEventType::DESTROY_RESOURCE, this);
 	App->events->AddObserverToEvent(TesseractEventType::UPDATE_ASSET_CACHE, this);
+	App->events->AddObserverToEvent(TesseractEventType::UPDATE_ASSET_CACHE_DIFF, this);
 
 #if GAME
 	ImportLibrary();
@@ -108,6 +146,10 @@ bool ModuleResources::Init() {
 bool ModuleResources::Start() {
 	stopImportThread = false;
 
+	// The import thread works on the batches too
+	unsigned numThreads = std::thread::hardware_concurrency();
+	importPipeline.Start(numThreads > 1 ? numThreads - 1 : 0);
+
 	importThread = std::thread(&ModuleResources::UpdateAsync, this);
 
 	return true;
@@ -128,6 +170,7 @@ UpdateStatus ModuleResources::Update() {
 bool ModuleResources::CleanUp() {
 	stopImportThread = true;
 	importThread.join();
+	importPipeline.Stop();
 
 	for (auto& entry : resources) {
 		Resource* resource = entry.second.get();
@@ -135,6 +178,8 @@ bool ModuleResources::CleanUp() {
 			resource->Unload();
 		}
 	}
+	resourceTable.Clear();
+	resourceHandles.clear();
 	resources.clear();
 	return true;
 }
@@ -142,11 +187,9 @@ bool ModuleResources::CleanUp() {
 void ModuleResources::ReceiveEvent(TesseractEvent& e) {
 	if (e.type == TesseractEventType::CREATE_RESOURCE) {
 		CreateResourceStruct& createResourceStruct = e.Get<CreateResourceStruct>();
-		Resource* resource = CreateResourceByType(createResourceStruct.type, createResourceStruct.resourceName.c_str(), createResourceStruct.assetFilePath.c_str(), createResourceStruct.resourceId);
+		Resource* resource = CreateResourceByType(createResourceStruct.type, createResourceStruct.resourceName, createResourceStruct.assetFilePath, createResourceStruct.resourceId);
 		UID id = resource->GetId();
-		resourcesMutex.lock();
-		resources[id].reset(resource);
-		resourcesMutex.unlock();
+		AddResource(resource);
 
 		if (GetReferenceCount(id) > 0) {
 			LoadResource(resource);
@@ -154,14 +197,7 @@ void ModuleResources::ReceiveEvent(TesseractEvent& e) {
 
 	} else if (e.type == TesseractEventType::DESTROY_RESOURCE) {
 		UID id = e.Get<DestroyResourceStruct>().resourceId;
-		resourcesMutex.lock();
-		auto& it = resources.find(id);
-		std::unique_ptr<Resource> resource = nullptr;
-		if (it != resources.end()) {
-			resource.swap(it->second);
-			resources.erase(it);
-		}
-		resourcesMutex.unlock();
+		std::unique_ptr<Resource> resource = RemoveResource(id);
 		if (resource.get() != nullptr) {
 			UnloadResource(resource.get());
 		}
@@ -170,6 +206,10 @@ void ModuleResources::ReceiveEvent(TesseractEvent& e) {
 		assetCache.reset(newAssetCache);
 
 		e.Get<UpdateAssetCacheStruct>().assetCache = nullptr;
+	} else if (e.type == TesseractEventType::UPDATE_ASSET_CACHE_DIFF) {
+		if (assetCache != nullptr) {
+			assetCache->ApplyDiff(*e.Get<UpdateAssetCacheDiffStruct>().diff);
+		}
 	}
 }
 
@@ -251,12 +291,39 @@ bool ModuleResources::ImportAssetByExtension(JsonValue jMeta, const char* filePa
 	return validExtension;
 }
 
-std::list<UID> ModuleResources::ImportAssetResources(const char* filePath, bool force) {
+std::list<UID> ModuleResources::ImportAssetResources(const char* filePath, bool force, const ImportIsolation* isolation) {
 	std::list<UID> resources;
 
+	const ImportIsolation* outerIsolation = importIsolation;
+	if (isolation != nullptr) importIsolation = isolation;
+	DEFER {
+		importIsolation = outerIsolation;
+	};
+
+	// Isolated imports read the assets from the copy, including the textures that models look for in TEXTURES_PATH
+	std::string isolatedFilePath;
+	size_t assetsPathLength = strlen(ASSETS_PATH);
+	if (importIsolation != nullptr && strncmp(filePath, ASSETS_PATH "/", assetsPathLength + 1) == 0) {
+		isolatedFilePath = importIsolation->assetsPath + (filePath + assetsPathLength);
+		filePath = isolatedFilePath.c_str();
+	}
+
 	// Return an empty list if the asset couldn't be found
 	if (!App->files->Exists(filePath)) return resources;
 
+	// Wait until other imports of the same asset finish
+	{
+		std::unique_lock<std::mutex> lock(importingAssetsMutex);
+		assetImportFinished.wait(lock, [this, filePath] { return importingAssets.find(filePath) == importingAssets.end(); });
+		importingAssets.insert(filePath);
+	}
+	DEFER {
+		importingAssetsMutex.lock();
+		importingAssets.erase(filePath);
+		importingAssetsMutex.unlock();
+		assetImportFinished.notify_all();
+	};
+
 	std::string metaFilePath = std::string(filePath) + META_EXTENSION;
 
 	// Flag to keep track of the validity of the asset's meta file
@@ -276,14 +343,20 @@ std::list<UID> ModuleResources::ImportAssetResources(const char* filePath, bool
 		}
 	}
 
+	// Forced imports are skipped if the asset and its import options are the same as in the last import
+	bool unchanged = false;
+	if (force && validMetaFile && validResourceFiles && skipUnchangedImports) {
+		UID contentHash = jMeta[JSON_TAG_CONTENT_HASH];
+		unchanged = contentHash != 0 && contentHash == HashAssetSource(filePath, document);
+	}
+
 	// if resources are valid resources, reimport them or import them if needed or forced to
-	if (!force && validMetaFile && validResourceFiles) {
+	if ((!force || unchanged) && validMetaFile && validResourceFiles) {
 		RecreateResources(jMeta, filePath);
 	} else {
 		if (ImportAssetByExtension(jMeta, filePath)) {
-			if (!validMetaFile) {
-				SaveJSON(metaFilePath.c_str(), document);
-			}
+			jMeta[JSON_TAG_CONTENT_HASH] = (UID) HashAssetSource(filePath, document);
+			SaveJSON(metaFilePath.c_str(), document);
 		}
 	}
 
@@ -296,6 +369,26 @@ std::list<UID> ModuleResources::ImportAssetResources(const char* filePath, bool
 	return resources;
 }
 
+void ModuleResources::ImportAssets(const std::vector<std::string>& filePaths, std::vector<std::list<UID>>& resourceIds, bool force, bool parallel, const ImportIsolation* isolation) {
+	importPipeline.Import(filePaths, resourceIds, force, parallel, isolation);
+}
+
+bool ModuleResources::IsImportIsolated() const {
+	return importIsolation != nullptr;
+}
+
+unsigned ModuleResources::GetImportThreadCount() const {
+	return importPipeline.GetNumThreads();
+}
+
+ResourceHandle ModuleResources::GetResourceHandle(UID id) {
+	resourcesMutex.lock();
+	auto it = resourceHandles.find(id);
+	ResourceHandle handle = it != resourceHandles.end() ? it->second : ResourceHandle();
+	resourcesMutex.unlock();
+	return handle;
+}
+
 AssetCache* ModuleResources::GetAssetCache() const {
 	return assetCache.get();
 }
@@ -336,7 +429,8 @@ unsigned ModuleResources::GetReferenceCount(UID id) const {
 
 std::string ModuleResources::GenerateResourcePath(UID id) const {
 	std::string strId = std::to_string(id);
-	std::string metaFolder = std::string(LIBRARY_PATH "/") + strId.substr(0, 2);
+	std::string libraryPath = importIsolation != nullptr ? importIsolation->libraryPath : LIBRARY_PATH;
+	std::string metaFolder = libraryPath + "/" + strId.substr(0, 2);
 
 	if (!App->files->Exists(metaFolder.c_str())) {
 		App->files->CreateFolder(metaFolder.c_str());
@@ -346,115 +440,281 @@ std::string ModuleResources::GenerateResourcePath(UID id) const {
 }
 
 void ModuleResources::UpdateAsync() {
+#if !GAME
+	bool watching = assetWatcher.Start(ASSETS_PATH);
+	if (!watching) {
+		LOG("The assets folder can't be watched. It will be scanned every %i ms.", TIME_BETWEEN_RESOURCE_UPDATES_MS);
+	}
+
+	MSTimer fullScanTimer;
+	fullScanTimer.Start();
+	bool fullScanNeeded = true;
+	std::vector<FileChange> changes;
+	std::vector<std::string> reimportedAssets;
+#endif
+
 	while (!stopImportThread) {
 #if !GAME
-		// Check if any asset file has been modified / deleted
-		std::vector<UID> resourcesToRemove;
-		std::vector<std::string> assetsToImport;
-
-		for (const auto& entry : concurrentResourceUIDToAssetFilePath) {
-			UID resourceId = entry.first;
-			const std::string& assetFilePath = entry.second;
-			const std::string& resourceFilePath = GenerateResourcePath(resourceId);
-			std::string metaFilePath = assetFilePath + META_EXTENSION;
-
-			// Check for deleted assets
-			if (!App->files->Exists(assetFilePath.c_str())) {
-				resourcesToRemove.push_back(resourceId);
-				continue;
+		changes.clear();
+		reimportedAssets.clear();
+
+		if (watching && !assetWatcher.PollChanges(changes)) {
+			LOG("Some changes of the assets folder were missed. Scanning it again.");
+			fullScanNeeded = true;
+		}
+		if (!watching || fullScanTimer.Read() >= TIME_BETWEEN_FULL_ASSET_SCANS_MS) {
+			fullScanNeeded = true;
+		}
+
+		while (!assetsToReimport.empty()) {
+			std::string assetFilePath = "";
+			if (assetsToReimport.try_pop(assetFilePath)) {
+				reimportedAssets.push_back(assetFilePath);
 			}
+		}
+
+		if (fullScanNeeded) {
+			ScanAssets(reimportedAssets);
+			fullScanTimer.Start();
+			fullScanNeeded = false;
+		} else if (!changes.empty() || !reimportedAssets.empty()) {
+			UpdateChangedAssets(changes, reimportedAssets);
+		}
+#endif
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(TIME_BETWEEN_RESOURCE_UPDATES_MS));
+	}
+
+#if !GAME
+	assetWatcher.Stop();
+#endif
+}
+
+void ModuleResources::ScanAssets(const std::vector<std::string>& reimportedAssets) {
+	// Check if any asset file has been modified / deleted
+	std::vector<UID> resourcesToRemove;
+	std::vector<std::string> assetsToImport;
+	concurrentResourcesMutex.lock();
+	for (const auto& entry : concurrentResourceUIDToAssetFilePath) {
+		CheckResource(entry.first, entry.second, resourcesToRemove, assetsToImport);
+	}
+	concurrentResourcesMutex.unlock();
+	RemoveResources(resourcesToRemove, assetsToImport);
+
+	std::vector<std::list<UID>> resourceIds;
+	importPipeline.Import(reimportedAssets, resourceIds, true);
+
+	// Check if there are any new assets and build cached folder structure. Importing every asset also imports the ones in assetsToImport
+	AssetCacheDiff diff;
+	std::vector<std::string> assetFilePaths;
+	CheckForNewAssetsRecursive(ASSETS_PATH, diff, assetFilePaths);
+	importPipeline.Import(assetFilePaths, resourceIds);
+	AddImportedAssetsToDiff(assetFilePaths, resourceIds, diff);
+
+	importAssetCache.reset(new AssetCache(ASSETS_PATH));
+	importAssetCache->ApplyDiff(diff);
+	AssetCache* newAssetCache = new AssetCache(ASSETS_PATH);
+	newAssetCache->ApplyDiff(diff);
+
+	TesseractEvent updateAssetCacheEv(TesseractEventType::UPDATE_ASSET_CACHE);
+	updateAssetCacheEv.Set<UpdateAssetCacheStruct>(newAssetCache);
+	App->events->AddEvent(std::move(updateAssetCacheEv));
+}
+
+void ModuleResources::UpdateChangedAssets(const std::vector<FileChange>& changes, const std::vector<std::string>& reimportedAssets) {
+	// Changes of a meta file are handled as changes of its asset. Each path is handled once
+	std::vector<std::string> changedPaths;
+	std::unordered_set<std::string> changedPathsSet;
+	for (const FileChange& change : changes) {
+		std::string path = change.path;
+		if (FileDialog::GetFileExtension(path.c_str()) == META_EXTENSION) {
+			path.erase(path.size() - strlen(META_EXTENSION));
+		}
+		if (changedPathsSet.insert(path).second) {
+			changedPaths.push_back(path);
+		}
+	}
+	std::unordered_set<std::string> reimportedAssetsSet(reimportedAssets.begin(), reimportedAssets.end());
+	for (const std::string& assetFilePath : reimportedAssets) {
+		if (changedPathsSet.insert(assetFilePath).second) {
+			changedPaths.push_back(assetFilePath);
+		}
+	}
 
-			// Check for deleted, invalid or outdated meta files
-			if (!App->files->Exists(metaFilePath.c_str())) {
+	// Check the resources of the changed assets and of the assets inside changed folders
+	std::vector<UID> resourcesToRemove;
+	std::vector<std::string> assetsToImport;
+	concurrentResourcesMutex.lock();
+	for (const auto& entry : concurrentResourceUIDToAssetFilePath) {
+		if (ContainsPathOrParent(changedPathsSet, entry.second)) {
+			CheckResource(entry.first, entry.second, resourcesToRemove, assetsToImport);
+		}
+	}
+	concurrentResourcesMutex.unlock();
+	RemoveResources(resourcesToRemove, assetsToImport);
+
+	// Build the diff of the asset cache. The changed assets are imported together, which also imports the ones in assetsToImport
+	AssetCacheDiff* diff = new AssetCacheDiff();
+	std::vector<std::string> assetFilePaths;
+	std::vector<std::string> reimportedFilePaths;
+	for (const std::string& path : changedPaths) {
+		if (!App->files->Exists(path.c_str())) {
+			assetMetaCache.erase(path);
+			if (importAssetCache->foldersMap.find(path) != importAssetCache->foldersMap.end()) {
+				diff->removedFolders.push_back(path);
+			} else if (importAssetCache->filesMap.find(path) != importAssetCache->filesMap.end()) {
+				diff->removedFiles.push_back(path);
+			}
+		} else if (App->files->IsDirectory(path.c_str())) {
+			if (importAssetCache->foldersMap.find(path) == importAssetCache->foldersMap.end()) {
+				diff->addedFolders.push_back(path);
+				CheckForNewAssetsRecursive(path.c_str(), *diff, assetFilePaths);
+			}
+		} else if (reimportedAssetsSet.find(path) != reimportedAssetsSet.end()) {
+			reimportedFilePaths.push_back(path);
+		} else {
+			assetFilePaths.push_back(path);
+		}
+	}
+
+	std::vector<std::list<UID>> resourceIds;
+	importPipeline.Import(reimportedFilePaths, resourceIds, true);
+	AddImportedAssetsToDiff(reimportedFilePaths, resourceIds, *diff);
+	importPipeline.Import(assetFilePaths, resourceIds);
+	AddImportedAssetsToDiff(assetFilePaths, resourceIds, *diff);
+
+	SendAssetCacheDiff(diff);
+}
+
+void ModuleResources::CheckResource(UID resourceId, const std::string& assetFilePath, std::vector<UID>& resourcesToRemove, std::vector<std::string>& assetsToImport) {
+	const std::string& resourceFilePath = GenerateResourcePath(resourceId);
+	std::string metaFilePath = assetFilePath + META_EXTENSION;
+
+	// Check for deleted assets
+	if (!App->files->Exists(assetFilePath.c_str())) {
+		assetMetaCache.erase(assetFilePath);
+		resourcesToRemove.push_back(resourceId);
+		return;
+	}
+
+	// Check for deleted, invalid or outdated meta files
+	if (!App->files->Exists(metaFilePath.c_str())) {
+		assetMetaCache.erase(assetFilePath);
+		resourcesToRemove.push_back(resourceId);
+		return;
+	}
+
+	// The meta file is only read if it or its asset changed since the last check, and only parsed if its contents changed too
+	long long metaTimestamp = App->files->GetLocalFileModificationTime(metaFilePath.c_str());
+	long long assetTimestamp = App->files->GetLocalFileModificationTime(assetFilePath.c_str());
+	AssetMetaEntry& metaEntry = assetMetaCache[assetFilePath];
+	if (metaEntry.metaTimestamp != metaTimestamp || metaEntry.assetTimestamp != assetTimestamp) {
+		Buffer<char> buffer = App->files->Load(metaFilePath.c_str());
+		unsigned long long metaHash = HashData(buffer.Data(), buffer.Size());
+		if (metaHash != metaEntry.metaHash || assetTimestamp > metaTimestamp) {
+			rapidjson::Document document;
+			bool success = ParseJSON(metaFilePath.c_str(), buffer, document);
+			JsonValue jMeta(document, document);
+
+			if (!success) {
+				assetMetaCache.erase(assetFilePath);
 				resourcesToRemove.push_back(resourceId);
-				continue;
-			} else {
-				rapidjson::Document document;
-				bool success = ReadJSON(metaFilePath.c_str(), document);
-				JsonValue jMeta(document, document);
-
-				if (success) {
-					long long metaTimestamp = App->files->GetLocalFileModificationTime(metaFilePath.c_str());
-					long long assetTimestamp = App->files->GetLocalFileModificationTime(assetFilePath.c_str());
-					if (assetTimestamp > metaTimestamp) {
-						if (jMeta[JSON_TAG_RESOURCES].Size() > 1) {
-							resourcesToRemove.push_back(resourceId);
-						} else {
-							resourcesToRemove.push_back(resourceId);
-							if (std::find(assetsToImport.begin(), assetsToImport.end(), assetFilePath) == assetsToImport.end()) {
-								assetsToImport.push_back(assetFilePath);
-								SaveJSON(metaFilePath.c_str(), document);
-							}
-						}
-						continue;
-					}
+				return;
+			}
+
+			if (assetTimestamp > metaTimestamp) {
+				// Assets that were touched without changing them (e.g. by a checkout) keep their resources
+				UID contentHash = jMeta[JSON_TAG_CONTENT_HASH];
+				if (contentHash != 0 && contentHash == HashAssetSource(assetFilePath.c_str(), document) && App->files->Exists(resourceFilePath.c_str())) {
+					SaveJSON(metaFilePath.c_str(), document);
+					assetMetaCache.erase(assetFilePath);
+					return;
+				}
+
+				if (jMeta[JSON_TAG_RESOURCES].Size() > 1) {
+					resourcesToRemove.push_back(resourceId);
 				} else {
 					resourcesToRemove.push_back(resourceId);
-					continue;
-				}
-			}
-			// Check for deleted resources
-			if (!App->files->Exists(resourceFilePath.c_str())) {
-				if (std::find(assetsToImport.begin(), assetsToImport.end(), assetFilePath) == assetsToImport.end()) {
-					assetsToImport.push_back(assetFilePath);
+					if (std::find(assetsToImport.begin(), assetsToImport.end(), assetFilePath) == assetsToImport.end()) {
+						assetsToImport.push_back(assetFilePath);
+						SaveJSON(metaFilePath.c_str(), document);
+					}
 				}
+				assetMetaCache.erase(assetFilePath);
+				return;
 			}
 		}
-		for (UID resourceId : resourcesToRemove) {
-			const std::string& assetFilePath = concurrentResourceUIDToAssetFilePath.at(resourceId);
-			const std::string& resourceFilePath = GenerateResourcePath(resourceId);
-			std::string metaFilePath = assetFilePath + META_EXTENSION;
-			if (App->files->Exists(metaFilePath.c_str()) && std::find(assetsToImport.begin(), assetsToImport.end(), assetFilePath) == assetsToImport.end()) {
-				App->files->Erase(metaFilePath.c_str());
-			}
-			if (App->files->Exists(resourceFilePath.c_str())) {
-				App->files->Erase(resourceFilePath.c_str());
-			}
 
-			DestroyResource(resourceId);
+		metaEntry.metaTimestamp = metaTimestamp;
+		metaEntry.assetTimestamp = assetTimestamp;
+		metaEntry.metaHash = metaHash;
+	}
+
+	// Check for deleted resources
+	if (!App->files->Exists(resourceFilePath.c_str())) {
+		if (std::find(assetsToImport.begin(), assetsToImport.end(), assetFilePath) == assetsToImport.end()) {
+			assetsToImport.push_back(assetFilePath);
 		}
-		for (const std::string& assetFilePath : assetsToImport) {
-			ImportAssetResources(assetFilePath.c_str());
+	}
+}
+
+void ModuleResources::RemoveResources(const std::vector<UID>& resourcesToRemove, const std::vector<std::string>& assetsToImport) {
+	for (UID resourceId : resourcesToRemove) {
+		concurrentResourcesMutex.lock();
+		std::string assetFilePath = concurrentResourceUIDToAssetFilePath.at(resourceId);
+		concurrentResourcesMutex.unlock();
+		const std::string& resourceFilePath = GenerateResourcePath(resourceId);
+		std::string metaFilePath = assetFilePath + META_EXTENSION;
+		if (App->files->Exists(metaFilePath.c_str()) && std::find(assetsToImport.begin(), assetsToImport.end(), assetFilePath) == assetsToImport.end()) {
+			App->files->Erase(metaFilePath.c_str());
 		}
-		while (!assetsToReimport.empty()) {
-			std::string assetFilePath = "";
-			assetsToReimport.try_pop(assetFilePath);
-			ImportAssetResources(assetFilePath.c_str(), true);
+		if (App->files->Exists(resourceFilePath.c_str())) {
+			App->files->Erase(resourceFilePath.c_str());
 		}
 
-		// Check if there are any new assets and build cached folder structure
-		AssetCache* newAssetCache = new AssetCache(ASSETS_PATH);
-		CheckForNewAssetsRecursive(ASSETS_PATH, *newAssetCache, newAssetCache->root);
-
-		TesseractEvent updateAssetCacheEv(TesseractEventType::UPDATE_ASSET_CACHE);
-		updateAssetCacheEv.Set<UpdateAssetCacheStruct>(newAssetCache);
-		App->events->AddEvent(updateAssetCacheEv);
-#endif
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(TIME_BETWEEN_RESOURCE_UPDATES_MS));
+		DestroyResource(resourceId);
 	}
 }
 
-void ModuleResources::CheckForNewAssetsRecursive(const char* path, AssetCache& assetCache, AssetFolder& parentFolder) {
+void ModuleResources::CheckForNewAssetsRecursive(const char* path, AssetCacheDiff& diff, std::vector<std::string>& assetFilePaths) {
 	for (std::string& file : App->files->GetFilesInFolder(path)) {
 		std::string filePath = std::string(path) + "/" + file;
 		std::string extension = FileDialog::GetFileExtension(file.c_str());
 		if (App->files->IsDirectory(filePath.c_str())) {
-			parentFolder.folders.push_back(AssetFolder(filePath.c_str()));
-			assetCache.foldersMap[filePath] = &parentFolder.folders.back();
-			CheckForNewAssetsRecursive(filePath.c_str(), assetCache, parentFolder.folders.back());
+			diff.addedFolders.push_back(filePath);
+			CheckForNewAssetsRecursive(filePath.c_str(), diff, assetFilePaths);
 		} else if (extension != META_EXTENSION) {
-			std::list<UID>& resourceIds = ImportAssetResources(filePath.c_str());
-			if (!resourceIds.empty()) {
-				AssetFile assetFile(filePath.c_str());
-				assetFile.resourceIds = std::move(resourceIds);
-				parentFolder.files.push_back(std::move(assetFile));
-				assetCache.filesMap[filePath] = &parentFolder.files.back();
-			}
+			assetFilePaths.push_back(filePath);
 		}
 	}
 }
 
+void ModuleResources::AddImportedAssetsToDiff(const std::vector<std::string>& assetFilePaths, std::vector<std::list<UID>>& resourceIds, AssetCacheDiff& diff) {
+	for (unsigned i = 0; i < assetFilePaths.size(); ++i) {
+		const std::string& assetFilePath = assetFilePaths[i];
+		if (!resourceIds[i].empty()) {
+			AssetFile assetFile(assetFilePath.c_str());
+			assetFile.resourceIds = std::move(resourceIds[i]);
+			diff.addedFiles.push_back(std::move(assetFile));
+		} else if (importAssetCache != nullptr && importAssetCache->filesMap.find(assetFilePath) != importAssetCache->filesMap.end()) {
+			diff.removedFiles.push_back(assetFilePath);
+		}
+	}
+}
+
+void ModuleResources::SendAssetCacheDiff(AssetCacheDiff* diff) {
+	if (diff->IsEmpty()) {
+		RELEASE(diff);
+		return;
+	}
+
+	importAssetCache->ApplyDiff(*diff);
+
+	TesseractEvent updateAssetCacheDiffEv(TesseractEventType::UPDATE_ASSET_CACHE_DIFF);
+	updateAssetCacheDiffEv.Set<UpdateAssetCacheDiffStruct>(diff);
+	App->events->AddEvent(std::move(updateAssetCacheDiffEv));
+}
+
 void ModuleResources::ImportLibrary() {
 	for (std::string& libraryFile : App->files->GetFilesInFolder(LIBRARY_PATH)) {
 		std::string libraryFilePath = std::string(LIBRARY_PATH "/") + libraryFile;
@@ -488,19 +748,55 @@ void ModuleResources::ImportLibraryResource(const char* filePath) {
 	UID id = SDL_strtoull(fileName.c_str(), nullptr, 10);
 
 	Resource* resource = CreateResourceByType(type, resourceName.c_str(), "", id);
-	resources[id].reset(resource);
+	AddResource(resource);
 
 	if (GetReferenceCount(id) > 0) {
 		LoadResource(resource);
 	}
 }
 
+void ModuleResources::AddResource(Resource* resource) {
+	UID id = resource->GetId();
+
+	resourcesMutex.lock();
+	auto handleIt = resourceHandles.find(id);
+	if (handleIt != resourceHandles.end()) {
+		resourceTable.Remove(handleIt->second);
+	}
+	resources[id].reset(resource);
+	resourceHandles[id] = resourceTable.Add(resource);
+	resourcesMutex.unlock();
+}
+
+std::unique_ptr<Resource> ModuleResources::RemoveResource(UID id) {
+	std::unique_ptr<Resource> resource = nullptr;
+
+	resourcesMutex.lock();
+	auto handleIt = resourceHandles.find(id);
+	if (handleIt != resourceHandles.end()) {
+		resourceTable.Remove(handleIt->second);
+		resourceHandles.erase(handleIt);
+	}
+	auto it = resources.find(id);
+	if (it != resources.end()) {
+		resource.swap(it->second);
+		resources.erase(it);
+	}
+	resourcesMutex.unlock();
+
+	return resource;
+}
+
 void ModuleResources::SendCreateResourceEventByType(ResourceType type, const char* resourceName, const char* assetFilePath, UID id) {
+	if (IsImportIsolated()) return;
+
+	concurrentResourcesMutex.lock();
 	concurrentResourceUIDToAssetFilePath[id] = assetFilePath;
+	concurrentResourcesMutex.unlock();
 
 	TesseractEvent addResourceEvent(TesseractEventType::CREATE_RESOURCE);
 	addResourceEvent.Set<CreateResourceStruct>(type, id, resourceName, assetFilePath);
-	App->events->AddEvent(addResourceEvent);
+	App->events->AddEvent(std::move(addResourceEvent));
 }
 
 Resource* ModuleResources::CreateResourceByType(ResourceType type, const char* resourceName, const char* assetFilePath, UID id) {
@@ -561,11 +857,13 @@ Resource* ModuleResources::CreateResourceByType(ResourceType type, const char* r
 }
 
 void ModuleResources::DestroyResource(UID id) {
+	concurrentResourcesMutex.lock();
 	concurrentResourceUIDToAssetFilePath.erase(id);
+	concurrentResourcesMutex.unlock();
 
 	TesseractEvent destroyResourceEvent(TesseractEventType::DESTROY_RESOURCE);
 	destroyResourceEvent.Set<DestroyResourceStruct>(id);
-	App->events->AddEvent(destroyResourceEvent);
+	App->events->AddEvent(std::move(destroyResourceEvent));
 }
 
 void ModuleResources::LoadResource(Resource* resource) {
@@ -576,7 +874,7 @@ void ModuleResources::LoadResource(Resource* resource) {
 	std::string resourceMetaFile = resource->GetResourceFilePath() + META_EXTENSION;
 	Buffer<char> buffer = App->files->Load(resourceMetaFile.c_str());
 	if (buffer.Size() == 0) {
-		LOG("Error loading meta file path %s", resourceMetaFile);
+		LOG("Error loading meta file path %s", resourceMetaFile.c_str());
 		resourceMetaLoaded = false;
 	}
 
@@ -6,11 +6,16 @@
 #include "ModuleEvents.h"
 #include "Utils/UID.h"
 #include "Utils/AssetCache.h"
+#include "Utils/ResourceTable.h"
+#include "Utils/FileWatcher.h"
+#include "FileSystem/ImportPipeline.h"
 #include "Resources/Resource.h"
+#include "Resources/ResourceHandle.h"
 #include "FileSystem/JsonValue.h"
 #include "FileSystem/ImportOptions.h"
 #include "TesseractEvent.h"
 
+#include <concurrent_queue.h>
 #include <string>
 #include <list>
 #include <vector>
@@ -19,6 +24,19 @@
 #include <unordered_map>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+struct AssetMetaEntry {
+	long long assetTimestamp = 0;
+	long long metaTimestamp = 0;
+	unsigned long long metaHash = 0;
+};
+
+/* The import thread watches the assets folder, and only checks the assets that changed. The asset cache is
+*  updated with diffs of the changed files and folders. The whole folder is scanned when the thread starts,
+*  when the notifications of the watcher were lost or aren't available, and every TIME_BETWEEN_FULL_ASSET_SCANS_MS.
+*/
 
 class ModuleResources : public Module {
 public:
@@ -28,10 +46,15 @@ public:
 	bool CleanUp() override;
 	void ReceiveEvent(TesseractEvent& e) override;
 
-	std::list<UID> ImportAssetResources(const char* filePath, bool force = false);
+	std::list<UID> ImportAssetResources(const char* filePath, bool force = false, const ImportIsolation* isolation = nullptr); // Can be called from any thread. Forced imports are skipped if the asset and its import options haven't changed. Nested imports keep the isolation of the outer one
+	void ImportAssets(const std::vector<std::string>& filePaths, std::vector<std::list<UID>>& resourceIds, bool force = false, bool parallel = true, const ImportIsolation* isolation = nullptr);
+	bool IsImportIsolated() const; // True while the calling thread imports an asset with an ImportIsolation
+	unsigned GetImportThreadCount() const;
 
 	template<typename T> T* GetImportOptions(const char* filePath, bool forceLoad = false);
 	template<typename T> T* GetResource(UID id);
+	template<typename T> T* GetResource(UID id, ResourceHandle& handle); // Lock-free lookup through a cached handle. The handle is re-resolved only when it's stale.
+	ResourceHandle GetResourceHandle(UID id);
 	AssetCache* GetAssetCache() const;
 
 	void IncreaseReferenceCount(UID id);
@@ -50,7 +73,16 @@ private:
 	void UpdateAsync();
 	void ImportLibrary();
 
-	void CheckForNewAssetsRecursive(const char* path, AssetCache& assetCache, AssetFolder& parentFolder);
+	void ScanAssets(const std::vector<std::string>& reimportedAssets); // Checks every resource and rebuilds the asset cache
+	void UpdateChangedAssets(const std::vector<FileChange>& changes, const std::vector<std::string>& reimportedAssets);
+	void CheckResource(UID resourceId, const std::string& assetFilePath, std::vector<UID>& resourcesToRemove, std::vector<std::string>& assetsToImport);
+	void RemoveResources(const std::vector<UID>& resourcesToRemove, const std::vector<std::string>& assetsToImport);
+	void CheckForNewAssetsRecursive(const char* path, AssetCacheDiff& diff, std::vector<std::string>& assetFilePaths); // Adds the folders to the diff and the files to assetFilePaths
+	void AddImportedAssetsToDiff(const std::vector<std::string>& assetFilePaths, std::vector<std::list<UID>>& resourceIds, AssetCacheDiff& diff);
+	void SendAssetCacheDiff(AssetCacheDiff* diff);
+
+	void AddResource(Resource* resource);
+	std::unique_ptr<Resource> RemoveResource(UID id);
 
 	void SendCreateResourceEventByType(ResourceType type, const char* resourceName, const char* assetFilePath, UID id);
 	Resource* CreateResourceByType(ResourceType type, const char* resourceName, const char* assetFilePath, UID id);
@@ -65,21 +97,39 @@ private:
 
 public:
 	concurrency::concurrent_queue<std::string> assetsToReimport;
+	std::mutex imageLibraryMutex;					// DevIL keeps its state in globals, so only one thread can use it at a time
+	std::atomic<bool> skipUnchangedImports {true}; // Disabled by the import benchmark to import the same assets several times
 
 private:
 	std::mutex resourcesMutex;
 	std::unordered_map<std::string, std::unique_ptr<ImportOptions>> assetImportOptions;
 	std::unordered_map<UID, std::unique_ptr<Resource>> resources;
+	std::unordered_map<UID, ResourceHandle> resourceHandles;
+	ResourceTable resourceTable; // Only written from the main thread. Read without locking from the render path.
 	std::unordered_map<UID, unsigned> referenceCounts;
 	std::unique_ptr<AssetCache> assetCache;
 
 	std::thread importThread;
 	bool stopImportThread = false;
 	std::unordered_map<UID, std::string> concurrentResourceUIDToAssetFilePath;
+	std::mutex concurrentResourcesMutex; // The import workers add entries to concurrentResourceUIDToAssetFilePath
+	std::mutex importOptionsMutex;
+
+	// Imports run in parallel, so an asset that is being imported makes the other imports of the same asset wait
+	ImportPipeline importPipeline;
+	std::mutex importingAssetsMutex;
+	std::condition_variable assetImportFinished;
+	std::unordered_set<std::string> importingAssets;
+
+	// Only accessed from the import thread
+	FileWatcher assetWatcher;
+	std::unique_ptr<AssetCache> importAssetCache;					// Asset cache with the diffs already sent to the main thread applied
+	std::unordered_map<std::string, AssetMetaEntry> assetMetaCache; // State of the meta file of each asset when it was last read
 };
 
 template<typename T>
 inline T* ModuleResources::GetImportOptions(const char* filePath, bool forceLoad) {
+	std::lock_guard<std::mutex> lock(importOptionsMutex);
 	auto it = assetImportOptions.find(filePath);
 	if (forceLoad || it == assetImportOptions.end()) {
 		std::unique_ptr<ImportOptions>& importOptions = assetImportOptions[filePath];
@@ -99,6 +149,23 @@ inline T* ModuleResources::GetResource(UID id) {
 	return resource;
 }
 
+template<typename T>
+inline T* ModuleResources::GetResource(UID id, ResourceHandle& handle) {
+	if (id == 0) return nullptr;
+
+	Resource* resource = resourceTable.Get(handle, id);
+	if (resource == nullptr) {
+		// Ids that couldn't be found are only looked up again once a resource has been added
+		unsigned version = resourceTable.GetVersion();
+		if (handle.missingVersion == version) return nullptr;
+
+		handle = GetResourceHandle(id);
+		resource = resourceTable.Get(handle, id);
+		if (resource == nullptr) handle.missingVersion = version;
+	}
+	return static_cast<T*>(resource);
+}
+
 template<typename T>
 inline std::unique_ptr<T> ModuleResources::CreateResource(const char* resourceName, const char* assetFilePath, UID id) {
 	return std::unique_ptr<T>(static_cast<T*>(CreateResourceByType(T::staticType, resourceName, assetFilePath, id)));
@@ -106,9 +173,13 @@ inline std::unique_ptr<T> ModuleResources::CreateResource(const char* resourceNa
 
 template<typename T>
 inline void ModuleResources::SendCreateResourceEvent(std::unique_ptr<T>& resource) {
+	if (IsImportIsolated()) return;
+
+	concurrentResourcesMutex.lock();
 	concurrentResourceUIDToAssetFilePath[resource->GetId()] = resource->GetAssetFilePath();
+	concurrentResourcesMutex.unlock();
 
 	TesseractEvent addResourceEvent(TesseractEventType::CREATE_RESOURCE);
 	addResourceEvent.Set<CreateResourceStruct>(T::staticType, resource->GetId(), resource->GetName().c_str(), resource->GetAssetFilePath().c_str());
-	App->events->AddEvent(addResourceEvent);
+	App->events->AddEvent(std::move(addResourceEvent));
 }
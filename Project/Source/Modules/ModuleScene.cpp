@@ -15,6 +15,7 @@
 #include "Components/ComponentBoundingBox.h"
 #include "Components/ComponentCamera.h"
 #include "Components/ComponentScript.h"
+#include "Components/ComponentParticleSystem.h"
 #include "Components/UI/ComponentCanvas.h"
 #include "Components/UI/ComponentCanvasRenderer.h"
 #include "Components/UI/ComponentTransform2D.h"
@@ -31,6 +32,7 @@
 #include "Modules/ModuleUserInterface.h"
 #include "Modules/ModuleEvents.h"
 #include "Modules/ModuleTime.h"
+#include "Modules/ModuleJobs.h"
 #include "Resources/ResourceTexture.h"
 #include "Resources/ResourceSkybox.h"
 #include "Resources/ResourceScene.h"
@@ -112,12 +114,26 @@ bool ModuleScene::Start() {
 	return true;
 }
 
+UpdateStatus ModuleScene::FixedUpdate() {
+	BROFILER_CATEGORY("ModuleScene - FixedUpdate", Profiler::Color::Green)
+
+	scene->root->FixedUpdate();
+
+	return UpdateStatus::CONTINUE;
+}
+
 UpdateStatus ModuleScene::Update() {
 	BROFILER_CATEGORY("ModuleScene - Update", Profiler::Color::Green)
 
+	// Frame stages: the particle simulations only touch their own emitter, so they run in parallel before the scripts
+	SimulateParticles();
+
 	// Update GameObjects
 	scene->root->Update();
 
+	// World matrices of everything that moved in this frame, in one sweep before they are rendered
+	scene->UpdateTransforms();
+
 	return UpdateStatus::CONTINUE;
 }
 
@@ -166,6 +182,26 @@ UpdateStatus ModuleScene::PostUpdate() {
 	return UpdateStatus::CONTINUE;
 }
 
+void ModuleScene::SimulateParticles() {
+	BROFILER_CATEGORY("ModuleScene - SimulateParticles", Profiler::Color::Green)
+
+	// Linking the pending transforms first makes sure that resolving the matrix of an emitter can't invalidate another one
+	scene->transformHierarchy.SortByDepth();
+
+	simulatedEmitters.clear();
+	for (ComponentParticleSystem& particleSystem : scene->particleComponents) {
+		if (particleSystem.GetOwner().IsActive() && particleSystem.BeginSimulation()) {
+			simulatedEmitters.push_back(&particleSystem);
+		}
+	}
+
+	App->jobs->ParallelFor("Particle simulation", (unsigned) simulatedEmitters.size(), 1, [this](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i) {
+			simulatedEmitters[i]->SimulateParticles();
+		}
+	});
+}
+
 bool ModuleScene::CleanUp() {
 	RELEASE(scene);
 
@@ -270,5 +306,5 @@ void ModuleScene::DestroyGameObjectDeferred(GameObject* gameObject) {
 	TesseractEvent e(TesseractEventType::GAMEOBJECT_DESTROYED);
 	e.Set<DestroyGameObjectStruct>(gameObject->scene, gameObject);
 
-	App->events->AddEvent(e);
+	App->events->AddEvent(std::move(e));
 }
\ No newline at end of file
@@ -1,18 +1,22 @@
 #pragma once
 
+#include "Globals.h"
 #include "Modules/Module.h"
 #include "Utils/UID.h"
 
 #include <string>
+#include <vector>
 
 class Scene;
 class GameObject;
+class ComponentParticleSystem;
 
 class ModuleScene : public Module {
 public:
 	// ------- Core Functions ------ //
 	bool Init() override;
 	bool Start() override;
+	UpdateStatus FixedUpdate() override;
 	UpdateStatus Update() override;
 	UpdateStatus PostUpdate() override;
 	bool CleanUp() override;
@@ -32,9 +36,14 @@ public:
 
 	UID startSceneId = 0; // First scene to be loaded when in GAME configuration
 
+	int scenePoolHeadroom = SCENE_POOL_HEADROOM; // Free slots left in each pool of a binary scene, for what is created at runtime. The pools can't grow once the scene is loaded
+
 	//Temporary hardcoded solution
 	bool godModeOn = false;
 
+private:
+	void SimulateParticles(); // Updates the particles of every playing emitter in parallel, before the GameObjects
+
 private:
 	bool shouldLoadScene = false;
 	std::string sceneToLoadPath = "";
@@ -45,4 +54,6 @@ private:
 	bool shouldBuildPrefab = false;
 	UID buildingPrefabId = 0;
 	UID buildingPrefabParentId = 0;
+
+	std::vector<ComponentParticleSystem*> simulatedEmitters;
 };
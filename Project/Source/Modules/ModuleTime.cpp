@@ -15,6 +15,7 @@
 #include "Modules/ModulePhysics.h"
 #include "Scene.h"
 
+#include "Math/MathFunc.h"
 #include "SDL_timer.h"
 #include <ctime>
 
@@ -51,18 +52,29 @@ UpdateStatus ModuleTime::PreUpdate() {
 		lastAutoSave = realTime;
 	}
 
+	bool steppingOnce = false;
 	if (gameRunning) {
 		timeDeltaMs = lroundf(realTimeDeltaMs * timeScale);
 		timeLastMs += timeDeltaMs;
+		fixedTimeAccumulatorMs += realTimeDeltaMs * timeScale;
 	} else if (gameStepOnce) {
 		timeDeltaMs = stepDeltaTimeMs;
 		timeLastMs += timeDeltaMs;
+		fixedTimeAccumulatorMs += (float) stepDeltaTimeMs;
 
 		gameStepOnce = false;
+		steppingOnce = true;
 	} else {
 		timeDeltaMs = 0;
 	}
 
+	// Consume the accumulated game time in fixed steps. A step of the paused game isn't a slow frame, so all of stepDeltaTimeMs is simulated
+	float fixedDeltaTimeMs = GetFixedDeltaTime() * 1000.0f;
+	unsigned int availableSteps = (unsigned int) (fixedTimeAccumulatorMs / fixedDeltaTimeMs);
+	fixedStepsThisFrame = steppingOnce ? availableSteps : Min(availableSteps, (unsigned int) Max(maxFixedStepsPerFrame, 1));
+	fixedTimeAccumulatorMs -= availableSteps * fixedDeltaTimeMs;
+	droppedFixedSteps += availableSteps - fixedStepsThisFrame;
+
 	logger->LogDeltaMS((float) realTimeDeltaMs);
 
 	return UpdateStatus::CONTINUE;
@@ -122,6 +134,9 @@ void ModuleTime::ResetDeltaTime() {
 	} else {
 		timeDeltaMs = 0;
 	}
+
+	// The time spent loading isn't simulated
+	fixedTimeAccumulatorMs = 0.0f;
 }
 
 bool ModuleTime::HasGameStarted() const {
@@ -133,6 +148,8 @@ bool ModuleTime::IsGameRunning() const {
 }
 
 float ModuleTime::GetDeltaTime() const {
+	if (inFixedStep) return GetFixedDeltaTime();
+
 	return timeDeltaMs / 1000.0f;
 }
 
@@ -172,6 +189,34 @@ float ModuleTime::GetDeltaTimeOrRealDeltaTime() const {
 	}
 }
 
+float ModuleTime::GetFixedDeltaTime() const {
+	return 1.0f / Max(fixedUpdateRate, 1);
+}
+
+unsigned ModuleTime::GetFixedStepsThisFrame() const {
+	return fixedStepsThisFrame;
+}
+
+float ModuleTime::GetFixedStepAlpha() const {
+	return Clamp01(fixedTimeAccumulatorMs / (GetFixedDeltaTime() * 1000.0f));
+}
+
+bool ModuleTime::IsInFixedStep() const {
+	return inFixedStep;
+}
+
+void ModuleTime::BeginFixedStep() {
+	inFixedStep = true;
+}
+
+void ModuleTime::EndFixedStep() {
+	inFixedStep = false;
+}
+
+unsigned ModuleTime::GetDroppedFixedSteps() const {
+	return droppedFixedSteps;
+}
+
 void ModuleTime::StartGame() {
 	if (gameStarted) return;
 
@@ -193,6 +238,8 @@ void ModuleTime::StopGame() {
 	gameStarted = false;
 	gameRunning = false;
 	timeLastMs = 0;
+	fixedTimeAccumulatorMs = 0.0f;
+	fixedStepsThisFrame = 0;
 
 	App->project->GetGameState()->Clear();
 
@@ -33,6 +33,17 @@ public:
 
 	float GetDeltaTimeOrRealDeltaTime() const;
 
+	// --- Fixed Step --- //
+	// Game time is split in fixed steps of 1/fixedUpdateRate seconds, and the modules get one FixedUpdate for each step that was completed this frame.
+	// The time left over is carried to the next frame, and the fixed step alpha tells how far the frame is between the last two steps, to interpolate what is rendered.
+	TESSERACT_ENGINE_API float GetFixedDeltaTime() const;
+	unsigned GetFixedStepsThisFrame() const;
+	TESSERACT_ENGINE_API float GetFixedStepAlpha() const;
+	bool IsInFixedStep() const;
+	void BeginFixedStep(); // While in a fixed step, GetDeltaTime returns the fixed delta time
+	void EndFixedStep();
+	unsigned GetDroppedFixedSteps() const;
+
 	// --- Game Time Controllers --- //
 	// This functions control the flow of the time in-game by setting the Game Time Flags (see below).
 	// They are also in charge to serialise and load the scene on play, pause and stops.
@@ -52,6 +63,9 @@ public:
 	int stepDeltaTimeMs = 100;	// When calling StepGame(), the game will advance one frame, with a specific time increment of 'stepDeltaTimeMs'.
 	float timeScale = 1.0f;		// Multiplier of Game Time. 1=normal time, <1=slow motion, >1=accelerated
 
+	int fixedUpdateRate = 60;	   // Fixed steps per second of game time.
+	int maxFixedStepsPerFrame = 5; // Limits the steps a slow frame can take to catch up. The rest of the time is dropped, or each slow frame would make the next one slower. StepGame() isn't limited.
+
 private:
 	MSTimer timer = MSTimer(); // Real time Timer that is the base of every time calculation.
 
@@ -63,6 +77,11 @@ private:
 
 	unsigned int lastAutoSave = 0; // Last moment in time the scene was saved automatically.
 
+	float fixedTimeAccumulatorMs = 0.0f;  // Game time that hasn't been simulated by a fixed step yet. Not rounded, unlike timeDeltaMs.
+	unsigned int fixedStepsThisFrame = 0; // Fixed steps to run this frame.
+	unsigned int droppedFixedSteps = 0;	  // Total fixed steps that were skipped because of maxFixedStepsPerFrame.
+	bool inFixedStep = false;
+
 	// ------ Game Time Flags ------ //
 	bool gameStarted = false;
 	bool gameRunning = false;
@@ -7,6 +7,8 @@
 #include "Modules/ModuleTime.h"
 #include "Modules/ModuleInput.h"
 #include "Modules/ModuleScene.h"
+#include "Modules/ModuleCamera.h"
+#include "Modules/ModuleRender.h"
 #include "Components/UI/ComponentCanvas.h"
 #include "Components/UI/ComponentCanvasRenderer.h"
 #include "Components/UI/ComponentSelectable.h"
@@ -21,6 +23,7 @@
 
 #include "Geometry/LineSegment.h"
 #include "GL/glew.h"
+#include <algorithm>
 
 #include "Utils/Leaks.h"
 
@@ -33,6 +36,7 @@ bool ModuleUserInterface::Init() {
 
 bool ModuleUserInterface::Start() {
 	CreateQuadVBO();
+	batch.Init();
 	App->events->AddObserverToEvent(TesseractEventType::SCREEN_RESIZED, this);
 	App->events->AddObserverToEvent(TesseractEventType::MOUSE_CLICKED, this);
 	App->events->AddObserverToEvent(TesseractEventType::MOUSE_RELEASED, this);
@@ -147,6 +151,7 @@ UpdateStatus ModuleUserInterface::PostUpdate() {
 }
 
 bool ModuleUserInterface::CleanUp() {
+	batch.CleanUp();
 	glDeleteBuffers(1, &quadVBO);
 	return true;
 }
@@ -214,12 +219,22 @@ void ModuleUserInterface::GetCharactersInString(UID font, const std::string& sen
 	}
 }
 
+// Indices of the object and its ancestors in the children of their parents, from the root. Sorting by them gives the hierarchy order
+static void GetHierarchyPath(const GameObject* obj, std::vector<unsigned>& path) {
+	path.clear();
+	for (const GameObject* parent = obj->GetParent(); parent != nullptr; obj = parent, parent = parent->GetParent()) {
+		const std::vector<GameObject*>& children = parent->GetChildren();
+		path.push_back((unsigned) (std::find(children.begin(), children.end(), obj) - children.begin()));
+	}
+	std::reverse(path.begin(), path.end());
+}
+
 void ModuleUserInterface::RecursiveRender(const GameObject* obj) {
 	ComponentCanvasRenderer* renderer = obj->GetComponent<ComponentCanvasRenderer>();
 
 	if (obj->IsActive()) {
 		if (renderer && renderer->IsActive()) {
-			renderer->Render(obj);
+			renderer->Render(obj, batch);
 		}
 
 		for (const GameObject* child : obj->GetChildren()) {
@@ -230,9 +245,38 @@ void ModuleUserInterface::RecursiveRender(const GameObject* obj) {
 
 void ModuleUserInterface::Render() {
 	Scene* scene = App->scene->scene;
-	if (scene != nullptr) {
-		RecursiveRender(scene->root);
+	if (scene == nullptr) return;
+
+	// Only the subtrees of the outermost canvases are walked, in the order of the hierarchy
+	rootCanvases.clear();
+	for (ComponentCanvas& canvas : scene->canvasComponents) {
+		GameObject& owner = canvas.GetOwner();
+		if (!owner.IsActive()) continue;
+		if (owner.GetParent() != nullptr && owner.HasComponentInAnyParent<ComponentCanvas>(owner.GetParent()) != nullptr) continue;
+
+		CanvasPath canvasPath;
+		canvasPath.gameObject = &owner;
+		GetHierarchyPath(&owner, canvasPath.path);
+		rootCanvases.push_back(canvasPath);
+	}
+	std::sort(rootCanvases.begin(), rootCanvases.end(), [](const CanvasPath& a, const CanvasPath& b) { return a.path < b.path; });
+
+	float4x4 proj = App->camera->GetProjectionMatrix();
+	float4x4 view = App->camera->GetViewMatrix();
+	if (IsUsing2D()) {
+		proj = float4x4::D3DOrthoProjLH(-1, 1, App->renderer->GetViewportSize().x, App->renderer->GetViewportSize().y); //near plane. far plane, screen width, screen height
+		view = float4x4::identity;
 	}
+
+	batch.Begin(view, proj);
+	for (const CanvasPath& canvasPath : rootCanvases) {
+		RecursiveRender(canvasPath.gameObject);
+	}
+	batch.End();
+}
+
+unsigned ModuleUserInterface::GetDrawCalls() const {
+	return batch.GetDrawCount();
 }
 
 unsigned int ModuleUserInterface::GetQuadVBO() {
@@ -2,8 +2,11 @@
 
 #include "Module.h"
 #include "Utils/UID.h"
+#include "Rendering/UIBatch.h"
 #include "Math/float4.h"
 
+#include <vector>
+
 #define SCENE_SCREEN_FACTOR 0.01f
 
 class GameObject;
@@ -22,8 +25,8 @@ public:
 
 	Character GetCharacter(UID font, char c);																	// Returns the Character that matches the given one in the given font or null otherwise.
 	void GetCharactersInString(UID font, const std::string& sentence, std::vector<Character>& charsInSentence); // Fills the given vector with the glyphs of the given font to form the given sentence.
-	void Render();																								// Calls every ComponentCanvasRenderer Render function if the parent is active in hierarchy
-	void RecursiveRender(const GameObject* obj);
+	void Render();																								// Batches the ComponentCanvasRenderers under the active canvases and draws them
+	unsigned GetDrawCalls() const;																				// Draw calls of the last Render
 	void SetCurrentEventSystem(UID id_);		   // Sets the new event system
 	ComponentEventSystem* GetCurrentEventSystem(); // Returns the Module's Event System. If the UID is 0, returns nullptr
 
@@ -40,11 +43,20 @@ private:
 	void CreateQuadVBO();	  // Creates a vbo made by two triangles centered that form a Quad
 	void OnViewportResized(); // Sets all bool dirty required to recalculate ScreenFactors
 	void ManageInputsOnSelected(ComponentSelectable* currentlySelected);
+	void RecursiveRender(const GameObject* obj); // Calls every ComponentCanvasRenderer Render function if the parent is active in hierarchy
 
 private:
+	struct CanvasPath {
+		GameObject* gameObject = nullptr;
+		std::vector<unsigned> path; // Position in the hierarchy, used to draw the canvases in order
+	};
+
 	UID currentEvSys = 0;						// Module's Event System UID
 	unsigned int quadVBO = 0;					// VBO of the ComponentImage generic Quad
 	float4 errorColor = float4(-1, -1, -1, -1); // Representation of error in color (not a color to display)
 	bool viewportWasResized = false;
 	bool wasPressConfirmed = false;
+
+	UIBatch batch;						 // Quads of all the canvases, drawn in a few calls
+	std::vector<CanvasPath> rootCanvases; // Canvases without a parent canvas
 };
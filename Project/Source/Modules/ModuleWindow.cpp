@@ -120,7 +120,7 @@ void ModuleWindow::SetSize(int width, int height) {
 	SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED_DISPLAY(displayIndex), SDL_WINDOWPOS_CENTERED_DISPLAY(displayIndex));
 	TesseractEvent resizeEvent(TesseractEventType::SCREEN_RESIZED);
 	resizeEvent.Set<ViewportResizedStruct>(width, height);
-	App->events->AddEvent(resizeEvent);
+	App->events->AddEvent(std::move(resizeEvent));
 }
 
 void ModuleWindow::ResetToDefaultSize() {
@@ -432,9 +432,10 @@ NavMesh::~NavMesh() {
 bool NavMesh::Build(Scene* scene) {
 	CleanUp();
 
-	std::vector<float> verts = scene->GetVertices();
-	std::vector<int> tris = scene->GetTriangles();
-	std::vector<float> normals = scene->GetNormals();
+	std::vector<float> verts;
+	std::vector<int> tris;
+	std::vector<float> normals;
+	scene->GetStaticGeometry(verts, tris, normals);
 
 	unsigned ntris = tris.size() / 3;
 
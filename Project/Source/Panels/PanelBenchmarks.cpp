@@ -0,0 +1,49 @@
+#include "PanelBenchmarks.h"
+
+#include "Application.h"
+#include "Modules/ModuleEditor.h"
+#include "Utils/Benchmarks.h"
+#include "Utils/Logging.h"
+
+#include "imgui.h"
+#include "IconsForkAwesome.h"
+
+#include "Utils/Leaks.h"
+
+PanelBenchmarks::PanelBenchmarks()
+	: Panel("Benchmarks", false) {
+	benchmarks.push_back({"Resource lookup", Benchmarks::ResourceLookup});
+	benchmarks.push_back({"Particle rendering", Benchmarks::ParticleRendering});
+	benchmarks.push_back({"Particle update", Benchmarks::ParticleUpdate});
+	benchmarks.push_back({"Raycast", Benchmarks::Raycast});
+	benchmarks.push_back({"Frustum culling", Benchmarks::FrustumCulling});
+	benchmarks.push_back({"Prefab spawn", Benchmarks::PrefabSpawn});
+	benchmarks.push_back({"Logging throughput", Benchmarks::LoggingThroughput});
+	benchmarks.push_back({"Asset import", Benchmarks::AssetImport});
+	benchmarks.push_back({"Physics stepping", Benchmarks::PhysicsStepping});
+	benchmarks.push_back({"Job scaling", Benchmarks::JobScaling});
+	benchmarks.push_back({"Transform update", Benchmarks::TransformUpdate});
+	benchmarks.push_back({"Scene load", Benchmarks::SceneLoad});
+}
+
+void PanelBenchmarks::Update() {
+	ImGui::SetNextWindowSize(ImVec2(400.0f, 300.0f), ImGuiCond_FirstUseEver);
+	std::string windowName = std::string(ICON_FK_CLOCK_O " ") + name;
+	if (ImGui::Begin(windowName.c_str(), &enabled)) {
+		ImGui::TextWrapped("Benchmarks block the main thread while they run. Run them with the scene stopped.");
+		for (Benchmark& benchmark : benchmarks) {
+			ImGui::PushID(benchmark.name);
+			ImGui::Separator();
+			ImGui::TextColored(App->editor->titleColor, "%s", benchmark.name);
+			if (ImGui::Button("Run")) {
+				benchmark.report = benchmark.run();
+				LOG("Benchmark '%s':\n%s", benchmark.name, benchmark.report.c_str());
+			}
+			if (!benchmark.report.empty()) {
+				ImGui::TextUnformatted(benchmark.report.c_str());
+			}
+			ImGui::PopID();
+		}
+	}
+	ImGui::End();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Panel.h"
+
+#include <string>
+#include <vector>
+
+class PanelBenchmarks : public Panel {
+public:
+	PanelBenchmarks();
+
+	void Update() override;
+
+private:
+	struct Benchmark {
+		const char* name = nullptr;
+		std::string (*run)() = nullptr;
+		std::string report = "";
+	};
+
+	std::vector<Benchmark> benchmarks;
+};
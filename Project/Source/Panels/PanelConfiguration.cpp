@@ -13,6 +13,8 @@
 #include "Modules/ModulePhysics.h"
 #include "Modules/ModuleAudio.h"
 #include "Modules/ModuleConfiguration.h"
+#include "Modules/ModuleEvents.h"
+#include "Modules/ModuleJobs.h"
 #include "Resources/ResourceScene.h"
 #include "Resources/ResourceNavMesh.h"
 #include "Resources/ResourceTexture.h"
@@ -54,6 +56,7 @@ void PanelConfiguration::Update() {
 			ImGui::InputText("Organization", App->organization, IM_ARRAYSIZE(App->organization));
 			ImGui::TextColored(App->editor->titleColor, "Start scene");
 			ImGui::ResourceSlot<ResourceScene>("Scene", &App->scene->startSceneId);
+			ImGui::SliderInt("Scene pool headroom", &App->scene->scenePoolHeadroom, 1, MAX_SCENE_COMPONENTS);
 		}
 
 		// Time
@@ -65,6 +68,9 @@ void PanelConfiguration::Update() {
 			}
 			ImGui::SliderInt("Step delta time (MS)", &App->time->stepDeltaTimeMs, 1, 1000);
 			ImGui::SliderFloat("TimeScale", &App->time->timeScale, 0.f, 4.f);
+			ImGui::SliderInt("Fixed update rate (Hz)", &App->time->fixedUpdateRate, 10, 240);
+			ImGui::SliderInt("Max fixed steps per frame", &App->time->maxFixedStepsPerFrame, 1, 20);
+			ImGui::Text("Fixed steps this frame: %u (dropped: %u)", App->time->GetFixedStepsThisFrame(), App->time->GetDroppedFixedSteps());
 
 			// FPS Graph
 			char title[25];
@@ -79,6 +85,53 @@ void PanelConfiguration::Update() {
 			if (ImGui::DragFloat("Gravity", &App->physics->gravity, App->editor->dragSpeed3f, -100.f, 100.f)) {
 				App->physics->SetGravity(App->physics->gravity);
 			}
+			ImGui::Checkbox("Asynchronous stepping", &App->physics->asyncStepping);
+			ImGui::Text("Step time: %.3f ms (waited: %.3f ms)", App->physics->GetStepTime() / 1000.0f, App->physics->GetWaitTime() / 1000.0f);
+
+			ImGui::TextColored(App->editor->titleColor, "Collision events");
+			ImGui::Text("Contact pairs: %u", App->physics->GetNumContactPairs());
+			ImGui::Text("Events last frame: %u", App->physics->GetCollisionEventsLastFrame());
+			ImGui::Text("Ignored layers:");
+			ImGui::CheckboxFlags("Event Triggers", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::EVENT_TRIGGERS);
+			ImGui::CheckboxFlags("World Elements", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::WORLD_ELEMENTS);
+			ImGui::CheckboxFlags("Player", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::PLAYER);
+			ImGui::CheckboxFlags("Enemy", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::ENEMY);
+			ImGui::CheckboxFlags("Bullet", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::BULLET);
+			ImGui::CheckboxFlags("Bullet Enemy", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::BULLET_ENEMY);
+			ImGui::CheckboxFlags("Skills", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::SKILLS);
+			ImGui::CheckboxFlags("Everything", &App->physics->ignoredCollisionEventLayers, (int) WorldLayers::EVERYTHING);
+		}
+
+		// Events
+		if (ImGui::CollapsingHeader("Events")) {
+			ImGui::Text("Events last frame: %u", App->events->GetEventsLastFrame());
+			ImGui::Text("Payloads allocated on overflow: %u", App->events->createResourcePayloads.GetOverflowCount());
+			if (ImGui::BeginTable("##events", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+				ImGui::TableSetupColumn("Type");
+				ImGui::TableSetupColumn("Events");
+				ImGui::TableSetupColumn("Dispatch (ms)");
+				ImGui::TableHeadersRow();
+				for (int i = (int) TesseractEventType::UNKNOWN + 1; i < (int) TesseractEventType::COUNT; ++i) {
+					const EventTypeStats& stats = App->events->GetEventTypeStats((TesseractEventType) i);
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(GetEventTypeName((TesseractEventType) i));
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", stats.numEvents);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", stats.dispatchTimeMs);
+				}
+				ImGui::EndTable();
+			}
+		}
+
+		// Jobs
+		if (ImGui::CollapsingHeader("Jobs")) {
+			if (ImGui::SliderInt("Worker threads", &App->jobs->workerThreads, 0, (int) std::thread::hardware_concurrency() * 2, App->jobs->workerThreads == 0 ? "Auto" : "%d")) {
+				App->jobs->RestartWorkers();
+			}
+			ImGui::Text("Threads: %u", App->jobs->GetNumThreads());
+			ImGui::Text("Jobs last frame: %u (stolen: %u)", App->jobs->GetJobsLastFrame(), App->jobs->GetJobsStolenLastFrame());
 		}
 
 		// Hardware
@@ -28,6 +28,8 @@ void PanelConsole::Update() {
 
 		if (ImGui::BeginPopupContextWindow()) {
 			if (ImGui::Selectable("Clear")) logger->logString.clear();
+			bool verbose = logger->GetMinSeverity() == LogSeverity::VERBOSE;
+			if (ImGui::MenuItem("Verbose", nullptr, &verbose)) logger->SetMinSeverity(verbose ? LogSeverity::VERBOSE : LogSeverity::INFO);
 			ImGui::EndPopup();
 		}
 
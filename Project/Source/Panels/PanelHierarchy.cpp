@@ -225,6 +225,7 @@ void PanelHierarchy::UpdateHierarchyNode(GameObject* gameObject) {
 // --- New GameObject Functions ---- //
 GameObject* PanelHierarchy::CreateEmptyGameObject(GameObject* gameObject) {
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Game Object");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform* transform = newGameObject->CreateComponent<ComponentTransform>();
 	transform->SetPosition(float3(0, 0, 0));
 	transform->SetRotation(Quat::identity);
@@ -237,6 +238,7 @@ GameObject* PanelHierarchy::CreateEmptyGameObject(GameObject* gameObject) {
 GameObject* PanelHierarchy::CreateEventSystem(GameObject* gameObject) {
 	if (App->userInterface->GetCurrentEventSystem() == nullptr) {
 		GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Event System");
+		if (newGameObject == nullptr) return nullptr;
 		newGameObject->CreateComponent<ComponentTransform>();
 		ComponentEventSystem* component = newGameObject->CreateComponent<ComponentEventSystem>();
 		App->userInterface->SetCurrentEventSystem(component->GetID());
@@ -249,6 +251,7 @@ GameObject* PanelHierarchy::CreateEventSystem(GameObject* gameObject) {
 
 GameObject* PanelHierarchy::CreateUICanvas(GameObject* gameObject) {
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Canvas");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform2D* transform2D = newGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvas* canvas = newGameObject->CreateComponent<ComponentCanvas>();
 	newGameObject->Init();
@@ -264,6 +267,7 @@ GameObject* PanelHierarchy::CreateUIImage(GameObject* gameObject) {
 	}
 
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Image");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform2D* transform2D = newGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* canvasRenderer = newGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentImage* image = newGameObject->CreateComponent<ComponentImage>();
@@ -278,6 +282,7 @@ GameObject* PanelHierarchy::CreateUIVideo(GameObject* gameObject) {
 	}
 
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Video");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform2D* transform2D = newGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* canvasRenderer = newGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentVideo* image = newGameObject->CreateComponent<ComponentVideo>();
@@ -292,6 +297,7 @@ GameObject* PanelHierarchy::CreateUIText(GameObject* gameObject) {
 	}
 
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Text");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform2D* transform2D = newGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* canvasRenderer = newGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentText* text = newGameObject->CreateComponent<ComponentText>();
@@ -306,6 +312,7 @@ GameObject* PanelHierarchy::CreateUIButton(GameObject* gameObject) {
 	}
 
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Button");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform2D* transform2D = newGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* canvasRenderer = newGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentBoundingBox2D* boundingBox = newGameObject->CreateComponent<ComponentBoundingBox2D>();
@@ -327,6 +334,7 @@ GameObject* PanelHierarchy::CreateUIToggle(GameObject* gameObject) {
 	}
 
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Toggle");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform2D* transform2D = newGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* canvasRenderer = newGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentBoundingBox2D* boundingBox = newGameObject->CreateComponent<ComponentBoundingBox2D>();
@@ -339,6 +347,7 @@ GameObject* PanelHierarchy::CreateUIToggle(GameObject* gameObject) {
 
 	//Child Image
 	GameObject* newGameObjectChild = CreateUIImage(newGameObject);
+	if (newGameObjectChild == nullptr) return newGameObject;
 	newGameObjectChild->GetComponent<ComponentTransform2D>()->SetSize(transform2D->GetSize() / 2);
 	newGameObjectChild->GetComponent<ComponentImage>()->SetColor(float4::zero);
 	newGameObjectChild->name = "Checkmark";
@@ -355,16 +364,19 @@ GameObject* PanelHierarchy::CreateUIProgressBar(GameObject* gameObject) {
 	}
 
 	GameObject* progressBar = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Progress Bar");
+	if (progressBar == nullptr) return nullptr;
 	ComponentTransform2D* progressTransform2D = progressBar->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* progressRenderer = progressBar->CreateComponent<ComponentCanvasRenderer>();
 	ComponentProgressBar* progress = progressBar->CreateComponent<ComponentProgressBar>();
 	progressBar->Init();
 
 	GameObject* background = CreateUIImage(progressBar);
+	if (background == nullptr) return progressBar;
 	background->GetComponent<ComponentTransform2D>()->SetSize(float2(700, 80));
 	background->name = "Background";
 
 	GameObject* fill = CreateUIImage(progressBar);
+	if (fill == nullptr) return progressBar;
 	fill->GetComponent<ComponentImage>()->SetColor(float4(1.f, 0, 0, 1.f));
 	fill->name = "Fill";
 
@@ -377,6 +389,7 @@ GameObject* PanelHierarchy::CreateUISlider(GameObject* gameObject) {
 	}
 
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "Slider");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform2D* transform2D = newGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* canvasRenderer = newGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentBoundingBox2D* boundingBox = newGameObject->CreateComponent<ComponentBoundingBox2D>();
@@ -387,18 +400,21 @@ GameObject* PanelHierarchy::CreateUISlider(GameObject* gameObject) {
 	CreateEventSystem(App->scene->scene->root);
 
 	GameObject* backgroundGameObject = App->scene->scene->CreateGameObject(newGameObject, GenerateUID(), "Background");
+	if (backgroundGameObject == nullptr) return newGameObject;
 	ComponentTransform2D* backgroundTransform2D = backgroundGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* backgroundRenderer = backgroundGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentImage* backgorundImage = backgroundGameObject->CreateComponent<ComponentImage>();
 	backgroundGameObject->Init();
 
 	GameObject* fillGameObject = App->scene->scene->CreateGameObject(newGameObject, GenerateUID(), "Fill");
+	if (fillGameObject == nullptr) return newGameObject;
 	ComponentTransform2D* fillTransform2D = fillGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* fillRenderer = fillGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentImage* fillImage = fillGameObject->CreateComponent<ComponentImage>();
 	fillGameObject->Init();
 
 	GameObject* handleGameObject = App->scene->scene->CreateGameObject(newGameObject, GenerateUID(), "Handle");
+	if (handleGameObject == nullptr) return newGameObject;
 	ComponentTransform2D* handleTransform2D = handleGameObject->CreateComponent<ComponentTransform2D>();
 	ComponentCanvasRenderer* handleRenderer = handleGameObject->CreateComponent<ComponentCanvasRenderer>();
 	ComponentImage* handleImage = handleGameObject->CreateComponent<ComponentImage>();
@@ -412,6 +428,7 @@ GameObject* PanelHierarchy::CreateUISlider(GameObject* gameObject) {
 // ------- PARTICLE SYSTEMS -------- //
 GameObject* PanelHierarchy::CreatePartycleSystemObject(GameObject* gameObject) {
 	GameObject* newGameObject = App->scene->scene->CreateGameObject(gameObject, GenerateUID(), "ParticleSystem");
+	if (newGameObject == nullptr) return nullptr;
 	ComponentTransform* transform = newGameObject->CreateComponent<ComponentTransform>();
 	ComponentParticleSystem* particle = newGameObject->CreateComponent<ComponentParticleSystem>();
 	transform->SetPosition(float3(0, 0, 0));
@@ -435,6 +452,11 @@ GameObject* PanelHierarchy::DuplicateGameObject(GameObject* gameObject) {
 	Scene* scene = parent->scene;
 	UID gameObjectId = GenerateUID();
 	GameObject* newGameObject = scene->gameObjects.Obtain(gameObjectId);
+	if (newGameObject == nullptr) {
+		LOG("The GameObject pool is full. %s can't be duplicated.", gameObject->name.c_str());
+		return nullptr;
+	}
+
 	newGameObject->scene = scene;
 	newGameObject->id = gameObjectId;
 	newGameObject->SetParent(parent);
@@ -561,6 +561,7 @@ void PanelInspector::AddUIComponentsOptions(GameObject* selected) {
 			component->Init();
 
 			GameObject* background = App->scene->scene->CreateGameObject(selected, GenerateUID(), "Background");
+			if (background == nullptr) break;
 			ComponentTransform2D* transform2D = background->CreateComponent<ComponentTransform2D>();
 			ComponentCanvasRenderer* canvasRenderer = background->CreateComponent<ComponentCanvasRenderer>();
 			ComponentImage* image = background->CreateComponent<ComponentImage>();
@@ -568,6 +569,7 @@ void PanelInspector::AddUIComponentsOptions(GameObject* selected) {
 			transform2D->SetSize(float2(700, 80));
 
 			GameObject* fill = App->scene->scene->CreateGameObject(selected, GenerateUID(), "Fill");
+			if (fill == nullptr) break;
 			ComponentTransform2D* transform2DFill = fill->CreateComponent<ComponentTransform2D>();
 			ComponentCanvasRenderer* canvasRendererFill = fill->CreateComponent<ComponentCanvasRenderer>();
 			ComponentImage* imageFill = fill->CreateComponent<ComponentImage>();
@@ -584,6 +586,7 @@ void PanelInspector::AddUIComponentsOptions(GameObject* selected) {
 			}
 
 			GameObject* background = App->scene->scene->CreateGameObject(selected, GenerateUID(), "Background");
+			if (background == nullptr) break;
 			ComponentTransform2D* transform2D = background->CreateComponent<ComponentTransform2D>();
 			ComponentCanvasRenderer* canvasRenderer = background->CreateComponent<ComponentCanvasRenderer>();
 			ComponentImage* image = background->CreateComponent<ComponentImage>();
@@ -591,12 +594,14 @@ void PanelInspector::AddUIComponentsOptions(GameObject* selected) {
 			transform2D->SetSize(float2(700, 80));
 
 			GameObject* fill = App->scene->scene->CreateGameObject(selected, GenerateUID(), "Fill");
+			if (fill == nullptr) break;
 			ComponentTransform2D* transform2DFill = fill->CreateComponent<ComponentTransform2D>();
 			ComponentCanvasRenderer* canvasRendererFill = fill->CreateComponent<ComponentCanvasRenderer>();
 			ComponentImage* imageFill = fill->CreateComponent<ComponentImage>();
 			fill->Init();
 
 			GameObject* handle = App->scene->scene->CreateGameObject(selected, GenerateUID(), "Handle");
+			if (handle == nullptr) break;
 			ComponentTransform2D* transform2DHandle = fill->CreateComponent<ComponentTransform2D>();
 			ComponentCanvasRenderer* canvasRendererHandle = fill->CreateComponent<ComponentCanvasRenderer>();
 			ComponentImage* imageHandle = fill->CreateComponent<ComponentImage>();
@@ -242,6 +242,17 @@ void PanelScene::Update() {
 				char trianglesChar[10];
 				sprintf_s(trianglesChar, 10, "%d", triangles);
 				ImGui::TextColored(App->editor->textColor, trianglesChar);
+				ImGui::Separator();
+				ImGui::TextColored(App->editor->titleColor, "Mesh draws");
+				ImGui::Text("Draw calls: ");
+				ImGui::SameLine();
+				ImGui::TextColored(App->editor->textColor, "%d", App->renderer->GetDrawCalls());
+				ImGui::Text("State changes saved: ");
+				ImGui::SameLine();
+				ImGui::TextColored(App->editor->textColor, "%d", App->renderer->GetStateChangesSaved());
+				ImGui::Text("Draws merged: ");
+				ImGui::SameLine();
+				ImGui::TextColored(App->editor->textColor, "%d", App->renderer->GetDrawsMerged());
 
 				ImGui::EndPopup();
 			}
@@ -254,7 +265,7 @@ void PanelScene::Update() {
 			TesseractEvent resizeEvent(TesseractEventType::SCREEN_RESIZED);
 
 			resizeEvent.Set<ViewportResizedStruct>((int) size.x, (int) size.y);
-			App->events->AddEvent(resizeEvent);
+			App->events->AddEvent(std::move(resizeEvent));
 
 			framebufferSize = {
 				size.x,
@@ -0,0 +1,165 @@
+#include "CullingBatch.h"
+
+#include "Rendering/FrustumPlanes.h"
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "Utils/Leaks.h"
+
+void CullingBatch::Clear() {
+	count = 0;
+
+	centerX.clear();
+	centerY.clear();
+	centerZ.clear();
+	halfSizeX.clear();
+	halfSizeY.clear();
+	halfSizeZ.clear();
+	for (std::vector<float>& axis : axes) {
+		axis.clear();
+	}
+	minX.clear();
+	minY.clear();
+	minZ.clear();
+	maxX.clear();
+	maxY.clear();
+	maxZ.clear();
+}
+
+void CullingBatch::Add(const AABB& aabb, const OBB& obb) {
+	// Grow by a whole SIMD width, so that the padding lanes always hold valid numbers
+	if (count % CULLING_SIMD_WIDTH == 0) {
+		Resize(count + 1);
+	} else {
+		count += 1;
+	}
+
+	Set(count - 1, aabb, obb);
+}
+
+void CullingBatch::Resize(unsigned newCount) {
+	// Padded to a whole SIMD width, so that the padding lanes always hold valid numbers
+	size_t size = (newCount + CULLING_SIMD_WIDTH - 1) / CULLING_SIMD_WIDTH * CULLING_SIMD_WIDTH;
+	centerX.resize(size);
+	centerY.resize(size);
+	centerZ.resize(size);
+	halfSizeX.resize(size);
+	halfSizeY.resize(size);
+	halfSizeZ.resize(size);
+	for (std::vector<float>& axis : axes) {
+		axis.resize(size);
+	}
+	minX.resize(size);
+	minY.resize(size);
+	minZ.resize(size);
+	maxX.resize(size);
+	maxY.resize(size);
+	maxZ.resize(size);
+
+	count = newCount;
+}
+
+void CullingBatch::Set(unsigned index, const AABB& aabb, const OBB& obb) {
+	centerX[index] = obb.pos.x;
+	centerY[index] = obb.pos.y;
+	centerZ[index] = obb.pos.z;
+	halfSizeX[index] = obb.r.x;
+	halfSizeY[index] = obb.r.y;
+	halfSizeZ[index] = obb.r.z;
+	for (unsigned i = 0; i < 3; ++i) {
+		axes[i * 3][index] = obb.axis[i].x;
+		axes[i * 3 + 1][index] = obb.axis[i].y;
+		axes[i * 3 + 2][index] = obb.axis[i].z;
+	}
+	minX[index] = aabb.minPoint.x;
+	minY[index] = aabb.minPoint.y;
+	minZ[index] = aabb.minPoint.z;
+	maxX[index] = aabb.maxPoint.x;
+	maxY[index] = aabb.maxPoint.y;
+	maxZ[index] = aabb.maxPoint.z;
+}
+
+unsigned CullingBatch::Count() const {
+	return count;
+}
+
+static __m128 ProjectAxis(__m128 normalX, __m128 normalY, __m128 normalZ, const float* axisX, const float* axisY, const float* axisZ, __m128 absMask) {
+	__m128 projection = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, _mm_loadu_ps(axisX)), _mm_mul_ps(normalY, _mm_loadu_ps(axisY))), _mm_mul_ps(normalZ, _mm_loadu_ps(axisZ)));
+	return _mm_and_ps(projection, absMask);
+}
+
+void CullingBatch::Cull(const FrustumPlanes& planes, std::vector<unsigned>& visibility) const {
+	BeginCull(visibility);
+	CullRange(planes, visibility, 0, count);
+}
+
+void CullingBatch::BeginCull(std::vector<unsigned>& visibility) const {
+	visibility.assign((count + 31) / 32, 0);
+}
+
+void CullingBatch::CullRange(const FrustumPlanes& planes, std::vector<unsigned>& visibility, unsigned first, unsigned last) const {
+	if (first >= last) return;
+
+	// All the frustum corners are on the outer side of a box face only if the closest one is
+	float3 cornersMin = planes.frustumPoints[0];
+	float3 cornersMax = planes.frustumPoints[0];
+	for (unsigned i = 1; i < 8; ++i) {
+		cornersMin = cornersMin.Min(planes.frustumPoints[i]);
+		cornersMax = cornersMax.Max(planes.frustumPoints[i]);
+	}
+	__m128 cornersMinX = _mm_set1_ps(cornersMin.x);
+	__m128 cornersMinY = _mm_set1_ps(cornersMin.y);
+	__m128 cornersMinZ = _mm_set1_ps(cornersMin.z);
+	__m128 cornersMaxX = _mm_set1_ps(cornersMax.x);
+	__m128 cornersMaxY = _mm_set1_ps(cornersMax.y);
+	__m128 cornersMaxZ = _mm_set1_ps(cornersMax.z);
+
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 zero = _mm_setzero_ps();
+
+	for (unsigned i = first; i < last; i += CULLING_SIMD_WIDTH) {
+		__m128 boxCenterX = _mm_loadu_ps(&centerX[i]);
+		__m128 boxCenterY = _mm_loadu_ps(&centerY[i]);
+		__m128 boxCenterZ = _mm_loadu_ps(&centerZ[i]);
+		__m128 boxHalfSizeX = _mm_loadu_ps(&halfSizeX[i]);
+		__m128 boxHalfSizeY = _mm_loadu_ps(&halfSizeY[i]);
+		__m128 boxHalfSizeZ = _mm_loadu_ps(&halfSizeZ[i]);
+
+		// The box is outside a plane if its closest corner to the inner side is outside: center distance minus the projected radius
+		__m128 outside = zero;
+		for (const Plane& plane : planes.frustumPlanes) {
+			__m128 normalX = _mm_set1_ps(plane.normal.x);
+			__m128 normalY = _mm_set1_ps(plane.normal.y);
+			__m128 normalZ = _mm_set1_ps(plane.normal.z);
+
+			__m128 distance = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, boxCenterX), _mm_mul_ps(normalY, boxCenterY)), _mm_mul_ps(normalZ, boxCenterZ)), _mm_set1_ps(plane.d));
+			__m128 radius = _mm_mul_ps(ProjectAxis(normalX, normalY, normalZ, &axes[0][i], &axes[1][i], &axes[2][i], absMask), boxHalfSizeX);
+			radius = _mm_add_ps(radius, _mm_mul_ps(ProjectAxis(normalX, normalY, normalZ, &axes[3][i], &axes[4][i], &axes[5][i], absMask), boxHalfSizeY));
+			radius = _mm_add_ps(radius, _mm_mul_ps(ProjectAxis(normalX, normalY, normalZ, &axes[6][i], &axes[7][i], &axes[8][i], absMask), boxHalfSizeZ));
+
+			outside = _mm_or_ps(outside, _mm_cmpgt_ps(_mm_sub_ps(distance, radius), zero));
+		}
+
+		// Frustum corners against the AABB
+		outside = _mm_or_ps(outside, _mm_cmpgt_ps(cornersMinX, _mm_loadu_ps(&maxX[i])));
+		outside = _mm_or_ps(outside, _mm_cmplt_ps(cornersMaxX, _mm_loadu_ps(&minX[i])));
+		outside = _mm_or_ps(outside, _mm_cmpgt_ps(cornersMinY, _mm_loadu_ps(&maxY[i])));
+		outside = _mm_or_ps(outside, _mm_cmplt_ps(cornersMaxY, _mm_loadu_ps(&minY[i])));
+		outside = _mm_or_ps(outside, _mm_cmpgt_ps(cornersMinZ, _mm_loadu_ps(&maxZ[i])));
+		outside = _mm_or_ps(outside, _mm_cmplt_ps(cornersMaxZ, _mm_loadu_ps(&minZ[i])));
+
+		unsigned inside = ~(unsigned) _mm_movemask_ps(outside) & 0xF;
+		visibility[i / 32] |= inside << (i % 32);
+	}
+
+	// Clear the bits of the padding lanes
+	unsigned remainder = count % 32;
+	if (last == count && remainder != 0) {
+		visibility.back() &= (1u << remainder) - 1;
+	}
+}
+
+bool CullingBatch::IsVisible(const std::vector<unsigned>& visibility, unsigned index) {
+	return (visibility[index / 32] >> (index % 32) & 1) != 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Geometry/AABB.h"
+#include "Geometry/OBB.h"
+
+#include <vector>
+
+class FrustumPlanes;
+
+#define CULLING_SIMD_WIDTH 4 // Boxes tested per SSE instruction. The arrays are padded to this width
+
+/* Bounds of many objects packed as a struct of arrays, and tested against a frustum 4 at a time with SSE.
+*  The test is the same as FrustumPlanes::CheckIfInsideFrustumPlanes, without building the OBB corners: the OBB is
+*  stored as center, half size and axes and projected on the plane normals, and the AABB is compared against the
+*  bounds of the frustum corners. The result is a visibility bitmask with one bit per box.
+*/
+
+class CullingBatch {
+public:
+	void Clear();
+	void Add(const AABB& aabb, const OBB& obb);
+	void Resize(unsigned newCount); // Makes room for 'newCount' boxes, to be filled with Set. Lets several threads fill the batch
+	void Set(unsigned index, const AABB& aabb, const OBB& obb);
+	unsigned Count() const;
+
+	void Cull(const FrustumPlanes& planes, std::vector<unsigned>& visibility) const;									 // Resizes 'visibility' to one bit per box, and sets the bits of the boxes inside the frustum
+	void BeginCull(std::vector<unsigned>& visibility) const;															 // Resizes and clears 'visibility', before calling CullRange
+	void CullRange(const FrustumPlanes& planes, std::vector<unsigned>& visibility, unsigned first, unsigned last) const; // Sets the bits of the boxes in [first, last). 'first' has to be a multiple of 32, so that different ranges never write to the same word
+
+	static bool IsVisible(const std::vector<unsigned>& visibility, unsigned index);
+
+private:
+	unsigned count = 0;
+
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> halfSizeX;
+	std::vector<float> halfSizeY;
+	std::vector<float> halfSizeZ;
+	std::vector<float> axes[9]; // Components of the 3 OBB axes: x, y and z of the first axis, then the second and the third
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> minZ;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+	std::vector<float> maxZ;
+};
@@ -21,6 +21,11 @@ void FrustumPlanes::CalculateFrustumPlanes(const Frustum& frustum) {
 	float wFar = hFar * aspectRatio;
 	float hNear = 2 * tan(vFov / 2) * nearDistance;
 	float wNear = hNear * aspectRatio;
+	if (frustum.Type() == OrthographicFrustum) {
+		// Orthographic frustums (light frustums) are boxes, they have no field of view
+		hFar = hNear = frustum.OrthographicHeight();
+		wFar = wNear = frustum.OrthographicWidth();
+	}
 	float3 farCenter = pos + front * farDistance;
 	float3 nearCenter = pos + front * nearDistance;
 
@@ -86,3 +91,16 @@ bool FrustumPlanes::CheckIfInsideFrustumPlanes(const AABB& aabb, const OBB& obb)
 
 	return true;
 }
+
+bool FrustumPlanes::CheckIfInsideFrustumPlanes(const AABB& aabb) const {
+	for (const Plane& plane : frustumPlanes) {
+		// The box is outside if its corner furthest inside the plane is outside
+		float3 corner(
+			plane.normal.x > 0 ? aabb.minPoint.x : aabb.maxPoint.x,
+			plane.normal.y > 0 ? aabb.minPoint.y : aabb.maxPoint.y,
+			plane.normal.z > 0 ? aabb.minPoint.z : aabb.maxPoint.z);
+		if (plane.normal.Dot(corner) - plane.d > 0) return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,77 @@
+#include "InstanceBuffer.h"
+
+#include "Globals.h"
+#include "Utils/Logging.h"
+
+#include "GL/glew.h"
+
+#include "Utils/Leaks.h"
+
+#define INSTANCE_BUFFER_WAIT_TIMEOUT_NS 100000000
+
+void InstanceBuffer::Init() {
+	GLsizeiptr size = sizeof(float4x4) * INSTANCE_BUFFER_CAPACITY * INSTANCE_BUFFER_FRAMES;
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	glBufferStorage(GL_SHADER_STORAGE_BUFFER, size, nullptr, flags);
+	mappedInstances = static_cast<float4x4*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, size, flags));
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	if (mappedInstances == nullptr) {
+		LOG("Error: The instance buffer couldn't be mapped. Instanced rendering is disabled.");
+	}
+}
+
+void InstanceBuffer::CleanUp() {
+	for (void*& fence : fences) {
+		if (fence != nullptr) {
+			glDeleteSync(static_cast<GLsync>(fence));
+			fence = nullptr;
+		}
+	}
+
+	if (mappedInstances != nullptr) {
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+		glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		mappedInstances = nullptr;
+	}
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+}
+
+void InstanceBuffer::BeginFrame() {
+	currentFrame = (currentFrame + 1) % INSTANCE_BUFFER_FRAMES;
+	usedInstances = 0;
+
+	GLsync fence = static_cast<GLsync>(fences[currentFrame]);
+	if (fence == nullptr) return;
+
+	GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, INSTANCE_BUFFER_WAIT_TIMEOUT_NS);
+	if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+		LOG("Warning: Timed out waiting for the GPU to release the instance buffer.");
+	}
+	glDeleteSync(fence);
+	fences[currentFrame] = nullptr;
+}
+
+void InstanceBuffer::EndFrame() {
+	if (fences[currentFrame] != nullptr) {
+		glDeleteSync(static_cast<GLsync>(fences[currentFrame]));
+	}
+	fences[currentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+float4x4* InstanceBuffer::Allocate(unsigned count, unsigned& baseInstance) {
+	if (mappedInstances == nullptr || usedInstances + count > INSTANCE_BUFFER_CAPACITY) return nullptr;
+
+	baseInstance = currentFrame * INSTANCE_BUFFER_CAPACITY + usedInstances;
+	usedInstances += count;
+	return mappedInstances + baseInstance;
+}
+
+void InstanceBuffer::Bind() const {
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_BUFFER_BINDING, buffer);
+}
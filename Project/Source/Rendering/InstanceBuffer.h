@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Math/float4x4.h"
+
+#define INSTANCE_BUFFER_BINDING 8		// Must match the binding of 'InstancesBuffer' in instancing.shader
+#define INSTANCE_BUFFER_FRAMES 3		// Frames that can be in flight before the CPU has to wait for the GPU
+#define INSTANCE_BUFFER_CAPACITY 16384	// Instances per frame
+
+/* Persistent-mapped storage buffer with the model matrices of instanced draws.
+*  The buffer is split in one region per frame in flight. Each region is fenced
+*  at the end of the frame and waited on before it is written again.
+*/
+
+class InstanceBuffer {
+public:
+	void Init();
+	void CleanUp();
+
+	void BeginFrame(); // Moves to the next region, waiting for the GPU to finish reading it if needed
+	void EndFrame();   // Fences the region written this frame
+
+	float4x4* Allocate(unsigned count, unsigned& baseInstance); // Returns nullptr if there isn't enough space left in this frame's region
+	void Bind() const;
+
+private:
+	unsigned buffer = 0;
+	float4x4* mappedInstances = nullptr;
+	void* fences[INSTANCE_BUFFER_FRAMES] = {nullptr, nullptr, nullptr};
+	unsigned currentFrame = 0;
+	unsigned usedInstances = 0;
+};
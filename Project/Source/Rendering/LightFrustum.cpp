@@ -13,8 +13,48 @@
 
 #include "Utils/Leaks.h"
 
+#define STATIC_CASCADE_SNAP_FRACTION 0.25f		 // Grid step of the static cascade regions, as a fraction of the radius of the cascade
+#define STATIC_CASCADE_CASTER_DISTANCE 1000.0f	 // Distance toward the light, past the region of a static cascade, where its casters are looked for
+
 const float3 colors[MAX_NUMBER_OF_CASCADES] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}};
 
+static AABB ComputeStableBounds(const Frustum& cascadeFrustum, const float4x4& worldToLight) {
+	float3 corners[8];
+	cascadeFrustum.GetCornerPoints(corners);
+
+	// The radius of the bounding sphere doesn't change when the camera rotates. It's rounded up, so that floating point noise doesn't resize the region
+	float3 center = float3::zero;
+	for (const float3& corner : corners) {
+		center += corner;
+	}
+	center /= 8.0f;
+	float radius = 0.0f;
+	for (const float3& corner : corners) {
+		radius = Max(radius, corner.Distance(center));
+	}
+	radius = Max(Ceil(radius), 1.0f);
+
+	// The center is snapped to the grid, and the region is one step bigger than the sphere so that it always contains it
+	float step = radius * STATIC_CASCADE_SNAP_FRACTION;
+	float3 lightCenter = worldToLight.TransformPos(center);
+	lightCenter = float3(Floor(lightCenter.x / step), Floor(lightCenter.y / step), Floor(lightCenter.z / step)) * step;
+	float3 extent = float3(radius + step);
+	return AABB(lightCenter - extent, lightCenter + extent);
+}
+
+// Fits the frustum to a box in light space
+static void SetOrthographicBounds(Frustum& orthographicFrustum, ComponentTransform* lightTransform, const float4x4& lightOrientation, const AABB& lightAABB) {
+	float3 minPoint = lightAABB.minPoint;
+	float3 maxPoint = lightAABB.maxPoint;
+	float3 position = lightOrientation.RotatePart() * float3((maxPoint.x + minPoint.x) * 0.5f, ((maxPoint.y + minPoint.y) * 0.5f), minPoint.z);
+
+	orthographicFrustum.SetOrthographic((maxPoint.x - minPoint.x), (maxPoint.y - minPoint.y));
+	orthographicFrustum.SetUp(lightTransform->GetUp());
+	orthographicFrustum.SetFront(lightTransform->GetFront());
+	orthographicFrustum.SetPos(position);
+	orthographicFrustum.SetViewPlaneDistances(0.0f, (maxPoint.z - minPoint.z));
+}
+
 LightFrustum::LightFrustum() {
 
 	subFrustums.resize(MAX_NUMBER_OF_CASCADES);
@@ -64,17 +104,40 @@ void LightFrustum::UpdateFrustums() {
 }
 
 void LightFrustum::ReconstructFrustum(ShadowCasterType shadowCasterType) {
+	GameObject* light = App->scene->scene->directionalLight;
+	ComponentCamera* gameCamera = App->camera->GetGameCamera();
+
+	// The cascades follow the light orientation and the game camera, so they have to be refit when any of them changes
+	if (light) {
+		Quat rotation = light->GetComponent<ComponentTransform>()->GetGlobalRotation();
+		if (!rotation.Equals(lightRotation)) {
+			lightRotation = rotation;
+			dirty = true;
+		}
+	}
+	if (gameCamera) {
+		Frustum* gameFrustum = gameCamera->GetFrustum();
+		if (!gameFrustum->Pos().Equals(cameraPosition) || !gameFrustum->Front().Equals(cameraFront)) {
+			cameraPosition = gameFrustum->Pos();
+			cameraFront = gameFrustum->Front();
+			dirty = true;
+		}
+	}
+
 	if (!dirty) return;
 
 	UpdateFrustums();
 
-	GameObject* light = App->scene->scene->directionalLight;
 	if (!light) return;
 
 	ComponentTransform* transform = light->GetComponent<ComponentTransform>();
 	assert(transform);
 
+	bool invalidated = contentsChanged;
 	for (unsigned int i = 0; i < numberOfCascades; i++) {
+		Frustum& orthographicFrustum = subFrustums[i].orthographicFrustum;
+		float4x4 previousViewProj = orthographicFrustum.Type() == OrthographicFrustum ? orthographicFrustum.ViewProjMatrix() : float4x4::zero;
+
 		float4x4 lightOrientation = transform->GetGlobalMatrix();
 		lightOrientation.SetTranslatePart(float3::zero);
 		
@@ -84,7 +147,18 @@ void LightFrustum::ReconstructFrustum(ShadowCasterType shadowCasterType) {
 		std::vector<GameObject*> gameObjects;
 		
 		if (shadowCasterType == ShadowCasterType::STATIC) {
-			gameObjects = App->scene->scene->GetStaticCulledShadowCasters(subFrustums[i].planes);
+			// Static cascades cover a region snapped to a grid in light space. While the camera stays inside it, the casters aren't culled again and the cached shadow map stays valid
+			AABB stableBounds = ComputeStableBounds(subFrustums[i].perspectiveFrustum, lightOrientation.Inverted());
+			if (!invalidated && stableBounds.minPoint.Equals(subFrustums[i].stableBounds.minPoint) && stableBounds.maxPoint.Equals(subFrustums[i].stableBounds.maxPoint)) continue;
+			subFrustums[i].stableBounds = stableBounds;
+
+			// Casters between the light and the region can shadow it, even if they are off-screen
+			AABB casterBounds = stableBounds;
+			casterBounds.minPoint.z -= STATIC_CASCADE_CASTER_DISTANCE;
+			SetOrthographicBounds(orthographicFrustum, transform, lightOrientation, casterBounds);
+			subFrustums[i].orthographicPlanes.CalculateFrustumPlanes(orthographicFrustum);
+			gameObjects = App->scene->scene->GetStaticCulledShadowCasters(subFrustums[i].orthographicPlanes);
+			lightAABB = stableBounds;
 		} else if (shadowCasterType == ShadowCasterType::DYNAMIC) {
 			gameObjects = App->scene->scene->GetDynamicCulledShadowCasters(subFrustums[i].planes);
 		} else {
@@ -96,19 +170,28 @@ void LightFrustum::ReconstructFrustum(ShadowCasterType shadowCasterType) {
 			if (componentBBox) {
 				AABB boundingBox = componentBBox->GetWorldAABB();
 				OBB orientedBoundingBox = boundingBox.Transform(lightOrientation.Inverted());
-				lightAABB.Enclose(orientedBoundingBox.MinimalEnclosingAABB());
+				AABB casterAABB = orientedBoundingBox.MinimalEnclosingAABB();
+				if (shadowCasterType == ShadowCasterType::STATIC) {
+					// The x and y of static cascades stay on their snapped region, so that big casters don't stretch it. Only the near plane moves toward the light
+					lightAABB.minPoint.z = Min(lightAABB.minPoint.z, casterAABB.minPoint.z);
+				} else {
+					lightAABB.Enclose(casterAABB);
+				}
 			}
 		}
 
-		float3 minPoint = lightAABB.minPoint;
-		float3 maxPoint = lightAABB.maxPoint;
-		float3 position = lightOrientation.RotatePart() * float3((maxPoint.x + minPoint.x) * 0.5f, ((maxPoint.y + minPoint.y) * 0.5f), minPoint.z);
+		SetOrthographicBounds(orthographicFrustum, transform, lightOrientation, lightAABB);
+		subFrustums[i].orthographicPlanes.CalculateFrustumPlanes(orthographicFrustum);
 
-		subFrustums[i].orthographicFrustum.SetOrthographic((maxPoint.x - minPoint.x), (maxPoint.y - minPoint.y));
-		subFrustums[i].orthographicFrustum.SetUp(transform->GetUp());
-		subFrustums[i].orthographicFrustum.SetFront(transform->GetFront());
-		subFrustums[i].orthographicFrustum.SetPos(position);
-		subFrustums[i].orthographicFrustum.SetViewPlaneDistances(0.0f, (maxPoint.z - minPoint.z));
+		// Moving the camera doesn't always change the casters that fit in a cascade. In that case, the previous shadow map is still valid
+		if (!subFrustums[i].orthographicFrustum.ViewProjMatrix().Equals(previousViewProj)) {
+			contentsChanged = true;
+		}
+	}
+
+	if (contentsChanged) {
+		version += 1;
+		contentsChanged = false;
 	}
 
 	dirty = false;
@@ -172,4 +255,9 @@ LightFrustum::FrustumInformation& LightFrustum::operator[](unsigned int i) {
 
 void LightFrustum::Invalidate() {
 	dirty = true;
+	contentsChanged = true;
+}
+
+unsigned int LightFrustum::GetVersion() const {
+	return version;
 }
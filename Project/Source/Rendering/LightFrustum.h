@@ -2,6 +2,8 @@
 
 #include "FrustumPlanes.h"
 
+#include "Math/Quat.h"
+
 constexpr unsigned int MAX_NUMBER_OF_CASCADES = 4;
 constexpr float MINIMUM_FAR_DISTANCE = 50.f;
 
@@ -23,6 +25,8 @@ public:
 		Frustum orthographicFrustum; // Light frustum
 		Frustum perspectiveFrustum;	 // Camera frustum
 		FrustumPlanes planes = FrustumPlanes();
+		FrustumPlanes orthographicPlanes = FrustumPlanes(); // Light frustum planes, used to cull the shadow casters of the cascade
+		AABB stableBounds = AABB(float3::zero, float3::zero); // Light space region covered by a static cascade. Only changes when the camera leaves it
 		float3 color = float3(0.0f, 0.0f, 0.0f);
 		float multiplier = 1.0f;
 		float nearPlane = 0.001f;
@@ -48,9 +52,15 @@ public:
 	FrustumInformation& operator[](unsigned int i);
 
 	void Invalidate();
+	unsigned int GetVersion() const; // Increases every time the contents of the shadow maps of this light frustum may have changed
 
 private:
 	bool dirty = true;
+	bool contentsChanged = true;
+	unsigned int version = 0;
+	Quat lightRotation = Quat::identity;
+	float3 cameraPosition = float3::zero;
+	float3 cameraFront = float3::zero;
 	unsigned int numberOfCascades = 1;
 	CascadeMode mode = CascadeMode::FitToScene;
 	std::vector<FrustumInformation> subFrustums;
@@ -0,0 +1,88 @@
+#include "ParticleInstanceBuffer.h"
+
+#include "Application.h"
+#include "Modules/ModuleUserInterface.h"
+
+#include "Math/MathFunc.h"
+#include "GL/glew.h"
+
+#include "Utils/Leaks.h"
+
+#define PARTICLE_INSTANCE_BUFFER_MIN_CAPACITY 64
+
+static_assert(sizeof(ParticleInstance) == sizeof(float) * 16, "ParticleInstance must match the instanced billboard attributes");
+
+void ParticleInstanceBuffer::Init() {
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(1, &vbo);
+
+	glBindVertexArray(vao);
+
+	// Quad vertices, shared by every particle
+	glBindBuffer(GL_ARRAY_BUFFER, App->userInterface->GetQuadVBO());
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*) (sizeof(float) * 6 * 3));
+
+	// Per-instance attributes
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	for (unsigned i = 2; i <= 5; ++i) {
+		glEnableVertexAttribArray(i);
+		glVertexAttribDivisor(i, 1);
+	}
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*) offsetof(ParticleInstance, position));
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*) offsetof(ParticleInstance, scale));
+	glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*) offsetof(ParticleInstance, color));
+	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*) offsetof(ParticleInstance, direction));
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	capacity = 0;
+}
+
+void ParticleInstanceBuffer::CleanUp() {
+	if (vao) {
+		glDeleteVertexArrays(1, &vao);
+		vao = 0;
+	}
+
+	if (vbo) {
+		glDeleteBuffers(1, &vbo);
+		vbo = 0;
+	}
+
+	capacity = 0;
+}
+
+ParticleInstance* ParticleInstanceBuffer::Map(unsigned count) {
+	if (count == 0) return nullptr;
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	if (count > capacity) {
+		capacity = Max(Max(count, capacity * 2), (unsigned) PARTICLE_INSTANCE_BUFFER_MIN_CAPACITY);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance) * capacity, nullptr, GL_STREAM_DRAW);
+	}
+
+	// Invalidating the whole buffer lets the driver hand out new storage while the previous frame is still being drawn
+	ParticleInstance* instances = static_cast<ParticleInstance*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(ParticleInstance) * count, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	if (instances == nullptr) {
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	return instances;
+}
+
+void ParticleInstanceBuffer::Unmap() {
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleInstanceBuffer::Draw(unsigned count) const {
+	glBindVertexArray(vao);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+	glBindVertexArray(0);
+}
+
+bool ParticleInstanceBuffer::IsInitialized() const {
+	return vao != 0;
+}
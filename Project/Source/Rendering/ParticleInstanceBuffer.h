@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Math/float3.h"
+#include "Math/float4.h"
+
+/* Per-particle data of an instanced billboard. Read as vertex attributes 2 to 5 by 'billboardVertexInstanced'.
+*  The orientation of the billboard is computed in the vertex shader.
+*/
+
+struct ParticleInstance {
+	float3 position;  // World position
+	float rotation;	  // Rotation around the billboard normal, in radians
+	float3 scale;
+	float frame;	  // Current frame of the texture sheet
+	float4 color;
+	float3 direction; // World direction, used by stretched and horizontal billboards
+	float padding;
+};
+
+/* Instance buffer of a particle emitter. It is orphaned and written once per frame,
+*  and then all its particles are drawn with a single instanced call.
+*/
+
+class ParticleInstanceBuffer {
+public:
+	void Init();
+	void CleanUp();
+
+	ParticleInstance* Map(unsigned count); // Orphans the buffer and maps the first 'count' instances for writing. Grows it if needed. Returns nullptr if it can't be mapped
+	void Unmap();
+	void Draw(unsigned count) const; // The instanced billboard program must be in use
+
+	bool IsInitialized() const;
+
+private:
+	unsigned vao = 0;
+	unsigned vbo = 0;
+	unsigned capacity = 0;
+};
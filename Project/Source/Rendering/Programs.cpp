@@ -223,6 +223,23 @@ ProgramDepthPrepass::ProgramDepthPrepass(unsigned program_)
 	offsetLocation = glGetUniformLocation(program, "offset");
 }
 
+ProgramShadowMap::ProgramShadowMap(unsigned program_)
+	: Program(program_) {
+	modelLocation = glGetUniformLocation(program, "model");
+	viewLocation = glGetUniformLocation(program, "view");
+	projLocation = glGetUniformLocation(program, "proj");
+
+	diffuseMapLocation = glGetUniformLocation(program, "diffuseMap");
+	diffuseColorLocation = glGetUniformLocation(program, "diffuseColor");
+	hasDiffuseMapLocation = glGetUniformLocation(program, "hasDiffuseMap");
+
+	paletteLocation = glGetUniformLocation(program, "palette");
+	hasBonesLocation = glGetUniformLocation(program, "hasBones");
+
+	tilingLocation = glGetUniformLocation(program, "tiling");
+	offsetLocation = glGetUniformLocation(program, "offset");
+}
+
 ProgramDepthPrepassConvertTextures::ProgramDepthPrepassConvertTextures(unsigned program_)
 	: Program(program_) {
 	samplesNumberLocation = glGetUniformLocation(program, "samplesNumber");
@@ -323,13 +340,12 @@ ProgramImageUI::ProgramImageUI(unsigned program_)
 	tilingLocation = glGetUniformLocation(program, "tiling");
 }
 
-ProgramTextUI::ProgramTextUI(unsigned program_)
+ProgramUIBatch::ProgramUIBatch(unsigned program_)
 	: Program(program_) {
-	modelLocation = glGetUniformLocation(program, "model");
 	viewLocation = glGetUniformLocation(program, "view");
 	projLocation = glGetUniformLocation(program, "proj");
 
-	textColorLocation = glGetUniformLocation(program, "textColor");
+	diffuseLocation = glGetUniformLocation(program, "diffuse");
 }
 
 ProgramBillboard::ProgramBillboard(unsigned program_)
@@ -360,6 +376,16 @@ ProgramBillboard::ProgramBillboard(unsigned program_)
 	softRangeLocation = glGetUniformLocation(program, "softRange");
 }
 
+ProgramBillboardInstanced::ProgramBillboardInstanced(unsigned program)
+	: ProgramBillboard(program) {
+	billboardTypeLocation = glGetUniformLocation(program, "billboardType");
+	renderAlignmentLocation = glGetUniformLocation(program, "renderAlignment");
+	horizontalOrientationLocation = glGetUniformLocation(program, "horizontalOrientation");
+	cameraPosLocation = glGetUniformLocation(program, "cameraPos");
+	cameraFrontLocation = glGetUniformLocation(program, "cameraFront");
+	emitterUpLocation = glGetUniformLocation(program, "emitterUp");
+}
+
 ProgramTrail::ProgramTrail(unsigned program_)
 	: Program(program_) {
 	viewLocation = glGetUniformLocation(program, "view");
@@ -244,6 +244,24 @@ struct ProgramDepthPrepass : Program {
 	int offsetLocation = -1;
 };
 
+struct ProgramShadowMap : Program {
+	ProgramShadowMap(unsigned program);
+
+	int modelLocation = -1;
+	int viewLocation = -1;
+	int projLocation = -1;
+
+	int diffuseMapLocation = -1;
+	int diffuseColorLocation = -1;
+	int hasDiffuseMapLocation = -1;
+
+	int paletteLocation = -1;
+	int hasBonesLocation = -1;
+
+	int tilingLocation = -1;
+	int offsetLocation = -1;
+};
+
 struct ProgramDepthPrepassConvertTextures : Program {
 	ProgramDepthPrepassConvertTextures(unsigned program);
 
@@ -354,14 +372,13 @@ struct ProgramImageUI : Program {
 	int tilingLocation = -1;
 };
 
-struct ProgramTextUI : Program {
-	ProgramTextUI(unsigned program);
+struct ProgramUIBatch : Program {
+	ProgramUIBatch(unsigned program);
 
-	int modelLocation = -1;
 	int viewLocation = -1;
 	int projLocation = -1;
 
-	int textColorLocation = -1;
+	int diffuseLocation = -1;
 };
 
 struct ProgramBillboard : Program {
@@ -393,6 +410,17 @@ struct ProgramBillboard : Program {
 	int softRangeLocation = -1;
 };
 
+struct ProgramBillboardInstanced : ProgramBillboard {
+	ProgramBillboardInstanced(unsigned program);
+
+	int billboardTypeLocation = -1;
+	int renderAlignmentLocation = -1;
+	int horizontalOrientationLocation = -1;
+	int cameraPosLocation = -1;
+	int cameraFrontLocation = -1;
+	int emitterUpLocation = -1;
+};
+
 struct ProgramTrail : Program {
 	ProgramTrail(unsigned program);
 
@@ -0,0 +1,174 @@
+#include "RenderQueue.h"
+
+#include "Globals.h"
+#include "Components/ComponentMeshRenderer.h"
+#include "Rendering/InstanceBuffer.h"
+#include "Resources/ResourceMesh.h"
+
+#include "Math/myassert.h"
+#include "GL/glew.h"
+
+#include "Utils/Leaks.h"
+
+#define RENDER_QUEUE_RADIX_BITS 8
+#define RENDER_QUEUE_RADIX_BUCKETS (1 << RENDER_QUEUE_RADIX_BITS)
+#define RENDER_QUEUE_MIN_INSTANCES 2
+#define RENDER_QUEUE_MAX_PROGRAM 0xFFFFFFF
+
+void RenderState::Reset() {
+	program = 0;
+	material = nullptr;
+	mesh = nullptr;
+	materialChanged = true;
+	instanceCount = 0;
+	baseInstance = 0;
+
+	draws = 0;
+	stateChangesSaved = 0;
+	drawsMerged = 0;
+}
+
+bool RenderState::UseProgram(unsigned program_) {
+	if (program == program_) {
+		stateChangesSaved += 1;
+		return false;
+	}
+
+	glUseProgram(program_);
+	program = program_;
+
+	// Material uniforms belong to the program, so they have to be set again
+	material = nullptr;
+	return true;
+}
+
+bool RenderState::UseMaterial(const ResourceMaterial* material_) {
+	if (material == material_) {
+		stateChangesSaved += 1;
+		materialChanged = false;
+		return false;
+	}
+
+	material = material_;
+	materialChanged = true;
+	return true;
+}
+
+void RenderState::DrawMesh(const ResourceMesh* mesh_) {
+	if (mesh == mesh_) {
+		stateChangesSaved += 1;
+	} else {
+		glBindVertexArray(mesh_->vao);
+		mesh = mesh_;
+	}
+
+	if (instanceCount > 0) {
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLES, mesh_->numIndices, mesh_->indexType, nullptr, instanceCount, baseInstance);
+		drawsMerged += instanceCount - 1;
+	} else {
+		glDrawElements(GL_TRIANGLES, mesh_->numIndices, mesh_->indexType, nullptr);
+	}
+	draws += 1;
+}
+
+void RenderQueue::Clear() {
+	commands.clear();
+	batches.clear();
+}
+
+void RenderQueue::Add(RenderPass pass, unsigned program, unsigned material, unsigned mesh, float depth, ComponentMeshRenderer* meshRenderer, const float4x4* modelMatrix, bool instanceable) {
+	if (depth < 0.0f) depth = 0.0f;
+	if (depth > 1.0f) depth = 1.0f;
+	unsigned long long depthBucket = static_cast<unsigned long long>(depth * 4294967295.0);
+	assert(program <= RENDER_QUEUE_MAX_PROGRAM); // ERROR: The program name doesn't fit in the sort key
+
+	DrawCommand& command = commands.emplace_back();
+	command.stateKey = (static_cast<unsigned long long>(pass) & 0xF) << 60
+					 | (static_cast<unsigned long long>(program) & RENDER_QUEUE_MAX_PROGRAM) << 32
+					 | static_cast<unsigned long long>(material);
+	command.drawKey = static_cast<unsigned long long>(mesh) << 32
+					| depthBucket;
+	command.meshRenderer = meshRenderer;
+	command.modelMatrix = modelMatrix;
+	command.instanceable = instanceable;
+}
+
+void RenderQueue::Sort() {
+	// LSD radix sort over the 128-bit keys, least significant word first
+	sortBuffer.resize(commands.size());
+	SortByKey(&DrawCommand::drawKey);
+	SortByKey(&DrawCommand::stateKey);
+}
+
+void RenderQueue::SortByKey(unsigned long long DrawCommand::*key) {
+	// Stable LSD radix sort over one 64-bit word. Passes where every key has the same digit are skipped.
+	for (unsigned shift = 0; shift < 64; shift += RENDER_QUEUE_RADIX_BITS) {
+		unsigned counts[RENDER_QUEUE_RADIX_BUCKETS] = {0};
+		for (const DrawCommand& command : commands) {
+			counts[(command.*key >> shift) & (RENDER_QUEUE_RADIX_BUCKETS - 1)] += 1;
+		}
+
+		bool trivialPass = false;
+		for (unsigned count : counts) {
+			if (count == commands.size()) {
+				trivialPass = true;
+				break;
+			}
+		}
+		if (trivialPass) continue;
+
+		unsigned offset = 0;
+		for (unsigned& count : counts) {
+			unsigned bucketSize = count;
+			count = offset;
+			offset += bucketSize;
+		}
+
+		for (const DrawCommand& command : commands) {
+			sortBuffer[counts[(command.*key >> shift) & (RENDER_QUEUE_RADIX_BUCKETS - 1)]++] = command;
+		}
+		commands.swap(sortBuffer);
+	}
+}
+
+void RenderQueue::BuildBatches(InstanceBuffer& instanceBuffer) {
+	batches.clear();
+
+	unsigned first = 0;
+	while (first < commands.size()) {
+		const DrawCommand& firstCommand = commands[first];
+
+		unsigned count = 1;
+		if (firstCommand.instanceable) {
+			while (first + count < commands.size()) {
+				const DrawCommand& command = commands[first + count];
+				if (!command.instanceable || !firstCommand.meshRenderer->CanBeInstancedWith(*command.meshRenderer)) break;
+				count += 1;
+			}
+		}
+
+		DrawBatch& batch = batches.emplace_back();
+		batch.first = first;
+		batch.count = count;
+
+		if (count >= RENDER_QUEUE_MIN_INSTANCES) {
+			float4x4* instances = instanceBuffer.Allocate(count, batch.baseInstance);
+			if (instances != nullptr) {
+				for (unsigned i = 0; i < count; ++i) {
+					instances[i] = *commands[first + i].modelMatrix;
+				}
+				batch.instanced = true;
+			}
+		}
+
+		first += count;
+	}
+}
+
+const std::vector<DrawCommand>& RenderQueue::GetCommands() const {
+	return commands;
+}
+
+const std::vector<DrawBatch>& RenderQueue::GetBatches() const {
+	return batches;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Math/float4x4.h"
+
+#include <vector>
+
+class ComponentMeshRenderer;
+class InstanceBuffer;
+class ResourceMaterial;
+class ResourceMesh;
+
+enum class RenderPass {
+	SHADOW,
+	DEPTH_PREPASS,
+	OPAQUE
+};
+
+// Sort key layout (most significant bits first), split in two words so that resource indices are never truncated:
+//   stateKey: pass (4) | program (28) | material (32)
+//   drawKey:  mesh (32) | depth (32)
+// Draws that share program, material and mesh end up together, so their state only needs to be bound once.
+struct DrawCommand {
+	unsigned long long stateKey = 0;
+	unsigned long long drawKey = 0;
+	ComponentMeshRenderer* meshRenderer = nullptr;
+	const float4x4* modelMatrix = nullptr;
+	bool instanceable = false;
+};
+
+// Consecutive draws of a sorted queue. Instanced batches are drawn with a single call.
+struct DrawBatch {
+	unsigned first = 0;
+	unsigned count = 0;
+	unsigned baseInstance = 0;
+	bool instanced = false;
+};
+
+// GL state left bound by the previous draw of a sorted queue. Draw functions skip the bindings that are still valid.
+struct RenderState {
+	void Reset();
+
+	bool UseProgram(unsigned program);					// Binds the program if it isn't already bound. Returns true if it changed.
+	bool UseMaterial(const ResourceMaterial* material); // Returns true if the material uniforms and textures must be set again.
+	void DrawMesh(const ResourceMesh* mesh);			// Binds the mesh VAO if needed and issues the draw call.
+
+	unsigned program = 0;
+	const ResourceMaterial* material = nullptr;
+	const ResourceMesh* mesh = nullptr;
+	bool materialChanged = true;
+	unsigned instanceCount = 0; // If not 0, the next draw uses the instanced programs and draws this many instances
+	unsigned baseInstance = 0;
+
+	// Counters
+	unsigned draws = 0;
+	unsigned stateChangesSaved = 0; // Program, material and VAO bindings skipped
+	unsigned drawsMerged = 0;		// Draws collapsed into an instanced draw
+};
+
+class RenderQueue {
+public:
+	void Clear();
+	void Add(RenderPass pass, unsigned program, unsigned material, unsigned mesh, float depth, ComponentMeshRenderer* meshRenderer, const float4x4* modelMatrix, bool instanceable); // Depth is expected to be normalized between 0 and 1
+	void Sort();
+	void BuildBatches(InstanceBuffer& instanceBuffer); // Groups the sorted draws that can be instanced together and writes their model matrices to the instance buffer
+
+	const std::vector<DrawCommand>& GetCommands() const;
+	const std::vector<DrawBatch>& GetBatches() const;
+
+private:
+	void SortByKey(unsigned long long DrawCommand::*key);
+
+private:
+	std::vector<DrawCommand> commands;
+	std::vector<DrawCommand> sortBuffer;
+	std::vector<DrawBatch> batches;
+};
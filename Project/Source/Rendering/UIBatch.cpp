@@ -0,0 +1,148 @@
+#include "UIBatch.h"
+
+#include "Application.h"
+#include "Modules/ModulePrograms.h"
+
+#include "Math/MathFunc.h"
+#include "GL/glew.h"
+
+#include "Utils/Leaks.h"
+
+#define UI_BATCH_MIN_CAPACITY 256 // In vertices
+
+static_assert(sizeof(UIVertex) == sizeof(float) * 11, "UIVertex must match the UI batch attributes");
+
+void UIBatch::Init() {
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(1, &vbo);
+
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(UIVertex), (void*) offsetof(UIVertex, position));
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(UIVertex), (void*) offsetof(UIVertex, uv));
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(UIVertex), (void*) offsetof(UIVertex, color));
+	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(UIVertex), (void*) offsetof(UIVertex, mode));
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	capacity = 0;
+}
+
+void UIBatch::CleanUp() {
+	if (vao) {
+		glDeleteVertexArrays(1, &vao);
+		vao = 0;
+	}
+
+	if (vbo) {
+		glDeleteBuffers(1, &vbo);
+		vbo = 0;
+	}
+
+	capacity = 0;
+}
+
+void UIBatch::Begin(const float4x4& view_, const float4x4& proj_) {
+	view = view_;
+	proj = proj_;
+	vertices.clear();
+	ranges.clear();
+	drawCount = 0;
+}
+
+void UIBatch::AddQuad(const float4x4& transform, const float2& minPosition, const float2& maxPosition, const float2& minUV, const float2& maxUV, const float4& color, unsigned texture, UIBatchMode mode, bool opaque) {
+	if (mode == UIBatchMode::COLOR) texture = 0;
+
+	// Merge with the previous quads if they use the same texture, or if one of them doesn't use any
+	unsigned first = (unsigned) vertices.size();
+	if (!ranges.empty() && (texture == 0 || ranges.back().texture == 0 || ranges.back().texture == texture)) {
+		DrawRange& range = ranges.back();
+		if (range.texture == 0) range.texture = texture;
+		range.count += 6;
+	} else {
+		DrawRange range;
+		range.texture = texture;
+		range.first = first;
+		range.count = 6;
+		ranges.push_back(range);
+	}
+
+	float3 bottomLeft = transform.TransformPos(float3(minPosition.x, minPosition.y, 0.0f));
+	float3 bottomRight = transform.TransformPos(float3(maxPosition.x, minPosition.y, 0.0f));
+	float3 topLeft = transform.TransformPos(float3(minPosition.x, maxPosition.y, 0.0f));
+	float3 topRight = transform.TransformPos(float3(maxPosition.x, maxPosition.y, 0.0f));
+
+	UIVertex vertex;
+	vertex.color = color;
+	vertex.mode = (float) mode;
+	vertex.opaque = opaque ? 1.0f : 0.0f;
+	vertices.resize(first + 6, vertex);
+	UIVertex* quad = &vertices[first];
+	quad[0].position = bottomLeft;
+	quad[0].uv = minUV;
+	quad[1].position = bottomRight;
+	quad[1].uv = float2(maxUV.x, minUV.y);
+	quad[2].position = topLeft;
+	quad[2].uv = float2(minUV.x, maxUV.y);
+	quad[3].position = bottomRight;
+	quad[3].uv = float2(maxUV.x, minUV.y);
+	quad[4].position = topRight;
+	quad[4].uv = maxUV;
+	quad[5].position = topLeft;
+	quad[5].uv = float2(minUV.x, maxUV.y);
+}
+
+void UIBatch::Flush() {
+	if (ranges.empty()) return;
+
+	ProgramUIBatch* program = App->programs->uiBatch;
+	if (program == nullptr || vao == 0) {
+		vertices.clear();
+		ranges.clear();
+		return;
+	}
+
+	// Orphan the buffer, so that the driver doesn't wait for the draws of the previous frame
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	if (vertices.size() > capacity) {
+		capacity = Max(Max((unsigned) vertices.size(), capacity * 2), (unsigned) UI_BATCH_MIN_CAPACITY);
+	}
+	glBufferData(GL_ARRAY_BUFFER, sizeof(UIVertex) * capacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(UIVertex) * vertices.size(), vertices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	glUseProgram(program->program);
+	glUniformMatrix4fv(program->viewLocation, 1, GL_TRUE, view.ptr());
+	glUniformMatrix4fv(program->projLocation, 1, GL_TRUE, proj.ptr());
+	glActiveTexture(GL_TEXTURE0);
+	glUniform1i(program->diffuseLocation, 0);
+
+	glBindVertexArray(vao);
+	for (const DrawRange& range : ranges) {
+		glBindTexture(GL_TEXTURE_2D, range.texture);
+		glDrawArrays(GL_TRIANGLES, range.first, range.count);
+	}
+	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glDisable(GL_BLEND);
+
+	drawCount += (unsigned) ranges.size();
+	vertices.clear();
+	ranges.clear();
+}
+
+void UIBatch::End() {
+	Flush();
+}
+
+unsigned UIBatch::GetDrawCount() const {
+	return drawCount;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Math/float2.h"
+#include "Math/float3.h"
+#include "Math/float4.h"
+#include "Math/float4x4.h"
+
+#include <vector>
+
+/* How the fragments of a UI quad use the bound texture. Read by 'fragUIBatch'. */
+
+enum class UIBatchMode {
+	COLOR,	 // The texture isn't sampled. These quads can be merged with any texture
+	TEXTURE, // The texture color is multiplied by the vertex color
+	GLYPH	 // The red channel of the texture (a font atlas) is used as alpha
+};
+
+struct UIVertex {
+	float3 position; // Position after the model and canvas scale transforms
+	float2 uv;
+	float4 color;
+	float mode;	  // UIBatchMode
+	float opaque; // 1 if the alpha must be ignored
+};
+
+/* Collects the quads of the UI of a frame in a single vertex buffer. Consecutive quads that use the same texture are
+*  merged into one draw call, and everything is drawn in the order it was added, with the blending always enabled.
+*/
+
+class UIBatch {
+public:
+	void Init();
+	void CleanUp();
+
+	void Begin(const float4x4& view, const float4x4& proj);
+	// The quad goes from 'minPosition' to 'maxPosition' in the XY plane, transformed by 'transform'. The UVs are set for the same corners
+	void AddQuad(const float4x4& transform, const float2& minPosition, const float2& maxPosition, const float2& minUV, const float2& maxUV, const float4& color, unsigned texture, UIBatchMode mode, bool opaque);
+	void Flush(); // Draws the quads added until now. Called before anything that draws the UI in another way
+	void End();
+
+	unsigned GetDrawCount() const; // Draws of the last frame
+
+private:
+	struct DrawRange {
+		unsigned texture = 0; // 0 if none of the quads samples a texture
+		unsigned first = 0;
+		unsigned count = 0;
+	};
+
+	unsigned vao = 0;
+	unsigned vbo = 0;
+	unsigned capacity = 0;
+
+	float4x4 view = float4x4::identity;
+	float4x4 proj = float4x4::identity;
+	std::vector<UIVertex> vertices;
+	std::vector<DrawRange> ranges;
+	unsigned drawCount = 0;
+};
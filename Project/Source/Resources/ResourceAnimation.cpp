@@ -6,8 +6,28 @@
 #include "Utils/MSTimer.h"
 #include "Utils/Logging.h"
 
+#include "Math/MathFunc.h"
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
 #include "Utils/Leaks.h"
 
+static ResourceAnimation::QuantizedRotation QuantizeRotation(const Quat& rotation) {
+	ResourceAnimation::QuantizedRotation quantized;
+	quantized.x = (short) roundf(Clamp(rotation.x, -1.0f, 1.0f) * SHRT_MAX);
+	quantized.y = (short) roundf(Clamp(rotation.y, -1.0f, 1.0f) * SHRT_MAX);
+	quantized.z = (short) roundf(Clamp(rotation.z, -1.0f, 1.0f) * SHRT_MAX);
+	quantized.w = (short) roundf(Clamp(rotation.w, -1.0f, 1.0f) * SHRT_MAX);
+	return quantized;
+}
+
+static __m128 DecodeRotation(const ResourceAnimation::QuantizedRotation& rotation, __m128 scale) {
+	// The shorts are sign extended to ints by unpacking them into the upper half of each lane
+	__m128i shorts = _mm_loadl_epi64((const __m128i*) &rotation);
+	__m128i ints = _mm_srai_epi32(_mm_unpacklo_epi16(shorts, shorts), 16);
+	return _mm_mul_ps(_mm_cvtepi32_ps(ints), scale);
+}
+
 void ResourceAnimation::Load() {
 	MSTimer timer;
 	timer.Start();
@@ -17,57 +37,148 @@ void ResourceAnimation::Load() {
 
 	duration = *((float*) cursor);
 	cursor += sizeof(float);
-	unsigned numKreyFrames = *((unsigned*) cursor);
+	numKeyFrames = *((unsigned*) cursor);
 	cursor += sizeof(unsigned);
 	unsigned numChannels = *((unsigned*) cursor);
 	cursor += sizeof(unsigned);
 
-	keyFrames.resize(numKreyFrames);
+	channelIndices.reserve(numChannels);
+	translations.resize((size_t) numChannels * numKeyFrames);
+	rotations.resize((size_t) numChannels * numKeyFrames);
 
-	for (unsigned i = 0; i < numKreyFrames; ++i) {
-		ResourceAnimation::KeyFrameChannels keyFrame;
+	std::vector<bool> channelFound(numChannels);
+	for (unsigned i = 0; i < numKeyFrames; ++i) {
+		std::fill(channelFound.begin(), channelFound.end(), false);
 
 		for (unsigned j = 0; j < numChannels; ++j) {
-			ResourceAnimation::Channel channel;
-
 			unsigned sizeName = *((unsigned*) cursor);
 			cursor += sizeof(unsigned);
 
-
-			Buffer<char> name(sizeof(char) * (sizeName + 1));
-			memcpy_s(name.Data(), sizeof(char) * sizeName, cursor, sizeof(char) * sizeName);
+			std::string name(cursor, sizeName);
 			cursor += (FILENAME_MAX / 2) * sizeof(char);
 
-			name[sizeName] = '\0';
-
-			channel.tranlation.x = *((float*) cursor);
-			cursor += sizeof(float);
-			channel.tranlation.y = *((float*) cursor);
-			cursor += sizeof(float);
-			channel.tranlation.z = *((float*) cursor);
-			cursor += sizeof(float);
-
-			channel.rotation.x = *((float*) cursor);
-			cursor += sizeof(float);
-			channel.rotation.y = *((float*) cursor);
-			cursor += sizeof(float);
-			channel.rotation.z = *((float*) cursor);
-			cursor += sizeof(float);
-			channel.rotation.w = *((float*) cursor);
-			cursor += sizeof(float);
-
-			keyFrame.channels.emplace(name.Data(), channel);
+			float* values = (float*) cursor;
+			cursor += sizeof(float) * 7;
+
+			// Channels aren't guaranteed to be in the same order in every keyframe, so they are matched by name
+			auto it = channelIndices.emplace(name, (unsigned) channelIndices.size()).first;
+			unsigned channel = it->second;
+			if (channel >= numChannels) {
+				channelIndices.erase(it);
+				continue;
+			}
+
+			size_t index = (size_t) channel * numKeyFrames + i;
+			translations[index] = float3(values[0], values[1], values[2]);
+			rotations[index] = QuantizeRotation(Quat(values[3], values[4], values[5], values[6]));
+			channelFound[channel] = true;
 		}
 
-		keyFrames[i] = keyFrame;
+		// Channels missing in a keyframe keep the pose of the previous one
+		for (unsigned channel = 0; channel < numChannels; ++channel) {
+			if (channelFound[channel] || i == 0) continue;
+
+			size_t index = (size_t) channel * numKeyFrames + i;
+			translations[index] = translations[index - 1];
+			rotations[index] = rotations[index - 1];
+		}
 	}
 
 	unsigned timeMs = timer.Stop();
-	LOG("Animation loaded in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Animation loaded in %ums", timeMs);
 }
 
 void ResourceAnimation::Unload() {
-	keyFrames.clear();
+	numKeyFrames = 0;
+	channelIndices.clear();
+	translations.clear();
+	translations.shrink_to_fit();
+	rotations.clear();
+	rotations.shrink_to_fit();
+}
+
+int ResourceAnimation::FindChannel(const std::string& name) const {
+	auto it = channelIndices.find(name);
+	if (it == channelIndices.end()) return ANIMATION_INVALID_CHANNEL;
+	return (int) it->second;
 }
 
+unsigned ResourceAnimation::GetNumChannels() const {
+	return (unsigned) channelIndices.size();
+}
+
+unsigned ResourceAnimation::GetNumKeyFrames() const {
+	return numKeyFrames;
+}
+
+void ResourceAnimation::SampleChannels(const int* channels, unsigned count, unsigned keyFrame, unsigned nextKeyFrame, float lambda, float3* positions, Quat* outRotations) const {
+	if (numKeyFrames == 0) return;
+
+	keyFrame = Min(keyFrame, numKeyFrames - 1);
+	nextKeyFrame = Min(nextKeyFrame, numKeyFrames - 1);
+
+	__m128 scale = _mm_set1_ps(1.0f / SHRT_MAX);
+	__m128 firstWeight = _mm_set1_ps(1.0f - lambda);
+	__m128 weight = _mm_set1_ps(lambda);
+	__m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 zero = _mm_setzero_ps();
+
+	unsigned i = 0;
+	while (true) {
+		// Gather the next valid channels. The last group is padded by repeating its last channel
+		unsigned indices[ANIMATION_SIMD_WIDTH];
+		unsigned numIndices = 0;
+		for (; i < count && numIndices < ANIMATION_SIMD_WIDTH; ++i) {
+			if (channels[i] != ANIMATION_INVALID_CHANNEL) indices[numIndices++] = i;
+		}
+		if (numIndices == 0) break;
+		for (unsigned lane = numIndices; lane < ANIMATION_SIMD_WIDTH; ++lane) {
+			indices[lane] = indices[numIndices - 1];
+		}
 
+		// Translations are lerped one channel per register, and rotations are decoded one channel per register
+		__m128 firstRotations[ANIMATION_SIMD_WIDTH];
+		__m128 secondRotations[ANIMATION_SIMD_WIDTH];
+		for (unsigned lane = 0; lane < ANIMATION_SIMD_WIDTH; ++lane) {
+			size_t offset = (size_t) channels[indices[lane]] * numKeyFrames;
+			const float3& firstTranslation = translations[offset + keyFrame];
+			const float3& secondTranslation = translations[offset + nextKeyFrame];
+			__m128 first = _mm_setr_ps(firstTranslation.x, firstTranslation.y, firstTranslation.z, 0.0f);
+			__m128 second = _mm_setr_ps(secondTranslation.x, secondTranslation.y, secondTranslation.z, 0.0f);
+			float translation[4];
+			_mm_storeu_ps(translation, _mm_add_ps(_mm_mul_ps(first, firstWeight), _mm_mul_ps(second, weight)));
+			positions[indices[lane]] = float3(translation[0], translation[1], translation[2]);
+
+			firstRotations[lane] = DecodeRotation(rotations[offset + keyFrame], scale);
+			secondRotations[lane] = DecodeRotation(rotations[offset + nextKeyFrame], scale);
+		}
+
+		// Same as AnimationController::Interpolate, with one channel per lane
+		_MM_TRANSPOSE4_PS(firstRotations[0], firstRotations[1], firstRotations[2], firstRotations[3]);
+		_MM_TRANSPOSE4_PS(secondRotations[0], secondRotations[1], secondRotations[2], secondRotations[3]);
+		__m128 x0 = firstRotations[0], y0 = firstRotations[1], z0 = firstRotations[2], w0 = firstRotations[3];
+		__m128 x1 = secondRotations[0], y1 = secondRotations[1], z1 = secondRotations[2], w1 = secondRotations[3];
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_add_ps(_mm_mul_ps(z0, z1), _mm_mul_ps(w0, w1)));
+		__m128 secondWeight = _mm_xor_ps(weight, _mm_and_ps(_mm_cmplt_ps(dot, zero), signMask)); // Minimum arc
+		__m128 x = _mm_add_ps(_mm_mul_ps(x0, firstWeight), _mm_mul_ps(x1, secondWeight));
+		__m128 y = _mm_add_ps(_mm_mul_ps(y0, firstWeight), _mm_mul_ps(y1, secondWeight));
+		__m128 z = _mm_add_ps(_mm_mul_ps(z0, firstWeight), _mm_mul_ps(z1, secondWeight));
+		__m128 w = _mm_add_ps(_mm_mul_ps(w0, firstWeight), _mm_mul_ps(w1, secondWeight));
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+		__m128 invLength = _mm_and_ps(_mm_div_ps(one, length), _mm_cmpgt_ps(length, zero));
+		x = _mm_mul_ps(x, invLength);
+		y = _mm_mul_ps(y, invLength);
+		z = _mm_mul_ps(z, invLength);
+		w = _mm_mul_ps(w, invLength);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		__m128 results[ANIMATION_SIMD_WIDTH] = {x, y, z, w};
+		for (unsigned lane = 0; lane < numIndices; ++lane) {
+			Quat& rotation = outRotations[indices[lane]];
+			float values[4];
+			_mm_storeu_ps(values, results[lane]);
+			rotation = Quat(values[0], values[1], values[2], values[3]);
+		}
+	}
+}
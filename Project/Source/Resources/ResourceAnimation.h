@@ -6,9 +6,14 @@
 #include "Math/Quat.h"
 #include <vector>
 #include <unordered_map>
+#include <climits>
+
+#define ANIMATION_INVALID_CHANNEL -1
+#define ANIMATION_SIMD_WIDTH 4 // Channels sampled per SSE instruction
 
 class ResourceAnimation : public Resource {
 public:
+	// Used to import the animations. Loaded animations are baked into contiguous arrays
 	struct Channel {
 		float3 tranlation = float3::zero;
 		Quat rotation = Quat::identity;
@@ -18,14 +23,33 @@ public:
 		std::unordered_map<std::string, Channel> channels;
 	};
 
+	// Rotations are quantized to 16 bits per component
+	struct QuantizedRotation {
+		short x = 0;
+		short y = 0;
+		short z = 0;
+		short w = SHRT_MAX;
+	};
+
 public:
 	REGISTER_RESOURCE(ResourceAnimation, ResourceType::ANIMATION);
 
 	void Load() override;
 	void Unload() override;
 
-public:
-	std::vector<KeyFrameChannels> keyFrames;
+	int FindChannel(const std::string& name) const; // Returns ANIMATION_INVALID_CHANNEL if no channel animates the given bone
+	unsigned GetNumChannels() const;
+	unsigned GetNumKeyFrames() const;
 
+	// Samples 'count' channels between two keyframes, ANIMATION_SIMD_WIDTH at a time. Channels with index ANIMATION_INVALID_CHANNEL are skipped
+	void SampleChannels(const int* channels, unsigned count, unsigned keyFrame, unsigned nextKeyFrame, float lambda, float3* positions, Quat* outRotations) const;
+
+public:
 	float duration = 0.0f;
+
+private:
+	unsigned numKeyFrames = 0;
+	std::unordered_map<std::string, unsigned> channelIndices;
+	std::vector<float3> translations;		  // The keyframes of each channel are contiguous: [channel * numKeyFrames + keyFrame]
+	std::vector<QuantizedRotation> rotations; // Same layout as the translations
 };
@@ -25,7 +25,7 @@ void ResourceAudioClip::Load() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading audio from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading audio from path: \"%s\".", filePath.c_str());
 
 	ALenum err, format;
 	SNDFILE* sndfile;
@@ -37,7 +37,7 @@ void ResourceAudioClip::Load() {
 	// Open Audio File
 	sndfile = sf_open(filePath.c_str(), SFM_READ, &sfinfo);
 	if (!sndfile) {
-		LOG("Could not open audio in %s: %s", filePath.c_str(), sf_strerror(sndfile));
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Could not open audio in %s: %s", filePath.c_str(), sf_strerror(sndfile));
 		return;
 	}
 	DEFER {
@@ -45,7 +45,7 @@ void ResourceAudioClip::Load() {
 	};
 
 	if (sfinfo.frames < 1 || sfinfo.frames > (sf_count_t)(INT_MAX / sizeof(short)) / sfinfo.channels) {
-		LOG("Bad sample count in %s (%" PRId64 ")", filePath, sfinfo.frames);
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Bad sample count in %s (%" PRId64 ")", filePath.c_str(), sfinfo.frames);
 		return;
 	}
 
@@ -56,7 +56,7 @@ void ResourceAudioClip::Load() {
 		format = AL_FORMAT_STEREO16;
 	}
 	if (!format) {
-		LOG("Unsupported channel count: %d", sfinfo.channels);
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Unsupported channel count: %d", sfinfo.channels);
 		return;
 	}
 
@@ -67,7 +67,7 @@ void ResourceAudioClip::Load() {
 	};
 	numFrames = sf_readf_short(sndfile, audioData, sfinfo.frames);
 	if (numFrames < 1) {
-		LOG("Failed to read samples in %s (%" PRId64 ")", filePath, numFrames);
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to read samples in %s (%" PRId64 ")", filePath.c_str(), numFrames);
 		return;
 	}
 	size = (ALsizei)(numFrames * sfinfo.channels) * (ALsizei) sizeof(short);
@@ -79,7 +79,7 @@ void ResourceAudioClip::Load() {
 	// Check if an error occured, and clean up if so.
 	err = alGetError();
 	if (err != AL_NO_ERROR) {
-		LOG("OpenAL Error: %s", alGetString(err));
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "OpenAL Error: %s", alGetString(err));
 		if (ALbuffer && alIsBuffer(ALbuffer)) {
 			alCall(alDeleteBuffers, 1, &ALbuffer);
 		}
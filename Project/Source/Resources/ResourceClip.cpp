@@ -39,7 +39,7 @@ void ResourceClip::Load() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading ResourceClip from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading ResourceClip from path: \"%s\".", filePath.c_str());
 
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
 	if (buffer.Size() == 0) return;
@@ -47,7 +47,7 @@ void ResourceClip::Load() {
 	rapidjson::Document document;
 	document.ParseInsitu<rapidjson::kParseNanAndInfFlag>(buffer.Data());
 	if (document.HasParseError()) {
-		LOG("Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
 		return;
 	}
 	JsonValue jStateMachine(document, document);
@@ -61,7 +61,7 @@ void ResourceClip::Load() {
 	frameRate = jStateMachine[JSON_TAG_FRAMERATE];
 	if (frameRate <= FLT_MIN) {
 		frameRate = 1;
-		LOG("WARNING frameRate missing");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::WARNING, "WARNING frameRate missing");
 	}
 
 	JsonValue keyEventClipsJson = jStateMachine[JSON_TAG_KEY_EVENT_CLIP];
@@ -76,7 +76,7 @@ void ResourceClip::Load() {
 	App->resources->IncreaseReferenceCount(animationUID);
 
 	unsigned timeMs = timer.Stop();
-	LOG("Clip loaded in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Clip loaded in %ums", timeMs);
 }
 
 void ResourceClip::GetInfoJson() {
@@ -84,7 +84,7 @@ void ResourceClip::GetInfoJson() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Getting info of ResourceClip from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Getting info of ResourceClip from path: \"%s\".", filePath.c_str());
 
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
 	if (buffer.Size() == 0) return;
@@ -92,7 +92,7 @@ void ResourceClip::GetInfoJson() {
 	rapidjson::Document document;
 	document.ParseInsitu<rapidjson::kParseNanAndInfFlag>(buffer.Data());
 	if (document.HasParseError()) {
-		LOG("Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
 		return;
 	}
 	JsonValue jStateMachine(document, document);
@@ -113,7 +113,7 @@ void ResourceClip::GetInfoJson() {
 	}
 
 	unsigned timeMs = timer.Stop();
-	LOG("Clip info received in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Clip info received in %ums", timeMs);
 }
 
 void ResourceClip::Unload() {
@@ -139,8 +139,8 @@ void ResourceClip::OnEditorUpdate() {
 
 	int maxFrames = 0;
 	ResourceAnimation* resourceAnimation = App->resources->GetResource<ResourceAnimation>(animationUID);
-	if (resourceAnimation != nullptr && resourceAnimation->keyFrames.size() != 0) {
-		maxFrames = resourceAnimation->keyFrames.size();
+	if (resourceAnimation != nullptr && resourceAnimation->GetNumKeyFrames() != 0) {
+		maxFrames = resourceAnimation->GetNumKeyFrames();
 	}
 
 	ImGui::Checkbox("Loop", &loop);
@@ -200,7 +200,7 @@ void ResourceClip::OnEditorUpdate() {
 }
 
 bool ResourceClip::SaveToFile(const char* filePath) {
-	LOG("Saving ResourceClip to path: \"%s\".", filePath);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Saving ResourceClip to path: \"%s\".", filePath);
 
 	MSTimer timer;
 	timer.Start();
@@ -233,12 +233,12 @@ bool ResourceClip::SaveToFile(const char* filePath) {
 	// Save to file
 	bool saved = App->files->Save(filePath, stringBuffer.GetString(), stringBuffer.GetSize());
 	if (!saved) {
-		LOG("Failed to save clip resource.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to save clip resource.");
 		return false;
 	}
 
 	unsigned timeMs = timer.Stop();
-	LOG("Clip saved in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Clip saved in %ums", timeMs);
 	return true;
 }
 
@@ -7,6 +7,9 @@
 #include "ft2build.h"
 #include "freetype/freetype.h"
 #include "GL/glew.h"
+#include <vector>
+#include <algorithm>
+#include <string.h>
 
 #include "Utils/Leaks.h"
 
@@ -15,12 +18,12 @@ void ResourceFont::Load() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading font from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading font from path: \"%s\".", filePath.c_str());
 
 	FT_Library ft;
 	//Initiate freetype library. This piece of code should go into Module initialization
 	if (FT_Init_FreeType(&ft)) {
-		LOG("Could not init FreeType library.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Could not init FreeType library.");
 		return;
 	}
 
@@ -28,43 +31,72 @@ void ResourceFont::Load() {
 
 	//Load font as a face
 	if (FT_New_Face(ft, filePath.c_str(), 0, &face)) {
-		LOG("Could not load the font.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Could not load the font.");
 		return;
 	}
 
-	// IF THE HEIGHT IS CHANGED (48), COMPONENTTEXT SCALINGFACTOR MUST BE CHANGED!
-	FT_Set_Pixel_Sizes(face, 0, 48);
+	// IF THE HEIGHT IS CHANGED (FONT_PIXEL_SIZE), COMPONENTTEXT SCALINGFACTOR MUST BE CHANGED!
+	FT_Set_Pixel_Sizes(face, 0, FONT_PIXEL_SIZE);
 
-	//Disable byte-alignment restriction.
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-	// TODO: read char from 32 to 128 + generate only one texture for the whole font
+	// Pack the glyphs in rows from the top left corner of the atlas
+	std::vector<unsigned char> atlasPixels;
+	std::unordered_map<char, float2> glyphPositions;
+	unsigned rowX = FONT_ATLAS_PADDING;
+	unsigned rowY = FONT_ATLAS_PADDING;
+	unsigned rowHeight = 0;
 	for (unsigned char c = 0; c < 128; c++) {
 		if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-			LOG("Failed to load glyph.");
+			LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to load glyph.");
 			continue;
 		}
 
-		unsigned int texture;
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
+		const FT_Bitmap& bitmap = face->glyph->bitmap;
+		if (rowX + bitmap.width + FONT_ATLAS_PADDING > FONT_ATLAS_WIDTH) {
+			rowX = FONT_ATLAS_PADDING;
+			rowY += rowHeight + FONT_ATLAS_PADDING;
+			rowHeight = 0;
+		}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		atlasPixels.resize(std::max(atlasPixels.size(), (size_t)(rowY + bitmap.rows + FONT_ATLAS_PADDING) * FONT_ATLAS_WIDTH), 0);
+		for (unsigned row = 0; row < bitmap.rows; ++row) {
+			memcpy(&atlasPixels[(rowY + row) * FONT_ATLAS_WIDTH + rowX], bitmap.buffer + row * bitmap.pitch, bitmap.width);
+		}
 
-		Character character = {
-			texture,
-			float2(static_cast<float>(face->glyph->bitmap.width), static_cast<float>(face->glyph->bitmap.rows)),
-			float2(static_cast<float>(face->glyph->bitmap_left), static_cast<float>(face->glyph->bitmap_top)),
-			static_cast<unsigned int>(face->glyph->advance.x)};
+		Character character;
+		character.size = float2(static_cast<float>(bitmap.width), static_cast<float>(bitmap.rows));
+		character.bearing = float2(static_cast<float>(face->glyph->bitmap_left), static_cast<float>(face->glyph->bitmap_top));
+		character.advance = static_cast<unsigned int>(face->glyph->advance.x);
 
-		//Store the loaded glyph in the map for later use.
+		//Store the loaded glyph in the map for later use. The UVs are set when the atlas height is known
 		characters.insert(std::pair<char, Character>(c, character));
+		glyphPositions.emplace(c, float2(static_cast<float>(rowX), static_cast<float>(rowY)));
+
+		rowX += bitmap.width + FONT_ATLAS_PADDING;
+		rowHeight = std::max(rowHeight, bitmap.rows);
+	}
+
+	unsigned atlasHeight = std::max((unsigned) (atlasPixels.size() / FONT_ATLAS_WIDTH), 1u);
+	atlasPixels.resize(atlasHeight * FONT_ATLAS_WIDTH, 0);
+	float2 atlasSize = float2(static_cast<float>(FONT_ATLAS_WIDTH), static_cast<float>(atlasHeight));
+	for (auto& entry : characters) {
+		float2 position = glyphPositions[entry.first];
+		entry.second.uvMin = position.Div(atlasSize);
+		entry.second.uvMax = (position + entry.second.size).Div(atlasSize);
 	}
 
+	//Disable byte-alignment restriction.
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	glGenTextures(1, &atlasTexture);
+	glBindTexture(GL_TEXTURE_2D, atlasTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, FONT_ATLAS_WIDTH, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, atlasPixels.data());
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
 	//Reset pixel storage mode to default
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
@@ -73,11 +105,13 @@ void ResourceFont::Load() {
 	FT_Done_FreeType(ft);
 
 	name = FileDialog::GetFileName(filePath.c_str());
+
+	unsigned timeMs = timer.Stop();
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Font loaded in %ums (%ux%u atlas).", timeMs, FONT_ATLAS_WIDTH, atlasHeight);
 }
 
 void ResourceFont::Unload() {
-	for (const auto& entry : characters) {
-		glDeleteTextures(1, &entry.second.textureID);
-	}
+	glDeleteTextures(1, &atlasTexture);
+	atlasTexture = 0;
 	characters.clear();
 }
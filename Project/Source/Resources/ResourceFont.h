@@ -6,8 +6,13 @@
 #include <unordered_map>
 #include <string>
 
+#define FONT_PIXEL_SIZE 48	  // Height of the rasterized glyphs. ComponentText scales them to the font size
+#define FONT_ATLAS_WIDTH 512 // The atlas grows in height to fit all the glyphs
+#define FONT_ATLAS_PADDING 1 // Empty pixels between glyphs, so that linear filtering doesn't sample the neighbours
+
 struct Character {
-	unsigned int textureID = 0;
+	float2 uvMin = float2::zero; // Top left corner of the glyph in the atlas
+	float2 uvMax = float2::zero; // Bottom right corner of the glyph in the atlas
 	float2 size = float2::zero;
 	float2 bearing = float2::zero;
 	unsigned int advance = 0;
@@ -23,4 +28,5 @@ public:
 public:
 	std::unordered_map<char, Character> characters; //Should character be a pointer? It's not a built-in type
 	std::string name = "";
+	unsigned int atlasTexture = 0; // Single-channel texture with all the glyphs, packed in rows
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+// Generation-checked reference to a slot of the ModuleResources' resource table.
+// Handles are resolved once from a UID and then read every frame without locking.
+// A handle becomes stale (resolves to nullptr) when the resource it points to is destroyed.
+struct ResourceHandle {
+	unsigned index = 0;
+	unsigned generation = 0;	 // 0 is never used by a live slot, so a default handle is always invalid
+	unsigned missingVersion = 0; // Table version when the id was last looked up and not found. 0 if it never was
+
+	bool IsValid() const {
+		return generation != 0;
+	}
+};
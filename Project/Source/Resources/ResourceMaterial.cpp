@@ -63,7 +63,7 @@ void ResourceMaterial::Load() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading material from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading material from path: \"%s\".", filePath.c_str());
 
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
 	if (buffer.Size() == 0) return;
@@ -71,7 +71,7 @@ void ResourceMaterial::Load() {
 	rapidjson::Document document;
 	document.ParseInsitu<rapidjson::kParseNanAndInfFlag>(buffer.Data());
 	if (document.HasParseError()) {
-		LOG("Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
 		return;
 	}
 	JsonValue jMaterial(document, document);
@@ -135,11 +135,16 @@ void ResourceMaterial::Load() {
 	App->resources->IncreaseReferenceCount(emissiveMapId);
 	App->resources->IncreaseReferenceCount(ambientOcclusionMapId);
 
+	// The cached shadow maps may have been drawn with the previous version of the material
+	InvalidateShadowCasters();
+
 	unsigned timeMs = timer.Stop();
-	LOG("Material loaded in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Material loaded in %ums", timeMs);
 }
 
 void ResourceMaterial::Unload() {
+	InvalidateShadowCasters();
+
 	App->resources->DecreaseReferenceCount(diffuseMapId);
 	App->resources->DecreaseReferenceCount(specularMapId);
 	App->resources->DecreaseReferenceCount(metallicMapId);
@@ -156,7 +161,7 @@ void ResourceMaterial::Unload() {
 }
 
 void ResourceMaterial::SaveToFile(const char* filePath) {
-	LOG("Saving material to path: \"%s\".", filePath);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Saving material to path: \"%s\".", filePath);
 
 	MSTimer timer;
 	timer.Start();
@@ -240,12 +245,12 @@ void ResourceMaterial::SaveToFile(const char* filePath) {
 	// Save to file
 	bool saved = App->files->Save(filePath, stringBuffer.GetString(), stringBuffer.GetSize());
 	if (!saved) {
-		LOG("Failed to save material resource.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to save material resource.");
 		return;
 	}
 
 	unsigned timeMs = timer.Stop();
-	LOG("Material saved in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Material saved in %ums", timeMs);
 }
 
 void ResourceMaterial::UpdateMask(MaskToChange maskToChange, bool forceDeleteShadows) {
@@ -289,6 +294,18 @@ void ResourceMaterial::UpdateMask(MaskToChange maskToChange, bool forceDeleteSha
 	}
 }
 
+void ResourceMaterial::InvalidateShadowCasters() {
+	if (!castShadows) return;
+
+	if (shadowCasterType == ShadowCasterType::STATIC) {
+		App->renderer->lightFrustumStatic.Invalidate();
+	} else if (shadowCasterType == ShadowCasterType::DYNAMIC) {
+		App->renderer->lightFrustumDynamic.Invalidate();
+	} else {
+		App->renderer->lightFrustumMainEntities.Invalidate();
+	}
+}
+
 void ResourceMaterial::OnEditorUpdate() {
 	// Save Material
 	if (FileDialog::GetFileExtension(GetAssetFilePath().c_str()) == MATERIAL_EXTENSION) {
@@ -348,8 +365,11 @@ void ResourceMaterial::OnEditorUpdate() {
 			for (int n = 0; n < IM_ARRAYSIZE(shadowCasterTypes); ++n) {
 				bool isSelected = (shadowCasterTypeCurrent == shadowCasterTypes[n]);
 				if (ImGui::Selectable(shadowCasterTypes[n], isSelected)) {
+					// The cached shadow maps of both the old and the new caster type have to be redrawn
+					InvalidateShadowCasters();
 					shadowCasterType = static_cast<ShadowCasterType>(n);
 					UpdateMask(MaskToChange::SHADOW);
+					InvalidateShadowCasters();
 				}
 
 				if (isSelected) {
@@ -395,7 +415,12 @@ void ResourceMaterial::OnEditorUpdate() {
 	//Diffuse
 	ImGui::BeginColumns("##diffuse_material", 2, ImGuiColumnsFlags_NoResize | ImGuiColumnsFlags_NoBorder);
 	{
-		ImGui::ResourceSlot<ResourceTexture>("Diffuse Map", &diffuseMapId);
+		// The shadow pass reads the alpha of the diffuse map
+		ImGui::ResourceSlot<ResourceTexture>(
+			"Diffuse Map",
+			&diffuseMapId,
+			[this]() { InvalidateShadowCasters(); },
+			[this]() { InvalidateShadowCasters(); });
 	}
 	ImGui::NextColumn();
 	{
@@ -554,8 +579,11 @@ void ResourceMaterial::OnEditorUpdate() {
 	ImGui::NewLine();
 
 	// Tiling Options
-	ImGui::DragFloat2("Tiling", tiling.ptr(), App->editor->dragSpeed1f, 1, inf);
-	ImGui::DragFloat2("Offset", offset.ptr(), App->editor->dragSpeed3f, -inf, inf);
+	bool tilingChanged = ImGui::DragFloat2("Tiling", tiling.ptr(), App->editor->dragSpeed1f, 1, inf);
+	tilingChanged |= ImGui::DragFloat2("Offset", offset.ptr(), App->editor->dragSpeed3f, -inf, inf);
+	if (tilingChanged) {
+		InvalidateShadowCasters();
+	}
 
 	if (shaderType == MaterialShader::STANDARD_DISSOLVE || shaderType == MaterialShader::UNLIT_DISSOLVE) {
 		ImGui::NewLine();
@@ -2,6 +2,7 @@
 
 #include "Utils/UID.h"
 #include "Resources/Resource.h"
+#include "Resources/ResourceHandle.h"
 #include "Rendering/LightFrustum.h"
 
 #include "Math/float4.h"
@@ -38,6 +39,7 @@ public:
 	void SaveToFile(const char* filePath);
 
 	void UpdateMask(MaskToChange maskToChange, bool forceDeleteShadows = false);
+	void InvalidateShadowCasters(); // Forces the shadow maps of this material's caster type to be redrawn
 
 public:
 	// Material shader
@@ -98,4 +100,13 @@ public:
 	//Shadows
 	ShadowCasterType shadowCasterType = ShadowCasterType::STATIC;
 	bool castShadows = false;
+
+	// Cached texture handles (resolved lazily from the map ids above)
+	ResourceHandle diffuseMapHandle;
+	ResourceHandle specularMapHandle;
+	ResourceHandle metallicMapHandle;
+	ResourceHandle normalMapHandle;
+	ResourceHandle emissiveMapHandle;
+	ResourceHandle ambientOcclusionMapHandle;
+	ResourceHandle dissolveNoiseMapHandle;
 };
\ No newline at end of file
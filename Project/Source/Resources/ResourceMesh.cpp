@@ -5,6 +5,7 @@
 #include "Utils/Logging.h"
 #include "Utils/Buffer.h"
 #include "Utils/MSTimer.h"
+#include "Utils/VertexPacking.h"
 #include "Modules/ModuleFiles.h"
 
 #include "GL/glew.h"
@@ -26,90 +27,119 @@ constexpr unsigned uvSize = sizeof(float) * uvSizeQuantity;
 constexpr unsigned bonesIDSize = sizeof(unsigned) * bonesIDSizeQuantity;
 constexpr unsigned weightsSize = sizeof(float) * weightSizeQuantity;
 
-constexpr unsigned nonPosVertexAttributesSize = normalSize + tangentSize + uvSize + bonesIDSize + weightsSize;
+constexpr unsigned legacyBoneSize = sizeof(unsigned) + sizeof(char) * FILENAME_MAX + sizeof(float) * 10;
+
+// Points to every section of a mesh file, so that both versions can be read the same way without copying them
+struct MeshFileSections {
+	unsigned version = 1;
+	unsigned numVertices = 0;
+	unsigned numIndices = 0;
+	unsigned numBones = 0;
+	unsigned indexSize = sizeof(unsigned);
+	const char* bones = nullptr;
+	const char* stringTable = nullptr;
+	const char* vertices = nullptr; // Version 1: ResourceMesh::Vertex. Version 2: ResourceMesh::StaticVertex followed by ResourceMesh::SkinnedVertex
+	const char* indices = nullptr;
+};
+
+static unsigned AlignTo4(unsigned size) {
+	return (size + 3) & ~3u;
+}
+
+static bool ReadMeshFileSections(const Buffer<char>& buffer, MeshFileSections& sections) {
+	const char* data = buffer.Data();
+	size_t size = buffer.Size();
+	if (data == nullptr || size < sizeof(unsigned) * 3) return false;
+
+	const ResourceMesh::FileHeader* header = (const ResourceMesh::FileHeader*) data;
+	if (size >= sizeof(ResourceMesh::FileHeader) && header->magic == MESH_FORMAT_MAGIC) {
+		if (header->version != MESH_FORMAT_VERSION) {
+			LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Unsupported mesh format version %u.", header->version);
+			return false;
+		}
+
+		sections.version = header->version;
+		sections.numVertices = header->numVertices;
+		sections.numIndices = header->numIndices;
+		sections.numBones = header->numBones;
+		sections.indexSize = header->indexSize;
+
+		const char* cursor = data + sizeof(ResourceMesh::FileHeader);
+		sections.bones = cursor;
+		cursor += sizeof(ResourceMesh::FileBone) * header->numBones;
+		sections.stringTable = cursor;
+		cursor += header->stringTableSize;
+		sections.vertices = cursor;
+		cursor += sizeof(ResourceMesh::StaticVertex) * header->numVertices;
+		if (header->numBones > 0) {
+			cursor += sizeof(ResourceMesh::SkinnedVertex) * header->numVertices;
+		}
+		sections.indices = cursor;
+		cursor += AlignTo4(header->indexSize * header->numIndices);
+
+		return (size_t)(cursor - data) <= size;
+	}
+
+	// Version 1
+	const unsigned* legacyHeader = (const unsigned*) data;
+	sections.numVertices = legacyHeader[0];
+	sections.numIndices = legacyHeader[1];
+	sections.numBones = legacyHeader[2];
+
+	const char* cursor = data + sizeof(unsigned) * 3;
+	sections.bones = cursor;
+	cursor += legacyBoneSize * sections.numBones;
+	sections.vertices = cursor;
+	cursor += sizeof(ResourceMesh::Vertex) * sections.numVertices;
+	sections.indices = cursor;
+	cursor += sizeof(unsigned) * sections.numIndices;
+
+	return (size_t)(cursor - data) <= size;
+}
 
 void ResourceMesh::Load() {
 	// Timer to measure loading a mesh
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading mesh from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading mesh from path: \"%s\".", filePath.c_str());
 
 	// Load file
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
-	char* cursor = buffer.Data();
-
-	// Header
-	unsigned numVertices = *((unsigned*) cursor);
-	cursor += sizeof(unsigned);
-	unsigned numIndices = *((unsigned*) cursor);
-	cursor += sizeof(unsigned);
-	unsigned numBones = *((unsigned*) cursor);
-	cursor += sizeof(unsigned);
-
-	// Bones
-	bones.resize(numBones);
-	for (unsigned i = 0; i < numBones; ++i) {
-		float3 position, scaling;
-		Quat rotation;
-
-		unsigned lengthName = *((unsigned*) cursor);
-		cursor += sizeof(unsigned);
-
-		char* name = (char*) malloc((lengthName + 1) * sizeof(char));
-
-		memcpy_s(name, lengthName * sizeof(char), cursor, lengthName * sizeof(char));
-		cursor += FILENAME_MAX * sizeof(char);
-
-		name[lengthName] = '\0';
-
-		// Translation
-		position.x = *((float*) cursor);
-		cursor += sizeof(float);
-		position.y = *((float*) cursor);
-		cursor += sizeof(float);
-		position.z = *((float*) cursor);
-		cursor += sizeof(float);
-
-		// Scaling
-		scaling.x = *((float*) cursor);
-		cursor += sizeof(float);
-		scaling.y = *((float*) cursor);
-		cursor += sizeof(float);
-		scaling.z = *((float*) cursor);
-		cursor += sizeof(float);
-
-		// Rotation
-		rotation.x = *((float*) cursor);
-		cursor += sizeof(float);
-		rotation.y = *((float*) cursor);
-		cursor += sizeof(float);
-		rotation.z = *((float*) cursor);
-		cursor += sizeof(float);
-		rotation.w = *((float*) cursor);
-		cursor += sizeof(float);
-
-		bones[i].transform = float4x4::FromTRS(position, rotation, scaling);
-		bones[i].boneName = name;
-
-		free(name);
+	MeshFileSections sections;
+	if (!ReadMeshFileSections(buffer, sections)) {
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Invalid mesh file: \"%s\".", filePath.c_str());
+		return;
 	}
 
-	LOG("Loading %i vertices...", numVertices);
+	numVertices = sections.numVertices;
+	numIndices = sections.numIndices;
+	indexType = sections.indexSize == sizeof(unsigned short) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 
-	// Vertices
-	vertices.resize(numVertices);
-	for (unsigned i = 0; i < numVertices; ++i) {
-		vertices[i] = *((Vertex*) cursor);
-		cursor += sizeof(Vertex);
+	// Bones
+	bones.resize(sections.numBones);
+	if (sections.version == 1) {
+		const char* cursor = sections.bones;
+		for (unsigned i = 0; i < sections.numBones; ++i) {
+			unsigned lengthName = *((unsigned*) cursor);
+			cursor += sizeof(unsigned);
+			bones[i].boneName = std::string(cursor, lengthName);
+			cursor += FILENAME_MAX * sizeof(char);
+
+			// Translation, scaling and rotation
+			const float* trs = (const float*) cursor;
+			bones[i].transform = float4x4::FromTRS(float3(trs[0], trs[1], trs[2]), Quat(trs[6], trs[7], trs[8], trs[9]), float3(trs[3], trs[4], trs[5]));
+			cursor += sizeof(float) * 10;
+		}
+	} else {
+		const FileBone* fileBones = (const FileBone*) sections.bones;
+		for (unsigned i = 0; i < sections.numBones; ++i) {
+			bones[i].transform.Set(fileBones[i].transform);
+			bones[i].boneName = sections.stringTable + fileBones[i].nameOffset;
+		}
 	}
 
-	// Indices
-	indices.resize(numIndices);
-	for (unsigned i = 0; i < numIndices; ++i) {
-		indices[i] = *((unsigned*) cursor);
-		cursor += sizeof(unsigned);
-	}
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading %i vertices...", numVertices);
 
 	// Create VAO
 	glGenVertexArrays(1, &vao);
@@ -120,38 +150,68 @@ void ResourceMesh::Load() {
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
 
-	// Load VBO
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), (bones.size() > 0) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
-
-	// Load EBO
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned), indices.data(), GL_STATIC_DRAW);
+	// Load VBO and EBO straight from the file buffer
+	GLenum usage = (bones.size() > 0) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+	if (sections.version == 1) {
+		glBufferData(GL_ARRAY_BUFFER, numVertices * sizeof(Vertex), sections.vertices, usage);
+	} else {
+		unsigned vertexSize = sizeof(StaticVertex) + (bones.size() > 0 ? sizeof(SkinnedVertex) : 0);
+		glBufferData(GL_ARRAY_BUFFER, numVertices * vertexSize, sections.vertices, usage);
+	}
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sections.indexSize, sections.indices, GL_STATIC_DRAW);
 
 	// Load vertex attributes
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glEnableVertexAttribArray(2);
 	glEnableVertexAttribArray(3);
-	glEnableVertexAttribArray(4);
-	glEnableVertexAttribArray(5);
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) 0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) positionSize);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) (positionSize + normalSize));
-	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) (positionSize + normalSize + tangentSize));
-	glVertexAttribIPointer(4, 4, GL_UNSIGNED_INT, sizeof(Vertex), (void*) (positionSize + normalSize + tangentSize + uvSize));
-	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) (positionSize + normalSize + tangentSize + uvSize + bonesIDSize));
+	if (sections.version == 1) {
+		glEnableVertexAttribArray(4);
+		glEnableVertexAttribArray(5);
+
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) 0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) positionSize);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) (positionSize + normalSize));
+		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) (positionSize + normalSize + tangentSize));
+		glVertexAttribIPointer(4, 4, GL_UNSIGNED_INT, sizeof(Vertex), (void*) (positionSize + normalSize + tangentSize + uvSize));
+		glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) (positionSize + normalSize + tangentSize + uvSize + bonesIDSize));
+	} else {
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*) offsetof(StaticVertex, position));
+		glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(StaticVertex), (void*) offsetof(StaticVertex, normal));
+		glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(StaticVertex), (void*) offsetof(StaticVertex, tangent));
+		glVertexAttribPointer(3, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*) offsetof(StaticVertex, uv));
+
+		// The skinned stream goes after the static one. Static meshes don't have it
+		if (bones.size() > 0) {
+			size_t skinnedOffset = numVertices * sizeof(StaticVertex);
+			glEnableVertexAttribArray(4);
+			glEnableVertexAttribArray(5);
+
+			glVertexAttribIPointer(4, 4, GL_UNSIGNED_BYTE, sizeof(SkinnedVertex), (void*) (skinnedOffset + offsetof(SkinnedVertex, bones)));
+			glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SkinnedVertex), (void*) (skinnedOffset + offsetof(SkinnedVertex, weights)));
+		}
+	}
 
 	// Unbind VAO
 	glBindVertexArray(0);
 
 	unsigned timeMs = timer.Stop();
-	LOG("Mesh loaded in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Mesh loaded in %ums", timeMs);
 }
 
 void ResourceMesh::Unload() {
 	bones.clear();
-	vertices.clear();
-	indices.clear();
+	numVertices = 0;
+	numIndices = 0;
+
+	geometryCached = false;
+	cachedPositions.clear();
+	cachedPositions.shrink_to_fit();
+	cachedNormals.clear();
+	cachedNormals.shrink_to_fit();
+	cachedIndices.clear();
+	cachedIndices.shrink_to_fit();
 
 	if (vao) {
 		glDeleteVertexArrays(1, &vao);
@@ -170,57 +230,67 @@ void ResourceMesh::Unload() {
 }
 
 std::vector<Triangle> ResourceMesh::ExtractTriangles(const float4x4& modelMatrix) const {
+	std::vector<Triangle> triangles;
+	if (!CacheGeometry()) return triangles;
+
+	triangles.reserve(cachedIndices.size() / 3);
+	for (unsigned i = 0; i + 2 < cachedIndices.size(); i += 3) {
+		float3 a = (modelMatrix * float4(cachedPositions[cachedIndices[i]], 1)).xyz();
+		float3 b = (modelMatrix * float4(cachedPositions[cachedIndices[i + 1]], 1)).xyz();
+		float3 c = (modelMatrix * float4(cachedPositions[cachedIndices[i + 2]], 1)).xyz();
+		triangles.push_back(Triangle(a, b, c));
+	}
+
+	return triangles;
+}
+
+bool ResourceMesh::ReadGeometry(std::vector<float3>& positions, std::vector<float3>& normals, std::vector<unsigned>& indices) const {
+	if (!CacheGeometry()) return false;
+
+	positions = cachedPositions;
+	normals = cachedNormals;
+	indices = cachedIndices;
+	return true;
+}
+
+bool ResourceMesh::CacheGeometry() const {
+	if (geometryCached) return true;
+
 	std::string filePath = GetResourceFilePath();
 
 	// Load file
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
-	char* cursor = buffer.Data();
-
-	// Header
-	unsigned numVertices = *((unsigned*) cursor);
-	cursor += sizeof(unsigned);
-	unsigned numIndices = *((unsigned*) cursor);
-	cursor += sizeof(unsigned);
-	unsigned numBones = *((unsigned*) cursor);
-	cursor += sizeof(unsigned);
-
-	// Bones
-	for (unsigned i = 0; i < numBones; ++i) {
-		// bone name size
-		cursor += sizeof(unsigned);
-		// bone name
-		cursor += FILENAME_MAX * sizeof(char);
-		// translation, scaling, rotation
-		cursor += sizeof(float) * 10;
-	}
+	MeshFileSections sections;
+	if (!ReadMeshFileSections(buffer, sections)) return false;
 
 	// Vertices
-	std::vector<float3> vertices;
-	for (unsigned i = 0; i < numVertices; ++i) {
-		float vertex[3] = {};
-		vertex[0] = *((float*) cursor);
-		cursor += sizeof(float);
-		vertex[1] = *((float*) cursor);
-		cursor += sizeof(float);
-		vertex[2] = *((float*) cursor);
-		cursor += sizeof(float);
-		cursor += nonPosVertexAttributesSize;
-
-		vertices.push_back((modelMatrix * float4(vertex[0], vertex[1], vertex[2], 1)).xyz());
+	cachedPositions.resize(sections.numVertices);
+	cachedNormals.resize(sections.numVertices);
+	if (sections.version == 1) {
+		const Vertex* vertices = (const Vertex*) sections.vertices;
+		for (unsigned i = 0; i < sections.numVertices; ++i) {
+			cachedPositions[i] = vertices[i].position;
+			cachedNormals[i] = vertices[i].normal;
+		}
+	} else {
+		const StaticVertex* vertices = (const StaticVertex*) sections.vertices;
+		for (unsigned i = 0; i < sections.numVertices; ++i) {
+			cachedPositions[i] = vertices[i].position;
+			cachedNormals[i] = UnpackNormal(vertices[i].normal);
+		}
 	}
 
-	std::vector<Triangle> triangles;
-	triangles.reserve(numIndices / 3);
-	for (unsigned i = 0; i < numIndices / 3; ++i) {
-		unsigned triangeIndices[3] = {};
-		triangeIndices[0] = *((unsigned*) cursor);
-		cursor += sizeof(unsigned);
-		triangeIndices[1] = *((unsigned*) cursor);
-		cursor += sizeof(unsigned);
-		triangeIndices[2] = *((unsigned*) cursor);
-		cursor += sizeof(unsigned);
-		triangles.push_back(Triangle(vertices[triangeIndices[0]], vertices[triangeIndices[1]], vertices[triangeIndices[2]]));
+	// Indices
+	cachedIndices.resize(sections.numIndices);
+	if (sections.indexSize == sizeof(unsigned short)) {
+		const unsigned short* shortIndices = (const unsigned short*) sections.indices;
+		for (unsigned i = 0; i < sections.numIndices; ++i) {
+			cachedIndices[i] = shortIndices[i];
+		}
+	} else {
+		memcpy(cachedIndices.data(), sections.indices, sections.numIndices * sizeof(unsigned));
 	}
 
-	return triangles;
+	geometryCached = true;
+	return true;
 }
@@ -9,6 +9,10 @@
 #include <string>
 #include <vector>
 
+#define MESH_FORMAT_MAGIC 0x4853454D // "MESH". Version 1 files start with the vertex count instead
+#define MESH_FORMAT_VERSION 2
+#define MESH_MAX_BONES 256 // Skinned vertices store their bone indices in one byte
+
 class ResourceMesh : public Resource {
 public:
 	struct Bone {
@@ -22,6 +26,7 @@ public:
 		float weights[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 	};
 
+	// Vertex layout of the version 1 mesh format. Files without a FileHeader use it
 	struct Vertex {
 		float3 position = {0.0f, 0.0f, 0.0f};
 		float3 normal = {0.0f, 0.0f, 0.0f};
@@ -31,6 +36,36 @@ public:
 		float weights[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 	};
 
+	// --- Version 2 mesh format --- //
+	// Header | Bones | Bone name string table | Static vertex stream | Skinned vertex stream (only if it has bones) | Indices
+	// Every section starts 4-byte aligned. The streams have the same layout as the VBO, so they are uploaded as they are
+	struct FileHeader {
+		unsigned magic = 0;
+		unsigned version = 0;
+		unsigned numVertices = 0;
+		unsigned numIndices = 0;
+		unsigned numBones = 0;
+		unsigned indexSize = 0;		  // 2 or 4 bytes
+		unsigned stringTableSize = 0; // Padded to 4 bytes
+	};
+
+	struct FileBone {
+		float transform[16] = {}; // Row-major. Stored as floats so that it doesn't need float4x4 alignment
+		unsigned nameOffset = 0;  // Offset in the string table. Names are null-terminated
+	};
+
+	struct StaticVertex {
+		float3 position = {0.0f, 0.0f, 0.0f};
+		unsigned normal = 0;			 // Signed normalized 10-10-10-2
+		unsigned tangent = 0;			 // Signed normalized 10-10-10-2
+		unsigned short uv[2] = {0, 0}; // Half floats
+	};
+
+	struct SkinnedVertex {
+		unsigned char bones[4] = {0, 0, 0, 0};
+		unsigned char weights[4] = {0, 0, 0, 0}; // Unsigned normalized. They add up to 255
+	};
+
 public:
 	REGISTER_RESOURCE(ResourceMesh, ResourceType::MESH);
 
@@ -38,13 +73,26 @@ public:
 	void Unload() override;
 
 	std::vector<Triangle> ExtractTriangles(const float4x4& modelMatrix) const;
+	bool ReadGeometry(std::vector<float3>& positions, std::vector<float3>& normals, std::vector<unsigned>& indices) const; // Copies the geometry used by tools (navigation, picking...). It's read from the resource file on the first call and kept until the mesh is unloaded
+
+private:
+	bool CacheGeometry() const; // Reads the positions, normals and indices from the resource file if they aren't cached yet
 
 public:
 	unsigned vbo = 0;
 	unsigned ebo = 0;
 	unsigned vao = 0;
 
+	unsigned numVertices = 0;
+	unsigned numIndices = 0;
+	unsigned indexType = 0; // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+
 	std::vector<Bone> bones;
-	std::vector<Vertex> vertices;
-	std::vector<unsigned> indices;
+
+private:
+	// CPU copy of the geometry, since the GPU copy can't be read back. Filled the first time a tool needs it
+	mutable bool geometryCached = false;
+	mutable std::vector<float3> cachedPositions;
+	mutable std::vector<float3> cachedNormals;
+	mutable std::vector<unsigned> cachedIndices;
 };
\ No newline at end of file
@@ -17,14 +17,14 @@ void ResourceNavMesh::Load() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading mesh from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading mesh from path: \"%s\".", filePath.c_str());
 
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
 	App->navigation->GetNavMesh().Load(buffer);
 	App->navigation->navMeshId = GetId();
 
 	unsigned timeMs = timer.Stop();
-	LOG("Mesh loaded in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Mesh loaded in %ums", timeMs);
 }
 
 void ResourceNavMesh::Unload() {
@@ -11,6 +11,8 @@
 
 #include "rapidjson/error/en.h"
 
+#include <algorithm>
+
 #define JSON_TAG_ROOT "Root"
 #define JSON_TAG_NAME "Name"
 #define JSON_TAG_PARENT_INDEX "ParentIndex"
@@ -21,7 +23,7 @@ void ResourcePrefab::Load() {
 	timer.Start();
 
 	std::string filePath = GetResourceFilePath();
-	LOG("Building prefab from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Building prefab from path: \"%s\".", filePath.c_str());
 
 	// Read from file
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
@@ -31,7 +33,7 @@ void ResourcePrefab::Load() {
 	document = new rapidjson::Document();
 	document->Parse<rapidjson::kParseNanAndInfFlag>(buffer.Data());
 	if (document->HasParseError()) {
-		LOG("Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document->GetParseError()), document->GetErrorOffset());
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document->GetParseError()), document->GetErrorOffset());
 		return;
 	}
 
@@ -50,34 +52,76 @@ void ResourcePrefab::Load() {
 	gameObject->SetParent(nullptr);
 	gameObject->LoadPrefab(jRoot);
 
+	// Compile the template used to create the instances
+	prefabTemplate.Compile(*document, (*document)[JSON_TAG_ROOT]);
+
 	unsigned timeMs = timer.Stop();
-	LOG("Prefab loaded in %ums.", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Prefab loaded in %ums (%u GameObjects, %u components).", timeMs, prefabTemplate.GetGameObjectCount(), prefabTemplate.GetComponentCount());
 
 	prefabScene->root->Init();
 }
 
 void ResourcePrefab::Unload() {
+	prefabTemplate.Clear();
+	pooledInstances.clear();
 	RELEASE(document);
 	RELEASE(prefabScene);
 }
 
 UID ResourcePrefab::BuildPrefab(GameObject* parent) {
-	JsonValue jPrefab(*document, *document);
+	GameObject* gameObject = Instantiate(parent);
+	return gameObject != nullptr ? gameObject->GetID() : 0;
+}
 
-	// Load GameObjects
-	Scene* scene = parent->scene;
-	JsonValue jRoot = jPrefab[JSON_TAG_ROOT];
-	UID gameObjectId = GenerateUID();
-	GameObject* gameObject = scene->gameObjects.Obtain(gameObjectId);
-	gameObject->scene = scene;
-	gameObject->id = gameObjectId;
-	gameObject->SetParent(parent);
-	gameObject->LoadPrefab(jRoot);
+GameObject* ResourcePrefab::Instantiate(GameObject* parent) {
+	GameObject* gameObject = prefabTemplate.Instantiate(parent);
+	if (gameObject == nullptr) return nullptr;
 
+	gameObject->SetPrefabId(GetId());
 	gameObject->Init();
 	if (App->time->HasGameStarted()) {
 		gameObject->Start();
 	}
 
-	return gameObjectId;
-}
\ No newline at end of file
+	return gameObject;
+}
+
+void ResourcePrefab::SetPoolSize(unsigned poolSize_) {
+	poolSize = poolSize_;
+	if (pooledInstances.size() > poolSize) {
+		pooledInstances.resize(poolSize);
+	}
+}
+
+unsigned ResourcePrefab::GetPoolSize() const {
+	return poolSize;
+}
+
+GameObject* ResourcePrefab::TakeFromPool(GameObject* parent) {
+	Scene* scene = parent->scene;
+	while (!pooledInstances.empty()) {
+		UID instanceId = pooledInstances.back();
+		pooledInstances.pop_back();
+
+		GameObject* instance = scene->GetGameObject(instanceId);
+		if (instance == nullptr || instance->GetPrefabId() != GetId() || instance->IsActiveInternal()) continue;
+
+		if (instance->GetParent() != parent) {
+			instance->SetParent(parent);
+		}
+		instance->Enable();
+		return instance;
+	}
+
+	return nullptr;
+}
+
+bool ResourcePrefab::ReturnToPool(GameObject* instance) {
+	if (instance->GetPrefabId() != GetId()) return false;
+	if (std::find(pooledInstances.begin(), pooledInstances.end(), instance->GetID()) != pooledInstances.end()) return true;
+	if (pooledInstances.size() >= poolSize) return false;
+
+	instance->Disable();
+	pooledInstances.push_back(instance->GetID());
+	return true;
+}
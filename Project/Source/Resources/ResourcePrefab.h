@@ -2,10 +2,18 @@
 
 #include "Globals.h"
 #include "Resources/Resource.h"
+#include "Utils/PrefabTemplate.h"
+
+#include <vector>
 
 class GameObject;
 class Scene;
 
+/* Instances are created from a PrefabTemplate compiled when the prefab is loaded.
+*  Prefabs can keep a pool of despawned instances (disabled, but still in the scene). The pool is empty by default,
+*  and is enabled with SetPoolSize. Pooled instances keep the state they had when they were despawned.
+*/
+
 class ResourcePrefab : public Resource {
 public:
 	REGISTER_RESOURCE(ResourcePrefab, ResourceType::PREFAB);
@@ -14,8 +22,19 @@ public:
 	void Unload() override;
 
 	TESSERACT_ENGINE_API UID BuildPrefab(GameObject* parent);
+	TESSERACT_ENGINE_API GameObject* Instantiate(GameObject* parent); // Same as BuildPrefab, but returns the instance instead of its id
+
+	// --- Instance pool --- //
+	TESSERACT_ENGINE_API void SetPoolSize(unsigned poolSize_); // Maximum number of despawned instances kept to be reused
+	TESSERACT_ENGINE_API unsigned GetPoolSize() const;
+	GameObject* TakeFromPool(GameObject* parent); // Enables a pooled instance under 'parent'. Returns nullptr if there are none
+	bool ReturnToPool(GameObject* instance);	  // Disables the instance and keeps it to be reused. Returns false if the pool is full or it isn't an instance of this prefab
 
 private:
 	rapidjson::Document* document = nullptr;
 	Scene* prefabScene = nullptr;
+	PrefabTemplate prefabTemplate;
+
+	unsigned poolSize = 0;
+	std::vector<UID> pooledInstances; // Ids of the despawned instances. They are checked when taken, since the scene could have destroyed them
 };
@@ -13,12 +13,12 @@ void ResourceShader::Load() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading shader from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading shader from path: \"%s\".", filePath.c_str());
 
 	shaderProgram = App->programs->CreateProgram(filePath.c_str());
 
 	unsigned timeMs = timer.Stop();
-	LOG("Shader loaded in %ums.", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Shader loaded in %ums.", timeMs);
 }
 
 void ResourceShader::Unload() {
@@ -59,7 +59,7 @@ static void RenderToCubemap(unsigned cubemap, int resolution, ProgramCubemapRend
 
 void ResourceSkybox::Load() {
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading skybox from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading skybox from path: \"%s\".", filePath.c_str());
 
 	// Get shaders
 	ProgramHDRToCubemap* hdrToCubemapProgram = App->programs->hdrToCubemap;
@@ -67,7 +67,7 @@ void ResourceSkybox::Load() {
 	ProgramPreFilteredMap* preFilteredMapProgram = App->programs->preFilteredMap;
 	ProgramEnvironmentBRDF* environmentBRDFProgram = App->programs->environmentBRDF;
 	if (!hdrToCubemapProgram || !irradianceProgram || !preFilteredMapProgram || !environmentBRDFProgram) {
-		LOG("ERROR: Shaders haven't been loaded.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "ERROR: Shaders haven't been loaded.");
 		return;
 	}
 
@@ -75,6 +75,9 @@ void ResourceSkybox::Load() {
 	MSTimer timer;
 	timer.Start();
 
+	// DevIL can only be used by one thread at a time
+	std::lock_guard<std::mutex> lock(App->resources->imageLibraryMutex);
+
 	// Generate image handler
 	unsigned image;
 	ilGenImages(1, &image);
@@ -86,14 +89,14 @@ void ResourceSkybox::Load() {
 	ilBindImage(image);
 	bool imageLoaded = ilLoad(IL_HDR, filePath.c_str());
 	if (!imageLoaded) {
-		LOG("Failed to load image.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to load image.");
 		return;
 	}
 
 	// Convert image
 	bool imageConverted = ilConvertImage(IL_RGB, IL_FLOAT);
 	if (!imageConverted) {
-		LOG("Failed to convert image.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to convert image.");
 		return;
 	}
 
@@ -235,7 +238,7 @@ void ResourceSkybox::Load() {
 	glDrawArrays(GL_TRIANGLES, 0, 3);
 
 	unsigned timeMs = timer.Stop();
-	LOG("Skybox loaded in %ums.", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Skybox loaded in %ums.", timeMs);
 }
 
 void ResourceSkybox::Unload() {
@@ -42,7 +42,7 @@ void ResourceStateMachine::Load() {
 	MSTimer timer;
 	timer.Start();
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading material from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading material from path: \"%s\".", filePath.c_str());
 
 	Buffer<char> buffer = App->files->Load(filePath.c_str());
 	if (buffer.Size() == 0) return;
@@ -50,7 +50,7 @@ void ResourceStateMachine::Load() {
 	rapidjson::Document document;
 	document.ParseInsitu<rapidjson::kParseNanAndInfFlag>(buffer.Data());
 	if (document.HasParseError()) {
-		LOG("Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Error parsing JSON: %s (offset: %u)", rapidjson::GetParseError_En(document.GetParseError()), document.GetErrorOffset());
 		return;
 	}
 	JsonValue jStateMachine(document, document);
@@ -104,7 +104,7 @@ void ResourceStateMachine::Load() {
 	}
 
 	unsigned timeMs = timer.Stop();
-	LOG("Material loaded in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Material loaded in %ums", timeMs);
 }
 
 void ResourceStateMachine::Unload() {
@@ -120,7 +120,7 @@ void ResourceStateMachine::Unload() {
 }
 
 void ResourceStateMachine::SaveToFile(const char* filePath) {
-	LOG("Saving ResourceStateMachine to path: \"%s\".", filePath);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Saving ResourceStateMachine to path: \"%s\".", filePath);
 
 	MSTimer timer;
 	timer.Start();
@@ -181,19 +181,19 @@ void ResourceStateMachine::SaveToFile(const char* filePath) {
 	// Save to file
 	bool saved = App->files->Save(filePath, stringBuffer.GetString(), stringBuffer.GetSize());
 	if (!saved) {
-		LOG("Failed to save material resource.");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to save material resource.");
 		return;
 	}
 
 	unsigned timeMs = timer.Stop();
-	LOG("Material saved in %ums", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Material saved in %ums", timeMs);
 }
 
 void ResourceStateMachine::OnEditorUpdate() {
 	ImGui::TextColored(App->editor->titleColor, "Resource State Machine");
 
 	if (ImGui::Button("Generate JSON State Machin##StateMacghin")) {
-		LOG("Generate JSON State Machin");
+		LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Generate JSON State Machin");
 		std::string filePath = GetAssetFilePath();
 		StateMachineGenerator::GenerateStateMachine(filePath.c_str());
 	}
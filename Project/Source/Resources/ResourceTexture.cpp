@@ -26,7 +26,7 @@
 
 void ResourceTexture::Load() {
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading texture from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading texture from path: \"%s\".", filePath.c_str());
 
 	// Timer to measure loading a texture
 	MSTimer timer;
@@ -63,6 +63,9 @@ void ResourceTexture::Load() {
 		break;
 	}
 	default: {
+		// DevIL can only be used by one thread at a time
+		std::lock_guard<std::mutex> lock(App->resources->imageLibraryMutex);
+
 		// Generate image handler
 		unsigned image;
 		ilGenImages(1, &image);
@@ -73,7 +76,7 @@ void ResourceTexture::Load() {
 		ilBindImage(image);
 		bool imageLoaded = ilLoad(IL_TGA, filePath.c_str());
 		if (!imageLoaded) {
-			LOG("Failed to load image.");
+			LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to load image.");
 			return;
 		}
 
@@ -86,7 +89,7 @@ void ResourceTexture::Load() {
 		// Convert image
 		bool imageConverted = ilConvertImage(format, IL_UNSIGNED_BYTE);
 		if (!imageConverted) {
-			LOG("Failed to convert image.");
+			LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::CRITICAL, "Failed to convert image.");
 			return;
 		}
 
@@ -139,7 +142,7 @@ void ResourceTexture::Load() {
 	UpdateMagFilter(magFilter);
 
 	unsigned timeMs = timer.Stop();
-	LOG("Texture loaded in %ums.", timeMs);
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Texture loaded in %ums.", timeMs);
 }
 
 void ResourceTexture::Unload() {
@@ -3,7 +3,7 @@
 
 void ResourceVideo::Load() {
 	std::string filePath = GetResourceFilePath();
-	LOG("Loading video from path: \"%s\".", filePath.c_str());
+	LOG_CATEGORY(LogCategory::RESOURCES, LogSeverity::VERBOSE, "Loading video from path: \"%s\".", filePath.c_str());
 }
 
 void ResourceVideo::Unload() {
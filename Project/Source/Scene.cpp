@@ -11,6 +11,7 @@
 #include "Modules/ModuleWindow.h"
 #include "Modules/ModuleProject.h"
 #include "Modules/ModuleResources.h"
+#include "Modules/ModuleJobs.h"
 #include "Scripting/PropertyMap.h"
 #include "Resources/ResourceMesh.h"
 #include "Utils/Logging.h"
@@ -28,6 +29,10 @@
 #define JSON_TAG_CURSOR_HEIGHT "CursorHeight"
 #define JSON_TAG_CURSOR "Cursor"
 
+#define BOUNDING_BOX_REFRESH_BATCH_SIZE 256 // Culling candidates whose bounds are refreshed by each job
+#define FRUSTUM_CULLING_BATCH_WORDS 16 // Words of the visibility mask (32 candidates each) tested by each job
+#define TRANSFORM_UPDATE_BATCH_SIZE 512 // Transforms of a level updated by each job
+
 Scene::Scene(unsigned numGameObjects) {
 	gameObjects.Allocate(numGameObjects);
 
@@ -75,6 +80,12 @@ void Scene::ClearScene() {
 	DestroyGameObject(root);
 	root = nullptr;
 	quadtree.Clear();
+	raycastTree.Clear();
+	raycastTreeDirty = true;
+	raycastMovedBoundingBoxes.clear();
+	dynamicTree.Clear();
+	movedBoundingBoxes.clear();
+	transformHierarchy.Clear();
 
 	assert(gameObjects.Count() == 0); // There should be no GameObjects outside the scene hierarchy
 	gameObjects.Clear();			  // This looks redundant, but it resets the free list so that GameObject order is mantained when saving/loading
@@ -96,6 +107,8 @@ void Scene::RebuildQuadtree() {
 		}
 	}
 	quadtree.Optimize();
+
+	QueueAllBoundingBoxes();
 }
 
 void Scene::ClearQuadtree() {
@@ -103,6 +116,101 @@ void Scene::ClearQuadtree() {
 	for (GameObject& gameObject : gameObjects) {
 		gameObject.isInQuadtree = false;
 	}
+
+	QueueAllBoundingBoxes();
+}
+
+void Scene::UpdateRaycastTree() {
+	if (!raycastTreeDirty && raycastMovedBoundingBoxes.empty()) return;
+
+	// Refitting degrades the tree as objects move, so it's rebuilt once as many boxes have been refitted as there are in the tree.
+	// That keeps the cost of the rebuilds proportional to the number of moves
+	raycastTreeRefits += (unsigned) raycastMovedBoundingBoxes.size();
+	if (raycastTreeDirty || raycastTreeRefits >= raycastTree.GetElementCount()) {
+		raycastTree.Clear();
+		for (ComponentBoundingBox& boundingBox : boundingBoxComponents) {
+			raycastTree.Add(&boundingBox, boundingBox.GetWorldAABB());
+		}
+		raycastTree.Build();
+		raycastTreeRefits = 0;
+		raycastTreeDirty = false;
+	} else {
+		raycastTree.Refit(raycastMovedBoundingBoxes, [](ComponentBoundingBox* boundingBox) { return boundingBox->GetWorldAABB(); });
+	}
+	raycastMovedBoundingBoxes.clear();
+}
+
+void Scene::UpdateDynamicTree() {
+	for (ComponentBoundingBox* boundingBox : movedBoundingBoxes) {
+		boundingBox->SetDynamicTreeQueueIndex(BOUNDING_BOX_NOT_QUEUED);
+
+		int leaf = boundingBox->GetDynamicTreeLeaf();
+		if (boundingBox->GetOwner().isInQuadtree) {
+			if (leaf != DYNAMIC_AABB_TREE_NULL_NODE) {
+				dynamicTree.Remove(leaf);
+				boundingBox->SetDynamicTreeLeaf(DYNAMIC_AABB_TREE_NULL_NODE);
+			}
+		} else if (leaf == DYNAMIC_AABB_TREE_NULL_NODE) {
+			boundingBox->SetDynamicTreeLeaf(dynamicTree.Insert(boundingBox, boundingBox->GetWorldAABB()));
+		} else {
+			dynamicTree.Move(leaf, boundingBox->GetWorldAABB());
+		}
+	}
+	movedBoundingBoxes.clear();
+}
+
+void Scene::QueueDynamicTreeUpdate(ComponentBoundingBox* boundingBox) {
+	// Ray queries can come after a move in the same frame, so the raycast tree is refitted on the next one.
+	// A box can be queued more than once, so the queue is dropped for a rebuild once it has more entries than there are boxes
+	if (!raycastTreeDirty) {
+		raycastMovedBoundingBoxes.push_back(boundingBox);
+		if (raycastMovedBoundingBoxes.size() > boundingBoxComponents.Count()) {
+			raycastMovedBoundingBoxes.clear();
+			raycastTreeDirty = true;
+		}
+	}
+
+	if (boundingBox->IsDynamicTreeQueued()) return;
+
+	boundingBox->SetDynamicTreeQueueIndex((int) movedBoundingBoxes.size());
+	movedBoundingBoxes.push_back(boundingBox);
+}
+
+void Scene::UpdateTransforms() {
+	transformHierarchy.SortByDepth();
+
+	// The parents of a level are all in the previous one, so the transforms of a level can be split between threads
+	for (unsigned level = 0; level < transformHierarchy.GetNumLevels(); ++level) {
+		unsigned begin = transformHierarchy.GetLevelBegin(level);
+		unsigned end = transformHierarchy.GetLevelEnd(level);
+		App->jobs->ParallelFor("Transform update", end - begin, TRANSFORM_UPDATE_BATCH_SIZE, [this, begin](unsigned first, unsigned last) {
+			transformHierarchy.UpdateWorldMatrices(begin + first, begin + last);
+		});
+	}
+}
+
+void Scene::RemoveFromDynamicTree(ComponentBoundingBox* boundingBox) {
+	int leaf = boundingBox->GetDynamicTreeLeaf();
+	if (leaf != DYNAMIC_AABB_TREE_NULL_NODE) {
+		dynamicTree.Remove(leaf);
+		boundingBox->SetDynamicTreeLeaf(DYNAMIC_AABB_TREE_NULL_NODE);
+	}
+
+	// Swap with the last queued bounding box, so that removing every bounding box of a scene stays linear
+	if (boundingBox->IsDynamicTreeQueued()) {
+		int index = boundingBox->GetDynamicTreeQueueIndex();
+		ComponentBoundingBox* last = movedBoundingBoxes.back();
+		movedBoundingBoxes[index] = last;
+		last->SetDynamicTreeQueueIndex(index);
+		movedBoundingBoxes.pop_back();
+		boundingBox->SetDynamicTreeQueueIndex(BOUNDING_BOX_NOT_QUEUED);
+	}
+}
+
+void Scene::QueueAllBoundingBoxes() {
+	for (ComponentBoundingBox& boundingBox : boundingBoxComponents) {
+		QueueDynamicTreeUpdate(&boundingBox);
+	}
 }
 
 void Scene::Init() {
@@ -193,6 +301,11 @@ void Scene::Save(JsonValue jScene) const {
 
 GameObject* Scene::CreateGameObject(GameObject* parent, UID id, const char* name) {
 	GameObject* gameObject = gameObjects.Obtain(id);
+	if (gameObject == nullptr) {
+		LOG("The GameObject pool is full. GameObject '%s' can't be created.", name);
+		return nullptr;
+	}
+
 	gameObject->scene = this;
 	gameObject->id = id;
 	gameObject->name = name;
@@ -304,12 +417,22 @@ Component* Scene::GetComponentByTypeAndId(ComponentType type, UID componentId) {
 
 Component* Scene::CreateComponentByTypeAndId(GameObject* owner, ComponentType type, UID componentId) {
 	switch (type) {
-	case ComponentType::TRANSFORM:
-		return transformComponents.Obtain(componentId, owner, componentId, owner->IsActive());
+	case ComponentType::TRANSFORM: {
+		ComponentTransform* transform = transformComponents.Obtain(componentId, owner, componentId, owner->IsActive());
+		if (transform != nullptr) transformHierarchy.Add(transform);
+		return transform;
+	}
 	case ComponentType::MESH_RENDERER:
 		return meshRendererComponents.Obtain(componentId, owner, componentId, owner->IsActive());
-	case ComponentType::BOUNDING_BOX:
-		return boundingBoxComponents.Obtain(componentId, owner, componentId, owner->IsActive());
+	case ComponentType::BOUNDING_BOX: {
+		raycastTreeDirty = true;
+		ComponentBoundingBox* boundingBox = boundingBoxComponents.Obtain(componentId, owner, componentId, owner->IsActive());
+		if (boundingBox != nullptr) {
+			QueueDynamicTreeUpdate(boundingBox);
+			transformHierarchy.AddBoundingBox(boundingBox);
+		}
+		return boundingBox;
+	}
 	case ComponentType::CAMERA:
 		return cameraComponents.Obtain(componentId, owner, componentId, owner->IsActive());
 	case ComponentType::LIGHT:
@@ -375,17 +498,132 @@ Component* Scene::CreateComponentByTypeAndId(GameObject* owner, ComponentType ty
 	}
 }
 
-void Scene::RemoveComponentByTypeAndId(ComponentType type, UID componentId) {
+void Scene::AllocateComponentsByType(ComponentType type, unsigned amount) {
 	switch (type) {
 	case ComponentType::TRANSFORM:
+		transformComponents.Allocate(amount);
+		break;
+	case ComponentType::MESH_RENDERER:
+		meshRendererComponents.Allocate(amount);
+		break;
+	case ComponentType::BOUNDING_BOX:
+		boundingBoxComponents.Allocate(amount);
+		break;
+	case ComponentType::CAMERA:
+		cameraComponents.Allocate(amount);
+		break;
+	case ComponentType::LIGHT:
+		lightComponents.Allocate(amount);
+		break;
+	case ComponentType::CANVAS:
+		canvasComponents.Allocate(amount);
+		break;
+	case ComponentType::CANVASRENDERER:
+		canvasRendererComponents.Allocate(amount);
+		break;
+	case ComponentType::IMAGE:
+		imageComponents.Allocate(amount);
+		break;
+	case ComponentType::TRANSFORM2D:
+		transform2DComponents.Allocate(amount);
+		break;
+	case ComponentType::BUTTON:
+		buttonComponents.Allocate(amount);
+		break;
+	case ComponentType::EVENT_SYSTEM:
+		eventSystemComponents.Allocate(amount);
+		break;
+	case ComponentType::BOUNDING_BOX_2D:
+		boundingBox2DComponents.Allocate(amount);
+		break;
+	case ComponentType::TOGGLE:
+		toggleComponents.Allocate(amount);
+		break;
+	case ComponentType::TEXT:
+		textComponents.Allocate(amount);
+		break;
+	case ComponentType::SELECTABLE:
+		selectableComponents.Allocate(amount);
+		break;
+	case ComponentType::SLIDER:
+		sliderComponents.Allocate(amount);
+		break;
+	case ComponentType::SKYBOX:
+		skyboxComponents.Allocate(amount);
+		break;
+	case ComponentType::ANIMATION:
+		animationComponents.Allocate(amount);
+		break;
+	case ComponentType::SCRIPT:
+		scriptComponents.Allocate(amount);
+		break;
+	case ComponentType::PARTICLE:
+		particleComponents.Allocate(amount);
+		break;
+	case ComponentType::TRAIL:
+		trailComponents.Allocate(amount);
+		break;
+	case ComponentType::BILLBOARD:
+		billboardComponents.Allocate(amount);
+		break;
+	case ComponentType::AUDIO_SOURCE:
+		audioSourceComponents.Allocate(amount);
+		break;
+	case ComponentType::AUDIO_LISTENER:
+		audioListenerComponents.Allocate(amount);
+		break;
+	case ComponentType::PROGRESS_BAR:
+		progressbarsComponents.Allocate(amount);
+		break;
+	case ComponentType::SPHERE_COLLIDER:
+		sphereColliderComponents.Allocate(amount);
+		break;
+	case ComponentType::BOX_COLLIDER:
+		boxColliderComponents.Allocate(amount);
+		break;
+	case ComponentType::CAPSULE_COLLIDER:
+		capsuleColliderComponents.Allocate(amount);
+		break;
+	case ComponentType::AGENT:
+		agentComponents.Allocate(amount);
+		break;
+	case ComponentType::OBSTACLE:
+		obstacleComponents.Allocate(amount);
+		break;
+	case ComponentType::FOG:
+		fogComponents.Allocate(amount);
+		break;
+	case ComponentType::VIDEO:
+		videoComponents.Allocate(amount);
+		break;
+	default:
+		LOG("Component of type %i hasn't been registered in Scene::AllocateComponentsByType.", (unsigned) type);
+		assert(false);
+		break;
+	}
+}
+
+void Scene::RemoveComponentByTypeAndId(ComponentType type, UID componentId) {
+	switch (type) {
+	case ComponentType::TRANSFORM: {
+		ComponentTransform* transform = transformComponents.Find(componentId);
+		if (transform != nullptr) transformHierarchy.Remove(transform);
 		transformComponents.Release(componentId);
 		break;
+	}
 	case ComponentType::MESH_RENDERER:
 		meshRendererComponents.Release(componentId);
 		break;
-	case ComponentType::BOUNDING_BOX:
+	case ComponentType::BOUNDING_BOX: {
+		raycastTreeDirty = true;
+		ComponentBoundingBox* boundingBox = boundingBoxComponents.Find(componentId);
+		if (boundingBox != nullptr) {
+			RemoveFromDynamicTree(boundingBox);
+			transformHierarchy.RemoveBoundingBox(boundingBox);
+		}
 		boundingBoxComponents.Release(componentId);
 		break;
+	}
 	case ComponentType::CAMERA:
 		cameraComponents.Release(componentId);
 		break;
@@ -488,82 +726,49 @@ int Scene::GetTotalTriangles() const {
 	for (const ComponentMeshRenderer& meshComponent : meshRendererComponents) {
 		ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshComponent.GetMesh());
 		if (mesh != nullptr) {
-			triangles += mesh->indices.size() / 3;
+			triangles += mesh->numIndices / 3;
 		}
 	}
 	return triangles;
 }
 
-std::vector<float> Scene::GetVertices() {
-	std::vector<float> result;
+void Scene::GetStaticGeometry(std::vector<float>& vertices, std::vector<int>& triangles, std::vector<float>& normals) {
+	// The geometry of each mesh is copied into buffers shared by all the meshes. Meshes keep it cached after the first read
+	std::vector<float3> meshPositions;
+	std::vector<float3> meshNormals;
+	std::vector<unsigned> meshIndices;
 
 	for (ComponentMeshRenderer& meshRenderer : meshRendererComponents) {
 		ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshRenderer.GetMesh());
-		ComponentTransform* transform = meshRenderer.GetOwner().GetComponent<ComponentTransform>();
-		if (mesh != nullptr && transform->GetOwner().IsStatic()) {
-			for (const ResourceMesh::Vertex& vertex : mesh->vertices) {
-				float4 transformedVertex = transform->GetGlobalMatrix() * float4(vertex.position, 1.0f);
-				result.push_back(transformedVertex.x);
-				result.push_back(transformedVertex.y);
-				result.push_back(transformedVertex.z);
-			}
-		}
-	}
+		if (mesh == nullptr || !meshRenderer.GetOwner().IsStatic()) continue;
 
-	return result;
-}
-
-std::vector<int> Scene::GetTriangles() {
-	int triangles = 0;
-	std::vector<int> maxVertMesh;
-	maxVertMesh.push_back(0);
-	for (ComponentMeshRenderer& meshRenderer : meshRendererComponents) {
-		ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshRenderer.GetMesh());
-		if (mesh != nullptr && meshRenderer.GetOwner().IsStatic()) {
-			triangles += mesh->indices.size() / 3;
-			maxVertMesh.push_back(mesh->vertices.size());
+		if (!mesh->ReadGeometry(meshPositions, meshNormals, meshIndices)) {
+			LOG("Failed to read the geometry of mesh \"%s\".", mesh->GetName().c_str());
+			continue;
 		}
-	}
-	std::vector<int> result(triangles * 3);
 
-	int currentGlobalTri = 0;
-	int vertOverload = 0;
-	int i = 0;
-
-	for (ComponentMeshRenderer& meshRenderer : meshRendererComponents) {
-		ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshRenderer.GetMesh());
-		if (mesh != nullptr && meshRenderer.GetOwner().IsStatic()) {
-			vertOverload += maxVertMesh[i];
-			for (unsigned j = 0; j < mesh->indices.size(); j += 3) {
-				result[currentGlobalTri] = mesh->indices[j] + vertOverload;
-				result[currentGlobalTri + 1] = mesh->indices[j + 1] + vertOverload;
-				result[currentGlobalTri + 2] = mesh->indices[j + 2] + vertOverload;
-				currentGlobalTri += 3;
-			}
-			i++;
+		ComponentTransform* transform = meshRenderer.GetOwner().GetComponent<ComponentTransform>();
+		float4x4 globalMatrix = transform->GetGlobalMatrix();
+		int firstVertex = (int) (vertices.size() / 3);
+
+		for (const float3& position : meshPositions) {
+			float4 transformedVertex = globalMatrix * float4(position, 1.0f);
+			vertices.push_back(transformedVertex.x);
+			vertices.push_back(transformedVertex.y);
+			vertices.push_back(transformedVertex.z);
 		}
-	}
 
-	return result;
-}
-
-std::vector<float> Scene::GetNormals() {
-	std::vector<float> result;
+		for (unsigned index : meshIndices) {
+			triangles.push_back(index + firstVertex);
+		}
 
-	for (ComponentMeshRenderer& meshRenderer : meshRendererComponents) {
-		ResourceMesh* mesh = App->resources->GetResource<ResourceMesh>(meshRenderer.GetMesh());
-		ComponentTransform* transform = meshRenderer.GetOwner().GetComponent<ComponentTransform>();
-		if (mesh != nullptr && transform->GetOwner().IsStatic()) {
-			for (const ResourceMesh::Vertex& vertex : mesh->vertices) {
-				float4 transformedVertex = transform->GetGlobalMatrix() * float4(vertex.normal, 1.0f);
-				result.push_back(transformedVertex.x);
-				result.push_back(transformedVertex.y);
-				result.push_back(transformedVertex.z);
-			}
+		for (const float3& normal : meshNormals) {
+			float4 transformedVertex = globalMatrix * float4(normal, 1.0f);
+			normals.push_back(transformedVertex.x);
+			normals.push_back(transformedVertex.y);
+			normals.push_back(transformedVertex.z);
 		}
 	}
-
-	return result;
 }
 
 const std::vector<GameObject*>& Scene::GetStaticShadowCasters() const {
@@ -604,35 +809,159 @@ std::vector<GameObject*> Scene::GetCulledMeshes(const FrustumPlanes& planes, con
 	return meshes;
 }
 
-std::vector<GameObject*> Scene::GetStaticCulledShadowCasters(const FrustumPlanes& planes) {
-	std::vector<GameObject*> meshes;
+void Scene::GatherCandidatesFromQuadtree(const Quadtree<GameObject>::Node& node, const AABB2D& aabb, const FrustumPlanes& planes, std::vector<GameObject*>& candidates) {
+	AABB aabb3d = AABB({aabb.minPoint.x, -1000000.0f, aabb.minPoint.y}, {aabb.maxPoint.x, 1000000.0f, aabb.maxPoint.y});
+	if (!planes.CheckIfInsideFrustumPlanes(aabb3d, OBB(aabb3d))) return;
 
-	for (GameObject* go : staticShadowCasters) {
-		if (InsideFrustumPlanes(planes, go)) {
-			meshes.push_back(go);
+	if (node.IsBranch()) {
+		vec2d center = aabb.minPoint + (aabb.maxPoint - aabb.minPoint) * 0.5f;
+
+		AABB2D topLeftAABB = {{aabb.minPoint.x, center.y}, {center.x, aabb.maxPoint.y}};
+		GatherCandidatesFromQuadtree(node.childNodes->nodes[0], topLeftAABB, planes, candidates);
+
+		AABB2D topRightAABB = {{center.x, center.y}, {aabb.maxPoint.x, aabb.maxPoint.y}};
+		GatherCandidatesFromQuadtree(node.childNodes->nodes[1], topRightAABB, planes, candidates);
+
+		AABB2D bottomLeftAABB = {{aabb.minPoint.x, aabb.minPoint.y}, {center.x, center.y}};
+		GatherCandidatesFromQuadtree(node.childNodes->nodes[2], bottomLeftAABB, planes, candidates);
+
+		AABB2D bottomRightAABB = {{center.x, aabb.minPoint.y}, {aabb.maxPoint.x, center.y}};
+		GatherCandidatesFromQuadtree(node.childNodes->nodes[3], bottomRightAABB, planes, candidates);
+	} else {
+		const Quadtree<GameObject>::Element* element = node.firstElement;
+		while (element != nullptr) {
+			candidates.push_back(element->object);
+			element = element->next;
 		}
 	}
+}
 
-	return meshes;
+void Scene::GatherCandidatesFromDynamicTree(const FrustumPlanes& planes, std::vector<GameObject*>& candidates) {
+	UpdateDynamicTree();
+	dynamicTree.Query(
+		[&planes](const AABB& aabb) { return planes.CheckIfInsideFrustumPlanes(aabb); },
+		[&candidates](ComponentBoundingBox* boundingBox) {
+			candidates.push_back(&boundingBox->GetOwner());
+		});
 }
 
-std::vector<GameObject*> Scene::GetDynamicCulledShadowCasters(const FrustumPlanes& planes) {
-	std::vector<GameObject*> meshes;
+void Scene::CullGameObjects(const FrustumPlanes& planes, std::vector<GameObject*>& candidates, std::vector<unsigned>& visibility, bool useQuadtree) {
+	candidates.clear();
+	GatherCandidatesFromDynamicTree(planes, candidates);
+
+	if (useQuadtree && quadtree.IsOperative()) {
+		// Quadtree elements can be in more than one node. The ones without a bounding box can't be culled
+		size_t first = candidates.size();
+		GatherCandidatesFromQuadtree(quadtree.root, quadtree.bounds, planes, candidates);
+		std::sort(candidates.begin() + first, candidates.end());
+		candidates.erase(std::unique(candidates.begin() + first, candidates.end()), candidates.end());
+		candidates.erase(std::remove_if(candidates.begin() + first, candidates.end(), [](const GameObject* go) { return go->GetComponent<ComponentBoundingBox>() == nullptr; }), candidates.end());
+	}
 
-	for (GameObject* go : dynamicShadowCasters) {
-		if (InsideFrustumPlanes(planes, go)) {
-			meshes.push_back(go);
+	// Transforms are resolved lazily through their parents, so the ones that changed are updated here before the boxes are refreshed in parallel.
+	// Linking the pending transforms first makes sure that no bounding box is invalidated in the middle of the pass
+	transformHierarchy.SortByDepth();
+	candidateBoundingBoxes.clear();
+	for (GameObject* go : candidates) {
+		ComponentBoundingBox* boundingBox = go->GetComponent<ComponentBoundingBox>();
+		if (boundingBox->IsDirty()) {
+			go->GetComponent<ComponentTransform>()->GetGlobalMatrix();
 		}
+		candidateBoundingBoxes.push_back(boundingBox);
 	}
 
-	return meshes;
+	unsigned count = (unsigned) candidateBoundingBoxes.size();
+	cullingBatch.Clear();
+	cullingBatch.Resize(count);
+	App->jobs->ParallelFor("Bounding box refresh", count, BOUNDING_BOX_REFRESH_BATCH_SIZE, [this](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i) {
+			ComponentBoundingBox* boundingBox = candidateBoundingBoxes[i];
+			cullingBatch.Set(i, boundingBox->GetWorldAABB(), boundingBox->GetWorldOBB());
+		}
+	});
+
+	// Each batch writes whole words of the visibility mask
+	cullingBatch.BeginCull(visibility);
+	App->jobs->ParallelFor("Frustum culling", (unsigned) visibility.size(), FRUSTUM_CULLING_BATCH_WORDS, [this, &planes, &visibility, count](unsigned begin, unsigned end) {
+		cullingBatch.CullRange(planes, visibility, begin * 32, std::min(end * 32, count));
+	});
 }
 
-std::vector<GameObject*> Scene::GetMainEntitiesCulledShadowCasters(const FrustumPlanes& planes) {
+void Scene::GetGameObjectsInAABBFromQuadtree(const Quadtree<GameObject>::Node& node, const AABB2D& nodeAABB, const AABB& aabb, std::vector<GameObject*>& gameObjects) {
+	if (!nodeAABB.Intersects(AABB2D(aabb.minPoint.xz(), aabb.maxPoint.xz()))) return;
+
+	if (node.IsBranch()) {
+		vec2d center = nodeAABB.minPoint + (nodeAABB.maxPoint - nodeAABB.minPoint) * 0.5f;
+
+		AABB2D topLeftAABB = {{nodeAABB.minPoint.x, center.y}, {center.x, nodeAABB.maxPoint.y}};
+		GetGameObjectsInAABBFromQuadtree(node.childNodes->nodes[0], topLeftAABB, aabb, gameObjects);
+
+		AABB2D topRightAABB = {{center.x, center.y}, {nodeAABB.maxPoint.x, nodeAABB.maxPoint.y}};
+		GetGameObjectsInAABBFromQuadtree(node.childNodes->nodes[1], topRightAABB, aabb, gameObjects);
+
+		AABB2D bottomLeftAABB = {{nodeAABB.minPoint.x, nodeAABB.minPoint.y}, {center.x, center.y}};
+		GetGameObjectsInAABBFromQuadtree(node.childNodes->nodes[2], bottomLeftAABB, aabb, gameObjects);
+
+		AABB2D bottomRightAABB = {{center.x, nodeAABB.minPoint.y}, {nodeAABB.maxPoint.x, center.y}};
+		GetGameObjectsInAABBFromQuadtree(node.childNodes->nodes[3], bottomRightAABB, aabb, gameObjects);
+	} else {
+		const Quadtree<GameObject>::Element* element = node.firstElement;
+		while (element != nullptr) {
+			ComponentBoundingBox* boundingBox = element->object->GetComponent<ComponentBoundingBox>();
+			if (boundingBox != nullptr && boundingBox->GetWorldAABB().Intersects(aabb)) {
+				gameObjects.push_back(element->object);
+			}
+			element = element->next;
+		}
+	}
+}
+
+void Scene::GetGameObjectsInAABB(const AABB& aabb, std::vector<GameObject*>& gameObjects) {
+	UpdateDynamicTree();
+	dynamicTree.Query(
+		[&aabb](const AABB& nodeAABB) { return nodeAABB.Intersects(aabb); },
+		[&aabb, &gameObjects](ComponentBoundingBox* boundingBox) {
+			if (boundingBox->GetWorldAABB().Intersects(aabb)) {
+				gameObjects.push_back(&boundingBox->GetOwner());
+			}
+		});
+
+	if (quadtree.IsOperative()) {
+		size_t first = gameObjects.size();
+		GetGameObjectsInAABBFromQuadtree(quadtree.root, quadtree.bounds, aabb, gameObjects);
+		std::sort(gameObjects.begin() + first, gameObjects.end());
+		gameObjects.erase(std::unique(gameObjects.begin() + first, gameObjects.end()), gameObjects.end());
+	}
+}
+
+std::vector<GameObject*> Scene::GetCulledShadowCasters(const FrustumPlanes& planes, const std::vector<GameObject*>& shadowCasters, bool useQuadtree) {
 	std::vector<GameObject*> meshes;
+	if (shadowCasters.empty()) return meshes;
+
+	// Shadow casters in the dynamic tree (and in the quadtree, if it's used) are culled in batch. The rest are checked one by one
+	useQuadtree = useQuadtree && quadtree.IsOperative();
+	std::vector<GameObject*> candidates;
+	std::vector<unsigned> visibility;
+	CullGameObjects(planes, candidates, visibility, useQuadtree);
+
+	std::vector<GameObject*> culledGameObjects;
+	for (unsigned i = 0; i < candidates.size(); ++i) {
+		if (CullingBatch::IsVisible(visibility, i)) {
+			culledGameObjects.push_back(candidates[i]);
+		}
+	}
+	std::sort(culledGameObjects.begin(), culledGameObjects.end());
+
+	for (GameObject* go : shadowCasters) {
+		ComponentBoundingBox* boundingBox = go->GetComponent<ComponentBoundingBox>();
+		if (boundingBox == nullptr) continue;
 
-	for (GameObject* go : mainEntitiesShadowCasters) {
-		if (InsideFrustumPlanes(planes, go)) {
+		bool indexed = (useQuadtree && go->isInQuadtree) || boundingBox->GetDynamicTreeLeaf() != DYNAMIC_AABB_TREE_NULL_NODE;
+		if (indexed) {
+			if (std::binary_search(culledGameObjects.begin(), culledGameObjects.end(), go)) {
+				meshes.push_back(go);
+			}
+		} else if (InsideFrustumPlanes(planes, go)) {
 			meshes.push_back(go);
 		}
 	}
@@ -640,6 +969,18 @@ std::vector<GameObject*> Scene::GetMainEntitiesCulledShadowCasters(const Frustum
 	return meshes;
 }
 
+std::vector<GameObject*> Scene::GetStaticCulledShadowCasters(const FrustumPlanes& planes) {
+	return GetCulledShadowCasters(planes, staticShadowCasters, true);
+}
+
+std::vector<GameObject*> Scene::GetDynamicCulledShadowCasters(const FrustumPlanes& planes) {
+	return GetCulledShadowCasters(planes, dynamicShadowCasters, false);
+}
+
+std::vector<GameObject*> Scene::GetMainEntitiesCulledShadowCasters(const FrustumPlanes& planes) {
+	return GetCulledShadowCasters(planes, mainEntitiesShadowCasters, false);
+}
+
 void Scene::RemoveStaticShadowCaster(const GameObject* go) {
 	auto it = std::find(staticShadowCasters.begin(), staticShadowCasters.end(), go);
 
@@ -2,8 +2,12 @@
 
 #include "Utils/PoolMap.h"
 #include "Utils/Quadtree.h"
+#include "Utils/BVH.h"
+#include "Utils/DynamicAABBTree.h"
+#include "Utils/TransformHierarchy.h"
 #include "Utils/UID.h"
 #include "Rendering/FrustumPlanes.h"
+#include "Rendering/CullingBatch.h"
 #include "Components/ComponentTransform.h"
 #include "Components/ComponentMeshRenderer.h"
 #include "Components/ComponentBoundingBox.h"
@@ -46,6 +50,10 @@ public:
 	void ClearScene();		// Removes and clears every GameObject from the scene.
 	void RebuildQuadtree(); // Recalculates the Quadtree hierarchy with all the GameObjects in the scene.
 	void ClearQuadtree();	// Resets the Quadrtee as empty, and removes all GameObjects from it.
+	void UpdateRaycastTree(); // Rebuilds the raycast BVH, or refits the bounding boxes that have moved since the last update. Called by the ray queries.
+	void UpdateDynamicTree(); // Inserts, moves or removes the bounding boxes that have changed since the last update. Called by the queries that use the dynamic tree.
+	void QueueDynamicTreeUpdate(ComponentBoundingBox* boundingBox); // Called by the bounding boxes every time their world AABB changes. Also marks the raycast tree for a refit
+	void UpdateTransforms(); // Updates the world matrices of every transform that changed, level by level. Called once per frame, after the GameObjects are updated
 
 	void Init();
 	void Start();
@@ -65,13 +73,14 @@ public:
 	Component* GetComponentByTypeAndId(ComponentType type, UID componentId);
 	Component* CreateComponentByTypeAndId(GameObject* owner, ComponentType type, UID componentId);
 	void RemoveComponentByTypeAndId(ComponentType type, UID componentId);
+	void AllocateComponentsByType(ComponentType type, unsigned amount); // Reallocates the pool of the given type. The pool must be empty
 
 	int GetTotalTriangles() const;
-	std::vector<float> GetVertices(); // Gets all the vertices from the MeshRenderer Components only if the ResourceMesh is found and the GameObject is Static
-	std::vector<int> GetTriangles();  // Gets all the triangles from the MeshRenderer Components only if the ResourceMesh is found and the GameObject is Static
-	std::vector<float> GetNormals();
+	void GetStaticGeometry(std::vector<float>& vertices, std::vector<int>& triangles, std::vector<float>& normals); // Appends the world space geometry of the MeshRenderer Components of static GameObjects whose ResourceMesh is found and can be read
 
 	std::vector<GameObject*> GetCulledMeshes(const FrustumPlanes& planes, const int mask);	// Gets all the game objects inside the given frustum
+	void CullGameObjects(const FrustumPlanes& planes, std::vector<GameObject*>& candidates, std::vector<unsigned>& visibility, bool useQuadtree = true); // Fills 'candidates' with the game objects in the quadtree and dynamic tree nodes inside the frustum, and 'visibility' with one bit per candidate (see CullingBatch)
+	void GetGameObjectsInAABB(const AABB& aabb, std::vector<GameObject*>& gameObjects);				// Appends the game objects whose bounding box intersects the given AABB
 	std::vector<GameObject*> GetStaticCulledShadowCasters(const FrustumPlanes& planes);		// Gets all the shadow casters game objects inside the given frustum
 	std::vector<GameObject*> GetDynamicCulledShadowCasters(const FrustumPlanes& planes);	// Gets all the shadow casters game objects inside the given frustum
 	std::vector<GameObject*> GetMainEntitiesCulledShadowCasters(const FrustumPlanes& planes);	// Gets all the shadow casters game objects inside the given frustum
@@ -141,12 +150,21 @@ public:
 	PoolMap<UID, ComponentFog> fogComponents;
 	PoolMap<UID, ComponentVideo> videoComponents;
 
+	// ---- Transform Hierarchy ---- //
+	TransformHierarchy transformHierarchy; // Position, rotation, scale and matrices of every transform, stored in flat arrays. Used through the transform components
+
 	// ---- Quadtree Parameters ---- //
 	Quadtree<GameObject> quadtree;
 	AABB2D quadtreeBounds = {{-1000, -1000}, {1000, 1000}};
 	unsigned quadtreeMaxDepth = 4;
 	unsigned quadtreeElementsPerNode = 200;
 
+	// ---- Raycast Parameters ---- //
+	BVH<ComponentBoundingBox> raycastTree; // Hierarchy over the world AABBs of every bounding box. Use it through the Physics ray queries, which keep it updated.
+
+	// ---- Dynamic Tree Parameters ---- //
+	DynamicAABBTree<ComponentBoundingBox> dynamicTree; // Bounding boxes that aren't in the quadtree. Call UpdateDynamicTree() before querying it.
+
 	// ---- Game Camera Parameters ---- //
 	UID gameCameraId = 0;
 
@@ -163,11 +181,25 @@ public:
 
 private:
 	bool InsideFrustumPlanes(const FrustumPlanes& planes, const GameObject* go);
+	void GatherCandidatesFromQuadtree(const Quadtree<GameObject>::Node& node, const AABB2D& aabb, const FrustumPlanes& planes, std::vector<GameObject*>& candidates); // Gets the static game objects in the nodes inside the given frustum. They can be repeated if they are in more than one node
+	void GatherCandidatesFromDynamicTree(const FrustumPlanes& planes, std::vector<GameObject*>& candidates);
+	void GetGameObjectsInAABBFromQuadtree(const Quadtree<GameObject>::Node& node, const AABB2D& nodeAABB, const AABB& aabb, std::vector<GameObject*>& gameObjects); // They can be repeated if they are in more than one node
+	std::vector<GameObject*> GetCulledShadowCasters(const FrustumPlanes& planes, const std::vector<GameObject*>& shadowCasters, bool useQuadtree);
+	void RemoveFromDynamicTree(ComponentBoundingBox* boundingBox);
+	void QueueAllBoundingBoxes(); // Queues every bounding box, so that the dynamic tree follows the changes of the quadtree
 
 private:
 	std::vector<GameObject*> staticShadowCasters;
 	std::vector<GameObject*> dynamicShadowCasters;
 	std::vector<GameObject*> mainEntitiesShadowCasters;
+
+	bool raycastTreeDirty = true;								  // Set when a bounding box is created or removed. The raycast tree is rebuilt on the next query
+	unsigned raycastTreeRefits = 0;								  // Bounding boxes refitted since the raycast tree was last rebuilt
+	std::vector<ComponentBoundingBox*> raycastMovedBoundingBoxes; // Bounding boxes moved since the raycast tree was last updated. Only they are refitted on the next query
+
+	std::vector<ComponentBoundingBox*> movedBoundingBoxes;	   // Bounding boxes waiting to be updated in the dynamic tree
+	std::vector<ComponentBoundingBox*> candidateBoundingBoxes; // Bounding boxes of the culling candidates, in the same order
+	CullingBatch cullingBatch;								   // Bounds of the culling candidates. Reused between calls to keep its memory
 };
 
 template<class T>
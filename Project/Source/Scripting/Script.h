@@ -39,6 +39,7 @@ public:
 	virtual void ReceiveEvent(TesseractEvent& /* e */) {}
 
 	virtual void Update() = 0;
+	virtual void FixedUpdate() {} // Called once per fixed step of game time, before Update. GetDeltaTime returns the fixed delta time here
 	virtual void Start() = 0;
 	virtual void OnButtonClick() {}
 	virtual void OnToggled(bool /* val */) {}
@@ -46,7 +47,9 @@ public:
 	virtual void OnAnimationFinished() {}
 	virtual void OnAnimationSecondaryFinished() {}
 	virtual void OnAnimationEvent(StateMachineEnum /* stateMachineEnum */, const char* /* eventName */) {}
-	virtual void OnCollision(GameObject& /* collidedWith */, float3 /* collisionNormal */, float3 /* penetrationDistance */, void* /* particle = nullptr */) {}
+	virtual void OnCollisionEnter(GameObject& /* collidedWith */, float3 /* collisionNormal */, float3 /* penetrationDistance */, void* /* particle = nullptr */) {} // Called in the first step the bodies touch, before OnCollision
+	virtual void OnCollision(GameObject& /* collidedWith */, float3 /* collisionNormal */, float3 /* penetrationDistance */, void* /* particle = nullptr */) {}		 // Called once per batch of steps while the bodies touch
+	virtual void OnCollisionExit(GameObject& /* collidedWith */, void* /* particle = nullptr */) {}																	 // Called in the first step the bodies stop touching
 	virtual void OnEnable() {}
 	virtual void OnDisable() {}
 
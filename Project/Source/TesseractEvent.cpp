@@ -1,5 +1,91 @@
 #include "TesseractEvent.h"
 
+#include "Application.h"
+#include "Modules/ModuleEvents.h"
+
+#include "Utils/Leaks.h"
+
+CreateResourcePayload::CreateResourcePayload(const char* resourceName_, const char* assetFilePath_) {
+	snprintf(resourceName, FILENAME_MAX, "%s", resourceName_);
+	snprintf(assetFilePath, FILENAME_MAX, "%s", assetFilePath_);
+}
+
+CreateResourceStruct::CreateResourceStruct(ResourceType type_, UID resourceId_, const char* resourceName_, const char* assetFilePath_)
+	: type(type_)
+	, resourceId(resourceId_) {
+	payload = App->events->createResourcePayloads.Obtain(resourceName_, assetFilePath_);
+	resourceName = payload->resourceName;
+	assetFilePath = payload->assetFilePath;
+}
+
+CreateResourceStruct::CreateResourceStruct(CreateResourceStruct&& other) noexcept
+	: type(other.type)
+	, resourceId(other.resourceId)
+	, resourceName(other.resourceName)
+	, assetFilePath(other.assetFilePath)
+	, payload(other.payload) {
+	other.resourceName = "";
+	other.assetFilePath = "";
+	other.payload = nullptr;
+}
+
+CreateResourceStruct::~CreateResourceStruct() {
+	App->events->createResourcePayloads.Release(payload);
+}
+
+CreateResourceStruct& CreateResourceStruct::operator=(CreateResourceStruct&& other) noexcept {
+	if (this == &other) return *this;
+
+	App->events->createResourcePayloads.Release(payload);
+	type = other.type;
+	resourceId = other.resourceId;
+	resourceName = other.resourceName;
+	assetFilePath = other.assetFilePath;
+	payload = other.payload;
+	other.resourceName = "";
+	other.assetFilePath = "";
+	other.payload = nullptr;
+	return *this;
+}
+
+const char* GetEventTypeName(TesseractEventType type) {
+	switch (type) {
+	case TesseractEventType::GAMEOBJECT_DESTROYED:
+		return "GameObject destroyed";
+	case TesseractEventType::PRESSED_PLAY:
+		return "Pressed play";
+	case TesseractEventType::PRESSED_PAUSE:
+		return "Pressed pause";
+	case TesseractEventType::PRESSED_RESUME:
+		return "Pressed resume";
+	case TesseractEventType::PRESSED_STEP:
+		return "Pressed step";
+	case TesseractEventType::PRESSED_STOP:
+		return "Pressed stop";
+	case TesseractEventType::CREATE_RESOURCE:
+		return "Create resource";
+	case TesseractEventType::DESTROY_RESOURCE:
+		return "Destroy resource";
+	case TesseractEventType::UPDATE_ASSET_CACHE:
+		return "Update asset cache";
+	case TesseractEventType::MOUSE_CLICKED:
+		return "Mouse clicked";
+	case TesseractEventType::MOUSE_RELEASED:
+		return "Mouse released";
+	case TesseractEventType::CHANGE_SCENE:
+		return "Change scene";
+	case TesseractEventType::COMPILATION_FINISHED:
+		return "Compilation finished";
+	case TesseractEventType::SCREEN_RESIZED:
+		return "Screen resized";
+	case TesseractEventType::PROJECTION_CHANGED:
+		return "Projection changed";
+	case TesseractEventType::UPDATE_ASSET_CACHE_DIFF:
+		return "Update asset cache diff";
+	default:
+		return "Unknown";
+	}
+}
+
 TesseractEvent::TesseractEvent(TesseractEventType type_)
 	: type(type_) {}
-
@@ -4,7 +4,7 @@
 #include "Utils/UID.h"
 
 #include "Math/float2.h"
-#include <string>
+#include <stdio.h>
 #include <variant>
 
 class Scene;
@@ -13,13 +13,16 @@ class Component;
 class Resource;
 
 struct AssetCache;
+struct AssetCacheDiff;
 
-#define EventVariant std::variant<int, DestroyGameObjectStruct, CreateResourceStruct, DestroyResourceStruct, UpdateAssetCacheStruct, ChangeSceneStruct, ViewportResizedStruct>
+#define EventVariant std::variant<int, DestroyGameObjectStruct, CreateResourceStruct, DestroyResourceStruct, UpdateAssetCacheStruct, UpdateAssetCacheDiffStruct, ChangeSceneStruct, ViewportResizedStruct>
 
 /* Creating a new event type:
 *    1. Add a new EventType for the new event (ALWAYS ABOVE COUNT)
 *    2. Add a struct containing the necessary information for said event inside the union below (Make sure it has a constructor)
-*    3. (If allocating) Make sure you release all allocated resources in ModuleEvents.cpp's CleanUpEvent()
+*    3. (If allocating) Make sure you release all allocated resources in ModuleEvents.cpp's CleanUpEvent(). Data that doesn't fit in the struct
+*       (strings) goes in a payload obtained from one of the pools of ModuleEvents, so that sending the event doesn't allocate.
+*       Structs that own a payload release it in their destructor and are move-only, so events are moved into the queues
 *	 4. Remember to make an std::emplace whenever generating a TesseractEvent, there are no default values so trying to std::get a non initiated variant will return a crash
 */
 
@@ -40,19 +43,29 @@ enum class TesseractEventType {
 	COMPILATION_FINISHED,
 	SCREEN_RESIZED,
 	PROJECTION_CHANGED,
+	UPDATE_ASSET_CACHE_DIFF,
 	COUNT
 };
 
+struct CreateResourcePayload {
+	char resourceName[FILENAME_MAX] = "";
+	char assetFilePath[FILENAME_MAX] = "";
+	CreateResourcePayload(const char* resourceName_, const char* assetFilePath_);
+};
+
+// Move-only, since it owns a payload of ModuleEvents::createResourcePayloads. The payload is released when the struct is destroyed
 struct CreateResourceStruct {
 	ResourceType type = ResourceType::UNKNOWN;
 	UID resourceId = 0;
-	std::string resourceName = "";
-	std::string assetFilePath = "";
-	CreateResourceStruct(ResourceType type_, UID resourceId_, const char* resourceName_, const char* assetFilePath_)
-		: type(type_)
-		, resourceId(resourceId_)
-		, resourceName(resourceName_)
-		, assetFilePath(assetFilePath_) {}
+	const char* resourceName = "";
+	const char* assetFilePath = "";
+	CreateResourcePayload* payload = nullptr; // Owns the strings
+	CreateResourceStruct(ResourceType type_, UID resourceId_, const char* resourceName_, const char* assetFilePath_);
+	CreateResourceStruct(const CreateResourceStruct&) = delete;
+	CreateResourceStruct(CreateResourceStruct&& other) noexcept;
+	~CreateResourceStruct();
+	CreateResourceStruct& operator=(const CreateResourceStruct&) = delete;
+	CreateResourceStruct& operator=(CreateResourceStruct&& other) noexcept;
 };
 
 struct DestroyResourceStruct {
@@ -76,6 +89,12 @@ struct UpdateAssetCacheStruct {
 	}
 };
 
+struct UpdateAssetCacheDiffStruct {
+	AssetCacheDiff* diff = nullptr;
+	UpdateAssetCacheDiffStruct(AssetCacheDiff* diff_)
+		: diff(diff_) {}
+};
+
 struct ChangeSceneStruct {
 	UID sceneId = 0;
 	ChangeSceneStruct(UID sceneId_)
@@ -90,6 +109,8 @@ struct ViewportResizedStruct {
 	int newHeight = 0;
 };
 
+const char* GetEventTypeName(TesseractEventType type);
+
 struct TesseractEvent {
 public:
 	TesseractEvent(TesseractEventType type);
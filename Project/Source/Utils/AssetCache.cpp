@@ -6,7 +6,75 @@ AssetFile::AssetFile(const char* path_)
 AssetFolder::AssetFolder(const char* path_)
 	: path(path_) {}
 
+bool AssetCacheDiff::IsEmpty() const {
+	return removedFolders.empty() && removedFiles.empty() && addedFolders.empty() && addedFiles.empty();
+}
+
 AssetCache::AssetCache(const char* rootPath)
 	: root(rootPath) {
 	foldersMap[rootPath] = &root;
 }
+
+void AssetCache::ApplyDiff(const AssetCacheDiff& diff) {
+	for (const std::string& path : diff.removedFolders) {
+		auto it = foldersMap.find(path);
+		if (it == foldersMap.end() || it->second == &root) continue;
+
+		AssetFolder* folder = it->second;
+		RemoveFolderEntries(*folder);
+		GetParentFolder(path)->folders.remove_if([folder](const AssetFolder& child) { return &child == folder; });
+	}
+
+	for (const std::string& path : diff.removedFiles) {
+		auto it = filesMap.find(path);
+		if (it == filesMap.end()) continue;
+
+		AssetFile* file = it->second;
+		filesMap.erase(it);
+		GetParentFolder(path)->files.remove_if([file](const AssetFile& child) { return &child == file; });
+	}
+
+	for (const std::string& path : diff.addedFolders) {
+		AddFolder(path);
+	}
+
+	for (const AssetFile& addedFile : diff.addedFiles) {
+		auto it = filesMap.find(addedFile.path);
+		if (it != filesMap.end()) {
+			it->second->resourceIds = addedFile.resourceIds;
+			continue;
+		}
+
+		AssetFolder* folder = GetParentFolder(addedFile.path);
+		folder->files.push_back(addedFile);
+		filesMap[addedFile.path] = &folder->files.back();
+	}
+}
+
+AssetFolder* AssetCache::GetParentFolder(const std::string& path) {
+	size_t lastSeparator = path.find_last_of('/');
+	if (lastSeparator == std::string::npos) return &root;
+
+	return AddFolder(path.substr(0, lastSeparator));
+}
+
+AssetFolder* AssetCache::AddFolder(const std::string& path) {
+	auto it = foldersMap.find(path);
+	if (it != foldersMap.end()) return it->second;
+
+	AssetFolder* parent = GetParentFolder(path);
+	parent->folders.push_back(AssetFolder(path.c_str()));
+	AssetFolder* folder = &parent->folders.back();
+	foldersMap[path] = folder;
+	return folder;
+}
+
+void AssetCache::RemoveFolderEntries(AssetFolder& folder) {
+	for (AssetFolder& child : folder.folders) {
+		RemoveFolderEntries(child);
+	}
+	for (AssetFile& file : folder.files) {
+		filesMap.erase(file.path);
+	}
+	foldersMap.erase(folder.path);
+}
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include <unordered_map>
 
 struct AssetFile {
@@ -21,10 +22,29 @@ struct AssetFolder {
 	std::list<AssetFile> files;
 };
 
+/* Changes to an AssetCache found by the import thread. Removals are applied first, then the folders
+*  (parents before their subfolders) and then the files. Added files that are already cached get their resources replaced.
+*/
+struct AssetCacheDiff {
+	bool IsEmpty() const;
+
+	std::vector<std::string> removedFolders;
+	std::vector<std::string> removedFiles;
+	std::vector<std::string> addedFolders;
+	std::vector<AssetFile> addedFiles;
+};
+
 struct AssetCache {
 	AssetCache(const char* rootPath);
 
+	void ApplyDiff(const AssetCacheDiff& diff);
+
 	AssetFolder root;
 	std::unordered_map<std::string, AssetFolder*> foldersMap;
 	std::unordered_map<std::string, AssetFile*> filesMap;
-};
\ No newline at end of file
+
+private:
+	AssetFolder* GetParentFolder(const std::string& path); // Adds the missing folders
+	AssetFolder* AddFolder(const std::string& path);
+	void RemoveFolderEntries(AssetFolder& folder);
+};
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "Math/float3.h"
+#include "Geometry/AABB.h"
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#define BVH_MAX_LEAF_ELEMENTS 4 // Nodes with this many elements or less are not split
+#define BVH_MAX_DEPTH 64		// Size of the traversal stack. Median splits keep the depth at log2 of the element count
+
+/* Bounding Volume Hierarchy over the AABBs of a set of objects, used to answer ray queries.
+*  Nodes are stored flattened in depth-first order: the left child of a branch is always the next node,
+*  and the right child is at 'offset'. Refitting keeps the hierarchy and only recalculates the node bounds.
+*  Refitting a list of moved objects only touches their leaves and the ancestors of those, so it costs
+*  O(moved * log N) instead of O(N). The hierarchy degrades as objects move, so it should be rebuilt from time to time.
+*/
+
+template<typename T>
+class BVH {
+public:
+	class Element {
+	public:
+		T* object = nullptr;
+		AABB aabb = {{0, 0, 0}, {0, 0, 0}};
+	};
+
+	class Node {
+	public:
+		bool IsLeaf() const {
+			return count > 0;
+		}
+
+	public:
+		AABB aabb = {{0, 0, 0}, {0, 0, 0}};
+		unsigned offset = 0; // Leaf: index of the first element. Branch: index of the right child
+		unsigned count = 0;	 // Number of elements of a leaf. 0 for branches
+	};
+
+	class Hit {
+	public:
+		T* object = nullptr;
+		float distance = 0; // Normalized distance along the ray, from 0 (start) to 1 (end)
+	};
+
+public:
+	void Clear() {
+		elements.clear();
+		nodes.clear();
+		nodeParents.clear();
+		elementLeaves.clear();
+		elementIndices.clear();
+	}
+
+	void Add(T* object, const AABB& aabb) {
+		Element& element = elements.emplace_back();
+		element.object = object;
+		element.aabb = aabb;
+	}
+
+	void Build() {
+		nodes.clear();
+		nodeParents.clear();
+		elementLeaves.clear();
+		elementIndices.clear();
+		if (elements.empty()) return;
+
+		nodes.reserve(elements.size());
+		nodeParents.reserve(elements.size());
+		elementLeaves.resize(elements.size());
+		BuildNode(0, (unsigned) elements.size(), 0);
+
+		// Building reorders the elements, so the objects are indexed afterwards
+		elementIndices.reserve(elements.size());
+		for (unsigned i = 0; i < (unsigned) elements.size(); ++i) {
+			elementIndices[elements[i].object] = i;
+		}
+	}
+
+	// 'getAABB' returns the current AABB of an object
+	template<typename F>
+	void Refit(F getAABB) {
+		for (Element& element : elements) {
+			element.aabb = getAABB(element.object);
+		}
+
+		// Children always have a higher index than their parent
+		for (int i = (int) nodes.size() - 1; i >= 0; --i) {
+			Node& node = nodes[i];
+			if (node.IsLeaf()) {
+				node.aabb = elements[node.offset].aabb;
+				for (unsigned j = node.offset + 1; j < node.offset + node.count; ++j) {
+					node.aabb.Enclose(elements[j].aabb);
+				}
+			} else {
+				node.aabb = nodes[i + 1].aabb;
+				node.aabb.Enclose(nodes[node.offset].aabb);
+			}
+		}
+	}
+
+	// Refits only the given objects, their leaves and the ancestors of those. Objects that aren't in the hierarchy are ignored
+	template<typename F>
+	void Refit(const std::vector<T*>& objects, F getAABB) {
+		for (T* object : objects) {
+			auto it = elementIndices.find(object);
+			if (it == elementIndices.end()) continue;
+
+			unsigned elementIndex = it->second;
+			elements[elementIndex].aabb = getAABB(object);
+
+			unsigned nodeIndex = elementLeaves[elementIndex];
+			Node& leaf = nodes[nodeIndex];
+			leaf.aabb = elements[leaf.offset].aabb;
+			for (unsigned j = leaf.offset + 1; j < leaf.offset + leaf.count; ++j) {
+				leaf.aabb.Enclose(elements[j].aabb);
+			}
+
+			while (nodeIndex != 0) {
+				nodeIndex = nodeParents[nodeIndex];
+				Node& node = nodes[nodeIndex];
+				node.aabb = nodes[nodeIndex + 1].aabb;
+				node.aabb.Enclose(nodes[node.offset].aabb);
+			}
+		}
+	}
+
+	// Returns the closest object hit by the segment between 'start' and 'end' that passes 'filter', or nullptr if there's none
+	template<typename F>
+	T* RayNearest(const float3& start, const float3& end, F filter, float& distance) const {
+		T* closest = nullptr;
+		distance = 1.0f;
+		if (nodes.empty()) return closest;
+
+		float3 invDirection = (end - start).Recip();
+
+		unsigned stack[BVH_MAX_DEPTH];
+		unsigned stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0) {
+			const Node& node = nodes[stack[--stackSize]];
+			float nodeDistance;
+			if (!IntersectsRay(node.aabb, start, invDirection, distance, nodeDistance)) continue;
+
+			if (node.IsLeaf()) {
+				for (unsigned i = node.offset; i < node.offset + node.count; ++i) {
+					const Element& element = elements[i];
+					float elementDistance;
+					if (!IntersectsRay(element.aabb, start, invDirection, distance, elementDistance)) continue;
+					if (closest != nullptr && elementDistance >= distance) continue;
+					if (!filter(element.object)) continue;
+
+					closest = element.object;
+					distance = elementDistance;
+				}
+			} else {
+				// Visit the closest child first, so that the furthest one can be discarded by distance
+				unsigned left = (unsigned) (&node - nodes.data()) + 1;
+				unsigned right = node.offset;
+				float leftDistance = 0;
+				float rightDistance = 0;
+				bool leftHit = IntersectsRay(nodes[left].aabb, start, invDirection, distance, leftDistance);
+				bool rightHit = IntersectsRay(nodes[right].aabb, start, invDirection, distance, rightDistance);
+				if (leftHit && rightHit) {
+					if (leftDistance <= rightDistance) {
+						stack[stackSize++] = right;
+						stack[stackSize++] = left;
+					} else {
+						stack[stackSize++] = left;
+						stack[stackSize++] = right;
+					}
+				} else if (leftHit) {
+					stack[stackSize++] = left;
+				} else if (rightHit) {
+					stack[stackSize++] = right;
+				}
+			}
+		}
+
+		return closest;
+	}
+
+	// Appends every object hit by the segment between 'start' and 'end' that passes 'filter', sorted from closest to furthest
+	template<typename F>
+	void RayAll(const float3& start, const float3& end, F filter, std::vector<Hit>& hits) const {
+		if (nodes.empty()) return;
+
+		size_t firstHit = hits.size();
+		float3 invDirection = (end - start).Recip();
+
+		unsigned stack[BVH_MAX_DEPTH];
+		unsigned stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0) {
+			unsigned nodeIndex = stack[--stackSize];
+			const Node& node = nodes[nodeIndex];
+			float nodeDistance;
+			if (!IntersectsRay(node.aabb, start, invDirection, 1.0f, nodeDistance)) continue;
+
+			if (node.IsLeaf()) {
+				for (unsigned i = node.offset; i < node.offset + node.count; ++i) {
+					const Element& element = elements[i];
+					float elementDistance;
+					if (!IntersectsRay(element.aabb, start, invDirection, 1.0f, elementDistance)) continue;
+					if (!filter(element.object)) continue;
+
+					Hit& hit = hits.emplace_back();
+					hit.object = element.object;
+					hit.distance = elementDistance;
+				}
+			} else {
+				stack[stackSize++] = node.offset;
+				stack[stackSize++] = nodeIndex + 1;
+			}
+		}
+
+		std::sort(hits.begin() + firstHit, hits.end(), [](const Hit& a, const Hit& b) { return a.distance < b.distance; });
+	}
+
+	unsigned GetElementCount() const {
+		return (unsigned) elements.size();
+	}
+
+	unsigned GetNodeCount() const {
+		return (unsigned) nodes.size();
+	}
+
+private:
+	unsigned BuildNode(unsigned first, unsigned count, unsigned parent) {
+		unsigned nodeIndex = (unsigned) nodes.size();
+		nodes.emplace_back();
+		nodeParents.push_back(parent);
+
+		AABB aabb = elements[first].aabb;
+		AABB centroids(aabb.CenterPoint(), aabb.CenterPoint());
+		for (unsigned i = first + 1; i < first + count; ++i) {
+			aabb.Enclose(elements[i].aabb);
+			centroids.Enclose(elements[i].aabb.CenterPoint());
+		}
+		nodes[nodeIndex].aabb = aabb;
+
+		if (count <= BVH_MAX_LEAF_ELEMENTS) {
+			nodes[nodeIndex].offset = first;
+			nodes[nodeIndex].count = count;
+			for (unsigned i = first; i < first + count; ++i) {
+				elementLeaves[i] = nodeIndex;
+			}
+			return nodeIndex;
+		}
+
+		// Split at the median of the longest axis of the centroids
+		float3 size = centroids.Size();
+		int axis = (size.x >= size.y && size.x >= size.z) ? 0 : (size.y >= size.z ? 1 : 2);
+		unsigned half = count / 2;
+		std::nth_element(elements.begin() + first, elements.begin() + first + half, elements.begin() + first + count, [axis](const Element& a, const Element& b) {
+			return a.aabb.CenterPoint()[axis] < b.aabb.CenterPoint()[axis];
+		});
+
+		BuildNode(first, half, nodeIndex);
+		unsigned right = BuildNode(first + half, count - half, nodeIndex);
+		nodes[nodeIndex].offset = right;
+		return nodeIndex;
+	}
+
+	// Slab test against the segment 'origin' + t * direction, with t between 0 and 'maxDistance'
+	static bool IntersectsRay(const AABB& aabb, const float3& origin, const float3& invDirection, float maxDistance, float& distance) {
+		float tMin = 0.0f;
+		float tMax = maxDistance;
+		for (int axis = 0; axis < 3; ++axis) {
+			float t1 = (aabb.minPoint[axis] - origin[axis]) * invDirection[axis];
+			float t2 = (aabb.maxPoint[axis] - origin[axis]) * invDirection[axis];
+			tMin = std::max(tMin, std::min(t1, t2));
+			tMax = std::min(tMax, std::max(t1, t2));
+		}
+		distance = tMin;
+		return tMin <= tMax;
+	}
+
+private:
+	std::vector<Element> elements;
+	std::vector<Node> nodes;
+	std::vector<unsigned> nodeParents;	             // Parent of each node. The root is its own parent
+	std::vector<unsigned> elementLeaves;	         // Leaf that contains each element
+	std::unordered_map<T*, unsigned> elementIndices; // Index of the element of each object
+};
@@ -0,0 +1,1361 @@
+#include "Benchmarks.h"
+
+#include "Globals.h"
+#include "Application.h"
+#include "GameObject.h"
+#include "Scene.h"
+#include "Components/ComponentCamera.h"
+#include "Modules/ModuleCamera.h"
+#include "Modules/ModulePrograms.h"
+#include "Modules/ModuleUserInterface.h"
+#include "Modules/ModuleResources.h"
+#include "Modules/ModuleScene.h"
+#include "Modules/ModuleFiles.h"
+#include "Modules/ModuleJobs.h"
+#include "Utils/FileDialog.h"
+#include "FileSystem/SceneImporter.h"
+#include "Rendering/ParticleInstanceBuffer.h"
+#include "Rendering/FrustumPlanes.h"
+#include "Rendering/CullingBatch.h"
+#include "Utils/ParticleSimulation.h"
+#include "Utils/BVH.h"
+#include "Utils/PrefabTemplate.h"
+#include "Utils/Logging.h"
+#include "Resources/Resource.h"
+#include "Resources/ResourceHandle.h"
+#include "Resources/ResourcePrefab.h"
+#include "Utils/ResourceTable.h"
+#include "Utils/PerformanceTimer.h"
+#include "Utils/PhysicsStepper.h"
+#include "Utils/JobSystem.h"
+#include "Utils/UID.h"
+#include "Utils/Random.h"
+
+#include "Math/float3x3.h"
+#include "Math/float4x4.h"
+#include "Math/MathConstants.h"
+#include "Math/MathFunc.h"
+#include "Math/Quat.h"
+#include "Geometry/AABB.h"
+#include "Geometry/OBB.h"
+#include "Geometry/Frustum.h"
+#include "Geometry/LineSegment.h"
+#include "GL/glew.h"
+#include "btBulletDynamicsCommon.h"
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <queue>
+#include <stdarg.h>
+#include <unordered_map>
+
+#include "Utils/Leaks.h"
+
+#define BENCHMARK_RESOURCE_COUNT 10000
+#define BENCHMARK_RESOURCE_LOOKUPS 2000000
+
+#define BENCHMARK_PARTICLE_EMITTERS 10
+#define BENCHMARK_PARTICLES_PER_EMITTER 1000
+#define BENCHMARK_PARTICLE_FRAMES 20
+#define BENCHMARK_PARTICLE_TARGET_SIZE 256
+
+#define BENCHMARK_SIMULATION_PARTICLES 100000
+#define BENCHMARK_SIMULATION_FRAMES 100
+#define BENCHMARK_SIMULATION_DELTA_TIME 0.016f
+
+#define BENCHMARK_RAYCAST_OBJECTS 10000
+#define BENCHMARK_RAYCAST_RAYS 1000
+#define BENCHMARK_RAYCAST_WORLD_SIZE 500.0f
+#define BENCHMARK_RAYCAST_RAY_LENGTH 100.0f
+#define BENCHMARK_RAYCAST_MOVED 100
+
+#define BENCHMARK_CULLING_BOXES 100000
+#define BENCHMARK_CULLING_FRAMES 10
+#define BENCHMARK_CULLING_WORLD_SIZE 1000.0f
+
+#define BENCHMARK_PREFAB_GAMEOBJECTS 30
+#define BENCHMARK_PREFAB_INSTANCES 50
+#define BENCHMARK_PREFAB_ROUNDS 10
+
+#define BENCHMARK_LOG_BURST 4096 // Messages per burst, split between the threads. The same as LOG_RING_SIZE, so that the ring never drops messages
+#define BENCHMARK_LOG_BURSTS 100
+#define BENCHMARK_LOG_MAX_THREADS 8
+
+#define BENCHMARK_IMPORT_PATH ASSETS_PATH
+#define BENCHMARK_IMPORT_TEMP_PATH "ImportBenchmark" // Copy of the assets and library of the import benchmark. Erased when it finishes
+
+#define BENCHMARK_PHYSICS_DYNAMIC_BODIES 1500
+#define BENCHMARK_PHYSICS_KINEMATIC_BODIES 500
+#define BENCHMARK_PHYSICS_FRAMES 120
+#define BENCHMARK_PHYSICS_TIME_STEP (1.0f / 60.0f)
+#define BENCHMARK_PHYSICS_FRAME_WORK_US 3000 // Work of the rest of the frame (updating and rendering), done while the world is stepped
+
+#define BENCHMARK_JOBS_BOXES 100000
+#define BENCHMARK_JOBS_FRAMES 20
+#define BENCHMARK_JOBS_WORLD_SIZE 1000.0f
+#define BENCHMARK_JOBS_REFRESH_BATCH_SIZE 256 // Same batch sizes as Scene::CullGameObjects
+#define BENCHMARK_JOBS_CULLING_BATCH_WORDS 16
+
+#define BENCHMARK_TRANSFORM_SKELETONS 100
+#define BENCHMARK_TRANSFORM_BONES 64 // A spine of 4 bones with 4 chains of 15 bones, as a skinned character
+#define BENCHMARK_TRANSFORM_FRAMES 60
+
+#define BENCHMARK_SCENE_GAMEOBJECTS 5000
+#define BENCHMARK_SCENE_ROUNDS 5
+#define BENCHMARK_SCENE_JSON_PATH "SceneBenchmark.scene"	 // Written and erased by the scene loading benchmark
+#define BENCHMARK_SCENE_BINARY_PATH "SceneBenchmark.binary" // Written and erased by the scene loading benchmark
+
+static double OperationsPerSecond(unsigned long long operations, unsigned long long microseconds) {
+	if (microseconds == 0) microseconds = 1;
+	return (double) operations * 1000000.0 / (double) microseconds;
+}
+
+std::string Benchmarks::ResourceLookup() {
+	std::unordered_map<UID, std::unique_ptr<Resource>> resources;
+	std::vector<UID> ids;
+	std::vector<ResourceHandle> handles;
+	std::mutex resourcesMutex;
+	ResourceTable resourceTable;
+
+	ids.reserve(BENCHMARK_RESOURCE_COUNT);
+	handles.reserve(BENCHMARK_RESOURCE_COUNT);
+	for (unsigned i = 0; i < BENCHMARK_RESOURCE_COUNT; ++i) {
+		UID id = GenerateUID();
+		std::unique_ptr<Resource>& resource = resources[id];
+		resource.reset(new Resource(ResourceType::UNKNOWN, id, "Benchmark", "", ""));
+		ids.push_back(id);
+		handles.push_back(resourceTable.Add(resource.get()));
+	}
+
+	// Same access pattern for both paths: a strided walk over all the resident resources
+	PerformanceTimer timer;
+	unsigned long long checksum = 0;
+
+	timer.Start();
+	for (unsigned i = 0; i < BENCHMARK_RESOURCE_LOOKUPS; ++i) {
+		unsigned index = (i * 7919) % BENCHMARK_RESOURCE_COUNT;
+		resourcesMutex.lock();
+		auto it = resources.find(ids[index]);
+		Resource* resource = it != resources.end() ? it->second.get() : nullptr;
+		resourcesMutex.unlock();
+		checksum += resource != nullptr ? resource->GetId() : 0;
+	}
+	unsigned long long mapTime = timer.Stop();
+
+	timer.Start();
+	for (unsigned i = 0; i < BENCHMARK_RESOURCE_LOOKUPS; ++i) {
+		unsigned index = (i * 7919) % BENCHMARK_RESOURCE_COUNT;
+		Resource* resource = resourceTable.Get(handles[index], ids[index]);
+		checksum -= resource != nullptr ? resource->GetId() : 0;
+	}
+	unsigned long long tableTime = timer.Stop();
+
+	resourceTable.Clear();
+
+	double mapLookups = OperationsPerSecond(BENCHMARK_RESOURCE_LOOKUPS, mapTime);
+	double tableLookups = OperationsPerSecond(BENCHMARK_RESOURCE_LOOKUPS, tableTime);
+
+	std::string report;
+	report += "Resident resources: " + std::to_string(BENCHMARK_RESOURCE_COUNT) + "\n";
+	report += "Map + mutex: " + std::to_string((unsigned long long) mapLookups) + " lookups/s (" + std::to_string(mapTime) + " us)\n";
+	report += "Handle table: " + std::to_string((unsigned long long) tableLookups) + " lookups/s (" + std::to_string(tableTime) + " us)\n";
+	report += "Speedup: x" + std::to_string(tableLookups / mapLookups) + "\n";
+	if (checksum != 0) report += "WARNING: Lookup results differ between both paths\n";
+	return report;
+}
+
+// Same layout as the particles had before the hot data was split into ParticleSimulation
+struct BenchmarkParticle {
+	float3 initialPosition = float3::zero;
+	float3 position = float3::zero;
+	Quat rotation = Quat::identity;
+	float3 scale = float3(0.1f, 0.1f, 0.1f);
+	float3 direction = float3::zero;
+
+	float speed = 0.0f;
+	float life = 0.0f;
+	float initialLife = 0.0f;
+	float currentFrame = 0.0f;
+	float animationSpeed = 1.0f;
+
+	float rotationOL = 0.0f;
+	float scaleOL = 0.0f;
+	float velocityXOL = 0.0f;
+	float velocityYOL = 0.0f;
+	float velocityZOL = 0.0f;
+	float speedMultiplierOL = 0.0f;
+	float gravityFactorOL = 0.0f;
+
+	bool hasCollided = false;
+	void* motionState = nullptr;
+	void* rigidBody = nullptr;
+	void* emitter = nullptr;
+	void* collider[2] = {nullptr, nullptr};
+	float radius = 0;
+	void* trail = nullptr;
+	void* lightGO = nullptr;
+};
+
+std::string Benchmarks::ParticleUpdate() {
+	std::vector<BenchmarkParticle> particles(BENCHMARK_SIMULATION_PARTICLES);
+	ParticleSimulation simulation;
+	simulation.Allocate(BENCHMARK_SIMULATION_PARTICLES);
+
+	// Long lives, so that every particle is updated in every frame
+	for (BenchmarkParticle& particle : particles) {
+		unsigned index = simulation.Add();
+		float3 direction = float3(Random() - 0.5f, Random(), Random() - 0.5f).Normalized();
+		particle.direction = direction;
+		particle.speed = 1.0f + Random();
+		particle.initialLife = particle.life = 1000.0f;
+		particle.rotationOL = Random();
+		particle.scaleOL = Random() * 0.1f;
+		particle.gravityFactorOL = -9.8f;
+		particle.animationSpeed = 10.0f;
+
+		simulation.directionX[index] = direction.x;
+		simulation.directionY[index] = direction.y;
+		simulation.directionZ[index] = direction.z;
+		simulation.speed[index] = particle.speed;
+		simulation.initialLife[index] = simulation.life[index] = particle.life;
+		simulation.rotationFactor[index] = particle.rotationOL;
+		simulation.scaleFactor[index] = particle.scaleOL;
+		simulation.gravityFactor[index] = particle.gravityFactorOL;
+		simulation.animationSpeed[index] = particle.animationSpeed;
+	}
+
+	// Gravity, rotation, size and texture animation over lifetime
+	PerformanceTimer timer;
+	float deltaTime = BENCHMARK_SIMULATION_DELTA_TIME;
+
+	timer.Start();
+	for (unsigned frame = 0; frame < BENCHMARK_SIMULATION_FRAMES; ++frame) {
+		for (BenchmarkParticle& particle : particles) {
+			float3 gravityAxis = float3(0.0f, particle.gravityFactorOL, 0.0f);
+			particle.position += particle.direction * particle.speed * deltaTime + 0.5f * gravityAxis * deltaTime * deltaTime;
+			particle.direction += gravityAxis * deltaTime;
+			particle.position += particle.direction * particle.speed * deltaTime;
+
+			particle.life -= deltaTime;
+
+			float rotation = particle.rotation.ToEulerXYZ().z;
+			rotation += particle.rotationOL * deltaTime;
+			particle.rotation = Quat::FromEulerXYZ(0.0f, 0.0f, rotation);
+
+			particle.scale += float3(particle.scaleOL) * deltaTime;
+			if (particle.scale.x < 0 || particle.scale.y < 0 || particle.scale.z < 0) {
+				particle.scale = float3::zero;
+			}
+
+			particle.currentFrame += particle.animationSpeed * deltaTime;
+		}
+	}
+	unsigned long long aosTime = timer.Stop();
+
+	std::vector<unsigned> deadIndices;
+	timer.Start();
+	for (unsigned frame = 0; frame < BENCHMARK_SIMULATION_FRAMES; ++frame) {
+		simulation.UpdatePositionGravity(float3::unitY, deltaTime);
+		simulation.UpdatePosition(deltaTime);
+		simulation.UpdateLife(deltaTime);
+		simulation.UpdateRotation(deltaTime);
+		simulation.UpdateScale(deltaTime);
+		simulation.UpdateFrames(deltaTime);
+		simulation.FindDead(deadIndices);
+	}
+	unsigned long long soaTime = timer.Stop();
+
+	// Both paths must end with the same particles
+	float maxError = 0.0f;
+	for (unsigned i = 0; i < BENCHMARK_SIMULATION_PARTICLES; ++i) {
+		float3 position(simulation.positionX[i], simulation.positionY[i], simulation.positionZ[i]);
+		maxError = Max(maxError, position.Distance(particles[i].position));
+	}
+
+	unsigned long long updates = (unsigned long long) BENCHMARK_SIMULATION_PARTICLES * BENCHMARK_SIMULATION_FRAMES;
+	double aosUpdatesPerMs = OperationsPerSecond(updates, aosTime) / 1000.0;
+	double soaUpdatesPerMs = OperationsPerSecond(updates, soaTime) / 1000.0;
+
+	std::string report;
+	report += "Particles: " + std::to_string(BENCHMARK_SIMULATION_PARTICLES) + ", " + std::to_string(BENCHMARK_SIMULATION_FRAMES) + " frames\n";
+	report += "Array of structs: " + std::to_string((unsigned long long) aosUpdatesPerMs) + " particles/ms (" + std::to_string(aosTime) + " us)\n";
+	report += "SoA + SSE: " + std::to_string((unsigned long long) soaUpdatesPerMs) + " particles/ms (" + std::to_string(soaTime) + " us)\n";
+	report += "Speedup: x" + std::to_string(soaUpdatesPerMs / aosUpdatesPerMs) + "\n";
+	if (!deadIndices.empty() || maxError > 0.01f) report += "WARNING: Simulation results differ between both paths\n";
+	return report;
+}
+
+std::string Benchmarks::ParticleRendering() {
+	// Particles spread in front of the camera, split in several emitters
+	std::vector<ParticleInstance> particles(BENCHMARK_PARTICLE_EMITTERS * BENCHMARK_PARTICLES_PER_EMITTER);
+	Frustum* frustum = App->camera->GetActiveCamera()->GetFrustum();
+	for (ParticleInstance& particle : particles) {
+		particle.position = frustum->Pos() + frustum->Front() * (5.0f + Random() * 20.0f) + float3(Random() - 0.5f, Random() - 0.5f, Random() - 0.5f) * 10.0f;
+		particle.rotation = Random() * 2.0f * pi;
+		particle.scale = float3(0.1f, 0.1f, 0.1f);
+		particle.frame = 0.0f;
+		particle.color = float4(Random(), Random(), Random(), 1.0f);
+		particle.direction = float3::unitY;
+		particle.padding = 0.0f;
+	}
+
+	ParticleInstanceBuffer instanceBuffers[BENCHMARK_PARTICLE_EMITTERS];
+	for (ParticleInstanceBuffer& instanceBuffer : instanceBuffers) {
+		instanceBuffer.Init();
+	}
+
+	// Offscreen target, so that the benchmark doesn't draw over the editor
+	GLint previousFramebuffer = 0;
+	GLint previousViewport[4];
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+	unsigned framebuffer = 0;
+	unsigned colorTexture = 0;
+	glGenFramebuffers(1, &framebuffer);
+	glGenTextures(1, &colorTexture);
+	glBindTexture(GL_TEXTURE_2D, colorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, BENCHMARK_PARTICLE_TARGET_SIZE, BENCHMARK_PARTICLE_TARGET_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+	glViewport(0, 0, BENCHMARK_PARTICLE_TARGET_SIZE, BENCHMARK_PARTICLE_TARGET_SIZE);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	float4x4 view = App->camera->GetViewMatrix();
+	float4x4 proj = App->camera->GetProjectionMatrix();
+	float3x3 billboardRotation = float3x3::LookAt(float3::unitZ, -frustum->Front(), float3::unitY, float3::unitY);
+
+	PerformanceTimer timer;
+	unsigned perParticleDrawCalls = 0;
+	unsigned instancedDrawCalls = 0;
+
+	// One draw call per particle, with the orientation computed on the CPU
+	ProgramBillboard* billboard = App->programs->billboard;
+	glFinish();
+	timer.Start();
+	for (unsigned frame = 0; frame < BENCHMARK_PARTICLE_FRAMES; ++frame) {
+		glUseProgram(billboard->program);
+		glBindBuffer(GL_ARRAY_BUFFER, App->userInterface->GetQuadVBO());
+		glEnableVertexAttribArray(0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*) (sizeof(float) * 6 * 3));
+		glUniformMatrix4fv(billboard->viewLocation, 1, GL_TRUE, view.ptr());
+		glUniformMatrix4fv(billboard->projLocation, 1, GL_TRUE, proj.ptr());
+		glUniform1i(billboard->hasDiffuseLocation, 0);
+		glUniform1i(billboard->xTilesLocation, 1);
+		glUniform1i(billboard->yTilesLocation, 1);
+		for (const ParticleInstance& particle : particles) {
+			float4x4 model = float4x4::FromTRS(particle.position, billboardRotation * float3x3::RotateZ(particle.rotation), particle.scale);
+			glUniformMatrix4fv(billboard->modelLocation, 1, GL_TRUE, model.ptr());
+			glUniform4fv(billboard->inputColorLocation, 1, particle.color.ptr());
+			glUniform1f(billboard->currentFrameLocation, particle.frame);
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+			perParticleDrawCalls += 1;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	unsigned long long perParticleCpuTime = timer.Read();
+	glFinish();
+	unsigned long long perParticleTime = timer.Stop();
+
+	// One instanced draw call per emitter, with the orientation computed in the vertex shader
+	ProgramBillboardInstanced* billboardInstanced = App->programs->billboardInstanced;
+	glFinish();
+	timer.Start();
+	for (unsigned frame = 0; frame < BENCHMARK_PARTICLE_FRAMES; ++frame) {
+		glUseProgram(billboardInstanced->program);
+		glUniformMatrix4fv(billboardInstanced->viewLocation, 1, GL_TRUE, view.ptr());
+		glUniformMatrix4fv(billboardInstanced->projLocation, 1, GL_TRUE, proj.ptr());
+		glUniform1i(billboardInstanced->hasDiffuseLocation, 0);
+		glUniform1i(billboardInstanced->xTilesLocation, 1);
+		glUniform1i(billboardInstanced->yTilesLocation, 1);
+		glUniform1i(billboardInstanced->billboardTypeLocation, 0);
+		glUniform1i(billboardInstanced->renderAlignmentLocation, 0);
+		glUniform3fv(billboardInstanced->cameraPosLocation, 1, frustum->Pos().ptr());
+		glUniform3fv(billboardInstanced->cameraFrontLocation, 1, frustum->Front().ptr());
+		for (unsigned emitter = 0; emitter < BENCHMARK_PARTICLE_EMITTERS; ++emitter) {
+			ParticleInstanceBuffer& instanceBuffer = instanceBuffers[emitter];
+			ParticleInstance* instances = instanceBuffer.Map(BENCHMARK_PARTICLES_PER_EMITTER);
+			if (instances == nullptr) continue;
+			memcpy(instances, &particles[emitter * BENCHMARK_PARTICLES_PER_EMITTER], sizeof(ParticleInstance) * BENCHMARK_PARTICLES_PER_EMITTER);
+			instanceBuffer.Unmap();
+			instanceBuffer.Draw(BENCHMARK_PARTICLES_PER_EMITTER);
+			instancedDrawCalls += 1;
+		}
+	}
+	unsigned long long instancedCpuTime = timer.Read();
+	glFinish();
+	unsigned long long instancedTime = timer.Stop();
+
+	// Restore the previous state
+	glUseProgram(0);
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+	glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+	glDeleteTextures(1, &colorTexture);
+	glDeleteFramebuffers(1, &framebuffer);
+	for (ParticleInstanceBuffer& instanceBuffer : instanceBuffers) {
+		instanceBuffer.CleanUp();
+	}
+
+	std::string report;
+	report += "Particles: " + std::to_string(particles.size()) + " in " + std::to_string(BENCHMARK_PARTICLE_EMITTERS) + " emitters, " + std::to_string(BENCHMARK_PARTICLE_FRAMES) + " frames\n";
+	report += "Per particle: " + std::to_string(perParticleDrawCalls / BENCHMARK_PARTICLE_FRAMES) + " draw calls/frame, CPU " + std::to_string(perParticleCpuTime / BENCHMARK_PARTICLE_FRAMES) + " us/frame, total " + std::to_string(perParticleTime / BENCHMARK_PARTICLE_FRAMES) + " us/frame\n";
+	report += "Instanced: " + std::to_string(instancedDrawCalls / BENCHMARK_PARTICLE_FRAMES) + " draw calls/frame, CPU " + std::to_string(instancedCpuTime / BENCHMARK_PARTICLE_FRAMES) + " us/frame, total " + std::to_string(instancedTime / BENCHMARK_PARTICLE_FRAMES) + " us/frame\n";
+	if (instancedCpuTime > 0) report += "CPU speedup: x" + std::to_string((double) perParticleCpuTime / (double) instancedCpuTime) + "\n";
+	return report;
+}
+
+struct BenchmarkRaycastObject {
+	AABB aabb;
+	int mask = 0;
+};
+
+std::string Benchmarks::Raycast() {
+	std::vector<BenchmarkRaycastObject> objects(BENCHMARK_RAYCAST_OBJECTS);
+	for (BenchmarkRaycastObject& object : objects) {
+		float3 center = float3(Random() - 0.5f, Random() * 0.05f, Random() - 0.5f) * BENCHMARK_RAYCAST_WORLD_SIZE;
+		float3 halfSize = float3(0.5f + Random(), 0.5f + Random() * 2.0f, 0.5f + Random());
+		object.aabb = AABB(center - halfSize, center + halfSize);
+		object.mask = Random() < 0.5f ? 1 : 2;
+	}
+
+	std::vector<float3> starts(BENCHMARK_RAYCAST_RAYS);
+	std::vector<float3> ends(BENCHMARK_RAYCAST_RAYS);
+	for (unsigned i = 0; i < BENCHMARK_RAYCAST_RAYS; ++i) {
+		starts[i] = float3(Random() - 0.5f, Random() * 0.05f, Random() - 0.5f) * BENCHMARK_RAYCAST_WORLD_SIZE;
+		float3 direction = float3(Random() - 0.5f, (Random() - 0.5f) * 0.1f, Random() - 0.5f).Normalized();
+		ends[i] = starts[i] + direction * BENCHMARK_RAYCAST_RAY_LENGTH;
+	}
+
+	const int mask = 1;
+	PerformanceTimer timer;
+
+	// Linear scan, as Physics::Raycast used to do
+	std::vector<const BenchmarkRaycastObject*> linearHits(BENCHMARK_RAYCAST_RAYS);
+	timer.Start();
+	for (unsigned i = 0; i < BENCHMARK_RAYCAST_RAYS; ++i) {
+		LineSegment ray(starts[i], ends[i]);
+		const BenchmarkRaycastObject* closest = nullptr;
+		float closestNear = FLT_MAX;
+		for (const BenchmarkRaycastObject& object : objects) {
+			if ((object.mask & mask) == 0) continue;
+			float dNear, dFar;
+			if (ray.Intersects(object.aabb, dNear, dFar) && dNear < closestNear) {
+				closest = &object;
+				closestNear = dNear;
+			}
+		}
+		linearHits[i] = closest;
+	}
+	unsigned long long linearTime = timer.Stop();
+
+	// BVH
+	BVH<const BenchmarkRaycastObject> tree;
+	timer.Start();
+	for (const BenchmarkRaycastObject& object : objects) {
+		tree.Add(&object, object.aabb);
+	}
+	tree.Build();
+	unsigned long long buildTime = timer.Stop();
+
+	timer.Start();
+	tree.Refit([](const BenchmarkRaycastObject* object) { return object->aabb; });
+	unsigned long long refitTime = timer.Stop();
+
+	// Refitting only the objects that moved, as the scene does
+	std::vector<const BenchmarkRaycastObject*> moved(BENCHMARK_RAYCAST_MOVED);
+	for (unsigned i = 0; i < BENCHMARK_RAYCAST_MOVED; ++i) {
+		moved[i] = &objects[(size_t) (Random() * (BENCHMARK_RAYCAST_OBJECTS - 1))];
+	}
+	timer.Start();
+	tree.Refit(moved, [](const BenchmarkRaycastObject* object) { return object->aabb; });
+	unsigned long long movedRefitTime = timer.Stop();
+
+	auto filter = [mask](const BenchmarkRaycastObject* object) { return (object->mask & mask) != 0; };
+	std::vector<const BenchmarkRaycastObject*> treeHits(BENCHMARK_RAYCAST_RAYS);
+	timer.Start();
+	for (unsigned i = 0; i < BENCHMARK_RAYCAST_RAYS; ++i) {
+		float distance;
+		treeHits[i] = tree.RayNearest(starts[i], ends[i], filter, distance);
+	}
+	unsigned long long treeTime = timer.Stop();
+
+	std::vector<BVH<const BenchmarkRaycastObject>::Hit> allHits;
+	timer.Start();
+	for (unsigned i = 0; i < BENCHMARK_RAYCAST_RAYS; ++i) {
+		tree.RayAll(starts[i], ends[i], filter, allHits);
+	}
+	unsigned long long allTime = timer.Stop();
+
+	// Both paths must find the same objects. Ties at the same distance can pick either object
+	unsigned mismatches = 0;
+	for (unsigned i = 0; i < BENCHMARK_RAYCAST_RAYS; ++i) {
+		if (linearHits[i] == treeHits[i]) continue;
+		if (linearHits[i] == nullptr || treeHits[i] == nullptr) {
+			mismatches += 1;
+			continue;
+		}
+		float dNear, dFar;
+		float linearNear = LineSegment(starts[i], ends[i]).Intersects(linearHits[i]->aabb, dNear, dFar) ? dNear : 0.0f;
+		float treeNear = LineSegment(starts[i], ends[i]).Intersects(treeHits[i]->aabb, dNear, dFar) ? dNear : 0.0f;
+		if (Abs(linearNear - treeNear) > 0.0001f) mismatches += 1;
+	}
+
+	std::string report;
+	report += "Objects: " + std::to_string(BENCHMARK_RAYCAST_OBJECTS) + ", rays: " + std::to_string(BENCHMARK_RAYCAST_RAYS) + "\n";
+	report += "Linear scan: " + std::to_string((unsigned long long) OperationsPerSecond(BENCHMARK_RAYCAST_RAYS, linearTime)) + " rays/s (" + std::to_string(linearTime) + " us)\n";
+	report += "BVH nearest: " + std::to_string((unsigned long long) OperationsPerSecond(BENCHMARK_RAYCAST_RAYS, treeTime)) + " rays/s (" + std::to_string(treeTime) + " us)\n";
+	report += "BVH all hits: " + std::to_string((unsigned long long) OperationsPerSecond(BENCHMARK_RAYCAST_RAYS, allTime)) + " rays/s (" + std::to_string(allTime) + " us, " + std::to_string(allHits.size()) + " hits)\n";
+	report += "BVH build: " + std::to_string(buildTime) + " us, refit: " + std::to_string(refitTime) + " us, refit " + std::to_string(BENCHMARK_RAYCAST_MOVED) + " moved: " + std::to_string(movedRefitTime) + " us, nodes: " + std::to_string(tree.GetNodeCount()) + "\n";
+	report += "Speedup: x" + std::to_string((double) Max(linearTime, 1ull) / (double) Max(treeTime, 1ull)) + "\n";
+	if (mismatches > 0) report += "WARNING: " + std::to_string(mismatches) + " rays hit different objects in both paths\n";
+	return report;
+}
+
+std::string Benchmarks::FrustumCulling() {
+	std::vector<AABB> aabbs(BENCHMARK_CULLING_BOXES);
+	std::vector<OBB> obbs(BENCHMARK_CULLING_BOXES);
+	for (unsigned i = 0; i < BENCHMARK_CULLING_BOXES; ++i) {
+		float3 center = float3(Random() - 0.5f, (Random() - 0.5f) * 0.1f, Random() - 0.5f) * BENCHMARK_CULLING_WORLD_SIZE;
+		float3 halfSize = float3(0.5f + Random() * 2.0f, 0.5f + Random() * 4.0f, 0.5f + Random() * 2.0f);
+		obbs[i] = OBB(AABB(-halfSize, halfSize));
+		obbs[i].Transform(float3x3::FromEulerXYZ(Random() * pi * 2.0f, Random() * pi * 2.0f, Random() * pi * 2.0f));
+		obbs[i].Translate(center);
+		aabbs[i] = obbs[i].MinimalEnclosingAABB();
+	}
+
+	// Same frustum as the default engine camera, looking at the center of the world from one side
+	Frustum frustum;
+	frustum.SetKind(FrustumSpaceGL, FrustumRightHanded);
+	frustum.SetViewPlaneDistances(0.1f, 2000.0f);
+	frustum.SetHorizontalFovAndAspectRatio(DEGTORAD * 90.0f, 1.3f);
+	frustum.SetPos(float3(0, 10.0f, -BENCHMARK_CULLING_WORLD_SIZE * 0.5f));
+	frustum.SetFront(vec::unitZ);
+	frustum.SetUp(vec::unitY);
+	FrustumPlanes planes;
+	planes.CalculateFrustumPlanes(frustum);
+
+	PerformanceTimer timer;
+
+	// One box at a time, as the scene used to do
+	std::vector<bool> scalarResults(BENCHMARK_CULLING_BOXES);
+	unsigned scalarVisible = 0;
+	timer.Start();
+	for (unsigned frame = 0; frame < BENCHMARK_CULLING_FRAMES; ++frame) {
+		scalarVisible = 0;
+		for (unsigned i = 0; i < BENCHMARK_CULLING_BOXES; ++i) {
+			bool inside = planes.CheckIfInsideFrustumPlanes(aabbs[i], obbs[i]);
+			scalarResults[i] = inside;
+			scalarVisible += inside ? 1 : 0;
+		}
+	}
+	unsigned long long scalarTime = timer.Stop();
+
+	// Packed bounds tested 4 at a time. Gathering the bounds is part of the cost, since the scene does it every call
+	CullingBatch batch;
+	std::vector<unsigned> visibility;
+	timer.Start();
+	for (unsigned frame = 0; frame < BENCHMARK_CULLING_FRAMES; ++frame) {
+		batch.Clear();
+		for (unsigned i = 0; i < BENCHMARK_CULLING_BOXES; ++i) {
+			batch.Add(aabbs[i], obbs[i]);
+		}
+		batch.Cull(planes, visibility);
+	}
+	unsigned long long batchTime = timer.Stop();
+
+	timer.Start();
+	for (unsigned frame = 0; frame < BENCHMARK_CULLING_FRAMES; ++frame) {
+		batch.Cull(planes, visibility);
+	}
+	unsigned long long kernelTime = timer.Stop();
+
+	unsigned mismatches = 0;
+	for (unsigned i = 0; i < BENCHMARK_CULLING_BOXES; ++i) {
+		if (CullingBatch::IsVisible(visibility, i) != scalarResults[i]) mismatches += 1;
+	}
+
+	unsigned long long boxes = (unsigned long long) BENCHMARK_CULLING_BOXES * BENCHMARK_CULLING_FRAMES;
+	std::string report;
+	report += "Boxes: " + std::to_string(BENCHMARK_CULLING_BOXES) + ", frames: " + std::to_string(BENCHMARK_CULLING_FRAMES) + ", visible: " + std::to_string(scalarVisible) + "\n";
+	report += "Scalar: " + std::to_string((unsigned long long) OperationsPerSecond(boxes, scalarTime)) + " boxes/s (" + std::to_string(scalarTime) + " us)\n";
+	report += "SSE with gather: " + std::to_string((unsigned long long) OperationsPerSecond(boxes, batchTime)) + " boxes/s (" + std::to_string(batchTime) + " us)\n";
+	report += "SSE kernel only: " + std::to_string((unsigned long long) OperationsPerSecond(boxes, kernelTime)) + " boxes/s (" + std::to_string(kernelTime) + " us)\n";
+	report += "Speedup: x" + std::to_string((double) Max(scalarTime, 1ull) / (double) Max(batchTime, 1ull)) + "\n";
+	if (mismatches > 0) report += "WARNING: " + std::to_string(mismatches) + " boxes have different visibility in both paths\n";
+	return report;
+}
+
+std::string Benchmarks::PrefabSpawn() {
+	Scene scene(BENCHMARK_PREFAB_GAMEOBJECTS * (BENCHMARK_PREFAB_INSTANCES + 1) + 1);
+	scene.root = scene.CreateGameObject(nullptr, GenerateUID(), "Root");
+
+	// Prefab with a tree of GameObjects with a transform each, saved to JSON as the editor does
+	std::vector<GameObject*> sourceGameObjects;
+	for (unsigned i = 0; i < BENCHMARK_PREFAB_GAMEOBJECTS; ++i) {
+		GameObject* parent = i > 0 ? sourceGameObjects[(i - 1) / 3] : scene.root;
+		GameObject* gameObject = scene.CreateGameObject(parent, GenerateUID(), ("GameObject " + std::to_string(i)).c_str());
+		ComponentTransform* transform = gameObject->CreateComponent<ComponentTransform>();
+		transform->SetPosition(float3(Random(), Random(), Random()) * 10.0f);
+		sourceGameObjects.push_back(gameObject);
+	}
+
+	rapidjson::Document document(rapidjson::kObjectType);
+	JsonValue jPrefab(document, document);
+	JsonValue jRoot = jPrefab["Root"];
+	sourceGameObjects[0]->SavePrefab(jRoot);
+	scene.DestroyGameObject(sourceGameObjects[0]);
+
+	PrefabTemplate prefabTemplate;
+	prefabTemplate.Compile(document, document["Root"]);
+
+	std::vector<GameObject*> instances;
+	instances.reserve(BENCHMARK_PREFAB_INSTANCES);
+	unsigned mismatches = 0;
+	PerformanceTimer timer;
+
+	// Walking the JSON document for each instance, as BuildPrefab used to do
+	unsigned long long jsonTime = 0;
+	for (unsigned round = 0; round < BENCHMARK_PREFAB_ROUNDS; ++round) {
+		timer.Start();
+		for (unsigned i = 0; i < BENCHMARK_PREFAB_INSTANCES; ++i) {
+			UID gameObjectId = GenerateUID();
+			GameObject* gameObject = scene.gameObjects.Obtain(gameObjectId);
+			gameObject->scene = &scene;
+			gameObject->id = gameObjectId;
+			gameObject->SetParent(scene.root);
+			gameObject->LoadPrefab(jRoot);
+			gameObject->Init();
+			instances.push_back(gameObject);
+		}
+		jsonTime += timer.Stop();
+
+		if (scene.gameObjects.Count() != BENCHMARK_PREFAB_GAMEOBJECTS * BENCHMARK_PREFAB_INSTANCES + 1) mismatches += 1;
+		for (GameObject* instance : instances) {
+			scene.DestroyGameObject(instance);
+		}
+		instances.clear();
+	}
+
+	// Creating the instances from the compiled template
+	unsigned long long templateTime = 0;
+	for (unsigned round = 0; round < BENCHMARK_PREFAB_ROUNDS; ++round) {
+		timer.Start();
+		for (unsigned i = 0; i < BENCHMARK_PREFAB_INSTANCES; ++i) {
+			GameObject* gameObject = prefabTemplate.Instantiate(scene.root);
+			gameObject->Init();
+			instances.push_back(gameObject);
+		}
+		templateTime += timer.Stop();
+
+		if (scene.gameObjects.Count() != BENCHMARK_PREFAB_GAMEOBJECTS * BENCHMARK_PREFAB_INSTANCES + 1) mismatches += 1;
+		if (round == BENCHMARK_PREFAB_ROUNDS - 1) break; // The last instances are kept for the pool
+		for (GameObject* instance : instances) {
+			scene.DestroyGameObject(instance);
+		}
+		instances.clear();
+	}
+
+	// Despawning to the pool of a prefab and spawning again, as the scripts do for prefabs with a pool
+	ResourcePrefab prefab(GenerateUID(), "Benchmark", "", "");
+	prefab.SetPoolSize(BENCHMARK_PREFAB_INSTANCES);
+	for (GameObject* instance : instances) {
+		instance->SetPrefabId(prefab.GetId());
+	}
+
+	unsigned long long returnTime = 0;
+	unsigned long long poolTime = 0;
+	for (unsigned round = 0; round < BENCHMARK_PREFAB_ROUNDS; ++round) {
+		unsigned returned = 0;
+		timer.Start();
+		for (GameObject* instance : instances) {
+			if (prefab.ReturnToPool(instance)) returned += 1;
+		}
+		returnTime += timer.Stop();
+		instances.clear();
+
+		timer.Start();
+		for (unsigned i = 0; i < BENCHMARK_PREFAB_INSTANCES; ++i) {
+			GameObject* instance = prefab.TakeFromPool(scene.root);
+			if (instance == nullptr) break;
+
+			ComponentTransform* transform = instance->GetComponent<ComponentTransform>();
+			transform->SetGlobalRotation(Quat::identity);
+			transform->SetGlobalPosition(float3::zero);
+			instances.push_back(instance);
+		}
+		poolTime += timer.Stop();
+
+		if (returned != BENCHMARK_PREFAB_INSTANCES || instances.size() != BENCHMARK_PREFAB_INSTANCES) mismatches += 1;
+	}
+
+	unsigned long long spawns = (unsigned long long) BENCHMARK_PREFAB_INSTANCES * BENCHMARK_PREFAB_ROUNDS;
+	std::string report;
+	report += "Prefab GameObjects: " + std::to_string(prefabTemplate.GetGameObjectCount()) + ", instances: " + std::to_string(BENCHMARK_PREFAB_INSTANCES) + ", rounds: " + std::to_string(BENCHMARK_PREFAB_ROUNDS) + "\n";
+	report += "JSON walk: " + std::to_string(OperationsPerSecond(spawns, jsonTime) / 1000.0) + " instances/ms (" + std::to_string(jsonTime) + " us)\n";
+	report += "Compiled template: " + std::to_string(OperationsPerSecond(spawns, templateTime) / 1000.0) + " instances/ms (" + std::to_string(templateTime) + " us)\n";
+	report += "Pooled: " + std::to_string(OperationsPerSecond(spawns, poolTime) / 1000.0) + " instances/ms (" + std::to_string(poolTime) + " us, plus " + std::to_string(returnTime) + " us returning them)\n";
+	report += "Speedup: x" + std::to_string((double) Max(jsonTime, 1ull) / (double) Max(templateTime, 1ull)) + " (template), x" + std::to_string((double) Max(jsonTime, 1ull) / (double) Max(poolTime, 1ull)) + " (pool)\n";
+	if (mismatches > 0) report += "WARNING: " + std::to_string(mismatches) + " rounds created or pooled a different number of GameObjects\n";
+	return report;
+}
+
+// Logger before the log ring: formats under a mutex and queues a std::string per message
+class MutexLogger {
+public:
+	void Log(const char file[], int line, const char* format, ...) {
+		logMessageQueueMutex.lock();
+		va_list ap;
+		va_start(ap, format);
+		vsnprintf(tmpString, 4096, format, ap);
+		va_end(ap);
+		snprintf(tmpString2, 4096, "%s(%d) : %s\n", file, line, tmpString);
+		logMessageQueue.push(tmpString2);
+		logMessageQueueMutex.unlock();
+	}
+
+	unsigned ReadMessages(std::string& messages) {
+		unsigned numMessages = 0;
+		logMessageQueueMutex.lock();
+		while (!logMessageQueue.empty()) {
+			messages += logMessageQueue.front();
+			logMessageQueue.pop();
+			numMessages += 1;
+		}
+		logMessageQueueMutex.unlock();
+		return numMessages;
+	}
+
+private:
+	std::mutex logMessageQueueMutex;
+	std::queue<std::string> logMessageQueue;
+	char tmpString[4096] = {0};
+	char tmpString2[4096] = {0};
+};
+
+// Logs bursts of BENCHMARK_LOG_BURST messages split between 'numThreads' threads, and reads them after each burst as the main thread does every frame
+template<typename T>
+static void MeasureLogging(T& messageLogger, unsigned numThreads, unsigned long long& logTime, unsigned long long& readTime, unsigned& messagesRead) {
+	std::atomic<unsigned> startedBursts = 0;
+	std::atomic<unsigned> finishedThreads = 0;
+	std::vector<std::thread> threads;
+	for (unsigned i = 0; i < numThreads; ++i) {
+		threads.emplace_back([&messageLogger, &startedBursts, &finishedThreads, numThreads, i]() {
+			for (unsigned burst = 0; burst < BENCHMARK_LOG_BURSTS; ++burst) {
+				while (startedBursts.load() <= burst) std::this_thread::yield();
+				for (unsigned j = 0; j < BENCHMARK_LOG_BURST / numThreads; ++j) {
+					messageLogger.Log(__FILENAME__, __LINE__, "Texture imported in %ums (thread %u, \"%s\")", j, i, "Assets/Textures/Benchmark.png");
+				}
+				finishedThreads += 1;
+			}
+		});
+	}
+
+	PerformanceTimer timer;
+	std::string messages;
+	logTime = 0;
+	readTime = 0;
+	messagesRead = 0;
+	for (unsigned burst = 0; burst < BENCHMARK_LOG_BURSTS; ++burst) {
+		timer.Start();
+		startedBursts += 1;
+		while (finishedThreads.load() < numThreads * (burst + 1)) std::this_thread::yield();
+		logTime += timer.Stop();
+
+		timer.Start();
+		messagesRead += messageLogger.ReadMessages(messages);
+		readTime += timer.Stop();
+		messages.clear();
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+// Adapts the log ring to the interface of MutexLogger
+class RingLogger {
+public:
+	template<typename... Args>
+	void Log(const char file[], int line, const char* format, Args... args) {
+		ringLogger.Log(LogCategory::RESOURCES, LogSeverity::INFO, file, line, format, args...);
+	}
+
+	unsigned ReadMessages(std::string& messages) {
+		return ringLogger.ReadMessages(messages);
+	}
+
+public:
+	Logger ringLogger;
+};
+
+std::string Benchmarks::LoggingThroughput() {
+	std::unique_ptr<MutexLogger> mutexLogger = std::make_unique<MutexLogger>();
+	std::unique_ptr<RingLogger> ringLogger = std::make_unique<RingLogger>();
+
+	unsigned long long messages = (unsigned long long) BENCHMARK_LOG_BURST * BENCHMARK_LOG_BURSTS;
+	std::string report;
+	report += "Bursts: " + std::to_string(BENCHMARK_LOG_BURSTS) + " of " + std::to_string(BENCHMARK_LOG_BURST) + " messages, ring size: " + std::to_string(LOG_RING_SIZE) + "\n";
+	for (unsigned numThreads = 1; numThreads <= BENCHMARK_LOG_MAX_THREADS; numThreads *= 2) {
+		unsigned long long mutexLogTime = 0;
+		unsigned long long mutexReadTime = 0;
+		unsigned mutexRead = 0;
+		MeasureLogging(*mutexLogger, numThreads, mutexLogTime, mutexReadTime, mutexRead);
+
+		unsigned droppedBefore = ringLogger->ringLogger.GetDroppedMessages();
+		unsigned long long ringLogTime = 0;
+		unsigned long long ringReadTime = 0;
+		unsigned ringRead = 0;
+		MeasureLogging(*ringLogger, numThreads, ringLogTime, ringReadTime, ringRead);
+		unsigned dropped = ringLogger->ringLogger.GetDroppedMessages() - droppedBefore;
+
+		report += std::to_string(numThreads) + " threads: mutex " + std::to_string((unsigned long long) OperationsPerSecond(messages, mutexLogTime)) + " messages/s, ring " + std::to_string((unsigned long long) OperationsPerSecond(messages, ringLogTime)) + " messages/s";
+		report += " (x" + std::to_string((double) Max(mutexLogTime, 1ull) / (double) Max(ringLogTime, 1ull)) + "). Reading: mutex " + std::to_string(mutexReadTime) + " us, ring " + std::to_string(ringReadTime) + " us\n";
+		if (mutexRead != messages || ringRead != messages) report += "WARNING: " + std::to_string(messages * 2 - mutexRead - ringRead) + " messages were lost (" + std::to_string(dropped) + " dropped by the ring)\n";
+	}
+	return report;
+}
+
+// Copies the assets and their meta files. Returns the number of files copied
+static unsigned CopyAssetFolder(const char* folderPath, const std::string& copyPath) {
+	unsigned numFiles = 0;
+	App->files->CreateFolder(copyPath.c_str());
+	for (const std::string& file : App->files->GetFilesInFolder(folderPath)) {
+		std::string filePath = std::string(folderPath) + "/" + file;
+		std::string fileCopyPath = copyPath + "/" + file;
+		if (App->files->IsDirectory(filePath.c_str())) {
+			numFiles += CopyAssetFolder(filePath.c_str(), fileCopyPath);
+		} else if (App->files->Save(fileCopyPath.c_str(), App->files->Load(filePath.c_str()))) {
+			numFiles += 1;
+		}
+	}
+	return numFiles;
+}
+
+static void EraseFolder(const char* folderPath) {
+	for (const std::string& file : App->files->GetFilesInFolder(folderPath)) {
+		std::string filePath = std::string(folderPath) + "/" + file;
+		if (App->files->IsDirectory(filePath.c_str())) {
+			EraseFolder(filePath.c_str());
+		} else {
+			App->files->Erase(filePath.c_str());
+		}
+	}
+	App->files->Erase(folderPath);
+}
+
+static void CollectAssetFiles(const char* folderPath, std::vector<std::string>& filePaths) {
+	for (const std::string& file : App->files->GetFilesInFolder(folderPath)) {
+		std::string filePath = std::string(folderPath) + "/" + file;
+		if (App->files->IsDirectory(filePath.c_str())) {
+			CollectAssetFiles(filePath.c_str(), filePaths);
+		} else if (FileDialog::GetFileExtension(file.c_str()) != META_EXTENSION) {
+			filePaths.push_back(filePath);
+		}
+	}
+}
+
+std::string Benchmarks::AssetImport() {
+	// The assets are imported from a copy into their own library, so the project and the editor aren't touched
+	ImportIsolation isolation;
+	isolation.assetsPath = BENCHMARK_IMPORT_TEMP_PATH "/" ASSETS_PATH;
+	isolation.libraryPath = BENCHMARK_IMPORT_TEMP_PATH "/" LIBRARY_PATH;
+	if (App->files->Exists(BENCHMARK_IMPORT_TEMP_PATH)) EraseFolder(BENCHMARK_IMPORT_TEMP_PATH);
+	App->files->CreateFolder(BENCHMARK_IMPORT_TEMP_PATH);
+	App->files->CreateFolder(isolation.libraryPath.c_str());
+	unsigned numCopiedFiles = CopyAssetFolder(BENCHMARK_IMPORT_PATH, isolation.assetsPath);
+
+	std::vector<std::string> filePaths;
+	CollectAssetFiles(isolation.assetsPath.c_str(), filePaths);
+
+	std::vector<std::list<UID>> resourceIds;
+	PerformanceTimer timer;
+
+	// Import everything from scratch, first with only the calling thread and then with the workers
+	App->resources->skipUnchangedImports = false;
+	timer.Start();
+	App->resources->ImportAssets(filePaths, resourceIds, true, false, &isolation);
+	unsigned long long serialTime = timer.Stop();
+
+	timer.Start();
+	App->resources->ImportAssets(filePaths, resourceIds, true, true, &isolation);
+	unsigned long long parallelTime = timer.Stop();
+	App->resources->skipUnchangedImports = true;
+
+	// Forced import of unchanged assets, which only checks their content hashes
+	timer.Start();
+	App->resources->ImportAssets(filePaths, resourceIds, true, true, &isolation);
+	unsigned long long skipTime = timer.Stop();
+
+	EraseFolder(BENCHMARK_IMPORT_TEMP_PATH);
+
+	unsigned numResources = 0;
+	unsigned numFailed = 0;
+	for (const std::list<UID>& ids : resourceIds) {
+		numResources += (unsigned) ids.size();
+		if (ids.empty()) numFailed += 1;
+	}
+
+	std::string report;
+	report += "Assets: " + std::to_string(filePaths.size()) + " in a copy of " BENCHMARK_IMPORT_PATH " (" + std::to_string(numCopiedFiles) + " files), resources: " + std::to_string(numResources) + ", threads: " + std::to_string(App->resources->GetImportThreadCount()) + "\n";
+	report += "Serial import: " + std::to_string(serialTime / 1000) + " ms (" + std::to_string((unsigned long long) OperationsPerSecond(filePaths.size(), serialTime)) + " assets/s)\n";
+	report += "Parallel import: " + std::to_string(parallelTime / 1000) + " ms (" + std::to_string((unsigned long long) OperationsPerSecond(filePaths.size(), parallelTime)) + " assets/s, x" + std::to_string((double) Max(serialTime, 1ull) / (double) Max(parallelTime, 1ull)) + ")\n";
+	report += "Unchanged assets: " + std::to_string(skipTime / 1000) + " ms (x" + std::to_string((double) Max(serialTime, 1ull) / (double) Max(skipTime, 1ull)) + ")\n";
+	if (numFailed > 0) report += std::to_string(numFailed) + " assets have no importer or failed to import\n";
+	return report;
+}
+
+struct BenchmarkPhysicsWorld {
+	btDefaultCollisionConfiguration collisionConfiguration;
+	btCollisionDispatcher dispatcher {&collisionConfiguration};
+	btDbvtBroadphase broadPhase;
+	btSequentialImpulseConstraintSolver constraintSolver;
+	btDiscreteDynamicsWorld world {&dispatcher, &broadPhase, &constraintSolver, &collisionConfiguration};
+	btBoxShape groundShape {btVector3(100.0f, 1.0f, 100.0f)};
+	btSphereShape sphereShape {0.5f};
+	btBoxShape boxShape {btVector3(0.5f, 0.5f, 0.5f)};
+	std::vector<std::unique_ptr<btRigidBody>> bodies;
+	std::vector<btRigidBody*> kinematicBodies;
+
+	BenchmarkPhysicsWorld() {
+		world.setGravity(btVector3(0.0f, -9.81f, 0.0f));
+		AddBody(&groundShape, 0.0f, btVector3(0.0f, -1.0f, 0.0f), btCollisionObject::CF_STATIC_OBJECT);
+
+		// Piles of spheres falling on the ground, like props and ragdolls
+		int side = (int) ceil(sqrt((float) BENCHMARK_PHYSICS_DYNAMIC_BODIES / 4.0f));
+		for (int i = 0; i < BENCHMARK_PHYSICS_DYNAMIC_BODIES; ++i) {
+			int layer = i / (side * side);
+			int row = (i / side) % side;
+			int column = i % side;
+			AddBody(&sphereShape, 1.0f, btVector3((column - side / 2) * 1.1f, 1.0f + layer * 1.1f, (row - side / 2) * 1.1f), 0);
+		}
+
+		// Boxes moved by the game, like enemies and bullets
+		for (int i = 0; i < BENCHMARK_PHYSICS_KINEMATIC_BODIES; ++i) {
+			btRigidBody* body = AddBody(&boxShape, 0.0f, KinematicPosition(i, 0), btCollisionObject::CF_KINEMATIC_OBJECT);
+			body->setActivationState(DISABLE_DEACTIVATION);
+			kinematicBodies.push_back(body);
+		}
+	}
+
+	~BenchmarkPhysicsWorld() {
+		for (std::unique_ptr<btRigidBody>& body : bodies) {
+			world.removeRigidBody(body.get());
+		}
+	}
+
+	btRigidBody* AddBody(btCollisionShape* shape, float mass, const btVector3& position, int flags) {
+		btVector3 localInertia(0, 0, 0);
+		if (mass != 0.0f) shape->calculateLocalInertia(mass, localInertia);
+
+		btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, nullptr, shape, localInertia);
+		rbInfo.m_startWorldTransform.setOrigin(position);
+		bodies.push_back(std::make_unique<btRigidBody>(rbInfo));
+		btRigidBody* body = bodies.back().get();
+		body->setCollisionFlags(body->getCollisionFlags() | flags);
+		world.addRigidBody(body);
+		return body;
+	}
+
+	static btVector3 KinematicPosition(int index, unsigned frame) {
+		float angle = index * 0.37f + frame * 0.02f;
+		float radius = 5.0f + (index % 20) * 1.5f;
+		return btVector3(cos(angle) * radius, 0.5f + (index % 3), sin(angle) * radius);
+	}
+
+	void MoveKinematicBodies(unsigned frame) {
+		for (int i = 0; i < (int) kinematicBodies.size(); ++i) {
+			kinematicBodies[i]->getWorldTransform().setOrigin(KinematicPosition(i, frame));
+		}
+	}
+};
+
+static void SimulateFrameWork() {
+	PerformanceTimer timer;
+	timer.Start();
+	while (timer.Read() < BENCHMARK_PHYSICS_FRAME_WORK_US) {
+	}
+}
+
+std::string Benchmarks::PhysicsStepping() {
+	PerformanceTimer timer;
+
+	// Frames that step the world and then do the rest of their work
+	unsigned long long syncStepTime = 0;
+	unsigned long long syncFrameTime = 0;
+	{
+		std::unique_ptr<BenchmarkPhysicsWorld> physicsWorld = std::make_unique<BenchmarkPhysicsWorld>();
+		for (unsigned frame = 0; frame < BENCHMARK_PHYSICS_FRAMES; ++frame) {
+			timer.Start();
+			physicsWorld->MoveKinematicBodies(frame);
+			physicsWorld->world.stepSimulation(BENCHMARK_PHYSICS_TIME_STEP, 0);
+			syncStepTime += timer.Read();
+			SimulateFrameWork();
+			syncFrameTime += timer.Stop();
+		}
+	}
+
+	// Frames that start the step on the worker, do their work and wait for the step at the start of the next frame
+	unsigned long long asyncStepTime = 0;
+	unsigned long long asyncWaitTime = 0;
+	unsigned long long asyncFrameTime = 0;
+	{
+		std::unique_ptr<BenchmarkPhysicsWorld> physicsWorld = std::make_unique<BenchmarkPhysicsWorld>();
+		PhysicsStepper stepper;
+		stepper.Start();
+		for (unsigned frame = 0; frame < BENCHMARK_PHYSICS_FRAMES; ++frame) {
+			timer.Start();
+			if (stepper.IsStepping()) {
+				stepper.Wait();
+				asyncStepTime += stepper.GetLastStepTime();
+				asyncWaitTime += stepper.GetLastWaitTime();
+			}
+			physicsWorld->MoveKinematicBodies(frame);
+			stepper.StepAsync(&physicsWorld->world, 1, BENCHMARK_PHYSICS_TIME_STEP);
+			SimulateFrameWork();
+			asyncFrameTime += timer.Stop();
+		}
+		stepper.Wait();
+		asyncStepTime += stepper.GetLastStepTime();
+		stepper.Stop();
+	}
+
+	unsigned frames = BENCHMARK_PHYSICS_FRAMES;
+	std::string report;
+	report += "Bodies: " + std::to_string(BENCHMARK_PHYSICS_DYNAMIC_BODIES) + " dynamic, " + std::to_string(BENCHMARK_PHYSICS_KINEMATIC_BODIES) + " kinematic. Frames: " + std::to_string(frames) + ", other work per frame: " + std::to_string(BENCHMARK_PHYSICS_FRAME_WORK_US) + " us\n";
+	report += "Synchronous: step " + std::to_string(syncStepTime / frames) + " us, frame " + std::to_string(syncFrameTime / frames) + " us\n";
+	report += "Asynchronous: step " + std::to_string(asyncStepTime / frames) + " us, waited " + std::to_string(asyncWaitTime / frames) + " us, frame " + std::to_string(asyncFrameTime / frames) + " us (x" + std::to_string((double) Max(syncFrameTime, 1ull) / (double) Max(asyncFrameTime, 1ull)) + ")\n";
+	report += "The step itself runs on one thread: the Bullet version in Libs has no task scheduler to split it\n";
+	return report;
+}
+
+std::string Benchmarks::JobScaling() {
+	// Local boxes and world matrices, as the bounding boxes of the scene have them
+	std::vector<AABB> localAABBs(BENCHMARK_JOBS_BOXES);
+	std::vector<float4x4> globalMatrices(BENCHMARK_JOBS_BOXES);
+	for (unsigned i = 0; i < BENCHMARK_JOBS_BOXES; ++i) {
+		float3 halfSize = float3(0.5f + Random() * 2.0f, 0.5f + Random() * 4.0f, 0.5f + Random() * 2.0f);
+		float3 position = float3(Random() - 0.5f, (Random() - 0.5f) * 0.1f, Random() - 0.5f) * BENCHMARK_JOBS_WORLD_SIZE;
+		Quat rotation = Quat::FromEulerXYZ(Random() * pi * 2.0f, Random() * pi * 2.0f, Random() * pi * 2.0f);
+		localAABBs[i] = AABB(-halfSize, halfSize);
+		globalMatrices[i] = float4x4::FromTRS(position, rotation, float3::one);
+	}
+
+	Frustum frustum;
+	frustum.SetKind(FrustumSpaceGL, FrustumRightHanded);
+	frustum.SetViewPlaneDistances(0.1f, 2000.0f);
+	frustum.SetHorizontalFovAndAspectRatio(DEGTORAD * 90.0f, 1.3f);
+	frustum.SetPos(float3(0, 10.0f, -BENCHMARK_JOBS_WORLD_SIZE * 0.5f));
+	frustum.SetFront(vec::unitZ);
+	frustum.SetUp(vec::unitY);
+	FrustumPlanes planes;
+	planes.CalculateFrustumPlanes(frustum);
+
+	unsigned maxThreads = Max(std::thread::hardware_concurrency(), 1u);
+
+	std::string report;
+	report += "Boxes: " + std::to_string(BENCHMARK_JOBS_BOXES) + ", frames: " + std::to_string(BENCHMARK_JOBS_FRAMES) + ", hardware threads: " + std::to_string(maxThreads) + "\n";
+
+	PerformanceTimer timer;
+	CullingBatch batch;
+	std::vector<unsigned> visibility;
+	unsigned long long singleThreadTime = 0;
+	unsigned expectedVisible = 0;
+	for (unsigned numThreads = 1; numThreads <= maxThreads; ++numThreads) {
+		JobSystem jobs;
+		jobs.Start(numThreads - 1);
+
+		timer.Start();
+		for (unsigned frame = 0; frame < BENCHMARK_JOBS_FRAMES; ++frame) {
+			batch.Clear();
+			batch.Resize(BENCHMARK_JOBS_BOXES);
+			jobs.ParallelFor("Bounding box refresh", BENCHMARK_JOBS_BOXES, BENCHMARK_JOBS_REFRESH_BATCH_SIZE, [&](unsigned begin, unsigned end) {
+				for (unsigned i = begin; i < end; ++i) {
+					OBB obb = OBB(localAABBs[i]);
+					obb.Transform(globalMatrices[i]);
+					batch.Set(i, obb.MinimalEnclosingAABB(), obb);
+				}
+			});
+
+			batch.BeginCull(visibility);
+			jobs.ParallelFor("Frustum culling", (unsigned) visibility.size(), BENCHMARK_JOBS_CULLING_BATCH_WORDS, [&](unsigned begin, unsigned end) {
+				batch.CullRange(planes, visibility, begin * 32, Min(end * 32, (unsigned) BENCHMARK_JOBS_BOXES));
+			});
+		}
+		unsigned long long time = timer.Stop();
+		unsigned long long jobsStolen = jobs.GetJobsStolen();
+		jobs.Stop();
+
+		unsigned visible = 0;
+		for (unsigned i = 0; i < BENCHMARK_JOBS_BOXES; ++i) {
+			if (CullingBatch::IsVisible(visibility, i)) visible += 1;
+		}
+
+		if (numThreads == 1) {
+			singleThreadTime = time;
+			expectedVisible = visible;
+		}
+
+		double speedup = (double) Max(singleThreadTime, 1ull) / (double) Max(time, 1ull);
+		report += std::to_string(numThreads) + " threads: " + std::to_string(time / BENCHMARK_JOBS_FRAMES) + " us/frame, speedup x" + std::to_string(speedup) + ", efficiency " + std::to_string((unsigned) (speedup * 100.0 / numThreads)) + "%, jobs stolen: " + std::to_string(jobsStolen) + "\n";
+		if (visible != expectedVisible) report += "WARNING: " + std::to_string(visible) + " boxes visible, " + std::to_string(expectedVisible) + " with one thread\n";
+	}
+	return report;
+}
+
+// Transform before the transform hierarchy: each one keeps its own matrices, setters invalidate the subtree through the
+// children of the owner and reads resolve the dirty parents recursively, finding every transform with GetComponent
+class LegacyTransform : public Component {
+public:
+	REGISTER_COMPONENT(LegacyTransform, ComponentType::TRANSFORM, false);
+
+	void InvalidateHierarchy() {
+		if (!dirty) {
+			dirty = true;
+			ComponentBoundingBox* boundingBox = GetOwner().GetComponent<ComponentBoundingBox>();
+			if (boundingBox) boundingBox->Invalidate();
+
+			for (GameObject* child : GetOwner().GetChildren()) {
+				LegacyTransform* childTransform = child->GetComponent<LegacyTransform>();
+				if (childTransform != nullptr) {
+					childTransform->InvalidateHierarchy();
+				}
+			}
+		}
+	}
+
+	void CalculateGlobalMatrix(bool force = false) {
+		if (force || dirty) {
+			localMatrix = float4x4::FromTRS(position, rotation, scale);
+
+			GameObject* parent = GetOwner().GetParent();
+			if (parent != nullptr) {
+				LegacyTransform* parentTransform = parent->GetComponent<LegacyTransform>();
+
+				parentTransform->CalculateGlobalMatrix();
+				globalMatrix = parentTransform->globalMatrix * localMatrix;
+			} else {
+				globalMatrix = localMatrix;
+			}
+
+			dirty = false;
+		}
+	}
+
+	void SetPosition(float3 position_) {
+		position = position_;
+		InvalidateHierarchy();
+	}
+
+	void SetRotation(Quat rotation_) {
+		rotation = rotation_;
+		localEulerAngles = rotation_.ToEulerXYZ().Mul(RADTODEG);
+		InvalidateHierarchy();
+	}
+
+	const float4x4& GetGlobalMatrix() {
+		CalculateGlobalMatrix();
+		return globalMatrix;
+	}
+
+private:
+	float3 position = float3::zero;
+	Quat rotation = Quat::identity;
+	float3 scale = float3::one;
+	float3 localEulerAngles = float3::zero;
+	float4x4 localMatrix = float4x4::identity;
+	float4x4 globalMatrix = float4x4::identity;
+	bool dirty = true;
+};
+
+// Creates the transforms of the skeletons as children of the root of the scene. Only the root of each skeleton is offset
+template<typename T>
+static void CreateSkeletons(Scene& scene, std::vector<T*>& bones, std::function<T*(GameObject*)> createTransform) {
+	scene.root = scene.CreateGameObject(nullptr, GenerateUID(), "Root");
+	createTransform(scene.root);
+
+	bones.reserve(BENCHMARK_TRANSFORM_SKELETONS * BENCHMARK_TRANSFORM_BONES);
+	for (unsigned skeleton = 0; skeleton < BENCHMARK_TRANSFORM_SKELETONS; ++skeleton) {
+		std::vector<GameObject*> skeletonBones;
+		for (unsigned i = 0; i < BENCHMARK_TRANSFORM_BONES; ++i) {
+			GameObject* parent = i == 0 ? scene.root : skeletonBones[i < 4 ? i - 1 : (i < 8 ? 3 : i - 4)];
+			GameObject* gameObject = scene.CreateGameObject(parent, GenerateUID(), "Bone");
+			T* transform = createTransform(gameObject);
+			transform->SetPosition(i == 0 ? float3((float) skeleton * 2.0f, 0.0f, 0.0f) : float3(0.0f, 0.2f, 0.0f));
+			skeletonBones.push_back(gameObject);
+			bones.push_back(transform);
+		}
+	}
+}
+
+template<typename T>
+static void AnimateBones(const std::vector<T*>& bones, unsigned frame) {
+	for (unsigned i = 0; i < bones.size(); ++i) {
+		float angle = 0.1f * Sin((float) (frame + i) * 0.1f);
+		bones[i]->SetRotation(Quat::RotateZ(angle));
+	}
+}
+
+template<typename T>
+static void ReadBones(const std::vector<T*>& bones, float3& checksum) {
+	for (T* bone : bones) {
+		checksum += bone->GetGlobalMatrix().TranslatePart();
+	}
+}
+
+std::string Benchmarks::TransformUpdate() {
+	unsigned numGameObjects = BENCHMARK_TRANSFORM_SKELETONS * BENCHMARK_TRANSFORM_BONES + 1;
+	Scene scene(numGameObjects);
+	std::vector<ComponentTransform*> bones;
+	CreateSkeletons<ComponentTransform>(scene, bones, [](GameObject* gameObject) {
+		return gameObject->CreateComponent<ComponentTransform>();
+	});
+
+	// The legacy transforms aren't in a pool of the scene, so they are taken out of their GameObjects before it is destroyed
+	Scene legacyScene(numGameObjects);
+	std::vector<std::unique_ptr<LegacyTransform>> legacyTransforms;
+	std::vector<LegacyTransform*> legacyBones;
+	CreateSkeletons<LegacyTransform>(legacyScene, legacyBones, [&legacyTransforms](GameObject* gameObject) {
+		legacyTransforms.push_back(std::make_unique<LegacyTransform>(gameObject, GenerateUID(), true));
+		gameObject->components.push_back(legacyTransforms.back().get());
+		return legacyTransforms.back().get();
+	});
+	DEFER {
+		for (const std::unique_ptr<LegacyTransform>& legacyTransform : legacyTransforms) {
+			legacyTransform->GetOwner().components.clear();
+		}
+	};
+
+	PerformanceTimer timer;
+
+	// Every read resolves the dirty world matrices up the parents with the old transforms
+	unsigned long long legacyAnimateTime = 0;
+	unsigned long long legacyTime = 0;
+	float3 legacyChecksum = float3::zero;
+	for (unsigned frame = 0; frame < BENCHMARK_TRANSFORM_FRAMES; ++frame) {
+		timer.Start();
+		AnimateBones(legacyBones, frame);
+		legacyAnimateTime += timer.Read();
+		ReadBones(legacyBones, legacyChecksum);
+		legacyTime += timer.Stop();
+	}
+
+	// The same lazy resolution, but on the arrays of the hierarchy
+	unsigned long long lazyAnimateTime = 0;
+	unsigned long long lazyTime = 0;
+	float3 lazyChecksum = float3::zero;
+	for (unsigned frame = 0; frame < BENCHMARK_TRANSFORM_FRAMES; ++frame) {
+		timer.Start();
+		AnimateBones(bones, frame);
+		lazyAnimateTime += timer.Read();
+		ReadBones(bones, lazyChecksum);
+		lazyTime += timer.Stop();
+	}
+
+	// One sweep over the depth-sorted arrays before the reads, on this thread
+	TransformHierarchy& hierarchy = scene.transformHierarchy;
+	unsigned long long serialTime = 0;
+	float3 serialChecksum = float3::zero;
+	for (unsigned frame = 0; frame < BENCHMARK_TRANSFORM_FRAMES; ++frame) {
+		timer.Start();
+		AnimateBones(bones, frame);
+		hierarchy.SortByDepth();
+		for (unsigned level = 0; level < hierarchy.GetNumLevels(); ++level) {
+			hierarchy.UpdateWorldMatrices(hierarchy.GetLevelBegin(level), hierarchy.GetLevelEnd(level));
+		}
+		ReadBones(bones, serialChecksum);
+		serialTime += timer.Stop();
+	}
+
+	// The same sweep split between the job threads, as the scene does every frame
+	unsigned long long jobsTime = 0;
+	float3 jobsChecksum = float3::zero;
+	for (unsigned frame = 0; frame < BENCHMARK_TRANSFORM_FRAMES; ++frame) {
+		timer.Start();
+		AnimateBones(bones, frame);
+		scene.UpdateTransforms();
+		ReadBones(bones, jobsChecksum);
+		jobsTime += timer.Stop();
+	}
+
+	// Frame times include setting the local rotations, which is where the old transforms invalidated their subtrees
+	unsigned frames = BENCHMARK_TRANSFORM_FRAMES;
+	std::string report;
+	report += "Skeletons: " + std::to_string(BENCHMARK_TRANSFORM_SKELETONS) + ", bones: " + std::to_string(BENCHMARK_TRANSFORM_BONES) + ", levels: " + std::to_string(hierarchy.GetNumLevels()) + ", frames: " + std::to_string(frames) + "\n";
+	report += "Old transforms, resolved on read with GetComponent: " + std::to_string(legacyTime / frames) + " us/frame (" + std::to_string(legacyAnimateTime / frames) + " us setting the rotations)\n";
+	report += "Hierarchy, resolved on read: " + std::to_string(lazyTime / frames) + " us/frame (" + std::to_string(lazyAnimateTime / frames) + " us setting the rotations, x" + std::to_string((double) Max(legacyTime, 1ull) / (double) Max(lazyTime, 1ull)) + ")\n";
+	report += "Sweep: " + std::to_string(serialTime / frames) + " us/frame (x" + std::to_string((double) Max(legacyTime, 1ull) / (double) Max(serialTime, 1ull)) + ")\n";
+	report += "Sweep with jobs (" + std::to_string(App->jobs->GetNumThreads()) + " threads): " + std::to_string(jobsTime / frames) + " us/frame (x" + std::to_string((double) Max(legacyTime, 1ull) / (double) Max(jobsTime, 1ull)) + ")\n";
+	if (!legacyChecksum.Equals(lazyChecksum, 0.01f) || !legacyChecksum.Equals(serialChecksum, 0.01f) || !legacyChecksum.Equals(jobsChecksum, 0.01f)) report += "WARNING: the world matrices are different in the four paths\n";
+	return report;
+}
+
+std::string Benchmarks::SceneLoad() {
+	// Level of static props: a transform, a bounding box and a mesh renderer each, under a few groups
+	Scene scene(BENCHMARK_SCENE_GAMEOBJECTS + 1);
+	scene.root = scene.CreateGameObject(nullptr, GenerateUID(), "Root");
+	scene.root->CreateComponent<ComponentTransform>();
+	std::vector<GameObject*> groups;
+	for (unsigned i = 0; i < BENCHMARK_SCENE_GAMEOBJECTS; ++i) {
+		GameObject* parent = i % 100 == 0 ? scene.root : groups.back();
+		GameObject* gameObject = scene.CreateGameObject(parent, GenerateUID(), ("GameObject " + std::to_string(i)).c_str());
+		ComponentTransform* transform = gameObject->CreateComponent<ComponentTransform>();
+		transform->SetPosition(float3(Random(), Random(), Random()) * 100.0f);
+		ComponentBoundingBox* boundingBox = gameObject->CreateComponent<ComponentBoundingBox>();
+		boundingBox->SetLocalBoundingBox(AABB(float3(-1.0f), float3(1.0f)));
+		gameObject->CreateComponent<ComponentMeshRenderer>();
+		gameObject->SetStatic(true);
+		if (i % 100 == 0) groups.push_back(gameObject);
+	}
+
+	// The same scene as the editor saves it, and as it is imported
+	SceneImporter::SaveScene(&scene, BENCHMARK_SCENE_JSON_PATH);
+	rapidjson::Document document(rapidjson::kObjectType);
+	JsonValue jScene(document, document);
+	scene.Save(jScene);
+	std::vector<char> binaryData;
+	SceneImporter::WriteBinaryScene(document, binaryData);
+	App->files->Save(BENCHMARK_SCENE_BINARY_PATH, binaryData.data(), binaryData.size());
+
+	// Each load includes reading the file and initializing the scene, as ModuleScene does
+	PerformanceTimer timer;
+	unsigned long long jsonTime = 0;
+	unsigned long long binaryTime = 0;
+	unsigned failedLoads = 0;
+	for (unsigned round = 0; round < BENCHMARK_SCENE_ROUNDS; ++round) {
+		timer.Start();
+		Scene* jsonScene = SceneImporter::LoadScene(BENCHMARK_SCENE_JSON_PATH);
+		jsonTime += timer.Stop();
+		if (jsonScene == nullptr || jsonScene->gameObjects.Count() != BENCHMARK_SCENE_GAMEOBJECTS + 1) failedLoads += 1;
+		RELEASE(jsonScene);
+
+		timer.Start();
+		Scene* binaryScene = SceneImporter::LoadScene(BENCHMARK_SCENE_BINARY_PATH);
+		binaryTime += timer.Stop();
+		if (binaryScene == nullptr || binaryScene->gameObjects.Count() != BENCHMARK_SCENE_GAMEOBJECTS + 1) failedLoads += 1;
+		RELEASE(binaryScene);
+	}
+
+	unsigned long long jsonSize = App->files->Load(BENCHMARK_SCENE_JSON_PATH).Size();
+	App->files->Erase(BENCHMARK_SCENE_JSON_PATH);
+	App->files->Erase(BENCHMARK_SCENE_BINARY_PATH);
+
+	unsigned rounds = BENCHMARK_SCENE_ROUNDS;
+	std::string report;
+	report += "GameObjects: " + std::to_string(BENCHMARK_SCENE_GAMEOBJECTS) + " with 3 components, rounds: " + std::to_string(rounds) + ", pool headroom: " + std::to_string(App->scene->scenePoolHeadroom) + "\n";
+	report += "JSON: " + std::to_string(jsonTime / rounds / 1000) + " ms/load (" + std::to_string(jsonSize / 1024) + " KB, pools of " + std::to_string(MAX_SCENE_COMPONENTS) + ")\n";
+	report += "Binary: " + std::to_string(binaryTime / rounds / 1000) + " ms/load (" + std::to_string(binaryData.size() / 1024) + " KB, pools sized from the chunks)\n";
+	report += "Speedup: x" + std::to_string((double) Max(jsonTime, 1ull) / (double) Max(binaryTime, 1ull)) + "\n";
+	if (failedLoads > 0) report += "WARNING: " + std::to_string(failedLoads) + " loads failed or lost GameObjects\n";
+	return report;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+/* In-engine micro-benchmarks. They are run on demand from PanelBenchmarks.
+*  Each benchmark returns a human-readable report with the measured results.
+*/
+
+namespace Benchmarks {
+	std::string ResourceLookup();	 // Compares map+mutex resource lookups against ResourceTable handle lookups with 10k resident resources
+	std::string ParticleRendering(); // Compares drawing 10k particles with one draw call per particle against one instanced draw per emitter
+	std::string ParticleUpdate();	 // Compares the per-particle update of an array of structs against the batched SSE update of ParticleSimulation with 100k particles
+	std::string Raycast();			 // Compares casting 1,000 rays against 10k bounding boxes with a linear scan and with the raycast BVH
+	std::string FrustumCulling();	 // Compares culling 100k bounding boxes one at a time against the packed SSE kernel of CullingBatch, and checks that both agree
+	std::string PrefabSpawn();		 // Compares spawning a 30 GameObject prefab by walking its JSON, from its compiled template and from a pool of despawned instances
+	std::string LoggingThroughput(); // Compares logging bursts from 1 to 8 threads with the mutex and std::string queue against the log ring, and the time to read the messages
+	std::string AssetImport();		 // Compares a forced import of a copy of Assets with one thread and with the import pipeline, and a forced import of the unchanged assets. The project isn't touched
+	std::string PhysicsStepping();	 // Compares frames that step a 2k body world and then do 3 ms of work against frames that do the work while the world is stepped on a worker
+	std::string JobScaling();		 // Refreshes and culls 100k bounding boxes with the job system, from 1 thread up to one per hardware thread, and reports the speedup and efficiency of each
+	std::string TransformUpdate();	 // Animates 100 skeletons of 64 bones and reads their world matrices with the old recursive transforms, resolving them lazily on the hierarchy and in one batched sweep, serial and with jobs
+	std::string SceneLoad();		 // Compares loading a scene of 5k GameObjects from JSON, with pools of MAX_SCENE_COMPONENTS, against the binary format with pools sized from its chunks
+} // namespace Benchmarks
@@ -0,0 +1,129 @@
+#include "ContactCache.h"
+
+#include "btBulletDynamicsCommon.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "Utils/Leaks.h"
+
+size_t ContactCache::PairKeyHash::operator()(const PairKey& key) const {
+	size_t hash = std::hash<const void*>()(key.first);
+	return hash ^ (std::hash<const void*>()(key.second) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
+
+void ContactCache::Update(btDispatcher* dispatcher) {
+	step += 1;
+
+	int numManifolds = dispatcher->getNumManifolds();
+	for (int i = 0; i < numManifolds; ++i) {
+		btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		if (manifold->getNumContacts() == 0) continue;
+
+		const btCollisionObject* bodyA = manifold->getBody0();
+		const btCollisionObject* bodyB = manifold->getBody1();
+
+		PairKey key;
+		key.first = bodyA < bodyB ? bodyA : bodyB;
+		key.second = bodyA < bodyB ? bodyB : bodyA;
+
+		auto it = pairs.find(key);
+		bool entered = it == pairs.end();
+		if (entered) {
+			it = pairs.emplace(key, Pair()).first;
+		} else if (it->second.lastStep == step) {
+			continue; // Another manifold of the same pair
+		}
+
+		Pair& pair = it->second;
+		pair.lastStep = step;
+		pair.bodyA = bodyA;
+		pair.bodyB = bodyB;
+
+		const btManifoldPoint& point = manifold->getContactPoint(0);
+		float3 normal = float3(point.m_normalWorldOnB);
+		float3 penetration = float3(point.getPositionWorldOnB()) - float3(point.getPositionWorldOnA());
+
+		// The pair is still touching since its pending event, which can only be an ENTER or a STAY
+		if (pair.eventBatch == batch) {
+			ContactEvent& pendingEvent = events[pair.eventIndex];
+			if (pendingEvent.type == ContactEventType::STAY) {
+				pendingEvent.bodyA = bodyA;
+				pendingEvent.bodyB = bodyB;
+				pendingEvent.normal = normal;
+				pendingEvent.penetration = penetration;
+			}
+			continue;
+		}
+
+		ContactEvent event;
+		event.type = entered ? ContactEventType::ENTER : ContactEventType::STAY;
+		event.bodyA = bodyA;
+		event.bodyB = bodyB;
+		event.normal = normal;
+		event.penetration = penetration;
+		pair.eventBatch = batch;
+		pair.eventIndex = (unsigned) events.size();
+		events.push_back(event);
+	}
+
+	// Pairs that weren't found in this step
+	for (auto it = pairs.begin(); it != pairs.end();) {
+		if (it->second.lastStep == step) {
+			++it;
+			continue;
+		}
+
+		ContactEvent event;
+		event.type = ContactEventType::EXIT;
+		event.bodyA = it->second.bodyA;
+		event.bodyB = it->second.bodyB;
+		events.push_back(event);
+
+		it = pairs.erase(it);
+	}
+}
+
+void ContactCache::RemoveBodies(const std::vector<const btCollisionObject*>& bodies) {
+	if (bodies.empty()) return;
+
+	std::vector<const btCollisionObject*> sortedBodies = bodies;
+	std::sort(sortedBodies.begin(), sortedBodies.end());
+	auto isRemoved = [&sortedBodies](const btCollisionObject* body) {
+		return std::binary_search(sortedBodies.begin(), sortedBodies.end(), body);
+	};
+
+	for (auto it = pairs.begin(); it != pairs.end();) {
+		if (isRemoved(it->first.first) || isRemoved(it->first.second)) {
+			it = pairs.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	events.erase(std::remove_if(events.begin(), events.end(), [&isRemoved](const ContactEvent& event) {
+		return isRemoved(event.bodyA) || isRemoved(event.bodyB);
+	}), events.end());
+
+	// The remaining events moved, so the pairs can't find theirs anymore
+	batch += 1;
+}
+
+void ContactCache::Clear() {
+	pairs.clear();
+	events.clear();
+	batch += 1;
+}
+
+const std::vector<ContactEvent>& ContactCache::GetEvents() const {
+	return events;
+}
+
+void ContactCache::ClearEvents() {
+	events.clear();
+	batch += 1;
+}
+
+unsigned ContactCache::GetNumPairs() const {
+	return (unsigned) pairs.size();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Math/float3.h"
+
+#include <vector>
+#include <unordered_map>
+
+class btCollisionObject;
+class btDispatcher;
+
+enum class ContactEventType {
+	ENTER, // The bodies started touching in this step
+	STAY,  // The bodies were already touching in the previous step
+	EXIT   // The bodies stopped touching in this step
+};
+
+struct ContactEvent {
+	ContactEventType type = ContactEventType::STAY;
+	const btCollisionObject* bodyA = nullptr;
+	const btCollisionObject* bodyB = nullptr;
+	float3 normal = float3::zero;	   // Normal of the contact on B. Zero for EXIT
+	float3 penetration = float3::zero; // From the contact point on A to the contact point on B. Zero for EXIT
+};
+
+/* Pairs of bodies that were touching in the last step. After each step, the contact manifolds of the dispatcher are
+*  compared against the pairs of the previous step to get the enter, stay and exit events of the step. Events accumulate
+*  until they are cleared, so that several steps can run before they are sent. A pair only keeps one pending event while
+*  it stays in contact: later steps update its contact instead of adding more events.
+*/
+
+class ContactCache {
+public:
+	void Update(btDispatcher* dispatcher);									// Called after each step, from the thread that steps the world
+	void RemoveBodies(const std::vector<const btCollisionObject*>& bodies);	// Forgets the pairs of bodies that left the world, without exit events
+	void Clear();
+
+	const std::vector<ContactEvent>& GetEvents() const;
+	void ClearEvents();
+	unsigned GetNumPairs() const;
+
+private:
+	struct PairKey {
+		const btCollisionObject* first = nullptr; // Lower address of the two
+		const btCollisionObject* second = nullptr;
+
+		bool operator==(const PairKey& other) const {
+			return first == other.first && second == other.second;
+		}
+	};
+
+	struct PairKeyHash {
+		size_t operator()(const PairKey& key) const;
+	};
+
+	struct Pair {
+		unsigned lastStep = 0;
+		unsigned eventBatch = 0; // Batch of the pending event of the pair. The event is only valid if it matches the current batch
+		unsigned eventIndex = 0;
+		const btCollisionObject* bodyA = nullptr; // Order of the bodies in the manifold, which gives the direction of the normal
+		const btCollisionObject* bodyB = nullptr;
+	};
+
+private:
+	std::unordered_map<PairKey, Pair, PairKeyHash> pairs;
+	std::vector<ContactEvent> events;
+	unsigned step = 0;
+	unsigned batch = 1; // Increased every time the events are cleared or reordered
+};
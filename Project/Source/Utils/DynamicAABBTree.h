@@ -0,0 +1,318 @@
+#pragma once
+
+#include "Math/float3.h"
+#include "Geometry/AABB.h"
+#include <vector>
+#include <algorithm>
+#include <assert.h>
+
+#define DYNAMIC_AABB_TREE_NULL_NODE -1
+#define DYNAMIC_AABB_TREE_MARGIN 0.5f	  // Enlargement of the leaf AABBs, so that objects can move a bit without being reinserted
+#define DYNAMIC_AABB_TREE_STACK_SIZE 256 // Size of the traversal stack. The tree is kept balanced, so its height grows with log2 of the element count
+
+/* Incrementally updated AABB tree for objects that move. Each object is a leaf with an enlarged ("fat") AABB.
+*  Moving an object only reinserts its leaf when its new AABB leaves the fat one, and insertions pick the sibling
+*  that least increases the surface area of the tree. Nodes are rotated on the way up to keep the tree balanced.
+*  Nodes are stored in a vector and referenced by index, and leaves keep their index while they are in the tree.
+*/
+
+template<typename T>
+class DynamicAABBTree {
+public:
+	class Node {
+	public:
+		bool IsLeaf() const {
+			return left == DYNAMIC_AABB_TREE_NULL_NODE;
+		}
+
+	public:
+		AABB aabb = {{0, 0, 0}, {0, 0, 0}};
+		T* object = nullptr;
+		int parent = DYNAMIC_AABB_TREE_NULL_NODE; // Next free node if the node isn't used
+		int left = DYNAMIC_AABB_TREE_NULL_NODE;
+		int right = DYNAMIC_AABB_TREE_NULL_NODE;
+		int height = -1; // 0 for leaves, -1 for free nodes
+	};
+
+public:
+	void Clear() {
+		nodes.clear();
+		root = DYNAMIC_AABB_TREE_NULL_NODE;
+		freeList = DYNAMIC_AABB_TREE_NULL_NODE;
+		numElements = 0;
+	}
+
+	// Returns the index of the leaf of the object, used to move and remove it
+	int Insert(T* object, const AABB& aabb) {
+		int leaf = AllocateNode();
+		Node& node = nodes[leaf];
+		node.object = object;
+		node.aabb = Enlarge(aabb);
+		node.height = 0;
+		InsertLeaf(leaf);
+		numElements += 1;
+		return leaf;
+	}
+
+	void Remove(int leaf) {
+		assert(leaf >= 0 && leaf < (int) nodes.size() && nodes[leaf].IsLeaf());
+		RemoveLeaf(leaf);
+		FreeNode(leaf);
+		numElements -= 1;
+	}
+
+	// Returns true if the leaf had to be reinserted
+	bool Move(int leaf, const AABB& aabb) {
+		assert(leaf >= 0 && leaf < (int) nodes.size() && nodes[leaf].IsLeaf());
+		if (nodes[leaf].aabb.Contains(aabb)) return false;
+
+		RemoveLeaf(leaf);
+		nodes[leaf].aabb = Enlarge(aabb);
+		InsertLeaf(leaf);
+		return true;
+	}
+
+	// 'test' returns true if a node AABB can contain results. 'callback' is called with the objects of the leaves that pass the test
+	template<typename F, typename G>
+	void Query(F test, G callback) const {
+		if (root == DYNAMIC_AABB_TREE_NULL_NODE) return;
+
+		int stack[DYNAMIC_AABB_TREE_STACK_SIZE];
+		unsigned stackSize = 0;
+		stack[stackSize++] = root;
+		while (stackSize > 0) {
+			const Node& node = nodes[stack[--stackSize]];
+			if (!test(node.aabb)) continue;
+
+			if (node.IsLeaf()) {
+				callback(node.object);
+			} else {
+				assert(stackSize + 2 <= DYNAMIC_AABB_TREE_STACK_SIZE);
+				stack[stackSize++] = node.right;
+				stack[stackSize++] = node.left;
+			}
+		}
+	}
+
+	T* GetObject(int leaf) const {
+		return nodes[leaf].object;
+	}
+
+	const AABB& GetFatAABB(int leaf) const {
+		return nodes[leaf].aabb;
+	}
+
+	unsigned GetElementCount() const {
+		return numElements;
+	}
+
+	int GetHeight() const {
+		return root != DYNAMIC_AABB_TREE_NULL_NODE ? nodes[root].height : 0;
+	}
+
+private:
+	static AABB Enlarge(const AABB& aabb) {
+		float3 margin = float3(DYNAMIC_AABB_TREE_MARGIN, DYNAMIC_AABB_TREE_MARGIN, DYNAMIC_AABB_TREE_MARGIN);
+		return AABB(aabb.minPoint - margin, aabb.maxPoint + margin);
+	}
+
+	static AABB Union(const AABB& a, const AABB& b) {
+		AABB result = a;
+		result.Enclose(b);
+		return result;
+	}
+
+	int AllocateNode() {
+		int index;
+		if (freeList != DYNAMIC_AABB_TREE_NULL_NODE) {
+			index = freeList;
+			freeList = nodes[index].parent;
+			nodes[index] = Node();
+		} else {
+			index = (int) nodes.size();
+			nodes.emplace_back();
+		}
+		return index;
+	}
+
+	void FreeNode(int index) {
+		Node& node = nodes[index];
+		node.object = nullptr;
+		node.left = DYNAMIC_AABB_TREE_NULL_NODE;
+		node.right = DYNAMIC_AABB_TREE_NULL_NODE;
+		node.height = -1;
+		node.parent = freeList;
+		freeList = index;
+	}
+
+	void InsertLeaf(int leaf) {
+		if (root == DYNAMIC_AABB_TREE_NULL_NODE) {
+			root = leaf;
+			nodes[leaf].parent = DYNAMIC_AABB_TREE_NULL_NODE;
+			return;
+		}
+
+		// Find the best sibling, going down while it's cheaper than making a new parent at the current node
+		AABB leafAABB = nodes[leaf].aabb;
+		int index = root;
+		while (!nodes[index].IsLeaf()) {
+			const Node& node = nodes[index];
+			float area = node.aabb.SurfaceArea();
+			float combinedArea = Union(node.aabb, leafAABB).SurfaceArea();
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area); // Minimum cost of pushing the leaf further down
+
+			float leftCost = DescendCost(node.left, leafAABB) + inheritanceCost;
+			float rightCost = DescendCost(node.right, leafAABB) + inheritanceCost;
+			if (cost < leftCost && cost < rightCost) break;
+
+			index = leftCost < rightCost ? node.left : node.right;
+		}
+
+		int sibling = index;
+		int oldParent = nodes[sibling].parent;
+		int newParent = AllocateNode();
+		Node& parentNode = nodes[newParent];
+		parentNode.parent = oldParent;
+		parentNode.aabb = Union(leafAABB, nodes[sibling].aabb);
+		parentNode.height = nodes[sibling].height + 1;
+		parentNode.left = sibling;
+		parentNode.right = leaf;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+
+		if (oldParent != DYNAMIC_AABB_TREE_NULL_NODE) {
+			if (nodes[oldParent].left == sibling) {
+				nodes[oldParent].left = newParent;
+			} else {
+				nodes[oldParent].right = newParent;
+			}
+		} else {
+			root = newParent;
+		}
+
+		RefitAncestors(newParent);
+	}
+
+	void RemoveLeaf(int leaf) {
+		if (leaf == root) {
+			root = DYNAMIC_AABB_TREE_NULL_NODE;
+			return;
+		}
+
+		int parent = nodes[leaf].parent;
+		int grandParent = nodes[parent].parent;
+		int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+		if (grandParent != DYNAMIC_AABB_TREE_NULL_NODE) {
+			if (nodes[grandParent].left == parent) {
+				nodes[grandParent].left = sibling;
+			} else {
+				nodes[grandParent].right = sibling;
+			}
+			nodes[sibling].parent = grandParent;
+			FreeNode(parent);
+
+			RefitAncestors(grandParent);
+		} else {
+			root = sibling;
+			nodes[sibling].parent = DYNAMIC_AABB_TREE_NULL_NODE;
+			FreeNode(parent);
+		}
+	}
+
+	// Cost of inserting a leaf with the given AABB somewhere under 'index', without the inherited cost
+	float DescendCost(int index, const AABB& leafAABB) const {
+		const Node& node = nodes[index];
+		float combinedArea = Union(node.aabb, leafAABB).SurfaceArea();
+		return node.IsLeaf() ? combinedArea : combinedArea - node.aabb.SurfaceArea();
+	}
+
+	// Rebalances and recalculates the AABBs and heights from 'index' to the root
+	void RefitAncestors(int index) {
+		while (index != DYNAMIC_AABB_TREE_NULL_NODE) {
+			index = Balance(index);
+
+			Node& node = nodes[index];
+			const Node& left = nodes[node.left];
+			const Node& right = nodes[node.right];
+			node.height = 1 + std::max(left.height, right.height);
+			node.aabb = Union(left.aabb, right.aabb);
+
+			index = node.parent;
+		}
+	}
+
+	// Rotates the taller child of 'indexA' up if the heights of its children differ by more than one. Returns the index of the new subtree root
+	int Balance(int indexA) {
+		Node& a = nodes[indexA];
+		if (a.IsLeaf() || a.height < 2) return indexA;
+
+		int indexB = a.left;
+		int indexC = a.right;
+		Node& b = nodes[indexB];
+		Node& c = nodes[indexC];
+		int balance = c.height - b.height;
+
+		if (balance > 1) {
+			return Rotate(indexA, indexC, false);
+		} else if (balance < -1) {
+			return Rotate(indexA, indexB, true);
+		}
+
+		return indexA;
+	}
+
+	// Makes 'indexChild' the parent of 'indexA'. 'isLeft' tells on which side of 'indexA' the child was
+	int Rotate(int indexA, int indexChild, bool isLeft) {
+		Node& a = nodes[indexA];
+		Node& child = nodes[indexChild];
+		int indexOther = isLeft ? a.right : a.left; // The child of 'a' that stays
+		int indexF = child.left;
+		int indexG = child.right;
+		Node& f = nodes[indexF];
+		Node& g = nodes[indexG];
+
+		// The child takes the place of 'a'
+		child.left = indexA;
+		child.parent = a.parent;
+		a.parent = indexChild;
+		if (child.parent != DYNAMIC_AABB_TREE_NULL_NODE) {
+			if (nodes[child.parent].left == indexA) {
+				nodes[child.parent].left = indexChild;
+			} else {
+				nodes[child.parent].right = indexChild;
+			}
+		} else {
+			root = indexChild;
+		}
+
+		// The taller grandchild stays under the child, and the other one replaces the child under 'a'
+		int indexTaller = f.height > g.height ? indexF : indexG;
+		int indexShorter = f.height > g.height ? indexG : indexF;
+		Node& taller = nodes[indexTaller];
+		Node& shorter = nodes[indexShorter];
+
+		child.right = indexTaller;
+		if (isLeft) {
+			a.left = indexShorter;
+		} else {
+			a.right = indexShorter;
+		}
+		shorter.parent = indexA;
+
+		const Node& other = nodes[indexOther];
+		a.aabb = Union(other.aabb, shorter.aabb);
+		a.height = 1 + std::max(other.height, shorter.height);
+		child.aabb = Union(a.aabb, taller.aabb);
+		child.height = 1 + std::max(a.height, taller.height);
+
+		return indexChild;
+	}
+
+private:
+	std::vector<Node> nodes;
+	int root = DYNAMIC_AABB_TREE_NULL_NODE;
+	int freeList = DYNAMIC_AABB_TREE_NULL_NODE;
+	unsigned numElements = 0;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Math/myassert.h"
+
+#include <mutex>
+#include <new>
+#include <utility>
+
+/* Pre-allocated payloads for the event data that doesn't fit inline in a TesseractEvent (names and paths).
+*  Payloads can be obtained from any thread, and are released on the main thread when the event is cleaned up.
+*  If the pool runs out, the payload is allocated on the heap instead, so a burst of events never fails.
+*/
+
+template<typename T>
+class EventPayloadPool {
+public:
+	~EventPayloadPool() {
+		Deallocate();
+	}
+
+	void Allocate(unsigned amount) {
+		Deallocate();
+
+		data = (T*) ::operator new(amount * sizeof(T));
+		freeIndices = (unsigned*) ::operator new(amount * sizeof(unsigned));
+		capacity = amount;
+		numFree = amount;
+		for (unsigned i = 0; i < amount; ++i) {
+			freeIndices[i] = amount - i - 1; // The first payloads are obtained first
+		}
+	}
+
+	void Deallocate() {
+		assert(numFree == capacity); // ERROR: Some payloads haven't been released
+
+		if (data != nullptr) {
+			::operator delete(data);
+			::operator delete(freeIndices);
+			data = nullptr;
+			freeIndices = nullptr;
+		}
+		capacity = 0;
+		numFree = 0;
+	}
+
+	template<typename... Args>
+	T* Obtain(Args&&... args) {
+		T* payload = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (numFree > 0) {
+				numFree -= 1;
+				payload = data + freeIndices[numFree];
+			} else {
+				overflowCount += 1;
+			}
+		}
+
+		if (payload == nullptr) return new T(std::forward<Args>(args)...);
+		return new (payload) T(std::forward<Args>(args)...);
+	}
+
+	void Release(T* payload) {
+		if (payload == nullptr) return;
+
+		if (payload < data || payload >= data + capacity) {
+			delete payload;
+			return;
+		}
+
+		payload->~T();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		assert(numFree < capacity); // ERROR: The payload is already free
+		freeIndices[numFree++] = (unsigned) (payload - data);
+	}
+
+	unsigned Capacity() const {
+		return capacity;
+	}
+
+	unsigned GetOverflowCount() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return overflowCount;
+	}
+
+private:
+	mutable std::mutex mutex;
+	T* data = nullptr;
+	unsigned* freeIndices = nullptr;
+	unsigned capacity = 0;
+	unsigned numFree = 0;
+	unsigned overflowCount = 0; // Payloads that were allocated on the heap because the pool was empty
+};
@@ -0,0 +1,218 @@
+#include "FileWatcher.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/inotify.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+#include "Utils/Leaks.h"
+
+FileWatcher::~FileWatcher() {
+	Stop();
+}
+
+void FileWatcher::AddChange(FileChangeType type, const std::string& path, std::vector<FileChange>& changes) const {
+	FileChange change;
+	change.type = type;
+	change.path = path;
+	for (char& c : change.path) {
+		if (c == '\\') c = '/';
+	}
+	changes.push_back(std::move(change));
+}
+
+#ifdef _WIN32
+
+bool FileWatcher::Start(const char* folderPath_) {
+	Stop();
+
+	HANDLE handle = CreateFileA(folderPath_, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+	if (handle == INVALID_HANDLE_VALUE) return false;
+
+	folderPath = folderPath_;
+	directoryHandle = handle;
+	OVERLAPPED* newOverlapped = new OVERLAPPED();
+	newOverlapped->hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	overlapped = newOverlapped;
+	buffer.resize(FILE_WATCHER_BUFFER_SIZE);
+
+	if (!ReadChanges()) {
+		Stop();
+		return false;
+	}
+
+	return true;
+}
+
+void FileWatcher::Stop() {
+	if (directoryHandle == nullptr) return;
+
+	// Wait for the pending read to be cancelled before releasing its buffer
+	OVERLAPPED* pendingOverlapped = (OVERLAPPED*) overlapped;
+	DWORD bytes = 0;
+	CancelIoEx(directoryHandle, pendingOverlapped);
+	GetOverlappedResult(directoryHandle, pendingOverlapped, &bytes, TRUE);
+
+	CloseHandle(pendingOverlapped->hEvent);
+	CloseHandle(directoryHandle);
+	delete pendingOverlapped;
+	directoryHandle = nullptr;
+	overlapped = nullptr;
+	buffer.clear();
+}
+
+bool FileWatcher::IsWatching() const {
+	return directoryHandle != nullptr;
+}
+
+bool FileWatcher::PollChanges(std::vector<FileChange>& changes) {
+	if (directoryHandle == nullptr) return false;
+
+	DWORD bytes = 0;
+	if (!GetOverlappedResult(directoryHandle, (OVERLAPPED*) overlapped, &bytes, FALSE)) {
+		if (GetLastError() == ERROR_IO_INCOMPLETE) return true; // No changes yet
+
+		ReadChanges();
+		return false;
+	}
+
+	// A successful read without data means the buffer overflowed
+	bool complete = bytes > 0;
+	size_t offset = 0;
+	while (complete) {
+		FILE_NOTIFY_INFORMATION* notification = (FILE_NOTIFY_INFORMATION*) (buffer.data() + offset);
+
+		int nameLength = (int) (notification->FileNameLength / sizeof(WCHAR));
+		int size = WideCharToMultiByte(CP_UTF8, 0, notification->FileName, nameLength, NULL, 0, NULL, NULL);
+		std::string path = folderPath + "/";
+		size_t nameOffset = path.size();
+		path.resize(nameOffset + size);
+		WideCharToMultiByte(CP_UTF8, 0, notification->FileName, nameLength, &path[nameOffset], size, NULL, NULL);
+
+		switch (notification->Action) {
+		case FILE_ACTION_ADDED:
+		case FILE_ACTION_RENAMED_NEW_NAME:
+			AddChange(FileChangeType::ADDED, path, changes);
+			break;
+		case FILE_ACTION_REMOVED:
+		case FILE_ACTION_RENAMED_OLD_NAME:
+			AddChange(FileChangeType::REMOVED, path, changes);
+			break;
+		case FILE_ACTION_MODIFIED:
+			AddChange(FileChangeType::MODIFIED, path, changes);
+			break;
+		}
+
+		if (notification->NextEntryOffset == 0) break;
+		offset += notification->NextEntryOffset;
+	}
+
+	if (!ReadChanges()) {
+		Stop();
+		return false;
+	}
+
+	return complete;
+}
+
+bool FileWatcher::ReadChanges() {
+	OVERLAPPED* pendingOverlapped = (OVERLAPPED*) overlapped;
+	ResetEvent(pendingOverlapped->hEvent);
+
+	DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+	return ReadDirectoryChangesW(directoryHandle, buffer.data(), (DWORD) buffer.size(), TRUE, filter, NULL, pendingOverlapped, NULL) != FALSE;
+}
+
+#else
+
+bool FileWatcher::Start(const char* folderPath_) {
+	Stop();
+
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd < 0) return false;
+
+	folderPath = folderPath_;
+	buffer.resize(FILE_WATCHER_BUFFER_SIZE);
+	WatchFolderRecursive(folderPath);
+	if (watchedFolders.empty()) {
+		Stop();
+		return false;
+	}
+
+	return true;
+}
+
+void FileWatcher::Stop() {
+	if (inotifyFd < 0) return;
+
+	close(inotifyFd);
+	inotifyFd = -1;
+	watchedFolders.clear();
+	buffer.clear();
+}
+
+bool FileWatcher::IsWatching() const {
+	return inotifyFd >= 0;
+}
+
+bool FileWatcher::PollChanges(std::vector<FileChange>& changes) {
+	if (inotifyFd < 0) return false;
+
+	bool complete = true;
+	while (true) {
+		ssize_t bytes = read(inotifyFd, buffer.data(), buffer.size());
+		if (bytes <= 0) break; // EAGAIN: no more changes
+
+		for (ssize_t offset = 0; offset < bytes;) {
+			const inotify_event* notification = (const inotify_event*) (buffer.data() + offset);
+			offset += sizeof(inotify_event) + notification->len;
+
+			if (notification->mask & IN_Q_OVERFLOW) {
+				complete = false;
+				continue;
+			}
+			if (notification->mask & IN_IGNORED) {
+				watchedFolders.erase(notification->wd);
+				continue;
+			}
+
+			auto it = watchedFolders.find(notification->wd);
+			if (it == watchedFolders.end() || notification->len == 0) continue;
+
+			std::string path = it->second + "/" + notification->name;
+			if (notification->mask & (IN_CREATE | IN_MOVED_TO)) {
+				// inotify isn't recursive, so new subfolders need their own watches
+				if (notification->mask & IN_ISDIR) WatchFolderRecursive(path);
+				AddChange(FileChangeType::ADDED, path, changes);
+			} else if (notification->mask & (IN_DELETE | IN_MOVED_FROM)) {
+				AddChange(FileChangeType::REMOVED, path, changes);
+			} else if (notification->mask & (IN_MODIFY | IN_CLOSE_WRITE)) {
+				AddChange(FileChangeType::MODIFIED, path, changes);
+			}
+		}
+	}
+
+	return complete;
+}
+
+void FileWatcher::WatchFolderRecursive(const std::string& path) {
+	int watch = inotify_add_watch(inotifyFd, path.c_str(), IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO);
+	if (watch < 0) return;
+	watchedFolders[watch] = path;
+
+	DIR* directory = opendir(path.c_str());
+	if (directory == nullptr) return;
+
+	while (dirent* entry = readdir(directory)) {
+		if (entry->d_type != DT_DIR || strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+		WatchFolderRecursive(path + "/" + entry->d_name);
+	}
+	closedir(directory);
+}
+
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#define FILE_WATCHER_BUFFER_SIZE (64 * 1024) // Notifications that can be held between polls. If they don't fit, they're lost
+
+enum class FileChangeType {
+	ADDED,
+	REMOVED,
+	MODIFIED
+};
+
+struct FileChange {
+	FileChangeType type = FileChangeType::MODIFIED;
+	std::string path = ""; // Path of the file or folder, starting with the watched folder path and separated with '/'
+};
+
+/* Watches a folder and its subfolders with the change notifications of the OS (ReadDirectoryChangesW on Windows,
+*  inotify on Linux), so that changes can be handled without scanning the folder. Renames are reported as a removal
+*  of the old path and an addition of the new one. Notifications are lost if too many happen between two polls,
+*  and PollChanges returns false so that the folder can be scanned instead.
+*/
+
+class FileWatcher {
+public:
+	~FileWatcher();
+
+	bool Start(const char* folderPath); // Returns false if the folder can't be watched
+	void Stop();
+	bool IsWatching() const;
+
+	bool PollChanges(std::vector<FileChange>& changes); // Appends the changes since the last poll without blocking. Returns false if some were lost
+
+private:
+	void AddChange(FileChangeType type, const std::string& path, std::vector<FileChange>& changes) const;
+
+#ifdef _WIN32
+	bool ReadChanges();
+#else
+	void WatchFolderRecursive(const std::string& path);
+#endif
+
+private:
+	std::string folderPath = "";
+
+#ifdef _WIN32
+	void* directoryHandle = nullptr; // HANDLE
+	void* overlapped = nullptr;		 // OVERLAPPED
+	std::vector<unsigned char> buffer;
+#else
+	int inotifyFd = -1;
+	std::unordered_map<int, std::string> watchedFolders; // Path of each watch descriptor
+	std::vector<unsigned char> buffer;
+#endif
+};
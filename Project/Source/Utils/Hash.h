@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+// 64-bit FNV-1a
+inline unsigned long long HashData(const char* data, size_t size, unsigned long long hash = 14695981039346656037ull) {
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= (unsigned char) data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+inline unsigned long long HashString(const std::string& string, unsigned long long hash = 14695981039346656037ull) {
+	return HashData(string.c_str(), string.size() + 1, hash); // The terminator separates consecutive strings
+}
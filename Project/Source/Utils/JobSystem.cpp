@@ -0,0 +1,214 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "Utils/Leaks.h"
+
+// Queue of the current thread. Threads outside the system (and the one that started it) use the first queue
+static thread_local const JobSystem* currentJobSystem = nullptr;
+static thread_local unsigned currentThreadIndex = 0;
+
+bool JobCounter::IsDone() const {
+	return pending.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::~JobSystem() {
+	Stop();
+}
+
+void JobSystem::Start(unsigned numWorkers) {
+	Stop();
+
+	stopping = false;
+	for (unsigned i = 0; i < numWorkers + 1; ++i) {
+		queues.push_back(std::make_unique<JobQueue>());
+	}
+	for (unsigned i = 1; i < numWorkers + 1; ++i) {
+		workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+void JobSystem::Stop() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	jobQueued.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+
+	// The workers only leave when the queues are empty, but jobs can still be pushed from outside
+	if (!queues.empty()) {
+		Job job;
+		while (Pop(0, job)) {
+			Execute(job);
+		}
+	}
+	queues.clear();
+}
+
+unsigned JobSystem::GetNumThreads() const {
+	return (unsigned) workers.size() + 1;
+}
+
+void JobSystem::Run(const char* name, JobFunction function, JobCounter* counter) {
+	if (workers.empty()) {
+		function();
+		return;
+	}
+
+	Job job;
+	job.function = std::move(function);
+	job.counter = counter;
+	Describe(job, name);
+	Push(std::move(job));
+}
+
+void JobSystem::ParallelFor(const char* name, unsigned count, unsigned batchSize, const ParallelForFunction& function) {
+	if (batchSize == 0) batchSize = 1;
+	if (workers.empty() || count <= batchSize) {
+		if (count > 0) function(0, count);
+		return;
+	}
+
+	// The first batch runs on this thread, after the rest have been queued for the workers to steal
+	JobCounter counter;
+	Job batchJob;
+	batchJob.counter = &counter;
+	Describe(batchJob, name);
+	for (unsigned begin = batchSize; begin < count; begin += batchSize) {
+		unsigned end = std::min(begin + batchSize, count);
+		Job job = batchJob;
+		job.function = [&function, begin, end]() { function(begin, end); };
+		Push(std::move(job));
+	}
+
+	function(0, batchSize);
+	Wait(counter);
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	unsigned threadIndex = GetThreadIndex();
+	Job job;
+	while (!counter.IsDone()) {
+		if (Pop(threadIndex, job)) {
+			Execute(job);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+unsigned long long JobSystem::GetJobsExecuted() const {
+	return jobsExecuted;
+}
+
+unsigned long long JobSystem::GetJobsStolen() const {
+	return jobsStolen;
+}
+
+unsigned JobSystem::GetThreadIndex() const {
+	return currentJobSystem == this ? currentThreadIndex : 0;
+}
+
+void JobSystem::Describe(Job& job, const char* name) {
+#if USE_PROFILER
+	std::lock_guard<std::mutex> lock(descriptionsMutex);
+	for (const std::pair<const char*, Profiler::EventDescription*>& description : descriptions) {
+		if (description.first == name) {
+			job.description = description.second;
+			return;
+		}
+	}
+	job.description = Profiler::EventDescription::Create(name, __FILE__, __LINE__, (unsigned long) Profiler::Color::Orange);
+	descriptions.emplace_back(name, job.description);
+#endif
+}
+
+void JobSystem::Push(Job&& job) {
+	if (job.counter != nullptr) {
+		job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	JobQueue& queue = *queues[GetThreadIndex()];
+	{
+		// Counted before the job is visible, or a thief could take it first and make the count wrap around
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queuedJobs += 1;
+		queue.jobs.push_back(std::move(job));
+	}
+
+	// Taking the lock makes sure that a worker can't miss the job between checking the count and going to sleep
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	jobQueued.notify_one();
+}
+
+bool JobSystem::Pop(unsigned threadIndex, Job& job) {
+	if (queuedJobs == 0) return false;
+
+	// Newest job of the own queue, which is the most likely to still be in the cache
+	{
+		JobQueue& queue = *queues[threadIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			queuedJobs -= 1;
+			return true;
+		}
+	}
+
+	// Oldest job of another queue
+	unsigned numQueues = (unsigned) queues.size();
+	for (unsigned i = 1; i < numQueues; ++i) {
+		JobQueue& queue = *queues[(threadIndex + i) % numQueues];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			queuedJobs -= 1;
+			jobsStolen += 1;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::Execute(Job& job) {
+	{
+#if USE_PROFILER
+		Profiler::Category category(*job.description);
+#endif
+		job.function();
+	}
+	job.function = nullptr;
+	jobsExecuted += 1;
+
+	if (job.counter != nullptr) {
+		job.counter->pending.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void JobSystem::WorkerLoop(unsigned threadIndex) {
+	BROFILER_THREAD("Job Worker");
+	currentJobSystem = this;
+	currentThreadIndex = threadIndex;
+
+	Job job;
+	while (true) {
+		if (Pop(threadIndex, job)) {
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		jobQueued.wait(lock, [this] { return stopping || queuedJobs > 0; });
+		if (stopping && queuedJobs == 0) return;
+	}
+}
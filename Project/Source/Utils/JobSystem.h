@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Brofiler.h"
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+using JobFunction = std::function<void()>;
+using ParallelForFunction = std::function<void(unsigned begin, unsigned end)>;
+
+/* Number of jobs that haven't finished yet. Jobs that are run with a counter increase it, and decrease it when
+*  they finish. Waiting for a counter is how a job or a stage of the frame depends on the jobs it started.
+*/
+
+class JobCounter {
+public:
+	bool IsDone() const;
+
+private:
+	friend class JobSystem;
+	std::atomic<unsigned> pending {0};
+};
+
+/* Work-stealing job system. Each thread has its own queue: jobs are pushed and popped at the back of the queue of
+*  the thread that runs them, and idle threads steal from the front of the other queues, so the oldest (and usually
+*  biggest) jobs are the ones that move between threads. The thread that calls Start doesn't get a worker: it runs
+*  jobs while it waits for a counter, and its queue also takes the jobs run from threads outside the system.
+*  Jobs can't use modules that expect to be called from the main thread (events, resources, scripts, rendering).
+*/
+
+class JobSystem {
+public:
+	~JobSystem();
+
+	void Start(unsigned numWorkers); // Without workers, the jobs run on the thread that submits them
+	void Stop();					 // Runs the queued jobs before joining the workers
+	unsigned GetNumThreads() const;	 // Workers and the thread that started the system
+
+	void Run(const char* name, JobFunction function, JobCounter* counter = nullptr);							 // 'name' has to be a literal, it's used by the profiler
+	void ParallelFor(const char* name, unsigned count, unsigned batchSize, const ParallelForFunction& function); // Splits [0, count) in batches of up to 'batchSize' and returns when all of them have run
+	void Wait(JobCounter& counter);																				 // Runs jobs until the counter is done
+
+	unsigned long long GetJobsExecuted() const; // Since the system was started
+	unsigned long long GetJobsStolen() const;
+
+private:
+	struct Job {
+		JobFunction function;
+		JobCounter* counter = nullptr;
+#if USE_PROFILER
+		Profiler::EventDescription* description = nullptr;
+#endif
+	};
+
+	struct JobQueue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	unsigned GetThreadIndex() const;
+	void Describe(Job& job, const char* name); // Sets the profiler marker of the job
+	void Push(Job&& job);
+	bool Pop(unsigned threadIndex, Job& job); // Own queue first, then steals from the others
+	void Execute(Job& job);
+	void WorkerLoop(unsigned threadIndex);
+
+private:
+	std::vector<std::unique_ptr<JobQueue>> queues; // One per thread. The thread that started the system uses the first one
+	std::vector<std::thread> workers;
+
+	std::mutex sleepMutex;
+	std::condition_variable jobQueued;
+	std::atomic<unsigned> queuedJobs {0};
+	bool stopping = false;
+
+	std::atomic<unsigned long long> jobsExecuted {0};
+	std::atomic<unsigned long long> jobsStolen {0};
+
+#if USE_PROFILER
+	std::mutex descriptionsMutex;
+	std::vector<std::pair<const char*, Profiler::EventDescription*>> descriptions; // Profiler marker of each job name
+#endif
+};
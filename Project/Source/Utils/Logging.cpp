@@ -1,29 +1,82 @@
 #include "Logging.h"
 
 #include <windows.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "Leaks.h"
 
-void Logger::Log(const char file[], int line, const char* format, ...) {
-	// Construct the string from variable arguments
-	logMessageQueueMutex.lock();
-	va_list ap;
-	va_start(ap, format);
-	vsprintf_s(tmpString, 4096, format, ap);
-	va_end(ap);
-	sprintf_s(tmpString2, 4096, "%s(%d) : %s\n", file, line, tmpString);
-	OutputDebugString(tmpString2);
-	logMessageQueue.push(tmpString2);
-	logMessageQueueMutex.unlock();
+Logger::Logger() {
+	for (unsigned i = 0; i < LOG_RING_SIZE; ++i) {
+		ring[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+Logger::~Logger() {
+	for (Record& record : ring) {
+		delete[] record.formattedMessage;
+	}
+}
+
+void Logger::SetMinSeverity(LogSeverity severity) {
+	minSeverity.store((int) severity, std::memory_order_relaxed);
+}
+
+LogSeverity Logger::GetMinSeverity() const {
+	return (LogSeverity) minSeverity.load(std::memory_order_relaxed);
+}
+
+void Logger::SetCategoryEnabled(LogCategory category, bool enabled) {
+	unsigned bit = 1u << (unsigned) category;
+	if (enabled) {
+		categoryMask.fetch_or(bit, std::memory_order_relaxed);
+	} else {
+		categoryMask.fetch_and(~bit, std::memory_order_relaxed);
+	}
+}
+
+unsigned Logger::ReadMessages(std::string& messages) {
+	unsigned numMessages = 0;
+	while (true) {
+		Record& record = ring[readPosition & (LOG_RING_SIZE - 1)];
+		if (record.sequence.load(std::memory_order_acquire) != readPosition + 1) break;
+
+		FormatRecord(record, messages);
+		numMessages += 1;
+		delete[] record.formattedMessage;
+		record.formattedMessage = nullptr;
+
+		// Free the record for the write position that wraps around to it
+		record.sequence.store(readPosition + LOG_RING_SIZE, std::memory_order_release);
+		readPosition += 1;
+	}
+
+	unsigned dropped = droppedMessages.load(std::memory_order_relaxed);
+	if (dropped != reportedDroppedMessages) {
+		snprintf(message, LOG_MESSAGE_SIZE, "Logging.cpp : %u messages were dropped because the log ring was full\n", dropped - reportedDroppedMessages);
+		messages += message;
+		reportedDroppedMessages = dropped;
+	}
+
+	return numMessages;
+}
+
+unsigned Logger::GetDroppedMessages() const {
+	return droppedMessages.load(std::memory_order_relaxed);
 }
 
 void Logger::UpdateLogString() {
-	logMessageQueueMutex.lock();
-	while (!logMessageQueue.empty()) {
-		logString += logMessageQueue.front();
-		logMessageQueue.pop();
+	std::string messages;
+	if (ReadMessages(messages) == 0 && messages.empty()) return;
+
+	OutputDebugString(messages.c_str());
+	logString += messages;
+
+	// Remove the oldest lines. Cutting a quarter of the history at a time keeps this from happening every frame
+	if (logString.size() > LOG_HISTORY_SIZE) {
+		size_t cut = logString.find('\n', logString.size() - LOG_HISTORY_SIZE * 3 / 4);
+		logString.erase(0, cut != std::string::npos ? cut + 1 : logString.size());
 	}
-	logMessageQueueMutex.unlock();
 }
 
 void Logger::LogDeltaMS(float deltaMs) {
@@ -36,4 +89,191 @@ void Logger::LogDeltaMS(float deltaMs) {
 	msLog[fpsLogIndex] = deltaMs;
 }
 
+Logger::Record* Logger::BeginRecord() {
+	unsigned position = writePosition.load(std::memory_order_relaxed);
+	while (true) {
+		Record& record = ring[position & (LOG_RING_SIZE - 1)];
+		unsigned sequence = record.sequence.load(std::memory_order_acquire);
+		int difference = (int) (sequence - position);
+		if (difference == 0) {
+			// The record is free. Claim it if no other thread did it first
+			if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) return &record;
+		} else if (difference < 0) {
+			// The record still holds a message from the previous lap, so the ring is full
+			droppedMessages.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		} else {
+			position = writePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void Logger::EndRecord(Record* record) {
+	unsigned position = record->sequence.load(std::memory_order_relaxed);
+	record->sequence.store(position + 1, std::memory_order_release);
+}
+
+void Logger::FormatRecord(const Record& record, std::string& messages) {
+	int headerSize = snprintf(message, LOG_MESSAGE_SIZE, "%s(%d) : ", record.file, record.line);
+	unsigned size = headerSize > 0 ? (unsigned) headerSize : 0;
+	if (record.formattedMessage != nullptr) {
+		size_t length = strlen(record.formattedMessage);
+		if (length > LOG_MESSAGE_SIZE - 1 - size) length = LOG_MESSAGE_SIZE - 1 - size;
+		memcpy(message + size, record.formattedMessage, length);
+		size += (unsigned) length;
+		message[size++] = '\n';
+		messages.append(message, size);
+		return;
+	}
+
+	const char* format = record.strings;
+	unsigned argumentIndex = 0;
+	while (*format != '\0' && size < LOG_MESSAGE_SIZE - 2) {
+		if (*format != '%') {
+			message[size++] = *format++;
+			continue;
+		}
+		if (format[1] == '%') {
+			message[size++] = '%';
+			format += 2;
+			continue;
+		}
+
+		// Copy the conversion specification, replacing '*' with the width or precision argument
+		unsigned specSize = 0;
+		spec[specSize++] = *format++;
+		while (*format != '\0' && strchr("diouxXeEfFgGaAcsp", *format) == nullptr && specSize < sizeof(spec) - 12) {
+			if (*format == '*' && argumentIndex < record.numArguments) {
+				specSize += snprintf(spec + specSize, sizeof(spec) - specSize, "%d", record.arguments[argumentIndex++].intValue);
+				format += 1;
+			} else {
+				spec[specSize++] = *format++;
+			}
+		}
+		if (*format == '\0') break;
+		char conversion = *format++;
+		spec[specSize++] = conversion;
+		spec[specSize] = '\0';
+
+		char* output = message + size;
+		size_t outputSize = LOG_MESSAGE_SIZE - 1 - size; // The last byte is kept for the line break
+		int written = 0;
+		if (argumentIndex >= record.numArguments) {
+			written = snprintf(output, outputSize, "%s", spec);
+		} else {
+			const Argument& argument = record.arguments[argumentIndex++];
+			if (conversion == 's' && argument.type != ArgumentType::STRING) {
+				written = snprintf(output, outputSize, "(null)");
+			} else if (specSize == 2 && argument.type == ArgumentType::STRING) {
+				// Plain %s, the most common case, is copied directly
+				const char* string = record.strings + argument.stringOffset;
+				size_t length = strlen(string);
+				if (length >= outputSize) length = outputSize - 1;
+				memcpy(output, string, length);
+				written = (int) length;
+			} else {
+				switch (argument.type) {
+				case ArgumentType::INT:
+					written = snprintf(output, outputSize, spec, argument.intValue);
+					break;
+				case ArgumentType::UNSIGNED:
+					written = snprintf(output, outputSize, spec, argument.unsignedValue);
+					break;
+				case ArgumentType::LONG:
+					written = snprintf(output, outputSize, spec, argument.longValue);
+					break;
+				case ArgumentType::UNSIGNED_LONG:
+					written = snprintf(output, outputSize, spec, argument.unsignedLongValue);
+					break;
+				case ArgumentType::LONG_LONG:
+					written = snprintf(output, outputSize, spec, argument.longLongValue);
+					break;
+				case ArgumentType::UNSIGNED_LONG_LONG:
+					written = snprintf(output, outputSize, spec, argument.unsignedLongLongValue);
+					break;
+				case ArgumentType::DOUBLE:
+					written = snprintf(output, outputSize, spec, argument.doubleValue);
+					break;
+				case ArgumentType::STRING:
+					written = snprintf(output, outputSize, spec, record.strings + argument.stringOffset);
+					break;
+				case ArgumentType::POINTER:
+					written = snprintf(output, outputSize, spec, argument.pointerValue);
+					break;
+				}
+			}
+		}
+		if (written > 0) size += (size_t) written < outputSize ? (unsigned) written : (unsigned) outputSize - 1;
+	}
+	message[size++] = '\n';
+
+	messages.append(message, size);
+}
+
+unsigned Logger::CopyString(Record& record, const char* string) {
+	unsigned offset = record.stringsSize;
+	size_t length = strlen(string);
+	size_t available = LOG_RECORD_STRING_SIZE - offset - 1; // The last byte is always kept for the null terminator
+	if (length > available) length = available;
+
+	memcpy(record.strings + offset, string, length);
+	record.strings[offset + length] = '\0';
+	record.stringsSize = offset + (unsigned) length + 1;
+	if (record.stringsSize > LOG_RECORD_STRING_SIZE - 1) record.stringsSize = LOG_RECORD_STRING_SIZE - 1;
+	return offset;
+}
+
+void Logger::AddArgument(Record& record, int value) {
+	NextArgument(record, ArgumentType::INT).intValue = value;
+}
+
+void Logger::AddArgument(Record& record, unsigned value) {
+	NextArgument(record, ArgumentType::UNSIGNED).unsignedValue = value;
+}
+
+void Logger::AddArgument(Record& record, long value) {
+	NextArgument(record, ArgumentType::LONG).longValue = value;
+}
+
+void Logger::AddArgument(Record& record, unsigned long value) {
+	NextArgument(record, ArgumentType::UNSIGNED_LONG).unsignedLongValue = value;
+}
+
+void Logger::AddArgument(Record& record, long long value) {
+	NextArgument(record, ArgumentType::LONG_LONG).longLongValue = value;
+}
+
+void Logger::AddArgument(Record& record, unsigned long long value) {
+	NextArgument(record, ArgumentType::UNSIGNED_LONG_LONG).unsignedLongLongValue = value;
+}
+
+void Logger::AddArgument(Record& record, double value) {
+	NextArgument(record, ArgumentType::DOUBLE).doubleValue = value;
+}
+
+void Logger::AddArgument(Record& record, const char* value) {
+	if (value == nullptr) {
+		NextArgument(record, ArgumentType::POINTER).pointerValue = nullptr;
+		return;
+	}
+	NextArgument(record, ArgumentType::STRING).stringOffset = CopyString(record, value);
+}
+
+void Logger::AddArgument(Record& record, const unsigned char* value) {
+	AddArgument(record, (const char*) value);
+}
+
+void Logger::AddArgument(Record& record, const void* value) {
+	NextArgument(record, ArgumentType::POINTER).pointerValue = value;
+}
+
+Logger::Argument& Logger::NextArgument(Record& record, ArgumentType type) {
+	static thread_local Argument ignoredArgument;
+	if (record.numArguments >= LOG_MAX_ARGUMENTS) return ignoredArgument;
+
+	Argument& argument = record.arguments[record.numArguments++];
+	argument.type = type;
+	return argument;
+}
+
 Logger* logger = nullptr;
@@ -3,20 +3,104 @@
 #include "Globals.h"
 
 #include <string>
-#include <mutex>
-#include <queue>
+#include <atomic>
+#include <type_traits>
+#include <stdio.h>
+#include <string.h>
 
 #define __FILENAME__ (strrchr(__FILE__, '\\') ? strrchr(__FILE__, '\\') + 1 : __FILE__)
 
-#define LOG(format, ...) logger->Log(__FILENAME__, __LINE__, format, __VA_ARGS__);
+// Messages are filtered before their arguments are evaluated
+#define LOG(format, ...) { if (logger->IsEnabled(LogCategory::GENERAL, LogSeverity::INFO)) logger->Log(LogCategory::GENERAL, LogSeverity::INFO, __FILENAME__, __LINE__, format, __VA_ARGS__); }
+#define LOG_CATEGORY(category, severity, format, ...) { if (logger->IsEnabled(category, severity)) logger->Log(category, severity, __FILENAME__, __LINE__, format, __VA_ARGS__); }
 
 #define FPS_LOG_SIZE 100
 
+#define LOG_RING_SIZE 4096				// Number of messages that can wait to be formatted. Must be a power of 2. Messages logged while the ring is full are dropped
+#define LOG_MAX_ARGUMENTS 16			// Arguments after the format string. Extra arguments are ignored
+#define LOG_RECORD_STRING_SIZE 512		// Space for the format string and the string arguments of a message. Messages whose strings don't fit are formatted by the producer
+#define LOG_MESSAGE_SIZE 4096			// Maximum length of a formatted message
+#define LOG_HISTORY_SIZE (1024 * 1024) // Maximum length of logString. The oldest lines are removed when it's exceeded
+
+enum class LogCategory {
+	GENERAL,
+	RESOURCES,
+	RENDERING,
+	AUDIO,
+	SCRIPTING
+};
+
+enum class LogSeverity {
+	VERBOSE,
+	INFO,
+	WARNING,
+	CRITICAL
+};
+
+/* Messages are written to a lock-free ring of fixed-size records, and formatted when they are read on the main thread.
+*  Logging copies the format string and the arguments (strings included) to a free record, so it doesn't take a lock
+*  or allocate. The ring is a bounded multiple producer queue: each record has a sequence number that tells whether
+*  it's free or ready to be read. Messages whose strings don't fit in a record (shader info logs, for example) are
+*  formatted by the producer into an allocated buffer that the record points to, and that the reader frees.
+*/
+
 class Logger {
 public:
-	void Log(const char file[], int line, const char* format, ...);
+	enum class ArgumentType {
+		INT,
+		UNSIGNED,
+		LONG,
+		UNSIGNED_LONG,
+		LONG_LONG,
+		UNSIGNED_LONG_LONG,
+		DOUBLE,
+		STRING, // Offset of the copy in the record strings
+		POINTER
+	};
+
+	struct Argument {
+		ArgumentType type = ArgumentType::INT;
+		union {
+			int intValue;
+			unsigned unsignedValue;
+			long longValue;
+			unsigned long unsignedLongValue;
+			long long longLongValue;
+			unsigned long long unsignedLongLongValue;
+			double doubleValue;
+			unsigned stringOffset;
+			const void* pointerValue;
+		};
+	};
+
+	struct Record {
+		std::atomic<unsigned> sequence {0}; // Equal to the write position when free, and to the write position + 1 when ready to be read
+		LogCategory category = LogCategory::GENERAL;
+		LogSeverity severity = LogSeverity::INFO;
+		const char* file = nullptr; // __FILENAME__ is always a string literal
+		int line = 0;
+		unsigned numArguments = 0;
+		unsigned stringsSize = 0;
+		Argument arguments[LOG_MAX_ARGUMENTS];
+		char strings[LOG_RECORD_STRING_SIZE]; // The format string is stored first
+		char* formattedMessage = nullptr;	  // Set instead of the strings and arguments when they don't fit in the record
+	};
+
+public:
+	Logger();
+	~Logger();
+
+	bool IsEnabled(LogCategory category, LogSeverity severity) const;
+	void SetMinSeverity(LogSeverity severity); // Messages with a lower severity are ignored
+	LogSeverity GetMinSeverity() const;
+	void SetCategoryEnabled(LogCategory category, bool enabled);
+
+	template<typename... Args> bool Log(LogCategory category, LogSeverity severity, const char file[], int line, const char* format, Args... args); // Returns false if the message was dropped
+	unsigned ReadMessages(std::string& messages); // Formats the pending messages and appends them to 'messages'. Returns the number of messages. Only call it from one thread at a time
+	unsigned GetDroppedMessages() const;
+
 	void LogDeltaMS(float deltaMs);
-	void UpdateLogString();
+	void UpdateLogString(); // Reads the pending messages into logString and the debugger output. Called every frame
 
 public:
 	std::string logString = "";
@@ -25,11 +109,80 @@ public:
 	float msLog[FPS_LOG_SIZE] = {0};
 
 private:
-	std::mutex logMessageQueueMutex;
-	std::queue<std::string> logMessageQueue;
+	Record* BeginRecord(); // Returns nullptr if the ring is full
+	void EndRecord(Record* record);
+	void FormatRecord(const Record& record, std::string& messages);
+
+	unsigned CopyString(Record& record, const char* string);
+	template<typename T> static size_t StringSize(T value); // Bytes that the argument takes in the record strings
+	void AddArgument(Record& record, int value);
+	void AddArgument(Record& record, unsigned value);
+	void AddArgument(Record& record, long value);
+	void AddArgument(Record& record, unsigned long value);
+	void AddArgument(Record& record, long long value);
+	void AddArgument(Record& record, unsigned long long value);
+	void AddArgument(Record& record, double value);
+	void AddArgument(Record& record, const char* value);
+	void AddArgument(Record& record, const unsigned char* value); // OpenGL strings
+	void AddArgument(Record& record, const void* value);
+	Argument& NextArgument(Record& record, ArgumentType type);
+
+private:
+	std::atomic<int> minSeverity {(int) LogSeverity::VERBOSE};
+	std::atomic<unsigned> categoryMask {~0u};
+
+	Record ring[LOG_RING_SIZE];
+	std::atomic<unsigned> writePosition {0};
+	unsigned readPosition = 0;
+	std::atomic<unsigned> droppedMessages {0};
+	unsigned reportedDroppedMessages = 0;
 
-	char tmpString[4096] = {0};
-	char tmpString2[4096] = {0};
+	char message[LOG_MESSAGE_SIZE] = {0};
+	char spec[32] = {0};
 };
 
-extern Logger* logger;
\ No newline at end of file
+inline bool Logger::IsEnabled(LogCategory category, LogSeverity severity) const {
+	return (int) severity >= minSeverity.load(std::memory_order_relaxed) && (categoryMask.load(std::memory_order_relaxed) & (1u << (unsigned) category)) != 0;
+}
+
+template<typename... Args>
+inline bool Logger::Log(LogCategory category, LogSeverity severity, const char file[], int line, const char* format, Args... args) {
+	Record* record = BeginRecord();
+	if (record == nullptr) return false;
+
+	record->category = category;
+	record->severity = severity;
+	record->file = file;
+	record->line = line;
+	record->numArguments = 0;
+	record->stringsSize = 0;
+	record->formattedMessage = nullptr;
+	if (format == nullptr) format = "";
+
+	if (StringSize(format) + (StringSize(args) + ... + 0) <= LOG_RECORD_STRING_SIZE) {
+		CopyString(*record, format);
+		(AddArgument(*record, args), ...);
+	} else {
+		int length = snprintf(nullptr, 0, format, args...);
+		size_t size = length > 0 ? (size_t) length + 1 : 1;
+		if (size > LOG_MESSAGE_SIZE) size = LOG_MESSAGE_SIZE;
+		record->formattedMessage = new char[size];
+		snprintf(record->formattedMessage, size, format, args...);
+	}
+
+	EndRecord(record);
+	return true;
+}
+
+template<typename T>
+inline size_t Logger::StringSize(T value) {
+	if constexpr (std::is_convertible_v<T, const char*>) {
+		return value != nullptr ? strlen(value) + 1 : 0;
+	} else if constexpr (std::is_convertible_v<T, const unsigned char*>) {
+		return value != nullptr ? strlen((const char*) value) + 1 : 0;
+	} else {
+		return 0;
+	}
+}
+
+extern Logger* logger;
@@ -4,6 +4,7 @@
 #include "Application.h"
 #include "GameObject.h"
 #include "Modules/ModuleTime.h"
+#include "Modules/ModulePhysics.h"
 #include "Components/ComponentTransform.h"
 #include "Math/float4x4.h"
 #include "Math/float3x3.h"
@@ -19,6 +20,9 @@ MotionState::~MotionState() {
 }
 
 void MotionState::getWorldTransform(btTransform& centerOfMassWorldTrans) const {
+	// Kinematic transforms are copied to the bodies before the world is stepped on the worker
+	if (App->physics->IsSteppingAsync()) return;
+
 	float3 position = collider->GetOwner().GetComponent<ComponentTransform>()->GetGlobalPosition();
 	Quat rotation = collider->GetOwner().GetComponent<ComponentTransform>()->GetGlobalRotation();
 
@@ -29,20 +33,45 @@ void MotionState::getWorldTransform(btTransform& centerOfMassWorldTrans) const {
 ///Bullet only calls the update of worldtransform for active objects
 void MotionState::setWorldTransform(const btTransform& centerOfMassWorldTrans) {
 	if (App->time->IsGameRunning()) {
-		btTransform transform = centerOfMassWorldTrans * (freezeRotation? btTransform::getIdentity(): massCenterOffset);
-		float3 parentScale = collider->GetOwner().GetParent()->GetComponent<ComponentTransform>()->GetGlobalScale();
-		float3 parentPosition = collider->GetOwner().GetParent()->GetComponent<ComponentTransform>()->GetGlobalPosition();
-		Quat parentRotation = collider->GetOwner().GetParent()->GetComponent<ComponentTransform>()->GetGlobalRotation().Inverted();
-
-		// Set Local Position
-		float3 position = (float3) (transform.getOrigin() +  (freezeRotation ? massCenterOffset.getOrigin() : btVector3(0, 0, 0)));
-		collider->GetOwner().GetComponent<ComponentTransform>()->SetPosition(parentRotation.Transform(((position).Div(parentScale) - parentPosition)));
-
-		// Set Local Rotation
-		if (!freezeRotation) {
-			btQuaternion rotation;
-			transform.getBasis().getRotation(rotation);
-			collider->GetOwner().GetComponent<ComponentTransform>()->SetRotation(parentRotation * (Quat) rotation);
+		currentTransform = centerOfMassWorldTrans;
+		if (!hasTransform) {
+			previousTransform = centerOfMassWorldTrans;
+			hasTransform = true;
 		}
+		moving = true;
+	}
+}
+
+void MotionState::BeginFixedStep() {
+	previousTransform = currentTransform;
+}
+
+void MotionState::ApplyInterpolatedTransform(float alpha) {
+	if (!moving) return;
+
+	btTransform transform;
+	transform.setOrigin(previousTransform.getOrigin().lerp(currentTransform.getOrigin(), alpha));
+	transform.setRotation(previousTransform.getRotation().slerp(currentTransform.getRotation(), alpha));
+	SetOwnerTransform(transform);
+
+	// Bodies that stopped don't need to be placed again
+	if (previousTransform == currentTransform) moving = false;
+}
+
+void MotionState::SetOwnerTransform(const btTransform& centerOfMassWorldTrans) {
+	btTransform transform = centerOfMassWorldTrans * (freezeRotation? btTransform::getIdentity(): massCenterOffset);
+	float3 parentScale = collider->GetOwner().GetParent()->GetComponent<ComponentTransform>()->GetGlobalScale();
+	float3 parentPosition = collider->GetOwner().GetParent()->GetComponent<ComponentTransform>()->GetGlobalPosition();
+	Quat parentRotation = collider->GetOwner().GetParent()->GetComponent<ComponentTransform>()->GetGlobalRotation().Inverted();
+
+	// Set Local Position
+	float3 position = (float3) (transform.getOrigin() +  (freezeRotation ? massCenterOffset.getOrigin() : btVector3(0, 0, 0)));
+	collider->GetOwner().GetComponent<ComponentTransform>()->SetPosition(parentRotation.Transform(((position).Div(parentScale) - parentPosition)));
+
+	// Set Local Rotation
+	if (!freezeRotation) {
+		btQuaternion rotation;
+		transform.getBasis().getRotation(rotation);
+		collider->GetOwner().GetComponent<ComponentTransform>()->SetRotation(parentRotation * (Quat) rotation);
 	}
 }
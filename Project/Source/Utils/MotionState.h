@@ -6,6 +6,10 @@
 
 #include "Math/float3.h"
 
+/* Synchronizes a rigidbody with the transform of its GameObject. Bullet writes the transform of dynamic bodies after each fixed step,
+*  and the GameObject is placed between the last two of them (see ModuleTime::GetFixedStepAlpha), so that the rendered motion is smooth
+*  when the framerate and the fixed step rate differ.
+*/
 class MotionState : public btMotionState {
 public:
 	MotionState(Component* componentCollider, float3 centerOffset, bool freezeRot);
@@ -14,10 +18,21 @@ public:
 	void getWorldTransform(btTransform& centerOfMassWorldTrans) const override;
 	void setWorldTransform(const btTransform& centerOfMassWorldTrans) override;
 
+	void BeginFixedStep(); // The current transform becomes the previous one
+	void ApplyInterpolatedTransform(float alpha); // Sets the transform of the GameObject between the previous (0) and the current (1) transforms
+
 public:
 	bool freezeRotation = false;	// This boolean is set from the boolean with the same name in the attached ComponentCollider. Defines if the GameObject will rotate due to a collision.
 
+private:
+	void SetOwnerTransform(const btTransform& centerOfMassWorldTrans);
+
 private:
 	Component* collider = nullptr;
 	btTransform massCenterOffset = btTransform::getIdentity();
+
+	btTransform previousTransform = btTransform::getIdentity();
+	btTransform currentTransform = btTransform::getIdentity();
+	bool hasTransform = false; // True after the first transform from Bullet
+	bool moving = false;	   // True while the GameObject doesn't have the current transform
 };
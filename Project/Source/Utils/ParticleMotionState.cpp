@@ -1,5 +1,8 @@
 #include "ParticleMotionState.h"
 
+#include "Application.h"
+#include "Modules/ModulePhysics.h"
+
 #include "Math/float3x3.h"
 
 ParticleMotionState::ParticleMotionState(ComponentParticleSystem::Particle* p)
@@ -10,12 +13,11 @@ ParticleMotionState::~ParticleMotionState() {
 }
 
 void ParticleMotionState::getWorldTransform(btTransform& centerOfMassWorldTrans) const {
-	float4x4 particleModel = float4x4::FromTRS(particle->position, particle->rotation, float3::one);
-	if (particle->emitter->GetIsAttachEmitter()) {
-		float4x4 emitterModel;
-		particle->emitter->ObtainEmitterGlobalMatrix(emitterModel);
-		particleModel = emitterModel * particleModel;
-	}
+	// Kinematic transforms are copied to the bodies before the world is stepped on the worker
+	if (App->physics->IsSteppingAsync()) return;
+
+	float4x4 particleModel;
+	particle->emitter->ObtainParticleGlobalMatrix(particle, particleModel);
 	float3 pos = particleModel.TranslatePart();
 	Quat rot = particleModel.RotatePart().ToQuat();
 	centerOfMassWorldTrans = btTransform(btQuaternion(rot.x, rot.y, rot.z, rot.w), btVector3(pos.x, pos.y, pos.z));
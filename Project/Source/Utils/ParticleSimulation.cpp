@@ -0,0 +1,290 @@
+#include "ParticleSimulation.h"
+
+#include "Globals.h"
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "Utils/Leaks.h"
+
+#define PARTICLE_FLOAT_ARRAYS 20
+
+static unsigned RoundUpToSimdWidth(unsigned value) {
+	return (value + PARTICLE_SIMD_WIDTH - 1) & ~(PARTICLE_SIMD_WIDTH - 1);
+}
+
+ParticleSimulation::~ParticleSimulation() {
+	Deallocate();
+}
+
+void ParticleSimulation::Allocate(unsigned capacity_) {
+	Deallocate();
+
+	capacity = RoundUpToSimdWidth(capacity_);
+	if (capacity == 0) return;
+
+	// We allocate in the same block to mantain locality. Every array starts 16-byte aligned
+	size_t floatArraySize = capacity * sizeof(float);
+	block = _mm_malloc(floatArraySize * PARTICLE_FLOAT_ARRAYS + capacity * sizeof(void*), 16);
+
+	float* floatArrays[PARTICLE_FLOAT_ARRAYS];
+	for (unsigned i = 0; i < PARTICLE_FLOAT_ARRAYS; ++i) {
+		floatArrays[i] = (float*) ((char*) block + floatArraySize * i);
+	}
+
+	positionX = floatArrays[0];
+	positionY = floatArrays[1];
+	positionZ = floatArrays[2];
+	directionX = floatArrays[3];
+	directionY = floatArrays[4];
+	directionZ = floatArrays[5];
+	speed = floatArrays[6];
+	life = floatArrays[7];
+	initialLife = floatArrays[8];
+	scale = floatArrays[9];
+	rotation = floatArrays[10];
+	frame = floatArrays[11];
+	animationSpeed = floatArrays[12];
+	rotationFactor = floatArrays[13];
+	scaleFactor = floatArrays[14];
+	speedMultiplier = floatArrays[15];
+	gravityFactor = floatArrays[16];
+	velocityX = floatArrays[17];
+	velocityY = floatArrays[18];
+	velocityZ = floatArrays[19];
+	cold = (void**) ((char*) block + floatArraySize * PARTICLE_FLOAT_ARRAYS);
+
+	// Padding lanes are also processed by the batched updates, so they must hold valid numbers
+	memset(block, 0, floatArraySize * PARTICLE_FLOAT_ARRAYS + capacity * sizeof(void*));
+}
+
+void ParticleSimulation::Deallocate() {
+	if (block != nullptr) {
+		_mm_free(block);
+		block = nullptr;
+	}
+
+	positionX = positionY = positionZ = nullptr;
+	directionX = directionY = directionZ = nullptr;
+	speed = life = initialLife = scale = rotation = frame = animationSpeed = nullptr;
+	rotationFactor = scaleFactor = speedMultiplier = gravityFactor = nullptr;
+	velocityX = velocityY = velocityZ = nullptr;
+	cold = nullptr;
+
+	capacity = 0;
+	count = 0;
+}
+
+void ParticleSimulation::Clear() {
+	count = 0;
+}
+
+unsigned ParticleSimulation::Add() {
+	if (count == capacity) return PARTICLE_INVALID_INDEX;
+
+	unsigned index = count++;
+	positionX[index] = positionY[index] = positionZ[index] = 0.0f;
+	directionX[index] = directionY[index] = directionZ[index] = 0.0f;
+	speed[index] = 0.0f;
+	life[index] = 0.0f;
+	initialLife[index] = 0.0f;
+	scale[index] = 0.1f;
+	rotation[index] = 0.0f;
+	frame[index] = 0.0f;
+	animationSpeed[index] = 1.0f;
+	rotationFactor[index] = 0.0f;
+	scaleFactor[index] = 0.0f;
+	speedMultiplier[index] = 0.0f;
+	gravityFactor[index] = 0.0f;
+	velocityX[index] = velocityY[index] = velocityZ[index] = 0.0f;
+	cold[index] = nullptr;
+	return index;
+}
+
+unsigned ParticleSimulation::Remove(unsigned index) {
+	assert(index < count); // ERROR: The particle is not alive
+
+	unsigned last = --count;
+	if (index == last) return PARTICLE_INVALID_INDEX;
+
+	float* floatArrays = (float*) block;
+	for (unsigned i = 0; i < PARTICLE_FLOAT_ARRAYS; ++i) {
+		float* values = floatArrays + capacity * i;
+		values[index] = values[last];
+	}
+	cold[index] = cold[last];
+	return last;
+}
+
+unsigned ParticleSimulation::Count() const {
+	return count;
+}
+
+unsigned ParticleSimulation::Capacity() const {
+	return capacity;
+}
+
+void ParticleSimulation::UpdateLife(float deltaTime) {
+	__m128 dt = _mm_set1_ps(deltaTime);
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		_mm_store_ps(life + i, _mm_sub_ps(_mm_load_ps(life + i), dt));
+	}
+}
+
+void ParticleSimulation::UpdateRotation(float deltaTime) {
+	__m128 dt = _mm_set1_ps(deltaTime);
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		__m128 r = _mm_add_ps(_mm_load_ps(rotation + i), _mm_mul_ps(_mm_load_ps(rotationFactor + i), dt));
+		_mm_store_ps(rotation + i, r);
+	}
+}
+
+void ParticleSimulation::UpdateScale(float deltaTime) {
+	__m128 dt = _mm_set1_ps(deltaTime);
+	__m128 zero = _mm_setzero_ps();
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		__m128 s = _mm_add_ps(_mm_load_ps(scale + i), _mm_mul_ps(_mm_load_ps(scaleFactor + i), dt));
+		_mm_store_ps(scale + i, _mm_max_ps(s, zero));
+	}
+}
+
+void ParticleSimulation::SetScale(const float* values) {
+	__m128 zero = _mm_setzero_ps();
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		_mm_store_ps(scale + i, _mm_max_ps(_mm_load_ps(values + i), zero));
+	}
+}
+
+void ParticleSimulation::UpdatePosition(float deltaTime) {
+	__m128 dt = _mm_set1_ps(deltaTime);
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		__m128 distance = _mm_mul_ps(_mm_load_ps(speed + i), dt);
+		_mm_store_ps(positionX + i, _mm_add_ps(_mm_load_ps(positionX + i), _mm_mul_ps(_mm_load_ps(directionX + i), distance)));
+		_mm_store_ps(positionY + i, _mm_add_ps(_mm_load_ps(positionY + i), _mm_mul_ps(_mm_load_ps(directionY + i), distance)));
+		_mm_store_ps(positionZ + i, _mm_add_ps(_mm_load_ps(positionZ + i), _mm_mul_ps(_mm_load_ps(directionZ + i), distance)));
+	}
+}
+
+void ParticleSimulation::UpdatePositionReverse(float deltaTime) {
+	UpdatePosition(-deltaTime);
+}
+
+void ParticleSimulation::UpdatePositionGravity(float3 gravityAxis, float deltaTime) {
+	__m128 dt = _mm_set1_ps(deltaTime);
+	__m128 halfDt2 = _mm_set1_ps(0.5f * deltaTime * deltaTime);
+	__m128 axisX = _mm_set1_ps(gravityAxis.x);
+	__m128 axisY = _mm_set1_ps(gravityAxis.y);
+	__m128 axisZ = _mm_set1_ps(gravityAxis.z);
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		__m128 distance = _mm_mul_ps(_mm_load_ps(speed + i), dt);
+		__m128 g = _mm_load_ps(gravityFactor + i);
+		__m128 gX = _mm_mul_ps(axisX, g);
+		__m128 gY = _mm_mul_ps(axisY, g);
+		__m128 gZ = _mm_mul_ps(axisZ, g);
+
+		__m128 dX = _mm_load_ps(directionX + i);
+		__m128 dY = _mm_load_ps(directionY + i);
+		__m128 dZ = _mm_load_ps(directionZ + i);
+
+		// position += direction * speed * dt + 0.5 * gravity * dt^2
+		_mm_store_ps(positionX + i, _mm_add_ps(_mm_load_ps(positionX + i), _mm_add_ps(_mm_mul_ps(dX, distance), _mm_mul_ps(gX, halfDt2))));
+		_mm_store_ps(positionY + i, _mm_add_ps(_mm_load_ps(positionY + i), _mm_add_ps(_mm_mul_ps(dY, distance), _mm_mul_ps(gY, halfDt2))));
+		_mm_store_ps(positionZ + i, _mm_add_ps(_mm_load_ps(positionZ + i), _mm_add_ps(_mm_mul_ps(dZ, distance), _mm_mul_ps(gZ, halfDt2))));
+
+		// direction += gravity * dt
+		_mm_store_ps(directionX + i, _mm_add_ps(dX, _mm_mul_ps(gX, dt)));
+		_mm_store_ps(directionY + i, _mm_add_ps(dY, _mm_mul_ps(gY, dt)));
+		_mm_store_ps(directionZ + i, _mm_add_ps(dZ, _mm_mul_ps(gZ, dt)));
+	}
+}
+
+void ParticleSimulation::UpdatePositionVelocity(const float3x3& velocitySpace, float deltaTime) {
+	__m128 dt = _mm_set1_ps(deltaTime);
+	__m128 m[3][3];
+	for (int row = 0; row < 3; ++row) {
+		for (int col = 0; col < 3; ++col) {
+			m[row][col] = _mm_set1_ps(velocitySpace[row][col]);
+		}
+	}
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		__m128 vX = _mm_load_ps(velocityX + i);
+		__m128 vY = _mm_load_ps(velocityY + i);
+		__m128 vZ = _mm_load_ps(velocityZ + i);
+
+		// Linear velocity in the velocity space
+		__m128 lX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][0], vX), _mm_mul_ps(m[0][1], vY)), _mm_mul_ps(m[0][2], vZ));
+		__m128 lY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[1][0], vX), _mm_mul_ps(m[1][1], vY)), _mm_mul_ps(m[1][2], vZ));
+		__m128 lZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[2][0], vX), _mm_mul_ps(m[2][1], vY)), _mm_mul_ps(m[2][2], vZ));
+
+		// position += (direction + linear) * speed * speedMultiplier * dt
+		__m128 distance = _mm_mul_ps(_mm_mul_ps(_mm_load_ps(speed + i), _mm_load_ps(speedMultiplier + i)), dt);
+		_mm_store_ps(positionX + i, _mm_add_ps(_mm_load_ps(positionX + i), _mm_mul_ps(_mm_add_ps(_mm_load_ps(directionX + i), lX), distance)));
+		_mm_store_ps(positionY + i, _mm_add_ps(_mm_load_ps(positionY + i), _mm_mul_ps(_mm_add_ps(_mm_load_ps(directionY + i), lY), distance)));
+		_mm_store_ps(positionZ + i, _mm_add_ps(_mm_load_ps(positionZ + i), _mm_mul_ps(_mm_add_ps(_mm_load_ps(directionZ + i), lZ), distance)));
+	}
+}
+
+void ParticleSimulation::UpdateFrames(float deltaTime) {
+	__m128 dt = _mm_set1_ps(deltaTime);
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		__m128 f = _mm_add_ps(_mm_load_ps(frame + i), _mm_mul_ps(_mm_load_ps(animationSpeed + i), dt));
+		_mm_store_ps(frame + i, f);
+	}
+}
+
+void ParticleSimulation::SampleCurve(const float* curveTable, float* values) const {
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 zero = _mm_setzero_ps();
+	__m128 samples = _mm_set1_ps((float) PARTICLE_CURVE_SAMPLES);
+	__m128i lastSample = _mm_set1_epi32(PARTICLE_CURVE_SAMPLES - 1);
+	alignas(16) int sampleIndices[PARTICLE_SIMD_WIDTH];
+	alignas(16) float from[PARTICLE_SIMD_WIDTH];
+	alignas(16) float to[PARTICLE_SIMD_WIDTH];
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		// Normalized life. Life decreases from the initial life to 0. _mm_max_ps returns 0 for NaN
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(_mm_load_ps(life + i), _mm_load_ps(initialLife + i)));
+		t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+		__m128 x = _mm_mul_ps(t, samples);
+		__m128i index = _mm_cvttps_epi32(x);
+		__m128i greater = _mm_cmpgt_epi32(index, lastSample);
+		index = _mm_or_si128(_mm_and_si128(greater, lastSample), _mm_andnot_si128(greater, index));
+		__m128 fraction = _mm_sub_ps(x, _mm_cvtepi32_ps(index));
+
+		// SSE has no gather, so the table is read per lane
+		_mm_store_si128((__m128i*) sampleIndices, index);
+		for (unsigned lane = 0; lane < PARTICLE_SIMD_WIDTH; ++lane) {
+			from[lane] = curveTable[sampleIndices[lane]];
+			to[lane] = curveTable[sampleIndices[lane] + 1];
+		}
+
+		__m128 a = _mm_load_ps(from);
+		__m128 b = _mm_load_ps(to);
+		_mm_store_ps(values + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction)));
+	}
+}
+
+void ParticleSimulation::Fill(float* values, float value) const {
+	__m128 v = _mm_set1_ps(value);
+	for (unsigned i = 0; i < count; i += PARTICLE_SIMD_WIDTH) {
+		_mm_store_ps(values + i, v);
+	}
+}
+
+void ParticleSimulation::FindDead(std::vector<unsigned>& deadIndices) const {
+	__m128 zero = _mm_setzero_ps();
+	unsigned lastBlock = count & ~(PARTICLE_SIMD_WIDTH - 1);
+	for (int i = (int) lastBlock; i >= 0; i -= PARTICLE_SIMD_WIDTH) {
+		if ((unsigned) i >= count) continue;
+
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(_mm_load_ps(life + i), zero));
+		if (mask == 0) continue;
+
+		for (int lane = PARTICLE_SIMD_WIDTH - 1; lane >= 0; --lane) {
+			unsigned index = i + lane;
+			if ((mask & (1 << lane)) != 0 && index < count) {
+				deadIndices.push_back(index);
+			}
+		}
+	}
+}
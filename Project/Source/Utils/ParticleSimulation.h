@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Math/float3.h"
+#include "Math/float3x3.h"
+
+#include <vector>
+
+#define PARTICLE_SIMD_WIDTH 4		 // Floats processed per SSE instruction. Arrays are aligned and padded to this width
+#define PARTICLE_CURVE_SAMPLES 64	 // Samples of the over-lifetime curve tables
+#define PARTICLE_INVALID_INDEX ((unsigned) -1)
+
+/* Hot data of the particles of an emitter, stored as a struct of arrays.
+*  Alive particles are always the first Count() entries of every array: removing one moves
+*  the last particle into its slot. The batched updates work on 4 particles at a time with SSE.
+*  Data that only some particles use (trails, lights, rigid bodies) lives outside, in 'cold'.
+*/
+
+class ParticleSimulation {
+public:
+	~ParticleSimulation();
+
+	void Allocate(unsigned capacity);
+	void Deallocate();
+	void Clear();
+
+	unsigned Add();					  // Returns PARTICLE_INVALID_INDEX if the simulation is full. The new particle is reset to the default values
+	unsigned Remove(unsigned index); // Moves the last particle into 'index'. Returns the previous index of the moved particle, or PARTICLE_INVALID_INDEX if none was moved
+
+	unsigned Count() const;
+	unsigned Capacity() const;
+
+	// Batched updates of every alive particle
+	void UpdateLife(float deltaTime);
+	void UpdateRotation(float deltaTime);				  // Rotation speed is read from 'rotationFactor'
+	void UpdateScale(float deltaTime);					  // Scale speed is read from 'scaleFactor'
+	void SetScale(const float* values);				  // Used by curves, where the scale is the curve value. Negative scales are clamped to 0
+	void UpdatePosition(float deltaTime);				  // Moves along the direction
+	void UpdatePositionReverse(float deltaTime);		  // Moves against the direction
+	void UpdatePositionGravity(float3 gravityAxis, float deltaTime); // Gravity is 'gravityAxis' * 'gravityFactor'. Also bends the direction
+	void UpdatePositionVelocity(const float3x3& velocitySpace, float deltaTime); // Adds the linear velocity, rotated by 'velocitySpace', and scales by 'speedMultiplier'
+	void UpdateFrames(float deltaTime);
+
+	// Over-lifetime values
+	void SampleCurve(const float* curveTable, float* values) const; // 'curveTable' has PARTICLE_CURVE_SAMPLES + 1 samples over the normalized life
+	void Fill(float* values, float value) const;
+	void FindDead(std::vector<unsigned>& deadIndices) const; // Appends the particles with a negative life, from last to first
+
+public:
+	// Hot data
+	float* positionX = nullptr;
+	float* positionY = nullptr;
+	float* positionZ = nullptr;
+	float* directionX = nullptr;
+	float* directionY = nullptr;
+	float* directionZ = nullptr;
+	float* speed = nullptr;
+	float* life = nullptr;
+	float* initialLife = nullptr;
+	float* scale = nullptr;		// Particles are always scaled uniformly
+	float* rotation = nullptr;	// Radians around the billboard normal
+	float* frame = nullptr;
+	float* animationSpeed = nullptr;
+
+	// Over-lifetime factors. Set per particle on spawn, or filled every frame from curves and constants
+	float* rotationFactor = nullptr;
+	float* scaleFactor = nullptr;
+	float* speedMultiplier = nullptr;
+	float* gravityFactor = nullptr;
+	float* velocityX = nullptr;
+	float* velocityY = nullptr;
+	float* velocityZ = nullptr;
+
+	// Cold data of each particle. nullptr for particles that don't need it
+	void** cold = nullptr;
+
+private:
+	unsigned capacity = 0;	 // Max number of particles, rounded up to PARTICLE_SIMD_WIDTH
+	unsigned count = 0;		 // Current number of particles
+	void* block = nullptr;	 // All the arrays are allocated in the same block
+};
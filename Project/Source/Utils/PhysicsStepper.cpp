@@ -0,0 +1,94 @@
+#include "PhysicsStepper.h"
+
+#include "Utils/PerformanceTimer.h"
+
+#include "btBulletDynamicsCommon.h"
+
+#include "Utils/Leaks.h"
+
+PhysicsStepper::~PhysicsStepper() {
+	Stop();
+}
+
+void PhysicsStepper::Start() {
+	Stop();
+
+	stopping = false;
+	worker = std::thread(&PhysicsStepper::WorkerLoop, this);
+}
+
+void PhysicsStepper::Stop() {
+	if (!worker.joinable()) return;
+
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	stepStarted.notify_one();
+	worker.join();
+}
+
+void PhysicsStepper::StepAsync(btDiscreteDynamicsWorld* world_, unsigned numSteps_, float timeStep_) {
+	Wait();
+	if (numSteps_ == 0) return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		world = world_;
+		numSteps = numSteps_;
+		timeStep = timeStep_;
+		stepping = true;
+	}
+	stepStarted.notify_one();
+}
+
+void PhysicsStepper::Wait() {
+	if (!stepping) return;
+
+	PerformanceTimer timer;
+	timer.Start();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	stepFinished.wait(lock, [this] { return !stepping; });
+
+	lastWaitTime = timer.Stop();
+}
+
+bool PhysicsStepper::IsStepping() const {
+	return stepping;
+}
+
+unsigned long long PhysicsStepper::GetLastStepTime() const {
+	return lastStepTime;
+}
+
+unsigned long long PhysicsStepper::GetLastWaitTime() const {
+	return lastWaitTime;
+}
+
+void PhysicsStepper::WorkerLoop() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		stepStarted.wait(lock, [this] { return stopping || (stepping && numSteps > 0); });
+		if (stopping) return;
+
+		btDiscreteDynamicsWorld* stepWorld = world;
+		unsigned stepCount = numSteps;
+		float stepTime = timeStep;
+		numSteps = 0;
+		lock.unlock();
+
+		PerformanceTimer timer;
+		timer.Start();
+		for (unsigned i = 0; i < stepCount; ++i) {
+			stepWorld->stepSimulation(stepTime, 0);
+		}
+		unsigned long long time = timer.Stop();
+
+		lock.lock();
+		lastStepTime = time;
+		stepping = false;
+		stepFinished.notify_all();
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+class btDiscreteDynamicsWorld;
+
+/* Steps a physics world on a worker thread, so that the main thread can keep working until it needs the results.
+*  While a step is in flight the world belongs to the worker: the main thread has to call Wait before touching it.
+*/
+
+class PhysicsStepper {
+public:
+	~PhysicsStepper();
+
+	void Start();
+	void Stop();
+
+	void StepAsync(btDiscreteDynamicsWorld* world, unsigned numSteps, float timeStep); // Returns immediately. Each step advances the world timeStep seconds, without substeps
+	void Wait();																	   // Blocks until the steps in flight finish
+	bool IsStepping() const;
+
+	unsigned long long GetLastStepTime() const; // Microseconds the worker spent in the last StepAsync
+	unsigned long long GetLastWaitTime() const; // Microseconds the main thread was blocked in the last Wait that found a step in flight
+
+private:
+	void WorkerLoop();
+
+private:
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable stepStarted;
+	std::condition_variable stepFinished;
+	bool stopping = false;
+
+	btDiscreteDynamicsWorld* world = nullptr;
+	unsigned numSteps = 0;
+	float timeStep = 0.0f;
+	std::atomic<bool> stepping {false};
+
+	unsigned long long lastStepTime = 0;
+	unsigned long long lastWaitTime = 0;
+};
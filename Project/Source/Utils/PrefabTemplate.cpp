@@ -0,0 +1,167 @@
+#include "PrefabTemplate.h"
+
+#include "GameObject.h"
+#include "Scene.h"
+#include "FileSystem/ModelImporter.h"
+#include "Utils/UID.h"
+#include "Utils/Logging.h"
+
+#include <unordered_map>
+
+#include "Utils/Leaks.h"
+
+#define JSON_TAG_NAME "Name"
+#define JSON_TAG_ACTIVE "Active"
+#define JSON_TAG_MASK "Mask"
+#define JSON_TAG_TYPE "Type"
+#define JSON_TAG_COMPONENTS "Components"
+#define JSON_TAG_CHILDREN "Children"
+#define JSON_TAG_ROOT_BONE_NAME "RootBoneName"
+
+// --- Reading JSON values with the same defaults as JsonValue --- //
+
+static rapidjson::Value& GetMember(rapidjson::Value& value, const char* key) {
+	static rapidjson::Value nullValue;
+	if (!value.IsObject()) return nullValue;
+
+	rapidjson::Value::MemberIterator it = value.FindMember(key);
+	return it != value.MemberEnd() ? it->value : nullValue;
+}
+
+static unsigned GetArraySize(const rapidjson::Value& value) {
+	return value.IsArray() ? value.Size() : 0;
+}
+
+static bool GetBool(const rapidjson::Value& value) {
+	return value.IsBool() ? value.GetBool() : false;
+}
+
+static int GetInt(const rapidjson::Value& value) {
+	return value.IsInt() ? value.GetInt() : 0;
+}
+
+static const char* GetString(const rapidjson::Value& value) {
+	return value.IsString() ? value.GetString() : "";
+}
+
+// --- PrefabTemplate --- //
+
+void PrefabTemplate::Compile(rapidjson::Document& document_, rapidjson::Value& jRoot) {
+	Clear();
+	document = &document_;
+
+	CompileGameObject(jRoot, SCENE_INVALID_INDEX);
+}
+
+void PrefabTemplate::Clear() {
+	document = nullptr;
+	gameObjects.clear();
+	components.clear();
+	instanceGameObjects.clear();
+}
+
+GameObject* PrefabTemplate::Instantiate(GameObject* parent) const {
+	if (gameObjects.empty()) return nullptr;
+
+	Scene* scene = parent->scene;
+	instanceGameObjects.resize(gameObjects.size());
+	for (unsigned i = 0; i < gameObjects.size(); ++i) {
+		const TemplateGameObject& templateGameObject = gameObjects[i];
+
+		UID gameObjectId = GenerateUID();
+		GameObject* gameObject = scene->gameObjects.Obtain(gameObjectId);
+		if (gameObject == nullptr) {
+			// The pool is full. The part of the instance created so far is removed
+			LOG("The GameObject pool is full. The prefab can't be instantiated.");
+			if (i > 0) scene->DestroyGameObject(instanceGameObjects[0]);
+			return nullptr;
+		}
+
+		gameObject->scene = scene;
+		gameObject->LoadBinary(templateGameObject.fields, templateGameObject.name.c_str());
+		gameObject->id = gameObjectId;
+		gameObject->SetParent(templateGameObject.fields.parentIndex != SCENE_INVALID_INDEX ? instanceGameObjects[templateGameObject.fields.parentIndex] : parent);
+
+		unsigned endComponent = templateGameObject.firstComponent + templateGameObject.fields.numComponents;
+		for (unsigned j = templateGameObject.firstComponent; j < endComponent; ++j) {
+			const TemplateComponent& templateComponent = components[j];
+			Component* component = scene->CreateComponentByTypeAndId(gameObject, templateComponent.type, GenerateUID());
+			if (component == nullptr) continue;
+
+			gameObject->components.push_back(component);
+			component->Load(JsonValue(*document, *templateComponent.data));
+		}
+
+		instanceGameObjects[i] = gameObject;
+	}
+
+	// Bones are cached once the whole hierarchy exists. Going backwards, descendants are done before their ancestors, as in LoadPrefab
+	for (unsigned i = (unsigned) gameObjects.size(); i-- > 0;) {
+		unsigned rootBoneIndex = gameObjects[i].rootBoneIndex;
+		if (rootBoneIndex == SCENE_INVALID_INDEX) continue;
+
+		GameObject* gameObject = instanceGameObjects[i];
+		GameObject* rootBone = instanceGameObjects[rootBoneIndex];
+		gameObject->SetRootBone(rootBone);
+		std::unordered_map<std::string, GameObject*> temporalBonesMap;
+		temporalBonesMap[rootBone->name] = rootBone;
+		ModelImporter::CacheBones(rootBone, temporalBonesMap);
+		ModelImporter::SaveBones(gameObject, temporalBonesMap);
+	}
+
+	return instanceGameObjects[0];
+}
+
+unsigned PrefabTemplate::GetGameObjectCount() const {
+	return (unsigned) gameObjects.size();
+}
+
+unsigned PrefabTemplate::GetComponentCount() const {
+	return (unsigned) components.size();
+}
+
+void PrefabTemplate::CompileGameObject(rapidjson::Value& jGameObject, unsigned parentIndex) {
+	unsigned index = (unsigned) gameObjects.size();
+	gameObjects.emplace_back();
+	{
+		TemplateGameObject& templateGameObject = gameObjects.back();
+		templateGameObject.name = GetString(GetMember(jGameObject, JSON_TAG_NAME));
+		templateGameObject.fields.parentIndex = parentIndex;
+		templateGameObject.fields.active = GetBool(GetMember(jGameObject, JSON_TAG_ACTIVE));
+		templateGameObject.fields.mask = GetInt(GetMember(jGameObject, JSON_TAG_MASK));
+		templateGameObject.firstComponent = (unsigned) components.size();
+	}
+
+	rapidjson::Value& jComponents = GetMember(jGameObject, JSON_TAG_COMPONENTS);
+	for (unsigned i = 0; i < GetArraySize(jComponents); ++i) {
+		rapidjson::Value& jComponent = jComponents[i];
+
+		TemplateComponent templateComponent;
+		templateComponent.type = GetComponentTypeFromName(GetString(GetMember(jComponent, JSON_TAG_TYPE)));
+		templateComponent.data = &jComponent;
+		components.push_back(templateComponent);
+	}
+	gameObjects[index].fields.numComponents = (unsigned) components.size() - gameObjects[index].firstComponent;
+
+	rapidjson::Value& jChildren = GetMember(jGameObject, JSON_TAG_CHILDREN);
+	for (unsigned i = 0; i < GetArraySize(jChildren); ++i) {
+		CompileGameObject(jChildren[i], index);
+	}
+
+	// The root bone is the GameObject itself or its first descendant with the same name, as in FindDescendant
+	std::string rootBoneName = GetString(GetMember(jGameObject, JSON_TAG_ROOT_BONE_NAME));
+	if (rootBoneName != "") {
+		TemplateGameObject& templateGameObject = gameObjects[index];
+		if (rootBoneName == templateGameObject.name) {
+			templateGameObject.rootBoneIndex = index;
+		} else {
+			// Descendants are the GameObjects added after this one, in the same order FindDescendant visits them
+			for (unsigned i = index + 1; i < gameObjects.size(); ++i) {
+				if (gameObjects[i].name == rootBoneName) {
+					templateGameObject.rootBoneIndex = i;
+					break;
+				}
+			}
+		}
+	}
+}
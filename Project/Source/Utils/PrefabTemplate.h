@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Components/ComponentType.h"
+#include "FileSystem/SceneImporter.h"
+
+#include "rapidjson/document.h"
+
+#include <string>
+#include <vector>
+
+class GameObject;
+
+/* Prefab hierarchy flattened when the prefab is loaded, so that instantiating it doesn't walk the JSON document.
+*  GameObjects are stored in the order LoadPrefab creates them (parents first), with their fields and parent index
+*  already read, and their components with the type already resolved and a pointer to the JSON data they load from.
+*/
+
+class PrefabTemplate {
+public:
+	struct TemplateGameObject {
+		std::string name = "";
+		SceneImporter::FileGameObject fields; // Fields set with GameObject::LoadBinary. The id is generated for each instance
+		unsigned firstComponent = 0;
+		unsigned rootBoneIndex = SCENE_INVALID_INDEX; // Index of the root bone GameObject, if it has one
+	};
+
+	struct TemplateComponent {
+		ComponentType type = ComponentType::UNKNOWN;
+		rapidjson::Value* data = nullptr;
+	};
+
+public:
+	void Compile(rapidjson::Document& document, rapidjson::Value& jRoot);
+	void Clear();
+
+	GameObject* Instantiate(GameObject* parent) const; // Creates the GameObjects and components of an instance under 'parent'. Init and Start aren't called
+
+	unsigned GetGameObjectCount() const;
+	unsigned GetComponentCount() const;
+
+private:
+	void CompileGameObject(rapidjson::Value& jGameObject, unsigned parentIndex);
+
+private:
+	rapidjson::Document* document = nullptr;
+	std::vector<TemplateGameObject> gameObjects;
+	std::vector<TemplateComponent> components;
+	mutable std::vector<GameObject*> instanceGameObjects; // GameObjects of the instance being created, by template index. Kept to reuse its memory
+};
@@ -0,0 +1,160 @@
+#include "ResourceTable.h"
+
+#include "Globals.h"
+#include "Resources/Resource.h"
+
+#include "Math/myassert.h"
+
+#include "Utils/Leaks.h"
+
+#define RESOURCE_TABLE_INITIAL_CAPACITY 1024
+
+ResourceTable::SlotArray::SlotArray(unsigned capacity_)
+	: capacity(capacity_) {
+	slots = new Slot[capacity];
+}
+
+ResourceTable::SlotArray::~SlotArray() {
+	RELEASE_ARRAY(slots);
+}
+
+ResourceTable::ResourceTable() {
+	current.store(new SlotArray(RESOURCE_TABLE_INITIAL_CAPACITY), std::memory_order_release);
+}
+
+ResourceTable::~ResourceTable() {
+	Clear();
+	delete current.load(std::memory_order_relaxed);
+}
+
+ResourceHandle ResourceTable::Add(Resource* resource) {
+	assert(resource != nullptr); // ERROR: Null resources can't be added to the table
+
+	unsigned index = 0;
+	if (!freeSlots.empty()) {
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	} else {
+		if (usedSlots == current.load(std::memory_order_relaxed)->capacity) {
+			Grow();
+		}
+		index = usedSlots++;
+	}
+
+	// The generation was already bumped when the slot was freed, so stale handles are rejected before the new resource is visible
+	Slot& slot = current.load(std::memory_order_relaxed)->slots[index];
+	slot.id.store(resource->GetId(), std::memory_order_relaxed);
+	slot.resource.store(resource, std::memory_order_release);
+	count += 1;
+
+	unsigned nextVersion = version.load(std::memory_order_relaxed) + 1;
+	if (nextVersion == 0) nextVersion = 1;
+	version.store(nextVersion, std::memory_order_release);
+
+	ResourceHandle handle;
+	handle.index = index;
+	handle.generation = slot.generation.load(std::memory_order_relaxed);
+	return handle;
+}
+
+void ResourceTable::Remove(ResourceHandle handle) {
+	SlotArray* slotArray = current.load(std::memory_order_relaxed);
+	if (!handle.IsValid() || handle.index >= usedSlots) return;
+
+	Slot& slot = slotArray->slots[handle.index];
+	unsigned generation = slot.generation.load(std::memory_order_relaxed);
+	if (generation != handle.generation) return;
+
+	// Invalidate the handle first, then clear the slot
+	unsigned nextGeneration = generation + 1;
+	if (nextGeneration == 0) nextGeneration = 1;
+	slot.generation.store(nextGeneration, std::memory_order_release);
+	slot.resource.store(nullptr, std::memory_order_release);
+	slot.id.store(0, std::memory_order_relaxed);
+
+	freeSlots.push_back(handle.index);
+	count -= 1;
+}
+
+void ResourceTable::Clear() {
+	SlotArray* slotArray = current.load(std::memory_order_relaxed);
+	for (unsigned i = 0; i < usedSlots; ++i) {
+		Slot& slot = slotArray->slots[i];
+		if (slot.resource.load(std::memory_order_relaxed) == nullptr) continue;
+
+		unsigned nextGeneration = slot.generation.load(std::memory_order_relaxed) + 1;
+		if (nextGeneration == 0) nextGeneration = 1;
+		slot.generation.store(nextGeneration, std::memory_order_release);
+		slot.resource.store(nullptr, std::memory_order_release);
+		slot.id.store(0, std::memory_order_relaxed);
+	}
+
+	freeSlots.clear();
+	for (unsigned i = usedSlots; i > 0; --i) {
+		freeSlots.push_back(i - 1);
+	}
+	count = 0;
+
+	for (SlotArray* retiredArray : retired) {
+		delete retiredArray;
+	}
+	retired.clear();
+}
+
+Resource* ResourceTable::Get(ResourceHandle handle) const {
+	if (!handle.IsValid()) return nullptr;
+
+	const SlotArray* slotArray = current.load(std::memory_order_acquire);
+	if (handle.index >= slotArray->capacity) return nullptr;
+
+	const Slot& slot = slotArray->slots[handle.index];
+	if (slot.generation.load(std::memory_order_acquire) != handle.generation) return nullptr;
+	Resource* resource = slot.resource.load(std::memory_order_acquire);
+	if (slot.generation.load(std::memory_order_acquire) != handle.generation) return nullptr;
+
+	return resource;
+}
+
+Resource* ResourceTable::Get(ResourceHandle handle, UID id) const {
+	if (!handle.IsValid()) return nullptr;
+
+	const SlotArray* slotArray = current.load(std::memory_order_acquire);
+	if (handle.index >= slotArray->capacity) return nullptr;
+
+	const Slot& slot = slotArray->slots[handle.index];
+	if (slot.generation.load(std::memory_order_acquire) != handle.generation) return nullptr;
+	Resource* resource = slot.resource.load(std::memory_order_acquire);
+	UID slotId = slot.id.load(std::memory_order_relaxed);
+	if (slot.generation.load(std::memory_order_acquire) != handle.generation) return nullptr;
+
+	return slotId == id ? resource : nullptr;
+}
+
+unsigned ResourceTable::Count() const {
+	return count;
+}
+
+unsigned ResourceTable::Capacity() const {
+	return current.load(std::memory_order_acquire)->capacity;
+}
+
+unsigned ResourceTable::GetVersion() const {
+	return version.load(std::memory_order_acquire);
+}
+
+void ResourceTable::Grow() {
+	SlotArray* oldArray = current.load(std::memory_order_relaxed);
+	SlotArray* newArray = new SlotArray(oldArray->capacity * 2);
+
+	for (unsigned i = 0; i < oldArray->capacity; ++i) {
+		Slot& oldSlot = oldArray->slots[i];
+		Slot& newSlot = newArray->slots[i];
+		newSlot.resource.store(oldSlot.resource.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		newSlot.id.store(oldSlot.id.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		newSlot.generation.store(oldSlot.generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	// Publish the new array. Readers may still be resolving against the old one, so it is only retired.
+	current.store(newArray, std::memory_order_release);
+	retired.push_back(oldArray);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Resources/ResourceHandle.h"
+#include "Utils/UID.h"
+
+#include <atomic>
+#include <vector>
+
+class Resource;
+
+// Read-mostly slot table that resolves ResourceHandles without taking any lock.
+// There is a single writer (the thread that owns the resources) and any number of readers.
+// When the table runs out of slots, a bigger copy is published with an atomic swap and the
+// old array is retired instead of freed (RCU-style), so a reader that is still looking at it
+// never touches released memory. Retired arrays are released on Clear().
+class ResourceTable {
+public:
+	ResourceTable();
+	~ResourceTable();
+
+	// ---- Writer ---- //
+	ResourceHandle Add(Resource* resource);
+	void Remove(ResourceHandle handle);
+	void Clear();
+
+	// ---- Readers ---- //
+	Resource* Get(ResourceHandle handle) const;
+	Resource* Get(ResourceHandle handle, UID id) const; // Also checks that the slot still holds the resource with the given id
+
+	unsigned Count() const;
+	unsigned Capacity() const;
+	unsigned GetVersion() const; // Increased every time a resource is added
+
+private:
+	struct Slot {
+		std::atomic<Resource*> resource = nullptr;
+		std::atomic<UID> id = 0;
+		std::atomic<unsigned> generation = 1;
+	};
+
+	struct SlotArray {
+		SlotArray(unsigned capacity);
+		~SlotArray();
+
+		unsigned capacity = 0;
+		Slot* slots = nullptr;
+	};
+
+	void Grow();
+
+private:
+	std::atomic<SlotArray*> current = nullptr; // Array that readers resolve handles against
+	std::atomic<unsigned> version = 1;		   // Lets readers skip the lookup of ids that were missing and still can't be found
+	std::vector<SlotArray*> retired;		   // Arrays replaced by Grow() that may still be read
+	std::vector<unsigned> freeSlots;		   // Writer-only list of reusable slots
+	unsigned usedSlots = 0;					   // Slots handed out at least once
+	unsigned count = 0;						   // Slots currently holding a resource
+};
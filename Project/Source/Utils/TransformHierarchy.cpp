@@ -0,0 +1,356 @@
+#include "TransformHierarchy.h"
+
+#include "GameObject.h"
+#include "Components/ComponentTransform.h"
+#include "Components/ComponentBoundingBox.h"
+
+#include <algorithm>
+
+#include "Utils/Leaks.h"
+
+template<typename T>
+static void Permute(std::vector<T>& values, const std::vector<int>& order) {
+	std::vector<T> permutedValues;
+	permutedValues.reserve(order.size());
+	for (int index : order) {
+		permutedValues.push_back(values[index]);
+	}
+	values.swap(permutedValues);
+}
+
+static void Remap(std::vector<int>& indices, const std::vector<int>& newIndices) {
+	for (int& index : indices) {
+		if (index != TRANSFORM_HIERARCHY_NONE) index = newIndices[index];
+	}
+}
+
+void TransformHierarchy::Add(ComponentTransform* transform) {
+	int index;
+	if (!freeIndices.empty()) {
+		index = freeIndices.back();
+		freeIndices.pop_back();
+	} else {
+		index = (int) transforms.size();
+		size_t size = transforms.size() + 1;
+		transforms.resize(size);
+		boundingBoxes.resize(size);
+		parents.resize(size);
+		firstChildren.resize(size);
+		nextSiblings.resize(size);
+		depths.resize(size);
+		positions.resize(size);
+		rotations.resize(size);
+		scales.resize(size);
+		localMatrices.resize(size);
+		worldMatrices.resize(size);
+		dirtyFlags.resize(size);
+	}
+
+	transforms[index] = transform;
+	boundingBoxes[index] = nullptr;
+	parents[index] = TRANSFORM_HIERARCHY_NONE;
+	firstChildren[index] = TRANSFORM_HIERARCHY_NONE;
+	nextSiblings[index] = TRANSFORM_HIERARCHY_NONE;
+	depths[index] = 0;
+	positions[index] = float3::zero;
+	rotations[index] = Quat::identity;
+	scales[index] = float3::one;
+	localMatrices[index] = float4x4::identity;
+	worldMatrices[index] = float4x4::identity;
+	dirtyFlags[index] = 1;
+
+	transform->hierarchy = this;
+	transform->hierarchyIndex = index;
+	pendingTransforms.push_back(index);
+	sorted = false;
+}
+
+void TransformHierarchy::Remove(ComponentTransform* transform) {
+	int index = transform->hierarchyIndex;
+
+	// The children are left without a parent transform
+	int child = firstChildren[index];
+	while (child != TRANSFORM_HIERARCHY_NONE) {
+		int nextSibling = nextSiblings[child];
+		parents[child] = TRANSFORM_HIERARCHY_NONE;
+		nextSiblings[child] = TRANSFORM_HIERARCHY_NONE;
+		SetDepth(child, 0);
+		InvalidateSubtree(child);
+		child = nextSibling;
+	}
+	firstChildren[index] = TRANSFORM_HIERARCHY_NONE;
+	Unlink(index);
+
+	transforms[index] = nullptr;
+	boundingBoxes[index] = nullptr;
+	freeIndices.push_back(index);
+	sorted = false;
+
+	transform->hierarchy = nullptr;
+	transform->hierarchyIndex = TRANSFORM_HIERARCHY_NONE;
+}
+
+void TransformHierarchy::Relink(ComponentTransform* transform) {
+	pendingTransforms.push_back(transform->hierarchyIndex);
+}
+
+void TransformHierarchy::AddBoundingBox(ComponentBoundingBox* boundingBox) {
+	pendingBoundingBoxes.push_back(boundingBox);
+}
+
+void TransformHierarchy::RemoveBoundingBox(ComponentBoundingBox* boundingBox) {
+	pendingBoundingBoxes.erase(std::remove(pendingBoundingBoxes.begin(), pendingBoundingBoxes.end(), boundingBox), pendingBoundingBoxes.end());
+
+	ComponentTransform* transform = boundingBox->GetOwner().GetComponent<ComponentTransform>();
+	if (transform != nullptr && transform->hierarchy == this && boundingBoxes[transform->hierarchyIndex] == boundingBox) {
+		boundingBoxes[transform->hierarchyIndex] = nullptr;
+	}
+}
+
+void TransformHierarchy::Clear() {
+	transforms.clear();
+	boundingBoxes.clear();
+	parents.clear();
+	firstChildren.clear();
+	nextSiblings.clear();
+	depths.clear();
+	positions.clear();
+	rotations.clear();
+	scales.clear();
+	localMatrices.clear();
+	worldMatrices.clear();
+	dirtyFlags.clear();
+
+	freeIndices.clear();
+	pendingTransforms.clear();
+	pendingBoundingBoxes.clear();
+	levelStarts.clear();
+	sorted = true;
+}
+
+void TransformHierarchy::SetPosition(int index, const float3& position) {
+	positions[index] = position;
+	Invalidate(index);
+}
+
+void TransformHierarchy::SetRotation(int index, const Quat& rotation) {
+	rotations[index] = rotation;
+	Invalidate(index);
+}
+
+void TransformHierarchy::SetScale(int index, const float3& scale) {
+	scales[index] = scale;
+	Invalidate(index);
+}
+
+void TransformHierarchy::SetTRS(int index, const float3& position, const Quat& rotation, const float3& scale) {
+	positions[index] = position;
+	rotations[index] = rotation;
+	scales[index] = scale;
+	Invalidate(index);
+}
+
+const float3& TransformHierarchy::GetPosition(int index) const {
+	return positions[index];
+}
+
+const Quat& TransformHierarchy::GetRotation(int index) const {
+	return rotations[index];
+}
+
+const float3& TransformHierarchy::GetScale(int index) const {
+	return scales[index];
+}
+
+void TransformHierarchy::Invalidate(int index) {
+	LinkPending();
+	InvalidateSubtree(index);
+}
+
+const float4x4& TransformHierarchy::GetLocalMatrix(int index) {
+	LinkPending();
+	Resolve(index);
+	return localMatrices[index];
+}
+
+const float4x4& TransformHierarchy::GetWorldMatrix(int index) {
+	LinkPending();
+	Resolve(index);
+	return worldMatrices[index];
+}
+
+void TransformHierarchy::SortByDepth() {
+	LinkPending();
+	if (sorted) return;
+
+	// Counting sort by depth. Free indices are dropped, and transforms keep their relative order inside each level
+	unsigned numIndices = (unsigned) transforms.size();
+	unsigned numLevels = 0;
+	for (unsigned i = 0; i < numIndices; ++i) {
+		if (transforms[i] != nullptr) numLevels = std::max(numLevels, depths[i] + 1);
+	}
+
+	levelStarts.assign(numLevels + 1, 0);
+	for (unsigned i = 0; i < numIndices; ++i) {
+		if (transforms[i] != nullptr) levelStarts[depths[i] + 1] += 1;
+	}
+	for (unsigned level = 0; level < numLevels; ++level) {
+		levelStarts[level + 1] += levelStarts[level];
+	}
+
+	std::vector<unsigned> levelCursors(levelStarts.begin(), levelStarts.end() - 1);
+	std::vector<int> order(levelStarts[numLevels]);
+	std::vector<int> newIndices(numIndices, TRANSFORM_HIERARCHY_NONE);
+	for (unsigned i = 0; i < numIndices; ++i) {
+		if (transforms[i] == nullptr) continue;
+		unsigned newIndex = levelCursors[depths[i]]++;
+		order[newIndex] = (int) i;
+		newIndices[i] = (int) newIndex;
+	}
+
+	Permute(transforms, order);
+	Permute(boundingBoxes, order);
+	Permute(parents, order);
+	Permute(firstChildren, order);
+	Permute(nextSiblings, order);
+	Permute(depths, order);
+	Permute(positions, order);
+	Permute(rotations, order);
+	Permute(scales, order);
+	Permute(localMatrices, order);
+	Permute(worldMatrices, order);
+	Permute(dirtyFlags, order);
+	Remap(parents, newIndices);
+	Remap(firstChildren, newIndices);
+	Remap(nextSiblings, newIndices);
+
+	for (unsigned i = 0; i < transforms.size(); ++i) {
+		transforms[i]->hierarchyIndex = (int) i;
+	}
+	freeIndices.clear();
+	sorted = true;
+}
+
+unsigned TransformHierarchy::GetNumLevels() const {
+	return levelStarts.empty() ? 0 : (unsigned) levelStarts.size() - 1;
+}
+
+unsigned TransformHierarchy::GetLevelBegin(unsigned level) const {
+	return levelStarts[level];
+}
+
+unsigned TransformHierarchy::GetLevelEnd(unsigned level) const {
+	return levelStarts[level + 1];
+}
+
+void TransformHierarchy::UpdateWorldMatrices(unsigned begin, unsigned end) {
+	for (unsigned i = begin; i < end; ++i) {
+		if (dirtyFlags[i]) UpdateWorldMatrix((int) i);
+	}
+}
+
+unsigned TransformHierarchy::Count() const {
+	return (unsigned) (transforms.size() - freeIndices.size());
+}
+
+void TransformHierarchy::LinkPending() {
+	if (!pendingTransforms.empty()) {
+		for (int index : pendingTransforms) {
+			ComponentTransform* transform = transforms[index];
+			if (transform == nullptr) continue;
+
+			GameObject& owner = transform->GetOwner();
+			// New transforms start dirty, so the bounding box of the owner has to be told here
+			boundingBoxes[index] = owner.GetComponent<ComponentBoundingBox>();
+			if (boundingBoxes[index] != nullptr) boundingBoxes[index]->Invalidate();
+
+			GameObject* parent = owner.GetParent();
+			ComponentTransform* parentTransform = parent != nullptr ? parent->GetComponent<ComponentTransform>() : nullptr;
+			Link(index, parentTransform != nullptr ? parentTransform->hierarchyIndex : TRANSFORM_HIERARCHY_NONE);
+
+			// Children whose transforms were created before this one
+			for (GameObject* child : owner.GetChildren()) {
+				ComponentTransform* childTransform = child->GetComponent<ComponentTransform>();
+				if (childTransform != nullptr) Link(childTransform->hierarchyIndex, index);
+			}
+		}
+		pendingTransforms.clear();
+	}
+
+	if (!pendingBoundingBoxes.empty()) {
+		for (ComponentBoundingBox* boundingBox : pendingBoundingBoxes) {
+			ComponentTransform* transform = boundingBox->GetOwner().GetComponent<ComponentTransform>();
+			if (transform != nullptr) boundingBoxes[transform->hierarchyIndex] = boundingBox;
+		}
+		pendingBoundingBoxes.clear();
+	}
+}
+
+void TransformHierarchy::Link(int index, int parent) {
+	if (parents[index] == parent) return;
+
+	Unlink(index);
+	parents[index] = parent;
+	if (parent != TRANSFORM_HIERARCHY_NONE) {
+		nextSiblings[index] = firstChildren[parent];
+		firstChildren[parent] = index;
+	}
+
+	// The world matrices of the moved subtree now depend on another parent
+	SetDepth(index, parent != TRANSFORM_HIERARCHY_NONE ? depths[parent] + 1 : 0);
+	InvalidateSubtree(index);
+	sorted = false;
+}
+
+void TransformHierarchy::Unlink(int index) {
+	int parent = parents[index];
+	if (parent == TRANSFORM_HIERARCHY_NONE) return;
+
+	int* link = &firstChildren[parent];
+	while (*link != index) {
+		link = &nextSiblings[*link];
+	}
+	*link = nextSiblings[index];
+
+	parents[index] = TRANSFORM_HIERARCHY_NONE;
+	nextSiblings[index] = TRANSFORM_HIERARCHY_NONE;
+}
+
+void TransformHierarchy::SetDepth(int index, unsigned depth) {
+	depths[index] = depth;
+	for (int child = firstChildren[index]; child != TRANSFORM_HIERARCHY_NONE; child = nextSiblings[child]) {
+		SetDepth(child, depth + 1);
+	}
+}
+
+void TransformHierarchy::InvalidateSubtree(int index) {
+	if (dirtyFlags[index]) return;
+
+	dirtyFlags[index] = 1;
+	if (boundingBoxes[index] != nullptr) boundingBoxes[index]->Invalidate();
+
+	for (int child = firstChildren[index]; child != TRANSFORM_HIERARCHY_NONE; child = nextSiblings[child]) {
+		InvalidateSubtree(child);
+	}
+}
+
+void TransformHierarchy::Resolve(int index) {
+	if (!dirtyFlags[index]) return;
+
+	int parent = parents[index];
+	if (parent != TRANSFORM_HIERARCHY_NONE) Resolve(parent);
+	UpdateWorldMatrix(index);
+}
+
+void TransformHierarchy::UpdateWorldMatrix(int index) {
+	localMatrices[index] = float4x4::FromTRS(positions[index], rotations[index], scales[index]);
+
+	int parent = parents[index];
+	if (parent != TRANSFORM_HIERARCHY_NONE) {
+		worldMatrices[index] = worldMatrices[parent] * localMatrices[index];
+	} else {
+		worldMatrices[index] = localMatrices[index];
+	}
+
+	dirtyFlags[index] = 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Math/float3.h"
+#include "Math/Quat.h"
+#include "Math/float4x4.h"
+
+#include <vector>
+
+class ComponentTransform;
+class ComponentBoundingBox;
+
+#define TRANSFORM_HIERARCHY_NONE -1
+
+/* Transforms of a scene stored as flat arrays: local position, rotation and scale, local and world matrices, dirty flags
+*  and the parent, first child and next sibling of each transform, referenced by index. The components only keep their
+*  index. Changing a transform marks it and its descendants as dirty by walking the child indices, and reading a dirty
+*  world matrix recomputes it from its dirty ancestors. Once per frame, the arrays are sorted by depth (if the hierarchy
+*  changed) and every dirty world matrix is updated in one sweep, level by level, so that parents are always done first.
+*  The transforms of a level don't depend on each other, so a level can be split between several threads.
+*  Transforms are linked to their parent and children when the hierarchy is next used, because the components of a
+*  GameObject can still be incomplete when they are created.
+*/
+
+class TransformHierarchy {
+public:
+	void Add(ComponentTransform* transform); // Called by the scene when a transform is created
+	void Remove(ComponentTransform* transform);
+	void Relink(ComponentTransform* transform); // Called when the owner of the transform changes its parent
+	void AddBoundingBox(ComponentBoundingBox* boundingBox);
+	void RemoveBoundingBox(ComponentBoundingBox* boundingBox);
+	void Clear();
+
+	// ---------- Local TRS ---------- //
+	void SetPosition(int index, const float3& position);
+	void SetRotation(int index, const Quat& rotation);
+	void SetScale(int index, const float3& scale);
+	void SetTRS(int index, const float3& position, const Quat& rotation, const float3& scale);
+	const float3& GetPosition(int index) const;
+	const Quat& GetRotation(int index) const;
+	const float3& GetScale(int index) const;
+
+	// ---------- Matrices ---------- //
+	void Invalidate(int index);				   // Marks the transform and its descendants as dirty, and invalidates their bounding boxes
+	const float4x4& GetLocalMatrix(int index); // Recomputes the matrices of the transform and its dirty ancestors if needed. The reference is only valid until the next Add, Remove or SortByDepth
+	const float4x4& GetWorldMatrix(int index);
+
+	// ---------- Batched update ---------- //
+	void SortByDepth(); // Links the pending transforms and sorts the arrays by depth if the hierarchy has changed. The level ranges are valid until the next change
+	unsigned GetNumLevels() const;
+	unsigned GetLevelBegin(unsigned level) const; // Index of the first transform of the level
+	unsigned GetLevelEnd(unsigned level) const;
+	void UpdateWorldMatrices(unsigned begin, unsigned end); // Updates the dirty transforms in [begin, end), which must be in one level. Can be called from several threads for different ranges
+	unsigned Count() const;
+
+private:
+	void LinkPending();
+	void Link(int index, int parent);
+	void Unlink(int index);
+	void SetDepth(int index, unsigned depth); // Sets the depth of the transform and its descendants
+	void InvalidateSubtree(int index);
+	void Resolve(int index); // Updates the world matrix of a dirty transform, after the ones of its dirty ancestors
+	void UpdateWorldMatrix(int index);
+
+private:
+	std::vector<ComponentTransform*> transforms;	  // Null for free indices
+	std::vector<ComponentBoundingBox*> boundingBoxes; // Bounding box of the owner, invalidated with the transform
+	std::vector<int> parents;
+	std::vector<int> firstChildren;
+	std::vector<int> nextSiblings;
+	std::vector<unsigned> depths;
+	std::vector<float3> positions;
+	std::vector<Quat> rotations;
+	std::vector<float3> scales;
+	std::vector<float4x4> localMatrices;
+	std::vector<float4x4> worldMatrices;
+	std::vector<unsigned char> dirtyFlags; // A dirty transform always has dirty descendants
+
+	std::vector<int> freeIndices;
+	std::vector<int> pendingTransforms;						 // Transforms whose parent and children have to be linked
+	std::vector<ComponentBoundingBox*> pendingBoundingBoxes; // Bounding boxes created since the hierarchy was last used
+	std::vector<unsigned> levelStarts;						 // First index of each depth, and the count at the end. Only valid while 'sorted' is set
+	bool sorted = true;										 // Cleared when a transform is added, removed or moved to another parent
+};
@@ -3,6 +3,7 @@
 #include <random>
 #include <sstream>
 #include <string>
+#include <mutex>
 
 #include "Utils/Leaks.h"
 
@@ -11,13 +12,16 @@ static std::mt19937_64 mersenneTwister(random());
 static std::uniform_int_distribution<UID> distribution;
 static std::uniform_int_distribution<UID> distribution_hex(0, 15);
 static std::uniform_int_distribution<UID> distribution_hex_2(8, 11);
+static std::mutex generatorMutex; // Assets are imported from several threads
 
 UID GenerateUID() {
+	std::lock_guard<std::mutex> lock(generatorMutex);
 	return distribution(mersenneTwister);
 }
 
 std::string GenerateUID128() {
-	
+	std::lock_guard<std::mutex> lock(generatorMutex);
+
 	std::stringstream ss;
 	
 	ss << std::hex;
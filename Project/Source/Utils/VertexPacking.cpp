@@ -0,0 +1,83 @@
+#include "VertexPacking.h"
+
+#include "Math/MathFunc.h"
+#include <string.h>
+
+#include "Utils/Leaks.h"
+
+static unsigned PackSnorm10(float value) {
+	int quantized = static_cast<int>(roundf(Clamp(value, -1.0f, 1.0f) * 511.0f));
+	return static_cast<unsigned>(quantized) & 0x3FFu;
+}
+
+static float UnpackSnorm10(unsigned value) {
+	// Sign extend the 10 bits
+	int quantized = static_cast<int>(value << 22) >> 22;
+	return Max(static_cast<float>(quantized) / 511.0f, -1.0f);
+}
+
+unsigned PackNormal(const float3& normal) {
+	return PackSnorm10(normal.x) | (PackSnorm10(normal.y) << 10) | (PackSnorm10(normal.z) << 20);
+}
+
+float3 UnpackNormal(unsigned packedNormal) {
+	return float3(UnpackSnorm10(packedNormal), UnpackSnorm10(packedNormal >> 10), UnpackSnorm10(packedNormal >> 20));
+}
+
+unsigned short FloatToHalf(float value) {
+	unsigned bits = 0;
+	memcpy(&bits, &value, sizeof(float));
+
+	unsigned sign = (bits >> 16) & 0x8000u;
+	int exponent = static_cast<int>((bits >> 23) & 0xFFu) - 127 + 15;
+	unsigned mantissa = bits & 0x7FFFFFu;
+
+	if (exponent <= 0) {
+		// Too small for a normal half. Flush to a denormal or zero
+		if (exponent < -10) return static_cast<unsigned short>(sign);
+		mantissa |= 0x800000u;
+		unsigned shift = static_cast<unsigned>(14 - exponent);
+		unsigned half = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1u) half += 1; // Round to nearest
+		return static_cast<unsigned short>(sign | half);
+	}
+
+	if (exponent >= 31) {
+		// Clamp to the biggest half instead of producing infinity
+		return static_cast<unsigned short>(sign | 0x7BFFu);
+	}
+
+	unsigned half = sign | (static_cast<unsigned>(exponent) << 10) | (mantissa >> 13);
+	if (mantissa & 0x1000u) half += 1; // Round to nearest. A carry into the exponent is still correct
+	return static_cast<unsigned short>(Min(half & 0x7FFFu, 0x7BFFu) | sign);
+}
+
+float HalfToFloat(unsigned short value) {
+	unsigned sign = (value & 0x8000u) << 16;
+	int exponent = (value >> 10) & 0x1F;
+	unsigned mantissa = value & 0x3FFu;
+
+	unsigned bits = 0;
+	if (exponent == 0) {
+		if (mantissa == 0) {
+			bits = sign;
+		} else {
+			// Denormal half. Normalize it
+			exponent = 1;
+			while ((mantissa & 0x400u) == 0) {
+				mantissa <<= 1;
+				exponent -= 1;
+			}
+			mantissa &= 0x3FFu;
+			bits = sign | (static_cast<unsigned>(exponent + 127 - 15) << 23) | (mantissa << 13);
+		}
+	} else if (exponent == 31) {
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	} else {
+		bits = sign | (static_cast<unsigned>(exponent + 127 - 15) << 23) | (mantissa << 13);
+	}
+
+	float result = 0.0f;
+	memcpy(&result, &bits, sizeof(float));
+	return result;
+}
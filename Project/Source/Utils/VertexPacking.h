@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Math/float3.h"
+
+// Packs a unit vector into signed normalized 10-10-10-2 (GL_INT_2_10_10_10_REV). The w component is left as 0
+unsigned PackNormal(const float3& normal);
+float3 UnpackNormal(unsigned packedNormal);
+
+// Converts between 32-bit and 16-bit (GL_HALF_FLOAT) floats. Values out of the half range are clamped
+unsigned short FloatToHalf(float value);
+float HalfToFloat(unsigned short value);